@@ -1,7 +1,9 @@
 #pragma once
 
+#include "line_assembler.h"
 #include "log_client.h"
 #include "protocol.h"
+#include "protocol_bin.h"
 #include <Arduino.h>
 
 enum class ClientSafetyReason : uint8_t {
@@ -20,11 +22,16 @@ class ClientComm {
     void begin(uint32_t baudrate);
     void loop(); // non-blocking
 
-    // Host requested new outputs mask (H;SET;...)
+    // Host requested new outputs mask (H;SET/UPD/TOG/ACT;...)
     bool hasNewOutputsMask() const;
     uint16_t getOutputsMask() const;
     void clearNewOutputsMaskFlag();
 
+    // Call right after applying the outputs from hasNewOutputsMask()/the
+    // outputs callback: sends a pending C;ACK;ACT reply (H;ACT) with the
+    // applied state. Without the call it goes out on the next loop().
+    void outputsApplied();
+
     // Host requested a status frame (H;GET;STATUS)
     bool statusRequested() const;
     void clearStatusRequestedFlag();
@@ -39,7 +46,8 @@ class ClientComm {
     // In ClientComm.h (public section)
     using OutputsChangedCallback = void (*)(uint16_t newMask);
     using FillStatusCallback = void (*)(ProtocolStatus &st);
-    using TxLineCallback = void (*)(const String &line, const String &dir);
+    // `line` is the NUL-terminated frame incl. CRLF (valid during the call only).
+    using TxLineCallback = void (*)(const char *line, const char *dir);
     using HeartBeatCallback = void (*)();
 
     void setOutputsChangedCallback(OutputsChangedCallback cb);
@@ -47,10 +55,35 @@ class ClientComm {
     void setTxLineCallback(TxLineCallback cb);
     void setHeartBeatCallback(HeartBeatCallback cb);
 
+    // True while TX uses the binary link mode (negotiated by the host).
+    bool binaryActive() const { return _binaryTx; }
+
+    // STATUS push subscription (H;SUB). While subscribed, loop() sends a
+    // STATUS every statusPushPeriodMs() and additionally right after one of
+    // the subscribed ProtocolSubTrigger events. Output changes are detected
+    // here; the application reports door edges via notifyStatusEvent().
+    // Event pushes go out on the next loop() call, i.e. after the
+    // application has applied the new outputs.
+    void notifyStatusEvent(uint16_t trigger);
+    bool statusSubscribed() const { return _subPeriodMs != 0; }
+    uint16_t statusPushPeriodMs() const { return _subPeriodMs; }
+    uint32_t statusPushCount() const { return _statusPushCount; }
+
+    // Link baud rate (H;BAUD). The client follows host proposals of a
+    // supported rate and returns to the begin() rate when no good host frame
+    // arrives within kBaudVerifyMs after a switch, after kBaudErrorBurst RX
+    // errors in a row, and on host timeout.
+    uint32_t linkBaud() const { return _linkBaud; }
+    uint32_t baudFallbackCount() const { return _baudFallbacks; }
+
+    // RX line assembler (overflow / fragmentation counters)
+    const LineAssembler &rxLines() const { return _lines; }
+
   private:
     HardwareSerial &_linkSerial;
     uint8_t rx, tx;
-    String _rxBuffer;
+    static constexpr size_t kRxReadBlockLen = 128;
+    LineAssembler _lines;
 
     uint16_t _outputsMask;
     bool _newOutputsMask;
@@ -58,16 +91,69 @@ class ClientComm {
     uint8_t _rx;
     uint8_t _tx;
 
-    void handleIncomingLine(const String &line);
-
-    void sendAckSet(uint16_t mask);
+    void handleRxLine(const char *line, size_t len);
+    void handleIncomingLine(const char *line, size_t len);
+    void handleBinaryFrame();
+    void handleMessage(const ProtocolMessage &msg);
+
+    static ProtocolMessage makeMessage(ProtocolMessageType type);
+    void sendMessage(const ProtocolMessage &msg);
+
+    // Binary link mode (COBS + CRC16), see protocol_bin.h
+    ProtocolBinRx _binRx;
+    bool _binaryTx = false;
+
+    // Sequenced commands (;#QQ): applied strictly in order. Duplicates
+    // (host retransmits) are re-ACKed without applying them again, frames
+    // ahead of a gap are dropped so the host retransmits the gap first,
+    // except an absolute SET/ACT, which makes the gap irrelevant.
+    enum class SeqVerdict : uint8_t { Apply, Duplicate, Ahead };
+    uint8_t _expectedSeq = 0; // 0 = no sequenced command seen yet (or resynced)
+    SeqVerdict classifySeq(uint8_t seq) const;
+    void sendAck(ProtocolMessageType ackType, uint16_t mask, uint8_t seq);
+
+        // STATUS push subscription
+    static constexpr uint16_t kMinStatusPushPeriodMs = 50;
+    uint16_t _subPeriodMs = 0; // 0 = not subscribed
+    uint16_t _subTriggers = 0;
+    uint32_t _lastPushMs = 0;
+    bool _pushPending = false;
+    uint32_t _statusPushCount = 0;
+
+    void statusPushTick();
+    void clearStatusSubscription();
+    void sendCurrentStatus();
+
+    // Link baud rate
+    static constexpr uint32_t kBaudVerifyMs = 500;
+    static constexpr uint8_t kBaudErrorBurst = 3;
+    uint32_t _baseBaud = ProtocolLinkBaud::kBase;
+    uint32_t _linkBaud = ProtocolLinkBaud::kBase;
+    bool _baudVerifying = false;
+    uint32_t _baudSwitchMs = 0;
+    uint8_t _baudErrorBurst = 0;
+    uint32_t _baudFallbacks = 0;
+
+    void switchLinkBaud(uint32_t baud);
+    void baudFallback(const char *why);
+    void noteLinkError();
+
+    // Combined actuate-and-report (H;ACT): reply deferred to the next loop().
+    bool _actReplyPending = false;
+    uint16_t _actReplyMask = 0;
+    uint8_t _actReplySeq = 0;
+
+    void queueActReply(uint16_t ackMask, uint8_t seq);
+    void sendActReplyIfPending();
+
+    void sendAckSet(uint16_t mask, uint8_t seq = 0);
     void sendErrSet(int errorCode);
     void sendPong();
 
-    void sendAckUpd(uint16_t newMask);
-    void sendAckTog(uint16_t newMask);
+    void sendAckUpd(uint16_t newMask, uint8_t seq = 0);
+    void sendAckTog(uint16_t newMask, uint8_t seq = 0);
 
-    void sendLine(const String &lineWithCrlf);
+    void sendLine(const char *lineWithCrlf, size_t len);
     void debugLED(bool on = true, int durationMs = 100);
 
     OutputsChangedCallback _onOutputsChanged = nullptr;
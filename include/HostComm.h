@@ -1,7 +1,9 @@
 #pragma once
 
 #include "log_host_comm.h"
+#include "line_assembler.h"
 #include "protocol.h"
+#include "protocol_bin.h"
 #include <Arduino.h>
 
 /**
@@ -20,6 +22,9 @@
  * - Know anything about LVGL or the display
  * - Directly touch any GPIO or hardware except the UART interface
  */
+class HostRxTask;
+struct HostRxEvent;
+
 class HostComm {
   public:
     explicit HostComm(HardwareSerial &serial);
@@ -52,8 +57,15 @@ class HostComm {
 
     // Commands to client
     void sendRst();                                      // sends H;RST
-    void updOutputs(uint16_t setMask, uint16_t clrMask); // sends H;UPD;SSSS;CCCC
-    void togOutputs(uint16_t togMask);                   // sends H;TOG;TTTT
+    // With a command window, false = the queue was full and it was dropped.
+    bool updOutputs(uint16_t setMask, uint16_t clrMask); // sends H;UPD;SSSS;CCCC
+    bool togOutputs(uint16_t togMask);                   // sends H;TOG;TTTT
+
+    // Combined actuate-and-report: the client answers with C;ACK;ACT, i.e.
+    // the ACK mask plus a full STATUS sampled after applying the outputs.
+    // The reply updates getRemoteStatus()/hasNewStatus() and lastSetAcked().
+    bool actuateAndReport(uint16_t setMask, uint16_t clrMask); // sends H;ACT;SSSS;CCCC
+    void setOutputsMaskAndReport(uint16_t mask);               // SET as H;ACT;mask;~mask
 
     bool lastPongReceived() const;
     void clearLastPongFlag();
@@ -79,14 +91,102 @@ class HostComm {
     uint32_t lastRxAnyMs() const { return _lastRxAnyMs; }
     uint32_t lastStatusMs() const { return _lastStatusMs; }
 
+    // Age of the client's sensor sample in the last STATUS / ACK ACT right
+    // now (reported age + time since reception, link latency not included).
+    // UINT32_MAX if the client did not send sample information.
+    uint32_t remoteSampleAgeMs() const;
+
     // NEW: shared RX byte handler + line sanitizer
     void handleRxByte(char c);
     void processCompletedLine(String line);
+    void processCompletedLine(const char *line, size_t len); // view, need not be NUL-terminated
+
+    // Inline RX line assembler (overflow / fragmentation counters)
+    const LineAssembler &rxLines() const { return _lines; }
+
+    // Optional binary link mode (COBS + CRC16, see protocol_bin.h).
+    // When enabled, loop() sends H;BIN;0001 after linkSynced() and switches
+    // TX to binary on C;ACK;BIN;0001. Without an answer it stays on ASCII.
+    // RX always accepts both encodings.
+    void setBinaryModeEnabled(bool enabled);
+    bool binaryModeEnabled() const { return _binaryWanted; }
+    bool binaryActive() const { return _binaryActive; }
+    uint32_t binFrameCount() const { return _binFrameCount; }
+    uint32_t binErrorCount() const { return _binErrorCount; }
+
+    // Pipelined commands (optional). With a window > 0, SET/UPD/TOG carry a
+    // sequence number (;#QQ), up to `window` commands are in flight at once,
+    // each one is retransmitted after kCmdRetransmitMs (kCmdMaxRetries times)
+    // and ACKs are matched by sequence number in any order. Commands beyond
+    // the window wait in a FIFO of kCmdQueueLen entries. A SET (or an ACT
+    // that sets or clears every bit) arriving at a full FIFO supersedes the
+    // queued commands instead of being dropped. After a command
+    // failed or was dropped, the next sequence number jumps by
+    // ProtocolSeq::kTrackSpan so the client does not wait for the lost one.
+    // Window 0 (default) keeps the classic lockstep frames without sequence
+    // numbers.
+    void setCommandWindow(uint8_t window);
+    uint8_t commandWindow() const { return _cmdWindow; }
+    uint8_t commandsPending() const { return static_cast<uint8_t>(_inFlightCount + _cmdQueueCount); }
+
+    // Accounting: sent == acked + failed + dropped + superseded + commandsPending()
+    uint32_t cmdSentCount() const { return _cmdSent; }
+    uint32_t cmdAckedCount() const { return _cmdAcked; }
+    uint32_t cmdRetransmitCount() const { return _cmdRetransmits; }
+    uint32_t cmdFailedCount() const { return _cmdFailed; }   // no ACK after all retries
+    uint32_t cmdDroppedCount() const { return _cmdDropped; } // queue full / link reset
+    uint32_t cmdDupAckCount() const { return _cmdDupAcks; }  // ACK for a seq not in flight
+    uint32_t cmdSupersededCount() const { return _cmdSuperseded; } // queued, replaced by a SET
+
+    // STATUS push subscription (H;SUB, see ProtocolSubTrigger).
+    // When configured, loop() subscribes after linkSynced() and the client
+    // pushes STATUS frames on its own; hasNewStatus() works as with polling.
+    // statusSubscribed() is false until C;ACK;SUB arrives, after the retries
+    // are exhausted, and whenever pushes stop for kSubStaleFactor periods
+    // (the subscription is then renewed). Callers poll while it is false.
+    void setStatusSubscription(uint16_t periodMs, uint16_t triggers);
+    bool statusSubscribed() const { return _subActive; }
+    uint16_t statusPushPeriodMs() const { return _subAckPeriodMs; }
+    uint32_t statusFrameCount() const { return _statusFrameCount; }
+
+    // Link baud rate negotiation (H;BAUD, see ProtocolLinkBaud). With a
+    // target above the begin() rate, loop() proposes the fastest untried
+    // rate <= target after linkSynced(). Both sides switch on C;ACK;BAUD and
+    // keep the rate only if a PING at the new rate is answered within
+    // kBaudVerifyMs. kBaudErrorBurst RX errors in a row or kBaudRxTimeoutMs
+    // without a frame fall back to the begin() rate and re-sync the link;
+    // a rate that failed is not proposed again (the next lower one is).
+    struct LinkRateStats {
+        uint32_t rxFrames; // frames parsed while running at this rate
+        uint32_t rxErrors; // parse/CRC/overflow errors and timeouts at this rate
+        uint16_t upgrades; // verified switches to this rate
+        uint16_t fallbacks;
+    };
+    void setLinkBaudTarget(uint32_t baud); // 0 = keep the begin() rate
+    uint32_t linkBaudTarget() const { return _baudTarget; }
+    uint32_t linkBaud() const { return _linkBaud; }
+    bool linkBaudRaised() const { return _baudState == BaudState::Raised; }
+    uint32_t baudFallbackCount() const { return _baudFallbacks; }
+    // Per-rate counters, index into ProtocolLinkBaud::kRates.
+    const LinkRateStats &linkRateStats(uint8_t rateIndex) const { return _rateStats[rateIndex]; }
+    // rxErrors / (rxFrames + rxErrors) at `baud`, 0 if never used.
+    float linkErrorRate(uint32_t baud) const;
+
+    // Optional RX task (see HostRxTask.h). Once attached and started, the
+    // task owns the UART RX side: loop() no longer reads the UART and only
+    // applies the messages the task has already parsed. nullptr = inline RX.
+    void setRxTask(HostRxTask *task) { _rxTask = task; }
+    HostRxTask *rxTask() const { return _rxTask; }
+
+    // Link traffic counters (bytes written to / read from the UART)
+    uint32_t txBytes() const { return _txBytes; }
+    uint32_t rxBytes() const;
 
   private:
     HardwareSerial &_serial;
     uint8_t _rx, _tx;
-    String _rxBuffer;
+    static constexpr size_t kRxReadBlockLen = 128;
+    LineAssembler _lines;
 
     uint16_t _localOutputsMask;
     ProtocolStatus _remoteStatus;
@@ -105,7 +205,115 @@ class HostComm {
     uint32_t _lastRxAnyMs = 0;  // last time we received ANY valid frame (ACK/STATUS/PONG/RST/...)
     uint32_t _lastStatusMs = 0; // last STATUS timestamp (optional, for diagnostics)
 
-    void handleIncomingLine(const String &line);
+    // Binary link mode
+    static constexpr uint8_t kBinNegotiationAttempts = 3;
+    static constexpr uint32_t kBinNegotiationRetryMs = 300;
+    bool _binaryWanted = false;
+    bool _binaryActive = false;
+    bool _binaryGaveUp = false;
+    uint8_t _binaryAttempts = 0;
+    uint32_t _binaryLastReqMs = 0;
+    uint32_t _binFrameCount = 0;
+    uint32_t _binErrorCount = 0;
+    ProtocolBinRx _binRx;
+
+    // Pipelined commands
+    static constexpr uint8_t kMaxCommandWindow = 8;
+    static constexpr uint8_t kCmdQueueLen = 8;
+    static constexpr uint32_t kCmdRetransmitMs = 150;
+    static constexpr uint8_t kCmdMaxRetries = 3;
+
+    struct InFlightCommand {
+        ProtocolMessage msg;
+        uint32_t sentMs;
+        uint8_t retries;
+        bool acked;
+    };
+
+    uint8_t _cmdWindow = 0; // 0 = lockstep, no sequence numbers
+    uint8_t _nextSeq = 1;
+    bool _seqResync = false; // a number was given up on: the next one jumps
+    InFlightCommand _inFlight[kMaxCommandWindow];
+    uint8_t _inFlightHead = 0;
+    uint8_t _inFlightCount = 0;
+    ProtocolMessage _cmdQueue[kCmdQueueLen];
+    uint8_t _cmdQueueHead = 0;
+    uint8_t _cmdQueueCount = 0;
+    uint32_t _cmdSent = 0;
+    uint32_t _cmdAcked = 0;
+    uint32_t _cmdRetransmits = 0;
+    uint32_t _cmdFailed = 0;
+    uint32_t _cmdDropped = 0;
+    uint32_t _cmdDupAcks = 0;
+    uint32_t _cmdSuperseded = 0;
+
+    // STATUS push subscription
+    static constexpr uint8_t kSubAttempts = 3;
+    static constexpr uint32_t kSubRetryMs = 300;
+    static constexpr uint8_t kSubStaleFactor = 3;
+    uint16_t _subPeriodMs = 0; // requested, 0 = no subscription wanted
+    uint16_t _subTriggers = 0;
+    uint16_t _subAckPeriodMs = 0;
+    bool _subActive = false;
+    bool _subGaveUp = false;
+    uint8_t _subAttempts = 0;
+    uint32_t _subLastReqMs = 0;
+    uint32_t _subLastRxMs = 0; // last C;ACK;SUB or STATUS while subscribed
+    uint32_t _statusFrameCount = 0;
+
+    // Link baud rate negotiation
+    enum class BaudState : uint8_t { Base, Proposed, Verifying, Raised };
+    static constexpr size_t kLinkRxBufferSize = 1024;
+    static constexpr uint8_t kBaudProposeAttempts = 3;
+    static constexpr uint32_t kBaudProposeRetryMs = 300;
+    static constexpr uint32_t kBaudVerifyMs = 300;
+    static constexpr uint32_t kBaudVerifyPingMs = 100;
+    static constexpr uint8_t kBaudErrorBurst = 3;
+    static constexpr uint32_t kBaudRxTimeoutMs = 1500;
+    uint32_t _baudTarget = 0;
+    uint32_t _baseBaud = ProtocolLinkBaud::kBase;
+    uint32_t _linkBaud = ProtocolLinkBaud::kBase;
+    BaudState _baudState = BaudState::Base;
+    uint8_t _baudCandidate = 0;  // index into ProtocolLinkBaud::kRates
+    uint8_t _baudFailedMask = 0; // bit per kRates index
+    uint8_t _baudAttempts = 0;
+    uint8_t _baudErrorBurst = 0; // RX errors since the last good frame
+    uint32_t _baudStateMs = 0;   // last proposal / switch
+    uint32_t _baudLastPingMs = 0;
+    uint32_t _baudLastGoodMs = 0;
+    uint32_t _baudFallbacks = 0;
+    LinkRateStats _rateStats[ProtocolLinkBaud::kRateCount] = {};
+
+    uint32_t _txBytes = 0;
+    uint32_t _rxBytes = 0;
+
+    HostRxTask *_rxTask = nullptr;
+
+    void handleIncomingLine(const char *line, size_t len);
+    void setLastBadLine(const char *line, size_t len);
+    void handleBinaryFrame();
+    void handleMessage(const ProtocolMessage &msg);
+    void applyRxEvent(const HostRxEvent &ev);
+    void binaryNegotiationTick();
+    void statusSubscriptionTick();
+    bool sendCommand(ProtocolMessage msg);
+    void commandWindowTick();
+    void transmitQueuedCommands();
+    void matchCommandAck(uint8_t seq);
+    void dropPendingCommands();
+    void resetStatusSubscription();
+    void baudNegotiationTick();
+    void sendBaudProposal();
+    void handleBaudAck(uint16_t rateField);
+    void switchLinkBaud(uint32_t baud);
+    void baudFallback(const char *why);
+    void noteLinkFrame();
+    void noteLinkError();
+
+    static ProtocolMessage makeMessage(ProtocolMessageType type);
+    size_t encodeMessage(const ProtocolMessage &msg, char *buf, size_t cap) const;
+    void sendMessage(const ProtocolMessage &msg);
+    void sendFrame(const char *frame, size_t len);
 };
 
 // END OF FILE
\ No newline at end of file
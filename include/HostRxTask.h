@@ -0,0 +1,155 @@
+#pragma once
+
+#include "line_assembler.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+#include "spsc_ring.h"
+#include <Arduino.h>
+#include <atomic>
+
+#if !defined(ARDUINO_ARCH_ESP32)
+#include <thread>
+#endif
+
+// ============================================================================
+//  HostRxTask.h
+//
+//  Optional receive pipeline for HostComm that runs off the UI core.
+//
+//    UART driver -> HostRxTask (block read, line split, parse)
+//                -> SpscRing<HostRxEvent> -> HostComm::loop() (state only)
+//
+//  Without a task, HostComm::loop() reads and parses the UART itself,
+//  so a long LVGL render stalls the whole RX path. With a task attached
+//  (HostComm::setRxTask) the UART FIFO is emptied and frames are parsed
+//  while the UI core renders; loop() only applies ready-made messages.
+//
+//  - ESP32: FreeRTOS task pinned to the non-UI core, woken by the UART
+//           driver's RX event (HardwareSerial::onReceive)
+//  - native: std::thread polling the in-memory HardwareSerial, so the same
+//           pipeline can be stress-tested on the PC
+// ============================================================================
+
+// One decoded RX item. Errors are forwarded as events as well, so HostComm
+// keeps exactly the same counters as with inline parsing.
+struct HostRxEvent {
+    enum class Kind : uint8_t {
+        Frame = 0,    // msg is valid
+        ParseError,   // ASCII line rejected by ProtocolCodec (text = line)
+        JunkLine,     // ASCII line without 'C'/'H' (text = line)
+        LineOverflow, // ASCII line longer than LineAssembler::kMaxLineLen, dropped
+        BinError,     // binary frame rejected (COBS/CRC/length)
+        BinOverflow,  // binary frame longer than kMaxCobsLen, dropped
+    };
+
+    static constexpr size_t kTextLen = 48; // bad line excerpt, NUL-terminated
+
+    Kind kind;
+    bool binary; // Frame/BinError: came from the COBS decoder
+    ProtocolMessage msg;
+    char text[kTextLen];
+};
+
+// ----------------------------------------------------------------------------
+//  Byte stream -> HostRxEvent, same rules as the inline HostComm path
+//  (LineAssembler + ProtocolBinRx, then trim / leading junk / parse).
+//  Fixed buffers only, no String.
+// ----------------------------------------------------------------------------
+class HostRxDecoder {
+  public:
+    // emit(const HostRxEvent &) is called for every decoded item.
+    template <typename Emit>
+    void feed(const uint8_t *data, size_t len, Emit &&emit) {
+        HostRxEvent ev;
+        _lines.feedLink(
+            _binRx, data, len,
+            [&](const char *line, size_t n) {
+                if (lineEvent(line, n, ev)) {
+                    emit(ev);
+                }
+            },
+            [&]() {
+                setEvent(ev, HostRxEvent::Kind::LineOverflow, false);
+                emit(ev);
+            },
+            [&](ProtocolBinRx::Result r) {
+                binaryEvent(r, ev);
+                emit(ev);
+            });
+    }
+    void reset();
+    const LineAssembler &lines() const { return _lines; }
+
+  private:
+    LineAssembler _lines;
+    ProtocolBinRx _binRx;
+
+    bool lineEvent(const char *line, size_t len, HostRxEvent &ev);
+    void binaryEvent(ProtocolBinRx::Result r, HostRxEvent &ev);
+    static void setEvent(HostRxEvent &ev, HostRxEvent::Kind kind, bool binary);
+    static void setText(HostRxEvent &ev, const char *data, size_t len);
+};
+
+class HostRxTask {
+  public:
+    static constexpr size_t kQueueLen = 32;       // events, power of two
+    static constexpr size_t kReadBlockLen = 128;  // bytes per driver read
+    static constexpr uint32_t kIdleWaitMs = 5;    // wake-up without RX event
+    static constexpr int kDefaultCore = 0;        // Arduino loop()/LVGL run on core 1
+    static constexpr uint32_t kStackSize = 4096;
+    static constexpr uint8_t kPriority = 5;
+
+    explicit HostRxTask(HardwareSerial &serial);
+    ~HostRxTask();
+
+    bool start(int core = kDefaultCore);
+    void stop();
+    bool running() const { return _running.load(std::memory_order_acquire); }
+
+    // Consumer side (HostComm::loop)
+    bool pop(HostRxEvent &ev) { return _queue.pop(ev); }
+
+    // Called on the RX task after a read produced events, e.g. to wake a
+    // consumer loop that sleeps until its next deadline. Set before start().
+    using WakeCallback = void (*)(void *ctx);
+    void setWakeCallback(WakeCallback cb, void *ctx) {
+        _wakeCb = cb;
+        _wakeCtx = ctx;
+    }
+
+    // Drop a half-assembled line/frame before the next read, e.g. after the
+    // link changed its baud rate. Safe to call from the consumer side.
+    void requestDecoderReset() { _resetRequested.store(true, std::memory_order_release); }
+
+    // Diagnostics
+    uint32_t rxBytes() const { return _rxBytes.load(std::memory_order_relaxed); }
+    uint32_t eventCount() const { return _events.load(std::memory_order_relaxed); }
+    uint32_t droppedEvents() const { return _queue.dropped(); }
+    uint32_t queueHighWater() const { return _queue.highWater(); }
+    uint32_t wakeups() const { return _wakeups.load(std::memory_order_relaxed); }
+
+  private:
+    HardwareSerial &_serial;
+    HostRxDecoder _decoder;
+    SpscRing<HostRxEvent, kQueueLen> _queue;
+    std::atomic<bool> _running{false};
+    std::atomic<bool> _stopRequested{false};
+    std::atomic<bool> _resetRequested{false};
+    std::atomic<uint32_t> _rxBytes{0};
+    std::atomic<uint32_t> _events{0};
+    std::atomic<uint32_t> _wakeups{0};
+    WakeCallback _wakeCb = nullptr;
+    void *_wakeCtx = nullptr;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    TaskHandle_t _handle = nullptr;
+    static void taskEntry(void *arg);
+#else
+    std::thread _thread;
+#endif
+
+    void run();
+    size_t drainOnce(); // one block read + decode, returns bytes consumed
+};
+
+// EOF
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+//  ads1115_async.h
+//
+//  Non-blocking ADS1115 driver: chained single-shot conversions, paced by
+//  the ALERT/RDY pin, cycling the input mux over AIN0..AIN3.
+//
+//  - begin() puts ALERT/RDY into conversion-ready mode (Hi_thresh MSB = 1,
+//    Lo_thresh MSB = 0, COMP_QUE = 1 conversion) and starts AIN0
+//  - the RDY interrupt only wakes the sampling task; the task calls
+//    onReady(), which reads the finished channel and immediately starts the
+//    next one with a single config write (no polling, no delay)
+//  - single-shot instead of continuous mode: every conversion is started
+//    with its own mux setting, so no stale conversion has to be discarded
+//    after a mux switch
+//  - onTimeout() covers a missed edge (or an unwired RDY pin): one config
+//    read tells whether the conversion finished; otherwise it is restarted
+//  - all register access goes through Ads1115Bus, so the state machine runs
+//    natively against a mock (test_native_ads1115)
+// ============================================================================
+
+// Register access used by the driver (big-endian 16-bit registers).
+class Ads1115Bus {
+  public:
+    virtual ~Ads1115Bus() = default;
+    virtual bool writeReg(uint8_t addr, uint8_t reg, uint16_t value) = 0;
+    virtual bool readReg(uint8_t addr, uint8_t reg, uint16_t &value) = 0;
+};
+
+class Ads1115Async {
+  public:
+    static constexpr uint8_t kChannels = 4;
+
+    // Register pointers
+    static constexpr uint8_t kRegConversion = 0x00;
+    static constexpr uint8_t kRegConfig = 0x01;
+    static constexpr uint8_t kRegLoThresh = 0x02;
+    static constexpr uint8_t kRegHiThresh = 0x03;
+
+    // Config register fields
+    static constexpr uint16_t kCfgOsStart = 0x8000;    // write: start, read: 1 = idle
+    static constexpr uint16_t kCfgMuxSingle0 = 0x4000; // AINx vs GND = 0x4000 + x * 0x1000
+    static constexpr uint16_t kCfgPga6144 = 0x0000;    // +-6.144 V (GAIN_TWOTHIRDS)
+    static constexpr uint16_t kCfgModeSingle = 0x0100;
+    static constexpr uint16_t kCfgCompQue1 = 0x0000; // ALERT/RDY after every conversion
+
+    enum class DataRate : uint16_t {
+        Sps128 = 0x0080,
+        Sps250 = 0x00A0,
+        Sps475 = 0x00C0,
+        Sps860 = 0x00E0,
+    };
+
+    explicit Ads1115Async(Ads1115Bus &bus, uint8_t addr = 0x48, DataRate rate = DataRate::Sps860,
+                          uint16_t pga = kCfgPga6144);
+
+    // Configure ALERT/RDY and start the first conversion (AIN0).
+    bool begin();
+
+    // ALERT/RDY fired: read the finished channel and start the next one.
+    // Returns true when the conversion completed a full AIN0..AIN3 round.
+    bool onReady();
+
+    // No RDY within timeoutUs(): poll OS once and finish or restart.
+    bool onTimeout();
+
+    // Without RDY interrupt: finish the conversion if OS reports idle.
+    // Same return value as onReady(); false while still converting.
+    bool poll();
+
+    // Latest conversion of each channel (raw counts).
+    int16_t raw(uint8_t ch) const { return (ch < kChannels) ? _raw[ch] : 0; }
+    const int16_t *rawAll() const { return _raw; }
+    uint8_t channel() const { return _channel; } // channel currently converting
+
+    // Worst-case conversion time incl. the -10 % oscillator tolerance.
+    uint32_t conversionUs() const;
+    uint32_t timeoutUs() const { return 2 * conversionUs() + 1000; }
+
+    uint16_t configWord(uint8_t ch) const;
+
+    // Counters (wrap at 2^32)
+    uint32_t conversionCount() const { return _conversions; }
+    uint32_t roundCount() const { return _rounds; }
+    uint32_t busErrorCount() const { return _busErrors; }
+    uint32_t timeoutCount() const { return _timeouts; }
+
+  private:
+    bool startConversion();
+    bool finishConversion();
+
+    Ads1115Bus &_bus;
+    uint8_t _addr;
+    DataRate _rate;
+    uint16_t _pga;
+
+    uint8_t _channel = 0;
+    bool _started = false; // last config write for _channel succeeded
+    int16_t _raw[kChannels] = {};
+
+    uint32_t _conversions = 0;
+    uint32_t _rounds = 0;
+    uint32_t _busErrors = 0;
+    uint32_t _timeouts = 0;
+};
+
+// EOF
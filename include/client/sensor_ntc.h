@@ -7,6 +7,8 @@ namespace sensor_ntc {
 struct Sample {
     bool adsOk = false;
 
+    int16_t raw[4] = {}; // ADS1115 counts AIN0..AIN3 of the same round
+
     int16_t rawHotspot = 0;
     int32_t hot_mV = 0;
     int32_t hot_ohm = -1;
@@ -19,13 +21,37 @@ struct Sample {
     int32_t cha_ohm = 0;
     int16_t cha_dC = -32768;
     float tempChamberC = 0.0f / 0.0f; // NAN
+
+    // Filtered temperatures (ntc::HotspotFilter / ChamberFilter), invalid
+    // whenever the raw conversion above is invalid.
+    int16_t hotFilt_dC = -32768;
+    int16_t chaFilt_dC = -32768;
+
+    // Sensor fault mask as sent in STATUS (ntc_fault.h).
+    uint16_t sensorFaults = 0;
+
+    uint16_t seq = 0;      // increments per published sample, skips 0 (0 = none yet)
+    uint32_t sampleMs = 0; // millis() when the round finished
 };
 
 void init_door();
 void init_i2c_and_ads();
 bool is_door_open();
 
+// Blocking fallback: poll one AIN0..AIN3 round and publish it.
+// Does nothing while the sampling task runs.
 void sample_temperatures();
-const Sample &get_sample();
+
+// Start the sampling task (core 0): chained conversions paced by the
+// ADS1115 ALERT/RDY interrupt, one published sample per round (~215/s).
+// Call once after init_i2c_and_ads().
+bool start_sampling();
+bool sampling_running();
+
+// Latest published sample (seqlock snapshot, never blocks on I2C).
+Sample get_sample();
+
+// Age of a published sample in ms (UINT32_MAX if s.seq == 0).
+uint32_t sample_age_ms(const Sample &s);
 
 } // namespace sensor_ntc
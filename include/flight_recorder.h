@@ -0,0 +1,594 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+//  flight_recorder.h
+//
+//  Always-on run history of the host: one FlightSample per second in a RAM
+//  ring (PSRAM on the board), compressed per field against the previous
+//  sample. Independent of any PC listening on UDP.
+//
+//  Ring of fixed-size blocks; every block decodes on its own:
+//
+//    block:  u8 0xFA | u8 version | u16 used | u16 count | u16 0 | u32 seq
+//            sample ...                              (all little endian)
+//    sample: u8 mask, then only the parts the mask names
+//      kMaskChamber/Hotspot/Target  zig-zag varint delta (dC)
+//      kMaskFlags                   flags byte (kFlag...)
+//      kMaskStage                   stage byte, mode byte
+//      kMaskTime                    varint seconds since the previous
+//                                   sample (absent: 1 s)
+//    The first sample of a block is a key sample: every bit set, values
+//    absolute, time = absolute uptime seconds.
+//
+//  - a steady hold costs 2..3 bytes per sample; a full block is closed and
+//    the oldest block is overwritten, so the ring always holds the newest
+//    history (24 h ~ 240 KB, see test_native_flight_recorder)
+//  - freeze(post): keeps recording post more samples, then stops; the
+//    history around a safety event stays until resume()
+//  - blocks are read by their seq, which tells a dump whether the block was
+//    overwritten in the meantime
+//
+//  Platform-free (recorder, decoder, dump lines); src/app/flight_recorder.cpp
+//  owns the PSRAM buffer, the dump and the oven hook.
+// ============================================================================
+
+#ifndef FLIGHT_REC_BYTES
+#define FLIGHT_REC_BYTES (1024u * 1024u)
+#endif
+#ifndef FLIGHT_REC_BLOCK_BYTES
+#define FLIGHT_REC_BLOCK_BYTES 512u // one dump line of 1 KB hex per block
+#endif
+#ifndef FLIGHT_REC_POST_TRIGGER_S
+#define FLIGHT_REC_POST_TRIGGER_S 120u // samples kept after a freeze request
+#endif
+
+namespace flight_rec {
+
+static constexpr uint8_t kBlockMagic = 0xFA;
+static constexpr uint8_t kBlockVersion = 1;
+static constexpr size_t kBlockHeader = 12;
+static constexpr size_t kMaxSampleBytes = 1 + 3 * 3 + 1 + 2 + 5;
+
+enum SampleMask : uint8_t {
+    kMaskChamber = 0x01,
+    kMaskHotspot = 0x02,
+    kMaskTarget = 0x04,
+    kMaskFlags = 0x08,
+    kMaskStage = 0x10,
+    kMaskTime = 0x20,
+    kMaskKey = 0x3F,
+};
+
+enum SampleFlag : uint8_t {
+    kFlagHeaterReq = 0x01,
+    kFlagHeaterActual = 0x02,
+    kFlagDoorOpen = 0x04,
+    kFlagSafety = 0x08,
+    kFlagRunning = 0x10,
+    kFlagCommAlive = 0x20,
+};
+
+struct FlightSample {
+    uint32_t t_s; // uptime seconds
+    int16_t chamber_dC;
+    int16_t hotspot_dC;
+    int16_t target_dC;
+    uint8_t flags; // SampleFlag bits
+    uint8_t stage; // HeaterControlStage
+    uint8_t mode;  // OvenMode
+};
+
+inline bool operator==(const FlightSample &a, const FlightSample &b) {
+    return a.t_s == b.t_s && a.chamber_dC == b.chamber_dC && a.hotspot_dC == b.hotspot_dC &&
+           a.target_dC == b.target_dC && a.flags == b.flags && a.stage == b.stage && a.mode == b.mode;
+}
+
+// ----------------------------------------------------------------------------
+// Sample codec
+// ----------------------------------------------------------------------------
+
+inline size_t putVarint(uint8_t *out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80u) {
+        out[n++] = static_cast<uint8_t>(v | 0x80u);
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+inline uint32_t zigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+inline int32_t unzigzag(uint32_t v) { return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1u); }
+
+// prev == nullptr: key sample. Returns the bytes written (<= kMaxSampleBytes).
+inline size_t encodeSample(uint8_t *out, const FlightSample &s, const FlightSample *prev) {
+    uint8_t mask = kMaskKey;
+    int32_t dCh = s.chamber_dC;
+    int32_t dHot = s.hotspot_dC;
+    int32_t dTgt = s.target_dC;
+    uint32_t dt = s.t_s;
+    if (prev) {
+        dCh -= prev->chamber_dC;
+        dHot -= prev->hotspot_dC;
+        dTgt -= prev->target_dC;
+        dt -= prev->t_s;
+        mask = 0;
+        mask |= dCh ? kMaskChamber : 0;
+        mask |= dHot ? kMaskHotspot : 0;
+        mask |= dTgt ? kMaskTarget : 0;
+        mask |= s.flags != prev->flags ? kMaskFlags : 0;
+        mask |= (s.stage != prev->stage || s.mode != prev->mode) ? kMaskStage : 0;
+        mask |= dt != 1u ? kMaskTime : 0;
+    }
+    size_t n = 0;
+    out[n++] = mask;
+    if (mask & kMaskChamber) {
+        n += putVarint(out + n, zigzag(dCh));
+    }
+    if (mask & kMaskHotspot) {
+        n += putVarint(out + n, zigzag(dHot));
+    }
+    if (mask & kMaskTarget) {
+        n += putVarint(out + n, zigzag(dTgt));
+    }
+    if (mask & kMaskFlags) {
+        out[n++] = s.flags;
+    }
+    if (mask & kMaskStage) {
+        out[n++] = s.stage;
+        out[n++] = s.mode;
+    }
+    if (mask & kMaskTime) {
+        n += putVarint(out + n, dt);
+    }
+    return n;
+}
+
+inline bool getVarint(const uint8_t *p, size_t n, size_t &pos, uint32_t *out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= n) {
+            return false;
+        }
+        const uint8_t b = p[pos++];
+        v |= static_cast<uint32_t>(b & 0x7Fu) << shift;
+        if (!(b & 0x80u)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Decodes one sample at p[pos]; prev is the previous sample of the block
+// (ignored for the key sample, which must carry every part).
+inline bool decodeSample(const uint8_t *p, size_t n, size_t &pos, bool key, const FlightSample &prev,
+                         FlightSample *out) {
+    if (pos >= n) {
+        return false;
+    }
+    const uint8_t mask = p[pos++];
+    if ((mask & ~kMaskKey) || (key && mask != kMaskKey)) {
+        return false;
+    }
+    FlightSample s = key ? FlightSample() : prev;
+    uint32_t v;
+    if (mask & kMaskChamber) {
+        if (!getVarint(p, n, pos, &v)) {
+            return false;
+        }
+        s.chamber_dC = static_cast<int16_t>(s.chamber_dC + unzigzag(v));
+    }
+    if (mask & kMaskHotspot) {
+        if (!getVarint(p, n, pos, &v)) {
+            return false;
+        }
+        s.hotspot_dC = static_cast<int16_t>(s.hotspot_dC + unzigzag(v));
+    }
+    if (mask & kMaskTarget) {
+        if (!getVarint(p, n, pos, &v)) {
+            return false;
+        }
+        s.target_dC = static_cast<int16_t>(s.target_dC + unzigzag(v));
+    }
+    if (mask & kMaskFlags) {
+        if (pos >= n) {
+            return false;
+        }
+        s.flags = p[pos++];
+    }
+    if (mask & kMaskStage) {
+        if (pos + 2 > n) {
+            return false;
+        }
+        s.stage = p[pos++];
+        s.mode = p[pos++];
+    }
+    if (mask & kMaskTime) {
+        if (!getVarint(p, n, pos, &v)) {
+            return false;
+        }
+        s.t_s = key ? v : s.t_s + v;
+    } else {
+        s.t_s += 1u;
+    }
+    *out = s;
+    return true;
+}
+
+inline uint16_t getU16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline uint32_t getU32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+inline void putU16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+inline void putU32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+struct BlockInfo {
+    uint32_t seq;
+    uint16_t used;
+    uint16_t count;
+};
+
+inline bool parseBlockHeader(const uint8_t *p, size_t n, BlockInfo *out) {
+    if (n < kBlockHeader || p[0] != kBlockMagic || p[1] != kBlockVersion) {
+        return false;
+    }
+    out->used = getU16(p + 2);
+    out->count = getU16(p + 4);
+    out->seq = getU32(p + 8);
+    return out->used >= kBlockHeader && out->used <= n;
+}
+
+// Calls onSample(const FlightSample &) for every sample of a block. Returns
+// the number of samples, -1 if the block is malformed.
+template <typename OnSample>
+inline int decodeBlock(const uint8_t *p, size_t n, OnSample &&onSample) {
+    BlockInfo info;
+    if (!parseBlockHeader(p, n, &info)) {
+        return -1;
+    }
+    size_t pos = kBlockHeader;
+    FlightSample prev = FlightSample();
+    for (uint16_t i = 0; i < info.count; ++i) {
+        FlightSample s;
+        if (!decodeSample(p, info.used, pos, i == 0, prev, &s)) {
+            return -1;
+        }
+        onSample(s);
+        prev = s;
+    }
+    return pos == info.used ? static_cast<int>(info.count) : -1;
+}
+
+// ----------------------------------------------------------------------------
+// Recorder
+// ----------------------------------------------------------------------------
+
+class Recorder {
+  public:
+    struct Stats {
+        uint32_t samples;    // appended since reset (incl. overwritten)
+        uint32_t held;       // samples in the ring now
+        uint32_t bytesHeld;  // incl. block headers
+        uint32_t blocksHeld; // incl. the open one
+        uint32_t evicted;    // blocks overwritten
+        uint32_t ignored;    // appends while frozen
+        uint32_t oldest_s;
+        uint32_t newest_s;
+    };
+
+    Recorder() {}
+    Recorder(uint8_t *buf, size_t bytes, size_t blockBytes = FLIGHT_REC_BLOCK_BYTES) { attach(buf, bytes, blockBytes); }
+
+    // Takes a buffer of at least two blocks (the rest of a block is unused).
+    bool attach(uint8_t *buf, size_t bytes, size_t blockBytes = FLIGHT_REC_BLOCK_BYTES) {
+        if (!buf || blockBytes < kBlockHeader + 2 * kMaxSampleBytes || blockBytes > 0xFFFFu ||
+            bytes / blockBytes < 2) {
+            _buf = nullptr;
+            return false;
+        }
+        _buf = buf;
+        _blockBytes = blockBytes;
+        _blocks = static_cast<uint32_t>(bytes / blockBytes);
+        reset();
+        return true;
+    }
+
+    void reset() {
+        _nextSeq = 0;
+        _firstSeq = 0;
+        _open = false;
+        _frozen = false;
+        _postLeft = 0;
+        _freezeArmed = false;
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+    bool ready() const { return _buf != nullptr; }
+    size_t capacityBytes() const { return static_cast<size_t>(_blocks) * _blockBytes; }
+    size_t blockBytes() const { return _blockBytes; }
+
+    // false: frozen (or no buffer), the sample is not stored.
+    bool append(const FlightSample &s) {
+        if (!_buf) {
+            return false;
+        }
+        if (_frozen) {
+            _stats.ignored++;
+            return false;
+        }
+        uint8_t enc[kMaxSampleBytes];
+        size_t n = _open ? encodeSample(enc, s, &_prev) : 0;
+        if (!_open || _used + n > _blockBytes) {
+            openBlock();
+            n = encodeSample(enc, s, nullptr);
+        }
+        uint8_t *b = block(_nextSeq - 1);
+        memcpy(b + _used, enc, n);
+        _used += static_cast<uint16_t>(n);
+        _count++;
+        putU16(b + 2, _used);
+        putU16(b + 4, _count);
+        _prev = s;
+
+        _stats.samples++;
+        _stats.held++;
+        _stats.bytesHeld += static_cast<uint32_t>(n);
+        _stats.newest_s = s.t_s;
+        if (_stats.held == 1) {
+            _stats.oldest_s = s.t_s;
+        }
+        if (_freezeArmed && _postLeft-- == 0) {
+            _frozen = true;
+            _freezeArmed = false;
+        }
+        return true;
+    }
+
+    // Stops recording after postSamples more samples (0: right away). A
+    // pending or active freeze is kept as it is.
+    void freeze(uint32_t postSamples = FLIGHT_REC_POST_TRIGGER_S) {
+        if (_frozen || _freezeArmed) {
+            return;
+        }
+        if (postSamples == 0) {
+            _frozen = true;
+        } else {
+            _freezeArmed = true;
+            _postLeft = postSamples - 1;
+        }
+    }
+    void resume() {
+        _frozen = false;
+        _freezeArmed = false;
+    }
+    bool frozen() const { return _frozen; }
+    bool freezePending() const { return _freezeArmed; }
+
+    // Blocks by seq: firstSeq() .. lastSeq() are held (the last one may
+    // still grow) unless empty().
+    bool empty() const { return _nextSeq == 0; }
+    uint32_t firstSeq() const { return _firstSeq; }
+    uint32_t lastSeq() const { return _nextSeq - 1; }
+
+    // The block with this seq, nullptr once it was overwritten.
+    const uint8_t *blockBySeq(uint32_t seq, size_t *len) const {
+        if (!_buf || _nextSeq == 0 || seq < _firstSeq || seq >= _nextSeq) {
+            return nullptr;
+        }
+        const uint8_t *b = block(seq);
+        if (len) {
+            *len = getU16(b + 2);
+        }
+        return b;
+    }
+
+    Stats stats() const {
+        Stats s = _stats;
+        s.blocksHeld = _nextSeq - _firstSeq;
+        s.bytesHeld += s.blocksHeld * static_cast<uint32_t>(kBlockHeader);
+        return s;
+    }
+
+  private:
+    uint8_t *block(uint32_t seq) const { return _buf + static_cast<size_t>(seq % _blocks) * _blockBytes; }
+
+    void openBlock() {
+        if (_nextSeq - _firstSeq >= _blocks) {
+            // overwrite the oldest block
+            const uint8_t *old = block(_firstSeq);
+            const uint16_t oldCount = getU16(old + 4);
+            const uint16_t oldUsed = getU16(old + 2);
+            _stats.held -= oldCount;
+            _stats.bytesHeld -= static_cast<uint32_t>(oldUsed - kBlockHeader);
+            _stats.evicted++;
+            _firstSeq++;
+            _stats.oldest_s = firstTimeOf(_firstSeq);
+        }
+        uint8_t *b = block(_nextSeq);
+        b[0] = kBlockMagic;
+        b[1] = kBlockVersion;
+        putU16(b + 6, 0);
+        putU32(b + 8, _nextSeq);
+        _used = static_cast<uint16_t>(kBlockHeader);
+        _count = 0;
+        putU16(b + 2, _used);
+        putU16(b + 4, 0);
+        _nextSeq++;
+        _open = true;
+    }
+
+    // Time of a block's key sample (its absolute uptime).
+    uint32_t firstTimeOf(uint32_t seq) const {
+        const uint8_t *b = block(seq);
+        if (getU16(b + 4) == 0) {
+            return _prev.t_s;
+        }
+        FlightSample s;
+        size_t pos = kBlockHeader;
+        return decodeSample(b, getU16(b + 2), pos, true, FlightSample(), &s) ? s.t_s : 0;
+    }
+
+    uint8_t *_buf = nullptr;
+    size_t _blockBytes = 0;
+    uint32_t _blocks = 0;
+    uint32_t _nextSeq = 0;
+    uint32_t _firstSeq = 0;
+    bool _open = false;
+    uint16_t _used = 0;
+    uint16_t _count = 0;
+    FlightSample _prev = FlightSample();
+    bool _frozen = false;
+    bool _freezeArmed = false;
+    uint32_t _postLeft = 0;
+    Stats _stats;
+};
+
+// ----------------------------------------------------------------------------
+// Dump lines
+// ----------------------------------------------------------------------------
+//
+//   [FR] BEGIN blocks=<n> samples=<n> frozen=<0|1> now_s=<uptime>
+//   [FR] B <hex of the block> <fnv1a-32 of the block bytes, 8 hex>
+//   [FR] END blocks=<n> skipped=<n>
+//
+// One block per line (FLIGHT_REC_BLOCK_BYTES 512 -> ~1050 characters, one
+// UDP datagram). tools/flight_decode turns a captured console or UDP log
+// into CSV.
+
+inline uint32_t fnv1a(const uint8_t *p, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; ++i) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+inline size_t blockLineLen(size_t blockLen) { return 7 + 2 * blockLen + 1 + 8 + 1; }
+
+// Writes "[FR] B <hex> <crc>\n" into out (blockLineLen() bytes, no NUL).
+inline size_t formatBlockLine(char *out, const uint8_t *block, size_t len) {
+    static const char kHex[] = "0123456789abcdef";
+    size_t n = 0;
+    memcpy(out, "[FR] B ", 7);
+    n = 7;
+    for (size_t i = 0; i < len; ++i) {
+        out[n++] = kHex[block[i] >> 4];
+        out[n++] = kHex[block[i] & 0x0F];
+    }
+    out[n++] = ' ';
+    const uint32_t crc = fnv1a(block, len);
+    for (int i = 7; i >= 0; --i) {
+        out[n++] = kHex[(crc >> (4 * i)) & 0x0F];
+    }
+    out[n++] = '\n';
+    return n;
+}
+
+inline int hexNibble(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Parses a block line (leading text before "[FR] B " allowed, e.g. a
+// timestamp or the ';' of a UDP-only line). out needs FLIGHT_REC_BLOCK_BYTES.
+// Returns the block length, 0 if the line is no block line or is damaged.
+inline size_t parseBlockLine(const char *line, size_t len, uint8_t *out, size_t cap) {
+    const char *tag = nullptr;
+    for (size_t i = 0; i + 7 <= len; ++i) {
+        if (memcmp(line + i, "[FR] B ", 7) == 0) {
+            tag = line + i + 7;
+            break;
+        }
+    }
+    if (!tag) {
+        return 0;
+    }
+    const char *end = line + len;
+    while (end > tag && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ')) {
+        end--;
+    }
+    const char *space = tag;
+    while (space < end && *space != ' ') {
+        space++;
+    }
+    const size_t hexLen = static_cast<size_t>(space - tag);
+    if (hexLen % 2 || hexLen / 2 > cap || end - space != 9) {
+        return 0;
+    }
+    for (size_t i = 0; i < hexLen / 2; ++i) {
+        const int hi = hexNibble(tag[2 * i]);
+        const int lo = hexNibble(tag[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return 0;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    uint32_t crc = 0;
+    for (int i = 1; i <= 8; ++i) {
+        const int v = hexNibble(space[i]);
+        if (v < 0) {
+            return 0;
+        }
+        crc = (crc << 4) | static_cast<uint32_t>(v);
+    }
+    return crc == fnv1a(out, hexLen / 2) ? hexLen / 2 : 0;
+}
+
+} // namespace flight_rec
+
+// ----------------------------------------------------------------------------
+// Host API (src/app/flight_recorder.cpp)
+// ----------------------------------------------------------------------------
+
+enum FlightDumpTarget : uint8_t {
+    FLIGHT_DUMP_SERIAL = 0,
+    FLIGHT_DUMP_UDP,
+};
+
+// Allocates the ring (PSRAM if present). false: no memory, recording off.
+bool flight_recorder_init(void);
+
+// One sample; the caller paces it (once per second from oven_comm_poll).
+void flight_recorder_append(const flight_rec::FlightSample &sample);
+
+// Safety event: keep FLIGHT_REC_POST_TRIGGER_S more samples, then stop.
+void flight_recorder_freeze(const char *reason);
+void flight_recorder_resume(void);
+
+// Dump the ring, FLIGHT_REC_DUMP_LINES_SERIAL/_UDP lines per
+// flight_recorder_dump_step() (main-loop timer). Recording goes on; blocks
+// overwritten meanwhile are skipped.
+bool flight_recorder_dump_start(FlightDumpTarget target);
+void flight_recorder_dump_step(void);
+bool flight_recorder_dumping(void);
+
+// "[FR] ..." status line: held samples and hours, bytes per sample, encode
+// time in oven_comm_poll.
+void flight_recorder_print_stats(void);
+
+// Console command: "fr" (stats), "fr dump", "fr dump udp", "fr freeze",
+// "fr resume". false: not an "fr" command.
+bool flight_recorder_command(const char *line, size_t len);
+
+// EOF
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <stdint.h>
+
+// ============================================================================
+//  heater_mpc.h
+//
+//  Model-predictive heater control for the host, optional per HeaterPolicy
+//  (HeaterControlMode::MPC, see oven.h).
+//
+//  HeaterModel: plant identified online with recursive least squares, one
+//  sample every kSampleMs on the STATUS temperatures:
+//
+//    hotspot  H[k+1] = H[k] + aH (H[k] - C[k]) + bH u[k - d]
+//    chamber  C[k+1] = C[k] + aC (H[k] - C[k]) + lC (C[k] - C0)
+//
+//    u   heater duty over the sample (0..1)
+//    d   dead time in samples (heater housing and NTC lag), 0..kMaxDelay
+//    C0  chamber temperature when the model was reset (ambient)
+//
+//  The hotspot stage is first order plus dead time from the heater; a bank
+//  of estimators, one per candidate d, runs in parallel and the one with
+//  the smallest prediction error is used. The chamber stage is first order,
+//  driven by the measured hotspot, with its loss to ambient relative to C0.
+//  Both use exponential forgetting so a changed load or fan mode is tracked.
+//
+//  HeaterMpc::plan(): candidate inputs "heat for P more ms, then off"; the
+//  model is rolled forward over kHorizonSamples and the longest P whose
+//  chamber peak stays at or below the aim and whose hotspot stays below its
+//  limit wins. The peak grows with P, so P is found by binary search.
+//
+//  All float, no allocation; a plan costs a few thousand multiply-adds.
+// ============================================================================
+
+namespace heater_mpc {
+
+static constexpr uint32_t kSampleMs = 5000;
+static constexpr uint8_t kMaxDelay = 3;                // up to 15 s dead time
+static constexpr uint16_t kHorizonSamples = 120;       // 10 min look-ahead
+static constexpr float kForgetting = 0.995f;           // ~17 min memory
+static constexpr float kInitialCovariance = 1000.0f;
+static constexpr float kMaxCovarianceTrace = 1.0e4f;   // no windup without excitation
+static constexpr float kErrorEmaAlpha = 0.05f;         // dead-time selection
+static constexpr uint16_t kReadyMinSamples = 24;       // 2 min of data ...
+static constexpr uint16_t kReadyMinHeatSamples = 2;    // ... with some heating in it
+static constexpr float kReadyMaxErrorC = 0.3f;         // one-step hotspot RMS
+
+// Two-parameter RLS: y = th0 x0 + th1 x1.
+class Rls2 {
+  public:
+    void reset(float th0 = 0.0f, float th1 = 0.0f, float p0 = kInitialCovariance) {
+        _th[0] = th0;
+        _th[1] = th1;
+        _p00 = p0;
+        _p01 = 0.0f;
+        _p11 = p0;
+    }
+
+    // Returns the a-priori prediction error.
+    float update(float x0, float x1, float y, float lambda = kForgetting) {
+        const float e = y - (_th[0] * x0 + _th[1] * x1);
+        const float px0 = _p00 * x0 + _p01 * x1;
+        const float px1 = _p01 * x0 + _p11 * x1;
+        const float den = lambda + x0 * px0 + x1 * px1;
+        const float k0 = px0 / den;
+        const float k1 = px1 / den;
+        _th[0] += k0 * e;
+        _th[1] += k1 * e;
+        _p00 = (_p00 - k0 * px0) / lambda;
+        _p01 = (_p01 - k0 * px1) / lambda;
+        _p11 = (_p11 - k1 * px1) / lambda;
+        const float trace = _p00 + _p11;
+        if (trace > kMaxCovarianceTrace) {
+            const float s = kMaxCovarianceTrace / trace;
+            _p00 *= s;
+            _p01 *= s;
+            _p11 *= s;
+        }
+        return e;
+    }
+
+    float theta(uint8_t i) const { return _th[i]; }
+
+  private:
+    float _th[2] = {0.0f, 0.0f};
+    float _p00 = kInitialCovariance;
+    float _p01 = 0.0f;
+    float _p11 = kInitialCovariance;
+};
+
+// Identified parameters (per sample of kSampleMs).
+struct HeaterModelParams {
+    float aH;      // hotspot relaxation towards the chamber (< 0)
+    float bH;      // hotspot rise per sample at full duty (> 0)
+    float aC;      // chamber gain from the hotspot lead (> 0)
+    float lC;      // chamber loss relative to C0 (<= 0)
+    uint8_t delay; // dead time, samples
+};
+
+class HeaterModel {
+  public:
+    void reset(float hotspotC, float chamberC) {
+        for (uint8_t d = 0; d <= kMaxDelay; ++d) {
+            _hot[d].reset();
+            _errSq[d] = 1.0f;
+        }
+        _chamber.reset();
+        for (uint8_t i = 0; i <= kMaxDelay; ++i) {
+            _duty[i] = 0.0f;
+        }
+        _c0 = chamberC;
+        _lastH = hotspotC;
+        _lastC = chamberC;
+        _samples = 0;
+        _heatSamples = 0;
+        _best = 0;
+    }
+
+    // Restart the sample chain (after a pause) without touching the estimates.
+    void rebase(float hotspotC, float chamberC) {
+        _lastH = hotspotC;
+        _lastC = chamberC;
+        for (uint8_t i = 0; i <= kMaxDelay; ++i) {
+            _duty[i] = 0.0f;
+        }
+    }
+
+    // One sample: temperatures at its end, heater duty during it.
+    void update(float hotspotC, float chamberC, float duty) {
+        for (uint8_t i = kMaxDelay; i > 0; --i) {
+            _duty[i] = _duty[i - 1];
+        }
+        _duty[0] = duty;
+
+        // The candidates only differ while heat is in the dead-time window;
+        // outside it their errors converge and switching would pick noise.
+        bool excited = false;
+        for (uint8_t i = 0; i <= kMaxDelay; ++i) {
+            excited |= (_duty[i] > 0.0f);
+        }
+
+        const float lead = _lastH - _lastC;
+        const float dH = hotspotC - _lastH;
+        const float dC = chamberC - _lastC;
+        for (uint8_t d = 0; d <= kMaxDelay; ++d) {
+            const float e = _hot[d].update(lead, _duty[d], dH);
+            _errSq[d] += kErrorEmaAlpha * (e * e - _errSq[d]);
+            if (excited && _errSq[d] < _errSq[_best]) {
+                _best = d;
+            }
+        }
+        _chamber.update(lead, _lastC - _c0, dC);
+
+        _lastH = hotspotC;
+        _lastC = chamberC;
+        if (_samples < 0xFFFF) {
+            _samples++;
+        }
+        if (duty > 0.0f && _heatSamples < 0xFFFF) {
+            _heatSamples++;
+        }
+    }
+
+    HeaterModelParams params() const {
+        return {_hot[_best].theta(0), _hot[_best].theta(1), _chamber.theta(0), _chamber.theta(1), _best};
+    }
+
+    // Enough data, physically plausible and predicting well.
+    bool ready() const {
+        if (_samples < kReadyMinSamples || _heatSamples < kReadyMinHeatSamples) {
+            return false;
+        }
+        const HeaterModelParams p = params();
+        if (!(p.aH < 0.0f && p.aH > -1.0f && p.bH > 0.0f && p.aC > 0.0f && p.aC < 1.0f && p.lC <= 0.01f)) {
+            return false;
+        }
+        return _errSq[_best] < kReadyMaxErrorC * kReadyMaxErrorC;
+    }
+
+    float chamberBaseC() const { return _c0; }
+    uint16_t samples() const { return _samples; }
+    float errorRmsSq() const { return _errSq[_best]; }
+
+    // Duty of the sample that ended i samples ago (0 = the last one).
+    float pastDuty(uint8_t i) const { return (i <= kMaxDelay) ? _duty[i] : 0.0f; }
+
+  private:
+    Rls2 _hot[kMaxDelay + 1];
+    float _errSq[kMaxDelay + 1] = {};
+    Rls2 _chamber;
+    float _duty[kMaxDelay + 1] = {};
+    float _c0 = 0.0f;
+    float _lastH = 0.0f;
+    float _lastC = 0.0f;
+    uint16_t _samples = 0;
+    uint16_t _heatSamples = 0;
+    uint8_t _best = 0;
+};
+
+struct HeaterMpcLimits {
+    float aimC;          // chamber peak may reach this
+    float hotspotLimitC; // hotspot must stay below this
+};
+
+struct HeaterMpcPlan {
+    uint32_t pulseMs;   // heat this long from now (0: stay off)
+    uint32_t peakInMs;  // predicted chamber peak, time from now
+    float peakC;        // predicted chamber peak
+    float hotspotPeakC; // predicted hotspot peak
+};
+
+class HeaterMpc {
+  public:
+    // Roll the model forward from the measured temperatures with the
+    // candidate "pulseMs on, then off".
+    static HeaterMpcPlan predict(const HeaterModel &model, float hotspotC, float chamberC, uint32_t pulseMs) {
+        const HeaterModelParams p = model.params();
+        const float c0 = model.chamberBaseC();
+        float h = hotspotC;
+        float c = chamberC;
+        HeaterMpcPlan out = {pulseMs, 0, chamberC, hotspotC};
+        for (uint16_t j = 0; j < kHorizonSamples; ++j) {
+            float u;
+            if (j >= p.delay) {
+                const uint32_t startMs = static_cast<uint32_t>(j - p.delay) * kSampleMs;
+                u = (pulseMs <= startMs) ? 0.0f
+                    : (pulseMs - startMs >= kSampleMs)
+                        ? 1.0f
+                        : static_cast<float>(pulseMs - startMs) / static_cast<float>(kSampleMs);
+            } else {
+                u = model.pastDuty(static_cast<uint8_t>(p.delay - j - 1));
+            }
+            const float lead = h - c;
+            h += p.aH * lead + p.bH * u;
+            c += p.aC * lead + p.lC * (c - c0);
+            if (c > out.peakC) {
+                out.peakC = c;
+                out.peakInMs = static_cast<uint32_t>(j + 1) * kSampleMs;
+            }
+            if (h > out.hotspotPeakC) {
+                out.hotspotPeakC = h;
+            }
+        }
+        return out;
+    }
+
+    // Longest pulse up to maxPulseMs (stepMs resolution) that keeps the
+    // predicted chamber peak <= aim and the hotspot < limit; pulseMs 0 if
+    // not even stepMs fits.
+    static HeaterMpcPlan plan(const HeaterModel &model, float hotspotC, float chamberC, const HeaterMpcLimits &lim,
+                              uint32_t maxPulseMs, uint32_t stepMs) {
+        uint32_t lo = 0;
+        uint32_t hi = maxPulseMs / stepMs;
+        HeaterMpcPlan best = predict(model, hotspotC, chamberC, 0);
+        while (lo < hi) {
+            const uint32_t mid = (lo + hi + 1) / 2;
+            const HeaterMpcPlan cand = predict(model, hotspotC, chamberC, mid * stepMs);
+            if (cand.peakC <= lim.aimC && cand.hotspotPeakC < lim.hotspotLimitC) {
+                lo = mid;
+                best = cand;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        return best;
+    }
+};
+
+} // namespace heater_mpc
+
+// EOF
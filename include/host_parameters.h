@@ -24,8 +24,13 @@ typedef struct HostParameters {
     HostHeaterProfileParameters heaterProfiles[HOST_PARAMETER_HEATER_PROFILE_COUNT];
     uint8_t displayDimPercent;
     uint8_t displayDimTimeoutMin;
+    // Pulse/soak tuning per profile, defaults from kHeaterPulseTables (oven.h)
+    HeaterPulseTable heaterTables[HOST_PARAMETER_HEATER_PROFILE_COUNT];
 } HostParameters;
 
+static_assert(sizeof(kHeaterPulseTables) / sizeof(kHeaterPulseTables[0]) == HOST_PARAMETER_HEATER_PROFILE_COUNT,
+              "one heater pulse table per heater profile");
+
 void host_parameters_init(void);
 void host_parameters_get_defaults(HostParameters *out);
 void host_parameters_get(HostParameters *out);
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "protocol_bin.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+//  line_assembler.h
+//
+//  Fixed-capacity assembler for the '\n'-terminated ASCII link frames, shared
+//  by HostComm, HostRxTask and ClientComm.
+//
+//  - feed() scans whole RX blocks with memchr() instead of going byte by byte
+//  - a line that is complete inside one block is handed out as a (ptr, len)
+//    view into that block (no copy); only a line split across blocks is
+//    copied into the internal buffer and handed out from there
+//  - views are valid during the callback only
+//  - a trailing '\r' is stripped, empty lines are not reported
+//  - a line longer than kMaxLineLen is dropped up to its '\n' and reported
+//    once through the overflow callback
+//
+//  feedLink() additionally separates 0x00-delimited binary frames (see
+//  protocol_bin.h) from the ASCII lines of the same byte stream.
+// ============================================================================
+
+class LineAssembler {
+  public:
+    static constexpr size_t kMaxLineLen = 120; // without CR/LF
+
+    // Counters (wrap at 2^32)
+    uint32_t lineCount() const { return _lines; }
+    uint32_t overflowCount() const { return _overflows; }
+    uint32_t fragmentedCount() const { return _fragmented; } // lines that spanned several feeds
+    uint32_t copiedBytes() const { return _copied; }         // bytes that went through the buffer
+    size_t pendingLen() const { return _len; }
+
+    void reset() {
+        _len = 0;
+        _discarding = false;
+    }
+
+    // onLine(const char *data, size_t len), onOverflow()
+    template <typename OnLine, typename OnOverflow>
+    void feed(const char *data, size_t len, OnLine &&onLine, OnOverflow &&onOverflow) {
+        if (len == 1 && *data != '\n' && !_discarding && _len < kBufLen) {
+            // Byte-wise RX (slow links, tests): plain append, no scan.
+            _buf[_len++] = *data;
+            _copied++;
+            return;
+        }
+        while (len > 0) {
+            const char *nl = static_cast<const char *>(memchr(data, '\n', len));
+            const size_t seg = nl ? static_cast<size_t>(nl - data) : len;
+
+            if (_discarding) {
+                // Rest of an overlong line: skip up to and including '\n'.
+                if (!nl) {
+                    return;
+                }
+                _discarding = false;
+            } else if (_len == 0 && nl) {
+                // Whole line inside this block: hand out a view, no copy.
+                emit(data, seg, onLine, onOverflow);
+            } else if (_len + seg > kBufLen) {
+                _len = 0;
+                _overflows++;
+                onOverflow();
+                if (!nl) {
+                    _discarding = true;
+                    return;
+                }
+            } else {
+                memcpy(_buf + _len, data, seg);
+                _len += seg;
+                _copied += static_cast<uint32_t>(seg);
+                if (!nl) {
+                    return; // line continues in the next block
+                }
+                _fragmented++;
+                const size_t lineLen = _len;
+                _len = 0;
+                emit(_buf, lineLen, onLine, onOverflow);
+            }
+
+            data += seg + 1;
+            len -= seg + 1;
+        }
+    }
+
+    // Same as feed(), but 0x00-delimited binary frames are collected by `bin`
+    // and reported through onBinary(ProtocolBinRx::Result::Frame/Overflow).
+    // Only the bytes outside binary frames reach the line assembler.
+    template <typename OnLine, typename OnOverflow, typename OnBinary>
+    void feedLink(ProtocolBinRx &bin, const uint8_t *data, size_t len, OnLine &&onLine, OnOverflow &&onOverflow,
+                  OnBinary &&onBinary) {
+        size_t pos = 0;
+        while (pos < len) {
+            if (!bin.collecting()) {
+                // ASCII run up to the next delimiter (the usual case: no 0x00 at all).
+                const void *z = memchr(data + pos, ProtocolBinCodec::kDelimiter, len - pos);
+                const size_t run = z ? static_cast<size_t>(static_cast<const uint8_t *>(z) - (data + pos)) : len - pos;
+                if (run > 0) {
+                    feed(reinterpret_cast<const char *>(data + pos), run, onLine, onOverflow);
+                    pos += run;
+                }
+                if (!z) {
+                    return;
+                }
+            }
+            const ProtocolBinRx::Result r = bin.accept(data[pos++]);
+            if (r == ProtocolBinRx::Result::Frame || r == ProtocolBinRx::Result::Overflow) {
+                onBinary(r);
+            }
+        }
+    }
+
+    // Helpers for the line consumers ------------------------------------------
+
+    // Strip whitespace at both ends (same set as String::trim()).
+    static void trim(const char *&data, size_t &len);
+
+    // Offset of the first frame start ('C' or 'H'), `len` if there is none.
+    static size_t frameStart(const char *data, size_t len);
+
+  private:
+    static constexpr size_t kBufLen = kMaxLineLen + 1; // room for the CR
+
+    char _buf[kBufLen];
+    size_t _len = 0;
+    bool _discarding = false;
+    uint32_t _lines = 0;
+    uint32_t _overflows = 0;
+    uint32_t _fragmented = 0;
+    uint32_t _copied = 0;
+
+    template <typename OnLine, typename OnOverflow>
+    void emit(const char *data, size_t len, OnLine &onLine, OnOverflow &onOverflow) {
+        if (len > 0 && data[len - 1] == '\r') {
+            len--;
+        }
+        if (len > kMaxLineLen) {
+            _overflows++;
+            onOverflow();
+            return;
+        }
+        if (len == 0) {
+            return;
+        }
+        _lines++;
+        onLine(data, len);
+    }
+};
+
+// EOF
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+//  log_async.h
+//
+//  Asynchronous output stage of log_core.h.
+//
+//    log macros (any task) -> LogRing (lock-free MPSC, PSRAM if present)
+//                          -> drain task (low priority)
+//                          -> Serial: one write per batch
+//                          -> UDP:    lines packed into datagrams of up to
+//                                     LOG_ASYNC_DATAGRAM_BYTES
+//
+//  - a log call only formats and copies into the ring; the WiFi stack and
+//    the UART are only touched by the drain task
+//  - a full ring drops the line and counts it; the drain task reports the
+//    number of dropped lines in the stream ("[LOG/WARN] n lines dropped")
+//  - write_blocking() (FATAL) waits for ring space and until the line has
+//    been handed to Serial/UDP, so it is out before a reset
+//  - lines are never split across datagrams; a datagram holds whole
+//    '\n'-terminated lines, receivers split on '\n' (and on the length of
+//    binary records, log_bin.h)
+//  - until start() succeeds (and in the native tests) log_core.h writes
+//    synchronously as before
+//
+//  ESP32: FreeRTOS task; native: std::thread, so the same path can be
+//  stress-tested on the PC.
+// ============================================================================
+
+#ifndef LOG_ASYNC_RING_BYTES
+#define LOG_ASYNC_RING_BYTES 16384 // PSRAM
+#endif
+#ifndef LOG_ASYNC_RING_BYTES_INTERNAL
+#define LOG_ASYNC_RING_BYTES_INTERNAL 8192 // fallback without PSRAM
+#endif
+#ifndef LOG_ASYNC_DATAGRAM_BYTES
+#define LOG_ASYNC_DATAGRAM_BYTES 1400 // fits a 1500 byte MTU with IP/UDP headers
+#endif
+#ifndef LOG_ASYNC_COALESCE_MS
+#define LOG_ASYNC_COALESCE_MS 5 // drain waits this long after a wake-up to collect a burst
+#endif
+#ifndef LOG_ASYNC_BLOCKING_TIMEOUT_MS
+#define LOG_ASYNC_BLOCKING_TIMEOUT_MS 500
+#endif
+
+namespace log_async {
+
+struct Stats {
+    uint32_t lines;      // accepted into the ring
+    uint32_t dropped;    // ring full
+    uint32_t truncated;  // longer than a quarter of the ring
+    uint32_t datagrams;  // UDP sends
+    uint32_t udpBytes;
+    uint32_t serialWrites;
+    uint32_t serialBytes;
+    uint32_t blockingWrites;
+    uint32_t blockingTimeouts;
+    uint32_t ringBytes; // capacity
+    uint32_t ringHighWater;
+    bool psram;
+};
+
+// Output sinks of the drain task. Defaults: Serial (lines starting with ';'
+// skipped, as in log_core.h) and udp::send_bytes() when UDP logging is
+// enabled. The native tests replace them; set before start().
+using SinkFn = void (*)(const char *data, size_t len);
+void set_sinks(SinkFn serialSink, SinkFn udpSink);
+
+// Allocates the ring and starts the drain task. Safe to call again.
+bool start();
+// Drains what is left and stops the task (tests, before a deliberate reset).
+void stop();
+bool running();
+
+// Queue one formatted line. false: not running, or dropped (counted).
+bool write(const char *line, size_t len);
+
+// Queue and wait until the line has been written out, up to timeoutMs.
+// false: not running or timed out.
+bool write_blocking(const char *line, size_t len, uint32_t timeoutMs);
+
+// Wait until everything queued so far has been written out.
+bool flush(uint32_t timeoutMs);
+
+Stats stats();
+
+} // namespace log_async
+
+// EOF
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <cstddef>
+#include <type_traits>
+
+// ============================================================================
+//  log_bin.h
+//
+//  Deferred-format binary log records (LOG_BINARY_ENABLE=1).
+//
+//  Instead of running vsnprintf() on the device, a log call stores the
+//  compile-time ID of its call site, a timestamp and the raw arguments:
+//
+//    0x1E | len | id (u32 LE) | t_ms (varint) | arg ... (len = bytes after len)
+//
+//    arg: type byte + payload
+//      kArgSigned    zig-zag varint     kArgFloat   4 bytes (double that
+//      kArgUnsigned  varint                         converts exactly)
+//      kArgPointer   varint             kArgDouble  8 bytes
+//      kArgString    varint len + bytes (cut to LOGBIN_MAX_STRING)
+//      kArgTruncated record full, the remaining arguments were dropped
+//
+//  - the ID is FNV-1a over "TAG\x1F" "LEVEL\x1F" fmt, computed by the
+//    compiler (the format string itself never leaves the flash)
+//  - scripts/pio_logbin_formats.py computes the same IDs from the sources
+//    at build time and writes the format table (logbin_formats.tsv)
+//  - tools/logbin_decode turns a captured or live UDP stream back into the
+//    text lines; text lines (RAW, CSV, FATAL) pass through unchanged, 0x1E
+//    never starts a text line
+//  - records carry no '\n'; the log drain sends them to UDP only
+//
+//  This header is platform-free (encoder + IDs) so the native tests and the
+//  decoder share it; log_core.h adds the timestamp and the output path.
+// ============================================================================
+
+#ifndef LOG_BINARY_ENABLE
+#define LOG_BINARY_ENABLE 0
+#endif
+
+#ifndef LOGBIN_MAX_RECORD
+#define LOGBIN_MAX_RECORD 128 // bytes incl. mark and length
+#endif
+#ifndef LOGBIN_MAX_STRING
+#define LOGBIN_MAX_STRING 64 // per %s argument
+#endif
+
+namespace logbin {
+
+static constexpr uint8_t kRecordMark = 0x1E;
+static constexpr size_t kHeaderLen = 2; // mark + len
+static_assert(LOGBIN_MAX_RECORD >= 16 && LOGBIN_MAX_RECORD <= 255 + kHeaderLen, "record length is one byte");
+
+enum ArgType : uint8_t {
+    kArgSigned = 1,
+    kArgUnsigned = 2,
+    kArgFloat = 3,
+    kArgDouble = 4,
+    kArgString = 5,
+    kArgPointer = 6,
+    kArgTruncated = 0x0F,
+};
+
+// Recursive for C++11 constexpr; formats stay well below the compiler's
+// default depth of 512.
+constexpr uint32_t fnv1a(const char *s, uint32_t h = 2166136261u) {
+    return *s ? fnv1a(s + 1, (h ^ static_cast<uint8_t>(*s)) * 16777619u) : h;
+}
+
+// Bounded record writer. One byte stays reserved for kArgTruncated.
+class Writer {
+  public:
+    Writer(uint8_t *out, size_t cap) : _out(out), _cap(cap) {}
+
+    size_t size() const { return _n; }
+    bool truncated() const { return _truncated; }
+    size_t room() const { return _truncated || _n + 1 >= _cap ? 0 : _cap - 1 - _n; }
+
+    void raw(const void *data, size_t len) {
+        memcpy(_out + _n, data, len);
+        _n += len;
+    }
+    void byte(uint8_t b) { _out[_n++] = b; }
+    void u32le(uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            byte(static_cast<uint8_t>(v >> (8 * i)));
+        }
+    }
+    void varint(uint64_t v) {
+        while (v >= 0x80u) {
+            byte(static_cast<uint8_t>(v | 0x80u));
+            v >>= 7;
+        }
+        byte(static_cast<uint8_t>(v));
+    }
+
+    static size_t varintLen(uint64_t v) {
+        size_t n = 1;
+        while (v >= 0x80u) {
+            v >>= 7;
+            n++;
+        }
+        return n;
+    }
+
+    // Argument that needs `need` bytes; false marks the record truncated.
+    bool reserve(size_t need) {
+        if (need > room()) {
+            if (!_truncated) {
+                _out[_n++] = kArgTruncated; // the reserved byte
+                _truncated = true;
+            }
+            return false;
+        }
+        return true;
+    }
+
+  private:
+    uint8_t *_out;
+    size_t _cap;
+    size_t _n = 0;
+    bool _truncated = false;
+};
+
+inline void putSigned(Writer &w, int64_t v) {
+    const uint64_t zz = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    if (w.reserve(1 + Writer::varintLen(zz))) {
+        w.byte(kArgSigned);
+        w.varint(zz);
+    }
+}
+
+inline void putUnsigned(Writer &w, uint64_t v, ArgType type = kArgUnsigned) {
+    if (w.reserve(1 + Writer::varintLen(v))) {
+        w.byte(type);
+        w.varint(v);
+    }
+}
+
+inline void putDouble(Writer &w, double d) {
+    const float f = static_cast<float>(d);
+    if (static_cast<double>(f) == d) {
+        if (w.reserve(5)) {
+            w.byte(kArgFloat);
+            w.raw(&f, 4);
+        }
+    } else if (w.reserve(9)) {
+        w.byte(kArgDouble);
+        w.raw(&d, 8);
+    }
+}
+
+inline void putString(Writer &w, const char *s) {
+    if (!s) {
+        s = "(null)";
+    }
+    size_t len = strnlen(s, LOGBIN_MAX_STRING);
+    if (!w.reserve(2)) {
+        return;
+    }
+    // Cut to what is left rather than dropping the argument.
+    const size_t room = w.room();
+    if (len + 1 + Writer::varintLen(len) > room) {
+        len = room - 1 - Writer::varintLen(room);
+    }
+    w.byte(kArgString);
+    w.varint(len);
+    w.raw(s, len);
+}
+
+// One overload per argument kind (C++11: the client core builds gnu++11).
+inline void putArg(Writer &w, bool v) { putUnsigned(w, v ? 1u : 0u); }
+inline void putArg(Writer &w, char v) { putSigned(w, v); }
+inline void putArg(Writer &w, signed char v) { putSigned(w, v); }
+inline void putArg(Writer &w, short v) { putSigned(w, v); }
+inline void putArg(Writer &w, int v) { putSigned(w, v); }
+inline void putArg(Writer &w, long v) { putSigned(w, v); }
+inline void putArg(Writer &w, long long v) { putSigned(w, v); }
+inline void putArg(Writer &w, unsigned char v) { putUnsigned(w, v); }
+inline void putArg(Writer &w, unsigned short v) { putUnsigned(w, v); }
+inline void putArg(Writer &w, unsigned int v) { putUnsigned(w, v); }
+inline void putArg(Writer &w, unsigned long v) { putUnsigned(w, v); }
+inline void putArg(Writer &w, unsigned long long v) { putUnsigned(w, v); }
+inline void putArg(Writer &w, double v) { putDouble(w, v); } // float promotes
+inline void putArg(Writer &w, const char *s) { putString(w, s); }
+inline void putArg(Writer &w, std::nullptr_t) { putUnsigned(w, 0u, kArgPointer); }
+
+template <typename T>
+inline void putArg(Writer &w, const T *p) {
+    putUnsigned(w, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p)), kArgPointer);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value>::type putArg(Writer &w, T v) {
+    putArg(w, static_cast<typename std::underlying_type<T>::type>(v));
+}
+
+// Arduino String (anything with c_str())
+template <typename T>
+inline auto putArg(Writer &w, const T &v) -> decltype(v.c_str(), void()) {
+    putString(w, v.c_str());
+}
+
+inline void putArgs(Writer &) {}
+
+template <typename T, typename... Rest>
+inline void putArgs(Writer &w, const T &first, const Rest &...rest) {
+    putArg(w, first);
+    putArgs(w, rest...);
+}
+
+// Builds one record into out (LOGBIN_MAX_RECORD bytes). Returns its length.
+template <typename... Args>
+inline size_t encode(uint8_t *out, size_t cap, uint32_t id, uint32_t timeMs, const Args &...args) {
+    Writer w(out, cap);
+    w.byte(kRecordMark);
+    w.byte(0); // length, patched below
+    w.u32le(id);
+    w.varint(timeMs);
+    putArgs(w, args...);
+    out[1] = static_cast<uint8_t>(w.size() - kHeaderLen);
+    return w.size();
+}
+
+} // namespace logbin
+
+// Call-site ID of (tag, level, fmt). fmt must be a string literal.
+#define LOGBIN_FMT_(fmt, ...) fmt
+#define LOGBIN_SITE_ID(tag, level, ...) \
+    (std::integral_constant<uint32_t, ::logbin::fnv1a(tag "\x1F" level "\x1F" LOGBIN_FMT_(__VA_ARGS__, 0))>::value)
+
+// EOF
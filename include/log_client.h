@@ -16,9 +16,9 @@
  */
 
 #ifdef CLIENTINFO
-#define CLIENT_INFO(...)                          \
-    do {                                          \
-        logPrintf("CLIENT", "INFO", __VA_ARGS__); \
+#define CLIENT_INFO(...)                                \
+    do {                                                \
+        LOG_CORE_PRINTF("CLIENT", "INFO", __VA_ARGS__); \
     } while (0)
 #else
 #define CLIENT_INFO(...) \
@@ -27,9 +27,9 @@
 #endif
 
 #ifdef CLIENTDBG
-#define CLIENT_DBG(...)                            \
-    do {                                           \
-        logPrintf("CLIENT", "DEBUG", __VA_ARGS__); \
+#define CLIENT_DBG(...)                                  \
+    do {                                                 \
+        LOG_CORE_PRINTF("CLIENT", "DEBUG", __VA_ARGS__); \
     } while (0)
 #else
 #define CLIENT_DBG(...) \
@@ -38,9 +38,9 @@
 #endif
 
 #ifdef CLIENTWARN
-#define CLIENT_WARN(...)                          \
-    do {                                          \
-        logPrintf("CLIENT", "WARN", __VA_ARGS__); \
+#define CLIENT_WARN(...)                                \
+    do {                                                \
+        LOG_CORE_PRINTF("CLIENT", "WARN", __VA_ARGS__); \
     } while (0)
 #else
 #define CLIENT_WARN(...) \
@@ -49,9 +49,9 @@
 #endif
 
 #ifdef CLIENTERR
-#define CLIENT_ERR(...)                          \
-    do {                                         \
-        logPrintf("CLIENT", "ERR", __VA_ARGS__); \
+#define CLIENT_ERR(...)                                \
+    do {                                               \
+        LOG_CORE_PRINTF("CLIENT", "ERR", __VA_ARGS__); \
     } while (0)
 #else
 #define CLIENT_ERR(...) \
@@ -5,6 +5,26 @@
 
 #include "udp/fsd_udp.h" // your UDP helper header
 
+// Asynchronous output (log_async.h): once log_async::start() has run, log
+// calls only format and queue the line; Serial/UDP are written by the drain
+// task. Off for the native tests, whose CSV capture relies on synchronous
+// Serial output.
+#ifndef LOG_ASYNC_ENABLE
+#if defined(ARDUINO_ARCH_ESP32)
+#define LOG_ASYNC_ENABLE 1
+#else
+#define LOG_ASYNC_ENABLE 0
+#endif
+#endif
+
+#if LOG_ASYNC_ENABLE
+#include "log_async.h"
+#endif
+
+// Binary log records (log_bin.h): the level macros store call-site ID and
+// arguments instead of formatting. Off unless -DLOG_BINARY_ENABLE=1.
+#include "log_bin.h"
+
 #ifdef INFO
 #undef INFO
 #endif
@@ -22,6 +42,11 @@
  * NOTE:
  * - Make sure Serial.begin(...) is called early in your setup().
  * - Format strings follow printf-style formatting.
+ * - With LOG_ASYNC_ENABLE the line is queued; FATAL(...) waits until it has
+ *   been written out (use it before a reset/abort).
+ * - With LOG_BINARY_ENABLE the level macros (INFO, OVEN_INFO, UI_DBG, ...)
+ *   need a string literal as format and go to UDP only, as binary records;
+ *   RAW, CSV_LOG and FATAL stay text.
  */
 
 // One-line buffer to ensure "one UDP packet per log line".
@@ -49,6 +74,46 @@ inline void logWriteSerial(const char *s, size_t n) {
     }
 }
 
+// One finished line to Serial + UDP, queued when the async stage runs.
+// blocking: wait until written out; falls back to a synchronous write if the
+// drain task does not get there in time.
+inline void logEmit(const char *s, size_t n, bool blocking) {
+#if LOG_ASYNC_ENABLE
+    if (log_async::running()) {
+        if (!blocking) {
+            log_async::write(s, n);
+            return;
+        }
+        if (log_async::write_blocking(s, n, LOG_ASYNC_BLOCKING_TIMEOUT_MS)) {
+            return;
+        }
+    }
+#else
+    (void)blocking;
+#endif
+    logWriteSerial(s, n);
+    logWriteUdpIfEnabled(s, n);
+}
+
+// One binary record: UDP only, the console cannot show it.
+inline void logEmitRecord(const uint8_t *rec, size_t n) {
+    const char *s = reinterpret_cast<const char *>(rec);
+#if LOG_ASYNC_ENABLE
+    if (log_async::running()) {
+        log_async::write(s, n);
+        return;
+    }
+#endif
+    logWriteUdpIfEnabled(s, n);
+}
+
+template <typename... Args>
+inline void logBinPrintf(uint32_t siteId, const char *fmt, const Args &...args) {
+    (void)fmt; // lives in the format table, not in the record
+    uint8_t rec[LOGBIN_MAX_RECORD];
+    logEmitRecord(rec, logbin::encode(rec, sizeof(rec), siteId, millis(), args...));
+}
+
 inline void logPrintPrefixToBuf(char *out, size_t out_size, const char *tag, const char *level) {
     if (!out || out_size == 0) {
         return;
@@ -60,7 +125,7 @@ inline void logPrintPrefixToBuf(char *out, size_t out_size, const char *tag, con
     }
 }
 
-inline void logVPrintf(const char *tag, const char *level, const char *fmt, va_list args) {
+inline void logVPrintf(const char *tag, const char *level, const char *fmt, va_list args, bool blocking = false) {
     char line[LOG_CORE_LINEBUF_SIZE];
 
     // Build prefix
@@ -93,11 +158,8 @@ inline void logVPrintf(const char *tag, const char *level, const char *fmt, va_l
         total = sizeof(line) - 1;
     }
 
-    // Serial output (exactly as before, just via one buffer)
-    logWriteSerial(line, total);
-
-    // UDP output (one packet per log call)
-    logWriteUdpIfEnabled(line, total);
+    // Serial + UDP (one packet per log call, or batched by the drain task)
+    logEmit(line, total, blocking);
 }
 
 inline void logPrintf(const char *tag, const char *level, const char *fmt, ...) {
@@ -107,6 +169,14 @@ inline void logPrintf(const char *tag, const char *level, const char *fmt, ...)
     va_end(args);
 }
 
+// Waits until the line is out (FATAL).
+inline void logPrintfBlocking(const char *tag, const char *level, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    logVPrintf(tag, level, fmt, args, true);
+    va_end(args);
+}
+
 inline void logRawVPrintf(const char *fmt, va_list args) {
     char line[LOG_CORE_LINEBUF_SIZE];
 
@@ -124,8 +194,7 @@ inline void logRawVPrintf(const char *fmt, va_list args) {
         total = sizeof(line) - 1;
     }
 
-    logWriteSerial(line, total);
-    logWriteUdpIfEnabled(line, total);
+    logEmit(line, total, false);
 }
 
 inline void logRawPrintf(const char *fmt, ...) {
@@ -135,35 +204,48 @@ inline void logRawPrintf(const char *fmt, ...) {
     va_end(args);
 }
 
+// Entry point of the level macros (here and in log_*.h).
+#if LOG_BINARY_ENABLE
+#define LOG_CORE_PRINTF(tag, level, ...) logBinPrintf(LOGBIN_SITE_ID(tag, level, __VA_ARGS__), __VA_ARGS__)
+#else
+#define LOG_CORE_PRINTF(tag, level, ...) logPrintf(tag, level, __VA_ARGS__)
+#endif
+
 #define RAW(...)                   \
     do {                           \
         logRawPrintf(__VA_ARGS__); \
     } while (0)
 
-#define INFO(...)                               \
-    do {                                        \
-        logPrintf("MAIN", "INFO", __VA_ARGS__); \
+#define INFO(...)                                     \
+    do {                                              \
+        LOG_CORE_PRINTF("MAIN", "INFO", __VA_ARGS__); \
     } while (0)
 
-#define DBG(...)                                 \
-    do {                                         \
-        logPrintf("MAIN", "DEBUG", __VA_ARGS__); \
+#define DBG(...)                                       \
+    do {                                               \
+        LOG_CORE_PRINTF("MAIN", "DEBUG", __VA_ARGS__); \
     } while (0)
 
-#define WARN(...)                               \
-    do {                                        \
-        logPrintf("MAIN", "WARN", __VA_ARGS__); \
+#define WARN(...)                                     \
+    do {                                              \
+        LOG_CORE_PRINTF("MAIN", "WARN", __VA_ARGS__); \
     } while (0)
 
-#define ERR(...)                               \
-    do {                                       \
-        logPrintf("MAIN", "ERR", __VA_ARGS__); \
+#define ERR(...)                                     \
+    do {                                             \
+        LOG_CORE_PRINTF("MAIN", "ERR", __VA_ARGS__); \
     } while (0)
 
 // Alias for convenience (some modules prefer ERROR over ERR).
-#define ERROR(...)                             \
-    do {                                       \
-        logPrintf("MAIN", "ERR", __VA_ARGS__); \
+#define ERROR(...)                                   \
+    do {                                             \
+        LOG_CORE_PRINTF("MAIN", "ERR", __VA_ARGS__); \
+    } while (0)
+
+// Blocking: the line is on Serial/UDP when FATAL returns.
+#define FATAL(...)                                       \
+    do {                                                 \
+        logPrintfBlocking("MAIN", "FATAL", __VA_ARGS__); \
     } while (0)
 
 // END OF FILE
\ No newline at end of file
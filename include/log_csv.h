@@ -16,9 +16,10 @@ namespace csv {
 // Temperature output, millivolts, ohms, tempearture for hotSpot & Chamber, some state values
 struct CLIENT_TEMP {
     static constexpr const char *PREFIX = "CLIENT_PLOT";
-    // [CSV_<PREFIX>];rawHot;hotMilliVolts;tempHot_dC;rawChamber;chamberMilliVolts;tempChamber_dC;heater_on;door_open;state
+    // [CSV_<PREFIX>];rawHot;hotMilliVolts;tempHot_dC;rawChamber;chamberMilliVolts;tempChamber_dC;state;heater_on;door_open;
+    //   tempHotFilt_dC;tempChamberFilt_dC
     static constexpr const char *FMT =
-        "[CSV_%s];%ld;%ld;%ld;%ld;%ld;%ld;%d;%d;%d\n";
+        "[CSV_%s];%ld;%ld;%ld;%ld;%ld;%ld;%ld;%ld;%ld;%ld;%ld\n";
 };
 
 // State output, door_open, heater, fan12V, fan230V, fan230V_slow, motor
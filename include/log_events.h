@@ -25,7 +25,7 @@
 #ifdef EVENTINFO
 #define EVENT_INFO(...)                                                                                                \
   do {                                                                                                                 \
-    logPrintf("EVENT", "INFO", __VA_ARGS__);                                                                           \
+    LOG_CORE_PRINTF("EVENT", "INFO", __VA_ARGS__);                                                                     \
   } while (0)
 #else
 #define EVENT_INFO(...)                                                                                                \
@@ -36,7 +36,7 @@
 #ifdef EVENTDBG
 #define EVENT_DBG(...)                                                                                                 \
   do {                                                                                                                 \
-    logPrintf("EVENT", "DEBUG", __VA_ARGS__);                                                                          \
+    LOG_CORE_PRINTF("EVENT", "DEBUG", __VA_ARGS__);                                                                    \
   } while (0)
 #else
 #define EVENT_DBG(...)                                                                                                 \
@@ -47,7 +47,7 @@
 #ifdef EVENTWARN
 #define EVENT_WARN(...)                                                                                                \
   do {                                                                                                                 \
-    logPrintf("EVENT", "WARN", __VA_ARGS__);                                                                           \
+    LOG_CORE_PRINTF("EVENT", "WARN", __VA_ARGS__);                                                                     \
   } while (0)
 #else
 #define EVENT_WARN(...)                                                                                                \
@@ -58,7 +58,7 @@
 #ifdef EVENTERR
 #define EVENT_ERR(...)                                                                                                 \
   do {                                                                                                                 \
-    logPrintf("EVENT", "ERR", __VA_ARGS__);                                                                            \
+    LOG_CORE_PRINTF("EVENT", "ERR", __VA_ARGS__);                                                                      \
   } while (0)
 #else
 #define EVENT_ERR(...)                                                                                                 \
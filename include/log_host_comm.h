@@ -16,9 +16,9 @@
  */
 
 #ifdef HOSTINFO
-#define HOST_INFO(...)                          \
-    do {                                        \
-        logPrintf("HOST", "INFO", __VA_ARGS__); \
+#define HOST_INFO(...)                                \
+    do {                                              \
+        LOG_CORE_PRINTF("HOST", "INFO", __VA_ARGS__); \
     } while (0)
 #else
 #define HOST_INFO(...) \
@@ -38,9 +38,9 @@
 #endif
 
 #ifdef HOSTDBG
-#define HOST_DBG(...)                            \
-    do {                                         \
-        logPrintf("HOST", "DEBUG", __VA_ARGS__); \
+#define HOST_DBG(...)                                  \
+    do {                                               \
+        LOG_CORE_PRINTF("HOST", "DEBUG", __VA_ARGS__); \
     } while (0)
 #else
 #define HOST_DBG(...) \
@@ -49,9 +49,9 @@
 #endif
 
 #ifdef HOSTWARN
-#define HOST_WARN(...)                          \
-    do {                                        \
-        logPrintf("HOST", "WARN", __VA_ARGS__); \
+#define HOST_WARN(...)                                \
+    do {                                              \
+        LOG_CORE_PRINTF("HOST", "WARN", __VA_ARGS__); \
     } while (0)
 #else
 #define HOST_WARN(...) \
@@ -60,9 +60,9 @@
 #endif
 
 #ifdef HOSTERR
-#define HOST_ERR(...)                          \
-    do {                                       \
-        logPrintf("HOST", "ERR", __VA_ARGS__); \
+#define HOST_ERR(...)                                \
+    do {                                             \
+        LOG_CORE_PRINTF("HOST", "ERR", __VA_ARGS__); \
     } while (0)
 #else
 #define HOST_ERR(...) \
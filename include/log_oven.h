@@ -16,10 +16,10 @@
  */
 
 #ifdef OVENINFO
-#define OVEN_INFO(...)                          \
-    do                                          \
-    {                                           \
-        logPrintf("OVEN", "INFO", __VA_ARGS__); \
+#define OVEN_INFO(...)                                \
+    do                                                \
+    {                                                 \
+        LOG_CORE_PRINTF("OVEN", "INFO", __VA_ARGS__); \
     } while (0)
 #else
 #define OVEN_INFO(...) \
@@ -29,10 +29,10 @@
 #endif
 
 #ifdef OVENDBG
-#define OVEN_DBG(...)                            \
-    do                                           \
-    {                                            \
-        logPrintf("OVEN", "DEBUG", __VA_ARGS__); \
+#define OVEN_DBG(...)                                  \
+    do                                                 \
+    {                                                  \
+        LOG_CORE_PRINTF("OVEN", "DEBUG", __VA_ARGS__); \
     } while (0)
 #else
 #define OVEN_DBG(...) \
@@ -42,10 +42,10 @@
 #endif
 
 #ifdef OVENWARN
-#define OVEN_WARN(...)                          \
-    do                                          \
-    {                                           \
-        logPrintf("OVEN", "WARN", __VA_ARGS__); \
+#define OVEN_WARN(...)                                \
+    do                                                \
+    {                                                 \
+        LOG_CORE_PRINTF("OVEN", "WARN", __VA_ARGS__); \
     } while (0)
 #else
 #define OVEN_WARN(...) \
@@ -55,10 +55,10 @@
 #endif
 
 #ifdef OVENERR
-#define OVEN_ERR(...)                          \
-    do                                         \
-    {                                          \
-        logPrintf("OVEN", "ERR", __VA_ARGS__); \
+#define OVEN_ERR(...)                                \
+    do                                               \
+    {                                                \
+        LOG_CORE_PRINTF("OVEN", "ERR", __VA_ARGS__); \
     } while (0)
 #else
 #define OVEN_ERR(...) \
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+//  log_ring.h
+//
+//  Lock-free multi-producer / single-consumer ring of variable-length log
+//  records, the buffer between the log macros and the log drain task
+//  (log_async.h).
+//
+//  - any number of tasks push(); exactly one drains
+//  - a producer reserves its record with one CAS on the head counter, copies
+//    the line and then commits it by publishing the record header (release);
+//    the consumer stops at the first record that is reserved but not yet
+//    committed, so records come out in reservation order and never torn
+//  - a record never wraps: if it does not fit before the end of the buffer,
+//    the rest is reserved as padding in the same CAS
+//  - push() never blocks; when the ring is full the line is dropped and
+//    counted (dropped())
+//  - the buffer is supplied by the caller (PSRAM or internal RAM), its size
+//    must be a power of two; consumed bytes are zeroed so a stale payload
+//    can never look like a committed header
+//
+//  Headers are accessed with the GCC __atomic builtins on the 4-byte aligned
+//  buffer (Xtensa and x86/ARM hosts for the native tests).
+// ============================================================================
+
+class LogRing {
+  public:
+    static constexpr size_t kHeaderLen = 4;
+    static constexpr size_t kMaxRecordLen = 0xFFFF; // line bytes per record
+
+    // buf must be 4-byte aligned, size a power of two in 64 .. 256 KiB.
+    bool init(uint8_t *buf, size_t size) {
+        if (!buf || size < 64 || size > 4u * (kMaxRecordLen + 1u) || (size & (size - 1)) != 0 ||
+            (reinterpret_cast<uintptr_t>(buf) & 3u) != 0) {
+            _buf = nullptr;
+            return false;
+        }
+        memset(buf, 0, size);
+        _buf = buf;
+        _size = static_cast<uint32_t>(size);
+        _mask = _size - 1u;
+        _head.store(0, std::memory_order_relaxed);
+        _tail.store(0, std::memory_order_relaxed);
+        _dropped.store(0, std::memory_order_relaxed);
+        _pushed.store(0, std::memory_order_relaxed);
+        _highWater.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ready() const { return _buf != nullptr; }
+    size_t capacity() const { return _size; }
+
+    // Producer side (any task) ---------------------------------------------
+
+    // endPos (optional) receives the ring position after the record: the
+    // record has been consumed once consumedPos() has passed it. Lines
+    // longer than a quarter of the ring are truncated.
+    bool push(const char *data, size_t len, uint32_t *endPos = nullptr) {
+        if (!_buf || !data || len == 0) {
+            return false;
+        }
+        if (len > kMaxRecordLen || recordBytes(len) > _size / 4u) {
+            len = _size / 4u - kHeaderLen; // one record never takes more than a quarter
+        }
+        const uint32_t need = recordBytes(len);
+
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t pad;
+        uint32_t total;
+        for (;;) {
+            const uint32_t tail = _tail.load(std::memory_order_acquire);
+            const uint32_t toEnd = _size - (head & _mask);
+            pad = need > toEnd ? toEnd : 0u;
+            total = pad + need;
+            if (head + total - tail > _size) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (_head.compare_exchange_weak(head, head + total, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (pad) {
+            storeHeader(head, kCommitted | kPadding | pad);
+            head += pad;
+        }
+        memcpy(_buf + (head & _mask) + kHeaderLen, data, len);
+        storeHeader(head, kCommitted | static_cast<uint32_t>(len));
+        if (endPos) {
+            *endPos = head + need;
+        }
+
+        _pushed.fetch_add(1, std::memory_order_relaxed);
+        const uint32_t used = head + need - _tail.load(std::memory_order_relaxed);
+        uint32_t hw = _highWater.load(std::memory_order_relaxed);
+        while (used > hw && !_highWater.compare_exchange_weak(hw, used, std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    // Consumer side (the drain task only) -----------------------------------
+
+    // Calls onRecord(const char *data, size_t len) for committed records in
+    // order until the ring is empty, a record is still being written or
+    // onRecord returns false (record kept for the next call).
+    // Returns the number of records consumed.
+    template <typename OnRecord>
+    size_t drain(OnRecord &&onRecord) {
+        if (!_buf) {
+            return 0;
+        }
+        size_t n = 0;
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        const uint32_t head = _head.load(std::memory_order_acquire);
+        while (tail != head) {
+            const uint32_t hdr = loadHeader(tail);
+            if ((hdr & kCommitted) == 0) {
+                break; // reserved, producer still copying
+            }
+            uint32_t bytes;
+            if (hdr & kPadding) {
+                bytes = hdr & kLenMask;
+            } else {
+                const uint32_t len = hdr & kLenMask;
+                if (!onRecord(reinterpret_cast<const char *>(_buf + (tail & _mask) + kHeaderLen),
+                              static_cast<size_t>(len))) {
+                    break;
+                }
+                bytes = recordBytes(len);
+                n++;
+            }
+            memset(_buf + (tail & _mask), 0, bytes);
+            tail += bytes;
+            _tail.store(tail, std::memory_order_release);
+        }
+        return n;
+    }
+
+    uint32_t consumedPos() const { return _tail.load(std::memory_order_acquire); }
+    bool empty() const { return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire); }
+
+    // Diagnostics
+    size_t used() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t pushed() const { return _pushed.load(std::memory_order_relaxed); }
+    uint32_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+  private:
+    static constexpr uint32_t kCommitted = 0x80000000u;
+    static constexpr uint32_t kPadding = 0x40000000u;
+    static constexpr uint32_t kLenMask = 0x0000FFFFu;
+
+    static uint32_t recordBytes(size_t len) { return static_cast<uint32_t>((kHeaderLen + len + 3u) & ~size_t(3u)); }
+
+    void storeHeader(uint32_t pos, uint32_t value) {
+        __atomic_store_n(reinterpret_cast<uint32_t *>(_buf + (pos & _mask)), value, __ATOMIC_RELEASE);
+    }
+    uint32_t loadHeader(uint32_t pos) const {
+        return __atomic_load_n(reinterpret_cast<const uint32_t *>(_buf + (pos & _mask)), __ATOMIC_ACQUIRE);
+    }
+
+    uint8_t *_buf = nullptr;
+    uint32_t _size = 0;
+    uint32_t _mask = 0;
+    std::atomic<uint32_t> _head{0}; // reserved, free-running
+    std::atomic<uint32_t> _tail{0}; // consumed, free-running
+    std::atomic<uint32_t> _dropped{0};
+    std::atomic<uint32_t> _pushed{0};
+    std::atomic<uint32_t> _highWater{0};
+};
+
+// EOF
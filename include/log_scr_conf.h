@@ -15,10 +15,10 @@
  */
 
 #ifdef SCRCONF
-#define SCR_INFO(...)                          \
-  do                                           \
-  {                                            \
-    logPrintf("SCRCONF", "INFO", __VA_ARGS__); \
+#define SCR_INFO(...)                                \
+  do                                                 \
+  {                                                  \
+    LOG_CORE_PRINTF("SCRCONF", "INFO", __VA_ARGS__); \
   } while (0)
 #else
 #define SCR_CONF_INFO(...) \
@@ -28,10 +28,10 @@
 #endif
 
 #ifdef SCRCONF
-#define SCR_CONF_DBG(...)                       \
-  do                                            \
-  {                                             \
-    logPrintf("SCRCONF", "DEBUG", __VA_ARGS__); \
+#define SCR_CONF_DBG(...)                             \
+  do                                                  \
+  {                                                   \
+    LOG_CORE_PRINTF("SCRCONF", "DEBUG", __VA_ARGS__); \
   } while (0)
 #else
 #define SCR_CONF_DBG(...) \
@@ -41,10 +41,10 @@
 #endif
 
 #ifdef SCRCONFWARN
-#define SCR_CONF_WARN(...)                     \
-  do                                           \
-  {                                            \
-    logPrintf("SCRCONF", "WARN", __VA_ARGS__); \
+#define SCR_CONF_WARN(...)                           \
+  do                                                 \
+  {                                                  \
+    LOG_CORE_PRINTF("SCRCONF", "WARN", __VA_ARGS__); \
   } while (0)
 #else
 #define SCR_CONF_WARN(...) \
@@ -54,10 +54,10 @@
 #endif
 
 #ifdef SCRCONFERR
-#define SCR_CONF_ERR(...)                     \
-  do                                          \
-  {                                           \
-    logPrintf("SCRCONF", "ERR", __VA_ARGS__); \
+#define SCR_CONF_ERR(...)                           \
+  do                                                \
+  {                                                 \
+    LOG_CORE_PRINTF("SCRCONF", "ERR", __VA_ARGS__); \
   } while (0)
 #else
 #define SCR_CONF_ERR(...) \
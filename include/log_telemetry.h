@@ -0,0 +1,82 @@
+#pragma once
+
+#include "log_core.h"
+#include "log_csv.h"
+#include "telemetry.h"
+
+/**
+ * Telemetry output (telemetry.h).
+ *
+ * The call sites fill a record struct and hand it to TELEMETRY_LOG(rec):
+ *   - TELEMETRY_BINARY=1: one binary frame (plus the schema when due) on UDP
+ *   - otherwise:          the CSV_LOG text line of log_csv.h, as before
+ *
+ * Not thread-safe: each stream is sent from one task (the host and client
+ * main loops).
+ */
+
+#if TELEMETRY_BINARY
+
+inline void telemetryWriteFrame(const uint8_t *frame, size_t len) {
+    logEmitRecord(frame, len);
+}
+
+inline bool telemetryLinkUp() {
+#if defined(WIFI_LOGGING_ENABLE) && (WIFI_LOGGING_ENABLE == 1)
+    return udp::is_enabled();
+#else
+    return false;
+#endif
+}
+
+inline telemetry::Emitter &telemetryEmitter() {
+    static telemetry::Emitter emitter(telemetryWriteFrame);
+    return emitter;
+}
+
+template <typename T>
+inline void telemetryLog(const T &rec) {
+    telemetryEmitter().send(rec, millis(), telemetryLinkUp());
+}
+
+#else
+
+inline void telemetryLog(const telemetry::ClientTemp &r) {
+    (void)r;
+    CSV_LOG_CLIENT_TEMP(
+        (long)r.rawHot, (long)r.hot_mV, (long)r.hot_dC,
+        (long)r.rawChamber, (long)r.cha_mV, (long)r.cha_dC,
+        (long)r.state, (long)r.heater, (long)r.door,
+        (long)r.hotFilt_dC, (long)r.chaFilt_dC);
+}
+
+inline void telemetryLog(const telemetry::ClientLogic &r) {
+    (void)r;
+    CSV_LOG_CLIENT_LOGIC(
+        (int)r.fan12V, (int)r.fan230V, (int)r.fan230V_slow, (int)r.motor,
+        (int)r.heater, (int)r.lamp, (int)r.door, (unsigned)r.state);
+}
+
+inline void telemetryLog(const telemetry::HostTemp &r) {
+    (void)r;
+    CSV_LOG_HOST_TEMP(
+        (long)r.chamber_dC, (long)r.hotspot_dC, (long)r.target_dC,
+        (long)r.low_dC, (long)r.high_dC, (int)r.safety);
+}
+
+inline void telemetryLog(const telemetry::HostLogic &r) {
+    (void)r;
+    CSV_LOG_HOST_LOGIC(
+        (unsigned)r.mode, (int)r.running, (int)r.heaterReq, (int)r.heaterActual,
+        (int)r.door, (int)r.safety, (int)r.commAlive, (int)r.linkSynced,
+        (unsigned)r.materialClass, (unsigned)r.heaterStage);
+}
+
+#endif
+
+#define TELEMETRY_LOG(rec) \
+    do {                   \
+        telemetryLog(rec); \
+    } while (0)
+
+// EOF
@@ -17,7 +17,7 @@
 #ifdef UIINFO
 #define UI_INFO(...)                                                                                                   \
   do {                                                                                                                 \
-    logPrintf("UI", "INFO", __VA_ARGS__);                                                                              \
+    LOG_CORE_PRINTF("UI", "INFO", __VA_ARGS__);                                                                        \
   } while (0)
 #else
 #define UI_INFO(...)                                                                                                   \
@@ -28,7 +28,7 @@
 #ifdef UIDBG
 #define UI_DBG(...)                                                                                                    \
   do {                                                                                                                 \
-    logPrintf("UI", "DEBUG", __VA_ARGS__);                                                                             \
+    LOG_CORE_PRINTF("UI", "DEBUG", __VA_ARGS__);                                                                       \
   } while (0)
 #else
 #define UI_DBG(...)                                                                                                    \
@@ -39,7 +39,7 @@
 #ifdef UIWARN
 #define UI_WARN(...)                                                                                                   \
   do {                                                                                                                 \
-    logPrintf("UI", "WARN", __VA_ARGS__);                                                                              \
+    LOG_CORE_PRINTF("UI", "WARN", __VA_ARGS__);                                                                        \
   } while (0)
 #else
 #define UI_WARN(...)                                                                                                   \
@@ -50,7 +50,7 @@
 #ifdef UIERR
 #define UI_ERR(...)                                                                                                    \
   do {                                                                                                                 \
-    logPrintf("UI", "ERR", __VA_ARGS__);                                                                               \
+    LOG_CORE_PRINTF("UI", "ERR", __VA_ARGS__);                                                                         \
   } while (0)
 #else
 #define UI_ERR(...)                                                                                                    \
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "ntc/ntc_divider_config_chamber.h"
+#include "ntc/ntc_divider_config_hotspot.h"
+#include "sensors/ads1115_config.h"
+#include <stdint.h>
+
+// ============================================================================
+//  ntc_fault.h
+//
+//  Per-channel NTC sensor fault detection, O(1) work and fixed memory per
+//  sample (runs next to the filter chains in the client sampling task).
+//
+//  SensorFaultDetector (one per channel):
+//    Open / Short  divider voltage at a rail (debounced); which rail means
+//                  "open" depends on the divider orientation
+//    Range         no valid temperature from the table (debounced)
+//    Stuck         the same raw code for stuckRounds rounds in a row; a live
+//                  divider always shows ADC noise or drift, a frozen bus or
+//                  ADC does not
+//    Noisy         raw-code variance over a sliding window (running sum and
+//                  sum of squares over a ring buffer) above the limit:
+//                  loose contact, EMI
+//    Slope         the filtered temperature moves faster than the oven can
+//
+//  SensorPairCheck: hotspot and chamber disagree in a way no heating or
+//  cooling phase explains (a sensor fell off its mount).
+//
+//  A fault stays set for holdRounds after its condition cleared, so an
+//  intermittent sensor does not toggle the heater. Windows are counted in
+//  sampling rounds (kSensorRoundsPerS).
+//
+//  The client packs both channels and the pair check into
+//  ProtocolStatus::sensorFaults (pack_sensor_faults()); the host stops the
+//  heater while it is non-zero.
+// ============================================================================
+
+namespace ntc {
+
+enum SensorFault : uint8_t {
+    SensorFaultOpen = 0x01,
+    SensorFaultShort = 0x02,
+    SensorFaultRange = 0x04,
+    SensorFaultStuck = 0x08,
+    SensorFaultNoisy = 0x10,
+    SensorFaultSlope = 0x20,
+};
+
+// ProtocolStatus::sensorFaults: hotspot SensorFault bits 0..7, chamber bits
+// 8..14, pair divergence bit 15.
+static constexpr uint8_t kSensorFaultChamberShift = 8;
+static constexpr uint16_t kSensorFaultDivergence = 0x8000;
+
+inline uint16_t pack_sensor_faults(uint8_t hot, uint8_t chamber, bool divergence) {
+    return static_cast<uint16_t>(hot | ((chamber & 0x7F) << kSensorFaultChamberShift) |
+                                 (divergence ? kSensorFaultDivergence : 0));
+}
+
+// AIN0..AIN3 rounds per second at 860 SPS (see ntc_filter.h).
+static constexpr uint16_t kSensorRoundsPerS = 180;
+
+struct SensorFaultConfig {
+    int32_t railLowMv;     // divider mV at or below: rail fault
+    int32_t railHighMv;    // divider mV at or above: rail fault
+    bool ntcToGnd;         // NTC on the low side: open NTC = high rail
+    uint16_t railRounds;   // rail / range condition must persist this long
+    uint16_t stuckRounds;  // identical raw codes in a row
+    uint32_t noisyVarRaw2; // variance limit over the window, raw counts^2
+    uint16_t noisyRounds;  // variance must stay above the limit this long
+    int16_t maxSlope_dC;   // per slopeRounds, on the filtered temperature
+    uint16_t slopeRounds;
+    uint16_t holdRounds; // a fault stays set this long after it cleared
+};
+
+class SensorFaultDetector {
+  public:
+    static constexpr uint8_t kWindowBits = 6;
+    static constexpr uint16_t kWindow = 1u << kWindowBits; // variance window, rounds
+
+    explicit SensorFaultDetector(const SensorFaultConfig &cfg) : _cfg(cfg) {}
+
+    // One round: raw ADS1115 code, divider voltage, converted temperature
+    // (TEMP_INVALID_DC if none) and the filter chain output.
+    // Returns the current SensorFault mask.
+    uint8_t update(int16_t raw, int32_t mV, int16_t temp_dC, int16_t filt_dC) {
+        uint8_t active = 0;
+
+        // Rails and range.
+        const bool low = (mV <= _cfg.railLowMv);
+        const bool high = (mV >= _cfg.railHighMv);
+        _railCount = (low || high) ? sat_inc(_railCount) : 0;
+        if (_railCount >= _cfg.railRounds) {
+            active |= (high == _cfg.ntcToGnd) ? SensorFaultOpen : SensorFaultShort;
+        }
+        _rangeCount = (temp_dC == TEMP_INVALID_DC && !low && !high) ? sat_inc(_rangeCount) : 0;
+        if (_rangeCount >= _cfg.railRounds) {
+            active |= SensorFaultRange;
+        }
+
+        // Stuck: identical codes in a row.
+        _stuckCount = (_fill > 0 && raw == _lastRaw) ? sat_inc(_stuckCount) : 0;
+        _lastRaw = raw;
+        if (_stuckCount >= _cfg.stuckRounds) {
+            active |= SensorFaultStuck;
+        }
+
+        // Noisy: N^2 * var = N * sum(x^2) - sum(x)^2 over the ring buffer.
+        if (_fill == kWindow) {
+            const int32_t old = _win[_idx];
+            _sum -= old;
+            _sumSq -= old * old;
+        } else {
+            _fill++;
+        }
+        _win[_idx] = raw;
+        _idx = static_cast<uint8_t>((_idx + 1) & (kWindow - 1));
+        _sum += raw;
+        _sumSq += static_cast<int32_t>(raw) * raw;
+        bool noisy = false;
+        if (_fill == kWindow) {
+            const int64_t n2var = static_cast<int64_t>(kWindow) * _sumSq - static_cast<int64_t>(_sum) * _sum;
+            noisy = n2var > static_cast<int64_t>(_cfg.noisyVarRaw2) * kWindow * kWindow;
+        }
+        _noisyCount = noisy ? sat_inc(_noisyCount) : 0;
+        if (_noisyCount >= _cfg.noisyRounds) {
+            active |= SensorFaultNoisy;
+        }
+
+        // Slope: filtered temperature against the value one span earlier.
+        if (filt_dC == TEMP_INVALID_DC) {
+            _slopeRefValid = false;
+            _slopeHit = false;
+        } else if (!_slopeRefValid) {
+            _slopeRefValid = true;
+            _slopeRef = filt_dC;
+            _slopeCount = 0;
+        } else if (++_slopeCount >= _cfg.slopeRounds) {
+            const int32_t d = static_cast<int32_t>(filt_dC) - _slopeRef;
+            _slopeHit = (d > _cfg.maxSlope_dC || d < -_cfg.maxSlope_dC);
+            _slopeRef = filt_dC;
+            _slopeCount = 0;
+        }
+        if (_slopeHit) {
+            active |= SensorFaultSlope;
+        }
+
+        // Hold every fault for holdRounds after its condition cleared.
+        _faults = 0;
+        for (uint8_t b = 0; b < kFaultBits; ++b) {
+            const uint8_t bit = static_cast<uint8_t>(1u << b);
+            if (active & bit) {
+                _hold[b] = _cfg.holdRounds;
+                _faults |= bit;
+            } else if (_hold[b] > 0) {
+                _hold[b]--;
+                _faults |= bit;
+            }
+        }
+        return _faults;
+    }
+
+    uint8_t faults() const { return _faults; }
+
+    void reset() { *this = SensorFaultDetector(_cfg); }
+
+  private:
+    static constexpr uint8_t kFaultBits = 6;
+
+    static uint16_t sat_inc(uint16_t v) { return (v == 0xFFFF) ? v : static_cast<uint16_t>(v + 1); }
+
+    SensorFaultConfig _cfg;
+    uint8_t _faults = 0;
+    uint16_t _hold[kFaultBits] = {};
+
+    uint16_t _railCount = 0;
+    uint16_t _rangeCount = 0;
+
+    int16_t _lastRaw = 0;
+    uint16_t _stuckCount = 0;
+
+    int16_t _win[kWindow] = {};
+    uint8_t _idx = 0;
+    uint8_t _fill = 0;
+    int32_t _sum = 0;
+    int64_t _sumSq = 0;
+    uint16_t _noisyCount = 0;
+
+    int16_t _slopeRef = 0;
+    uint16_t _slopeCount = 0;
+    bool _slopeRefValid = false;
+    bool _slopeHit = false;
+};
+
+struct SensorPairConfig {
+    int16_t hotBelowChamber_dC; // hotspot colder than the chamber by more
+    int16_t maxSpread_dC;       // |hotspot - chamber| above
+    uint16_t rounds;            // condition must persist this long
+    uint16_t holdRounds;
+};
+
+// Plausibility of hotspot vs. chamber on the filtered temperatures. The
+// hotspot sits at the heater and leads the chamber while heating; it can
+// trail it a little while cooling, but not by much and not for long.
+class SensorPairCheck {
+  public:
+    explicit SensorPairCheck(const SensorPairConfig &cfg) : _cfg(cfg) {}
+
+    bool update(int16_t hotFilt_dC, int16_t chaFilt_dC) {
+        bool bad = false;
+        if (hotFilt_dC != TEMP_INVALID_DC && chaFilt_dC != TEMP_INVALID_DC) {
+            const int32_t d = static_cast<int32_t>(hotFilt_dC) - chaFilt_dC;
+            bad = (d < -_cfg.hotBelowChamber_dC) || (d > _cfg.maxSpread_dC);
+        }
+        _count = bad ? static_cast<uint16_t>((_count == 0xFFFF) ? _count : _count + 1) : 0;
+        if (_count >= _cfg.rounds) {
+            _hold = _cfg.holdRounds;
+            _fault = true;
+        } else if (_hold > 0) {
+            _hold--;
+        } else {
+            _fault = false;
+        }
+        return _fault;
+    }
+
+    bool fault() const { return _fault; }
+
+  private:
+    SensorPairConfig _cfg;
+    uint16_t _count = 0;
+    uint16_t _hold = 0;
+    bool _fault = false;
+};
+
+// ----------------------------------------------------------------------------
+// Client channel configuration
+//
+// - rails: 50 mV from either end of the divider, 0.25 s
+// - stuck: 5 s without a single changed code
+// - noisy: raw-code sigma > 40 counts (7.5 mV) for 1 s
+// - slope: hotspot 15 °C/s, chamber 5 °C/s on the filtered value
+// - pair: hotspot 20 °C below the chamber or 120 °C above it for 10 s
+// - faults clear 2 s after the condition is gone
+// ----------------------------------------------------------------------------
+static constexpr SensorFaultConfig kHotspotFaultConfig = {
+    50, hotspot::NTC_VREF_MV - 50, hotspot::NTC_TO_GND, kSensorRoundsPerS / 4, 5 * kSensorRoundsPerS,
+    40 * 40, kSensorRoundsPerS, 150, kSensorRoundsPerS, 2 * kSensorRoundsPerS};
+
+static constexpr SensorFaultConfig kChamberFaultConfig = {
+    50, chamber::NTC_VREF_MV - 50, chamber::NTC_TO_GND, kSensorRoundsPerS / 4, 5 * kSensorRoundsPerS,
+    40 * 40, kSensorRoundsPerS, 50, kSensorRoundsPerS, 2 * kSensorRoundsPerS};
+
+static constexpr SensorPairConfig kSensorPairConfig = {200, 1200, 10 * kSensorRoundsPerS,
+                                                       2 * kSensorRoundsPerS};
+
+} // namespace ntc
+
+// EOF
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "ntc/ntc.h"
+#include "sensors/ads1115_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+//  ntc_filter.h
+//
+//  Compile-time composed filter chains for the NTC temperatures (deci-°C).
+//
+//  - every stage is a small struct with update(int32_t) and reset(); a chain
+//    is FilterChain<StageA, StageB, ...> and runs the stages in order
+//  - integer math only, no heap, state lives inside the chain object
+//  - TEMP_INVALID_DC is passed through unchanged and resets the chain, so a
+//    reconnected sensor starts fresh instead of ramping from a stale value
+//
+//  Stages:
+//    SpikeReject<MaxJump, MaxHold>  drop single outliers (hold last value)
+//    Median5                        median of the last 5 samples
+//    Ema<Shift>                     y += (x - y) / 2^Shift, Q8 internal state
+//    RateLimit<MaxStep>             |y[n] - y[n-1]| <= MaxStep
+//
+//  The client runs one chain per channel on every AIN0..AIN3 round (~180/s)
+//  and publishes raw and filtered values side by side (sensor_ntc.h).
+// ============================================================================
+
+namespace ntc {
+
+// Replace a sample that jumps more than MaxJump from the last accepted one
+// by that value; after MaxHold rejections in a row the jump is taken as real.
+template <int32_t MaxJump, uint8_t MaxHold = 3>
+struct SpikeReject {
+    int32_t last = 0;
+    uint8_t held = 0;
+    bool primed = false;
+    uint32_t rejected = 0;
+
+    int32_t update(int32_t x) {
+        if (!primed) {
+            primed = true;
+            last = x;
+            return x;
+        }
+        const int32_t d = x - last;
+        if ((d > MaxJump || d < -MaxJump) && held < MaxHold) {
+            held++;
+            rejected++;
+            return last;
+        }
+        held = 0;
+        last = x;
+        return x;
+    }
+
+    void reset() {
+        primed = false;
+        held = 0;
+    }
+};
+
+// Median of the last 5 samples (fewer while filling: the newest sample).
+struct Median5 {
+    int32_t buf[5] = {};
+    uint8_t idx = 0;
+    uint8_t count = 0;
+
+    int32_t update(int32_t x) {
+        buf[idx] = x;
+        idx = static_cast<uint8_t>((idx + 1) % 5);
+        if (count < 5) {
+            count++;
+            return x;
+        }
+        return median5(buf[0], buf[1], buf[2], buf[3], buf[4]);
+    }
+
+    void reset() {
+        idx = 0;
+        count = 0;
+    }
+};
+
+// First-order IIR low pass, time constant ~2^Shift samples.
+template <uint8_t Shift>
+struct Ema {
+    static_assert(Shift >= 1 && Shift <= 12, "Ema shift out of range");
+    static constexpr uint8_t kFrac = 8; // Q8 state, keeps sub-dC resolution
+    int32_t acc = 0;
+    bool primed = false;
+
+    int32_t update(int32_t x) {
+        const int32_t xq = x * (1 << kFrac);
+        if (!primed) {
+            primed = true;
+            acc = xq;
+        } else {
+            const int32_t d = xq - acc;
+            acc += (d >= 0) ? (d >> Shift) : -((-d) >> Shift);
+        }
+        const int32_t half = 1 << (kFrac - 1);
+        return (acc >= 0) ? ((acc + half) >> kFrac) : -((-acc + half) >> kFrac);
+    }
+
+    void reset() { primed = false; }
+};
+
+// Slew-rate limit: at most MaxStep per sample.
+template <int32_t MaxStep>
+struct RateLimit {
+    static_assert(MaxStep > 0, "RateLimit step must be positive");
+    int32_t last = 0;
+    bool primed = false;
+
+    int32_t update(int32_t x) {
+        if (!primed) {
+            primed = true;
+            last = x;
+            return x;
+        }
+        if (x > last + MaxStep) {
+            last += MaxStep;
+        } else if (x < last - MaxStep) {
+            last -= MaxStep;
+        } else {
+            last = x;
+        }
+        return last;
+    }
+
+    void reset() { primed = false; }
+};
+
+template <typename... Stages>
+struct FilterStages;
+
+template <>
+struct FilterStages<> {
+    int32_t update(int32_t x) { return x; }
+    void reset() {}
+};
+
+template <typename First, typename... Rest>
+struct FilterStages<First, Rest...> {
+    First head;
+    FilterStages<Rest...> tail;
+
+    int32_t update(int32_t x) { return tail.update(head.update(x)); }
+    void reset() {
+        head.reset();
+        tail.reset();
+    }
+};
+
+template <typename... Stages>
+class FilterChain {
+  public:
+    int16_t update(int16_t temp_dC) {
+        if (temp_dC == TEMP_INVALID_DC) {
+            _stages.reset();
+            return TEMP_INVALID_DC;
+        }
+        const int32_t y = _stages.update(temp_dC);
+        return static_cast<int16_t>((y < -32767) ? -32767 : (y > 32767) ? 32767 : y);
+    }
+
+    void reset() { _stages.reset(); }
+
+    FilterStages<Stages...> &stages() { return _stages; }
+
+  private:
+    FilterStages<Stages...> _stages;
+};
+
+// ----------------------------------------------------------------------------
+// Client channel configuration (per sample at ~180 rounds/s)
+//
+// - spikes: > 5.0 °C between two rounds (5 ms) is not physical
+// - median over 5 rounds, EMA time constant 32 rounds (~180 ms)
+// - rate limit 0.2 °C per round (~36 °C/s, only bounds transients)
+// ----------------------------------------------------------------------------
+using HotspotFilter = FilterChain<SpikeReject<50>, Median5, Ema<5>, RateLimit<2>>;
+using ChamberFilter = FilterChain<SpikeReject<50>, Median5, Ema<5>, RateLimit<2>>;
+
+} // namespace ntc
+
+// EOF
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "ntc/ntc_types.h"
+#include "sensors/ads1115_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+//  ntc_lut.h
+//
+//  Compile-time raw-ADC-code -> deci-°C tables for the NTC inputs.
+//
+//  calc_temp_from_ads_raw_dC() converts raw -> mV (float), mV -> Ohm
+//  (64-bit division), scans the NtcPoint table and interpolates in float for
+//  every sample. NtcRawLut evaluates exactly that chain at compile time and
+//  stores the result. The runtime path truncates to whole mV first, so the
+//  table is indexed by mV (raw * 3 / 16, exact for the 6.144 V range): ~5
+//  raw codes share one entry and the result stays bit-identical.
+//
+//  - Shift = 0: one entry per mV of the valid range, bit-identical
+//  - Shift = n: one node every 2^n mV, integer interpolation in between
+//    (caps flash use; see test_native_ntc_lut for the resulting error)
+//  - codes outside the table range map to TEMP_INVALID_DC like the runtime
+//    path
+//
+//  Table and divider are template parameters, so every sensor gets its own
+//  constexpr table in flash and no code runs at startup.
+// ============================================================================
+
+namespace ntc {
+namespace lut {
+
+// constexpr replicas of ntc_convert.cpp (same arithmetic, same rounding).
+constexpr int32_t raw_to_mV(int32_t raw) {
+    return (int32_t)((float)raw * ADS_LSB_MV);
+}
+
+constexpr int32_t mV_to_ohm(int32_t vntc_mV, int32_t vref_mV, int32_t r_fixed_ohm, bool ntc_to_gnd) {
+    if (vref_mV <= 0 || r_fixed_ohm <= 0 || vntc_mV <= 0 || vntc_mV >= vref_mV) {
+        return -1;
+    }
+    return ntc_to_gnd ? (int32_t)((int64_t)r_fixed_ohm * (int64_t)vntc_mV / (int64_t)(vref_mV - vntc_mV))
+                      : (int32_t)((int64_t)r_fixed_ohm * (int64_t)(vref_mV - vntc_mV) / (int64_t)vntc_mV);
+}
+
+// Table lookup as ntc_table_lookup_temp_dC(). With `extrapolate`, values
+// outside the table continue the first/last segment (used for the
+// interpolation nodes just outside the valid range only).
+constexpr int32_t lookup_dC(const NtcPoint *p, uint16_t n, int32_t v, bool extrapolate) {
+    const bool inc = p[n - 1].value > p[0].value;
+    const int32_t vmin = inc ? p[0].value : p[n - 1].value;
+    const int32_t vmax = inc ? p[n - 1].value : p[0].value;
+    if (!extrapolate && (v < vmin || v > vmax)) {
+        return TEMP_INVALID_DC;
+    }
+    uint16_t seg = 0;
+    if (v < vmin || v > vmax) {
+        const bool beforeFirst = inc ? (v < vmin) : (v > vmax);
+        seg = beforeFirst ? 0 : static_cast<uint16_t>(n - 2);
+    } else {
+        while (seg < n - 2) {
+            const int32_t a = p[seg].value;
+            const int32_t b = p[seg + 1].value;
+            if (inc ? (v >= a && v <= b) : (v <= a && v >= b)) {
+                break;
+            }
+            ++seg;
+        }
+    }
+    const int32_t a = p[seg].value;
+    const int32_t b = p[seg + 1].value;
+    const int16_t tA = p[seg].temp_dC;
+    const int16_t tB = p[seg + 1].temp_dC;
+    if (a == b) {
+        return tA;
+    }
+    const float frac = (float)(v - a) / (float)(b - a);
+    const float t = (float)tA + frac * (float)(tB - tA);
+    return (int32_t)(t >= 0 ? (t + 0.5f) : (t - 0.5f));
+}
+
+// Resistance-mode conversion of one whole-mV value (the runtime path after
+// ads_raw_to_mV()).
+constexpr int32_t mV_to_dC(int32_t mV, const NtcPoint *p, uint16_t n, int32_t vref_mV, int32_t r_fixed_ohm,
+                           bool ntc_to_gnd, bool extrapolate = false) {
+    const int32_t r = mV_to_ohm(mV, vref_mV, r_fixed_ohm, ntc_to_gnd);
+    if (r <= 0) {
+        return TEMP_INVALID_DC;
+    }
+    return lookup_dC(p, n, r, extrapolate);
+}
+
+// First (dir = +1) or last (dir = -1) mV value with a valid temperature,
+// -1 if there is none. The valid range is contiguous: Ohm is monotonic in mV.
+constexpr int32_t find_valid_mV(int dir, const NtcPoint *p, uint16_t n, int32_t vref_mV, int32_t r_fixed_ohm,
+                                bool ntc_to_gnd) {
+    for (int32_t mV = (dir > 0) ? 0 : vref_mV; mV >= 0 && mV <= vref_mV; mV += dir) {
+        if (mV_to_dC(mV, p, n, vref_mV, r_fixed_ohm, ntc_to_gnd) != TEMP_INVALID_DC) {
+            return mV;
+        }
+    }
+    return -1;
+}
+
+template <size_t N>
+struct Nodes {
+    int16_t v[N] = {};
+};
+
+// Node i sits at lo + (i << shift) mV. Nodes past the valid range (only the
+// end node of the last bucket) extrapolate the table.
+template <size_t N>
+constexpr Nodes<N> build_nodes(const NtcPoint *p, uint16_t n, int32_t vref_mV, int32_t r_fixed_ohm, bool ntc_to_gnd,
+                               uint8_t shift, int32_t lo) {
+    Nodes<N> out{};
+    for (size_t i = 0; i < N; ++i) {
+        const int32_t mV = lo + static_cast<int32_t>(i << shift);
+        int32_t t = mV_to_dC(mV, p, n, vref_mV, r_fixed_ohm, ntc_to_gnd, shift != 0);
+        if (t == TEMP_INVALID_DC) {
+            t = (i > 0) ? out.v[i - 1] : 0; // past the divider range: flat
+        }
+        out.v[i] = static_cast<int16_t>(t);
+    }
+    return out;
+}
+
+} // namespace lut
+
+template <const NtcPoint *Table, uint16_t Count, int32_t VrefMv, int32_t RFixedOhm, bool ToGnd, uint8_t Shift = 0>
+class NtcRawLut {
+    static_assert(Count >= 2, "NTC table needs >= 2 points");
+    static_assert(Shift <= 6, "buckets above 64 mV make no sense");
+    static_assert(ADS_LSB_MV == 0.1875f, "raw -> mV is computed as raw * 3 / 16 (GAIN_TWOTHIRDS)");
+
+  public:
+    static constexpr int32_t kMvLo = lut::find_valid_mV(+1, Table, Count, VrefMv, RFixedOhm, ToGnd);
+    static constexpr int32_t kMvHi = lut::find_valid_mV(-1, Table, Count, VrefMv, RFixedOhm, ToGnd);
+    static_assert(kMvLo > 0 && kMvHi >= kMvLo, "NTC table has no valid voltage");
+
+    // Shift 0: one entry per mV; else one node per bucket plus the end node.
+    static constexpr size_t kNodes =
+        (Shift == 0) ? static_cast<size_t>(kMvHi - kMvLo + 1) : static_cast<size_t>(((kMvHi - kMvLo) >> Shift) + 2);
+    static constexpr size_t kFlashBytes = kNodes * sizeof(int16_t);
+
+    static int16_t temp_dC(int16_t raw) {
+        // raw * 0.1875f truncated == raw * 3 / 16 for every int16 (exact in float).
+        const int32_t mV = (static_cast<int32_t>(raw) * 3) / 16;
+        if (mV < kMvLo || mV > kMvHi) {
+            return TEMP_INVALID_DC;
+        }
+        const uint32_t off = static_cast<uint32_t>(mV - kMvLo);
+        if (Shift == 0) {
+            return kTable.v[off];
+        }
+        const uint32_t i = off >> Shift;
+        const int32_t frac = static_cast<int32_t>(off & ((1u << Shift) - 1u));
+        const int32_t a = kTable.v[i];
+        const int32_t d = kTable.v[i + 1] - a;
+        const int32_t half = (Shift > 0) ? (1 << (Shift - 1)) : 0;
+        // Round to nearest for either sign of the slope.
+        const int32_t step = (d >= 0) ? ((d * frac + half) >> Shift) : -((-d * frac + half) >> Shift);
+        return static_cast<int16_t>(a + step);
+    }
+
+  private:
+    static constexpr lut::Nodes<kNodes> kTable =
+        lut::build_nodes<kNodes>(Table, Count, VrefMv, RFixedOhm, ToGnd, Shift, kMvLo);
+};
+
+template <const NtcPoint *Table, uint16_t Count, int32_t VrefMv, int32_t RFixedOhm, bool ToGnd, uint8_t Shift>
+constexpr lut::Nodes<NtcRawLut<Table, Count, VrefMv, RFixedOhm, ToGnd, Shift>::kNodes>
+    NtcRawLut<Table, Count, VrefMv, RFixedOhm, ToGnd, Shift>::kTable;
+
+} // namespace ntc
+
+// EOF
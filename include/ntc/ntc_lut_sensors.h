@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ntc/ntc_divider_config_chamber.h"
+#include "ntc/ntc_divider_config_hotspot.h"
+#include "ntc/ntc_lut.h"
+#include "ntc/ntc_table_10k_ioveo_036HS05201.h"
+#include "ntc/ntc_table_hotspot.h"
+
+// ----------------------------------------------------------------------------
+// Generated raw -> deci-°C tables of the two client NTC inputs.
+//
+// NTC_RAW_LUT=1 (default) converts through these tables, NTC_RAW_LUT=0 keeps
+// calc_temp_from_ads_raw_dC(). NTC_RAW_LUT_SHIFT selects the bucket size
+// (2^n codes per node, 0 = one entry per code).
+// ----------------------------------------------------------------------------
+
+#ifndef NTC_RAW_LUT
+#define NTC_RAW_LUT 1
+#endif
+
+#ifndef NTC_RAW_LUT_SHIFT
+#define NTC_RAW_LUT_SHIFT 0
+#endif
+
+namespace ntc {
+
+using HotspotRawLut = NtcRawLut<kNtc100k_Hotspot_Table, kNtc100k_Hotspot_TableCount, hotspot::NTC_VREF_MV,
+                                hotspot::NTC_R_FIXED_OHM, hotspot::NTC_TO_GND, NTC_RAW_LUT_SHIFT>;
+
+using ChamberRawLut = NtcRawLut<kNtc10k_Chamber_Table, kNtc10k_Chamber_TableCount, chamber::NTC_VREF_MV,
+                                chamber::NTC_R_FIXED_OHM, chamber::NTC_TO_GND, NTC_RAW_LUT_SHIFT>;
+
+} // namespace ntc
+
+// EOF
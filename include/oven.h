@@ -71,6 +71,14 @@ enum class HeaterControlStage : uint8_t {
     HOLD
 };
 
+// PULSE: pulse/soak tables (kHeaterPulseTables). MPC: pulse lengths from an
+// online-identified plant model (heater_mpc.h); the pulse tables run until
+// the model is ready.
+enum class HeaterControlMode : uint8_t {
+    PULSE = 0,
+    MPC
+};
+
 enum class HeaterCurveProfileId : uint8_t {
     LOW_45C = 0,
     MID_60C,
@@ -95,9 +103,39 @@ typedef struct
     uint8_t stepIndex;
 } PostRuntime;
 
-// Host requests STATUS periodically
+// Host requests STATUS periodically (fallback if the push subscription fails)
 constexpr uint32_t kStatusPollIntervalMs = 500; // request STATUS every n ms
 
+// Push-based STATUS (H;SUB): the client sends STATUS every n ms on its own
+// and immediately on door edges / output changes. 0 = keep polling.
+constexpr uint16_t kStatusPushPeriodMs = 500;
+
+// Negotiate the binary link mode (COBS + CRC16) after link sync.
+// Falls back to ASCII automatically if the client does not answer H;BIN.
+constexpr bool kCommBinaryModeEnabled = true;
+
+// Pipelined SET/UPD/TOG with sequence numbers: up to n commands in flight,
+// ACKs matched by sequence number, per-command retransmit. 0 = lockstep.
+constexpr uint8_t kCommCommandWindow = 4;
+
+// Send output changes as H;ACT: the client answers with ACK mask + full
+// STATUS in one frame, saving the GET/STATUS round trip after a command.
+constexpr bool kCommActuateAndReport = true;
+
+// Link rate to negotiate after link sync (H;BAUD); the session always starts
+// at the oven_comm_init() rate and falls back to it on errors/silence.
+constexpr uint32_t kCommLinkBaudTarget = 921600;
+
+// Receive and parse UART frames on a FreeRTOS task on the non-UI core
+// (HostRxTask); oven_comm_poll() then only consumes parsed messages.
+// false = HostComm::loop() reads the UART inline on the UI core.
+// The native oven simulator sets OVEN_COMM_RX_TASK=0 so the whole
+// run stays on one thread and replays bit for bit.
+#ifndef OVEN_COMM_RX_TASK
+#define OVEN_COMM_RX_TASK 1
+#endif
+constexpr bool kCommRxTaskEnabled = (OVEN_COMM_RX_TASK != 0);
+
 // ----------------------------------------------------------------------------
 // Presets & Profiles
 // ----------------------------------------------------------------------------
@@ -124,6 +162,7 @@ typedef struct
     float targetOvershootCapC;
     float chamberMaxC;
     float hotspotMaxC;
+    HeaterControlMode controlMode;
 } HeaterPolicy;
 
 typedef struct
@@ -155,9 +194,12 @@ typedef struct
     float tempHotspotC;    // safety temperature (Hotspot)
     bool tempChamberValid;
     bool tempHotspotValid;
+    uint16_t sensorFaultMask; // client sensor fault bits (ntc_fault.h), 0 = sensors plausible
     HeaterMaterialClass materialClass;
     HeaterCurveProfileId heaterCurveProfile;
     HeaterControlStage heaterStage;
+    bool heaterMpcActive; // MPC mode selected and its model ready
+    bool heaterWarmStart; // pulse schedule warm-started from the thermal cache
 
     int filamentId;
     char presetName[24];
@@ -188,6 +230,7 @@ typedef struct
     // Communication / link diagnostics
     bool commAlive;
     bool linkSynced;
+    uint32_t linkBaud; // current UART rate (negotiated via H;BAUD)
 
     // Host-side mode (not remote truth)
     OvenMode mode;
@@ -249,50 +292,177 @@ static constexpr float HOST_CHAMBER_MAX_C = 120.0f;
 static constexpr float HOST_HOTSPOT_MAX_C = 140.0f;
 static constexpr float HOST_SILICA_HEATER_HYSTERESIS_C = 2.5f;
 static constexpr float HOST_SILICA_TARGET_OVERSHOOT_CAP_C = 3.0f;
-static constexpr uint32_t HOST_SILICA_FIRST_PULSE_MAX_MS = 45000;
-static constexpr uint32_t HOST_SILICA_BULK_PULSE_MAX_MS = 18000;
-static constexpr uint32_t HOST_SILICA_APPROACH_PULSE_MAX_MS = 12000;
-static constexpr uint32_t HOST_SILICA_HOLD_PULSE_MAX_MS = 8000;
-static constexpr uint32_t HOST_SILICA_FIRST_SOAK_MS = 60000;
-static constexpr uint32_t HOST_SILICA_REHEAT_SOAK_MS = 35000;
-static constexpr uint32_t HOST_SILICA_SAFETY_SOAK_MS = 120000;
-static constexpr float HOST_SILICA_BULK_PULSE_ENABLE_BELOW_TARGET_C = 25.0f;
-static constexpr float HOST_SILICA_APPROACH_PULSE_ENABLE_BELOW_TARGET_C = 12.0f;
-static constexpr float HOST_SILICA_REHEAT_ENABLE_BELOW_TARGET_C = 4.0f;
-static constexpr float HOST_SILICA_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C = 2.0f;
-static constexpr float HOST_SILICA_FORCE_OFF_BEFORE_TARGET_C = 1.0f;
-static constexpr uint32_t HOST_FILAMENT_FIRST_PULSE_MAX_MS = 12000;
-static constexpr uint32_t HOST_FILAMENT_FIRST_PULSE_MAX_WARM_MS = 10000;
-static constexpr uint32_t HOST_FILAMENT_FIRST_PULSE_MAX_MID_MS = 11000;
-static constexpr uint32_t HOST_FILAMENT_BULK_PULSE_MAX_MS = 10000;
-static constexpr uint32_t HOST_FILAMENT_APPROACH_PULSE_MAX_MS = 7000;
-static constexpr uint32_t HOST_FILAMENT_HOLD_PULSE_MAX_MS = 4000;
-static constexpr uint32_t HOST_FILAMENT_HOLD_PULSE_WARM_MS = 6000;
-static constexpr uint32_t HOST_FILAMENT_HOLD_PULSE_MID_MS = 5000;
-static constexpr uint32_t HOST_FILAMENT_HOLD_PULSE_HIGH_MS = 6000;
-static constexpr uint32_t HOST_FILAMENT_FIRST_SOAK_MS = 45000;
-static constexpr uint32_t HOST_FILAMENT_REHEAT_SOAK_MS = 30000;
-static constexpr uint32_t HOST_FILAMENT_SAFETY_SOAK_MS = 90000;
-static constexpr float HOST_FILAMENT_BULK_PULSE_ENABLE_BELOW_TARGET_C = 20.0f;
-static constexpr float HOST_FILAMENT_APPROACH_PULSE_ENABLE_BELOW_TARGET_C = 10.0f;
-static constexpr float HOST_FILAMENT_REHEAT_ENABLE_BELOW_TARGET_C = 3.0f;
-static constexpr float HOST_FILAMENT_HIGH_REHEAT_ENABLE_BELOW_TARGET_C = 2.0f;
-static constexpr float HOST_FILAMENT_FORCE_OFF_BEFORE_TARGET_C = 1.0f;
-static constexpr float HOST_FILAMENT_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C = 2.0f;
-static constexpr float HOST_FILAMENT_HOTSPOT_REHEAT_BLOCK_ABOVE_TARGET_C = 5.0f;
-static constexpr float HOST_FILAMENT_HOTSPOT_FORCE_OFF_ABOVE_TARGET_C = 10.0f;
-static constexpr uint32_t HOST_FILAMENT_FAN_MIN_SWITCH_MS = 5000;
-static constexpr uint32_t HOST_FILAMENT_FAN_FAST_AFTER_HEAT_MS = 12000;
-static constexpr uint32_t HOST_FILAMENT_WAIT_RESUME_SOAK_MS = 12000;
-static constexpr uint32_t HOST_FILAMENT_WAIT_RESUME_SOAK_MIN_MS = 5000;
-static constexpr uint32_t HOST_FILAMENT_WAIT_RESUME_SOAK_HOT_TARGET_MS = 7000;
-static constexpr uint32_t HOST_FILAMENT_WAIT_RESUME_PULSE_SHORT_MS = 6000;
-static constexpr uint32_t HOST_FILAMENT_WAIT_RESUME_PULSE_LONG_MS = 8000;
-static constexpr float HOST_FILAMENT_WAIT_RESUME_LONG_PULSE_ERROR_C = 8.0f;
-static constexpr float HOST_FILAMENT_WAIT_RESUME_MEDIUM_PULSE_ERROR_C = 5.0f;
-static constexpr float HOST_FILAMENT_MID_TARGET_C = 70.0f;
-static constexpr float HOST_FILAMENT_WAIT_RESUME_HOT_TARGET_C = 80.0f;
-static constexpr uint32_t HOST_FILAMENT_WAIT_RESUME_LONG_OPEN_MS = 15000;
+
+// ----------------------------------------------------------------------------
+// Heater pulse tables
+//
+// One row per HeaterCurveProfileId drives the pulse/soak heater control in
+// oven_comm_poll(). The row is looked up once per tick; HostParameters holds
+// a copy (heaterTables[]) so tunings can be changed and saved without a
+// reflash. Temperatures in deci-°C, durations in ms.
+//
+// Pulse ladder on the chamber error (target - chamber), first match wins:
+//   first pulse of a run     firstPulseMs[tier]
+//   error > bulkAbove        bulkPulseMs
+//   error > approachAbove    approachPulseMs
+//   error > reheatAbove      holdPulseMs[tier]
+//   otherwise                no pulse (and no reheat)
+// The tier is picked from the target: below midTarget warm, below hotTarget
+// mid, else hot.
+// ----------------------------------------------------------------------------
+enum HeaterRule : uint8_t {
+    HEATER_RULE_PULSE_GATE = 0x01,       // pulse/soak gate; without: plain stage hysteresis
+    HEATER_RULE_HOTSPOT_GUARD = 0x02,    // hotspot above target blocks reheat / forces off
+    HEATER_RULE_PREDICT_OFF = 0x04,      // force off when chamber + lead * gain reaches target
+    HEATER_RULE_HOLD_HOTSPOT_OFF = 0x08, // HOLD: force off once the hotspot reaches target
+    HEATER_RULE_RUNNING_FANS = 0x10,     // 12 V + 230 V slow, 230 V fast after each pulse
+    HEATER_RULE_WAIT_RESUME = 0x20,      // resume from WAIT with a short soak + sized pulse
+    HEATER_RULE_MPC = 0x40,              // HeaterControlMode::MPC for this profile
+};
+static constexpr uint8_t HEATER_RULE_ALL = 0x7F;
+
+enum HeaterTargetTier : uint8_t {
+    HEATER_TIER_WARM = 0,
+    HEATER_TIER_MID,
+    HEATER_TIER_HOT,
+    HEATER_TIER_COUNT
+};
+
+typedef struct HeaterPulseTable {
+    uint8_t rules; // HeaterRule bits
+
+    int16_t midTarget_dC;
+    int16_t hotTarget_dC;
+
+    // Pulse ladder
+    uint32_t firstPulseMs[HEATER_TIER_COUNT];
+    int16_t bulkAbove_dC;
+    uint32_t bulkPulseMs;
+    int16_t approachAbove_dC;
+    uint32_t approachPulseMs;
+    int16_t reheatAbove_dC;
+    uint32_t holdPulseMs[HEATER_TIER_COUNT];
+
+    // Soak after a pulse (first / later), and after a safety cutoff
+    uint32_t firstSoakMs;
+    uint32_t reheatSoakMs;
+    uint32_t safetySoakMs;
+
+    // Force the heater off this far below target (first pulse / later)
+    int16_t firstForceOffBefore_dC;
+    int16_t forceOffBefore_dC;
+    // HEATER_RULE_PREDICT_OFF: later pulses (the first uses firstForceOffBefore_dC)
+    int16_t predictForceOffBefore_dC;
+    uint16_t predictLeadGain_pct;
+    // HEATER_RULE_HOTSPOT_GUARD
+    int16_t hotspotReheatBlockAbove_dC;
+    int16_t hotspotForceOffAbove_dC;
+
+    // HEATER_RULE_RUNNING_FANS
+    uint32_t fanMinSwitchMs;
+    uint32_t fanFastAfterHeatMs;
+
+    // HEATER_RULE_WAIT_RESUME: soak before and pulse right after a WAIT
+    uint32_t resumeSoakMs;
+    uint32_t resumeSoakHotMs; // hot tier
+    uint32_t resumeSoakMinMs;
+    uint32_t resumeSoakLongErrorMs;   // soak cap at resumeLongError_dC
+    uint32_t resumeSoakMediumErrorMs; // soak cap at resumeMediumError_dC
+    uint32_t resumeLongOpenMs;        // door open at least this long ...
+    uint32_t resumeLongOpenCutMs;     // ... shortens the soak by this much
+    uint32_t resumePulseShortMs;
+    uint32_t resumePulseLongMs;   // at resumeLongError_dC; halfway at medium
+    uint32_t resumePulseHotCutMs; // hot tier: shorter pulse
+    int16_t resumeLongError_dC;
+    int16_t resumeMediumError_dC;
+} HeaterPulseTable;
+
+// Filament rows differ only in the reheat threshold and the hot-tier hold
+// pulse: HIGH_80C reheats closer to target with a longer hold pulse.
+#define OVEN_FILAMENT_PULSE_TABLE(reheatAbove_dC, holdHotMs)                          \
+    {                                                                                  \
+        HEATER_RULE_PULSE_GATE | HEATER_RULE_HOTSPOT_GUARD | HEATER_RULE_PREDICT_OFF | \
+            HEATER_RULE_HOLD_HOTSPOT_OFF | HEATER_RULE_RUNNING_FANS |                  \
+            HEATER_RULE_WAIT_RESUME,                                                   \
+        700, 800,                                                                      \
+        {10000, 11000, 12000},                                                         \
+        200, 10000,                                                                    \
+        100, 7000,                                                                     \
+        (reheatAbove_dC), {6000, 5000, (holdHotMs)},                                   \
+        45000, 30000, 90000,                                                           \
+        20, 10, 5, 150,                                                                \
+        50, 100,                                                                       \
+        5000, 12000,                                                                   \
+        12000, 7000, 5000, 7000, 9000, 15000, 2000,                                    \
+        6000, 8000, 1000,                                                              \
+        80, 50,                                                                        \
+    }
+
+// Indexed by HeaterCurveProfileId.
+static constexpr HeaterPulseTable kHeaterPulseTables[] = {
+    OVEN_FILAMENT_PULSE_TABLE(30, 4000), // LOW_45C
+    OVEN_FILAMENT_PULSE_TABLE(30, 4000), // MID_60C
+    OVEN_FILAMENT_PULSE_TABLE(20, 6000), // HIGH_80C
+    {
+        // SILICA_100C: long pulses, no hotspot, fan or resume rules (their
+        // fields only keep the row valid)
+        HEATER_RULE_PULSE_GATE,
+        700, 800,
+        {45000, 45000, 45000},
+        250, 18000,
+        120, 12000,
+        40, {8000, 8000, 8000},
+        60000, 35000, 120000,
+        20, 10, 5, 150,
+        50, 100,
+        5000, 12000,
+        12000, 7000, 5000, 7000, 9000, 15000, 2000,
+        6000, 8000, 1000,
+        80, 50,
+    },
+};
+
+#undef OVEN_FILAMENT_PULSE_TABLE
+
+// HeaterControlMode::MPC: the planner picks the longest pulse (1 s steps, at
+// most HOST_MPC_MAX_PULSE_MS) whose predicted chamber peak stays within
+// HOST_MPC_AIM_ABOVE_TARGET_C of the target and whose hotspot stays
+// HOST_MPC_HOTSPOT_MARGIN_C below its limit (hotspotMaxC, or the table's
+// hotspot force-off distance with HEATER_RULE_HOTSPOT_GUARD). Shorter pulses
+// than HOST_MPC_MIN_PULSE_MS are not started; after a pulse the heater rests
+// at least HOST_MPC_MIN_SOAK_MS.
+static constexpr float HOST_MPC_AIM_ABOVE_TARGET_C = 0.0f;
+static constexpr float HOST_MPC_HOTSPOT_MARGIN_C = 1.0f;
+static constexpr uint32_t HOST_MPC_MIN_PULSE_MS = 3000;
+static constexpr uint32_t HOST_MPC_MAX_PULSE_MS = 300000;
+static constexpr uint32_t HOST_MPC_MIN_SOAK_MS = 10000;
+
+// Learned thermal cache (thermal_cache.h): each run folds its observation
+// into the preset's entry with this EMA weight. Heat-up ends when the
+// chamber first comes within HOST_THERMAL_CACHE_REACHED_C of the target;
+// dead time is first heater on until the chamber NTC rose
+// HOST_THERMAL_CACHE_RESPONSE_C; hold duty and overshoot need
+// HOST_THERMAL_CACHE_MIN_HOLD_MS after that, before any WAIT and on the
+// pulse table (not MPC).
+//
+// Warm start of the pulse table schedule from an entry:
+//   first pulse  HOST_THERMAL_CACHE_FIRST_RISE_PCT of the start error at the
+//                learned heat-up rate (table value .. MAX_PULSE)
+//   soaks        dead time + SOAK_MARGIN (MIN_SOAK .. table value); in HOLD
+//                sized to the learned hold duty
+//   target       offset so the peak lands OVERSHOOT_MARGIN below the target
+//                (+/- MAX_OFFSET); only the pulse rules see it, the stage
+//                and the safety limits use the real target
+static constexpr uint8_t HOST_THERMAL_CACHE_EMA_PCT = 30;
+static constexpr float HOST_THERMAL_CACHE_REACHED_C = 5.0f;
+static constexpr float HOST_THERMAL_CACHE_RESPONSE_C = 0.3f;
+static constexpr uint32_t HOST_THERMAL_CACHE_MIN_HOLD_MS = 10u * 60u * 1000u;
+static constexpr uint8_t HOST_THERMAL_CACHE_FIRST_RISE_PCT = 50;
+static constexpr uint32_t HOST_THERMAL_CACHE_MAX_PULSE_MS = 30000;
+static constexpr uint32_t HOST_THERMAL_CACHE_MIN_SOAK_MS = 10000;
+static constexpr uint32_t HOST_THERMAL_CACHE_SOAK_MARGIN_MS = 5000;
+static constexpr float HOST_THERMAL_CACHE_OVERSHOOT_MARGIN_C = 0.5f;
+static constexpr float HOST_THERMAL_CACHE_MAX_OFFSET_C = 3.0f;
 
 // ----------------------------------------------------------------------------
 // Public API
@@ -337,4 +507,11 @@ void oven_set_runtime_actuator_lamp(bool on);
 void oven_comm_init(HardwareSerial &serial, uint32_t baudrate, uint8_t rx, uint8_t tx);
 void oven_comm_poll(void);
 
+// Called from the RX task whenever received frames are waiting for
+// oven_comm_poll(). Set before oven_comm_init(); only effective with the RX
+// task running (oven_comm_rx_event_driven()), otherwise the UART must be
+// polled.
+void oven_comm_set_rx_wake(void (*wake)(void *ctx), void *ctx);
+bool oven_comm_rx_event_driven(void);
+
 // END OF FILE
@@ -33,6 +33,11 @@ constexpr int PIN_MAX6675_SCK = 18; // GPIO18 (SPI_SCK)
 constexpr int PIN_MAX6675_CS = 5;   // GPIO5 (SPI_SS)
 constexpr int PIN_MAX6675_SO = 19;  // GPIO19 (SPI(MISO))
 
+// -------------------------------------------
+// ADS1115 ALERT/RDY (open drain, conversion ready)
+// -------------------------------------------
+constexpr int PIN_ADS_ALERT_RDY = 21; // GPIO21 (I2C runs on GPIO22/23)
+
 // -------------------------------------------
 // Internel Board-LED
 // -------------------------------------------
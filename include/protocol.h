@@ -23,6 +23,11 @@ struct ProtocolStatus {
     int16_t  tempHotspot_dC;  // Hotspot (safety)
     int16_t  tempChamber_dC;  // Chamber (control/UI)
 
+    // Age of the sensor data (optional on the wire, sampleSeq 0 = not sent).
+    uint16_t sampleSeq;       // client sample counter, skips 0 on wrap
+    uint16_t sampleAgeMs;     // sample age when the frame was built
+    uint16_t sensorFaults;    // client sensor fault bits (ntc_fault.h), sent with the sample fields
+
     // Deprecated (kept temporarily for Step-3 compile-safety if any legacy code still references it).
     // Semantics: equals tempChamber_dC.
 };
@@ -30,28 +35,116 @@ struct ProtocolStatus {
 enum class ProtocolMessageType : uint8_t {
     Unknown = 0,
     // Host -> Client
-    HostUpd, // H;UPD;SSSS;CCCC
-    HostTog, // H;TOG;TTTT
+    HostUpd, // H;UPD;SSSS;CCCC[;#QQ]  (QQ = optional sequence number)
+    HostTog, // H;TOG;TTTT[;#QQ]
     HostSet,
     HostGetStatus,
     HostPing,
     HostRst,
 
     // Client -> Host
-    ClientAckUpd, // C;ACK;UPD;MMMM
-    ClientAckTog, // C;ACK;TOG;MMMM
+    ClientAckUpd, // C;ACK;UPD;MMMM[;#QQ] (QQ echoed from the command)
+    ClientAckTog, // C;ACK;TOG;MMMM[;#QQ]
     ClientAckSet,
     ClientErrSet,
     ClientStatus,
     ClientPong,
     ClientRst,
+
+    // Link mode negotiation (always ASCII, see protocol_bin.h)
+    HostBin,      // H;BIN;MMMM   (MMMM = requested ProtocolLinkMode)
+    ClientAckBin, // C;ACK;BIN;MMMM (MMMM = mode the client switched to)
+
+    // Push-based STATUS subscription
+    HostSub,      // H;SUB;PPPP;TTTT (period ms, ProtocolSubTrigger mask; 0000 = off)
+    ClientAckSub, // C;ACK;SUB;PPPP  (PPPP = period the client will push with)
+
+    // Combined actuate-and-report
+    HostAct,      // H;ACT;SSSS;CCCC[;#QQ] (UPD semantics, SET = ACT(m, ~m))
+    ClientAckAct, // C;ACK;ACT;MMMM;<status fields as C;STATUS>[;#QQ]
+
+    // Link baud rate negotiation (see ProtocolLinkBaud)
+    HostBaud,      // H;BAUD;RRRR (RRRR = proposed rate / 100)
+    ClientAckBaud, // C;ACK;BAUD;RRRR (RRRR = rate the client switched to)
+};
+
+// Event triggers for H;SUB: the client pushes a STATUS right away (in addition
+// to the periodic push) when one of the selected conditions changes.
+enum ProtocolSubTrigger : uint16_t {
+    SubTriggerDoor = 0x0001,    // door input edge
+    SubTriggerOutputs = 0x0002, // applied outputs mask changed (SET/UPD/TOG/SAFE)
+    SubTriggerSensorFault = 0x0004, // sensor fault mask changed
+};
+
+// Encodings selectable via H;BIN;MMMM.
+enum class ProtocolLinkMode : uint16_t {
+    Ascii = 0x0000,
+    CobsCrc16 = 0x0001,
+};
+
+// Link baud rates for H;BAUD;RRRR. Every session starts on kBase; the host
+// proposes a faster rate after link sync and both sides fall back to kBase
+// on failed verification, parse error bursts or silence.
+struct ProtocolLinkBaud {
+    static constexpr uint32_t kBase = 115200;
+    static constexpr uint32_t kMax = 921600;
+    static constexpr uint8_t kRateCount = 4;
+    static constexpr uint32_t kRates[kRateCount] = {921600, 460800, 230400, 115200}; // fastest first
+
+    static constexpr uint16_t toField(uint32_t baud) { return static_cast<uint16_t>(baud / 100); }
+    static constexpr uint32_t fromField(uint16_t field) { return static_cast<uint32_t>(field) * 100; }
+
+    // Index into kRates, -1 if `baud` is not a supported link rate.
+    static int8_t indexOf(uint32_t baud) {
+        for (uint8_t i = 0; i < kRateCount; ++i) {
+            if (kRates[i] == baud) {
+                return static_cast<int8_t>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+// Sequence numbers of SET/UPD/TOG/ACT (;#QQ): 1..255, wrapping. The client
+// tracks kTrackSpan numbers around the one it expects next: behind is a
+// retransmit, ahead waits for the gap to be filled. A number further ahead
+// resynchronizes it; the host jumps that far when it gives up on a number.
+struct ProtocolSeq {
+    static constexpr uint8_t kTrackSpan = 16;
+
+    static constexpr uint8_t advance(uint8_t seq, uint8_t n) {
+        return static_cast<uint8_t>((static_cast<unsigned>(seq) - 1u + n) % 255u + 1u);
+    }
+};
+
+// Typed result of ProtocolCodec::parseFrame().
+// Only the fields belonging to `type` are meaningful; all others are zero.
+struct ProtocolMessage {
+    ProtocolMessageType type; // Unknown if the frame was rejected
+    ProtocolStatus status;    // ClientStatus, ClientAckAct
+    uint16_t mask;            // SET/TOG mask, UPD/ACT set-mask, ACK result mask, SUB period, BAUD rate
+    uint16_t maskB;           // UPD/ACT clear-mask, SUB trigger mask
+    uint16_t maskC;           // reserved
+    int errorCode;            // ClientErrSet
+    uint8_t seq;              // SET/UPD/TOG + ACK sequence number (1..255), 0 = none
 };
 
 class ProtocolCodec {
   public:
+    // Maximum number of ';'-separated fields inspected per frame
+    // (C;ACK;ACT with sample fields and sequence field has 15).
+    static constexpr uint8_t kMaxFields = 15;
+
+    // Parse a single frame (without trailing CR/LF) directly from a char span.
+    // Tokenizes in place and decodes hex/decimal fields without any heap use.
+    // `data` does not need to be NUL-terminated.
+    // Returns true on success, false on parse error (msg.type == Unknown).
+    static bool parseFrame(const char *data, size_t len, ProtocolMessage &msg);
+
     // Parse a single line (without trailing CR/LF).
     // Fills type, status, mask, errorCode as applicable.
     // Returns true on success, false on parse error.
+    // Thin wrapper around parseFrame() kept for existing callers.
     static bool parseLine(const String &line,
                           ProtocolMessageType &type,
                           ProtocolStatus &status,
@@ -60,6 +153,59 @@ class ProtocolCodec {
                           uint16_t &maskB,
                           uint16_t &maskC);
 
+    // Worst-case frame length incl. CRLF and terminating NUL
+    // (C;ACK;ACT with six "-32768" fields, ;FFFF;65535;FFFF and ;#QQ is 81 chars + CRLF).
+    static constexpr size_t kMaxFrameLen = 84;
+
+    // ---------------------------------------------------------------------
+    // Allocation-free builders: write a complete frame (incl. CRLF) into
+    // `buf`, NUL-terminate it and return its length without the NUL.
+    // Return 0 if `cap` is too small. Use kMaxFrameLen for stack buffers.
+    // SET/UPD/TOG and their ACKs take an optional sequence number that is
+    // appended as ";#XX" (seq == 0 = classic frame without the field).
+    // ---------------------------------------------------------------------
+
+    // Host → Client messages
+    static size_t buildHostSet(char *buf, size_t cap, uint16_t mask, uint8_t seq = 0);
+    static size_t buildHostGetStatus(char *buf, size_t cap);
+    static size_t buildHostPing(char *buf, size_t cap);
+    static size_t buildHostRst(char *buf, size_t cap);
+    static size_t buildHostUpd(char *buf, size_t cap, uint16_t setMask, uint16_t clrMask, uint8_t seq = 0);
+    static size_t buildHostTog(char *buf, size_t cap, uint16_t togMask, uint8_t seq = 0);
+
+    // Client → Host messages
+    static size_t buildClientAckSet(char *buf, size_t cap, uint16_t mask, uint8_t seq = 0);
+    static size_t buildClientErrSet(char *buf, size_t cap, int errorCode);
+    static size_t buildClientStatus(char *buf, size_t cap, const ProtocolStatus &status);
+    static size_t buildClientPong(char *buf, size_t cap);
+    static size_t buildClientRst(char *buf, size_t cap);
+    static size_t buildClientAckUpd(char *buf, size_t cap, uint16_t newMask, uint8_t seq = 0);
+    static size_t buildClientAckTog(char *buf, size_t cap, uint16_t newMask, uint8_t seq = 0);
+
+    // Link mode negotiation
+    static size_t buildHostBin(char *buf, size_t cap, uint16_t mode);
+    static size_t buildClientAckBin(char *buf, size_t cap, uint16_t mode);
+
+    // STATUS subscription
+    static size_t buildHostSub(char *buf, size_t cap, uint16_t periodMs, uint16_t triggers);
+    static size_t buildClientAckSub(char *buf, size_t cap, uint16_t periodMs);
+
+    // Link baud rate negotiation (rate field = baud / 100)
+    static size_t buildHostBaud(char *buf, size_t cap, uint16_t rateField);
+    static size_t buildClientAckBaud(char *buf, size_t cap, uint16_t rateField);
+
+    // Combined actuate-and-report (ACK mask + full STATUS in one reply)
+    static size_t buildHostAct(char *buf, size_t cap, uint16_t setMask, uint16_t clrMask, uint8_t seq = 0);
+    static size_t buildClientAckAct(char *buf, size_t cap, uint16_t ackMask, const ProtocolStatus &status,
+                                    uint8_t seq = 0);
+
+    // Generic ASCII builder: dispatches on msg.type to the builders above.
+    static size_t buildFrame(char *buf, size_t cap, const ProtocolMessage &msg);
+
+    // ---------------------------------------------------------------------
+    // String convenience builders (heap allocating, same output as above).
+    // ---------------------------------------------------------------------
+
     // Host → Client messages
     static String buildHostSet(uint16_t mask);
     static String buildHostGetStatus();
@@ -83,8 +229,9 @@ class ProtocolCodec {
     static String buildClientAckTog(uint16_t newMask);
 
   private:
-    static String toHex4(uint16_t value);
-    static bool parseHex4(const String &text, uint16_t &value);
+    static bool parseHex4(const char *text, size_t len, uint16_t &value);
+    static bool parseSeq(const char *text, size_t len, uint8_t &seq);
+    static long parseDecimal(const char *text, size_t len);
 };
 
 // EOF
\ No newline at end of file
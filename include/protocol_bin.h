@@ -0,0 +1,128 @@
+#pragma once
+
+#include "protocol.h"
+#include <Arduino.h>
+
+// ============================================================================
+//  protocol_bin.h
+//
+//  Optional binary encoding of the host/client link (negotiated via
+//  H;BIN;0001 after linkSynced, see HostComm).
+//
+//  Wire format of one frame:
+//
+//    0x00 | COBS( type:u8 | payload | crc16:u16 LE ) | 0x00
+//
+//  - type    = ProtocolMessageType value (same message set as ASCII)
+//  - payload = little-endian fields, layout depends on type:
+//                SET/TOG/ACK*/BIN : mask:u16 (ACK SUB: period, BAUD: rate / 100)
+//                UPD              : setMask:u16 clrMask:u16
+//                SUB              : period:u16 triggers:u16
+//                ERR SET          : errorCode:i32
+//                STATUS           : mask:u16 adc[4]:i16 hot:i16 chamber:i16
+//                                   [sampleSeq:u16 sampleAgeMs:u16 sensorFaults:u16]
+//                ACT              : setMask:u16 clrMask:u16
+//                ACK ACT          : ackMask:u16 STATUS
+//                others           : (empty)
+//              SET/UPD/TOG/ACT and their ACKs may append seq:u8 (1..255)
+//  - crc16   = CRC-16/CCITT-FALSE over type+payload
+//
+//  COBS guarantees that the encoded block contains no 0x00, so the delimiter
+//  byte never appears inside a frame and never appears in an ASCII line.
+//  Receivers therefore decode both encodings at any time; the negotiated
+//  mode only decides what a side *sends*.
+// ============================================================================
+
+class ProtocolBinCodec {
+  public:
+    static constexpr uint8_t kDelimiter = 0x00;
+
+    // Optional sample fields after a STATUS (sent when status.sampleSeq != 0).
+    static constexpr size_t kSampleExtLen = 6;
+
+    // Largest raw record: type + ACK ACT payload (2 + 14 + 6) + seq + CRC (2).
+    static constexpr size_t kMaxRecordLen = 1 + 16 + kSampleExtLen + 1 + 2;
+
+    // Largest COBS block (without delimiters) for kMaxRecordLen.
+    static constexpr size_t kMaxCobsLen = kMaxRecordLen + 1;
+
+    // Largest frame on the wire incl. both delimiters.
+    static constexpr size_t kMaxFrameLen = kMaxCobsLen + 2;
+
+    // CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection).
+    static uint16_t crc16(const uint8_t *data, size_t len, uint16_t crc = 0xFFFF);
+
+    // Consistent Overhead Byte Stuffing. Return output length, 0 on error.
+    static size_t cobsEncode(const uint8_t *in, size_t len, uint8_t *out, size_t cap);
+    static size_t cobsDecode(const uint8_t *in, size_t len, uint8_t *out, size_t cap);
+
+    // Encode a complete frame (both delimiters included) into `out`.
+    // Returns frame length or 0 if `cap` is too small / type is Unknown.
+    static size_t encode(const ProtocolMessage &msg, uint8_t *out, size_t cap);
+
+    // Decode one COBS block (bytes between the delimiters).
+    // Returns false on COBS error, CRC mismatch, unknown type or bad length.
+    static bool decode(const uint8_t *block, size_t len, ProtocolMessage &msg);
+};
+
+// ----------------------------------------------------------------------------
+//  Receive-side helper: collects bytes between two delimiters.
+//
+//  Feed every RX byte through accept(); bytes that are not part of a binary
+//  frame are reported as Result::NotBinary and belong to the ASCII assembler.
+// ----------------------------------------------------------------------------
+class ProtocolBinRx {
+  public:
+    enum class Result : uint8_t {
+        NotBinary = 0, // byte belongs to the ASCII line assembler
+        Pending,       // byte consumed, frame not complete yet
+        Frame,         // frame complete: block()/blockLen() are valid
+        Overflow,      // frame too long, dropped (next bytes go to ASCII again)
+    };
+
+    Result accept(uint8_t b) {
+        if (!_collecting) {
+            if (b != ProtocolBinCodec::kDelimiter) {
+                return Result::NotBinary;
+            }
+            _collecting = true;
+            _len = 0;
+            return Result::Pending;
+        }
+
+        if (b == ProtocolBinCodec::kDelimiter) {
+            if (_len == 0) {
+                // Back-to-back delimiters: treat as (re)start marker.
+                return Result::Pending;
+            }
+            _collecting = false;
+            return Result::Frame;
+        }
+
+        if (_len >= sizeof(_buf)) {
+            // A stray 0x00 on an ASCII link (noise, wrong rate) must not
+            // swallow the following lines while waiting for a delimiter the
+            // peer never sends.
+            _collecting = false;
+            _len = 0;
+            return Result::Overflow;
+        }
+        _buf[_len++] = b;
+        return Result::Pending;
+    }
+
+    const uint8_t *block() const { return _buf; }
+    size_t blockLen() const { return _len; }
+    bool collecting() const { return _collecting; }
+    void reset() {
+        _collecting = false;
+        _len = 0;
+    }
+
+  private:
+    uint8_t _buf[ProtocolBinCodec::kMaxCobsLen];
+    size_t _len = 0;
+    bool _collecting = false;
+};
+
+// EOF
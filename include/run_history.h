@@ -0,0 +1,848 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+//  run_history.h
+//
+//  Append-only history of drying runs in a flash partition: one 32-byte
+//  summary per run (preset, heater profile, start, duration, time to target,
+//  overshoot, heater energy, how it ended), kept across reboots.
+//
+//  The partition is a ring of erase sectors, written strictly in order:
+//
+//    sector: header (16 B) | index (768 B, written when the sector is full)
+//            | 103 record slots of 32 B
+//    header: u32 magic | u32 seq | u16 version | u16 record size | u32 crc
+//    record: u8 kind | u8 reason | u8 preset | u8 profile | u32 runId
+//            | u32 start_s | u32 duration_s | u32 timeToTarget_s
+//            | u16 energy_Wh | i16 overshoot_dC | i16 target_dC | u8 flags
+//            | u8 0xFF | u32 crc                          (little endian)
+//    index:  per preset of the sector, in preset order: runs, reached,
+//            aborted and the sums an aggregate needs, plus the sector's
+//            start time range
+//
+//  - crash safety: every record, header and index carries a CRC and goes to
+//    erased flash only, nothing is ever rewritten in place. A power cut
+//    leaves at most one torn slot, which mount() skips; the next append goes
+//    to the slot after it
+//  - a run writes a start record when it begins and its summary when it
+//    ends; a start without a summary after a reboot is a run cut short by
+//    power loss (pendingRun())
+//  - wear: the sectors are used round-robin, so every sector is erased once
+//    per lap (~50 runs per erase); the oldest sector is dropped when the
+//    ring wraps
+//  - queries: mount() keeps a few bytes per sector in RAM (seq, time range,
+//    preset bitmap); aggregate() reads one index entry of every sector
+//    inside the time range and scans only the sectors at its edges
+//
+//  All flash access goes through RunHistoryFlash, so the store runs natively
+//  against a file-backed NOR flash (test/native_support/file_flash.h,
+//  test_native_run_history). src/app/run_history.cpp puts it on the data
+//  partition and hooks it into the oven runtime.
+// ============================================================================
+
+#ifndef RUN_HISTORY_MAX_SECTORS
+#define RUN_HISTORY_MAX_SECTORS 384u // 1.5 MB of 4 KB sectors; more are not used
+#endif
+
+// NOR flash: erase sets a sector to 0xFF, program only clears bits.
+class RunHistoryFlash {
+  public:
+    virtual ~RunHistoryFlash() = default;
+    virtual uint32_t sectorSize() const = 0;
+    virtual uint32_t sectorCount() const = 0;
+    virtual bool read(uint32_t addr, void *dst, size_t len) = 0;
+    virtual bool program(uint32_t addr, const void *src, size_t len) = 0;
+    virtual bool erase(uint32_t sector) = 0;
+};
+
+enum RunEndReason : uint8_t {
+    RUN_END_COMPLETED = 0, // timer ran out (POST follows)
+    RUN_END_USER_STOP,
+    RUN_END_COMM_LOST, // local safe stop, client link lost
+    RUN_END_POWER_LOSS, // found unfinished after a reboot
+    RUN_END_REASON_COUNT
+};
+
+enum RunFlag : uint8_t {
+    RUN_FLAG_SAFETY = 0x01,     // a hard safety limit tripped during the run
+    RUN_FLAG_DOOR = 0x02,       // the door was opened (WAIT)
+    RUN_FLAG_MPC = 0x04,        // MPC controlled at some point
+    RUN_FLAG_WARM_START = 0x08, // started from the thermal cache
+};
+
+static constexpr uint32_t RUN_HISTORY_NOT_REACHED = 0xFFFFFFFFu;
+
+typedef struct RunSummary {
+    uint32_t runId; // counts up across reboots
+    uint32_t start_s;
+    uint32_t duration_s;
+    uint32_t timeToTarget_s; // RUN_HISTORY_NOT_REACHED if never
+    uint16_t energy_Wh;      // heater on-time x HOST_HEATER_POWER_W
+    int16_t overshoot_dC;    // chamber peak above target after reaching it
+    int16_t target_dC;
+    uint8_t preset;
+    uint8_t profile; // HeaterCurveProfileId
+    uint8_t reason;  // RunEndReason
+    uint8_t flags;   // RunFlag bits
+} RunSummary;
+
+namespace run_history {
+
+static constexpr uint32_t kSectorMagic = 0x31485352u; // "RSH1"
+static constexpr uint32_t kIndexMagic = 0x31585352u;  // "RSX1"
+static constexpr uint16_t kVersion = 1;
+static constexpr size_t kHeaderBytes = 16;
+static constexpr size_t kIndexBytes = 768;
+static constexpr size_t kRecordBytes = 32;
+static constexpr size_t kIndexEntryBytes = 24;
+static constexpr size_t kIndexHeadBytes = 16;
+static constexpr size_t kMaxIndexEntries = (kIndexBytes - kIndexHeadBytes - 4) / kIndexEntryBytes;
+static constexpr uint8_t kAnyPreset = 0xFF;
+
+enum RecordKind : uint8_t {
+    kRecordStart = 0x5A,
+    kRecordEnd = 0xA5,
+};
+
+enum IndexFlag : uint8_t {
+    kIndexOverflow = 0x01, // more presets than entries: scan the sector
+};
+
+inline uint32_t crc32(const uint8_t *p, size_t n, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) {
+        crc ^= p[i];
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+inline void put16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+inline void put32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+inline uint16_t get16(const uint8_t *p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+inline uint32_t get32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline bool erased(const uint8_t *p, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void encodeRecord(uint8_t *out, RecordKind kind, const RunSummary &r) {
+    out[0] = kind;
+    out[1] = r.reason;
+    out[2] = r.preset;
+    out[3] = r.profile;
+    put32(out + 4, r.runId);
+    put32(out + 8, r.start_s);
+    put32(out + 12, r.duration_s);
+    put32(out + 16, r.timeToTarget_s);
+    put16(out + 20, r.energy_Wh);
+    put16(out + 22, static_cast<uint16_t>(r.overshoot_dC));
+    put16(out + 24, static_cast<uint16_t>(r.target_dC));
+    out[26] = r.flags;
+    out[27] = 0xFF;
+    put32(out + 28, crc32(out, kRecordBytes - 4));
+}
+
+// false: torn or no record.
+inline bool decodeRecord(const uint8_t *p, RecordKind *kind, RunSummary *out) {
+    if ((p[0] != kRecordStart && p[0] != kRecordEnd) || get32(p + 28) != crc32(p, kRecordBytes - 4)) {
+        return false;
+    }
+    *kind = static_cast<RecordKind>(p[0]);
+    out->reason = p[1];
+    out->preset = p[2];
+    out->profile = p[3];
+    out->runId = get32(p + 4);
+    out->start_s = get32(p + 8);
+    out->duration_s = get32(p + 12);
+    out->timeToTarget_s = get32(p + 16);
+    out->energy_Wh = get16(p + 20);
+    out->overshoot_dC = static_cast<int16_t>(get16(p + 22));
+    out->target_dC = static_cast<int16_t>(get16(p + 24));
+    out->flags = p[26];
+    return true;
+}
+
+// Sums over the runs of one preset in one sector (the on-flash index), or
+// over a query.
+struct RunAggregate {
+    uint32_t runs;
+    uint32_t reached;          // runs that reached the target
+    uint32_t aborted;          // reason != RUN_END_COMPLETED
+    uint32_t sumTimeToTarget_s; // over the reached runs
+    uint32_t sumOvershoot_dC;   // over the reached runs, negative counts as 0
+    uint32_t sumEnergy_Wh;
+    uint32_t sumDuration_s;
+    int16_t maxOvershoot_dC;
+
+    void add(const RunSummary &r) {
+        runs++;
+        aborted += r.reason != RUN_END_COMPLETED ? 1u : 0u;
+        if (r.timeToTarget_s != RUN_HISTORY_NOT_REACHED) {
+            reached++;
+            sumTimeToTarget_s += r.timeToTarget_s;
+            sumOvershoot_dC += r.overshoot_dC > 0 ? static_cast<uint32_t>(r.overshoot_dC) : 0u;
+            maxOvershoot_dC = r.overshoot_dC > maxOvershoot_dC ? r.overshoot_dC : maxOvershoot_dC;
+        }
+        sumEnergy_Wh += r.energy_Wh;
+        sumDuration_s += r.duration_s;
+    }
+    void add(const RunAggregate &a) {
+        runs += a.runs;
+        reached += a.reached;
+        aborted += a.aborted;
+        sumTimeToTarget_s += a.sumTimeToTarget_s;
+        sumOvershoot_dC += a.sumOvershoot_dC;
+        sumEnergy_Wh += a.sumEnergy_Wh;
+        sumDuration_s += a.sumDuration_s;
+        maxOvershoot_dC = a.maxOvershoot_dC > maxOvershoot_dC ? a.maxOvershoot_dC : maxOvershoot_dC;
+    }
+};
+
+// Index entry: u8 preset | u8 runs | u8 reached | u8 aborted | u32 sumTtt
+// | u32 sumOvershoot | u32 sumEnergy | u32 sumDuration | i16 maxOvershoot
+// | u16 0xFFFF
+inline void encodeIndexEntry(uint8_t *out, uint8_t preset, const RunAggregate &a) {
+    out[0] = preset;
+    out[1] = static_cast<uint8_t>(a.runs);
+    out[2] = static_cast<uint8_t>(a.reached);
+    out[3] = static_cast<uint8_t>(a.aborted);
+    put32(out + 4, a.sumTimeToTarget_s);
+    put32(out + 8, a.sumOvershoot_dC);
+    put32(out + 12, a.sumEnergy_Wh);
+    put32(out + 16, a.sumDuration_s);
+    put16(out + 20, static_cast<uint16_t>(a.maxOvershoot_dC));
+    put16(out + 22, 0xFFFF);
+}
+
+inline uint8_t decodeIndexEntry(const uint8_t *p, RunAggregate *a) {
+    *a = RunAggregate();
+    a->runs = p[1];
+    a->reached = p[2];
+    a->aborted = p[3];
+    a->sumTimeToTarget_s = get32(p + 4);
+    a->sumOvershoot_dC = get32(p + 8);
+    a->sumEnergy_Wh = get32(p + 12);
+    a->sumDuration_s = get32(p + 16);
+    a->maxOvershoot_dC = static_cast<int16_t>(get16(p + 20));
+    return p[0];
+}
+
+// What a query cost (benchmarks, tests).
+struct QueryCost {
+    uint32_t sectorsFromIndex;
+    uint32_t sectorsScanned;
+    uint32_t bytesRead;
+};
+
+// ----------------------------------------------------------------------------
+// Store
+// ----------------------------------------------------------------------------
+
+class Store {
+  public:
+    static constexpr uint32_t kNoSeq = 0xFFFFFFFFu;
+
+    struct Stats {
+        uint32_t sectors;     // in use by the store
+        uint32_t slotsPerSector;
+        uint32_t sectorsHeld; // with a valid header
+        uint32_t runs;        // summaries held
+        uint32_t torn;        // slots skipped (power cut while writing)
+        uint32_t erases;      // since mount
+        uint32_t programs;    // since mount
+        uint32_t indexesRebuilt; // at mount, written for a closed sector without one
+        uint32_t mountBytesRead;
+        uint32_t oldest_s;
+        uint32_t newest_s;
+    };
+
+    // Reads every sector header, the index of every closed sector and the
+    // records of the open one. false: the flash is unusable (too small,
+    // wrong sector size, read error); the store stays off.
+    bool mount(RunHistoryFlash *flash) {
+        _flash = nullptr;
+        memset(&_stats, 0, sizeof(_stats));
+        if (!flash || flash->sectorSize() < kHeaderBytes + kIndexBytes + 4 * kRecordBytes ||
+            flash->sectorCount() < 2) {
+            return false;
+        }
+        _flash = flash;
+        const uint32_t readBefore = _bytesRead;
+        _sectorBytes = flash->sectorSize();
+        _sectors = flash->sectorCount() < RUN_HISTORY_MAX_SECTORS ? flash->sectorCount() : RUN_HISTORY_MAX_SECTORS;
+        _slots = static_cast<uint32_t>((_sectorBytes - kHeaderBytes - kIndexBytes) / kRecordBytes);
+        _newestSeq = kNoSeq;
+        _writeSlot = 0;
+        _nextRunId = 1;
+        _pending = false;
+        _stats.sectors = _sectors;
+        _stats.slotsPerSector = _slots;
+
+        for (uint32_t i = 0; i < _sectors; ++i) {
+            SectorInfo &si = _info[i];
+            si = SectorInfo();
+            uint8_t h[kHeaderBytes];
+            if (!readAt(i, 0, h, sizeof(h))) {
+                _flash = nullptr;
+                return false;
+            }
+            if (get32(h) != kSectorMagic || get16(h + 8) != kVersion || get16(h + 10) != kRecordBytes ||
+                get32(h + 12) != crc32(h, 12) || get32(h + 4) % _sectors != i) {
+                continue;
+            }
+            si.seq = get32(h + 4);
+            si.state = kClosed;
+            _stats.sectorsHeld++;
+            if (_newestSeq == kNoSeq || si.seq > _newestSeq) {
+                _newestSeq = si.seq;
+            }
+        }
+        if (_newestSeq == kNoSeq) {
+            _stats.mountBytesRead = _bytesRead - readBefore;
+            return true; // blank (or foreign) partition: the first append formats a sector
+        }
+
+        for (uint32_t i = 0; i < _sectors; ++i) {
+            SectorInfo &si = _info[i];
+            if (si.state == kFree) {
+                continue;
+            }
+            if (si.seq == _newestSeq) {
+                continue;
+            }
+            if (!loadIndex(i)) {
+                scanSector(i, nullptr);
+                if (writeIndex(i)) {
+                    _stats.indexesRebuilt++;
+                }
+            }
+        }
+
+        // The open sector: rebuild its sums and find the write position.
+        const uint32_t open = _newestSeq % _sectors;
+        if (loadIndex(open)) {
+            _writeSlot = _slots; // closed just before the power went; the next append opens a sector
+        } else {
+            _info[open].state = kOpen;
+            _writeSlot = scanSector(open, &_open);
+        }
+
+        // Last record of the log: run ids go on from it; a start record
+        // means the run never ended.
+        for (uint32_t back = 0; back < _sectors && back <= _newestSeq; ++back) {
+            const uint32_t idx = (_newestSeq - back) % _sectors;
+            if (_info[idx].state == kFree || _info[idx].seq != _newestSeq - back) {
+                break;
+            }
+            RecordKind kind;
+            RunSummary last;
+            if (lastRecord(idx, &kind, &last)) {
+                _nextRunId = last.runId + 1;
+                _pending = kind == kRecordStart;
+                _pendingRun = last;
+                break;
+            }
+        }
+        _stats.mountBytesRead = _bytesRead - readBefore;
+        return true;
+    }
+
+    bool mounted() const { return _flash != nullptr; }
+
+    // Erases the ring (all history is gone).
+    bool format() {
+        if (!_flash) {
+            return false;
+        }
+        for (uint32_t i = 0; i < _sectors; ++i) {
+            if (!_flash->erase(i)) {
+                return false;
+            }
+            _stats.erases++;
+            _info[i] = SectorInfo();
+        }
+        _newestSeq = kNoSeq;
+        _writeSlot = 0;
+        _pending = false;
+        _stats.sectorsHeld = 0;
+        _stats.runs = 0;
+        return true;
+    }
+
+    // Start record; fills in r.runId. Only preset/profile/target/start_s/
+    // flags are meaningful at this point.
+    bool beginRun(RunSummary &r) {
+        r.runId = _nextRunId;
+        if (!append(kRecordStart, r)) {
+            return false;
+        }
+        _nextRunId++;
+        _pending = true;
+        _pendingRun = r;
+        return true;
+    }
+
+    // Summary record of a finished run (runId from beginRun(), or 0 for a
+    // run that had none: it gets the next id).
+    bool endRun(RunSummary &r) {
+        if (r.runId == 0) {
+            r.runId = _nextRunId++;
+        }
+        if (!append(kRecordEnd, r)) {
+            return false;
+        }
+        _pending = false;
+        return true;
+    }
+
+    // The start record of a run without a summary (power loss), if any.
+    bool pendingRun(RunSummary *out) const {
+        if (!_pending) {
+            return false;
+        }
+        if (out) {
+            *out = _pendingRun;
+        }
+        return true;
+    }
+
+    // Adds up the runs of one preset (kAnyPreset: all) that started in
+    // [from_s, to_s].
+    bool aggregate(uint8_t preset, uint32_t from_s, uint32_t to_s, RunAggregate *out, QueryCost *cost = nullptr) {
+        QueryCost local = {};
+        QueryCost &c = cost ? *cost : local;
+        c = QueryCost();
+        *out = RunAggregate();
+        if (!_flash) {
+            return false;
+        }
+        const uint32_t before = _bytesRead;
+        const uint64_t bit = presetBit(preset);
+        for (uint32_t i = 0; i < _sectors; ++i) {
+            const SectorInfo &si = _info[i];
+            if (si.state == kFree || si.runs == 0 || si.tLast < from_s || si.tFirst > to_s ||
+                (preset != kAnyPreset && !(si.presetMask & bit))) {
+                continue;
+            }
+            const bool inside = si.tFirst >= from_s && si.tLast <= to_s;
+            if (inside && si.state == kOpen && !_open.overflow) {
+                for (uint8_t e = 0; e < _open.count; ++e) {
+                    if (preset == kAnyPreset || _open.preset[e] == preset) {
+                        out->add(_open.sums[e]);
+                    }
+                }
+                continue;
+            }
+            if (inside && si.indexed && addFromIndex(i, preset, out)) {
+                c.sectorsFromIndex++;
+                continue;
+            }
+            c.sectorsScanned++;
+            forEachRecord(i, [&](RecordKind kind, const RunSummary &r) {
+                if (kind == kRecordEnd && r.start_s >= from_s && r.start_s <= to_s &&
+                    (preset == kAnyPreset || r.preset == preset)) {
+                    out->add(r);
+                }
+            });
+        }
+        c.bytesRead = _bytesRead - before;
+        return true;
+    }
+
+    // The newest summaries, newest first. Returns how many were written.
+    size_t recent(RunSummary *out, size_t max) {
+        size_t n = 0;
+        if (!_flash || _newestSeq == kNoSeq) {
+            return 0;
+        }
+        for (uint32_t back = 0; back < _sectors && back <= _newestSeq && n < max; ++back) {
+            const uint32_t idx = (_newestSeq - back) % _sectors;
+            if (_info[idx].state == kFree || _info[idx].seq != _newestSeq - back) {
+                break;
+            }
+            uint8_t rec[kRecordBytes];
+            for (uint32_t s = _slots; s-- > 0 && n < max;) {
+                RecordKind kind;
+                RunSummary r;
+                if (readAt(idx, slotOffset(s), rec, sizeof(rec)) && decodeRecord(rec, &kind, &r) &&
+                    kind == kRecordEnd) {
+                    out[n++] = r;
+                }
+            }
+        }
+        return n;
+    }
+
+    Stats stats() const {
+        Stats s = _stats;
+        s.runs = 0;
+        s.oldest_s = 0xFFFFFFFFu;
+        s.newest_s = 0;
+        for (uint32_t i = 0; i < _sectors; ++i) {
+            const SectorInfo &si = _info[i];
+            if (si.state != kFree && si.runs) {
+                s.runs += si.runs;
+                s.oldest_s = si.tFirst < s.oldest_s ? si.tFirst : s.oldest_s;
+                s.newest_s = si.tLast > s.newest_s ? si.tLast : s.newest_s;
+            }
+        }
+        if (s.runs == 0) {
+            s.oldest_s = 0;
+        }
+        return s;
+    }
+
+    uint32_t nextRunId() const { return _nextRunId; }
+    uint32_t bytesRead() const { return _bytesRead; }
+
+  private:
+    enum SectorState : uint8_t { kFree = 0, kClosed, kOpen };
+
+    struct SectorInfo {
+        uint32_t seq = 0;
+        uint32_t tFirst = 0xFFFFFFFFu; // start time range of the summaries
+        uint32_t tLast = 0;
+        uint64_t presetMask = 0; // bit (preset % 64); a hint, the index decides
+        uint16_t runs = 0;
+        uint8_t state = kFree;
+        uint8_t entries = 0; // in the on-flash index
+        bool indexed = false;
+    };
+
+    // Per-preset sums of the open sector; becomes its index when it is full.
+    struct OpenSums {
+        uint8_t count;
+        bool overflow;
+        uint8_t preset[kMaxIndexEntries];
+        RunAggregate sums[kMaxIndexEntries];
+    };
+
+    static uint64_t presetBit(uint8_t preset) { return 1ull << (preset % 64u); }
+
+    uint32_t slotOffset(uint32_t slot) const {
+        return static_cast<uint32_t>(kHeaderBytes + kIndexBytes + slot * kRecordBytes);
+    }
+
+    bool readAt(uint32_t sector, uint32_t off, void *dst, size_t len) {
+        _bytesRead += static_cast<uint32_t>(len);
+        return _flash->read(sector * _sectorBytes + off, dst, len);
+    }
+    bool programAt(uint32_t sector, uint32_t off, const void *src, size_t len) {
+        _stats.programs++;
+        return _flash->program(sector * _sectorBytes + off, src, len);
+    }
+
+    static void noteRun(SectorInfo &si, const RunSummary &r) {
+        si.runs++;
+        si.tFirst = r.start_s < si.tFirst ? r.start_s : si.tFirst;
+        si.tLast = r.start_s > si.tLast ? r.start_s : si.tLast;
+        si.presetMask |= presetBit(r.preset);
+    }
+
+    static void addToSums(OpenSums &o, const RunSummary &r) {
+        for (uint8_t e = 0; e < o.count; ++e) {
+            if (o.preset[e] == r.preset) {
+                o.sums[e].add(r);
+                return;
+            }
+        }
+        if (o.count == kMaxIndexEntries) {
+            o.overflow = true;
+            return;
+        }
+        o.preset[o.count] = r.preset;
+        o.sums[o.count] = RunAggregate();
+        o.sums[o.count].add(r);
+        o.count++;
+    }
+
+    template <typename F>
+    void forEachRecord(uint32_t sector, F &&f) {
+        uint8_t rec[kRecordBytes];
+        for (uint32_t s = 0; s < _slots; ++s) {
+            RecordKind kind;
+            RunSummary r;
+            if (!readAt(sector, slotOffset(s), rec, sizeof(rec))) {
+                return;
+            }
+            if (erased(rec, sizeof(rec))) {
+                return; // slots are written in order
+            }
+            if (decodeRecord(rec, &kind, &r)) {
+                f(kind, r);
+            }
+        }
+    }
+
+    bool lastRecord(uint32_t sector, RecordKind *kind, RunSummary *out) {
+        bool found = false;
+        forEachRecord(sector, [&](RecordKind k, const RunSummary &r) {
+            *kind = k;
+            *out = r;
+            found = true;
+        });
+        return found;
+    }
+
+    // Rebuilds the RAM info (and sums, if wanted) of a sector from its
+    // records. Returns the first free slot.
+    uint32_t scanSector(uint32_t sector, OpenSums *sums) {
+        SectorInfo &si = _info[sector];
+        si.runs = 0;
+        si.tFirst = 0xFFFFFFFFu;
+        si.tLast = 0;
+        si.presetMask = 0;
+        si.indexed = false;
+        OpenSums &o = sums ? *sums : _scratch; // _scratch: for writeIndex()
+        o.count = 0;
+        o.overflow = false;
+        uint32_t used = 0;
+        uint8_t rec[kRecordBytes];
+        for (uint32_t s = 0; s < _slots; ++s) {
+            if (!readAt(sector, slotOffset(s), rec, sizeof(rec)) || erased(rec, sizeof(rec))) {
+                break;
+            }
+            used = s + 1;
+            RecordKind kind;
+            RunSummary r;
+            if (!decodeRecord(rec, &kind, &r)) {
+                _stats.torn++;
+                continue;
+            }
+            if (kind == kRecordEnd) {
+                noteRun(si, r);
+                addToSums(o, r);
+            }
+        }
+        return used;
+    }
+
+    bool loadIndex(uint32_t sector) {
+        uint8_t head[kIndexHeadBytes];
+        if (!readAt(sector, kHeaderBytes, head, sizeof(head)) || get32(head) != kIndexMagic) {
+            return false;
+        }
+        const uint8_t entries = head[6];
+        if (entries > kMaxIndexEntries) {
+            return false;
+        }
+        uint8_t buf[kIndexBytes];
+        const size_t len = kIndexHeadBytes + entries * kIndexEntryBytes;
+        if (!readAt(sector, kHeaderBytes, buf, len + 4) || get32(buf + len) != crc32(buf, len)) {
+            return false;
+        }
+        SectorInfo &si = _info[sector];
+        si.entries = entries;
+        si.runs = get16(buf + 4);
+        si.tFirst = get32(buf + 8);
+        si.tLast = get32(buf + 12);
+        si.presetMask = 0;
+        for (uint8_t e = 0; e < entries; ++e) {
+            si.presetMask |= presetBit(buf[kIndexHeadBytes + e * kIndexEntryBytes]);
+        }
+        if (buf[7] & kIndexOverflow) {
+            si.presetMask = ~0ull;
+        }
+        si.indexed = !(buf[7] & kIndexOverflow);
+        si.state = kClosed;
+        return true;
+    }
+
+    // Index of a closed sector from _scratch (scanSector) or _open, entries
+    // sorted by preset. Only into an erased index area; a torn one stays,
+    // the sector is scanned.
+    bool writeIndex(uint32_t sector, const OpenSums *sums = nullptr) {
+        const OpenSums &o = sums ? *sums : _scratch;
+        uint8_t order[kMaxIndexEntries];
+        for (uint8_t e = 0; e < o.count; ++e) {
+            uint8_t k = e;
+            for (; k > 0 && o.preset[order[k - 1]] > o.preset[e]; --k) {
+                order[k] = order[k - 1];
+            }
+            order[k] = e;
+        }
+        SectorInfo &si = _info[sector];
+        uint8_t buf[kIndexBytes];
+        if (!readAt(sector, kHeaderBytes, buf, sizeof(buf)) || !erased(buf, sizeof(buf))) {
+            return false;
+        }
+        put32(buf, kIndexMagic);
+        put16(buf + 4, si.runs);
+        buf[6] = o.count;
+        buf[7] = o.overflow ? kIndexOverflow : 0;
+        put32(buf + 8, si.tFirst);
+        put32(buf + 12, si.tLast);
+        for (uint8_t e = 0; e < o.count; ++e) {
+            encodeIndexEntry(buf + kIndexHeadBytes + e * kIndexEntryBytes, o.preset[order[e]], o.sums[order[e]]);
+        }
+        const size_t len = kIndexHeadBytes + o.count * kIndexEntryBytes;
+        put32(buf + len, crc32(buf, len));
+        if (!programAt(sector, kHeaderBytes, buf, len + 4)) {
+            return false;
+        }
+        si.entries = o.count;
+        si.indexed = !o.overflow;
+        si.state = kClosed;
+        return true;
+    }
+
+    // The index CRC was checked by mount() (or the index written by this
+    // store), so a query reads entries only. With the entries sorted by
+    // preset, a preset below 64 is at the popcount of the lower mask bits;
+    // presets that share a bit end up in the full read.
+    bool addFromIndex(uint32_t sector, uint8_t preset, RunAggregate *out) {
+        const SectorInfo &si = _info[sector];
+        const uint32_t entriesAt = static_cast<uint32_t>(kHeaderBytes + kIndexHeadBytes);
+        uint8_t buf[kMaxIndexEntries * kIndexEntryBytes];
+        RunAggregate a;
+        if (preset < 64u) {
+            const uint32_t pos = static_cast<uint32_t>(__builtin_popcountll(si.presetMask & (presetBit(preset) - 1u)));
+            if (pos < si.entries && readAt(sector, entriesAt + pos * kIndexEntryBytes, buf, kIndexEntryBytes) &&
+                decodeIndexEntry(buf, &a) == preset) {
+                out->add(a);
+                return true;
+            }
+        }
+        if (!readAt(sector, entriesAt, buf, si.entries * kIndexEntryBytes)) {
+            return false;
+        }
+        for (uint8_t e = 0; e < si.entries; ++e) {
+            const uint8_t p = decodeIndexEntry(buf + e * kIndexEntryBytes, &a);
+            if (preset == kAnyPreset || p == preset) {
+                out->add(a);
+            }
+        }
+        return true;
+    }
+
+    bool openSector() {
+        const uint32_t seq = _newestSeq == kNoSeq ? 0 : _newestSeq + 1;
+        const uint32_t idx = seq % _sectors;
+        SectorInfo &si = _info[idx];
+        if (si.state != kFree) {
+            _stats.sectorsHeld--; // the oldest lap goes
+        }
+        si = SectorInfo();
+        _stats.erases++;
+        if (!_flash->erase(idx)) {
+            return false;
+        }
+        uint8_t h[kHeaderBytes];
+        put32(h, kSectorMagic);
+        put32(h + 4, seq);
+        put16(h + 8, kVersion);
+        put16(h + 10, static_cast<uint16_t>(kRecordBytes));
+        put32(h + 12, crc32(h, 12));
+        if (!programAt(idx, 0, h, sizeof(h))) {
+            return false;
+        }
+        si.seq = seq;
+        si.state = kOpen;
+        _stats.sectorsHeld++;
+        _newestSeq = seq;
+        _writeSlot = 0;
+        _open.count = 0;
+        _open.overflow = false;
+        return true;
+    }
+
+    bool append(RecordKind kind, const RunSummary &r) {
+        if (!_flash) {
+            return false;
+        }
+        if (_newestSeq == kNoSeq || _writeSlot >= _slots) {
+            if (_newestSeq != kNoSeq) {
+                const uint32_t cur = _newestSeq % _sectors;
+                if (_info[cur].state == kOpen) {
+                    writeIndex(cur, &_open); // if this fails the sector is scanned instead
+                    _info[cur].state = kClosed;
+                }
+            }
+            if (!openSector()) {
+                return false;
+            }
+        }
+        const uint32_t idx = _newestSeq % _sectors;
+        uint8_t rec[kRecordBytes];
+        encodeRecord(rec, kind, r);
+        const uint32_t slot = _writeSlot++; // a failed slot is not reused
+        if (!programAt(idx, slotOffset(slot), rec, sizeof(rec))) {
+            return false;
+        }
+        if (kind == kRecordEnd) {
+            noteRun(_info[idx], r);
+            addToSums(_open, r);
+        }
+        return true;
+    }
+
+    RunHistoryFlash *_flash = nullptr;
+    uint32_t _sectorBytes = 0;
+    uint32_t _sectors = 0;
+    uint32_t _slots = 0;
+    uint32_t _newestSeq = kNoSeq;
+    uint32_t _writeSlot = 0;
+    uint32_t _nextRunId = 1;
+    uint32_t _bytesRead = 0;
+    bool _pending = false;
+    RunSummary _pendingRun = RunSummary();
+    SectorInfo _info[RUN_HISTORY_MAX_SECTORS];
+    OpenSums _open = {};
+    OpenSums _scratch = {};
+    Stats _stats = {};
+};
+
+} // namespace run_history
+
+// ----------------------------------------------------------------------------
+// Host API (src/app/run_history.cpp)
+// ----------------------------------------------------------------------------
+
+#ifndef HOST_HEATER_POWER_W
+#define HOST_HEATER_POWER_W 300u // nominal heater power for the energy estimate
+#endif
+
+// Mounts the store on the data partition (flash == nullptr) or on the given
+// device (native tests). A run left unfinished by a power loss is closed
+// with RUN_END_POWER_LOSS. false: no usable partition, history off.
+bool run_history_init(RunHistoryFlash *flash);
+
+// Seconds for start_s: the wall clock once it is set (NTP), otherwise the
+// newest stored time plus the uptime, so the log stays in order.
+uint32_t run_history_now_s(void);
+
+// Called by oven.cpp when a run starts and ends.
+bool run_history_begin(RunSummary &run);
+bool run_history_end(RunSummary &run);
+
+// Aggregate / recent runs for a history screen; false while off.
+bool run_history_aggregate(uint8_t preset, uint32_t from_s, uint32_t to_s, run_history::RunAggregate *out);
+size_t run_history_recent(RunSummary *out, size_t max);
+
+// Console command: "hist" (per-preset stats), "hist recent". false: not a
+// "hist" command.
+bool run_history_command(const char *line, size_t len);
+
+// EOF
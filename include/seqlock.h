@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// ============================================================================
+//  seqlock.h
+//
+//  Single-writer sequence lock for publishing a small value (a sensor
+//  sample) from one task to any number of readers without blocking either.
+//
+//  - exactly one thread (task) calls write(); read() may be called anywhere
+//  - the writer never waits; a reader retries while a write is in progress
+//    or when the value changed under it (rare with a 100 ms writer cadence)
+//  - the payload is stored as 32-bit relaxed atomics, so concurrent access
+//    is well defined; T must be trivially copyable
+//  - sequence() is even when the value is stable and increments by 2 per
+//    write, so readers can also tell whether anything new was published
+//
+//  Memory ordering: the writer marks the sequence odd, fences, stores the
+//  words and publishes the even sequence with release; the reader acquires
+//  the sequence, loads the words, fences and checks the sequence again.
+// ============================================================================
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+
+  public:
+    // Writer side --------------------------------------------------------------
+    void write(const T &value) {
+        uint32_t words[kWords] = {};
+        memcpy(words, &value, sizeof(T));
+
+        const uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side --------------------------------------------------------------
+
+    // Single attempt; false if a write was in progress or overlapped.
+    bool tryRead(T &out) const {
+        const uint32_t before = _seq.load(std::memory_order_acquire);
+        if (before & 1u) {
+            return false;
+        }
+        uint32_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_seq.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        memcpy(&out, words, sizeof(T));
+        return true;
+    }
+
+    // Consistent copy of the latest value (retries until it gets one).
+    T read() const {
+        T out;
+        while (!tryRead(out)) {
+        }
+        return out;
+    }
+
+    uint32_t sequence() const { return _seq.load(std::memory_order_acquire); }
+
+  private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> _seq{0};
+    std::atomic<uint32_t> _words[kWords] = {};
+};
+
+// EOF
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+//  spsc_ring.h
+//
+//  Lock-free single-producer / single-consumer ring buffer.
+//
+//  - exactly one thread (task) calls push(), exactly one calls pop()
+//  - N must be a power of two; the ring holds N elements
+//  - head/tail are free-running 32-bit counters, so full/empty need no
+//    spare slot and wrap-around is handled by unsigned arithmetic
+//  - push() never blocks: when the ring is full the element is dropped and
+//    counted (the consumer sees the gap through dropped())
+//
+//  Memory ordering: the producer publishes an element with a release store
+//  of _head, the consumer acquires it before reading the slot (and vice
+//  versa for _tail), which is all that is needed on a dual-core ESP32 and
+//  on x86/ARM hosts for the native tests.
+// ============================================================================
+
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+  public:
+    static constexpr size_t kCapacity = N;
+
+    // Producer side -----------------------------------------------------------
+    bool push(const T &item) {
+        const uint32_t head = _head.load(std::memory_order_relaxed);
+        const uint32_t tail = _tail.load(std::memory_order_acquire);
+        const uint32_t used = head - tail;
+        if (used >= N) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _slots[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        if (used + 1 > _highWater.load(std::memory_order_relaxed)) {
+            _highWater.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Consumer side -----------------------------------------------------------
+    bool pop(T &out) {
+        const uint32_t tail = _tail.load(std::memory_order_relaxed);
+        const uint32_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;
+        }
+        out = _slots[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side (snapshot, may be stale by the time it is used) -------------
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+  private:
+    T _slots[N];
+    // Producer and consumer indices on separate cache lines (no false sharing).
+    alignas(64) std::atomic<uint32_t> _head{0};
+    alignas(64) std::atomic<uint32_t> _tail{0};
+    std::atomic<uint32_t> _dropped{0};
+    std::atomic<uint32_t> _highWater{0};
+};
+
+// EOF
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+//  telemetry.h
+//
+//  Typed telemetry records (TELEMETRY_BINARY=1) in place of the CSV_LOG text
+//  lines of log_csv.h. Same four streams, same columns, as fixed-layout
+//  structs sent in binary frames:
+//
+//    0x1D | len | kind | stream | seq (u16 LE) | t_ms (u32 LE) | payload
+//                                                     (len = bytes after len)
+//    kind kFrameSample: the fields in schema order, little endian, packed
+//    kind kFrameSchema: u8 version | u8 n + stream name |
+//                       u8 fields | per field: u8 type | u8 n + field name
+//
+//  - the schema frame describes a stream completely; it goes out before the
+//    first sample, again whenever the UDP link comes up and every
+//    TELEMETRY_SCHEMA_PERIOD_MS, so a receiver started late learns it too
+//  - seq counts the samples of one stream (u16, wraps); a gap is a lost
+//    frame. Schema frames carry the next sample's seq.
+//  - sample rate: TELEMETRY_SLOW_PERIOD_MS, TELEMETRY_FAST_PERIOD_MS while
+//    the oven heats up (binary only, the text lines stay at 1 Hz)
+//  - frames share the UDP log stream with text lines and log_bin.h records;
+//    0x1D never starts a text line. Console output is unaffected.
+//  - tools/telemetry_recv writes the streams to CSV or column files
+//
+//  Platform-free (records, schema, encoder, emitter); log_telemetry.h binds
+//  the emitter to the log output.
+// ============================================================================
+
+#ifndef TELEMETRY_BINARY
+#define TELEMETRY_BINARY 0
+#endif
+
+#ifndef TELEMETRY_SLOW_PERIOD_MS
+#define TELEMETRY_SLOW_PERIOD_MS 1000u
+#endif
+#ifndef TELEMETRY_FAST_PERIOD_MS
+#define TELEMETRY_FAST_PERIOD_MS 100u // 10 Hz during heat-up
+#endif
+#ifndef TELEMETRY_SCHEMA_PERIOD_MS
+#define TELEMETRY_SCHEMA_PERIOD_MS 10000u
+#endif
+
+namespace telemetry {
+
+static constexpr uint8_t kFrameMark = 0x1D;
+static constexpr size_t kHeaderLen = 2;  // mark + len
+static constexpr size_t kFrameHeader = 10; // up to and including t_ms
+static constexpr size_t kMaxFrame = 255 + kHeaderLen;
+static constexpr uint8_t kSchemaVersion = 1;
+
+enum FrameKind : uint8_t {
+    kFrameSchema = 1,
+    kFrameSample = 2,
+};
+
+enum FieldType : uint8_t {
+    kI8 = 1,
+    kU8 = 2,
+    kI16 = 3,
+    kU16 = 4,
+    kI32 = 5,
+    kU32 = 6,
+};
+
+inline size_t fieldSize(uint8_t type) {
+    switch (type) {
+    case kI8:
+    case kU8:
+        return 1;
+    case kI16:
+    case kU16:
+        return 2;
+    case kI32:
+    case kU32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+enum StreamId : uint8_t {
+    kStreamClientTemp = 1,
+    kStreamClientLogic = 2,
+    kStreamHostTemp = 3,
+    kStreamHostLogic = 4,
+    kStreamCount = 5, // ids are 1..kStreamCount-1
+};
+
+struct Field {
+    const char *name;
+    uint8_t type;
+    uint8_t offset; // in the record struct
+};
+
+struct StreamDesc {
+    uint8_t id;
+    const char *name; // CSV prefix of the text line
+    const Field *fields;
+    uint8_t fieldCount;
+};
+
+// ----------------------------------------------------------------------------
+// Records (columns as in log_csv.h)
+// ----------------------------------------------------------------------------
+
+struct ClientTemp {
+    int16_t rawHot;
+    int16_t hot_dC;
+    int32_t hot_mV;
+    int16_t rawChamber;
+    int16_t cha_dC;
+    int32_t cha_mV;
+    int16_t hotFilt_dC;
+    int16_t chaFilt_dC;
+    uint8_t state;
+    uint8_t heater;
+    uint8_t door;
+};
+
+struct ClientLogic {
+    uint8_t fan12V;
+    uint8_t fan230V;
+    uint8_t fan230V_slow;
+    uint8_t motor;
+    uint8_t heater;
+    uint8_t lamp;
+    uint8_t door;
+    uint8_t state;
+};
+
+struct HostTemp {
+    int16_t chamber_dC;
+    int16_t hotspot_dC;
+    int16_t target_dC;
+    int16_t low_dC;
+    int16_t high_dC;
+    uint8_t safety;
+};
+
+struct HostLogic {
+    uint8_t mode;
+    uint8_t running;
+    uint8_t heaterReq;
+    uint8_t heaterActual;
+    uint8_t door;
+    uint8_t safety;
+    uint8_t commAlive;
+    uint8_t linkSynced;
+    uint8_t materialClass;
+    uint8_t heaterStage;
+};
+
+#define TELEMETRY_FIELD_(rec, member, type) {#member, type, static_cast<uint8_t>(offsetof(rec, member))}
+
+// Field order = CSV column order of the text line.
+inline const StreamDesc &streamDesc(const ClientTemp &) {
+    static const Field fields[] = {
+        TELEMETRY_FIELD_(ClientTemp, rawHot, kI16),
+        TELEMETRY_FIELD_(ClientTemp, hot_mV, kI32),
+        TELEMETRY_FIELD_(ClientTemp, hot_dC, kI16),
+        TELEMETRY_FIELD_(ClientTemp, rawChamber, kI16),
+        TELEMETRY_FIELD_(ClientTemp, cha_mV, kI32),
+        TELEMETRY_FIELD_(ClientTemp, cha_dC, kI16),
+        TELEMETRY_FIELD_(ClientTemp, state, kU8),
+        TELEMETRY_FIELD_(ClientTemp, heater, kU8),
+        TELEMETRY_FIELD_(ClientTemp, door, kU8),
+        TELEMETRY_FIELD_(ClientTemp, hotFilt_dC, kI16),
+        TELEMETRY_FIELD_(ClientTemp, chaFilt_dC, kI16),
+    };
+    static const StreamDesc desc = {kStreamClientTemp, "CLIENT_PLOT", fields, sizeof(fields) / sizeof(fields[0])};
+    return desc;
+}
+
+inline const StreamDesc &streamDesc(const ClientLogic &) {
+    static const Field fields[] = {
+        TELEMETRY_FIELD_(ClientLogic, fan12V, kU8),
+        TELEMETRY_FIELD_(ClientLogic, fan230V, kU8),
+        TELEMETRY_FIELD_(ClientLogic, fan230V_slow, kU8),
+        TELEMETRY_FIELD_(ClientLogic, motor, kU8),
+        TELEMETRY_FIELD_(ClientLogic, heater, kU8),
+        TELEMETRY_FIELD_(ClientLogic, lamp, kU8),
+        TELEMETRY_FIELD_(ClientLogic, door, kU8),
+        TELEMETRY_FIELD_(ClientLogic, state, kU8),
+    };
+    static const StreamDesc desc = {kStreamClientLogic, "CLIENT_LOGIC", fields, sizeof(fields) / sizeof(fields[0])};
+    return desc;
+}
+
+inline const StreamDesc &streamDesc(const HostTemp &) {
+    static const Field fields[] = {
+        TELEMETRY_FIELD_(HostTemp, chamber_dC, kI16),
+        TELEMETRY_FIELD_(HostTemp, hotspot_dC, kI16),
+        TELEMETRY_FIELD_(HostTemp, target_dC, kI16),
+        TELEMETRY_FIELD_(HostTemp, low_dC, kI16),
+        TELEMETRY_FIELD_(HostTemp, high_dC, kI16),
+        TELEMETRY_FIELD_(HostTemp, safety, kU8),
+    };
+    static const StreamDesc desc = {kStreamHostTemp, "HOST_PLOT", fields, sizeof(fields) / sizeof(fields[0])};
+    return desc;
+}
+
+inline const StreamDesc &streamDesc(const HostLogic &) {
+    static const Field fields[] = {
+        TELEMETRY_FIELD_(HostLogic, mode, kU8),
+        TELEMETRY_FIELD_(HostLogic, running, kU8),
+        TELEMETRY_FIELD_(HostLogic, heaterReq, kU8),
+        TELEMETRY_FIELD_(HostLogic, heaterActual, kU8),
+        TELEMETRY_FIELD_(HostLogic, door, kU8),
+        TELEMETRY_FIELD_(HostLogic, safety, kU8),
+        TELEMETRY_FIELD_(HostLogic, commAlive, kU8),
+        TELEMETRY_FIELD_(HostLogic, linkSynced, kU8),
+        TELEMETRY_FIELD_(HostLogic, materialClass, kU8),
+        TELEMETRY_FIELD_(HostLogic, heaterStage, kU8),
+    };
+    static const StreamDesc desc = {kStreamHostLogic, "HOST_LOGIC", fields, sizeof(fields) / sizeof(fields[0])};
+    return desc;
+}
+
+#undef TELEMETRY_FIELD_
+
+// Sample payload bytes of a stream.
+inline size_t payloadSize(const StreamDesc &d) {
+    size_t n = 0;
+    for (uint8_t i = 0; i < d.fieldCount; ++i) {
+        n += fieldSize(d.fields[i].type);
+    }
+    return n;
+}
+
+// ----------------------------------------------------------------------------
+// Encoder
+// ----------------------------------------------------------------------------
+
+inline void putLe(uint8_t *out, uint32_t v, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+}
+
+inline size_t putHeader(uint8_t *out, FrameKind kind, uint8_t stream, uint16_t seq, uint32_t timeMs) {
+    out[0] = kFrameMark;
+    out[1] = 0; // length, patched by the caller
+    out[2] = kind;
+    out[3] = stream;
+    putLe(out + 4, seq, 2);
+    putLe(out + 6, timeMs, 4);
+    return kFrameHeader;
+}
+
+// Reads one field of a record as its wire bits (sign kept by the receiver).
+inline uint32_t fieldBits(const void *rec, const Field &f) {
+    const uint8_t *p = static_cast<const uint8_t *>(rec) + f.offset;
+    switch (f.type) {
+    case kI8:
+    case kU8:
+        return *p;
+    case kI16:
+    case kU16: {
+        uint16_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    default: {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    }
+}
+
+// Returns the frame length, 0 if it does not fit into cap.
+inline size_t encodeSample(uint8_t *out, size_t cap, const StreamDesc &d, uint16_t seq, uint32_t timeMs,
+                           const void *rec) {
+    const size_t len = kFrameHeader + payloadSize(d);
+    if (len > cap || len > kMaxFrame) {
+        return 0;
+    }
+    size_t n = putHeader(out, kFrameSample, d.id, seq, timeMs);
+    for (uint8_t i = 0; i < d.fieldCount; ++i) {
+        const size_t sz = fieldSize(d.fields[i].type);
+        putLe(out + n, fieldBits(rec, d.fields[i]), sz);
+        n += sz;
+    }
+    out[1] = static_cast<uint8_t>(n - kHeaderLen);
+    return n;
+}
+
+inline bool putName(uint8_t *out, size_t cap, size_t &n, const char *name) {
+    const size_t len = strlen(name);
+    if (len > 255 || n + 1 + len > cap) {
+        return false;
+    }
+    out[n++] = static_cast<uint8_t>(len);
+    memcpy(out + n, name, len);
+    n += len;
+    return true;
+}
+
+inline size_t encodeSchema(uint8_t *out, size_t cap, const StreamDesc &d, uint16_t seq, uint32_t timeMs) {
+    if (cap > kMaxFrame) {
+        cap = kMaxFrame;
+    }
+    if (cap < kFrameHeader + 3) {
+        return 0;
+    }
+    size_t n = putHeader(out, kFrameSchema, d.id, seq, timeMs);
+    out[n++] = kSchemaVersion;
+    if (!putName(out, cap, n, d.name) || n + 1 > cap) {
+        return 0;
+    }
+    out[n++] = d.fieldCount;
+    for (uint8_t i = 0; i < d.fieldCount; ++i) {
+        if (n + 1 > cap) {
+            return 0;
+        }
+        out[n++] = d.fields[i].type;
+        if (!putName(out, cap, n, d.fields[i].name)) {
+            return 0;
+        }
+    }
+    out[1] = static_cast<uint8_t>(n - kHeaderLen);
+    return n;
+}
+
+// ----------------------------------------------------------------------------
+// Emitter: sequence numbers and schema timing per stream
+// ----------------------------------------------------------------------------
+
+class Emitter {
+  public:
+    using Sink = void (*)(const uint8_t *frame, size_t len);
+
+    explicit Emitter(Sink sink) : _sink(sink) {}
+
+    // linkUp: the output can deliver (UDP connected). A rising edge resends
+    // every schema with the next sample of its stream.
+    template <typename T>
+    void send(const T &rec, uint32_t nowMs, bool linkUp) {
+        sendRecord(streamDesc(rec), &rec, nowMs, linkUp);
+    }
+
+    void sendRecord(const StreamDesc &d, const void *rec, uint32_t nowMs, bool linkUp) {
+        if (d.id == 0 || d.id >= kStreamCount) {
+            return;
+        }
+        if (linkUp && !_linkUp) {
+            for (size_t i = 0; i < kStreamCount; ++i) {
+                _schemaDue[i] = true;
+            }
+        }
+        _linkUp = linkUp;
+
+        uint8_t frame[kMaxFrame];
+        if (_schemaDue[d.id] || (nowMs - _schemaMs[d.id]) >= TELEMETRY_SCHEMA_PERIOD_MS) {
+            const size_t n = encodeSchema(frame, sizeof(frame), d, _seq[d.id], nowMs);
+            if (n) {
+                _sink(frame, n);
+                _schemas++;
+            }
+            _schemaDue[d.id] = false;
+            _schemaMs[d.id] = nowMs;
+        }
+        const size_t n = encodeSample(frame, sizeof(frame), d, _seq[d.id], nowMs, rec);
+        if (n) {
+            _sink(frame, n);
+            _samples++;
+            _bytes += static_cast<uint32_t>(n);
+        }
+        _seq[d.id]++;
+    }
+
+    uint16_t nextSeq(uint8_t stream) const { return stream < kStreamCount ? _seq[stream] : 0; }
+    uint32_t samples() const { return _samples; }
+    uint32_t schemas() const { return _schemas; }
+    uint32_t sampleBytes() const { return _bytes; }
+
+  private:
+    Sink _sink;
+    uint16_t _seq[kStreamCount] = {};
+    uint32_t _schemaMs[kStreamCount] = {};
+    bool _schemaDue[kStreamCount] = {true, true, true, true, true};
+    bool _linkUp = false;
+    uint32_t _samples = 0;
+    uint32_t _schemas = 0;
+    uint32_t _bytes = 0;
+};
+
+// Sample period for a stream; the fast rate only applies to binary frames.
+inline uint32_t samplePeriodMs(bool fast) {
+    return (TELEMETRY_BINARY && fast) ? TELEMETRY_FAST_PERIOD_MS : TELEMETRY_SLOW_PERIOD_MS;
+}
+
+// For periodic timers that tick at samplePeriodMs(true): lets every tick
+// through while fast, every (slow / fast)-th tick otherwise.
+class Decimator {
+  public:
+    bool tick(bool fast) {
+        const uint32_t ratio = samplePeriodMs(false) / samplePeriodMs(true);
+        if (fast || ratio <= 1u || ++_count >= ratio) {
+            _count = 0;
+            return true;
+        }
+        return false;
+    }
+
+  private:
+    uint32_t _count = 0;
+};
+
+} // namespace telemetry
+
+// EOF
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "oven.h"
+
+// ----------------------------------------------------------------------------
+// Learned thermal parameters per preset, kept in NVS across runs.
+//
+// oven.cpp observes every run and folds the result in when the run ends
+// (exponential moving average, HOST_THERMAL_CACHE_EMA_PCT); the next start
+// of the same preset warm-starts its pulse/soak schedule from the entry.
+// An entry only applies to the heater profile and target it was learned
+// with; a different profile or target replaces it.
+// ----------------------------------------------------------------------------
+
+enum ThermalCacheField : uint8_t {
+    THERMAL_CACHE_HEATUP = 0x01, // heatRate_mCps, deadTimeMs, timeToReachS
+    THERMAL_CACHE_HOLD = 0x02,   // holdDuty_pm, overshoot_dC
+};
+
+typedef struct ThermalCacheEntry {
+    uint8_t runs;          // runs folded in (saturates at 255), 0 = empty
+    uint8_t fields;        // ThermalCacheField bits learned so far
+    uint8_t heaterProfile; // HeaterCurveProfileId it was learned with
+    uint8_t reserved;
+    int16_t target_dC; // target it was learned at
+
+    // Heat-up, from start until the chamber is within
+    // HOST_THERMAL_CACHE_REACHED_C of the target
+    uint16_t heatRate_mCps; // chamber rise per second of heater on-time, milli-°C
+    uint32_t deadTimeMs;    // first heater on -> chamber NTC responds
+    uint16_t timeToReachS;
+
+    // Hold phase, after that
+    uint16_t holdDuty_pm; // heater on-time share, per mille
+    int16_t overshoot_dC; // chamber peak above target, without the learned target offset
+} ThermalCacheEntry;
+
+void thermal_cache_init(void);
+
+// Entry for this preset if one was learned with the same profile and
+// target, else nullptr.
+const ThermalCacheEntry *thermal_cache_get(uint16_t presetId, HeaterCurveProfileId profile, int16_t target_dC);
+
+// Folds one run's observation in (only the fields set in observed.fields)
+// and saves the cache. Returns false if nothing was saved.
+bool thermal_cache_record(uint16_t presetId, const ThermalCacheEntry &observed);
+
+// Forgets everything (RAM and NVS).
+bool thermal_cache_clear(void);
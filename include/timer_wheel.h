@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+//  timer_wheel.h
+//
+//  Hierarchical timer wheel for the periodic work of the host and client
+//  main loops (UI refresh, comm service, once-per-second logs, ...).
+//
+//  - 1 ms resolution on the millis() clock, 4 levels of 64 slots
+//    (level 0: the next 64 ms, level 3: up to 2^24 ms = 4.6 h ahead;
+//    longer delays are parked at the top and re-filed when they get there)
+//  - fixed pool of kMaxTimers, no heap; ids stay valid until remove()
+//  - start / stop / expire are O(1); advance() skips empty 64 ms spans
+//  - one-shot and periodic timers; a periodic timer keeps its phase
+//    (deadline += period, no drift) and, when a call is late by more than
+//    one period, runs once and counts the skipped periods as missed
+//  - msUntilNext() for sleeping until the next deadline: a bit scan per
+//    level plus the timers of one slot
+//  - per-timer lateness statistics (time between deadline and the call)
+//
+//  Callbacks run from advance() and may start, stop or restart any timer,
+//  including their own. Delays given inside a callback count from the time
+//  passed to advance(), otherwise from the last advance() / reset().
+//  Not thread-safe: one wheel belongs to one loop.
+// ============================================================================
+
+class TimerWheel {
+  public:
+    using Callback = void (*)(void *ctx);
+    using TimerId = uint8_t;
+
+    static constexpr size_t kMaxTimers = 16;
+    static constexpr TimerId kInvalidTimer = 0xFF;
+    static constexpr uint32_t kNever = 0xFFFFFFFFu; // msUntilNext(): nothing armed
+
+    static constexpr uint8_t kLevelBits = 6;
+    static constexpr uint8_t kSlots = 1u << kLevelBits;
+    static constexpr uint8_t kLevels = 4;
+    static constexpr uint32_t kMaxDelayMs = (1u << (kLevelBits * kLevels)) - 1u; // without re-filing
+
+    struct Stats {
+        uint32_t calls;      // callback invocations
+        uint32_t missed;     // periods skipped because a call was late by more than one period
+        uint32_t lateLastMs; // lateness of the last call
+        uint32_t lateMaxMs;
+        uint32_t lateSumMs; // wraps; lateSumMs / calls is the mean while it does not
+    };
+
+    explicit TimerWheel(uint32_t nowMs = 0) { reset(nowMs); }
+
+    // Drops all timers and sets the wheel time.
+    void reset(uint32_t nowMs);
+
+    // Returns kInvalidTimer when the pool is full or cb is null. A zero
+    // delay fires on the next advance(); a zero period is treated as 1 ms.
+    TimerId startOneShot(const char *name, uint32_t delayMs, Callback cb, void *ctx);
+    TimerId startPeriodic(const char *name, uint32_t periodMs, Callback cb, void *ctx, uint32_t firstDelayMs);
+
+    // Re-arms a timer (one-shot or periodic) delayMs from now, keeping its
+    // callback, period and statistics.
+    bool restart(TimerId id, uint32_t delayMs);
+    bool stop(TimerId id);   // disarm, the id stays allocated
+    bool remove(TimerId id); // disarm and free the id
+    bool armed(TimerId id) const;
+
+    // Runs every callback whose deadline is <= nowMs, in deadline order.
+    // Returns the number of calls.
+    size_t advance(uint32_t nowMs);
+
+    // ms from nowMs until the next deadline (0 = due), kNever if idle.
+    uint32_t msUntilNext(uint32_t nowMs) const;
+
+    uint32_t now() const { return _now; }
+    size_t armedCount() const { return _armedCount; }
+
+    // nullptr for a free id.
+    const char *name(TimerId id) const;
+    const Stats *stats(TimerId id) const;
+    void resetStats();
+
+  private:
+    static constexpr uint8_t kNil = 0xFF;
+
+    struct Timer {
+        uint32_t deadline;
+        uint32_t periodMs; // 0 = one-shot
+        Callback cb;
+        void *ctx;
+        const char *name;
+        Stats stats;
+        uint8_t prev;
+        uint8_t next;
+        uint8_t level;
+        uint8_t slot;
+        bool used;
+        bool armed;
+    };
+
+    Timer _timers[kMaxTimers];
+    uint8_t _heads[kLevels][kSlots];
+    uint64_t _occupied[kLevels]; // bit per non-empty slot
+    uint32_t _now = 0;           // every deadline <= _now has fired
+    uint32_t _dispatchNow = 0;   // nowMs of the running advance()
+    bool _dispatching = false;
+    size_t _armedCount = 0;
+
+    TimerId allocate(const char *name, Callback cb, void *ctx, uint32_t periodMs);
+    uint32_t baseTime() const { return _dispatching ? _dispatchNow : _now; }
+    void arm(uint8_t idx, uint32_t deadline);
+    void link(uint8_t idx);
+    void unlink(uint8_t idx);
+    void cascade(uint8_t level);
+    size_t expireSlot(uint32_t nowMs);
+};
+
+// EOF
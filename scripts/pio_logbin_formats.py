@@ -0,0 +1,238 @@
+"""Build-time format table for the binary log (include/log_bin.h).
+
+Scans the sources for calls of the level macros (INFO, OVEN_INFO, UI_DBG, ...),
+computes the same call-site IDs as LOGBIN_SITE_ID() and writes one line per
+site:
+
+    id<TAB>tag<TAB>level<TAB>file:line<TAB>fmt   (fmt with \\n \\t \\\\ \\xHH escapes)
+
+tools/logbin_decode reads this table to turn binary records back into text.
+
+PlatformIO (extra_scripts = pre:scripts/pio_logbin_formats.py) writes
+$BUILD_DIR/logbin_formats.tsv; standalone:
+
+    python3 scripts/pio_logbin_formats.py [-o logbin_formats.tsv] [project_dir]
+"""
+
+import re
+import sys
+from pathlib import Path
+
+SOURCE_SUFFIXES = {".c", ".cpp", ".h", ".hpp", ".ino"}
+SCAN_DIRS = ("include", "src")
+
+_DEFINE_RE = re.compile(r"^\s*#\s*define\s+([A-Za-z_]\w*)\s*\(")
+_EMIT_RE = re.compile(r'LOG_CORE_PRINTF\(\s*"([^"]*)"\s*,\s*"([^"]*)"')
+_ESCAPES = {
+    "n": 0x0A, "t": 0x09, "r": 0x0D, "a": 0x07, "b": 0x08, "f": 0x0C, "v": 0x0B,
+    "\\": 0x5C, "'": 0x27, '"': 0x22, "?": 0x3F,
+}
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def site_id(tag, level, fmt):
+    return fnv1a(tag.encode() + b"\x1f" + level.encode() + b"\x1f" + fmt)
+
+
+def strip_comments(text):
+    """Blank out comments, keep string/char literals and line numbers."""
+    out = []
+    i, n = 0, len(text)
+    while i < n:
+        c = text[i]
+        if c == "/" and i + 1 < n and text[i + 1] == "/":
+            while i < n and text[i] != "\n":
+                i += 1
+        elif c == "/" and i + 1 < n and text[i + 1] == "*":
+            end = text.find("*/", i + 2)
+            end = n if end < 0 else end + 2
+            out.append("".join(ch if ch == "\n" else " " for ch in text[i:end]))
+            i = end
+        elif c in "\"'":
+            j = i + 1
+            while j < n and text[j] != c and text[j] != "\n":
+                j += 2 if text[j] == "\\" else 1
+            out.append(text[i:j + 1])
+            i = j + 1
+        else:
+            out.append(c)
+            i += 1
+    return "".join(out)
+
+
+def literal_bytes(body):
+    """Bytes of a C string literal body (between the quotes)."""
+    out = bytearray()
+    i = 0
+    while i < len(body):
+        c = body[i]
+        if c != "\\":
+            out += c.encode("utf-8")
+            i += 1
+            continue
+        e = body[i + 1]
+        if e == "x":
+            j = i + 2
+            while j < len(body) and body[j] in "0123456789abcdefABCDEF":
+                j += 1
+            out.append(int(body[i + 2:j], 16) & 0xFF)
+            i = j
+        elif e in "01234567":
+            j = i + 1
+            while j < len(body) and j < i + 4 and body[j] in "01234567":
+                j += 1
+            out.append(int(body[i + 1:j], 8) & 0xFF)
+            i = j
+        else:
+            out.append(_ESCAPES.get(e, ord(e)))
+            i += 2
+    return bytes(out)
+
+
+def leading_literals(text, pos):
+    """Concatenated string literals starting at pos, or None if the first
+    argument is not made of literals only."""
+    fmt = bytearray()
+    found = False
+    n = len(text)
+    while True:
+        while pos < n and text[pos].isspace():
+            pos += 1
+        if text.startswith("u8\"", pos):
+            pos += 2
+        if pos < n and text[pos] == '"':
+            j = pos + 1
+            while j < n and text[j] != '"':
+                j += 2 if text[j] == "\\" else 1
+            fmt += literal_bytes(text[pos + 1:j])
+            found = True
+            pos = j + 1
+            continue
+        break
+    if found and pos < n and text[pos] in ",)":
+        return bytes(fmt)
+    return None
+
+
+def escape(fmt):
+    """Table form of a format: control characters and backslash escaped,
+    UTF-8 kept as is."""
+    named = {0x5C: b"\\\\", 0x0A: b"\\n", 0x0D: b"\\r", 0x09: b"\\t"}
+    out = bytearray()
+    for b in fmt:
+        if b in named:
+            out += named[b]
+        elif b < 0x20 or b == 0x7F:
+            out += b"\\x%02x" % b
+        else:
+            out.append(b)
+    return bytes(out)
+
+
+def source_files(root):
+    for d in SCAN_DIRS:
+        base = root / d
+        if base.is_dir():
+            for p in sorted(base.rglob("*")):
+                if p.suffix in SOURCE_SUFFIXES and p.is_file():
+                    yield p
+
+
+def level_macros(files):
+    """NAME -> (tag, level) for every macro that ends in LOG_CORE_PRINTF."""
+    macros = {}
+    for path in files:
+        lines = path.read_text(encoding="utf-8", errors="replace").splitlines()
+        i = 0
+        while i < len(lines):
+            m = _DEFINE_RE.match(lines[i])
+            if not m:
+                i += 1
+                continue
+            block = [lines[i]]
+            while lines[i].rstrip().endswith("\\") and i + 1 < len(lines):
+                i += 1
+                block.append(lines[i])
+            e = _EMIT_RE.search(" ".join(block))
+            if e and m.group(1) != "LOG_CORE_PRINTF":
+                macros[m.group(1)] = (e.group(1), e.group(2))
+            i += 1
+    return macros
+
+
+def collect(root):
+    files = list(source_files(root))
+    macros = level_macros(files)
+    call_re = re.compile(r"\b(" + "|".join(sorted(macros, key=len, reverse=True)) + r")\s*\(")
+    sites = {}
+    skipped = []
+    collisions = []
+    for path in files:
+        text = strip_comments(path.read_text(encoding="utf-8", errors="replace"))
+        rel = path.relative_to(root).as_posix()
+        for m in call_re.finditer(text):
+            line_start = text.rfind("\n", 0, m.start()) + 1
+            if text[line_start:m.start()].lstrip().startswith("#"):
+                continue  # the macro definitions themselves
+            line = text.count("\n", 0, m.start()) + 1
+            fmt = leading_literals(text, m.end())
+            if fmt is None:
+                skipped.append("%s:%d %s" % (rel, line, m.group(1)))
+                continue
+            tag, level = macros[m.group(1)]
+            sid = site_id(tag, level, fmt)
+            key = (tag, level, fmt)
+            if sid in sites and sites[sid][0] != key:
+                collisions.append("%08x %s:%d vs %s" % (sid, rel, line, sites[sid][1]))
+                continue
+            sites.setdefault(sid, (key, "%s:%d" % (rel, line)))
+    return sites, skipped, collisions
+
+
+def write_table(root, out_path):
+    sites, skipped, collisions = collect(root)
+    out_path.parent.mkdir(parents=True, exist_ok=True)
+    with open(out_path, "wb") as f:
+        f.write(b"# logbin format table: id, tag, level, site, fmt\n")
+        for sid in sorted(sites):
+            (tag, level, fmt), where = sites[sid]
+            f.write(("%08x\t%s\t%s\t%s\t" % (sid, tag, level, where)).encode() + escape(fmt) + b"\n")
+    for s in skipped:
+        print("logbin: format is not a string literal, not in table: " + s)
+    for c in collisions:
+        print("logbin: ID collision " + c)
+    print("logbin: %d call sites -> %s" % (len(sites), out_path))
+    return not collisions
+
+
+def main(argv):
+    out = Path("logbin_formats.tsv")
+    root = Path(".")
+    args = list(argv)
+    while args:
+        a = args.pop(0)
+        if a == "-o" and args:
+            out = Path(args.pop(0))
+        else:
+            root = Path(a)
+    return 0 if write_table(root.resolve(), out) else 1
+
+
+try:
+    from SCons.Script import Import  # noqa: F401  (PlatformIO build)
+
+    Import("env")
+    write_table(
+        Path(env.subst("$PROJECT_DIR")),  # noqa: F821
+        Path(env.subst("$BUILD_DIR")) / "logbin_formats.tsv",  # noqa: F821
+    )
+except ImportError:
+    if __name__ == "__main__":
+        sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,217 @@
+#include "flight_recorder.h"
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log_oven.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_heap_caps.h>
+#endif
+
+#ifndef FLIGHT_REC_DUMP_LINES_SERIAL
+#define FLIGHT_REC_DUMP_LINES_SERIAL 1 // per step; ~10 KB/s at 115200 baud
+#endif
+#ifndef FLIGHT_REC_DUMP_LINES_UDP
+#define FLIGHT_REC_DUMP_LINES_UDP 4
+#endif
+
+namespace {
+
+static flight_rec::Recorder s_recorder;
+static bool s_psram = false;
+
+// Encode cost of flight_recorder_append() (runs inside oven_comm_poll()).
+static uint32_t s_appendCalls = 0;
+static uint32_t s_appendUsSum = 0;
+static uint32_t s_appendUsMax = 0;
+
+struct DumpState {
+    bool active;
+    FlightDumpTarget target;
+    uint32_t nextSeq;
+    uint32_t lastSeq;
+    uint32_t sent;
+    uint32_t skipped;
+};
+static DumpState s_dump = {};
+
+// ';' + one block line (';': UDP only, like the CSV lines)
+static char s_line[1 + 7 + 2 * FLIGHT_REC_BLOCK_BYTES + 1 + 8 + 1];
+
+static uint8_t *allocate_ring(size_t bytes) {
+#if defined(ARDUINO_ARCH_ESP32)
+    uint8_t *buf = static_cast<uint8_t *>(heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    s_psram = buf != nullptr;
+    return buf;
+#else
+    return static_cast<uint8_t *>(malloc(bytes));
+#endif
+}
+
+static void dump_write(const char *line, size_t n) {
+    if (s_dump.target == FLIGHT_DUMP_UDP) {
+        logEmit(line, n, true);
+    } else {
+        logEmit(line + 1, n - 1, true); // console and UDP
+    }
+}
+
+static void dump_printf(const char *fmt, ...) {
+    char buf[128];
+    buf[0] = ';';
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(buf + 1, sizeof(buf) - 1, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        dump_write(buf, 1 + ((size_t)n < sizeof(buf) - 1 ? (size_t)n : sizeof(buf) - 2));
+    }
+}
+
+} // namespace
+
+bool flight_recorder_init(void) {
+    if (s_recorder.ready()) {
+        return true;
+    }
+    uint8_t *buf = allocate_ring(FLIGHT_REC_BYTES);
+    if (!buf || !s_recorder.attach(buf, FLIGHT_REC_BYTES, FLIGHT_REC_BLOCK_BYTES)) {
+        OVEN_WARN("[FR] no memory for %u bytes, flight recorder off\n", (unsigned)FLIGHT_REC_BYTES);
+        return false;
+    }
+    OVEN_INFO("[FR] %u KB ring%s, %u B blocks\n", (unsigned)(FLIGHT_REC_BYTES / 1024u), s_psram ? " (PSRAM)" : "",
+              (unsigned)FLIGHT_REC_BLOCK_BYTES);
+    return true;
+}
+
+void flight_recorder_append(const flight_rec::FlightSample &sample) {
+    if (!s_recorder.ready()) {
+        return;
+    }
+    const bool wasPending = s_recorder.freezePending();
+    const uint32_t t0 = micros();
+    s_recorder.append(sample);
+    const uint32_t us = micros() - t0;
+    s_appendCalls++;
+    s_appendUsSum += us;
+    s_appendUsMax = us > s_appendUsMax ? us : s_appendUsMax;
+    if (wasPending && s_recorder.frozen()) {
+        OVEN_WARN("[FR] frozen at t=%lus, 'fr dump' to read, 'fr resume' to record again\n",
+                  (unsigned long)sample.t_s);
+    }
+}
+
+void flight_recorder_freeze(const char *reason) {
+    (void)reason;
+    if (!s_recorder.ready() || s_recorder.frozen() || s_recorder.freezePending()) {
+        return;
+    }
+    OVEN_WARN("[FR] freeze (%s): %u more samples\n", reason ? reason : "request", (unsigned)FLIGHT_REC_POST_TRIGGER_S);
+    s_recorder.freeze(FLIGHT_REC_POST_TRIGGER_S);
+}
+
+void flight_recorder_resume(void) {
+    if (s_recorder.frozen() || s_recorder.freezePending()) {
+        OVEN_INFO("[FR] recording again\n");
+    }
+    s_recorder.resume();
+}
+
+bool flight_recorder_dump_start(FlightDumpTarget target) {
+    if (!s_recorder.ready() || s_dump.active) {
+        return false;
+    }
+    const flight_rec::Recorder::Stats st = s_recorder.stats();
+    s_dump = DumpState{};
+    s_dump.target = target;
+    dump_printf("[FR] BEGIN blocks=%lu samples=%lu frozen=%d now_s=%lu\n", (unsigned long)st.blocksHeld,
+                (unsigned long)st.held, s_recorder.frozen() ? 1 : 0, (unsigned long)(millis() / 1000u));
+    if (s_recorder.empty()) {
+        dump_printf("[FR] END blocks=0 skipped=0\n");
+        return true;
+    }
+    s_dump.active = true;
+    s_dump.nextSeq = s_recorder.firstSeq();
+    s_dump.lastSeq = s_recorder.lastSeq();
+    return true;
+}
+
+void flight_recorder_dump_step(void) {
+    if (!s_dump.active) {
+        return;
+    }
+    const int lines = s_dump.target == FLIGHT_DUMP_UDP ? FLIGHT_REC_DUMP_LINES_UDP : FLIGHT_REC_DUMP_LINES_SERIAL;
+    for (int i = 0; i < lines && s_dump.nextSeq <= s_dump.lastSeq; ++i) {
+        size_t len = 0;
+        const uint8_t *block = s_recorder.blockBySeq(s_dump.nextSeq++, &len);
+        if (!block) {
+            s_dump.skipped++; // overwritten since the dump started
+            continue;
+        }
+        s_line[0] = ';';
+        const size_t n = flight_rec::formatBlockLine(s_line + 1, block, len);
+        dump_write(s_line, 1 + n);
+        s_dump.sent++;
+    }
+    if (s_dump.nextSeq > s_dump.lastSeq) {
+        dump_printf("[FR] END blocks=%lu skipped=%lu\n", (unsigned long)s_dump.sent, (unsigned long)s_dump.skipped);
+        s_dump.active = false;
+    }
+}
+
+bool flight_recorder_dumping(void) {
+    return s_dump.active;
+}
+
+// Asked for on the console: printed whatever OVENINFO says.
+void flight_recorder_print_stats(void) {
+    if (!s_recorder.ready()) {
+        LOG_CORE_PRINTF("OVEN", "INFO", "[FR] off\n");
+        return;
+    }
+    const flight_rec::Recorder::Stats st = s_recorder.stats();
+    const uint32_t span = st.held ? st.newest_s - st.oldest_s : 0;
+    const uint32_t bpsX100 = st.held ? (uint32_t)((uint64_t)st.bytesHeld * 100u / st.held) : 0;
+    LOG_CORE_PRINTF("OVEN", "INFO", "[FR] %lu samples (%lu.%01lu h) in %lu/%lu KB%s, %lu.%02lu B/sample, %s\n",
+                    (unsigned long)st.held, (unsigned long)(span / 3600u), (unsigned long)(span % 3600u / 360u),
+                    (unsigned long)(st.bytesHeld / 1024u), (unsigned long)(s_recorder.capacityBytes() / 1024u),
+                    s_psram ? " PSRAM" : "", (unsigned long)(bpsX100 / 100u), (unsigned long)(bpsX100 % 100u),
+                    s_recorder.frozen() ? "FROZEN" : (s_recorder.freezePending() ? "freezing" : "recording"));
+    LOG_CORE_PRINTF("OVEN", "INFO", "[FR] append in oven_comm_poll: avg %lu us, max %lu us over %lu samples\n",
+                    (unsigned long)(s_appendCalls ? s_appendUsSum / s_appendCalls : 0), (unsigned long)s_appendUsMax,
+                    (unsigned long)s_appendCalls);
+}
+
+bool flight_recorder_command(const char *line, size_t len) {
+    while (len > 0 && (line[len - 1] == ' ' || line[len - 1] == '\r')) {
+        len--;
+    }
+    if (len < 2 || memcmp(line, "fr", 2) != 0 || (len > 2 && line[2] != ' ')) {
+        return false;
+    }
+    const char *arg = line + 2;
+    size_t argLen = len - 2;
+    while (argLen > 0 && *arg == ' ') {
+        arg++;
+        argLen--;
+    }
+    auto is = [arg, argLen](const char *word) { return argLen == strlen(word) && memcmp(arg, word, argLen) == 0; };
+    if (argLen == 0) {
+        flight_recorder_print_stats();
+    } else if (is("dump") || is("dump udp")) {
+        if (!flight_recorder_dump_start(argLen == 4 ? FLIGHT_DUMP_SERIAL : FLIGHT_DUMP_UDP)) {
+            OVEN_WARN("[FR] dump not started (%s)\n", flight_recorder_dumping() ? "busy" : "off");
+        }
+    } else if (is("freeze")) {
+        flight_recorder_freeze("console");
+    } else if (is("resume")) {
+        flight_recorder_resume();
+    } else {
+        OVEN_WARN("[FR] usage: fr | fr dump [udp] | fr freeze | fr resume\n");
+    }
+    return true;
+}
@@ -7,13 +7,28 @@ namespace {
 
 static constexpr const char *kNvsNamespace = "host-params";
 static constexpr const char *kBlobKey = "cfg";
-static constexpr uint16_t kVersion = 2;
+static constexpr uint16_t kVersion = 3;
 
 typedef struct HostParametersBlob {
     uint16_t version;
     HostParameters params;
 } HostParametersBlob;
 
+// Version 2 had no heater tables; its settings are kept on upgrade.
+static constexpr uint16_t kVersionV2 = 2;
+
+typedef struct HostParametersV2 {
+    uint16_t shortcutPresetIds[HOST_PARAMETER_SHORTCUT_SLOT_COUNT];
+    HostHeaterProfileParameters heaterProfiles[HOST_PARAMETER_HEATER_PROFILE_COUNT];
+    uint8_t displayDimPercent;
+    uint8_t displayDimTimeoutMin;
+} HostParametersV2;
+
+typedef struct HostParametersBlobV2 {
+    uint16_t version;
+    HostParametersV2 params;
+} HostParametersBlobV2;
+
 static HostParameters s_cached_params = {};
 static bool s_initialized = false;
 
@@ -36,6 +51,60 @@ static bool validate_profile(const HostHeaterProfileParameters &profile) {
     return true;
 }
 
+static bool validate_pulse_ms(uint32_t ms) { return ms >= 1000 && ms <= 60000; }
+
+static bool validate_soak_ms(uint32_t ms) { return ms >= 5000 && ms <= 600000; }
+
+static bool validate_band_dC(int16_t dC) { return dC >= 0 && dC <= 500; }
+
+static bool validate_table(const HeaterPulseTable &table) {
+    if ((table.rules & ~HEATER_RULE_ALL) != 0) {
+        return false;
+    }
+    if (table.midTarget_dC < 300 || table.midTarget_dC > table.hotTarget_dC || table.hotTarget_dC > 1200) {
+        return false;
+    }
+    // The ladder must step down towards the target.
+    if (!validate_band_dC(table.bulkAbove_dC) || table.approachAbove_dC >= table.bulkAbove_dC ||
+        table.reheatAbove_dC >= table.approachAbove_dC || table.reheatAbove_dC < 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < HEATER_TIER_COUNT; ++i) {
+        if (!validate_pulse_ms(table.firstPulseMs[i]) || !validate_pulse_ms(table.holdPulseMs[i])) {
+            return false;
+        }
+    }
+    if (!validate_pulse_ms(table.bulkPulseMs) || !validate_pulse_ms(table.approachPulseMs)) {
+        return false;
+    }
+    if (!validate_soak_ms(table.firstSoakMs) || !validate_soak_ms(table.reheatSoakMs) ||
+        !validate_soak_ms(table.safetySoakMs)) {
+        return false;
+    }
+    if (!validate_band_dC(table.firstForceOffBefore_dC) || !validate_band_dC(table.forceOffBefore_dC) ||
+        !validate_band_dC(table.predictForceOffBefore_dC) || table.predictLeadGain_pct > 500 ||
+        !validate_band_dC(table.hotspotReheatBlockAbove_dC) || !validate_band_dC(table.hotspotForceOffAbove_dC)) {
+        return false;
+    }
+    if (table.fanMinSwitchMs > 60000 || table.fanFastAfterHeatMs > 600000) {
+        return false;
+    }
+    if (table.resumeSoakMinMs < 1000 || table.resumeSoakMinMs > table.resumeSoakMs ||
+        table.resumeSoakMinMs > table.resumeSoakHotMs || table.resumeSoakMs > 600000 ||
+        table.resumeSoakHotMs > 600000 || table.resumeLongOpenCutMs > table.resumeSoakMinMs) {
+        return false;
+    }
+    if (table.resumePulseShortMs <= table.resumePulseHotCutMs || table.resumePulseShortMs > table.resumePulseLongMs ||
+        !validate_pulse_ms(table.resumePulseShortMs) || !validate_pulse_ms(table.resumePulseLongMs)) {
+        return false;
+    }
+    if (table.resumeMediumError_dC < 0 || table.resumeMediumError_dC > table.resumeLongError_dC ||
+        !validate_band_dC(table.resumeLongError_dC)) {
+        return false;
+    }
+    return true;
+}
+
 static bool validate_params(const HostParameters &params) {
     for (uint8_t i = 0; i < HOST_PARAMETER_SHORTCUT_SLOT_COUNT; ++i) {
         if (params.shortcutPresetIds[i] >= kPresetCount) {
@@ -43,7 +112,7 @@ static bool validate_params(const HostParameters &params) {
         }
     }
     for (uint8_t i = 0; i < HOST_PARAMETER_HEATER_PROFILE_COUNT; ++i) {
-        if (!validate_profile(params.heaterProfiles[i])) {
+        if (!validate_profile(params.heaterProfiles[i]) || !validate_table(params.heaterTables[i])) {
             return false;
         }
     }
@@ -79,6 +148,7 @@ void host_parameters_get_defaults(HostParameters *out) {
     }
     for (uint8_t i = 0; i < HOST_PARAMETER_HEATER_PROFILE_COUNT; ++i) {
         out->heaterProfiles[i] = kDefaultProfiles[i];
+        out->heaterTables[i] = kHeaterPulseTables[i];
     }
     out->displayDimPercent = kDefaultDisplayDimPercent;
     out->displayDimTimeoutMin = kDefaultDisplayDimTimeoutMin;
@@ -96,7 +166,24 @@ void host_parameters_init(void) {
     }
 
     HostParametersBlob blob{};
-    const size_t read_size = prefs.getBytes(kBlobKey, &blob, sizeof(blob));
+    const size_t stored_size = prefs.getBytesLength(kBlobKey);
+    size_t read_size = 0;
+    if (stored_size == sizeof(HostParametersBlobV2)) {
+        HostParametersBlobV2 old{};
+        read_size = prefs.getBytes(kBlobKey, &old, sizeof(old));
+        if (read_size == sizeof(old) && old.version == kVersionV2) {
+            blob.version = kVersion;
+            blob.params = defaults;
+            std::memcpy(blob.params.shortcutPresetIds, old.params.shortcutPresetIds,
+                        sizeof(blob.params.shortcutPresetIds));
+            std::memcpy(blob.params.heaterProfiles, old.params.heaterProfiles, sizeof(blob.params.heaterProfiles));
+            blob.params.displayDimPercent = old.params.displayDimPercent;
+            blob.params.displayDimTimeoutMin = old.params.displayDimTimeoutMin;
+            read_size = sizeof(blob);
+        }
+    } else {
+        read_size = prefs.getBytes(kBlobKey, &blob, sizeof(blob));
+    }
     prefs.end();
 
     if (read_size == sizeof(blob) &&
@@ -8,7 +8,13 @@
 
 #include "log_core.h"
 #include "display/display_timeout_manager.h"
+#include "flight_recorder.h"
 #include "host_parameters.h"
+#include "line_assembler.h"
+#include "log_async.h"
+#include "run_history.h"
+#include "thermal_cache.h"
+#include "timer_wheel.h"
 #include "ui.h"
 #include "ui/screens/screen_dbg_hw.h"
 #include "ui/screens/screen_boot.h"
@@ -25,6 +31,8 @@
 #include "wifi_net.h"
 #include "wifi_secrets.h"
 
+#include <atomic>
+
 // The parameters screen increases LVGL redraw depth enough to exceed the
 // Arduino default loopTask stack on ESP32-S3 during screen transitions.
 SET_LOOP_TASK_STACK_SIZE(16 * 1024);
@@ -34,9 +42,24 @@ static uint32_t last_tick_ms = 0;
 static uint32_t g_boot_ui_last_ms = 0;
 static uint32_t g_boot_wifi_elapsed_ms = 0;
 static uint8_t g_boot_progress_percent = 0;
-static uint32_t g_display_timeout_arm_ms = 0;
-static bool g_display_timeout_pending_init = false;
 static constexpr uint32_t DISPLAY_TIMEOUT_INIT_DELAY_MS = 1000;
+
+// Main loop schedule: loop() runs the due timers and LVGL, then sleeps
+// until the next deadline of either, or until the RX task reports frames.
+static constexpr uint32_t LOOP_UI_UPDATE_MS = 250;
+static constexpr uint32_t LOOP_COMM_SERVICE_MS = 20; // RX task wakes the loop for frames
+static constexpr uint32_t LOOP_COMM_POLL_MS = 5;     // inline RX: poll the UART
+static constexpr uint32_t LOOP_STATS_MS = 10000;
+static constexpr uint32_t LOOP_CONSOLE_MS = 100; // console commands, flight recorder dump pacing
+static constexpr uint32_t LOOP_MAX_SLEEP_MS = 50;
+
+static TimerWheel g_loop_timers;
+static TaskHandle_t g_loop_task = nullptr;
+static std::atomic<bool> g_comm_rx_pending{false};
+static uint32_t g_loop_passes = 0;
+static uint32_t g_loop_rx_wakeups = 0;
+static TimerWheel::TimerId g_display_timeout_init_timer = TimerWheel::kInvalidTimer;
+static LineAssembler g_console_lines;
 // Host UART pins on ESP32-S3
 constexpr int HOST_RX_PIN = 2;  // IO02 = relay2
 constexpr int HOST_TX_PIN = 40; // IO40 = relay1
@@ -79,10 +102,133 @@ void udp_log_selftest() {
 }
 #endif
 
+// RX task context: frames are queued for oven_comm_poll().
+static void loop_wake_from_rx(void *ctx) {
+    LV_UNUSED(ctx);
+    g_comm_rx_pending.store(true, std::memory_order_release);
+    if (g_loop_task) {
+        xTaskNotifyGive(g_loop_task);
+    }
+}
+
+static void loop_comm_service(void *ctx) {
+    LV_UNUSED(ctx);
+    oven_comm_poll();
+    oven_tick(); // 1 Hz internal
+}
+
+static void loop_ui_update(void *ctx) {
+    LV_UNUSED(ctx);
+    OvenRuntimeState st;
+    oven_get_runtime_state(&st);
+
+    switch (screen_manager_current()) {
+    case SCREEN_MAIN:
+        screen_main_update_runtime(&st);
+        break;
+    case SCREEN_CONFIG:
+        // currently has screen_config it's own logic
+        break;
+    case SCREEN_DBG_HW:
+        screen_dbg_hw_update_runtime(&st);
+        break;
+    case SCREEN_PARAMETERS:
+        break;
+    case SCREEN_BOOT:
+        break;
+    default:
+        screen_main_update_runtime(&st);
+        break;
+    }
+
+    display_timeout_note_runtime_state(&st);
+    display_timeout_tick(millis());
+}
+
+// USB console: "fr ..." commands; one dump step per pass.
+static void loop_console(void *ctx) {
+    LV_UNUSED(ctx);
+    char buf[64];
+    int avail;
+    while ((avail = Serial.available()) > 0) {
+        const size_t n = Serial.readBytes(buf, avail < (int)sizeof(buf) ? (size_t)avail : sizeof(buf));
+        if (n == 0) {
+            break;
+        }
+        g_console_lines.feed(
+            buf, n,
+            [](const char *line, size_t len) {
+                if (!flight_recorder_command(line, len) && !run_history_command(line, len)) {
+                    WARN("[CONSOLE] unknown command\n");
+                }
+            },
+            []() {});
+    }
+    flight_recorder_dump_step();
+}
+
+// One-shot, re-armed while the boot screen is still up.
+static void loop_display_timeout_init(void *ctx) {
+    LV_UNUSED(ctx);
+    if (screen_manager_current() == SCREEN_BOOT) {
+        g_loop_timers.restart(g_display_timeout_init_timer, DISPLAY_TIMEOUT_INIT_DELAY_MS);
+        return;
+    }
+    OvenRuntimeState st{};
+    oven_get_runtime_state(&st);
+    display_timeout_init();
+    display_timeout_note_runtime_state(&st);
+}
+
+static void loop_report_stats(void *ctx) {
+    LV_UNUSED(ctx);
+    DBG("[LOOP] %lu passes, %lu RX wake-ups in %lu ms\n", (unsigned long)g_loop_passes,
+        (unsigned long)g_loop_rx_wakeups, (unsigned long)LOOP_STATS_MS);
+    for (TimerWheel::TimerId id = 0; id < TimerWheel::kMaxTimers; ++id) {
+        const TimerWheel::Stats *st = g_loop_timers.stats(id);
+        if (!st || st->calls == 0) {
+            continue;
+        }
+        DBG("[LOOP] %-8s calls=%lu late avg=%lu max=%lu ms missed=%lu\n", g_loop_timers.name(id),
+            (unsigned long)st->calls, (unsigned long)(st->lateSumMs / st->calls), (unsigned long)st->lateMaxMs,
+            (unsigned long)st->missed);
+    }
+#if LOG_ASYNC_ENABLE
+    const log_async::Stats ls = log_async::stats();
+    DBG("[LOG] lines=%lu dropped=%lu datagrams=%lu serial=%lu ring %lu/%lu B%s\n", (unsigned long)ls.lines,
+        (unsigned long)ls.dropped, (unsigned long)ls.datagrams, (unsigned long)ls.serialWrites,
+        (unsigned long)ls.ringHighWater, (unsigned long)ls.ringBytes, ls.psram ? " (PSRAM)" : "");
+#endif
+    g_loop_timers.resetStats();
+    g_loop_passes = 0;
+    g_loop_rx_wakeups = 0;
+}
+
+static void loop_timers_init() {
+    const uint32_t now = millis();
+    g_loop_timers.reset(now);
+
+    const uint32_t commMs = oven_comm_rx_event_driven() ? LOOP_COMM_SERVICE_MS : LOOP_COMM_POLL_MS;
+    g_loop_timers.startPeriodic("comm", commMs, loop_comm_service, nullptr, 0);
+    g_loop_timers.startPeriodic("ui", LOOP_UI_UPDATE_MS, loop_ui_update, nullptr, LOOP_UI_UPDATE_MS);
+    g_loop_timers.startPeriodic("stats", LOOP_STATS_MS, loop_report_stats, nullptr, LOOP_STATS_MS);
+    g_loop_timers.startPeriodic("console", LOOP_CONSOLE_MS, loop_console, nullptr, LOOP_CONSOLE_MS);
+    g_display_timeout_init_timer =
+        g_loop_timers.startOneShot("dim-init", DISPLAY_TIMEOUT_INIT_DELAY_MS, loop_display_timeout_init, nullptr);
+}
+
 void setup() {
     Serial.begin(115200);
+#if LOG_ASYNC_ENABLE
+    log_async::start(); // log calls only queue from here on
+#endif
+    g_loop_task = xTaskGetCurrentTaskHandle();
+    oven_comm_set_rx_wake(loop_wake_from_rx, nullptr);
     oven_comm_init(Serial2, 115200, HOST_RX_PIN, HOST_TX_PIN);
     host_parameters_init();
+    thermal_cache_init();
+    flight_recorder_init();
+    run_history_init(nullptr);
     oven_init();
     ui_init();
 
@@ -190,8 +336,7 @@ void setup() {
     screen_main_update_runtime(&initial_state);
     pump_boot_ui();
 
-    g_display_timeout_arm_ms = millis();
-    g_display_timeout_pending_init = true;
+    loop_timers_init();
 }
 
 extern "C" void app_boot_progress_wifi(uint32_t elapsed_ms, uint32_t timeout_ms) {
@@ -222,73 +367,33 @@ extern "C" void app_boot_progress_wifi(uint32_t elapsed_ms, uint32_t timeout_ms)
 }
 
 void loop() {
-    static uint32_t last_ui_update = 0;
-    static uint32_t last_ui_log = 0;
-
     // LVGL tick
     const uint32_t now = millis();
     const uint32_t elapsed = now - last_tick_ms;
     last_tick_ms = now;
     lv_tick_inc(elapsed);
+    g_loop_passes++;
 
-    if (g_display_timeout_pending_init &&
-        screen_manager_current() != SCREEN_BOOT &&
-        (now - g_display_timeout_arm_ms) >= DISPLAY_TIMEOUT_INIT_DELAY_MS) {
-        OvenRuntimeState st{};
-        oven_get_runtime_state(&st);
-        display_timeout_init();
-        display_timeout_note_runtime_state(&st);
-        g_display_timeout_pending_init = false;
+    // Frames from the RX task are consumed right away, not on the next
+    // comm period.
+    if (g_comm_rx_pending.exchange(false, std::memory_order_acq_rel)) {
+        g_loop_rx_wakeups++;
+        oven_comm_poll();
     }
 
-    // IMPORTANT: Poll UART / protocol frequently (non-blocking)
-    oven_comm_poll();
-
-    // Oven tick (1 Hz internal)
-    oven_tick();
+    g_loop_timers.advance(now);
 
-    // UI update (4 Hz)
-    if (now - last_ui_update >= 250) {
-
-        OvenRuntimeState st;
-        oven_get_runtime_state(&st);
-
-        // Debug log (1 Hz)
-        if (now - last_ui_log >= 1000) {
-            last_ui_log = now;
-            // DBG("[UI] remaining=%lus duration=%umin mode=%u postRem=%u\n",
-            //     (unsigned long)st.secondsRemaining,
-            //     (unsigned int)st.durationMinutes,
-            //     (unsigned)st.mode,
-            //     (unsigned)st.post.secondsRemaining);
-        }
-        last_ui_update = now;
-
-        switch (screen_manager_current()) {
-        case SCREEN_MAIN:
-            screen_main_update_runtime(&st);
-            break;
-        case SCREEN_CONFIG:
-            // currently has screen_config it's own logic
-            break;
-        case SCREEN_DBG_HW:
-            screen_dbg_hw_update_runtime(&st);
-            break;
-        case SCREEN_PARAMETERS:
-            break;
-        case SCREEN_BOOT:
-            break;
-        default:
-            screen_main_update_runtime(&st);
-            break;
-        }
+    // Rendering
+    const uint32_t lvglWaitMs = lv_timer_handler();
 
-        display_timeout_note_runtime_state(&st);
+    uint32_t sleepMs = g_loop_timers.msUntilNext(millis());
+    if (lvglWaitMs < sleepMs) {
+        sleepMs = lvglWaitMs;
+    }
+    if (sleepMs > LOOP_MAX_SLEEP_MS) {
+        sleepMs = LOOP_MAX_SLEEP_MS;
+    }
+    if (sleepMs > 0 && !g_comm_rx_pending.load(std::memory_order_acquire)) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs));
     }
-
-    display_timeout_tick(now);
-
-    // Rendering
-    lv_timer_handler();
-    delay(5);
 }
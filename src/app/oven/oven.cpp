@@ -28,13 +28,18 @@
  */
 
 #include "oven_utils.h" // includes "oven.h"
+#include "heater_mpc.h"
+#include "flight_recorder.h"
 #include "host_parameters.h"
+#include "run_history.h"
+#include "thermal_cache.h"
 // =============================================================================
 // Includes
 // =============================================================================
 
 #include <Arduino.h>
-#include "log_csv.h"
+#include "HostRxTask.h"
+#include "log_telemetry.h"
 
 static constexpr int16_t TEMP_INVALID_DC = -32768;
 
@@ -52,8 +57,65 @@ struct FanGateState {
     uint32_t lastSwitchMs = 0;
 };
 
+// Online plant identification for HeaterControlMode::MPC. Samples run in
+// every RUNNING phase so the model is ready when a profile switches to MPC.
+struct HeaterMpcState {
+    heater_mpc::HeaterModel model;
+    bool sampling = false;
+    uint32_t sampleStartMs = 0;
+    uint32_t lastTickMs = 0;
+    uint32_t heaterOnMs = 0;
+};
+
+// Pulse schedule of the current run, warm-started from the thermal cache
+// (thermal_cache.h). Inactive: the table values apply unchanged.
+struct HeaterWarmStart {
+    bool active = false;
+    float targetOffsetC = 0.0f;
+    uint32_t firstPulseMs = 0; // consumed by the first pulse of the run
+    uint32_t firstSoakMs = 0;
+    uint32_t bulkSoakMs = 0;
+    uint32_t holdSoakMs = 0;
+};
+
+// What the current run shows about the oven, folded into the thermal cache
+// when it ends.
+struct ThermalRunObserver {
+    bool active = false;
+    bool waited = false; // a WAIT freezes the observation
+    uint32_t startMs = 0;
+    uint32_t lastMs = 0;
+    float startChamberC = 0.0f;
+    uint32_t heaterOnMs = 0; // until reached
+    uint32_t firstHeatMs = 0;
+    float firstHeatChamberC = 0.0f;
+    uint32_t deadTimeMs = 0;
+    uint32_t reachedMs = 0;
+    float reachedChamberC = 0.0f;
+    uint32_t heatupHeaterOnMs = 0;
+    uint32_t holdMs = 0;
+    uint32_t holdHeaterOnMs = 0;
+    float peakC = 0.0f;
+    bool mpcInHold = false; // hold was not on the pulse tables, nothing to learn for them
+};
+
 static HeaterGateState g_heaterGate;
 static FanGateState g_fanGate;
+static HeaterMpcState g_mpc;
+static HeaterWarmStart g_warm;
+static ThermalRunObserver g_runObs;
+
+// Run history (run_history.h): what one run did, saved when it ends.
+struct RunHistoryTracker {
+    bool active = false;
+    RunSummary run = {};
+    uint32_t startMs = 0;
+    uint32_t lastMs = 0;
+    uint32_t reachedMs = 0;
+    uint32_t heaterOnMs = 0;
+    float peakC = 0.0f;
+};
+static RunHistoryTracker g_runHist;
 
 static void thermal_pulse_reset(HeaterGateState &tms) {
     tms.heatPhaseUntilMs = 0;
@@ -165,6 +227,7 @@ static HeaterPolicy g_lowTempHeaterPolicy = {
     HOST_TARGET_OVERSHOOT_CAP_C,
     HOST_CHAMBER_MAX_C,
     HOST_HOTSPOT_MAX_C,
+    HeaterControlMode::PULSE,
 };
 
 static HeaterPolicy g_midTempHeaterPolicy = {
@@ -175,6 +238,7 @@ static HeaterPolicy g_midTempHeaterPolicy = {
     HOST_TARGET_OVERSHOOT_CAP_C,
     HOST_CHAMBER_MAX_C,
     HOST_HOTSPOT_MAX_C,
+    HeaterControlMode::PULSE,
 };
 
 static HeaterPolicy g_highTempHeaterPolicy = {
@@ -185,6 +249,7 @@ static HeaterPolicy g_highTempHeaterPolicy = {
     HOST_TARGET_OVERSHOOT_CAP_C,
     HOST_CHAMBER_MAX_C,
     HOST_HOTSPOT_MAX_C,
+    HeaterControlMode::PULSE,
 };
 
 static HeaterPolicy g_silica100HeaterPolicy = {
@@ -195,6 +260,7 @@ static HeaterPolicy g_silica100HeaterPolicy = {
     HOST_SILICA_TARGET_OVERSHOOT_CAP_C,
     HOST_CHAMBER_MAX_C,
     HOST_HOTSPOT_MAX_C,
+    HeaterControlMode::PULSE,
 };
 
 // -------------------------------------------------------------------------
@@ -246,9 +312,12 @@ static OvenRuntimeState runtimeState = {
     .tempHotspotC = 25.0f,
     .tempChamberValid = false,
     .tempHotspotValid = false,
+    .sensorFaultMask = 0,
     .materialClass = HeaterMaterialClass::FILAMENT,
     .heaterCurveProfile = HeaterCurveProfileId::HIGH_80C,
     .heaterStage = HeaterControlStage::IDLE,
+    .heaterMpcActive = false,
+    .heaterWarmStart = false,
 
     .filamentId = kDefaultPresetIndex,
 
@@ -273,6 +342,7 @@ static OvenRuntimeState runtimeState = {
 
     .commAlive = false,
     .linkSynced = false,
+    .linkBaud = 0,
 
     .mode = OvenMode::STOPPED,
     .running = false,
@@ -319,6 +389,13 @@ static void sync_heater_policies_from_host_parameters() {
     g_silica100HeaterPolicy.approachBandC = params->heaterProfiles[3].approachBand_dC / 10.0f;
     g_silica100HeaterPolicy.holdBandC = params->heaterProfiles[3].holdBand_dC / 10.0f;
     g_silica100HeaterPolicy.targetOvershootCapC = params->heaterProfiles[3].overshootCap_dC / 10.0f;
+
+    HeaterPolicy *const policies[HOST_PARAMETER_HEATER_PROFILE_COUNT] = {
+        &g_lowTempHeaterPolicy, &g_midTempHeaterPolicy, &g_highTempHeaterPolicy, &g_silica100HeaterPolicy};
+    for (uint8_t i = 0; i < HOST_PARAMETER_HEATER_PROFILE_COUNT; ++i) {
+        policies[i]->controlMode = (params->heaterTables[i].rules & HEATER_RULE_MPC) ? HeaterControlMode::MPC
+                                                                                      : HeaterControlMode::PULSE;
+    }
 }
 
 float oven_get_effective_preset_target_c(uint16_t index) {
@@ -433,138 +510,136 @@ static bool determine_heater_intent_for_stage(HeaterControlStage stage,
     }
 }
 
-static bool silica_should_force_heater_off(float chamberC,
-                                           float targetC,
-                                           uint8_t pulseCount) {
-    const bool firstPulseActive = (pulseCount <= 1u);
-    const float forceOffBeforeTargetC =
-        firstPulseActive ? HOST_SILICA_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C
-                         : HOST_SILICA_FORCE_OFF_BEFORE_TARGET_C;
-    return chamberC >= (targetC - forceOffBeforeTargetC);
-}
-
-static bool filament_should_force_heater_off(HeaterControlStage stage,
-                                             float chamberC,
-                                             float hotspotC,
-                                             float targetC,
-                                             uint8_t pulseCount) {
-    if (hotspotC >= (targetC + HOST_FILAMENT_HOTSPOT_FORCE_OFF_ABOVE_TARGET_C)) {
+// -------------------------------------------------------------------------
+// Pulse/soak heater control, driven by the profile's HeaterPulseTable
+// (oven.h). The row comes from HostParameters so saved tunings apply
+// without a reflash.
+// -------------------------------------------------------------------------
+static const HeaterPulseTable &heater_table_for_profile(HeaterCurveProfileId profileId) {
+    uint8_t index = static_cast<uint8_t>(profileId);
+    if (index >= HOST_PARAMETER_HEATER_PROFILE_COUNT) {
+        index = static_cast<uint8_t>(HeaterCurveProfileId::LOW_45C);
+    }
+    const HostParameters *params = host_parameters_get_cached();
+    return params ? params->heaterTables[index] : kHeaterPulseTables[index];
+}
+
+static inline float heater_table_c(int16_t dC) { return dC / 10.0f; }
+
+static inline bool heater_table_has(const HeaterPulseTable &table, HeaterRule rule) {
+    return (table.rules & rule) != 0u;
+}
+
+static HeaterTargetTier heater_target_tier(const HeaterPulseTable &table, float targetC) {
+    if (targetC >= heater_table_c(table.hotTarget_dC)) {
+        return HEATER_TIER_HOT;
+    }
+    if (targetC >= heater_table_c(table.midTarget_dC)) {
+        return HEATER_TIER_MID;
+    }
+    return HEATER_TIER_WARM;
+}
+
+static bool heater_should_force_off(const HeaterPulseTable &table,
+                                    HeaterControlStage stage,
+                                    float chamberC,
+                                    float hotspotC,
+                                    float targetC,
+                                    uint8_t pulseCount) {
+    if (heater_table_has(table, HEATER_RULE_HOTSPOT_GUARD) &&
+        hotspotC >= (targetC + heater_table_c(table.hotspotForceOffAbove_dC))) {
         return true;
     }
 
     const bool firstPulseActive = (pulseCount <= 1u);
     const float directForceOffBeforeTargetC =
-        firstPulseActive ? HOST_FILAMENT_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C
-                         : HOST_FILAMENT_FORCE_OFF_BEFORE_TARGET_C;
+        heater_table_c(firstPulseActive ? table.firstForceOffBefore_dC : table.forceOffBefore_dC);
     if (chamberC >= (targetC - directForceOffBeforeTargetC)) {
         return true;
     }
 
-    const float hotspotLeadC = max(0.0f, hotspotC - chamberC);
-    const float predictedChamberC = chamberC + (hotspotLeadC * 1.5f);
-    const float predictiveForceOffBeforeTargetC =
-        firstPulseActive ? HOST_FILAMENT_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C : 0.5f;
-
-    if (predictedChamberC >= (targetC - predictiveForceOffBeforeTargetC)) {
-        return true;
+    if (heater_table_has(table, HEATER_RULE_PREDICT_OFF)) {
+        const float hotspotLeadC = max(0.0f, hotspotC - chamberC);
+        const float predictedChamberC =
+            chamberC + (hotspotLeadC * (table.predictLeadGain_pct / 100.0f));
+        const float predictiveForceOffBeforeTargetC = heater_table_c(
+            firstPulseActive ? table.firstForceOffBefore_dC : table.predictForceOffBefore_dC);
+        if (predictedChamberC >= (targetC - predictiveForceOffBeforeTargetC)) {
+            return true;
+        }
     }
 
-    if (stage == HeaterControlStage::HOLD && hotspotC >= targetC) {
+    if (heater_table_has(table, HEATER_RULE_HOLD_HOTSPOT_OFF) &&
+        stage == HeaterControlStage::HOLD && hotspotC >= targetC) {
         return true;
     }
 
     return false;
 }
 
-static bool is_high_temp_filament_profile(HeaterCurveProfileId profileId) {
-    return profileId == HeaterCurveProfileId::HIGH_80C;
-}
-
-static float filament_reheat_enable_below_target_c(HeaterCurveProfileId profileId) {
-    return is_high_temp_filament_profile(profileId)
-               ? HOST_FILAMENT_HIGH_REHEAT_ENABLE_BELOW_TARGET_C
-               : HOST_FILAMENT_REHEAT_ENABLE_BELOW_TARGET_C;
-}
-
-static uint32_t filament_hold_pulse_duration_ms(float targetC,
-                                                HeaterCurveProfileId profileId) {
-    if (targetC >= HOST_FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
-        return is_high_temp_filament_profile(profileId)
-                   ? HOST_FILAMENT_HOLD_PULSE_HIGH_MS
-                   : HOST_FILAMENT_HOLD_PULSE_MAX_MS;
-    }
-    if (targetC >= HOST_FILAMENT_MID_TARGET_C) {
-        return HOST_FILAMENT_HOLD_PULSE_MID_MS;
-    }
-    return HOST_FILAMENT_HOLD_PULSE_WARM_MS;
-}
-
-static uint32_t filament_pulse_duration_ms(float chamberC,
-                                           float targetC,
-                                           uint8_t pulseCount,
-                                           HeaterCurveProfileId profileId) {
-    if (g_heaterGate.nextPulseOverrideMs > 0) {
-        const uint32_t pulseMs = g_heaterGate.nextPulseOverrideMs;
-        g_heaterGate.nextPulseOverrideMs = 0;
-        return pulseMs;
-    }
-
+static uint32_t heater_pulse_duration_ms(const HeaterPulseTable &table,
+                                         float chamberC,
+                                         float targetC,
+                                         uint8_t pulseCount) {
+    const HeaterTargetTier tier = heater_target_tier(table, targetC);
     if (pulseCount == 0) {
-        if (targetC >= HOST_FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
-            return HOST_FILAMENT_FIRST_PULSE_MAX_MS;
-        }
-        if (targetC >= HOST_FILAMENT_MID_TARGET_C) {
-            return HOST_FILAMENT_FIRST_PULSE_MAX_MID_MS;
-        }
-        return HOST_FILAMENT_FIRST_PULSE_MAX_WARM_MS;
+        return table.firstPulseMs[tier];
     }
 
     const float errorToTargetC = targetC - chamberC;
-    if (errorToTargetC > HOST_FILAMENT_BULK_PULSE_ENABLE_BELOW_TARGET_C) {
-        return HOST_FILAMENT_BULK_PULSE_MAX_MS;
+    if (errorToTargetC > heater_table_c(table.bulkAbove_dC)) {
+        return table.bulkPulseMs;
     }
-    if (errorToTargetC > HOST_FILAMENT_APPROACH_PULSE_ENABLE_BELOW_TARGET_C) {
-        return HOST_FILAMENT_APPROACH_PULSE_MAX_MS;
+    if (errorToTargetC > heater_table_c(table.approachAbove_dC)) {
+        return table.approachPulseMs;
     }
-    if (errorToTargetC > filament_reheat_enable_below_target_c(profileId)) {
-        return filament_hold_pulse_duration_ms(targetC, profileId);
+    if (errorToTargetC > heater_table_c(table.reheatAbove_dC)) {
+        return table.holdPulseMs[tier];
     }
     return 0;
 }
 
-static uint32_t filament_soak_duration_ms(uint8_t pulseCount) {
-    return (pulseCount <= 1u) ? HOST_FILAMENT_FIRST_SOAK_MS
-                              : HOST_FILAMENT_REHEAT_SOAK_MS;
+static uint32_t heater_soak_duration_ms(const HeaterPulseTable &table, uint8_t pulseCount) {
+    return (pulseCount <= 1u) ? table.firstSoakMs : table.reheatSoakMs;
 }
 
-static uint32_t silica_pulse_duration_ms(float chamberC, float targetC, uint8_t pulseCount) {
-    const float errorToTargetC = targetC - chamberC;
-
-    if (pulseCount == 0) {
-        return HOST_SILICA_FIRST_PULSE_MAX_MS;
-    }
-    if (errorToTargetC > HOST_SILICA_BULK_PULSE_ENABLE_BELOW_TARGET_C) {
-        return HOST_SILICA_BULK_PULSE_MAX_MS;
-    }
-    if (errorToTargetC > HOST_SILICA_APPROACH_PULSE_ENABLE_BELOW_TARGET_C) {
-        return HOST_SILICA_APPROACH_PULSE_MAX_MS;
+static uint32_t heater_run_soak_ms(const HeaterPulseTable &table, HeaterControlStage stage, uint8_t pulseCount) {
+    if (!g_warm.active) {
+        return heater_soak_duration_ms(table, pulseCount);
     }
-    if (errorToTargetC > HOST_SILICA_REHEAT_ENABLE_BELOW_TARGET_C) {
-        return HOST_SILICA_HOLD_PULSE_MAX_MS;
+    if (pulseCount <= 1u) {
+        return g_warm.firstSoakMs;
     }
-    return 0;
+    return (stage == HeaterControlStage::HOLD) ? g_warm.holdSoakMs : g_warm.bulkSoakMs;
 }
 
-static uint32_t silica_soak_duration_ms(uint8_t pulseCount) {
-    return (pulseCount <= 1u) ? HOST_SILICA_FIRST_SOAK_MS
-                              : HOST_SILICA_REHEAT_SOAK_MS;
+// Soak after a pulse was forced off early.
+static uint32_t heater_force_off_soak_ms(const HeaterPulseTable &table, HeaterControlStage stage) {
+    if (!g_warm.active) {
+        return table.reheatSoakMs;
+    }
+    return (stage == HeaterControlStage::HOLD) ? g_warm.holdSoakMs : g_warm.bulkSoakMs;
 }
 
-static bool silica_reheat_allowed(float chamberC, float targetC) {
-    return chamberC < (targetC - HOST_SILICA_REHEAT_ENABLE_BELOW_TARGET_C);
+static bool heater_reheat_allowed(const HeaterPulseTable &table,
+                                  float chamberC,
+                                  float hotspotC,
+                                  float targetC) {
+    if (chamberC >= (targetC - heater_table_c(table.reheatAbove_dC))) {
+        return false;
+    }
+    if (heater_table_has(table, HEATER_RULE_HOTSPOT_GUARD) &&
+        hotspotC >= (targetC + heater_table_c(table.hotspotReheatBlockAbove_dC))) {
+        return false;
+    }
+    return true;
 }
 
-static bool determine_silica_heater_intent(float chamberC, float targetC) {
+static bool determine_pulse_heater_intent(const HeaterPulseTable &table,
+                                          HeaterControlStage stage,
+                                          float chamberC,
+                                          float hotspotC,
+                                          float targetC) {
     const uint32_t nowMs = millis();
 
     if (heater_gate_is_heating(g_heaterGate, nowMs)) {
@@ -572,20 +647,27 @@ static bool determine_silica_heater_intent(float chamberC, float targetC) {
     }
 
     if ((g_heaterGate.heatPhaseUntilMs > 0) && (nowMs >= g_heaterGate.heatPhaseUntilMs)) {
-        heater_gate_begin_rest(g_heaterGate, nowMs,
-                               silica_soak_duration_ms(g_heaterGate.pulseCount));
+        heater_gate_begin_rest(g_heaterGate, nowMs, heater_run_soak_ms(table, stage, g_heaterGate.pulseCount));
     }
 
     if (heater_gate_is_resting(g_heaterGate, nowMs)) {
         return false;
     }
 
-    if (!silica_reheat_allowed(chamberC, targetC)) {
+    if (!heater_reheat_allowed(table, chamberC, hotspotC, targetC)) {
         return false;
     }
 
-    const uint32_t pulseMs =
-        silica_pulse_duration_ms(chamberC, targetC, g_heaterGate.pulseCount);
+    // A WAIT resume sizes the first pulse after the door closed.
+    uint32_t pulseMs = g_heaterGate.nextPulseOverrideMs;
+    if (pulseMs > 0) {
+        g_heaterGate.nextPulseOverrideMs = 0;
+    } else if (g_warm.firstPulseMs > 0) {
+        pulseMs = g_warm.firstPulseMs;
+        g_warm.firstPulseMs = 0;
+    } else {
+        pulseMs = heater_pulse_duration_ms(table, chamberC, targetC, g_heaterGate.pulseCount);
+    }
     if (pulseMs == 0) {
         return false;
     }
@@ -594,50 +676,218 @@ static bool determine_silica_heater_intent(float chamberC, float targetC) {
     return true;
 }
 
-static bool filament_reheat_allowed(float chamberC,
-                                    float hotspotC,
-                                    float targetC,
-                                    HeaterCurveProfileId profileId) {
-    if (chamberC >= (targetC - filament_reheat_enable_below_target_c(profileId))) {
+// -------------------------------------------------------------------------
+// HeaterControlMode::MPC (heater_mpc.h)
+// -------------------------------------------------------------------------
+static void heater_mpc_reset(float hotspotC, float chamberC) {
+    g_mpc.model.reset(hotspotC, chamberC);
+    g_mpc.sampling = false;
+}
+
+// Accumulates the heater on-time of the running sample and feeds the model
+// once per heater_mpc::kSampleMs. Returns true when a sample was taken.
+static bool heater_mpc_sample(uint32_t nowMs, bool heaterOn, bool valid, float hotspotC, float chamberC) {
+    if (!valid) {
+        g_mpc.sampling = false;
+        return false;
+    }
+    if (!g_mpc.sampling) {
+        g_mpc.model.rebase(hotspotC, chamberC);
+        g_mpc.sampling = true;
+        g_mpc.sampleStartMs = nowMs;
+        g_mpc.lastTickMs = nowMs;
+        g_mpc.heaterOnMs = 0;
         return false;
     }
-    if (hotspotC >= (targetC + HOST_FILAMENT_HOTSPOT_REHEAT_BLOCK_ABOVE_TARGET_C)) {
+
+    if (heaterOn) {
+        g_mpc.heaterOnMs += nowMs - g_mpc.lastTickMs;
+    }
+    g_mpc.lastTickMs = nowMs;
+
+    const uint32_t elapsedMs = nowMs - g_mpc.sampleStartMs;
+    if (elapsedMs < heater_mpc::kSampleMs) {
         return false;
     }
+    const float duty = min(1.0f, static_cast<float>(g_mpc.heaterOnMs) / static_cast<float>(elapsedMs));
+    g_mpc.model.update(hotspotC, chamberC, duty);
+    g_mpc.sampleStartMs = nowMs;
+    g_mpc.heaterOnMs = 0;
     return true;
 }
 
-static bool determine_filament_heater_intent(float chamberC,
-                                             float hotspotC,
-                                             float targetC,
-                                             HeaterCurveProfileId profileId) {
+// Replans on every model sample: starts, extends or cuts the pulse the gate
+// is running. Between samples the gate keeps the last decision.
+static bool determine_mpc_heater_intent(const HeaterPulseTable &table,
+                                        const HeaterPolicy &policy,
+                                        float chamberC,
+                                        float hotspotC,
+                                        float targetC,
+                                        bool sampled) {
     const uint32_t nowMs = millis();
 
+    if (sampled) {
+        float hotspotLimitC = policy.hotspotMaxC;
+        if (heater_table_has(table, HEATER_RULE_HOTSPOT_GUARD)) {
+            hotspotLimitC = min(hotspotLimitC, targetC + heater_table_c(table.hotspotForceOffAbove_dC));
+        }
+        const heater_mpc::HeaterMpcLimits limits = {
+            min(targetC + HOST_MPC_AIM_ABOVE_TARGET_C, targetC + policy.targetOvershootCapC),
+            hotspotLimitC - HOST_MPC_HOTSPOT_MARGIN_C};
+        const heater_mpc::HeaterMpcPlan plan =
+            heater_mpc::HeaterMpc::plan(g_mpc.model, hotspotC, chamberC, limits, HOST_MPC_MAX_PULSE_MS, 1000);
+
+        if (heater_gate_is_heating(g_heaterGate, nowMs)) {
+            if (plan.pulseMs == 0) {
+                heater_gate_begin_rest(g_heaterGate, nowMs, HOST_MPC_MIN_SOAK_MS);
+            } else {
+                g_heaterGate.heatPhaseUntilMs = nowMs + plan.pulseMs;
+            }
+        } else if (!heater_gate_is_resting(g_heaterGate, nowMs) && plan.pulseMs >= HOST_MPC_MIN_PULSE_MS) {
+            heater_gate_begin_heat(g_heaterGate, nowMs, plan.pulseMs);
+        }
+    }
+
     if (heater_gate_is_heating(g_heaterGate, nowMs)) {
         return true;
     }
-
     if ((g_heaterGate.heatPhaseUntilMs > 0) && (nowMs >= g_heaterGate.heatPhaseUntilMs)) {
-        heater_gate_begin_rest(g_heaterGate, nowMs,
-                               filament_soak_duration_ms(g_heaterGate.pulseCount));
+        heater_gate_begin_rest(g_heaterGate, nowMs, HOST_MPC_MIN_SOAK_MS);
     }
+    return false;
+}
 
-    if (heater_gate_is_resting(g_heaterGate, nowMs)) {
-        return false;
+// -------------------------------------------------------------------------
+// Learned thermal cache (thermal_cache.h)
+// -------------------------------------------------------------------------
+static int16_t thermal_cache_target_dC(float targetC) { return static_cast<int16_t>(lroundf(targetC * 10.0f)); }
+
+static uint32_t clamp_ms(uint32_t ms, uint32_t lo, uint32_t hi) { return (ms < lo) ? lo : ((ms > hi) ? hi : ms); }
+
+static void heater_warm_start_reset() { g_warm = HeaterWarmStart(); }
+
+// Derives this run's pulse schedule from what earlier runs of the preset
+// showed. Every value stays within the table's own (or a fixed) bound.
+static void heater_warm_start_from_cache(const ThermalCacheEntry &e,
+                                         const HeaterPulseTable &table,
+                                         float chamberC,
+                                         float targetC) {
+    heater_warm_start_reset();
+    if (!heater_table_has(table, HEATER_RULE_PULSE_GATE)) {
+        return;
     }
+    const HeaterTargetTier tier = heater_target_tier(table, targetC);
+    g_warm.firstSoakMs = table.firstSoakMs;
+    g_warm.bulkSoakMs = table.reheatSoakMs;
+    g_warm.holdSoakMs = table.reheatSoakMs;
 
-    if (!filament_reheat_allowed(chamberC, hotspotC, targetC, profileId)) {
-        return false;
+    if ((e.fields & THERMAL_CACHE_HEATUP) && e.heatRate_mCps > 0) {
+        const float errorC = max(0.0f, targetC - chamberC);
+        const float riseC = errorC * (HOST_THERMAL_CACHE_FIRST_RISE_PCT / 100.0f);
+        const uint32_t pulseMs = static_cast<uint32_t>(riseC * 1000000.0f / e.heatRate_mCps);
+        g_warm.firstPulseMs =
+            clamp_ms(pulseMs, table.firstPulseMs[tier], max(table.firstPulseMs[tier], HOST_THERMAL_CACHE_MAX_PULSE_MS));
+
+        const uint32_t soakMs = e.deadTimeMs + HOST_THERMAL_CACHE_SOAK_MARGIN_MS;
+        g_warm.firstSoakMs = clamp_ms(soakMs, HOST_THERMAL_CACHE_MIN_SOAK_MS, table.firstSoakMs);
+        g_warm.bulkSoakMs = clamp_ms(soakMs, HOST_THERMAL_CACHE_MIN_SOAK_MS, table.reheatSoakMs);
     }
+    if ((e.fields & THERMAL_CACHE_HOLD) && e.holdDuty_pm > 0) {
+        // holdPulse / (holdPulse + soak) = learned hold duty
+        const uint32_t duty = min<uint32_t>(e.holdDuty_pm, 1000u);
+        const uint32_t soakMs = table.holdPulseMs[tier] * (1000u - duty) / duty;
+        g_warm.holdSoakMs = clamp_ms(soakMs, HOST_THERMAL_CACHE_MIN_SOAK_MS, table.reheatSoakMs);
 
-    const uint32_t pulseMs =
-        filament_pulse_duration_ms(chamberC, targetC, g_heaterGate.pulseCount, profileId);
-    if (pulseMs == 0) {
-        return false;
+        const float offsetC = -(e.overshoot_dC / 10.0f) - HOST_THERMAL_CACHE_OVERSHOOT_MARGIN_C;
+        g_warm.targetOffsetC = max(-HOST_THERMAL_CACHE_MAX_OFFSET_C, min(HOST_THERMAL_CACHE_MAX_OFFSET_C, offsetC));
     }
+    g_warm.active = true;
+}
 
-    heater_gate_begin_heat(g_heaterGate, nowMs, pulseMs);
-    return true;
+static void thermal_run_begin(uint32_t nowMs, float chamberC) {
+    g_runObs = ThermalRunObserver();
+    g_runObs.active = true;
+    g_runObs.startMs = nowMs;
+    g_runObs.lastMs = nowMs;
+    g_runObs.startChamberC = chamberC;
+    g_runObs.peakC = chamberC;
+}
+
+// Once per RUNNING poll; heaterWasOn is the output since the last call.
+static void thermal_run_observe(uint32_t nowMs, float chamberC, float targetC, bool heaterWasOn, bool heaterOn) {
+    if (!g_runObs.active || g_runObs.waited) {
+        return;
+    }
+    const uint32_t dtMs = nowMs - g_runObs.lastMs;
+    g_runObs.lastMs = nowMs;
+    const uint32_t onMs = heaterWasOn ? dtMs : 0u;
+
+    if (heaterOn && g_runObs.firstHeatMs == 0) {
+        g_runObs.firstHeatMs = nowMs;
+        g_runObs.firstHeatChamberC = chamberC;
+    }
+    if (g_runObs.firstHeatMs != 0 && g_runObs.deadTimeMs == 0 &&
+        chamberC >= g_runObs.firstHeatChamberC + HOST_THERMAL_CACHE_RESPONSE_C) {
+        g_runObs.deadTimeMs = nowMs - g_runObs.firstHeatMs;
+    }
+
+    if (g_runObs.reachedMs == 0) {
+        g_runObs.heaterOnMs += onMs;
+        if (chamberC >= targetC - HOST_THERMAL_CACHE_REACHED_C) {
+            g_runObs.reachedMs = nowMs;
+            g_runObs.reachedChamberC = chamberC;
+            g_runObs.heatupHeaterOnMs = g_runObs.heaterOnMs;
+            g_runObs.peakC = chamberC;
+        }
+        return;
+    }
+    g_runObs.holdMs += dtMs;
+    g_runObs.holdHeaterOnMs += onMs;
+    g_runObs.peakC = max(g_runObs.peakC, chamberC);
+    g_runObs.mpcInHold = g_runObs.mpcInHold || runtimeState.heaterMpcActive;
+}
+
+// Run ended (stop, POST or finished): fold what was seen into the cache.
+static void thermal_run_finish() {
+    if (!g_runObs.active) {
+        return;
+    }
+    g_runObs.active = false;
+
+    ThermalCacheEntry seen = {};
+    seen.heaterProfile = static_cast<uint8_t>(runtimeState.heaterCurveProfile);
+    seen.target_dC = thermal_cache_target_dC(runtimeState.tempTarget);
+
+    if (g_runObs.reachedMs != 0 && g_runObs.deadTimeMs != 0 && g_runObs.heatupHeaterOnMs > 0) {
+        const float riseC = g_runObs.reachedChamberC - g_runObs.startChamberC;
+        const float rate_mCps = riseC * 1000000.0f / g_runObs.heatupHeaterOnMs;
+        if (rate_mCps >= 1.0f && rate_mCps < 65535.0f) {
+            seen.fields |= THERMAL_CACHE_HEATUP;
+            seen.heatRate_mCps = static_cast<uint16_t>(rate_mCps);
+            seen.deadTimeMs = g_runObs.deadTimeMs;
+            const uint32_t reachS = (g_runObs.reachedMs - g_runObs.startMs) / 1000u;
+            seen.timeToReachS = static_cast<uint16_t>(min<uint32_t>(reachS, 0xFFFFu));
+        }
+    }
+    if (g_runObs.holdMs >= HOST_THERMAL_CACHE_MIN_HOLD_MS && !g_runObs.mpcInHold) {
+        seen.fields |= THERMAL_CACHE_HOLD;
+        const uint64_t dutyPm = (static_cast<uint64_t>(g_runObs.holdHeaterOnMs) * 1000u) / g_runObs.holdMs;
+        seen.holdDuty_pm = static_cast<uint16_t>(dutyPm);
+        const float overshootC = g_runObs.peakC - (runtimeState.tempTarget + g_warm.targetOffsetC);
+        seen.overshoot_dC = static_cast<int16_t>(lroundf(overshootC * 10.0f));
+    }
+    if (seen.fields == 0) {
+        return;
+    }
+
+    if (!thermal_cache_record(static_cast<uint16_t>(runtimeState.filamentId), seen)) {
+        OVEN_WARN("[thermal_cache] preset %d: not saved\n", runtimeState.filamentId);
+        return;
+    }
+    OVEN_INFO("[thermal_cache] preset %d: rate %u m°C/s, dead time %lu ms, reached after %u s, duty %u pm, "
+              "overshoot %d dC\n",
+              runtimeState.filamentId, (unsigned)seen.heatRate_mCps, (unsigned long)seen.deadTimeMs,
+              (unsigned)seen.timeToReachS, (unsigned)seen.holdDuty_pm, (int)seen.overshoot_dC);
 }
 
 // =============================================================================
@@ -650,6 +900,8 @@ static bool determine_filament_heater_intent(float chamberC,
 static HostComm *g_hostComm = nullptr;
 static bool g_hasRealTelemetry = false;
 static uint32_t g_lastStatusRequestMs = 0;
+static void (*g_rxWake)(void *ctx) = nullptr;
+static void *g_rxWakeCtx = nullptr;
 
 // =============================================================================
 // Bitmask helpers
@@ -665,13 +917,13 @@ static inline uint16_t mask_set(uint16_t mask, OVEN_CONNECTOR c, bool on) {
     return static_cast<uint16_t>(mask & ~connector_u16(c));
 }
 
-static void apply_filament_running_fan_policy(uint16_t &cmd, bool heaterEffective) {
+static void apply_running_fan_policy(const HeaterPulseTable &table, uint16_t &cmd, bool heaterEffective) {
     const uint32_t nowMs = millis();
     const bool shouldUseFastFan =
         !heaterEffective && (nowMs < g_fanGate.forceFastUntilMs);
 
     if (shouldUseFastFan != g_fanGate.fastFanActive &&
-        ((nowMs - g_fanGate.lastSwitchMs) >= HOST_FILAMENT_FAN_MIN_SWITCH_MS)) {
+        ((nowMs - g_fanGate.lastSwitchMs) >= table.fanMinSwitchMs)) {
         g_fanGate.fastFanActive = shouldUseFastFan;
         g_fanGate.lastSwitchMs = nowMs;
     }
@@ -681,42 +933,44 @@ static void apply_filament_running_fan_policy(uint16_t &cmd, bool heaterEffectiv
     cmd = mask_set(cmd, OVEN_CONNECTOR::FAN230V_SLOW, !g_fanGate.fastFanActive);
 }
 
-static uint32_t filament_resume_soak_ms(float chamberC, float targetC, uint32_t waitOpenMs) {
-    uint32_t soakMs = HOST_FILAMENT_WAIT_RESUME_SOAK_MS;
+static uint32_t heater_resume_soak_ms(const HeaterPulseTable &table,
+                                      float chamberC,
+                                      float targetC,
+                                      uint32_t waitOpenMs) {
+    uint32_t soakMs = table.resumeSoakMs;
 
-    if (targetC >= HOST_FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
-        soakMs = HOST_FILAMENT_WAIT_RESUME_SOAK_HOT_TARGET_MS;
+    if (heater_target_tier(table, targetC) == HEATER_TIER_HOT) {
+        soakMs = table.resumeSoakHotMs;
     }
 
     const float errorToTargetC = max(0.0f, targetC - chamberC);
-    if (errorToTargetC >= HOST_FILAMENT_WAIT_RESUME_LONG_PULSE_ERROR_C) {
-        soakMs = min(soakMs, static_cast<uint32_t>(7000));
-    } else if (errorToTargetC >= HOST_FILAMENT_WAIT_RESUME_MEDIUM_PULSE_ERROR_C) {
-        soakMs = min(soakMs, static_cast<uint32_t>(9000));
+    if (errorToTargetC >= heater_table_c(table.resumeLongError_dC)) {
+        soakMs = min(soakMs, table.resumeSoakLongErrorMs);
+    } else if (errorToTargetC >= heater_table_c(table.resumeMediumError_dC)) {
+        soakMs = min(soakMs, table.resumeSoakMediumErrorMs);
     }
 
-    if (waitOpenMs >= HOST_FILAMENT_WAIT_RESUME_LONG_OPEN_MS) {
-        soakMs = max(HOST_FILAMENT_WAIT_RESUME_SOAK_MIN_MS, soakMs - 2000u);
+    if (waitOpenMs >= table.resumeLongOpenMs) {
+        const uint32_t cutMs = min(soakMs, table.resumeLongOpenCutMs);
+        soakMs = max(table.resumeSoakMinMs, soakMs - cutMs);
     }
 
-    return max(HOST_FILAMENT_WAIT_RESUME_SOAK_MIN_MS, soakMs);
+    return max(table.resumeSoakMinMs, soakMs);
 }
 
-static uint32_t filament_resume_pulse_ms(float chamberC, float targetC) {
+static uint32_t heater_resume_pulse_ms(const HeaterPulseTable &table, float chamberC, float targetC) {
     const float errorToTargetC = max(0.0f, targetC - chamberC);
-    uint32_t pulseMs = HOST_FILAMENT_WAIT_RESUME_PULSE_SHORT_MS;
+    uint32_t pulseMs = table.resumePulseShortMs;
 
-    if (errorToTargetC >= HOST_FILAMENT_WAIT_RESUME_LONG_PULSE_ERROR_C) {
-        pulseMs = HOST_FILAMENT_WAIT_RESUME_PULSE_LONG_MS;
-    } else if (errorToTargetC >= HOST_FILAMENT_WAIT_RESUME_MEDIUM_PULSE_ERROR_C) {
-        pulseMs = (HOST_FILAMENT_WAIT_RESUME_PULSE_SHORT_MS +
-                   HOST_FILAMENT_WAIT_RESUME_PULSE_LONG_MS) /
-                  2u;
+    if (errorToTargetC >= heater_table_c(table.resumeLongError_dC)) {
+        pulseMs = table.resumePulseLongMs;
+    } else if (errorToTargetC >= heater_table_c(table.resumeMediumError_dC)) {
+        pulseMs = (table.resumePulseShortMs + table.resumePulseLongMs) / 2u;
     }
 
-    if (targetC >= HOST_FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
-        const uint32_t minPulseMs = HOST_FILAMENT_WAIT_RESUME_PULSE_SHORT_MS - 1000u;
-        pulseMs = (pulseMs > 1000u) ? (pulseMs - 1000u) : minPulseMs;
+    if (heater_target_tier(table, targetC) == HEATER_TIER_HOT) {
+        const uint32_t minPulseMs = table.resumePulseShortMs - table.resumePulseHotCutMs;
+        pulseMs = (pulseMs > table.resumePulseHotCutMs) ? (pulseMs - table.resumePulseHotCutMs) : minPulseMs;
         if (pulseMs < minPulseMs) {
             pulseMs = minPulseMs;
         }
@@ -750,7 +1004,13 @@ static inline void comm_send_mask(uint16_t newMask) {
 
     g_lastCommandMask = newMask;
     g_heaterIntentOn = mask_has(newMask, OVEN_CONNECTOR::HEATER);
-    g_hostComm->setOutputsMask(newMask);
+    if (kCommActuateAndReport) {
+        // ACK + STATUS in one reply; the next poll is due a full interval later.
+        g_hostComm->setOutputsMaskAndReport(newMask);
+        g_lastStatusRequestMs = millis();
+    } else {
+        g_hostComm->setOutputsMask(newMask);
+    }
 
     // Optimistic host-side command view. Remote truth still comes from STATUS/ACK.
     runtimeState.fan12v_on = mask_has(newMask, OVEN_CONNECTOR::FAN12V);
@@ -770,11 +1030,86 @@ static inline void comm_send_mask_if_changed(uint16_t newMask) {
     comm_send_mask(normalizedMask);
 }
 
+// -----------------------------------------------------------------------------
+// Run history
+// -----------------------------------------------------------------------------
+// A hard safety limit while running: sensor fault, hotspot or chamber
+// maximum. The open door and the overshoot cap are normal control.
+static bool host_hard_safety_fault(const OvenRuntimeState &state) {
+    const HeaterPolicy &policy = heater_policy_for_profile(state.heaterCurveProfile);
+    return state.mode == OvenMode::RUNNING && (state.sensorFaultMask != 0 || state.tempHotspotC >= policy.hotspotMaxC ||
+                                               state.tempChamberC >= policy.chamberMaxC);
+}
+
+static void history_run_begin(uint32_t nowMs) {
+    g_runHist = RunHistoryTracker();
+    g_runHist.active = true;
+    g_runHist.startMs = nowMs;
+    g_runHist.lastMs = nowMs;
+
+    RunSummary &r = g_runHist.run;
+    r.start_s = run_history_now_s();
+    r.timeToTarget_s = RUN_HISTORY_NOT_REACHED;
+    r.target_dC = static_cast<int16_t>(lroundf(runtimeState.tempTarget * 10.0f));
+    r.preset = static_cast<uint8_t>(runtimeState.filamentId);
+    r.profile = static_cast<uint8_t>(runtimeState.heaterCurveProfile);
+    r.flags = runtimeState.heaterWarmStart ? RUN_FLAG_WARM_START : 0;
+    run_history_begin(r);
+}
+
+// Once per RUNNING poll, next to thermal_run_observe().
+static void history_run_observe(uint32_t nowMs, float chamberC, float targetC, bool heaterWasOn) {
+    if (!g_runHist.active) {
+        return;
+    }
+    if (heaterWasOn) {
+        g_runHist.heaterOnMs += nowMs - g_runHist.lastMs;
+    }
+    g_runHist.lastMs = nowMs;
+    if (g_runHist.reachedMs == 0 && chamberC >= targetC - HOST_THERMAL_CACHE_REACHED_C) {
+        g_runHist.reachedMs = nowMs;
+        g_runHist.peakC = chamberC;
+    } else if (g_runHist.reachedMs != 0) {
+        g_runHist.peakC = max(g_runHist.peakC, chamberC);
+    }
+    if (host_hard_safety_fault(runtimeState)) {
+        g_runHist.run.flags |= RUN_FLAG_SAFETY;
+    }
+    if (runtimeState.heaterMpcActive) {
+        g_runHist.run.flags |= RUN_FLAG_MPC;
+    }
+}
+
+static void history_run_end(RunEndReason reason) {
+    if (!g_runHist.active) {
+        return;
+    }
+    g_runHist.active = false;
+    const uint32_t now = millis();
+
+    RunSummary &r = g_runHist.run;
+    r.reason = reason;
+    r.duration_s = (now - g_runHist.startMs) / 1000u;
+    if (g_runHist.reachedMs != 0) {
+        r.timeToTarget_s = (g_runHist.reachedMs - g_runHist.startMs) / 1000u;
+        r.overshoot_dC = static_cast<int16_t>(lroundf((g_runHist.peakC - runtimeState.tempTarget) * 10.0f));
+    }
+    const uint32_t wh = static_cast<uint32_t>((static_cast<uint64_t>(g_runHist.heaterOnMs) * HOST_HEATER_POWER_W) /
+                                              3600000u);
+    r.energy_Wh = static_cast<uint16_t>(wh > 0xFFFFu ? 0xFFFFu : wh);
+    run_history_end(r);
+}
+
 static bool host_heater_safety_cutoff_active(const OvenRuntimeState &state) {
     const HeaterPolicy &policy = heater_policy_for_profile(state.heaterCurveProfile);
     if (state.door_open) {
         return true;
     }
+    // A failed or implausible sensor would leave the temperatures below
+    // frozen at their last valid value.
+    if (state.sensorFaultMask != 0) {
+        return true;
+    }
     if (state.tempHotspotC >= policy.hotspotMaxC) {
         return true;
     }
@@ -803,11 +1138,15 @@ static int32_t c_to_dC(float tempC) {
     return static_cast<int32_t>(tempC * 10.0f);
 }
 
-static void emit_csv_host_runtime_once_per_second(const OvenRuntimeState &state) {
+// HOST_PLOT + HOST_LOGIC records (log_telemetry.h), once per second or at
+// the fast telemetry rate while a run heats up.
+static void emit_host_telemetry(const OvenRuntimeState &state) {
     static uint32_t lastMs = 0;
     const uint32_t now = millis();
 
-    if ((now - lastMs) < 1000u) {
+    const bool heatingUp = state.running && (state.heaterStage == HeaterControlStage::BULK_HEAT ||
+                                             state.heaterStage == HeaterControlStage::APPROACH);
+    if ((now - lastMs) < telemetry::samplePeriodMs(heatingUp)) {
         return;
     }
     lastMs = now;
@@ -815,25 +1154,63 @@ static void emit_csv_host_runtime_once_per_second(const OvenRuntimeState &state)
     const float lowC = state.tempTarget - state.tempToleranceC;
     const float highC = state.tempTarget + state.tempToleranceC;
 
-    CSV_LOG_HOST_TEMP(
-        (long)c_to_dC(state.tempChamberC),
-        (long)c_to_dC(state.tempHotspotC),
-        (long)c_to_dC(state.tempTarget),
-        (long)c_to_dC(lowC),
-        (long)c_to_dC(highC),
-        state.safetyCutoffActive ? 1 : 0);
-
-    CSV_LOG_HOST_LOGIC(
-        (unsigned)oven_mode_to_u8(state.mode),
-        state.running ? 1 : 0,
-        state.heater_request_on ? 1 : 0,
-        state.heater_actual_on ? 1 : 0,
-        state.door_open ? 1 : 0,
-        state.safetyCutoffActive ? 1 : 0,
-        state.commAlive ? 1 : 0,
-        state.linkSynced ? 1 : 0,
-        (unsigned)heater_material_class_to_u8(state.materialClass),
-        (unsigned)heater_stage_to_u8(state.heaterStage));
+    telemetry::HostTemp temp{};
+    temp.chamber_dC = static_cast<int16_t>(c_to_dC(state.tempChamberC));
+    temp.hotspot_dC = static_cast<int16_t>(c_to_dC(state.tempHotspotC));
+    temp.target_dC = static_cast<int16_t>(c_to_dC(state.tempTarget));
+    temp.low_dC = static_cast<int16_t>(c_to_dC(lowC));
+    temp.high_dC = static_cast<int16_t>(c_to_dC(highC));
+    temp.safety = state.safetyCutoffActive ? 1 : 0;
+    TELEMETRY_LOG(temp);
+
+    telemetry::HostLogic logic{};
+    logic.mode = oven_mode_to_u8(state.mode);
+    logic.running = state.running ? 1 : 0;
+    logic.heaterReq = state.heater_request_on ? 1 : 0;
+    logic.heaterActual = state.heater_actual_on ? 1 : 0;
+    logic.door = state.door_open ? 1 : 0;
+    logic.safety = state.safetyCutoffActive ? 1 : 0;
+    logic.commAlive = state.commAlive ? 1 : 0;
+    logic.linkSynced = state.linkSynced ? 1 : 0;
+    logic.materialClass = heater_material_class_to_u8(state.materialClass);
+    logic.heaterStage = heater_stage_to_u8(state.heaterStage);
+    TELEMETRY_LOG(logic);
+}
+
+// Flight recorder: one sample per second, whether or not a PC listens. A
+// hard safety limit (sensor fault, hotspot or chamber maximum) freezes the
+// ring FLIGHT_REC_POST_TRIGGER_S seconds later; the open door and the
+// overshoot cap are normal control and do not.
+static void record_flight_sample(const OvenRuntimeState &state) {
+    static bool prevFault = false;
+    static uint32_t lastMs = 0;
+    const uint32_t now = millis();
+
+    const bool fault = host_hard_safety_fault(state);
+    if (fault && !prevFault) {
+        flight_recorder_freeze(state.sensorFaultMask ? "sensor fault" : "overtemperature");
+    }
+    prevFault = fault;
+
+    if ((now - lastMs) < 1000u) {
+        return;
+    }
+    lastMs = now;
+
+    flight_rec::FlightSample s{};
+    s.t_s = now / 1000u;
+    s.chamber_dC = static_cast<int16_t>(c_to_dC(state.tempChamberC));
+    s.hotspot_dC = static_cast<int16_t>(c_to_dC(state.tempHotspotC));
+    s.target_dC = static_cast<int16_t>(c_to_dC(state.tempTarget));
+    s.flags = static_cast<uint8_t>((state.heater_request_on ? flight_rec::kFlagHeaterReq : 0) |
+                                   (state.heater_actual_on ? flight_rec::kFlagHeaterActual : 0) |
+                                   (state.door_open ? flight_rec::kFlagDoorOpen : 0) |
+                                   (state.safetyCutoffActive ? flight_rec::kFlagSafety : 0) |
+                                   (state.running ? flight_rec::kFlagRunning : 0) |
+                                   (state.commAlive ? flight_rec::kFlagCommAlive : 0));
+    s.stage = heater_stage_to_u8(state.heaterStage);
+    s.mode = oven_mode_to_u8(state.mode);
+    flight_recorder_append(s);
 }
 
 // =============================================================================
@@ -854,6 +1231,11 @@ static void apply_remote_status_to_runtime(const ProtocolStatus &st) {
                                     : runtimeState.tempHotspotC;
     runtime_sync_legacy_temperature_aliases();
 
+    if (st.sensorFaults != runtimeState.sensorFaultMask) {
+        OVEN_WARN("[SENSOR] client fault mask 0x%04X -> 0x%04X\n", runtimeState.sensorFaultMask, st.sensorFaults);
+        runtimeState.sensorFaultMask = st.sensorFaults;
+    }
+
     runtimeState.fan12v_on = mask_has(st.outputsMask, OVEN_CONNECTOR::FAN12V);
     runtimeState.fan230_on = mask_has(st.outputsMask, OVEN_CONNECTOR::FAN230V);
     runtimeState.fan230_slow_on = mask_has(st.outputsMask, OVEN_CONNECTOR::FAN230V_SLOW);
@@ -873,6 +1255,10 @@ static void apply_remote_status_to_runtime(const ProtocolStatus &st) {
 static void force_local_safe_stop_due_to_comm(const char *reason) {
     (void)reason;
 
+    // An aborted run says nothing reliable about the oven.
+    g_runObs.active = false;
+    history_run_end(RUN_END_COMM_LOST);
+
     runtimeState.mode = OvenMode::STOPPED;
     runtimeState.running = false;
     waiting = false;
@@ -945,12 +1331,30 @@ void oven_start(void) {
     // come from the normal control path after current telemetry is evaluated.
     thermal_pulse_reset(g_heaterGate);
     fan_gate_reset(g_fanGate);
+    heater_mpc_reset(runtimeState.tempHotspotC, runtimeState.tempChamberC);
     g_heaterIntentOn = false;
     g_heaterEffectiveOn = false;
     runtimeState.heater_request_on = false;
     runtimeState.heater_actual_on = false;
     runtime_sync_heater_alias();
 
+    // Warm start from earlier runs of this preset, if any.
+    const ThermalCacheEntry *learned =
+        thermal_cache_get(static_cast<uint16_t>(currentProfile.filamentId), runtimeState.heaterCurveProfile,
+                          thermal_cache_target_dC(runtimeState.tempTarget));
+    if (learned && runtimeState.tempChamberValid) {
+        heater_warm_start_from_cache(*learned, heater_table_for_profile(runtimeState.heaterCurveProfile),
+                                     runtimeState.tempChamberC, runtimeState.tempTarget);
+        OVEN_INFO("[oven_start] warm start (%u runs): first pulse %lu ms, soak %lu/%lu/%lu ms, offset %.1f C\n",
+                  (unsigned)learned->runs, (unsigned long)g_warm.firstPulseMs, (unsigned long)g_warm.firstSoakMs,
+                  (unsigned long)g_warm.bulkSoakMs, (unsigned long)g_warm.holdSoakMs, g_warm.targetOffsetC);
+    } else {
+        heater_warm_start_reset();
+    }
+    runtimeState.heaterWarmStart = g_warm.active;
+    thermal_run_begin(millis(), runtimeState.tempChamberC);
+    history_run_begin(millis());
+
     uint16_t m = g_remoteOutputsMask;
     m = mask_set(m, OVEN_CONNECTOR::HEATER, false);
     m = mask_set(m, OVEN_CONNECTOR::FAN12V, true);
@@ -966,6 +1370,11 @@ void oven_stop(void) {
         return;
     }
 
+    thermal_run_finish();
+    history_run_end(RUN_END_USER_STOP); // a finished run was saved on its way here
+    heater_warm_start_reset();
+    runtimeState.heaterWarmStart = false;
+
     runtimeState.mode = OvenMode::STOPPED;
     runtimeState.running = false;
     runtimeState.heaterStage = HeaterControlStage::IDLE;
@@ -978,6 +1387,7 @@ void oven_stop(void) {
     // Reset pulse scheduler on stop
     thermal_pulse_reset(g_heaterGate);
     fan_gate_reset(g_fanGate);
+    heater_mpc_reset(runtimeState.tempHotspotC, runtimeState.tempChamberC);
     g_heaterIntentOn = false;
     g_heaterEffectiveOn = false;
     runtimeState.heater_request_on = false;
@@ -1074,6 +1484,8 @@ void oven_tick(void) {
                 runtimeState.secondsRemaining--;
             } else {
                 if (g_currentPostPlan.active && g_currentPostPlan.seconds > 0) {
+    thermal_run_finish();
+    history_run_end(RUN_END_COMPLETED);
     runtimeState.mode = OvenMode::POST;
     thermal_pulse_reset(g_heaterGate);
     fan_gate_reset(g_fanGate);
@@ -1109,6 +1521,7 @@ void oven_tick(void) {
                               (unsigned)runtimeState.post.secondsRemaining);
                 } else {
                     OVEN_INFO("[oven_tick] RUN finished -> STOP (no POST)\n");
+                    history_run_end(RUN_END_COMPLETED);
 
                     oven_stop();
                 }
@@ -1209,6 +1622,8 @@ void oven_pause_wait(void) {
     runtimeState.mode = OvenMode::WAITING;
     runtimeState.running = false;
     g_waitStartedMs = millis();
+    g_runObs.waited = true;
+    g_runHist.run.flags |= RUN_FLAG_DOOR;
 
     // Reset pulse scheduler while waiting (heater must be off anyway)
     thermal_pulse_reset(g_heaterGate);
@@ -1266,16 +1681,19 @@ bool oven_resume_from_wait(void) {
     // Filament resume after a door-open WAIT must not behave like a cold start.
     // Recovery is based on current chamber error, door-open time and target band
     // so hotter presets can resume slightly faster than low-temp filament runs.
-    if (runtimeState.materialClass == HeaterMaterialClass::FILAMENT) {
+    const HeaterPulseTable &table = heater_table_for_profile(runtimeState.heaterCurveProfile);
+    if (heater_table_has(table, HEATER_RULE_WAIT_RESUME)) {
         thermal_pulse_reset(g_heaterGate);
         g_heaterGate.pulseCount = 1;
         g_heaterGate.restUntilMs =
-            now + filament_resume_soak_ms(runtimeState.tempChamberC,
-                                          runtimeState.tempTarget,
-                                          waitOpenMs);
+            now + heater_resume_soak_ms(table,
+                                        runtimeState.tempChamberC,
+                                        runtimeState.tempTarget,
+                                        waitOpenMs);
         g_heaterGate.nextPulseOverrideMs =
-            filament_resume_pulse_ms(runtimeState.tempChamberC,
-                                     runtimeState.tempTarget);
+            heater_resume_pulse_ms(table,
+                                   runtimeState.tempChamberC,
+                                   runtimeState.tempTarget);
         runtimeState.heaterStage = HeaterControlStage::APPROACH;
     } else {
         // Silica keeps the simpler resume behavior for now.
@@ -1352,6 +1770,20 @@ void oven_comm_init(HardwareSerial &serial, uint32_t baudrate, uint8_t rx, uint8
     g_hostComm = &comm;
 
     g_hostComm->begin(baudrate, rx, tx);
+    g_hostComm->setBinaryModeEnabled(kCommBinaryModeEnabled);
+    g_hostComm->setCommandWindow(kCommCommandWindow);
+    g_hostComm->setStatusSubscription(kStatusPushPeriodMs, SubTriggerDoor | SubTriggerOutputs | SubTriggerSensorFault);
+    g_hostComm->setLinkBaudTarget(kCommLinkBaudTarget);
+
+    if (kCommRxTaskEnabled) {
+        static HostRxTask rxTask(serial);
+        rxTask.setWakeCallback(g_rxWake, g_rxWakeCtx);
+        if (rxTask.start()) {
+            g_hostComm->setRxTask(&rxTask);
+        } else {
+            OVEN_WARN("[oven_comm_init] RX task not started, using inline RX\n");
+        }
+    }
 
     g_hasRealTelemetry = false;
     g_lastStatusRequestMs = 0;
@@ -1364,11 +1796,20 @@ void oven_comm_init(HardwareSerial &serial, uint32_t baudrate, uint8_t rx, uint8
     g_lastPingMs = 0;
 }
 
+void oven_comm_set_rx_wake(void (*wake)(void *ctx), void *ctx) {
+    g_rxWake = wake;
+    g_rxWakeCtx = ctx;
+}
+
+bool oven_comm_rx_event_driven(void) {
+    return g_hostComm && g_hostComm->rxTask() && g_hostComm->rxTask()->running() && g_rxWake;
+}
+
 // =============================================================================
 // oven_comm_poll(): fast non-blocking comm loop (called frequently)
 // - UART RX processing
 // - Link sync & alive tracking
-// - STATUS polling
+// - STATUS push subscription / polling fallback
 // - Applies telemetry to runtime state
 // - Applies heater policy while RUNNING
 // =============================================================================
@@ -1386,6 +1827,7 @@ void oven_comm_poll(void) {
 
     // 2) Mirror comm diagnostics into runtime
     runtimeState.linkSynced = g_hostComm->linkSynced();
+    runtimeState.linkBaud = g_hostComm->linkBaud();
 
     const uint32_t lastRxAny = g_hostComm->lastRxAnyMs();
     const uint32_t lastStatus = g_hostComm->lastStatusMs();
@@ -1414,8 +1856,9 @@ void oven_comm_poll(void) {
         g_sentSafeStopOnThisSync = true;
     }
 
-    // 5) Poll STATUS periodically (only when link is synced AND alive)
-    if (runtimeState.linkSynced && runtimeState.commAlive) {
+    // 5) Poll STATUS periodically (only when link is synced AND alive).
+    //    Not needed while the client pushes STATUS (subscription active).
+    if (runtimeState.linkSynced && runtimeState.commAlive && !g_hostComm->statusSubscribed()) {
         if (now - g_lastStatusRequestMs >= kStatusPollIntervalMs) {
             g_lastStatusRequestMs = now;
             g_hostComm->requestStatus();
@@ -1440,9 +1883,9 @@ void oven_comm_poll(void) {
         const float chamberC = runtimeState.tempChamberC;
         const float tgt = runtimeState.tempTarget;
         const HeaterPolicy &policy = active_heater_policy();
-        const bool isFilament = (runtimeState.materialClass == HeaterMaterialClass::FILAMENT);
-        const bool isSilica100 =
-            (runtimeState.heaterCurveProfile == HeaterCurveProfileId::SILICA_100C);
+        const HeaterPulseTable &table = heater_table_for_profile(runtimeState.heaterCurveProfile);
+        const bool pulseGate = heater_table_has(table, HEATER_RULE_PULSE_GATE);
+        const bool runningFans = heater_table_has(table, HEATER_RULE_RUNNING_FANS);
 
         const bool safety = host_heater_safety_cutoff_active(runtimeState);
         runtimeState.safetyCutoffActive = safety;
@@ -1450,33 +1893,38 @@ void oven_comm_poll(void) {
         runtimeState.heaterStage = stage;
         runtimeState.tempToleranceC = heater_stage_band_c(stage, policy);
 
+        const bool sampled =
+            heater_mpc_sample(now, g_heaterEffectiveOn, !safety && runtimeState.tempChamberValid &&
+                                                            runtimeState.tempHotspotValid,
+                              runtimeState.tempHotspotC, chamberC);
+        const bool useMpc = (policy.controlMode == HeaterControlMode::MPC) && g_mpc.model.ready();
+        if (useMpc != runtimeState.heaterMpcActive) {
+            OVEN_INFO("[oven_comm_poll] heater MPC %s\n", useMpc ? "active" : "inactive, pulse tables");
+        }
+        runtimeState.heaterMpcActive = useMpc;
+
         bool desiredHeater = false;
-        if (!safety) {
-            if (isFilament) {
+        if (!safety && useMpc) {
+            desiredHeater = determine_mpc_heater_intent(
+                table, policy, chamberC, runtimeState.tempHotspotC, tgt, sampled);
+        } else if (!safety) {
+            if (pulseGate) {
+                // Pulse rules aim at the target plus the learned offset.
+                const float pulseTgt = tgt + g_warm.targetOffsetC;
                 desiredHeater =
-                    determine_filament_heater_intent(
-                        chamberC, runtimeState.tempHotspotC, tgt, runtimeState.heaterCurveProfile);
-            } else if (isSilica100) {
-                desiredHeater = determine_silica_heater_intent(chamberC, tgt);
+                    determine_pulse_heater_intent(table, stage, chamberC, runtimeState.tempHotspotC, pulseTgt);
+                if (desiredHeater &&
+                    heater_should_force_off(table, stage, chamberC, runtimeState.tempHotspotC, pulseTgt,
+                                            g_heaterGate.pulseCount)) {
+                    desiredHeater = false;
+                    heater_gate_begin_rest(g_heaterGate, now, heater_force_off_soak_ms(table, stage));
+                }
             } else {
                 desiredHeater = determine_heater_intent_for_stage(
                     stage, g_heaterIntentOn, chamberC, tgt, policy);
             }
-
-            if (desiredHeater && isFilament &&
-                filament_should_force_heater_off(
-                    stage, chamberC, runtimeState.tempHotspotC, tgt, g_heaterGate.pulseCount)) {
-                desiredHeater = false;
-                heater_gate_begin_rest(g_heaterGate, now, HOST_FILAMENT_REHEAT_SOAK_MS);
-            } else if (desiredHeater && isSilica100 &&
-                       silica_should_force_heater_off(chamberC, tgt, g_heaterGate.pulseCount)) {
-                desiredHeater = false;
-                heater_gate_begin_rest(g_heaterGate, now, HOST_SILICA_REHEAT_SOAK_MS);
-            }
-        } else if (isFilament) {
-            heater_gate_begin_rest(g_heaterGate, now, HOST_FILAMENT_SAFETY_SOAK_MS);
-        } else if (isSilica100) {
-            heater_gate_begin_rest(g_heaterGate, now, HOST_SILICA_SAFETY_SOAK_MS);
+        } else if (pulseGate) {
+            heater_gate_begin_rest(g_heaterGate, now, table.safetySoakMs);
         }
 
         // Request = control decision, Effective = relay-safe output after minimum ON/OFF timing
@@ -1485,8 +1933,10 @@ void oven_comm_poll(void) {
 
         const bool wasHeaterEffective = g_heaterEffectiveOn;
         const bool heaterEffective = compute_heater_effective(g_heaterIntentOn);
-        if (isFilament && wasHeaterEffective && !heaterEffective) {
-            fan_gate_force_fast(g_fanGate, now, HOST_FILAMENT_FAN_FAST_AFTER_HEAT_MS);
+        thermal_run_observe(now, chamberC, tgt, wasHeaterEffective, heaterEffective);
+        history_run_observe(now, chamberC, tgt, wasHeaterEffective);
+        if (runningFans && wasHeaterEffective && !heaterEffective) {
+            fan_gate_force_fast(g_fanGate, now, table.fanFastAfterHeatMs);
         }
         runtimeState.heater_actual_on = heaterEffective;
         runtime_sync_heater_alias();
@@ -1494,11 +1944,11 @@ void oven_comm_poll(void) {
         // Apply relay-safe effective state to command mask (remote truth is still telemetry)
         uint16_t cmd = g_lastCommandMask;
         cmd = mask_set(cmd, OVEN_CONNECTOR::HEATER, heaterEffective);
-        if (isFilament) {
+        if (runningFans) {
             if (heaterEffective) {
                 g_fanGate.forceFastUntilMs = 0;
             }
-            apply_filament_running_fan_policy(cmd, heaterEffective);
+            apply_running_fan_policy(table, cmd, heaterEffective);
         }
 
         // Overtemp indicator mirrors safety for now (kept for existing UI/logic)
@@ -1511,6 +1961,8 @@ void oven_comm_poll(void) {
         g_hostOvertempActive = false;
         g_heaterIntentOn = false;
         runtimeState.heaterStage = HeaterControlStage::IDLE;
+        runtimeState.heaterMpcActive = false;
+        g_mpc.sampling = false;
         runtimeState.heater_request_on = false;
         g_heaterEffectiveOn = false;
         runtimeState.heater_actual_on = false;
@@ -1580,7 +2032,8 @@ void oven_comm_poll(void) {
     }
     prevAlive = runtimeState.commAlive;
 
-    emit_csv_host_runtime_once_per_second(runtimeState);
+    emit_host_telemetry(runtimeState);
+    record_flight_sample(runtimeState);
 }
 
 // =============================================================================
@@ -0,0 +1,213 @@
+#include "run_history.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "log_oven.h"
+#include "oven.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_partition.h>
+#include <time.h>
+#endif
+
+#ifndef RUN_HISTORY_PARTITION_LABEL
+#define RUN_HISTORY_PARTITION_LABEL "runhist" // raw data partition, see partitions_host_16MB.csv
+#endif
+#ifndef RUN_HISTORY_PARTITION_SUBTYPE
+#define RUN_HISTORY_PARTITION_SUBTYPE 0x40 // custom data subtype: never a file system partition
+#endif
+#ifndef RUN_HISTORY_RECENT_LINES
+#define RUN_HISTORY_RECENT_LINES 10
+#endif
+
+namespace {
+
+#if defined(ARDUINO_ARCH_ESP32)
+static constexpr uint32_t kSectorBytes = 4096; // flash erase sector
+
+// The data partition as raw NOR flash.
+class PartitionFlash : public RunHistoryFlash {
+  public:
+    explicit PartitionFlash(const esp_partition_t *part) : _part(part) {}
+    uint32_t sectorSize() const override { return kSectorBytes; }
+    uint32_t sectorCount() const override { return _part->size / kSectorBytes; }
+    bool read(uint32_t addr, void *dst, size_t len) override {
+        return esp_partition_read(_part, addr, dst, len) == ESP_OK;
+    }
+    bool program(uint32_t addr, const void *src, size_t len) override {
+        return esp_partition_write(_part, addr, src, len) == ESP_OK;
+    }
+    bool erase(uint32_t sector) override {
+        return esp_partition_erase_range(_part, sector * kSectorBytes, kSectorBytes) == ESP_OK;
+    }
+
+  private:
+    const esp_partition_t *_part;
+};
+#endif
+
+static run_history::Store s_store;
+static uint32_t s_clockBase_s = 0; // newest stored time at mount
+
+static const char *reason_name(uint8_t reason) {
+    switch (reason) {
+    case RUN_END_COMPLETED:
+        return "completed";
+    case RUN_END_USER_STOP:
+        return "stopped";
+    case RUN_END_COMM_LOST:
+        return "comm lost";
+    case RUN_END_POWER_LOSS:
+        return "power loss";
+    default:
+        return "?";
+    }
+}
+
+static void print_aggregates(void) {
+    const uint32_t t0 = micros();
+    run_history::RunAggregate all;
+    if (!s_store.aggregate(run_history::kAnyPreset, 0, 0xFFFFFFFFu, &all)) {
+        LOG_CORE_PRINTF("OVEN", "INFO", "[HIST] off\n");
+        return;
+    }
+    const run_history::Store::Stats st = s_store.stats();
+    LOG_CORE_PRINTF("OVEN", "INFO", "[HIST] %lu runs, %lu.%01lu h, %lu Wh, %lu/%lu sectors, %lu torn\n",
+                    (unsigned long)all.runs, (unsigned long)(all.sumDuration_s / 3600u),
+                    (unsigned long)(all.sumDuration_s % 3600u / 360u), (unsigned long)all.sumEnergy_Wh,
+                    (unsigned long)st.sectorsHeld, (unsigned long)st.sectors, (unsigned long)st.torn);
+    char name[32];
+    for (uint16_t p = 0; p < kPresetCount; ++p) {
+        run_history::RunAggregate a;
+        s_store.aggregate(static_cast<uint8_t>(p), 0, 0xFFFFFFFFu, &a);
+        if (a.runs == 0) {
+            continue;
+        }
+        oven_get_preset_name(p, name, sizeof(name));
+        LOG_CORE_PRINTF("OVEN", "INFO",
+                        "[HIST] %-20s runs=%lu aborted=%lu reach avg %lu s, overshoot avg %ld max %d dC, %lu Wh/run\n",
+                        name, (unsigned long)a.runs, (unsigned long)a.aborted,
+                        (unsigned long)(a.reached ? a.sumTimeToTarget_s / a.reached : 0),
+                        (long)(a.reached ? a.sumOvershoot_dC / a.reached : 0), (int)a.maxOvershoot_dC,
+                        (unsigned long)(a.sumEnergy_Wh / a.runs));
+    }
+    LOG_CORE_PRINTF("OVEN", "INFO", "[HIST] queries took %lu us\n", (unsigned long)(micros() - t0));
+}
+
+static void print_recent(void) {
+    RunSummary runs[RUN_HISTORY_RECENT_LINES];
+    const size_t n = s_store.recent(runs, RUN_HISTORY_RECENT_LINES);
+    char name[32];
+    for (size_t i = 0; i < n; ++i) {
+        const RunSummary &r = runs[i];
+        oven_get_preset_name(r.preset, name, sizeof(name));
+        LOG_CORE_PRINTF("OVEN", "INFO", "[HIST] #%lu t=%lu %s %lu min, reach %ld s, overshoot %d dC, %u Wh, %s%s%s\n",
+                        (unsigned long)r.runId, (unsigned long)r.start_s, name, (unsigned long)(r.duration_s / 60u),
+                        r.timeToTarget_s == RUN_HISTORY_NOT_REACHED ? -1L : (long)r.timeToTarget_s,
+                        (int)r.overshoot_dC, (unsigned)r.energy_Wh, reason_name(r.reason),
+                        (r.flags & RUN_FLAG_SAFETY) ? ", safety" : "", (r.flags & RUN_FLAG_DOOR) ? ", door" : "");
+    }
+    if (n == 0) {
+        LOG_CORE_PRINTF("OVEN", "INFO", "[HIST] no runs\n");
+    }
+}
+
+} // namespace
+
+bool run_history_init(RunHistoryFlash *flash) {
+#if defined(ARDUINO_ARCH_ESP32)
+    static PartitionFlash *s_partition = nullptr;
+    if (!flash) {
+        if (!s_partition) {
+            const esp_partition_t *part = esp_partition_find_first(
+                ESP_PARTITION_TYPE_DATA, static_cast<esp_partition_subtype_t>(RUN_HISTORY_PARTITION_SUBTYPE),
+                RUN_HISTORY_PARTITION_LABEL);
+            if (!part) {
+                OVEN_WARN("[HIST] no '%s' partition (data, 0x%02X), run history off\n", RUN_HISTORY_PARTITION_LABEL,
+                          (unsigned)RUN_HISTORY_PARTITION_SUBTYPE);
+                return false;
+            }
+            s_partition = new PartitionFlash(part);
+        }
+        flash = s_partition;
+    }
+#endif
+    if (!s_store.mount(flash)) {
+        OVEN_WARN("[HIST] flash not usable, run history off\n");
+        return false;
+    }
+    const run_history::Store::Stats st = s_store.stats();
+    s_clockBase_s = st.newest_s;
+
+    RunSummary cut{};
+    if (s_store.pendingRun(&cut)) {
+        if (cut.start_s > s_clockBase_s) {
+            s_clockBase_s = cut.start_s;
+        }
+        cut.duration_s = 0; // unknown
+        cut.timeToTarget_s = RUN_HISTORY_NOT_REACHED;
+        cut.reason = RUN_END_POWER_LOSS;
+        s_store.endRun(cut);
+        OVEN_WARN("[HIST] run #%lu was cut short by a power loss\n", (unsigned long)cut.runId);
+    }
+    OVEN_INFO("[HIST] %lu runs in %lu/%lu sectors, mount read %lu B, %lu torn, %lu indexes rebuilt\n",
+              (unsigned long)st.runs, (unsigned long)st.sectorsHeld, (unsigned long)st.sectors,
+              (unsigned long)st.mountBytesRead, (unsigned long)st.torn, (unsigned long)st.indexesRebuilt);
+    return true;
+}
+
+uint32_t run_history_now_s(void) {
+#if defined(ARDUINO_ARCH_ESP32)
+    const time_t now = time(nullptr);
+    if (now > 1700000000) { // set by NTP
+        return static_cast<uint32_t>(now);
+    }
+#endif
+    return s_clockBase_s + 1u + static_cast<uint32_t>(millis() / 1000u);
+}
+
+bool run_history_begin(RunSummary &run) {
+    return s_store.mounted() && s_store.beginRun(run);
+}
+
+bool run_history_end(RunSummary &run) {
+    if (!s_store.mounted()) {
+        return false;
+    }
+    if (!s_store.endRun(run)) {
+        OVEN_WARN("[HIST] run #%lu not saved\n", (unsigned long)run.runId);
+        return false;
+    }
+    OVEN_INFO("[HIST] run #%lu saved: %lu s, reach %ld s, overshoot %d dC, %u Wh, %s\n", (unsigned long)run.runId,
+              (unsigned long)run.duration_s,
+              run.timeToTarget_s == RUN_HISTORY_NOT_REACHED ? -1L : (long)run.timeToTarget_s, (int)run.overshoot_dC,
+              (unsigned)run.energy_Wh, reason_name(run.reason));
+    return true;
+}
+
+bool run_history_aggregate(uint8_t preset, uint32_t from_s, uint32_t to_s, run_history::RunAggregate *out) {
+    return s_store.aggregate(preset, from_s, to_s, out);
+}
+
+size_t run_history_recent(RunSummary *out, size_t max) {
+    return s_store.recent(out, max);
+}
+
+bool run_history_command(const char *line, size_t len) {
+    while (len > 0 && (line[len - 1] == ' ' || line[len - 1] == '\r')) {
+        len--;
+    }
+    if (len < 4 || memcmp(line, "hist", 4) != 0 || (len > 4 && line[4] != ' ')) {
+        return false;
+    }
+    if (len == 4) {
+        print_aggregates();
+    } else if (len == 11 && memcmp(line + 5, "recent", 6) == 0) {
+        print_recent();
+    } else {
+        OVEN_WARN("[HIST] usage: hist | hist recent\n");
+    }
+    return true;
+}
@@ -0,0 +1,128 @@
+#include "thermal_cache.h"
+
+#include <Preferences.h>
+#include <cstring>
+
+namespace {
+
+static constexpr const char *kCacheNvsNamespace = "thermal-cache";
+static constexpr const char *kCacheBlobKey = "presets";
+static constexpr uint16_t kCacheVersion = 1;
+
+typedef struct ThermalCacheBlob {
+    uint16_t version;
+    uint16_t presetCount;
+    ThermalCacheEntry entries[kPresetCount];
+} ThermalCacheBlob;
+
+static ThermalCacheEntry s_cacheEntries[kPresetCount] = {};
+static bool s_cacheInitialized = false;
+
+static int32_t cache_ema(int32_t oldValue, int32_t observed) {
+    const int32_t step = (observed - oldValue) * HOST_THERMAL_CACHE_EMA_PCT;
+    return oldValue + (step >= 0 ? (step + 50) / 100 : (step - 50) / 100);
+}
+
+static bool cache_save() {
+    ThermalCacheBlob blob{};
+    blob.version = kCacheVersion;
+    blob.presetCount = kPresetCount;
+    std::memcpy(blob.entries, s_cacheEntries, sizeof(blob.entries));
+
+    Preferences prefs;
+    if (!prefs.begin(kCacheNvsNamespace, false)) {
+        return false;
+    }
+    const size_t written = prefs.putBytes(kCacheBlobKey, &blob, sizeof(blob));
+    prefs.end();
+    return written == sizeof(blob);
+}
+
+} // namespace
+
+void thermal_cache_init(void) {
+    std::memset(s_cacheEntries, 0, sizeof(s_cacheEntries));
+    s_cacheInitialized = true;
+
+    Preferences prefs;
+    if (!prefs.begin(kCacheNvsNamespace, true)) {
+        return;
+    }
+    ThermalCacheBlob blob{};
+    const size_t readSize = prefs.getBytes(kCacheBlobKey, &blob, sizeof(blob));
+    prefs.end();
+
+    // A changed preset list or layout starts from scratch: the entries are
+    // only a warm start, losing them costs one cold run per preset.
+    if (readSize == sizeof(blob) && blob.version == kCacheVersion && blob.presetCount == kPresetCount) {
+        std::memcpy(s_cacheEntries, blob.entries, sizeof(s_cacheEntries));
+    }
+}
+
+const ThermalCacheEntry *thermal_cache_get(uint16_t presetId, HeaterCurveProfileId profile, int16_t target_dC) {
+    if (!s_cacheInitialized) {
+        thermal_cache_init();
+    }
+    if (presetId >= kPresetCount) {
+        return nullptr;
+    }
+    const ThermalCacheEntry &e = s_cacheEntries[presetId];
+    if (e.runs == 0 || e.heaterProfile != static_cast<uint8_t>(profile) || e.target_dC != target_dC) {
+        return nullptr;
+    }
+    return &e;
+}
+
+bool thermal_cache_record(uint16_t presetId, const ThermalCacheEntry &observed) {
+    if (!s_cacheInitialized) {
+        thermal_cache_init();
+    }
+    if (presetId >= kPresetCount || observed.fields == 0) {
+        return false;
+    }
+
+    ThermalCacheEntry &e = s_cacheEntries[presetId];
+    if (e.runs == 0 || e.heaterProfile != observed.heaterProfile || e.target_dC != observed.target_dC) {
+        std::memset(&e, 0, sizeof(e));
+        e.heaterProfile = observed.heaterProfile;
+        e.target_dC = observed.target_dC;
+    }
+
+    // A field seen for the first time is taken as is.
+    if (observed.fields & THERMAL_CACHE_HEATUP) {
+        const bool known = (e.fields & THERMAL_CACHE_HEATUP) != 0;
+        e.heatRate_mCps = static_cast<uint16_t>(known ? cache_ema(e.heatRate_mCps, observed.heatRate_mCps)
+                                                      : observed.heatRate_mCps);
+        e.deadTimeMs = static_cast<uint32_t>(known ? cache_ema(static_cast<int32_t>(e.deadTimeMs),
+                                                         static_cast<int32_t>(observed.deadTimeMs))
+                                                   : observed.deadTimeMs);
+        e.timeToReachS = static_cast<uint16_t>(known ? cache_ema(e.timeToReachS, observed.timeToReachS)
+                                                    : observed.timeToReachS);
+    }
+    if (observed.fields & THERMAL_CACHE_HOLD) {
+        const bool known = (e.fields & THERMAL_CACHE_HOLD) != 0;
+        e.holdDuty_pm = static_cast<uint16_t>(known ? cache_ema(e.holdDuty_pm, observed.holdDuty_pm)
+                                                    : observed.holdDuty_pm);
+        e.overshoot_dC = static_cast<int16_t>(known ? cache_ema(e.overshoot_dC, observed.overshoot_dC)
+                                                    : observed.overshoot_dC);
+    }
+    e.fields |= observed.fields;
+    if (e.runs < 0xFF) {
+        e.runs++;
+    }
+
+    return cache_save();
+}
+
+bool thermal_cache_clear(void) {
+    std::memset(s_cacheEntries, 0, sizeof(s_cacheEntries));
+    s_cacheInitialized = true;
+
+    Preferences prefs;
+    if (!prefs.begin(kCacheNvsNamespace, false)) {
+        return false;
+    }
+    const bool ok = prefs.clear();
+    prefs.end();
+    return ok;
+}
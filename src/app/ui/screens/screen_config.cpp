@@ -269,7 +269,7 @@ static void load_preset_to_widgets(int preset_index) {
         //        std::snprintf(buf, sizeof(buf), "Loaded preset: %s", p->name);
         std::snprintf(buf, sizeof(buf), "Loaded preset '%s' %02d:%02d with %3d°C to widgets\n", p->name, hh, mm5, temp);
         lv_label_set_text(ui_config.label_info_message, buf);
-        UI_INFO(buf);
+        UI_INFO("%s", buf);
     }
     s_updating_widgets = false;
 }
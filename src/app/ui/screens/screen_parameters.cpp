@@ -3,6 +3,7 @@
 #include <Arduino.h>
 
 #include "host_parameters.h"
+#include "log_async.h"
 #include "ui_color_codes.h"
 
 #include <cstdint>
@@ -1070,6 +1071,7 @@ static void save_parameters_and_reboot(const HostParameters &params) {
     update_save_button_state();
     set_info_message("Gespeichert, Neustart...", 0x70D070);
     delay(120);
+    log_async::flush(LOG_ASYNC_BLOCKING_TIMEOUT_MS);
     ESP.restart();
 }
 
@@ -17,6 +17,7 @@
  * - Signaling events to the application:
  *     - hasNewOutputsMask(): host sent a SET command
  *     - statusRequested(): host sent a GET STATUS
+ * - Pushing STATUS frames while the host is subscribed (H;SUB)
  *
  * It does NOT:
  * - Directly manipulate GPIOs
@@ -39,12 +40,11 @@ static bool g_hostTimeoutActive = false;
 
 ClientComm::ClientComm(HardwareSerial &serial, uint8_t rx, uint8_t tx)
     : _linkSerial(serial),
-      _rx(rx),
-      _tx(tx),
-      _rxBuffer(),
       _outputsMask(0),
       _newOutputsMask(false),
-      _statusRequested(false) {
+      _statusRequested(false),
+      _rx(rx),
+      _tx(tx) {
 }
 
 /**
@@ -59,6 +59,8 @@ ClientComm::ClientComm(HardwareSerial &serial, uint8_t rx, uint8_t tx)
  * @param baudrate UART baud rate, must match the host side.
  */
 void ClientComm::begin(uint32_t baudrate) {
+    _baseBaud = baudrate;
+    _linkBaud = baudrate;
     _linkSerial.begin(baudrate, SERIAL_8N1, _rx, _tx);
     g_lastHostGoodMs = millis();
     g_hostTimeoutActive = false;
@@ -75,8 +77,7 @@ void ClientComm::begin(uint32_t baudrate) {
  *
  * It:
  * - Reads all available bytes from the UART
- * - Assembles lines until '\n'
- * - Strips '\r', uses '\n' as end-of-line
+ * - Splits them into binary frames and '\n'-terminated lines (LineAssembler)
  * - For each complete line, calls handleIncomingLine()
  *
  * This implementation is fully non-blocking and uses no delays.
@@ -84,55 +85,40 @@ void ClientComm::begin(uint32_t baudrate) {
 void ClientComm::loop() {
     bool hadActivity = false;
 
-    while (_linkSerial.available() > 0) {
-        hadActivity = true;
-        char c = static_cast<char>(_linkSerial.read());
-
-        if (c == '\r') {
-            continue;
+    // Replies and pushes flagged during the previous call go out first, so
+    // the application had one loop() pass to apply new outputs.
+    sendActReplyIfPending();
+    statusPushTick();
+
+    uint8_t block[kRxReadBlockLen];
+    int avail;
+    while ((avail = _linkSerial.available()) > 0) {
+        const size_t n =
+            _linkSerial.read(block, (size_t)avail < sizeof(block) ? (size_t)avail : sizeof(block));
+        if (n == 0) {
+            break;
         }
+        hadActivity = true;
 
-        if (c == '\n') {
-            String line = _rxBuffer;
-            _rxBuffer = "";
-
-            // Trim and ignore empty
-            line.trim();
-            if (line.isEmpty()) {
-                continue;
-            }
-
-            // Drop leading junk until 'H' or 'C'
-            int start = -1;
-            for (int i = 0; i < (int)line.length(); ++i) {
-                char ch = line[i];
-                if (ch == 'H' || ch == 'C') {
-                    start = i;
-                    break;
+        // Binary frames (0x00-delimited) are accepted at any time.
+        _lines.feedLink(
+            _binRx, block, n,
+            [this](const char *line, size_t len) { handleRxLine(line, len); },
+            [this]() {
+                // Safety against runaway garbage without '\n'
+                CLIENT_INFO("[CLIENTCOMM][T14] RX overflow -> SAFE");
+                enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::RxOverflow));
+                noteLinkError();
+            },
+            [this](ProtocolBinRx::Result r) {
+                if (r == ProtocolBinRx::Result::Frame) {
+                    handleBinaryFrame();
+                    return;
                 }
-            }
-
-            if (start < 0) {
-                // Junk-only line; ignore
-                continue;
-            }
-
-            if (start > 0) {
-                line = line.substring(start);
-            }
-
-            handleIncomingLine(line);
-            continue; // IMPORTANT: do NOT return; keep consuming RX buffer
-        }
-
-        _rxBuffer += c;
-
-        // Optional safety against runaway garbage without '\n'
-        if (_rxBuffer.length() > 120) {
-            CLIENT_INFO("[CLIENTCOMM][T14] RX overflow -> SAFE");
-            enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::RxOverflow));
-            _rxBuffer = "";
-        }
+                CLIENT_INFO("[CLIENTCOMM][T14] RX binary overflow -> SAFE");
+                enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::RxOverflow));
+                noteLinkError();
+            });
     }
     if (hadActivity && _heartBeatCb) {
         _heartBeatCb();
@@ -154,9 +140,19 @@ void ClientComm::loop() {
 
         _outputsMask = 0x0000;
         _newOutputsMask = true;
+        _expectedSeq = 0;  // the host drops its pending commands on re-sync
+        _binaryTx = false; // host will renegotiate after re-sync
+        clearStatusSubscription();
+        if (_linkBaud != _baseBaud) {
+            baudFallback("host timeout");
+        }
 
         RAW("[CLIENT][SAFETY] HOST TIMEOUT -> SAFE STATE (outputsMask=0)\n");
     }
+    // A raised link rate must be confirmed by a good host frame in time.
+    if (_baudVerifying && (now - _baudSwitchMs) >= kBaudVerifyMs) {
+        baudFallback("no host frame");
+    }
 }
 
 /**
@@ -237,8 +233,105 @@ void ClientComm::clearStatusRequestedFlag() {
  * @param status Status data to send.
  */
 void ClientComm::sendStatus(const ProtocolStatus &status) {
-    String msg = ProtocolCodec::buildClientStatus(status);
-    sendLine(msg);
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::ClientStatus);
+    msg.status = status;
+    sendMessage(msg);
+}
+
+/**
+ * @brief Sample the current status via the fill callback and send it.
+ *
+ * Used for H;GET;STATUS as well as for subscription pushes.
+ */
+void ClientComm::sendCurrentStatus() {
+    ProtocolStatus s{};
+    s.outputsMask = _outputsMask;
+
+    // Safe defaults
+    s.adcRaw[0] = s.adcRaw[1] = s.adcRaw[2] = s.adcRaw[3] = 0;
+
+    if (_fillStatusCb) {
+        _fillStatusCb(s);
+    }
+
+    sendStatus(s);
+}
+
+/**
+ * @brief Report a status-relevant event (ProtocolSubTrigger bit).
+ *
+ * Schedules an immediate STATUS push if the host subscribed to `trigger`.
+ * Cheap enough to call from any loop; does nothing without subscription.
+ */
+void ClientComm::notifyStatusEvent(uint16_t trigger) {
+    if (_subPeriodMs != 0 && (_subTriggers & trigger) != 0) {
+        _pushPending = true;
+    }
+}
+
+/**
+ * @brief Send a subscribed STATUS push when pending or when the period elapsed.
+ */
+void ClientComm::statusPushTick() {
+    if (_subPeriodMs == 0) {
+        return;
+    }
+
+    const uint32_t now = millis();
+    if (!_pushPending && (now - _lastPushMs) < _subPeriodMs) {
+        return;
+    }
+
+    _pushPending = false;
+    _lastPushMs = now; // event pushes restart the period
+    _statusPushCount++;
+    sendCurrentStatus();
+}
+
+/**
+ * @brief Send the deferred C;ACK;ACT reply (ACK mask + current STATUS).
+ *
+ * The STATUS part is sampled via the fill callback like H;GET;STATUS, so it
+ * reports the outputs as applied (door gating included). While subscribed,
+ * the reply also counts as the push for the outputs-change event.
+ */
+void ClientComm::sendActReplyIfPending() {
+    if (!_actReplyPending) {
+        return;
+    }
+    _actReplyPending = false;
+
+    ProtocolMessage reply = makeMessage(ProtocolMessageType::ClientAckAct);
+    reply.mask = _actReplyMask;
+    reply.seq = _actReplySeq;
+    reply.status.outputsMask = _outputsMask;
+    if (_fillStatusCb) {
+        _fillStatusCb(reply.status);
+    }
+    sendMessage(reply);
+
+    if (_subPeriodMs != 0) {
+        _pushPending = false;
+        _lastPushMs = millis();
+    }
+}
+
+void ClientComm::outputsApplied() {
+    sendActReplyIfPending();
+}
+
+void ClientComm::queueActReply(uint16_t ackMask, uint8_t seq) {
+    // Back-to-back ACTs within one loop() pass: answer the older one now.
+    sendActReplyIfPending();
+    _actReplyPending = true;
+    _actReplyMask = ackMask;
+    _actReplySeq = seq;
+}
+
+void ClientComm::clearStatusSubscription() {
+    _subPeriodMs = 0;
+    _subTriggers = 0;
+    _pushPending = false;
 }
 
 /**
@@ -251,9 +344,8 @@ void ClientComm::sendStatus(const ProtocolStatus &status) {
  *
  * @param mask 16-bit outputs mask confirming applied state.
  */
-void ClientComm::sendAckSet(uint16_t mask) {
-    String msg = ProtocolCodec::buildClientAckSet(mask);
-    sendLine(msg);
+void ClientComm::sendAckSet(uint16_t mask, uint8_t seq) {
+    sendAck(ProtocolMessageType::ClientAckSet, mask, seq);
 }
 
 /**
@@ -267,8 +359,9 @@ void ClientComm::sendAckSet(uint16_t mask) {
  * @param errorCode Application-defined error code.
  */
 void ClientComm::sendErrSet(int errorCode) {
-    String msg = ProtocolCodec::buildClientErrSet(errorCode);
-    sendLine(msg);
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::ClientErrSet);
+    msg.errorCode = errorCode;
+    sendMessage(msg);
 }
 
 /**
@@ -279,8 +372,7 @@ void ClientComm::sendErrSet(int errorCode) {
  */
 void ClientComm::sendPong() {
     // _clientSerialMonitor("Receiving PING  from host", "RX");
-    String msg = ProtocolCodec::buildClientPong();
-    sendLine(msg);
+    sendMessage(makeMessage(ProtocolMessageType::ClientPong));
     // _clientSerialMonitor("Sending PONG response to host", "TX");
 }
 
@@ -295,31 +387,72 @@ void ClientComm::sendPong() {
  *
  * Actual IO updates (GPIO, ADC, MAX6675) are handled by your main sketch.
  *
- * @param line A full protocol line without trailing CR/LF.
+ * @param line A full protocol line without trailing CR/LF (not NUL-terminated).
+ * @param len  Length of the line.
  */
 
-void ClientComm::handleIncomingLine(const String &line) {
-    ProtocolMessageType type;
-    ProtocolStatus dummyStatus; // not used for host messages
-    uint16_t mask = 0;
-    int errorCode = 0;
-    uint16_t maskB = 0;
-    uint16_t maskC = 0;
-    const uint16_t kDoorBit = (1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR);
+/**
+ * @brief Sanitize one assembled line (trim, drop leading junk) and parse it.
+ */
+void ClientComm::handleRxLine(const char *line, size_t len) {
+    // Trim and ignore empty
+    LineAssembler::trim(line, len);
+    if (len == 0) {
+        return;
+    }
+
+    // Drop leading junk until 'H' or 'C'; a junk-only line is ignored.
+    const size_t start = LineAssembler::frameStart(line, len);
+    if (start == len) {
+        return;
+    }
+    handleIncomingLine(line + start, len - start);
+}
+
+void ClientComm::handleIncomingLine(const char *line, size_t len) {
+    ProtocolMessage msg; // status part not used for host messages
 
     // Parse incoming line. For host→client messages we mainly care about:
     //  - HostSet / HostUpd / HostTog
     //  - HostGetStatus
     //  - HostPing
     //  - HostRst  (T14 SafetyGuard)
-    const bool ok = ProtocolCodec::parseLine(line, type, dummyStatus, mask, errorCode, maskB, maskC);
+    const bool ok = ProtocolCodec::parseFrame(line, len, msg);
     if (!ok) {
-        (void)errorCode;
-        RAW("[CLIENT][T14] Failed to parse line -> SAFE: %s\n", line.c_str());
+        RAW("[CLIENT][T14] Failed to parse line -> SAFE: %.*s\n", (int)len, line);
         enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::ParseError));
+        noteLinkError();
         return;
     }
 
+    handleMessage(msg);
+}
+
+/**
+ * @brief Handle one complete binary frame collected by _binRx.
+ *
+ * A CRC/COBS failure is a parse error and enters SAFE like ASCII.
+ */
+void ClientComm::handleBinaryFrame() {
+    ProtocolMessage msg;
+    if (!ProtocolBinCodec::decode(_binRx.block(), _binRx.blockLen(), msg)) {
+        RAW("[CLIENT][T14] Bad binary frame (len=%u) -> SAFE\n", (unsigned)_binRx.blockLen());
+        enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::ParseError));
+        noteLinkError();
+        return;
+    }
+    handleMessage(msg);
+}
+
+/**
+ * @brief Apply one decoded host message (ASCII or binary).
+ */
+void ClientComm::handleMessage(const ProtocolMessage &msg) {
+    const uint16_t kDoorBit = (1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR);
+    const ProtocolMessageType type = msg.type;
+    uint16_t mask = msg.mask;
+    const uint16_t maskB = msg.maskB;
+
     // SAFETY: feed host watchdog ONLY on expected host frames.
     // Do NOT clear the safety latch here. Only explicit SET/UPD/TOG can re-arm outputs.
     switch (type) {
@@ -329,19 +462,71 @@ void ClientComm::handleIncomingLine(const String &line) {
     case ProtocolMessageType::HostGetStatus:
     case ProtocolMessageType::HostPing:
     case ProtocolMessageType::HostRst:
+    case ProtocolMessageType::HostBin:
+    case ProtocolMessageType::HostSub:
+    case ProtocolMessageType::HostAct:
+    case ProtocolMessageType::HostBaud:
         g_lastHostGoodMs = millis();
         break;
     default:
-        RAW("[CLIENT][T14] Unexpected frame type -> SAFE (line=%s)\n", line.c_str());
+        RAW("[CLIENT][T14] Unexpected frame type=%u -> SAFE\n", (unsigned)type);
         enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::UnexpectedFrame));
         return;
     }
 
+    // A good host frame confirms the current link rate.
+    _baudErrorBurst = 0;
+    if (_baudVerifying) {
+        _baudVerifying = false;
+        RAW("[CLIENT] link rate %lu baud confirmed\n", (unsigned long)_linkBaud);
+    }
+
+    // Sequenced SET/UPD/TOG/ACT: in-order delivery, no double-apply on retransmit.
+    const uint8_t seq = msg.seq;
+    if (seq != 0) {
+        const ProtocolMessageType ackType =
+            (type == ProtocolMessageType::HostSet)   ? ProtocolMessageType::ClientAckSet
+            : (type == ProtocolMessageType::HostUpd) ? ProtocolMessageType::ClientAckUpd
+            : (type == ProtocolMessageType::HostAct) ? ProtocolMessageType::ClientAckAct
+                                                     : ProtocolMessageType::ClientAckTog;
+        switch (classifySeq(seq)) {
+        case SeqVerdict::Duplicate:
+            if (ackType == ProtocolMessageType::ClientAckAct) {
+                queueActReply(_outputsMask, seq);
+            } else {
+                sendAck(ackType, _outputsMask, seq);
+            }
+            RAW("[CLIENT] duplicate seq=%u -> re-ACK 0x%04X\n", seq, _outputsMask);
+            return;
+        case SeqVerdict::Ahead: {
+            // SET, or an ACT that sets or clears every output, does not depend
+            // on the commands in the gap: apply it, the gap becomes duplicates.
+            const uint16_t outputs = static_cast<uint16_t>(~kDoorBit);
+            const bool absolute = type == ProtocolMessageType::HostSet ||
+                                  (type == ProtocolMessageType::HostAct &&
+                                   ((msg.mask | msg.maskB) & outputs) == outputs);
+            if (!absolute) {
+                RAW("[CLIENT] seq=%u ahead of expected=%u -> dropped\n", seq, _expectedSeq);
+                return;
+            }
+            RAW("[CLIENT] seq=%u ahead of expected=%u, absolute -> applied\n", seq, _expectedSeq);
+            _expectedSeq = ProtocolSeq::advance(seq, 1);
+            break;
+        }
+        default:
+            _expectedSeq = ProtocolSeq::advance(seq, 1);
+            break;
+        }
+    }
+
     switch (type) {
     case ProtocolMessageType::HostSet: {
         clearSafetyLatch_();
 
         mask &= ~kDoorBit;
+        if (mask != _outputsMask) {
+            notifyStatusEvent(SubTriggerOutputs);
+        }
         _outputsMask = mask;
         _newOutputsMask = true;
 
@@ -349,7 +534,7 @@ void ClientComm::handleIncomingLine(const String &line) {
             _onOutputsChanged(_outputsMask);
         }
 
-        sendAckSet(mask);
+        sendAckSet(mask, seq);
         RAW("[CLIENT] Processed Host SET, new mask=0x%04X\n", mask);
         break;
     }
@@ -363,13 +548,16 @@ void ClientComm::handleIncomingLine(const String &line) {
 
         _outputsMask = (_outputsMask | setMask) & static_cast<uint16_t>(~clrMask);
         _newOutputsMask = true;
+        if (_outputsMask != prevMask) {
+            notifyStatusEvent(SubTriggerOutputs);
+        }
 
         if (_onOutputsChanged) {
             _onOutputsChanged(_outputsMask);
         }
 
         // ACK with resulting mask (current protocol)
-        sendAckUpd(_outputsMask);
+        sendAckUpd(_outputsMask, seq);
 
         RAW("[CLIENT/RX] HostUpd set=0x%04X clr=0x%04X prev=0x%04X new=0x%04X\n",
             setMask, clrMask, prevMask, _outputsMask);
@@ -384,43 +572,116 @@ void ClientComm::handleIncomingLine(const String &line) {
 
         _outputsMask ^= togMask;
         _newOutputsMask = true;
+        if (togMask != 0) {
+            notifyStatusEvent(SubTriggerOutputs);
+        }
 
         if (_onOutputsChanged) {
             _onOutputsChanged(_outputsMask);
         }
 
         // ACK with resulting mask (current protocol)
-        sendAckTog(_outputsMask);
+        sendAckTog(_outputsMask, seq);
 
         RAW("[CLIENT/RX] HostTog tog=0x%04X prev=0x%04X new=0x%04X\n",
             togMask, prevMask, _outputsMask);
         break;
     }
 
-    case ProtocolMessageType::HostGetStatus: {
-        ProtocolStatus s{};
-        s.outputsMask = _outputsMask;
+    case ProtocolMessageType::HostAct: {
+        // UPD semantics; the reply carries the full STATUS and is sent on
+        // the next loop() pass, after the application applied the outputs.
+        clearSafetyLatch_();
+
+        const uint16_t prevMask = _outputsMask;
+        const uint16_t setMask = mask & ~kDoorBit;
+        const uint16_t clrMask = maskB & ~kDoorBit;
 
-        // Safe defaults
-        s.adcRaw[0] = s.adcRaw[1] = s.adcRaw[2] = s.adcRaw[3] = 0;
+        _outputsMask = (_outputsMask | setMask) & static_cast<uint16_t>(~clrMask);
+        _newOutputsMask = true;
+        if (_outputsMask != prevMask) {
+            notifyStatusEvent(SubTriggerOutputs);
+        }
 
-        if (_fillStatusCb) {
-            _fillStatusCb(s);
+        if (_onOutputsChanged) {
+            _onOutputsChanged(_outputsMask);
         }
 
-        sendStatus(s);
+        queueActReply(_outputsMask, seq);
+
+        RAW("[CLIENT/RX] HostAct set=0x%04X clr=0x%04X prev=0x%04X new=0x%04X\n",
+            setMask, clrMask, prevMask, _outputsMask);
         break;
     }
 
+    case ProtocolMessageType::HostGetStatus:
+        sendCurrentStatus();
+        break;
+
     case ProtocolMessageType::HostPing:
         sendPong();
         break;
 
     case ProtocolMessageType::HostRst:
         // T14 SafetyGuard: treat RST as an immediate safe-state condition.
+        // The next session starts on ASCII again.
+        _actReplyPending = false;
+        _binaryTx = false;
+        clearStatusSubscription();
         enterSafeState_(static_cast<uint8_t>(ClientSafetyReason::HostRst));
         break;
 
+    case ProtocolMessageType::HostBin: {
+        // Link mode request. Always answered in ASCII, then TX switches.
+        const bool binary = (mask == static_cast<uint16_t>(ProtocolLinkMode::CobsCrc16));
+        const uint16_t mode = static_cast<uint16_t>(binary ? ProtocolLinkMode::CobsCrc16 : ProtocolLinkMode::Ascii);
+        _binaryTx = false;
+        char buf[ProtocolCodec::kMaxFrameLen];
+        sendLine(buf, ProtocolCodec::buildClientAckBin(buf, sizeof(buf), mode));
+        _binaryTx = binary;
+        RAW("[CLIENT] Link mode -> %s\n", binary ? "BINARY" : "ASCII");
+        break;
+    }
+
+    case ProtocolMessageType::HostBaud: {
+        // Link rate proposal. The ACK goes out at the old rate, then TX/RX
+        // switch; a good host frame within kBaudVerifyMs confirms the rate.
+        const uint32_t proposed = ProtocolLinkBaud::fromField(mask);
+        const bool supported = proposed <= ProtocolLinkBaud::kMax && ProtocolLinkBaud::indexOf(proposed) >= 0;
+        const uint32_t next = supported ? proposed : _linkBaud;
+
+        ProtocolMessage ack = makeMessage(ProtocolMessageType::ClientAckBaud);
+        ack.mask = ProtocolLinkBaud::toField(next);
+        sendMessage(ack);
+
+        if (next != _linkBaud) {
+            switchLinkBaud(next);
+            _baudVerifying = (next != _baseBaud);
+            _baudSwitchMs = millis();
+        }
+        RAW("[CLIENT] link rate proposal %lu -> %lu baud\n", (unsigned long)proposed, (unsigned long)next);
+        break;
+    }
+
+    case ProtocolMessageType::HostSub: {
+        // STATUS push subscription. Period 0 unsubscribes.
+        uint16_t period = mask;
+        if (period != 0 && period < kMinStatusPushPeriodMs) {
+            period = kMinStatusPushPeriodMs;
+        }
+        _subPeriodMs = period;
+        _subTriggers = (period != 0) ? maskB : 0;
+
+        ProtocolMessage ack = makeMessage(ProtocolMessageType::ClientAckSub);
+        ack.mask = period;
+        sendMessage(ack);
+
+        // First snapshot right away, then every period.
+        _pushPending = (period != 0);
+        RAW("[CLIENT] STATUS subscription period=%ums triggers=0x%04X\n", period, _subTriggers);
+        break;
+    }
+
     default:
         // Already handled above (unexpected -> SAFE).
         break;
@@ -531,15 +792,75 @@ void ClientComm::handleIncomingLine(const String &line) {
 void ClientComm::processLine(const String &line) {
     // Directly feed a protocol line into the normal handler.
     // This is used only in test/simulation environments.
-    handleIncomingLine(line);
+    handleIncomingLine(line.c_str(), line.length());
+}
+
+void ClientComm::sendAckUpd(uint16_t newMask, uint8_t seq) {
+    sendAck(ProtocolMessageType::ClientAckUpd, newMask, seq);
+}
+
+void ClientComm::sendAckTog(uint16_t newMask, uint8_t seq) {
+    sendAck(ProtocolMessageType::ClientAckTog, newMask, seq);
+}
+
+void ClientComm::sendAck(ProtocolMessageType ackType, uint16_t mask, uint8_t seq) {
+    ProtocolMessage msg = makeMessage(ackType);
+    msg.mask = mask;
+    msg.seq = seq;
+    sendMessage(msg);
+}
+
+/**
+ * @brief Classify a sequenced command relative to the next expected one.
+ *
+ * Sequence numbers run 1..255 and wrap. A number far outside the tracking
+ * span (host restarted, client rebooted) resynchronizes on that number.
+ */
+ClientComm::SeqVerdict ClientComm::classifySeq(uint8_t seq) const {
+    if (_expectedSeq == 0) {
+        return SeqVerdict::Apply;
+    }
+    const uint8_t d = static_cast<uint8_t>((static_cast<unsigned>(seq) + 255u - _expectedSeq) % 255u);
+    if (d == 0) {
+        return SeqVerdict::Apply;
+    }
+    if (d < ProtocolSeq::kTrackSpan) {
+        return SeqVerdict::Ahead;
+    }
+    if (d >= 255u - ProtocolSeq::kTrackSpan) {
+        return SeqVerdict::Duplicate;
+    }
+    return SeqVerdict::Apply;
+}
+
+// -----------------------------------------------------------------------------
+// Link baud rate (H;BAUD)
+// -----------------------------------------------------------------------------
+void ClientComm::switchLinkBaud(uint32_t baud) {
+    _linkSerial.flush(); // the ACK still goes out at the old rate
+    _linkSerial.updateBaudRate(baud);
+    _linkBaud = baud;
+    _lines.reset();
+    _binRx.reset();
+    _baudErrorBurst = 0;
 }
 
-void ClientComm::sendAckUpd(uint16_t newMask) {
-    sendLine(ProtocolCodec::buildClientAckUpd(newMask));
+void ClientComm::baudFallback(const char *why) {
+    RAW("[CLIENT] link rate %lu baud failed (%s) -> %lu baud\n", (unsigned long)_linkBaud, why,
+        (unsigned long)_baseBaud);
+    _baudFallbacks++;
+    _baudVerifying = false;
+    _expectedSeq = 0; // the host re-syncs and drops its pending commands
+    switchLinkBaud(_baseBaud);
 }
 
-void ClientComm::sendAckTog(uint16_t newMask) {
-    sendLine(ProtocolCodec::buildClientAckTog(newMask));
+void ClientComm::noteLinkError() {
+    if (_linkBaud == _baseBaud) {
+        return;
+    }
+    if (++_baudErrorBurst >= kBaudErrorBurst) {
+        baudFallback("RX errors");
+    }
 }
 
 void ClientComm::setOutputsChangedCallback(OutputsChangedCallback cb) {
@@ -555,12 +876,41 @@ void ClientComm::setHeartBeatCallback(HeartBeatCallback cb) {
     _heartBeatCb = cb;
 }
 
-void ClientComm::sendLine(const String &lineWithCrlf) {
-    _linkSerial.print(lineWithCrlf);
+ProtocolMessage ClientComm::makeMessage(ProtocolMessageType type) {
+    ProtocolMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = type;
+    return msg;
+}
+
+// Send a message in the negotiated link mode (ASCII or COBS+CRC16).
+void ClientComm::sendMessage(const ProtocolMessage &msg) {
+    char buf[ProtocolCodec::kMaxFrameLen];
+    if (!_binaryTx) {
+        sendLine(buf, ProtocolCodec::buildFrame(buf, sizeof(buf), msg));
+        return;
+    }
+
+    const size_t len = ProtocolBinCodec::encode(msg, reinterpret_cast<uint8_t *>(buf), sizeof(buf));
+    if (len == 0) {
+        return;
+    }
+    _linkSerial.write(reinterpret_cast<const uint8_t *>(buf), len);
+    if (_clientSerialMonitor) {
+        // Monitor always sees the readable ASCII form.
+        ProtocolCodec::buildFrame(buf, sizeof(buf), msg);
+        _clientSerialMonitor(buf, "TX");
+    }
+}
+
+// Send one NUL-terminated frame (incl. CRLF) with a single UART write.
+// A length of 0 (builder overflow) sends nothing.
+void ClientComm::sendLine(const char *lineWithCrlf, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    _linkSerial.write(reinterpret_cast<const uint8_t *>(lineWithCrlf), len);
     if (_clientSerialMonitor) {
-        // String noCrlf = lineWithCrlf;
-        // noCrlf.replace("\r", "");
-        // noCrlf.replace("\n", "");
         _clientSerialMonitor(lineWithCrlf, "TX");
     }
 }
@@ -594,6 +944,8 @@ const char *ClientComm::lastSafetyReasonStr() const {
 
 void ClientComm::enterSafeState_(uint8_t reasonRaw) {
     const ClientSafetyReason reason = static_cast<ClientSafetyReason>(reasonRaw);
+    // Whatever the host sends next starts a new sequence.
+    _expectedSeq = 0;
     // Idempotent: don't spam if already safe & latched.
     if (_safetyLatched && _outputsMask == 0) {
         return;
@@ -603,6 +955,9 @@ void ClientComm::enterSafeState_(uint8_t reasonRaw) {
     _lastSafetyReason = reasonRaw;
     _lastSafetyMs = millis();
 
+    if (_outputsMask != 0) {
+        notifyStatusEvent(SubTriggerOutputs);
+    }
     _outputsMask = 0;
     _newOutputsMask = true;
 
@@ -613,7 +968,7 @@ void ClientComm::enterSafeState_(uint8_t reasonRaw) {
     g_hostTimeoutActive = true;
 
     RAW("[CLIENT][SAFETY] ENTER SAFE STATE reason=%s (outputsMask=0)\n",
-        safetyReasonToStr_(static_cast<ClientSafetyReason>(reasonRaw)));
+        safetyReasonToStr_(reason));
 }
 
 void ClientComm::clearSafetyLatch_() {
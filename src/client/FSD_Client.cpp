@@ -19,6 +19,7 @@
 //   H;SET;XXXX
 //   H;UPD;SSSS;CCCC
 //   H;TOG;TTTT
+//   H;ACT;SSSS;CCCC
 //   H;GET;STATUS
 //   H;PING
 //
@@ -26,6 +27,7 @@
 //   C;ACK;SET;MMMM
 //   C;ACK;UPD;MMMM
 //   C;ACK;TOG;MMMM
+//   C;ACK;ACT;MMMM;<STATUS fields>
 //   C;STATUS;mask;a0;a1;a2;a3;tempChamber_dC
 //   C;PONG
 //
@@ -48,13 +50,15 @@
 #include "FSD_Client.h"
 #include "client/heater_io.h"
 #include "client/sensor_ntc.h"
+#include "log_async.h"
 #include "log_client.h"
-#include "log_csv.h"
+#include "log_telemetry.h"
 #include "ntc/ntc_convert.h"
 #include "ntc/ntc_divider_config_chamber.h"
 #include "ntc/ntc_divider_config_hotspot.h"
 #include "ntc/ntc_table_10k_ioveo_036HS05201.h"
 #include "sensors/ads1115_config.h"
+#include "timer_wheel.h"
 // #include "pins_client.h"
 #include "versions.h"
 #include "wifi_net.h"
@@ -198,66 +202,59 @@ static CLIENT_COMPLETE_STATE build_client_state(bool door_open) {
     return s;
 }
 
-static void emit_csv_client_state_once_per_second() {
-    static uint32_t last = 0;
-    const uint32_t now = millis();
-
-    if ((now - last) < 1000) {
+// CLIENT_PLOT + CLIENT_LOGIC records (log_telemetry.h). The timer ticks at
+// the fast telemetry rate; while the heater is off only every
+// (slow / fast)-th tick sends.
+static void emit_client_telemetry(void *ctx) {
+    (void)ctx;
+    static telemetry::Decimator decimator;
+    if (!decimator.tick(heater_io::is_running())) {
         return;
     }
-    last = now;
-
-    const bool door_open = sensor_ntc::is_door_open();
-    const CLIENT_COMPLETE_STATE s = build_client_state(door_open);
 
 #if defined(CSV_OUT) && (CSV_OUT == 1)
-    CSV_LOG_CLIENT_LOGIC(
-        s.fan12V ? 1 : 0,
-        s.fan230V ? 1 : 0,
-        s.fan230V_SLOW ? 1 : 0,
-        s.silica_motor ? 1 : 0,
-        s.heater ? 1 : 0,
-        s.lamp ? 1 : 0,
-        s.door ? 1 : 0,
-        s.running_state);
+    const sensor_ntc::Sample &s = sensor_ntc::get_sample();
+    const bool door_open = sensor_ntc::is_door_open();
+    const CLIENT_COMPLETE_STATE st = build_client_state(door_open);
+    static constexpr int16_t TEMP_INVALID_DC = -32768;
 
+    telemetry::ClientTemp temp{};
+    // Hotspot NTC
+    temp.rawHot = s.rawHotspot;
+    temp.hot_mV = s.hot_mV;
+    temp.hot_dC = s.hotValid ? s.hot_dC : TEMP_INVALID_DC;
+    // Chamber NTC
+    temp.rawChamber = s.rawChamber;
+    temp.cha_mV = s.cha_mV;
+    temp.cha_dC = s.cha_dC;
+    // Diagnostic state
+    temp.state = static_cast<uint8_t>(diag_state_to_int());
+    temp.heater = st.heater ? 1 : 0;
+    temp.door = door_open ? 1 : 0;
+    // Filtered (ntc_filter.h)
+    temp.hotFilt_dC = s.hotFilt_dC;
+    temp.chaFilt_dC = s.chaFilt_dC;
+    TELEMETRY_LOG(temp);
+
+    telemetry::ClientLogic logic{};
+    logic.fan12V = st.fan12V ? 1 : 0;
+    logic.fan230V = st.fan230V ? 1 : 0;
+    logic.fan230V_slow = st.fan230V_SLOW ? 1 : 0;
+    logic.motor = st.silica_motor ? 1 : 0;
+    logic.heater = st.heater ? 1 : 0;
+    logic.lamp = st.lamp ? 1 : 0;
+    logic.door = st.door ? 1 : 0;
+    logic.state = st.running_state;
+    TELEMETRY_LOG(logic);
 #endif
 }
 
-static void emit_diagnostic_log_once_per_second() {
-    static uint32_t lastMs = 0;
-    const uint32_t now = millis();
-    if ((now - lastMs) < 1000u) {
-        return;
-    }
-    lastMs = now;
-
+static void emit_diagnostic_log(void *ctx) {
+    (void)ctx;
     const sensor_ntc::Sample &s = sensor_ntc::get_sample();
     const bool door_open = sensor_ntc::is_door_open();
     const bool heater_on = heater_io::is_running();
 
-#if defined(CSV_OUT) && (CSV_OUT == 1)
-    // const long hot_dC = s.hotValid ? (long)s.hot_dC : -32768L;
-    static constexpr int16_t TEMP_INVALID_DC = -32768;
-    const long hot_dC = s.hotValid ? (long)s.hot_dC : TEMP_INVALID_DC;
-    const long cha_dC = (long)s.cha_dC;
-
-    CSV_LOG_CLIENT_TEMP(
-        // Hotspot NTC
-        (long)s.rawHotspot,
-        (long)s.hot_mV,
-        hot_dC,
-        // Chamber NTC
-        (long)s.rawChamber,
-        (long)s.cha_mV,
-        cha_dC,
-        // Diagnostic state
-        (long)diag_state_to_int(),
-        heater_on ? 1L : 0L,
-        door_open ? 1L : 0L);
-
-#endif
-
     CLIENT_INFO(
         "[DIAG] Door=%s state=%s mask=0x%04X rawHot=%d hot_mV=%ld hot_valid=%d "
         "Thot=%.2fC (%s) rawCh=%d cha_mV=%ld cha_ohm=%ld Tch=%.2fC heater=%s\n",
@@ -277,15 +274,12 @@ static void emit_diagnostic_log_once_per_second() {
 }
 
 // parse_hex4_at():
-//   Parse exactly 4 hex chars at a given position in an Arduino String.
+//   Parse exactly 4 hex chars at the start of a C string.
 //   Used to extract MMMM from outgoing ACK/STATUS lines for debug annotation.
-static bool parse_hex4_at(const String &s, int start, uint16_t &out) {
-    if (start < 0 || start + 4 > (int)s.length()) {
-        return false;
-    }
+static bool parse_hex4_at(const char *s, uint16_t &out) {
     uint16_t v = 0;
     for (int i = 0; i < 4; ++i) {
-        char c = s[start + i];
+        char c = s[i];
         uint8_t n;
         if (c >= '0' && c <= '9') {
             n = (uint8_t)(c - '0');
@@ -294,7 +288,7 @@ static bool parse_hex4_at(const String &s, int start, uint16_t &out) {
         } else if (c >= 'a' && c <= 'f') {
             n = (uint8_t)(10 + (c - 'a'));
         } else {
-            return false;
+            return false; // also stops at the terminating NUL
         }
         v = (uint16_t)((v << 4) | n);
     }
@@ -587,17 +581,26 @@ static void fillStatusCallback(ProtocolStatus &st) {
         st.outputsMask &= ~(1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR);
     }
 
-    sensor_ntc::sample_temperatures();
-    const sensor_ntc::Sample &sample = sensor_ntc::get_sample();
+    // Served from the background sampler's snapshot; only sample inline
+    // (blocking, two conversions) when the sampling task is not running.
+    if (!sensor_ntc::sampling_running()) {
+        sensor_ntc::sample_temperatures();
+    }
+    const sensor_ntc::Sample sample = sensor_ntc::get_sample();
+
+    for (uint8_t i = 0; i < 4; ++i) {
+        st.adcRaw[i] = sample.raw[i];
+    }
 
-    st.adcRaw[0] = sample.rawHotspot;
-    st.adcRaw[1] = sample.rawChamber;
-    st.adcRaw[2] = 0;
-    st.adcRaw[3] = 0;
+    // Filtered temperatures for the host control loop; the raw counts of the
+    // same round travel in adcRaw[].
+    st.tempHotspot_dC = sample.hotValid ? sample.hotFilt_dC : ntc::TEMP_INVALID_DC;
+    st.tempChamber_dC = sample.chaFilt_dC;
 
-    st.tempHotspot_dC = sample.hotValid ? sample.hot_dC : ntc::TEMP_INVALID_DC;
-    st.tempChamber_dC =
-        (sample.cha_dC == ntc::TEMP_INVALID_DC) ? ntc::TEMP_INVALID_DC : sample.cha_dC;
+    const uint32_t ageMs = sensor_ntc::sample_age_ms(sample);
+    st.sampleSeq = sample.seq;
+    st.sampleAgeMs = (ageMs > 0xFFFFu) ? 0xFFFFu : static_cast<uint16_t>(ageMs);
+    st.sensorFaults = sample.sensorFaults;
 }
 
 // Apply outputs when mask changes
@@ -614,7 +617,7 @@ static void outputsChangedCallback(uint16_t newMask) {
 
 // Debug outgoing frames (optional)
 // Adds a human-readable BitMask for known frames carrying a 16-bit mask.
-static void txLineCallback(const String &line, const String &dir) {
+static void txLineCallback(const char *line, const char *dir) {
     uint16_t mask = 0;
     bool hasMask = false;
 
@@ -622,45 +625,31 @@ static void txLineCallback(const String &line, const String &dir) {
     // - C;ACK;SET;MMMM
     // - C;ACK;UPD;MMMM
     // - C;ACK;TOG;MMMM
-    // - C;STATUS;MMMM;A0;A1;A2;A3;TEMP
-
-    const int idxAckSet = line.indexOf("C;ACK;SET;");
-    if (idxAckSet >= 0) {
-        const int hexPos = idxAckSet + (int)strlen("C;ACK;SET;");
-        hasMask = parse_hex4_at(line, hexPos, mask);
-    }
-
-    const int idxAckUpd = (!hasMask) ? line.indexOf("C;ACK;UPD;") : -1;
-    if (idxAckUpd >= 0) {
-        const int hexPos = idxAckUpd + (int)strlen("C;ACK;UPD;");
-        hasMask = parse_hex4_at(line, hexPos, mask);
-    }
-
-    const int idxAckTog = (!hasMask) ? line.indexOf("C;ACK;TOG;") : -1;
-    if (idxAckTog >= 0) {
-        const int hexPos = idxAckTog + (int)strlen("C;ACK;TOG;");
-        hasMask = parse_hex4_at(line, hexPos, mask);
-    }
-
-    const int idxStatus = (!hasMask) ? line.indexOf("C;STATUS;") : -1;
-    if (idxStatus >= 0) {
-        const int hexPos = idxStatus + (int)strlen("C;STATUS;");
-        hasMask = parse_hex4_at(line, hexPos, mask);
+    // - C;ACK;ACT;MMMM;<STATUS fields>
+    // - C;STATUS;MMMM;A0;A1;A2;A3;HOT;CHAMBER
+    static const char *const kMaskPrefixes[] = {"C;ACK;SET;", "C;ACK;UPD;", "C;ACK;TOG;", "C;ACK;ACT;", "C;STATUS;"};
+    for (const char *prefix : kMaskPrefixes) {
+        const char *hit = strstr(line, prefix);
+        if (hit != nullptr) {
+            hasMask = parse_hex4_at(hit + strlen(prefix), mask);
+            if (hasMask) {
+                break;
+            }
+        }
     }
 
 #ifdef CLIENTNOPONGLOG
     // Optional log hygiene: suppress PONG logs
-    const int idxPONG = line.indexOf("C;PONG");
-    if (idxPONG >= 0) {
+    if (strstr(line, "C;PONG") != nullptr) {
         return;
     }
 #endif
     if (hasMask) {
         CLIENT_RAW("[CLIENT] [%s]: BitMask: (%s) => %s;",
-                   dir.c_str(), bitmask8_to_str(mask), line.c_str());
+                   dir, bitmask8_to_str(mask), line);
     } else {
-        if (dir.length() > 2) {
-            CLIENT_RAW("[CLIENT] [%s]: %s", dir.c_str(), line.c_str());
+        if (strlen(dir) > 2) {
+            CLIENT_RAW("[CLIENT] [%s]: %s", dir, line);
         }
     }
 }
@@ -858,6 +847,9 @@ static void t13_ntc_chamber_test_tick() {
 
 void setup() {
     Serial.begin(115200);
+#if LOG_ASYNC_ENABLE
+    log_async::start(); // log calls only queue from here on
+#endif
     delay(2000);
 
 #if defined(WIFI_LOGGING_ENABLE) && (WIFI_LOGGING_ENABLE == 1)
@@ -901,6 +893,10 @@ void setup() {
 // ADS1x15
 #if ENABLE_INTERNAL_NTC
     sensor_ntc::init_i2c_and_ads();
+#ifndef T13_NTC_CHAMBER_TEST
+    // STATUS replies read the latest snapshot instead of converting inline
+    sensor_ntc::start_sampling();
+#endif
 #endif
 
     // Initialize ClientComm UART (routes RX2/TX2 inside ClientComm as required)
@@ -919,6 +915,10 @@ void setup() {
     // const bool door_open = (digitalRead(OVEN_DOOR_SENSOR) != 0);
 
     sensor_ntc::init_door();
+
+    g_loopTimers.reset(millis());
+    g_loopTimers.startPeriodic("diag", 1000, emit_diagnostic_log, nullptr, 1000);
+    g_loopTimers.startPeriodic("csv", telemetry::samplePeriodMs(true), emit_client_telemetry, nullptr, 1000);
 }
 
 //----------------------------------------------------------------------------
@@ -940,6 +940,9 @@ void loop() {
         g_applyPending = false;
         applyOutputs(m);
         CLIENT_RAW("[T10.1.41] applyOutputs() from loop: mask=0x%04X\n", m);
+
+        // H;ACT reply (ACK + STATUS) now reflects the applied outputs.
+        clientComm.outputsApplied();
     }
 
     // ---------------------------------------------------------------------
@@ -969,6 +972,16 @@ void loop() {
         clientComm.clearNewOutputsMaskFlag();
     }
 
+    // Sensor fault edges: the host stops the heater on a non-zero mask, so a
+    // subscribed host gets the change pushed instead of waiting a period.
+    static uint16_t lastSensorFaults = 0;
+    const uint16_t sensorFaults = sensor_ntc::get_sample().sensorFaults;
+    if (sensorFaults != lastSensorFaults) {
+        CLIENT_WARN("[SENSOR] fault mask 0x%04X -> 0x%04X\n", lastSensorFaults, sensorFaults);
+        lastSensorFaults = sensorFaults;
+        clientComm.notifyStatusEvent(SubTriggerSensorFault);
+    }
+
     // Door transition watcher: on door OPEN, force safe outputs immediately.
     static bool lastDoorOpen = false;
     const bool doorOpenNow = isDoorOpen();
@@ -976,6 +989,9 @@ void loop() {
     if (doorOpenNow != lastDoorOpen) {
         lastDoorOpen = doorOpenNow;
 
+        // Subscribed host gets a STATUS push with the new door bit right away.
+        clientComm.notifyStatusEvent(SubTriggerDoor);
+
         if (doorOpenNow) {
             uint16_t before = g_effectiveMask;
 
@@ -1012,8 +1028,8 @@ void loop() {
         }
     }
 
-    emit_diagnostic_log_once_per_second();
-    emit_csv_client_state_once_per_second();
+    // 1 Hz diagnostics (g_loopTimers, started at the end of setup())
+    g_loopTimers.advance(millis());
 }
 
 // EOF
@@ -0,0 +1,112 @@
+#include "client/ads1115_async.h"
+
+Ads1115Async::Ads1115Async(Ads1115Bus &bus, uint8_t addr, DataRate rate, uint16_t pga)
+    : _bus(bus), _addr(addr), _rate(rate), _pga(pga) {}
+
+uint16_t Ads1115Async::configWord(uint8_t ch) const {
+    return static_cast<uint16_t>(kCfgOsStart | (kCfgMuxSingle0 + (ch & 0x03) * 0x1000) | _pga | kCfgModeSingle |
+                                 static_cast<uint16_t>(_rate) | kCfgCompQue1);
+}
+
+uint32_t Ads1115Async::conversionUs() const {
+    uint32_t sps = 128;
+    switch (_rate) {
+    case DataRate::Sps128:
+        sps = 128;
+        break;
+    case DataRate::Sps250:
+        sps = 250;
+        break;
+    case DataRate::Sps475:
+        sps = 475;
+        break;
+    case DataRate::Sps860:
+        sps = 860;
+        break;
+    }
+    return (1100000u + sps - 1) / sps;
+}
+
+bool Ads1115Async::begin() {
+    _channel = 0;
+    // Conversion-ready mode: Hi_thresh MSB set, Lo_thresh MSB clear.
+    if (!_bus.writeReg(_addr, kRegHiThresh, 0x8000) || !_bus.writeReg(_addr, kRegLoThresh, 0x0000)) {
+        _busErrors++;
+        return false;
+    }
+    return startConversion();
+}
+
+bool Ads1115Async::startConversion() {
+    _started = _bus.writeReg(_addr, kRegConfig, configWord(_channel));
+    if (!_started) {
+        _busErrors++;
+    }
+    return _started;
+}
+
+bool Ads1115Async::finishConversion() {
+    if (!_started) {
+        // The start write failed: the conversion register holds the previous
+        // channel, so start again instead of reading it.
+        startConversion();
+        return false;
+    }
+    uint16_t value = 0;
+    if (!_bus.readReg(_addr, kRegConversion, value)) {
+        _busErrors++;
+        startConversion(); // retry the same channel
+        return false;
+    }
+    _raw[_channel] = static_cast<int16_t>(value);
+    _conversions++;
+
+    const bool roundDone = (_channel == kChannels - 1);
+    if (roundDone) {
+        _rounds++;
+    }
+    _channel = static_cast<uint8_t>((_channel + 1) % kChannels);
+    startConversion();
+    return roundDone;
+}
+
+bool Ads1115Async::onReady() {
+    return finishConversion();
+}
+
+bool Ads1115Async::poll() {
+    if (!_started) {
+        startConversion();
+        return false;
+    }
+    uint16_t cfg = 0;
+    if (!_bus.readReg(_addr, kRegConfig, cfg)) {
+        _busErrors++;
+        return false;
+    }
+    if (!(cfg & kCfgOsStart)) {
+        return false;
+    }
+    return finishConversion();
+}
+
+bool Ads1115Async::onTimeout() {
+    _timeouts++;
+    if (!_started) {
+        startConversion();
+        return false;
+    }
+    uint16_t cfg = 0;
+    if (!_bus.readReg(_addr, kRegConfig, cfg)) {
+        _busErrors++;
+        startConversion();
+        return false;
+    }
+    if (cfg & kCfgOsStart) {
+        return finishConversion(); // finished, only the edge was missed
+    }
+    startConversion(); // stuck or lost (device reset): start the channel again
+    return false;
+}
+
+// EOF
@@ -3,33 +3,87 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+#include "client/ads1115_async.h"
 #include "log_client.h"
 #include "pins_client.h"
+#include "seqlock.h"
 
 #include "ntc/ntc.h"
 #include "ntc/ntc_convert.h"
+#include "ntc/ntc_fault.h"
+#include "ntc/ntc_filter.h"
+#include "ntc/ntc_lut_sensors.h"
 #include "ntc/ntc_table_hotspot.h"
 #include "ntc/ntc_table_10k_ioveo_036HS05201.h"
 
-#include <Adafruit_ADS1X15.h>
-
 namespace sensor_ntc {
 
 static constexpr uint8_t I2C_SDA = 22;
 static constexpr uint8_t I2C_SCL = 23;
 static constexpr uint8_t I2C_ADR = 0x48;
 
-static constexpr int32_t VREF_MV = 5000;
-static constexpr int32_t RFIXED_HOT_OHM = 100000;
-static constexpr int32_t RFIXED_CHA_OHM = 10000;
-static constexpr bool NTC_TO_GND = true;
+// Divider values come from ntc_divider_config_*.h, which also feed the
+// generated tables (ntc_lut_sensors.h).
+static constexpr int32_t VREF_MV = ntc::chamber::NTC_VREF_MV;
+static constexpr int32_t RFIXED_HOT_OHM = ntc::hotspot::NTC_R_FIXED_OHM;
+static constexpr int32_t RFIXED_CHA_OHM = ntc::chamber::NTC_R_FIXED_OHM;
+static constexpr bool NTC_TO_GND = ntc::chamber::NTC_TO_GND;
+static_assert(ntc::hotspot::NTC_VREF_MV == VREF_MV && ntc::hotspot::NTC_TO_GND == NTC_TO_GND,
+              "both NTC dividers share Vref and orientation");
 
 static constexpr int32_t HOT_MV_MIN_VALID = 50;
 static constexpr int32_t HOT_MV_MAX_VALID = (VREF_MV - 50);
 
-static Adafruit_ADS1115 g_ads;
-static Sample g_sample;
-static Sample g_sample_next;
+// Background sampling: the task owns the ADS1115 driver and g_sample_next
+// and publishes every finished AIN0..AIN3 round through g_published, so
+// STATUS replies only copy the latest snapshot. The task sleeps until the
+// ALERT/RDY interrupt wakes it; each wake-up reads one channel and starts
+// the next conversion.
+static constexpr int kSampleTaskCore = 0; // loop() and ClientComm run on core 1
+static constexpr uint32_t kSampleTaskStack = 3072;
+static constexpr UBaseType_t kSampleTaskPriority = 2;
+static constexpr uint32_t kI2cClockHz = 400000; // ADS1115 fast mode
+
+// Ads1115Bus on the Arduino Wire instance.
+class WireAdsBus : public Ads1115Bus {
+  public:
+    bool writeReg(uint8_t addr, uint8_t reg, uint16_t value) override {
+        Wire.beginTransmission(addr);
+        Wire.write(reg);
+        Wire.write(static_cast<uint8_t>(value >> 8));
+        Wire.write(static_cast<uint8_t>(value & 0xFF));
+        return Wire.endTransmission() == 0;
+    }
+
+    bool readReg(uint8_t addr, uint8_t reg, uint16_t &value) override {
+        Wire.beginTransmission(addr);
+        Wire.write(reg);
+        if (Wire.endTransmission() != 0) {
+            return false;
+        }
+        if (Wire.requestFrom(addr, static_cast<uint8_t>(2)) != 2) {
+            return false;
+        }
+        const uint8_t hi = Wire.read();
+        const uint8_t lo = Wire.read();
+        value = static_cast<uint16_t>((hi << 8) | lo);
+        return true;
+    }
+};
+
+static WireAdsBus g_bus;
+static Ads1115Async g_adc(g_bus, I2C_ADR, Ads1115Async::DataRate::Sps860);
+static bool g_adsOk = false;
+static Sample g_sample_next; // writer side only
+static SeqLock<Sample> g_published;
+static ntc::HotspotFilter g_hotFilter; // writer side only
+static ntc::ChamberFilter g_chaFilter;
+static ntc::SensorFaultDetector g_hotFault(ntc::kHotspotFaultConfig);
+static ntc::SensorFaultDetector g_chaFault(ntc::kChamberFaultConfig);
+static ntc::SensorPairCheck g_pairCheck(ntc::kSensorPairConfig);
+static uint16_t g_seq = 0;
+static TaskHandle_t g_task = nullptr;
+static TaskHandle_t volatile g_rdyTask = nullptr; // set by the task itself before the ISR is attached
 
 static void i2c_scan() {
     CLIENT_INFO("---------------------------\n");
@@ -74,33 +128,35 @@ void init_door() {
 
 void init_i2c_and_ads() {
     Wire.begin(I2C_SDA, I2C_SCL);
-    Wire.setClock(100000);
+    Wire.setClock(kI2cClockHz);
 
     i2c_scan();
 
-    if (!g_ads.begin(I2C_ADR, &Wire)) {
+    uint16_t cfg = 0;
+    if (!g_bus.readReg(I2C_ADR, Ads1115Async::kRegConfig, cfg)) {
         CLIENT_ERR("[I2C] ADS1115 not found at 0x%02X. Check wiring/address\n",
                    (unsigned)I2C_ADR);
         CLIENT_ERR("[I2C] Tip: ADS1115 addresses are usually 0x48,0x49,0x4A,0x4B.\n");
 
-        g_sample.adsOk = false;
+        g_adsOk = false;
         g_sample_next.adsOk = false;
+        g_published.write(g_sample_next);
 
         while (true) {
             delay(1000);
         }
     } else {
-        g_sample.adsOk = true;
+        g_adsOk = true;
         g_sample_next.adsOk = true;
-        g_ads.setGain(GAIN_TWOTHIRDS);
+        g_published.write(g_sample_next);
+        pinMode(PIN_ADS_ALERT_RDY, INPUT_PULLUP); // open drain
 
-        CLIENT_INFO("[I2C] ADS1115 found, Gain=%d (6.144V)\n",
-                    (int)GAIN_TWOTHIRDS);
+        CLIENT_INFO("[I2C] ADS1115 found, PGA 6.144V, 860 SPS, RDY on GPIO%d\n", PIN_ADS_ALERT_RDY);
     }
 }
 
-static void sample_hotspot_temperature() {
-    g_sample_next.rawHotspot = g_ads.readADC_SingleEnded(0);
+static void convert_hotspot_temperature() {
+    g_sample_next.rawHotspot = g_sample_next.raw[ntc::ADS_CH_HOTSPOT];
     g_sample_next.hot_mV = ntc::ads_raw_to_mV(g_sample_next.rawHotspot);
 
     const bool rail_invalid =
@@ -113,6 +169,9 @@ static void sample_hotspot_temperature() {
         RFIXED_HOT_OHM,
         NTC_TO_GND);
 
+#if NTC_RAW_LUT
+    g_sample_next.hot_dC = ntc::HotspotRawLut::temp_dC(g_sample_next.rawHotspot);
+#else
     g_sample_next.hot_dC = ntc::calc_temp_from_ads_raw_dC(
         g_sample_next.rawHotspot,
         ntc::kNtc100k_Hotspot_Table,
@@ -121,6 +180,7 @@ static void sample_hotspot_temperature() {
         VREF_MV,
         RFIXED_HOT_OHM,
         NTC_TO_GND);
+#endif
 
     const bool conv_invalid =
         (g_sample_next.hot_ohm < 0) ||
@@ -131,16 +191,14 @@ static void sample_hotspot_temperature() {
         g_sample_next.hotValid ? (g_sample_next.hot_dC / 10.0f) : NAN;
 }
 
-void sample_temperatures() {
-    if (!g_sample.adsOk) {
-        return;
-    }
-
-    g_sample_next = g_sample;
+// NTC math, filter chains and fault detection on the latest round, then
+// publish raw and filtered temperatures and the fault mask together.
+static void publish_round() {
+    memcpy(g_sample_next.raw, g_adc.rawAll(), sizeof(g_sample_next.raw));
 
-    sample_hotspot_temperature();
+    convert_hotspot_temperature();
 
-    g_sample_next.rawChamber = g_ads.readADC_SingleEnded(1);
+    g_sample_next.rawChamber = g_sample_next.raw[ntc::ADS_CH_CHAMBER];
     g_sample_next.cha_mV = ntc::ads_raw_to_mV(g_sample_next.rawChamber);
     g_sample_next.cha_ohm = ntc::voltage_to_resistance_ohm(
         g_sample_next.cha_mV,
@@ -148,6 +206,9 @@ void sample_temperatures() {
         RFIXED_CHA_OHM,
         NTC_TO_GND);
 
+#if NTC_RAW_LUT
+    g_sample_next.cha_dC = ntc::ChamberRawLut::temp_dC(g_sample_next.rawChamber);
+#else
     g_sample_next.cha_dC = ntc::calc_temp_from_ads_raw_dC(
         g_sample_next.rawChamber,
         ntc::kNtc10k_Chamber_Table,
@@ -156,18 +217,115 @@ void sample_temperatures() {
         VREF_MV,
         RFIXED_CHA_OHM,
         NTC_TO_GND);
+#endif
 
     g_sample_next.tempChamberC =
         (g_sample_next.cha_dC == ntc::TEMP_INVALID_DC)
             ? NAN
             : (g_sample_next.cha_dC / 10.0f);
 
-    g_sample_next.adsOk = g_sample.adsOk;
-    g_sample = g_sample_next;
+    g_sample_next.hotFilt_dC =
+        g_hotFilter.update(g_sample_next.hotValid ? g_sample_next.hot_dC : ntc::TEMP_INVALID_DC);
+    g_sample_next.chaFilt_dC = g_chaFilter.update(g_sample_next.cha_dC);
+
+    const uint8_t hotFaults = g_hotFault.update(g_sample_next.rawHotspot, g_sample_next.hot_mV,
+                                                g_sample_next.hotValid ? g_sample_next.hot_dC : ntc::TEMP_INVALID_DC,
+                                                g_sample_next.hotFilt_dC);
+    const uint8_t chaFaults = g_chaFault.update(g_sample_next.rawChamber, g_sample_next.cha_mV,
+                                                g_sample_next.cha_dC, g_sample_next.chaFilt_dC);
+    g_sample_next.sensorFaults =
+        ntc::pack_sensor_faults(hotFaults, chaFaults, g_pairCheck.update(g_sample_next.hotFilt_dC, g_sample_next.chaFilt_dC));
+
+    g_sample_next.adsOk = true;
+    g_seq = (g_seq == 0xFFFF) ? 1 : static_cast<uint16_t>(g_seq + 1);
+    g_sample_next.seq = g_seq;
+    g_sample_next.sampleMs = millis();
+    g_published.write(g_sample_next);
+}
+
+void sample_temperatures() {
+    if (!g_adsOk || g_task != nullptr) {
+        return;
+    }
+
+    // Blocking fallback without the task: poll one full round.
+    static bool started = false;
+    if (!started) {
+        started = g_adc.begin();
+    }
+    const uint32_t rounds = g_adc.roundCount();
+    for (uint8_t i = 0; i < 3 * Ads1115Async::kChannels && g_adc.roundCount() == rounds; ++i) {
+        delayMicroseconds(g_adc.conversionUs());
+        if (!g_adc.poll()) {
+            g_adc.onTimeout();
+        }
+    }
+    if (g_adc.roundCount() != rounds) {
+        publish_round();
+    }
+}
+
+static void IRAM_ATTR ads_rdy_isr() {
+    TaskHandle_t task = g_rdyTask;
+    if (task == nullptr) {
+        return;
+    }
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void sampling_task(void *arg) {
+    (void)arg;
+    g_rdyTask = xTaskGetCurrentTaskHandle();
+    attachInterrupt(digitalPinToInterrupt(PIN_ADS_ALERT_RDY), ads_rdy_isr, FALLING);
+
+    const TickType_t timeoutTicks = pdMS_TO_TICKS((g_adc.timeoutUs() + 999) / 1000) + 1;
+    if (!g_adc.begin()) {
+        CLIENT_ERR("[NTC] ADS1115 start failed, retrying on timeout\n");
+    }
+    for (;;) {
+        const bool roundDone = (ulTaskNotifyTake(pdTRUE, timeoutTicks) > 0) ? g_adc.onReady() : g_adc.onTimeout();
+        if (roundDone) {
+            publish_round();
+        }
+    }
+}
+
+bool start_sampling() {
+    if (g_task != nullptr) {
+        return true;
+    }
+    if (!g_adsOk) {
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(sampling_task, "ntc_sample", kSampleTaskStack, nullptr, kSampleTaskPriority,
+                                &g_task, kSampleTaskCore) != pdPASS) {
+        g_task = nullptr;
+        CLIENT_ERR("[NTC] sampling task could not be created\n");
+        return false;
+    }
+    CLIENT_INFO("[NTC] RDY-driven sampling AIN0..AIN3 on core %d (conversion %lu us)\n", kSampleTaskCore,
+                (unsigned long)g_adc.conversionUs());
+    return true;
 }
 
-const Sample &get_sample() {
-    return g_sample;
+bool sampling_running() {
+    return g_task != nullptr;
+}
+
+Sample get_sample() {
+    return g_published.read();
+}
+
+uint32_t sample_age_ms(const Sample &s) {
+    if (s.seq == 0) {
+        return UINT32_MAX;
+    }
+    return millis() - s.sampleMs;
 }
 
 } // namespace sensor_ntc
@@ -1,4 +1,5 @@
 #include "HostComm.h"
+#include "HostRxTask.h"
 #include "oven_utils.h"
 
 // #warning "HOST BUILD: compiling HostComm.cpp"
@@ -31,7 +32,6 @@ HostComm::HostComm(HardwareSerial &serial)
     : _serial(serial),
       _rx(0),
       _tx(0),
-      _rxBuffer(),
       _localOutputsMask(0) {
     // Initialize remote status with known defaults
     _remoteStatus.outputsMask = 0;
@@ -62,6 +62,10 @@ HostComm::HostComm(HardwareSerial &serial)
 void HostComm::begin(uint32_t baudrate, uint8_t rx, uint8_t tx) {
     _rx = rx;
     _tx = tx;
+    _baseBaud = baudrate;
+    _linkBaud = baudrate;
+    // Room for ~10 ms of RX at the fastest negotiable rate (LVGL stalls).
+    _serial.setRxBufferSize(kLinkRxBufferSize);
     _serial.begin(baudrate, SERIAL_8N1, _rx, _tx);
 }
 
@@ -75,19 +79,39 @@ void HostComm::begin(uint32_t baudrate, uint8_t rx, uint8_t tx) {
  *   }
  *
  * It:
- * - Reads all available bytes from the UART receive buffer
- * - Accumulates characters into _rxBuffer until a '\n' is encountered
- * - Strips '\r' and treats '\n' as end-of-line marker
+ * - Reads all available bytes from the UART receive buffer in blocks
+ * - Splits them into binary frames and '\n'-terminated lines (LineAssembler)
  * - For each complete line, calls handleIncomingLine()
  *
+ * With an RX task attached (setRxTask), the UART is not touched here;
+ * the events parsed by the task are applied instead (applyRxEvent()).
+ *
  * The implementation is fully non-blocking and uses no delays,
  * so it is safe to run alongside LVGL or any real-time GUI loop.
  */
 void HostComm::loop() {
-    while (_serial.available() > 0) {
-        const char c = static_cast<char>(_serial.read());
-        handleRxByte(c);
+    if (_rxTask && _rxTask->running()) {
+        // Lines/frames were already assembled and parsed on the RX task.
+        HostRxEvent ev;
+        while (_rxTask->pop(ev)) {
+            applyRxEvent(ev);
+        }
+    } else {
+        uint8_t block[kRxReadBlockLen];
+        int avail;
+        while ((avail = _serial.available()) > 0) {
+            const size_t n = _serial.read(block, (size_t)avail < sizeof(block) ? (size_t)avail : sizeof(block));
+            if (n == 0) {
+                break;
+            }
+            processRxBytes(block, n);
+        }
     }
+
+    commandWindowTick();
+    binaryNegotiationTick();
+    baudNegotiationTick();
+    statusSubscriptionTick();
 }
 
 /**
@@ -108,9 +132,10 @@ void HostComm::setOutputsMask(uint16_t mask) {
     _localOutputsMask = mask;
     _lastSetAcked = false; // wait for a fresh ACK from the client
 
-    // Build protocol message: H;SET;<mask>\r\n
-    String msg = ProtocolCodec::buildHostSet(mask);
-    _serial.print(msg);
+    // Build protocol message: H;SET;<mask>[;#<seq>]\r\n
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostSet);
+    msg.mask = mask;
+    sendCommand(msg);
 }
 
 /**
@@ -127,8 +152,7 @@ void HostComm::setOutputsMask(uint16_t mask) {
  */
 void HostComm::requestStatus() {
     _newStatus = false; // reset stale flag
-    String msg = ProtocolCodec::buildHostGetStatus();
-    _serial.print(msg);
+    sendMessage(makeMessage(ProtocolMessageType::HostGetStatus));
 }
 
 /**
@@ -143,17 +167,18 @@ void HostComm::requestStatus() {
  * This is optional but can be used to check if the link is alive.
  */
 void HostComm::sendPing() {
-    String msg = ProtocolCodec::buildHostPing();
+    char buf[ProtocolCodec::kMaxFrameLen];
+    const size_t len = encodeMessage(makeMessage(ProtocolMessageType::HostPing), buf, sizeof(buf));
     static uint32_t n = 0;
     ++n;
-    HOST_DBG("[HostComm] TX(#%lu): %s", n, msg.c_str()); // contains \r\n already
+    HOST_DBG("[HostComm] TX(#%lu): PING (%s)\n", n, _binaryActive ? "BIN" : "ASCII");
     // HEX dump (damit wir 100% sehen was wirklich gesendet wird)
     HOST_RAW("[HostComm] TX HEX:");
-    for (size_t i = 0; i < msg.length(); ++i) {
-        HOST_RAW(" %02x", (uint8_t)msg[i]);
+    for (size_t i = 0; i < len; ++i) {
+        HOST_RAW(" %02x", (uint8_t)buf[i]);
     }
     HOST_RAW("\n");
-    _serial.print(msg);
+    sendFrame(buf, len);
     _serial.flush(); // for debugging only
 }
 
@@ -188,7 +213,8 @@ uint16_t HostComm::getRemoteOutputsMask() const {
  * The ProtocolStatus struct contains:
  * - outputsMask: digital state of all 16 channels
  * - adcRaw[0..3]: raw ADC values for CH12..CH15
- * - tempRaw: temperature in 0.25°C units
+ * - tempHotspot_dC / tempChamber_dC: temperatures in 0.1°C
+ * - sampleSeq / sampleAgeMs: sample counter and age (0 = not sent)
  *
  * Note: you should only read this after checking hasNewStatus()
  * and/or after knowing a STATUS frame was recently received.
@@ -199,6 +225,21 @@ const ProtocolStatus &HostComm::getRemoteStatus() const {
     return _remoteStatus;
 }
 
+/**
+ * @brief Age of the remote sensor sample as seen now.
+ *
+ * The client reports how old its cached ADS1115 sample was when it built the
+ * STATUS frame; the time since the frame arrived is added here.
+ *
+ * @return age in ms, UINT32_MAX if the last STATUS carried no sample fields.
+ */
+uint32_t HostComm::remoteSampleAgeMs() const {
+    if (_remoteStatus.sampleSeq == 0) {
+        return UINT32_MAX;
+    }
+    return _remoteStatus.sampleAgeMs + (millis() - _lastStatusMs);
+}
+
 /**
  * @brief Check whether a new STATUS frame has been received.
  *
@@ -275,28 +316,25 @@ void HostComm::clearCommErrorFlag() {
  * @brief Handle one complete, CR/LF-stripped protocol line.
  *
  * This function:
- * - Uses ProtocolCodec::parseLine to decode the message.
+ * - Uses ProtocolCodec::parseFrame to decode the message (no heap use).
  * - Updates flags and remote status according to the message type.
  *
  * It is intentionally kept small and focused on state handling;
  * all string parsing and formatting is delegated to ProtocolCodec.
  *
  * @param line A single complete protocol line, without trailing \r or \n.
-// //  */
-void HostComm::handleIncomingLine(const String &line) {
-    ProtocolMessageType type;
-    ProtocolStatus statusTmp;
-    uint16_t mask = 0;
-    int errorCode = 0;
-    uint16_t maskB = 0;
-    uint16_t maskC = 0;
-
-    const bool ok = ProtocolCodec::parseLine(line, type, statusTmp, mask, errorCode, maskB, maskC);
+ * @param len  Length of the line (the view is not NUL-terminated).
+ */
+void HostComm::handleIncomingLine(const char *line, size_t len) {
+    // Zero-allocation parse directly over the line view.
+    ProtocolMessage msg;
+    const bool ok = ProtocolCodec::parseFrame(line, len, msg);
     if (!ok) {
         _parseFailCount++;
-        _lastBadLine = line;
-        HOST_WARN("[HostComm] parse failed for line='%s' (failCount=%lu)\n",
-                  line.c_str(), (unsigned long)_parseFailCount);
+        setLastBadLine(line, len);
+        noteLinkError();
+        HOST_WARN("[HostComm] parse failed for line='%.*s' (failCount=%lu)\n",
+                  (int)len, line, (unsigned long)_parseFailCount);
 
         // IMPORTANT:
         // Before we have a stable link, ignore junk (boot noise, partial frames, etc.)
@@ -307,11 +345,97 @@ void HostComm::handleIncomingLine(const String &line) {
         return;
     }
 
+    handleMessage(msg);
+}
+
+/**
+ * @brief Handle one complete binary frame collected by _binRx.
+ *
+ * CRC/COBS failures are treated exactly like ASCII parse failures.
+ */
+void HostComm::handleBinaryFrame() {
+    ProtocolMessage msg;
+    if (!ProtocolBinCodec::decode(_binRx.block(), _binRx.blockLen(), msg)) {
+        _binErrorCount++;
+        _parseFailCount++;
+        noteLinkError();
+        HOST_WARN("[HostComm] binary frame rejected (len=%u, binErrors=%lu)\n",
+                  (unsigned)_binRx.blockLen(), (unsigned long)_binErrorCount);
+        if (_linkSynced) {
+            _commError = true;
+        }
+        return;
+    }
+
+    _binFrameCount++;
+    handleMessage(msg);
+}
+
+/**
+ * @brief Apply one event from the RX task.
+ *
+ * Mirrors handleRxByte()/processCompletedLine()/handleIncomingLine()/
+ * handleBinaryFrame(), so all counters and flags behave as with inline RX.
+ */
+void HostComm::applyRxEvent(const HostRxEvent &ev) {
+    switch (ev.kind) {
+    case HostRxEvent::Kind::Frame:
+        if (ev.binary) {
+            _binFrameCount++;
+        }
+        handleMessage(ev.msg);
+        return;
+    case HostRxEvent::Kind::ParseError:
+    case HostRxEvent::Kind::JunkLine:
+        _parseFailCount++;
+        setLastBadLine(ev.text, strlen(ev.text));
+        noteLinkError();
+        HOST_WARN("[HostComm] RX %s: '%s' (failCount=%lu)\n",
+                  ev.kind == HostRxEvent::Kind::JunkLine ? "junk line ignored" : "parse failed",
+                  ev.text, (unsigned long)_parseFailCount);
+        if (ev.kind == HostRxEvent::Kind::ParseError && _linkSynced) {
+            _commError = true;
+        }
+        return;
+    case HostRxEvent::Kind::LineOverflow:
+        HOST_WARN("[HostComm] RX line overflow, dropping\n");
+        noteLinkError();
+        return;
+    case HostRxEvent::Kind::BinError:
+        _binErrorCount++;
+        _parseFailCount++;
+        noteLinkError();
+        HOST_WARN("[HostComm] binary frame rejected (binErrors=%lu)\n", (unsigned long)_binErrorCount);
+        if (_linkSynced) {
+            _commError = true;
+        }
+        return;
+    case HostRxEvent::Kind::BinOverflow:
+        _binErrorCount++;
+        noteLinkError();
+        HOST_WARN("[HostComm] RX binary frame overflow, dropping\n");
+        return;
+    }
+}
+
+/**
+ * @brief Apply one decoded message (ASCII or binary) to the host state.
+ */
+void HostComm::handleMessage(const ProtocolMessage &msg) {
+    const ProtocolMessageType type = msg.type;
+    const ProtocolStatus &statusTmp = msg.status;
+    const uint16_t mask = msg.mask;
+
+    noteLinkFrame();
+
     switch (type) {
     case ProtocolMessageType::ClientAckSet:
         HOST_DBG("ACK SET received, mask=0x%04X (%10s)\n", mask, oven_outputs_mask_to_str(mask));
         _lastSetAcked = true;
         _remoteStatus.outputsMask = mask;
+        if (msg.seq != 0) {
+            matchCommandAck(msg.seq);
+        }
         //        _lastRxAnyMs = millis();
         break;
 
@@ -319,17 +443,40 @@ void HostComm::handleIncomingLine(const String &line) {
         HOST_DBG("ACK UPD received, mask=0x%04X (%10s)\n", mask, oven_outputs_mask_to_str(mask));
         _remoteStatus.outputsMask = mask;
         _lastUpdAcked = true;
+        if (msg.seq != 0) {
+            matchCommandAck(msg.seq);
+        }
         // _lastRxAnyMs = millis();
         break;
 
     case ProtocolMessageType::ClientAckTog:
         HOST_DBG("ACK TOG received, mask=0x%04X (%10s)\n", mask, oven_outputs_mask_to_str(mask));
         _remoteStatus.outputsMask = mask;
-        // _lastTogAcked = true;
+        _lastTogAcked = true;
+        if (msg.seq != 0) {
+            matchCommandAck(msg.seq);
+        }
+        break;
+
+    case ProtocolMessageType::ClientAckAct:
+        // ACK and STATUS in one frame: the STATUS part counts as a status
+        // reply (and as subscription traffic).
+        _lastSetAcked = true;
+        _lastUpdAcked = true;
+        _remoteStatus = statusTmp;
+        _newStatus = true;
+        _lastStatusMs = millis();
+        _subLastRxMs = _lastStatusMs;
+        _statusFrameCount++;
+        if (msg.seq != 0) {
+            matchCommandAck(msg.seq);
+        }
+        HOST_DBG("ACK ACT received, ack=0x%04X mask=0x%04X (%10s) tempChamber_dC=%d\n", mask,
+                 statusTmp.outputsMask, oven_outputs_mask_to_str(statusTmp.outputsMask), statusTmp.tempChamber_dC);
         break;
 
     case ProtocolMessageType::ClientErrSet:
-        HOST_ERR("ERR SET received, code=%d\n", errorCode);
+        HOST_ERR("ERR SET received, code=%d\n", (int)msg.errorCode);
         _commError = true; // THIS is a real protocol-level error
         // _lastRxAnyMs = millis();
         break;
@@ -338,6 +485,8 @@ void HostComm::handleIncomingLine(const String &line) {
         _remoteStatus = statusTmp;
         _newStatus = true;
         _lastStatusMs = millis();
+        _subLastRxMs = _lastStatusMs;
+        _statusFrameCount++;
         // _lastRxAnyMs = millis();
         HOST_INFO("STATUS received, mask=0x%04X (%10s), adc=[%u,%u,%u,%u] tempChamber_dC=%d\n",
                   statusTmp.outputsMask,
@@ -356,16 +505,37 @@ void HostComm::handleIncomingLine(const String &line) {
         if (_pongStreak >= 2) {
             _linkSynced = true;
         }
+        if (_baudState == BaudState::Verifying) {
+            // Verification ping answered at the new rate: keep it.
+            _baudState = BaudState::Raised;
+            _rateStats[_baudCandidate].upgrades++;
+            HOST_INFO("[HostComm] link rate %lu baud verified\n", (unsigned long)_linkBaud);
+        }
         // _lastRxAnyMs = millis();
         break;
 
     case ProtocolMessageType::ClientRst:
         HOST_WARN("RST received from client\n");
-        _linkSynced = false;
-        _pongStreak = 0;
+        clearLinkSync();
         // _lastRxAnyMs = millis();
         break;
 
+    case ProtocolMessageType::ClientAckBin:
+        _binaryActive = _binaryWanted && (mask == static_cast<uint16_t>(ProtocolLinkMode::CobsCrc16));
+        HOST_INFO("[HostComm] link mode ACK=0x%04X -> %s\n", mask, _binaryActive ? "BINARY" : "ASCII");
+        break;
+
+    case ProtocolMessageType::ClientAckBaud:
+        handleBaudAck(mask);
+        break;
+
+    case ProtocolMessageType::ClientAckSub:
+        _subAckPeriodMs = mask;
+        _subActive = (_subPeriodMs != 0) && (mask != 0);
+        _subLastRxMs = millis();
+        HOST_INFO("[HostComm] STATUS subscription ACK period=%ums -> %s\n", mask, _subActive ? "PUSH" : "POLL");
+        break;
+
     default:
         HOST_ERR("Unexpected message type=%u\n", (unsigned)type);
         _commError = true; // parse was OK but message is invalid for host
@@ -376,18 +546,503 @@ void HostComm::handleIncomingLine(const String &line) {
 }
 
 void HostComm::sendRst() {
-    String msg = ProtocolCodec::buildHostRst();
-    _serial.print(msg);
+    sendMessage(makeMessage(ProtocolMessageType::HostRst));
+}
+
+bool HostComm::updOutputs(uint16_t setMask, uint16_t clrMask) {
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostUpd);
+    msg.mask = setMask;
+    msg.maskB = clrMask;
+    return sendCommand(msg);
+}
+
+bool HostComm::togOutputs(uint16_t togMask) {
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostTog);
+    msg.mask = togMask;
+    return sendCommand(msg);
+}
+
+/**
+ * @brief Send H;ACT (UPD semantics) and get ACK + STATUS in one reply.
+ *
+ * Saves the separate H;GET;STATUS round trip after a command.
+ */
+bool HostComm::actuateAndReport(uint16_t setMask, uint16_t clrMask) {
+    _lastSetAcked = false; // wait for the combined reply
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostAct);
+    msg.mask = setMask;
+    msg.maskB = clrMask;
+    return sendCommand(msg);
+}
+
+void HostComm::setOutputsMaskAndReport(uint16_t mask) {
+    _localOutputsMask = mask;
+    actuateAndReport(mask, static_cast<uint16_t>(~mask));
+}
+
+ProtocolMessage HostComm::makeMessage(ProtocolMessageType type) {
+    ProtocolMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = type;
+    return msg;
+}
+
+/**
+ * @brief Encode a message in the currently active link mode.
+ *
+ * Link mode requests (H;BIN) are always sent as ASCII so a client that
+ * fell back (or never supported binary) can still answer them.
+ */
+size_t HostComm::encodeMessage(const ProtocolMessage &msg, char *buf, size_t cap) const {
+    if (_binaryActive && msg.type != ProtocolMessageType::HostBin) {
+        return ProtocolBinCodec::encode(msg, reinterpret_cast<uint8_t *>(buf), cap);
+    }
+    return ProtocolCodec::buildFrame(buf, cap, msg);
+}
+
+void HostComm::sendMessage(const ProtocolMessage &msg) {
+    char buf[ProtocolCodec::kMaxFrameLen];
+    sendFrame(buf, encodeMessage(msg, buf, sizeof(buf)));
+}
+
+/**
+ * @brief Send one pre-built frame with a single UART write.
+ *
+ * A length of 0 (builder overflow) sends nothing.
+ */
+void HostComm::sendFrame(const char *frame, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    _txBytes += len;
+    _serial.write(reinterpret_cast<const uint8_t *>(frame), len);
+}
+
+// -----------------------------------------------------------------------------
+// Binary link mode (COBS + CRC16), negotiated after linkSynced()
+// -----------------------------------------------------------------------------
+void HostComm::setBinaryModeEnabled(bool enabled) {
+    if (_binaryWanted == enabled) {
+        return;
+    }
+    _binaryWanted = enabled;
+    _binaryAttempts = 0;
+    _binaryGaveUp = false;
+
+    if (!enabled && _binaryActive) {
+        // Tell the client to go back to ASCII; we switch immediately since
+        // the client decodes both encodings anyway.
+        _binaryActive = false;
+        ProtocolMessage msg = makeMessage(ProtocolMessageType::HostBin);
+        msg.mask = static_cast<uint16_t>(ProtocolLinkMode::Ascii);
+        sendMessage(msg);
+    }
+}
+
+void HostComm::binaryNegotiationTick() {
+    if (!_binaryWanted || _binaryActive || !_linkSynced || _binaryGaveUp) {
+        return;
+    }
+
+    const uint32_t now = millis();
+    if (_binaryAttempts > 0 && (now - _binaryLastReqMs) < kBinNegotiationRetryMs) {
+        return;
+    }
+
+    if (_binaryAttempts >= kBinNegotiationAttempts) {
+        _binaryGaveUp = true;
+        HOST_WARN("[HostComm] binary link negotiation failed -> staying on ASCII\n");
+        return;
+    }
+
+    _binaryAttempts++;
+    _binaryLastReqMs = now;
+
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostBin);
+    msg.mask = static_cast<uint16_t>(ProtocolLinkMode::CobsCrc16);
+    sendMessage(msg);
+}
+
+// -----------------------------------------------------------------------------
+// Link baud rate negotiation (H;BAUD)
+// -----------------------------------------------------------------------------
+void HostComm::setLinkBaudTarget(uint32_t baud) {
+    _baudTarget = baud;
+    _baudFailedMask = 0;
+}
+
+float HostComm::linkErrorRate(uint32_t baud) const {
+    const int8_t idx = ProtocolLinkBaud::indexOf(baud);
+    if (idx < 0) {
+        return 0.0f;
+    }
+    const LinkRateStats &st = _rateStats[idx];
+    const uint32_t total = st.rxFrames + st.rxErrors;
+    return (total == 0) ? 0.0f : static_cast<float>(st.rxErrors) / static_cast<float>(total);
+}
+
+void HostComm::noteLinkFrame() {
+    const int8_t idx = ProtocolLinkBaud::indexOf(_linkBaud);
+    if (idx >= 0) {
+        _rateStats[idx].rxFrames++;
+    }
+    _baudErrorBurst = 0;
+    _baudLastGoodMs = millis();
+}
+
+void HostComm::noteLinkError() {
+    const int8_t idx = ProtocolLinkBaud::indexOf(_linkBaud);
+    if (idx >= 0) {
+        _rateStats[idx].rxErrors++;
+    }
+    if (_baudErrorBurst < 255) {
+        _baudErrorBurst++;
+    }
+}
+
+void HostComm::switchLinkBaud(uint32_t baud) {
+    _serial.flush(); // pending TX still goes out at the old rate
+    _serial.updateBaudRate(baud);
+    _linkBaud = baud;
+    _lines.reset();
+    _binRx.reset();
+    if (_rxTask) {
+        _rxTask->requestDecoderReset();
+    }
+    _baudErrorBurst = 0;
+    _baudLastGoodMs = millis();
 }
 
-void HostComm::updOutputs(uint16_t setMask, uint16_t clrMask) {
-    String msg = ProtocolCodec::buildHostUpd(setMask, clrMask);
-    _serial.print(msg);
+void HostComm::sendBaudProposal() {
+    _baudAttempts++;
+    _baudStateMs = millis();
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostBaud);
+    msg.mask = ProtocolLinkBaud::toField(ProtocolLinkBaud::kRates[_baudCandidate]);
+    sendMessage(msg);
 }
 
-void HostComm::togOutputs(uint16_t togMask) {
-    String msg = ProtocolCodec::buildHostTog(togMask);
-    _serial.print(msg);
+void HostComm::handleBaudAck(uint16_t rateField) {
+    if (_baudState != BaudState::Proposed) {
+        return; // late answer to a retried proposal
+    }
+    const uint32_t rate = ProtocolLinkBaud::kRates[_baudCandidate];
+    if (ProtocolLinkBaud::fromField(rateField) != rate) {
+        // Client stays where it is: do not propose this rate again.
+        _baudFailedMask |= static_cast<uint8_t>(1u << _baudCandidate);
+        _baudState = BaudState::Base;
+        HOST_WARN("[HostComm] client refused %lu baud\n", (unsigned long)rate);
+        return;
+    }
+
+    switchLinkBaud(rate);
+    _baudState = BaudState::Verifying;
+    _baudStateMs = millis();
+    _baudLastPingMs = _baudStateMs;
+    HOST_INFO("[HostComm] link rate -> %lu baud, verifying\n", (unsigned long)rate);
+    sendPing();
+}
+
+/**
+ * @brief Back to the session base rate; the link has to re-sync there.
+ *
+ * The rate that failed is not proposed again, so the next attempt uses the
+ * next lower one.
+ */
+void HostComm::baudFallback(const char *why) {
+    (void)why;
+    const int8_t idx = ProtocolLinkBaud::indexOf(_linkBaud);
+    if (idx >= 0) {
+        _rateStats[idx].fallbacks++;
+        _baudFailedMask |= static_cast<uint8_t>(1u << idx);
+    }
+    _baudFallbacks++;
+    HOST_WARN("[HostComm] link rate %lu baud failed (%s) -> %lu baud\n", (unsigned long)_linkBaud, why,
+              (unsigned long)_baseBaud);
+
+    switchLinkBaud(_baseBaud);
+    _baudState = BaudState::Base;
+    clearLinkSync();
+}
+
+void HostComm::baudNegotiationTick() {
+    const uint32_t now = millis();
+
+    switch (_baudState) {
+    case BaudState::Raised:
+        if (_baudErrorBurst >= kBaudErrorBurst) {
+            baudFallback("parse errors");
+        } else if ((now - _baudLastGoodMs) >= kBaudRxTimeoutMs) {
+            noteLinkError(); // silence counts as one error for this rate
+            baudFallback("timeout");
+        }
+        return;
+
+    case BaudState::Verifying:
+        if (_baudErrorBurst >= kBaudErrorBurst) {
+            baudFallback("verification");
+        } else if ((now - _baudStateMs) >= kBaudVerifyMs) {
+            noteLinkError();
+            baudFallback("verification timeout");
+        } else if ((now - _baudLastPingMs) >= kBaudVerifyPingMs) {
+            _baudLastPingMs = now;
+            sendPing();
+        }
+        return;
+
+    case BaudState::Proposed:
+        if ((now - _baudStateMs) < kBaudProposeRetryMs) {
+            return;
+        }
+        if (_baudAttempts >= kBaudProposeAttempts) {
+            _baudFailedMask |= static_cast<uint8_t>(1u << _baudCandidate);
+            _baudState = BaudState::Base;
+            HOST_WARN("[HostComm] no answer to H;BAUD -> staying at %lu baud\n", (unsigned long)_linkBaud);
+            return;
+        }
+        sendBaudProposal();
+        return;
+
+    case BaudState::Base:
+    default:
+        break;
+    }
+
+    // One negotiation at a time: wait until the link mode is settled.
+    if (_baudTarget <= _baseBaud || !_linkSynced || (_binaryWanted && !_binaryActive && !_binaryGaveUp)) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < ProtocolLinkBaud::kRateCount; ++i) {
+        const uint32_t rate = ProtocolLinkBaud::kRates[i];
+        if (rate <= _baudTarget && rate > _baseBaud && (_baudFailedMask & (1u << i)) == 0) {
+            _baudCandidate = i;
+            _baudAttempts = 0;
+            _baudState = BaudState::Proposed;
+            sendBaudProposal();
+            return;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Pipelined commands: sequence numbers, in-flight window, retransmits
+// -----------------------------------------------------------------------------
+void HostComm::setCommandWindow(uint8_t window) {
+    if (window > kMaxCommandWindow) {
+        window = kMaxCommandWindow;
+    }
+    if (window == 0) {
+        // Back to lockstep: forget sequenced commands still pending.
+        dropPendingCommands();
+    }
+    _cmdWindow = window;
+    transmitQueuedCommands();
+}
+
+/**
+ * @brief Send SET/UPD/TOG/ACT either directly (window 0) or through the window.
+ *
+ * A full queue drops a relative command (returns false). An absolute one
+ * (SET, or ACT with every bit set or cleared) does not depend on what is
+ * queued before it: it replaces the queued commands. Their numbers are never
+ * sent; the client applies an absolute command ahead of such a gap.
+ */
+bool HostComm::sendCommand(ProtocolMessage msg) {
+    if (_cmdWindow == 0) {
+        sendMessage(msg);
+        return true;
+    }
+
+    _cmdSent++;
+    if (_cmdQueueCount >= kCmdQueueLen) {
+        const bool absolute = msg.type == ProtocolMessageType::HostSet ||
+                              (msg.type == ProtocolMessageType::HostAct &&
+                               static_cast<uint16_t>(msg.mask | msg.maskB) == 0xFFFF);
+        if (!absolute) {
+            _cmdDropped++;
+            HOST_WARN("[HostComm] command queue full, dropping type=%u (dropped=%lu)\n",
+                      (unsigned)msg.type, (unsigned long)_cmdDropped);
+            return false;
+        }
+        _cmdSuperseded += _cmdQueueCount;
+        HOST_WARN("[HostComm] command queue full, type=%u supersedes %u queued\n", (unsigned)msg.type,
+                  (unsigned)_cmdQueueCount);
+        _cmdQueueHead = 0;
+        _cmdQueueCount = 0;
+    }
+
+    if (_seqResync) {
+        // A number was given up on: jump past the client's tracking span so
+        // it resynchronizes instead of waiting for the gap.
+        _nextSeq = ProtocolSeq::advance(_nextSeq, ProtocolSeq::kTrackSpan);
+        _seqResync = false;
+    }
+    msg.seq = _nextSeq;
+    _nextSeq = ProtocolSeq::advance(_nextSeq, 1);
+
+    _cmdQueue[(_cmdQueueHead + _cmdQueueCount) % kCmdQueueLen] = msg;
+    _cmdQueueCount++;
+    transmitQueuedCommands();
+    return true;
+}
+
+// Move queued commands into free window slots (in FIFO order) and send them.
+void HostComm::transmitQueuedCommands() {
+    while (_cmdQueueCount > 0 && _inFlightCount < _cmdWindow) {
+        InFlightCommand &e = _inFlight[(_inFlightHead + _inFlightCount) % kMaxCommandWindow];
+        e.msg = _cmdQueue[_cmdQueueHead];
+        e.sentMs = millis();
+        e.retries = 0;
+        e.acked = false;
+        _inFlightCount++;
+
+        _cmdQueueHead = static_cast<uint8_t>((_cmdQueueHead + 1) % kCmdQueueLen);
+        _cmdQueueCount--;
+
+        sendMessage(e.msg);
+    }
+}
+
+/**
+ * @brief Retire the in-flight command with sequence number `seq`.
+ *
+ * ACKs may arrive in any order; the window only slides once the oldest
+ * command is done.
+ */
+void HostComm::matchCommandAck(uint8_t seq) {
+    bool found = false;
+    for (uint8_t i = 0; i < _inFlightCount; ++i) {
+        InFlightCommand &e = _inFlight[(_inFlightHead + i) % kMaxCommandWindow];
+        if (!e.acked && e.msg.seq == seq) {
+            e.acked = true;
+            _cmdAcked++;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        // Late ACK of a retransmitted command or of a dropped session.
+        _cmdDupAcks++;
+    }
+
+    while (_inFlightCount > 0 && _inFlight[_inFlightHead].acked) {
+        _inFlightHead = static_cast<uint8_t>((_inFlightHead + 1) % kMaxCommandWindow);
+        _inFlightCount--;
+    }
+    transmitQueuedCommands();
+}
+
+void HostComm::commandWindowTick() {
+    if (_inFlightCount == 0) {
+        return;
+    }
+
+    const uint32_t now = millis();
+    for (uint8_t i = 0; i < _inFlightCount; ++i) {
+        InFlightCommand &e = _inFlight[(_inFlightHead + i) % kMaxCommandWindow];
+        if (e.acked || (now - e.sentMs) < kCmdRetransmitMs) {
+            continue;
+        }
+
+        if (e.retries >= kCmdMaxRetries) {
+            // Give up on this command; it is accounted as failed.
+            e.acked = true;
+            _cmdFailed++;
+            _commError = true;
+            _seqResync = true;
+            HOST_WARN("[HostComm] command seq=%u type=%u not acknowledged -> failed\n",
+                      (unsigned)e.msg.seq, (unsigned)e.msg.type);
+            continue;
+        }
+
+        e.retries++;
+        e.sentMs = now;
+        _cmdRetransmits++;
+        sendMessage(e.msg);
+    }
+
+    while (_inFlightCount > 0 && _inFlight[_inFlightHead].acked) {
+        _inFlightHead = static_cast<uint8_t>((_inFlightHead + 1) % kMaxCommandWindow);
+        _inFlightCount--;
+    }
+    transmitQueuedCommands();
+}
+
+void HostComm::dropPendingCommands() {
+    for (uint8_t i = 0; i < _inFlightCount; ++i) {
+        if (!_inFlight[(_inFlightHead + i) % kMaxCommandWindow].acked) {
+            _cmdDropped++;
+            _seqResync = true;
+        }
+    }
+    _cmdDropped += _cmdQueueCount;
+    _seqResync = _seqResync || _cmdQueueCount > 0;
+    _inFlightHead = 0;
+    _inFlightCount = 0;
+    _cmdQueueHead = 0;
+    _cmdQueueCount = 0;
+}
+
+// -----------------------------------------------------------------------------
+// STATUS push subscription (H;SUB), renewed after linkSynced()
+// -----------------------------------------------------------------------------
+void HostComm::setStatusSubscription(uint16_t periodMs, uint16_t triggers) {
+    if (_subPeriodMs == periodMs && _subTriggers == triggers) {
+        return;
+    }
+    const bool wasActive = _subActive;
+    _subPeriodMs = periodMs;
+    _subTriggers = triggers;
+    resetStatusSubscription();
+
+    if (periodMs == 0 && wasActive) {
+        ProtocolMessage msg = makeMessage(ProtocolMessageType::HostSub);
+        sendMessage(msg);
+    }
+}
+
+void HostComm::resetStatusSubscription() {
+    _subActive = false;
+    _subGaveUp = false;
+    _subAttempts = 0;
+    _subAckPeriodMs = 0;
+}
+
+void HostComm::statusSubscriptionTick() {
+    if (_subPeriodMs == 0 || !_linkSynced || _subGaveUp) {
+        return;
+    }
+
+    const uint32_t now = millis();
+
+    if (_subActive) {
+        // Pushes stopped (e.g. client rebooted): renew the subscription.
+        const uint32_t staleMs = static_cast<uint32_t>(_subAckPeriodMs) * kSubStaleFactor;
+        if ((now - _subLastRxMs) < staleMs) {
+            return;
+        }
+        HOST_WARN("[HostComm] no STATUS push for %lums -> renewing subscription\n",
+                  (unsigned long)(now - _subLastRxMs));
+        resetStatusSubscription();
+    }
+
+    if (_subAttempts > 0 && (now - _subLastReqMs) < kSubRetryMs) {
+        return;
+    }
+
+    if (_subAttempts >= kSubAttempts) {
+        _subGaveUp = true;
+        HOST_WARN("[HostComm] STATUS subscription not acknowledged -> polling\n");
+        return;
+    }
+
+    _subAttempts++;
+    _subLastReqMs = now;
+
+    ProtocolMessage msg = makeMessage(ProtocolMessageType::HostSub);
+    msg.mask = _subPeriodMs;
+    msg.maskB = _subTriggers;
+    sendMessage(msg);
 }
 
 // In HostComm.cpp:
@@ -407,6 +1062,23 @@ bool HostComm::linkSynced() const { return _linkSynced; }
 void HostComm::clearLinkSync() {
     _linkSynced = false;
     _pongStreak = 0;
+
+    // A new sync session renegotiates the link mode from ASCII.
+    _binaryActive = false;
+    _binaryAttempts = 0;
+    _binaryGaveUp = false;
+    _binRx.reset();
+
+    // The client drops its subscription on RST / watchdog timeout.
+    resetStatusSubscription();
+
+    // Commands of the lost session are not retransmitted into the next one.
+    dropPendingCommands();
+    // An unanswered rate proposal is retried after the next sync. A raised
+    // or verifying rate is supervised by baudNegotiationTick() instead.
+    if (_baudState == BaudState::Proposed) {
+        _baudState = BaudState::Base;
+    }
 }
 uint8_t HostComm::pongStreak() const { return _pongStreak; }
 
@@ -417,64 +1089,47 @@ void HostComm::clearLastTogAckFlag() { _lastTogAcked = false; }
 
 // --- NEW: shared RX byte handler (used by UART loop + tests) ---
 void HostComm::handleRxByte(char c) {
-    // Ignore CR
-    if (c == '\r') {
-        return;
-    }
-
-    if (c == '\n') {
-        // End of line: process even if empty buffer (we sanitize below)
-        String line = _rxBuffer;
-        _rxBuffer = "";
-        processCompletedLine(line);
-        return;
-    }
-
-    _rxBuffer += c;
-
-    if (_rxBuffer.length() > 120) {
-        HOST_WARN("[HostComm] RX line overflow, dropping\n");
-        _rxBuffer = "";
-        // Optional: set _commError only after link is stable
-        // if (_linkSynced) { _commError = true; }
-    }
+    processRxBytes(reinterpret_cast<const uint8_t *>(&c), 1);
 }
 
 // --- NEW: same sanitize path as loop() should use ---
 void HostComm::processCompletedLine(String line) {
+    processCompletedLine(line.c_str(), line.length());
+}
+
+void HostComm::processCompletedLine(const char *line, size_t len) {
     // 1) trim whitespace
-    line.trim();
-    if (line.isEmpty()) {
+    LineAssembler::trim(line, len);
+    if (len == 0) {
         return; // ignore empty lines
     }
 
     // 2) drop leading junk until we see 'C' or 'H'
-    int start = -1;
-    for (int i = 0; i < (int)line.length(); ++i) {
-        const char ch = line[i];
-        if (ch == 'C' || ch == 'H') {
-            start = i;
-            break;
-        }
-    }
-
-    if (start < 0) {
+    const size_t start = LineAssembler::frameStart(line, len);
+    if (start == len) {
         // treat as junk line (count as fail) but do not hard-fail the link
         _parseFailCount++;
-        _lastBadLine = line;
-        HOST_WARN("[HostComm] RX junk line ignored: '%s' (failCount=%lu)\n",
-                  line.c_str(), (unsigned long)_parseFailCount);
+        setLastBadLine(line, len);
+        noteLinkError();
+        HOST_WARN("[HostComm] RX junk line ignored: '%.*s' (failCount=%lu)\n",
+                  (int)len, line, (unsigned long)_parseFailCount);
         return;
     }
 
     if (start > 0) {
-        HOST_WARN("[HostComm] RX leading junk (%d bytes) removed\n", start);
-        line = line.substring(start);
+        HOST_WARN("[HostComm] RX leading junk (%u bytes) removed\n", (unsigned)start);
     }
 
-    // DBG("[HostComm] RX LINE: '%s'\n", line.c_str());
+    handleIncomingLine(line + start, len - start);
+}
+
+void HostComm::setLastBadLine(const char *line, size_t len) {
+    _lastBadLine = "";
+    _lastBadLine.concat(line, static_cast<unsigned int>(len));
+}
 
-    handleIncomingLine(line);
+uint32_t HostComm::rxBytes() const {
+    return _rxTask ? _rxBytes + _rxTask->rxBytes() : _rxBytes;
 }
 
 // --- NEW: processRxBytes for TC5 (and future RX fragmentation tests) ---
@@ -482,9 +1137,25 @@ void HostComm::processRxBytes(const uint8_t *data, size_t len) {
     if (!data || len == 0) {
         return;
     }
-    for (size_t i = 0; i < len; ++i) {
-        handleRxByte((char)data[i]);
-    }
+    _rxBytes += static_cast<uint32_t>(len);
+
+    // Binary frames are delimited by 0x00, which never occurs in ASCII lines.
+    _lines.feedLink(
+        _binRx, data, len,
+        [this](const char *line, size_t n) { processCompletedLine(line, n); },
+        [this]() {
+            HOST_WARN("[HostComm] RX line overflow, dropping\n");
+            noteLinkError();
+        },
+        [this](ProtocolBinRx::Result r) {
+            if (r == ProtocolBinRx::Result::Frame) {
+                handleBinaryFrame();
+                return;
+            }
+            _binErrorCount++;
+            noteLinkError();
+            HOST_WARN("[HostComm] RX binary frame overflow, dropping\n");
+        });
 }
 
 // END OF FILE
@@ -0,0 +1,211 @@
+#include "HostRxTask.h"
+
+#include "log_host_comm.h"
+#include <string.h>
+
+#if !defined(ARDUINO_ARCH_ESP32)
+#include <chrono>
+#endif
+
+// ============================================================================
+//  HostRxDecoder
+// ============================================================================
+
+void HostRxDecoder::reset() {
+    _lines.reset();
+    _binRx.reset();
+}
+
+void HostRxDecoder::setEvent(HostRxEvent &ev, HostRxEvent::Kind kind, bool binary) {
+    ev.kind = kind;
+    ev.binary = binary;
+    ev.text[0] = '\0';
+}
+
+void HostRxDecoder::setText(HostRxEvent &ev, const char *data, size_t len) {
+    if (len >= HostRxEvent::kTextLen) {
+        len = HostRxEvent::kTextLen - 1;
+    }
+    memcpy(ev.text, data, len);
+    ev.text[len] = '\0';
+}
+
+void HostRxDecoder::binaryEvent(ProtocolBinRx::Result r, HostRxEvent &ev) {
+    if (r == ProtocolBinRx::Result::Overflow) {
+        setEvent(ev, HostRxEvent::Kind::BinOverflow, true);
+        return;
+    }
+    const bool ok = ProtocolBinCodec::decode(_binRx.block(), _binRx.blockLen(), ev.msg);
+    setEvent(ev, ok ? HostRxEvent::Kind::Frame : HostRxEvent::Kind::BinError, true);
+}
+
+bool HostRxDecoder::lineEvent(const char *line, size_t len, HostRxEvent &ev) {
+    LineAssembler::trim(line, len);
+    if (len == 0) {
+        return false; // ignore empty lines
+    }
+
+    const size_t start = LineAssembler::frameStart(line, len);
+    if (start == len) {
+        setEvent(ev, HostRxEvent::Kind::JunkLine, false);
+        setText(ev, line, len);
+        return true;
+    }
+
+    if (ProtocolCodec::parseFrame(line + start, len - start, ev.msg)) {
+        setEvent(ev, HostRxEvent::Kind::Frame, false);
+    } else {
+        setEvent(ev, HostRxEvent::Kind::ParseError, false);
+        setText(ev, line + start, len - start);
+    }
+    return true;
+}
+
+// ============================================================================
+//  HostRxTask
+// ============================================================================
+
+HostRxTask::HostRxTask(HardwareSerial &serial) : _serial(serial) {}
+
+HostRxTask::~HostRxTask() { stop(); }
+
+/**
+ * @brief Read one block from the UART and push the decoded events.
+ *
+ * Runs on the RX task only. Every event needs at least two input bytes
+ * ("x\n", 0x00 x 0x00), so reading at most 2 bytes per free ring slot can
+ * never overflow the ring: while the consumer is busy, unread bytes stay in
+ * the UART driver buffer (HostComm sizes it for that). droppedEvents() is a
+ * safety counter only.
+ */
+size_t HostRxTask::drainOnce() {
+    if (_resetRequested.exchange(false, std::memory_order_acq_rel)) {
+        _decoder.reset();
+    }
+
+    const size_t freeSlots = kQueueLen - _queue.size();
+    if (freeSlots == 0) {
+        return 0;
+    }
+
+    uint8_t block[kReadBlockLen];
+    const int avail = _serial.available();
+    if (avail <= 0) {
+        return 0;
+    }
+    size_t want = (size_t)avail < sizeof(block) ? (size_t)avail : sizeof(block);
+    if (want > freeSlots * 2) {
+        want = freeSlots * 2;
+    }
+    const size_t n = _serial.read(block, want);
+
+    size_t pushed = 0;
+    _decoder.feed(block, n, [this, &pushed](const HostRxEvent &ev) {
+        _events.fetch_add(1, std::memory_order_relaxed);
+        _queue.push(ev);
+        pushed++;
+    });
+    _rxBytes.fetch_add(static_cast<uint32_t>(n), std::memory_order_relaxed);
+    if (pushed > 0 && _wakeCb) {
+        _wakeCb(_wakeCtx);
+    }
+    return n;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+void HostRxTask::taskEntry(void *arg) {
+    static_cast<HostRxTask *>(arg)->run();
+}
+
+void HostRxTask::run() {
+    while (!_stopRequested.load(std::memory_order_acquire)) {
+        // Woken by the UART driver (FIFO threshold / RX timeout); the timeout
+        // covers a missed notification and a full ring (the consumer does
+        // not notify), in which case we poll every tick.
+        const TickType_t wait = _queue.size() >= kQueueLen ? 1 : pdMS_TO_TICKS(kIdleWaitMs);
+        ulTaskNotifyTake(pdTRUE, wait);
+        _wakeups.fetch_add(1, std::memory_order_relaxed);
+        while (drainOnce() > 0) {
+        }
+    }
+    _running.store(false, std::memory_order_release);
+    _handle = nullptr;
+    vTaskDelete(nullptr);
+}
+
+bool HostRxTask::start(int core) {
+    if (running()) {
+        return true;
+    }
+    _stopRequested.store(false, std::memory_order_release);
+    _running.store(true, std::memory_order_release);
+    if (xTaskCreatePinnedToCore(&HostRxTask::taskEntry, "hostRx", kStackSize, this, kPriority,
+                                &_handle, core) != pdPASS) {
+        _running.store(false, std::memory_order_release);
+        _handle = nullptr;
+        HOST_ERR("[HostRxTask] task create failed\n");
+        return false;
+    }
+
+    // HardwareSerial owns the IDF UART driver and its event queue; its
+    // onReceive() hook is called from that driver's event task.
+    _serial.onReceive([this]() {
+        if (_handle) {
+            xTaskNotifyGive(_handle);
+        }
+    });
+    HOST_INFO("[HostRxTask] started on core %d\n", core);
+    return true;
+}
+
+void HostRxTask::stop() {
+    if (!running()) {
+        return;
+    }
+    _serial.onReceive(nullptr);
+    _stopRequested.store(true, std::memory_order_release);
+    if (_handle) {
+        xTaskNotifyGive(_handle);
+    }
+    while (running()) {
+        vTaskDelay(1);
+    }
+}
+
+#else // native: std::thread polling the in-memory UART
+
+void HostRxTask::run() {
+    while (!_stopRequested.load(std::memory_order_acquire)) {
+        _wakeups.fetch_add(1, std::memory_order_relaxed);
+        if (drainOnce() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+bool HostRxTask::start(int core) {
+    (void)core;
+    if (running()) {
+        return true;
+    }
+    _stopRequested.store(false, std::memory_order_release);
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread([this]() { run(); });
+    return true;
+}
+
+void HostRxTask::stop() {
+    if (!running()) {
+        return;
+    }
+    _stopRequested.store(true, std::memory_order_release);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _running.store(false, std::memory_order_release);
+}
+
+#endif
+
+// EOF
@@ -0,0 +1,24 @@
+#include "line_assembler.h"
+
+#include <ctype.h>
+
+void LineAssembler::trim(const char *&data, size_t &len) {
+    while (len > 0 && isspace(static_cast<unsigned char>(data[0]))) {
+        data++;
+        len--;
+    }
+    while (len > 0 && isspace(static_cast<unsigned char>(data[len - 1]))) {
+        len--;
+    }
+}
+
+size_t LineAssembler::frameStart(const char *data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (data[i] == 'C' || data[i] == 'H') {
+            return i;
+        }
+    }
+    return len;
+}
+
+// EOF
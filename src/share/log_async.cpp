@@ -0,0 +1,389 @@
+#include "log_async.h"
+
+#include "log_core.h"
+#include "log_ring.h"
+#include "telemetry.h"
+
+#include <atomic>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_heap_caps.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+namespace log_async {
+
+namespace {
+
+static constexpr size_t kDatagramBytes = LOG_ASYNC_DATAGRAM_BYTES;
+
+static LogRing g_ring;
+static std::atomic<bool> g_running{false};
+static std::atomic<bool> g_stopRequested{false};
+static std::atomic<uint32_t> g_sentPos{0}; // ring position handed to the sinks
+static uint32_t g_reportedDropped = 0;
+static bool g_psram = false;
+
+static SinkFn g_serialSink = nullptr;
+static SinkFn g_udpSink = nullptr;
+
+static std::atomic<uint32_t> g_truncated{0};
+static std::atomic<uint32_t> g_datagrams{0};
+static std::atomic<uint32_t> g_udpBytes{0};
+static std::atomic<uint32_t> g_serialWrites{0};
+static std::atomic<uint32_t> g_serialBytes{0};
+static std::atomic<uint32_t> g_blockingWrites{0};
+static std::atomic<uint32_t> g_blockingTimeouts{0};
+
+// Drain task only
+static char g_serialBatch[kDatagramBytes];
+static char g_udpBatch[kDatagramBytes];
+static size_t g_serialLen = 0;
+static size_t g_udpLen = 0;
+
+static void default_serial_sink(const char *data, size_t len) {
+    Serial.write(reinterpret_cast<const uint8_t *>(data), len);
+}
+
+static void default_udp_sink(const char *data, size_t len) { logWriteUdpIfEnabled(data, len); }
+
+// Same filter as logWriteSerial(): CSV records (';...'), binary records
+// (log_bin.h) and telemetry frames (telemetry.h) go to UDP only.
+static bool serial_wants(const char *data, size_t len) {
+    if (len <= 1) {
+        return false;
+    }
+    const uint8_t first = static_cast<uint8_t>(data[0]);
+    return first != ';' && first != logbin::kRecordMark && first != telemetry::kFrameMark;
+}
+
+static void flush_serial() {
+    if (g_serialLen > 0) {
+        g_serialSink(g_serialBatch, g_serialLen);
+        g_serialWrites.fetch_add(1, std::memory_order_relaxed);
+        g_serialBytes.fetch_add(static_cast<uint32_t>(g_serialLen), std::memory_order_relaxed);
+        g_serialLen = 0;
+    }
+}
+
+static void flush_udp() {
+    if (g_udpLen > 0) {
+        g_udpSink(g_udpBatch, g_udpLen);
+        g_datagrams.fetch_add(1, std::memory_order_relaxed);
+        g_udpBytes.fetch_add(static_cast<uint32_t>(g_udpLen), std::memory_order_relaxed);
+        g_udpLen = 0;
+    }
+}
+
+// One line into both batches; a batch that cannot take it is sent first.
+static void batch_line(const char *data, size_t len) {
+    if (g_udpLen + len > kDatagramBytes) {
+        flush_udp();
+    }
+    if (len > kDatagramBytes) {
+        g_udpSink(data, len); // longer than a datagram: on its own
+        g_datagrams.fetch_add(1, std::memory_order_relaxed);
+        g_udpBytes.fetch_add(static_cast<uint32_t>(len), std::memory_order_relaxed);
+    } else {
+        memcpy(g_udpBatch + g_udpLen, data, len);
+        g_udpLen += len;
+    }
+
+    if (!serial_wants(data, len)) {
+        return;
+    }
+    if (g_serialLen + len > kDatagramBytes) {
+        flush_serial();
+    }
+    if (len > kDatagramBytes) {
+        g_serialSink(data, len);
+        g_serialWrites.fetch_add(1, std::memory_order_relaxed);
+        g_serialBytes.fetch_add(static_cast<uint32_t>(len), std::memory_order_relaxed);
+    } else {
+        memcpy(g_serialBatch + g_serialLen, data, len);
+        g_serialLen += len;
+    }
+}
+
+// Everything committed so far -> sinks. Drain task only.
+static size_t drain_all() {
+    const size_t lines = g_ring.drain([](const char *data, size_t len) {
+        batch_line(data, len);
+        return true;
+    });
+
+    const uint32_t dropped = g_ring.dropped();
+    if (dropped != g_reportedDropped) {
+        char msg[64];
+        const int n = snprintf(msg, sizeof(msg), "[LOG/WARN] %lu lines dropped (ring full)\n",
+                               static_cast<unsigned long>(dropped - g_reportedDropped));
+        g_reportedDropped = dropped;
+        if (n > 0) {
+            batch_line(msg, static_cast<size_t>(n) < sizeof(msg) ? static_cast<size_t>(n) : sizeof(msg) - 1);
+        }
+    }
+
+    flush_udp();
+    flush_serial();
+    g_sentPos.store(g_ring.consumedPos(), std::memory_order_release);
+    return lines;
+}
+
+static bool position_reached(uint32_t pos) {
+    return static_cast<int32_t>(g_sentPos.load(std::memory_order_acquire) - pos) >= 0;
+}
+
+} // namespace
+
+// ============================================================================
+//  Platform part: task, wake-up, allocation
+// ============================================================================
+#if defined(ARDUINO_ARCH_ESP32)
+
+static constexpr uint32_t kIdleWaitMs = 100; // drain without a wake-up (missed notification)
+static constexpr uint32_t kStackSize = 4096;
+static constexpr UBaseType_t kPriority = 1; // just above idle
+static constexpr BaseType_t kCore = 0;      // LVGL / loop() run on core 1
+
+static TaskHandle_t g_task = nullptr;
+
+static void wake_drain() {
+    if (g_task) {
+        xTaskNotifyGive(g_task);
+    }
+}
+
+static bool in_drain_task() { return g_task && xTaskGetCurrentTaskHandle() == g_task; }
+
+static void sleep_ms(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms) > 0 ? pdMS_TO_TICKS(ms) : 1); }
+
+static uint32_t now_ms() { return millis(); }
+
+static void drain_task(void *arg) {
+    (void)arg;
+    while (!g_stopRequested.load(std::memory_order_acquire)) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kIdleWaitMs));
+        if (!g_ring.empty()) {
+            // Let a burst build up, so it leaves in few datagrams.
+            vTaskDelay(pdMS_TO_TICKS(LOG_ASYNC_COALESCE_MS));
+        }
+        drain_all();
+    }
+    drain_all();
+    g_running.store(false, std::memory_order_release);
+    g_task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+static uint8_t *allocate_ring(size_t &size) {
+    // Only plain 32-bit loads/stores touch the buffer (no S32C1I), so PSRAM
+    // is fine; the CAS is on LogRing's own counters in internal RAM.
+    size = LOG_ASYNC_RING_BYTES;
+    uint8_t *buf = static_cast<uint8_t *>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    g_psram = buf != nullptr;
+    if (!buf) {
+        size = LOG_ASYNC_RING_BYTES_INTERNAL;
+        buf = static_cast<uint8_t *>(heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    }
+    return buf;
+}
+
+static bool start_task() {
+    g_task = nullptr;
+    TaskHandle_t handle = nullptr;
+    if (xTaskCreatePinnedToCore(&drain_task, "logDrain", kStackSize, nullptr, kPriority, &handle, kCore) != pdPASS) {
+        return false;
+    }
+    g_task = handle;
+    return true;
+}
+
+static void join_task() {
+    wake_drain();
+    while (g_running.load(std::memory_order_acquire)) {
+        vTaskDelay(1);
+    }
+}
+
+#else // native: std::thread polling the ring
+
+static std::thread g_thread;
+static std::thread::id g_threadId;
+
+static void wake_drain() {}
+
+static bool in_drain_task() { return g_thread.joinable() && std::this_thread::get_id() == g_threadId; }
+
+static void sleep_ms(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// Wall clock: the shim's millis() is virtual and only moves when a test
+// advances it.
+static uint32_t now_ms() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+static uint8_t *allocate_ring(size_t &size) {
+    static uint32_t storage[LOG_ASYNC_RING_BYTES / sizeof(uint32_t)];
+    size = sizeof(storage);
+    g_psram = false;
+    return reinterpret_cast<uint8_t *>(storage);
+}
+
+static bool start_task() {
+    g_thread = std::thread([]() {
+        while (!g_stopRequested.load(std::memory_order_acquire)) {
+            if (drain_all() == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        drain_all();
+        g_running.store(false, std::memory_order_release);
+    });
+    g_threadId = g_thread.get_id();
+    return true;
+}
+
+static void join_task() {
+    if (g_thread.joinable()) {
+        g_thread.join();
+    }
+}
+
+#endif
+
+// ============================================================================
+//  API
+// ============================================================================
+
+void set_sinks(SinkFn serialSink, SinkFn udpSink) {
+    g_serialSink = serialSink;
+    g_udpSink = udpSink;
+}
+
+bool start() {
+    if (g_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+    if (!g_serialSink) {
+        g_serialSink = default_serial_sink;
+    }
+    if (!g_udpSink) {
+        g_udpSink = default_udp_sink;
+    }
+
+    static uint8_t *buf = nullptr;
+    static size_t size = 0;
+    if (!buf) {
+        buf = allocate_ring(size);
+    }
+    if (!buf || !g_ring.init(buf, size)) {
+        return false;
+    }
+    g_reportedDropped = 0;
+    g_sentPos.store(0, std::memory_order_relaxed);
+    g_stopRequested.store(false, std::memory_order_release);
+    g_running.store(true, std::memory_order_release);
+    if (!start_task()) {
+        g_running.store(false, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+void stop() {
+    if (!g_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    g_stopRequested.store(true, std::memory_order_release);
+    join_task();
+}
+
+bool running() { return g_running.load(std::memory_order_acquire); }
+
+bool write(const char *line, size_t len) {
+    if (!running()) {
+        return false;
+    }
+    if (len + LogRing::kHeaderLen > g_ring.capacity() / 4u) {
+        g_truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+    const bool ok = g_ring.push(line, len);
+    wake_drain();
+    return ok;
+}
+
+bool write_blocking(const char *line, size_t len, uint32_t timeoutMs) {
+    if (!running()) {
+        return false;
+    }
+    g_blockingWrites.fetch_add(1, std::memory_order_relaxed);
+    if (in_drain_task()) {
+        // Cannot wait for ourselves: straight to the sinks.
+        g_serialSink(line, len);
+        g_udpSink(line, len);
+        return true;
+    }
+
+    const uint32_t start = now_ms();
+    uint32_t endPos = 0;
+    while (!g_ring.push(line, len, &endPos)) {
+        wake_drain();
+        if (now_ms() - start >= timeoutMs) {
+            g_blockingTimeouts.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        sleep_ms(1);
+    }
+    while (!position_reached(endPos)) {
+        wake_drain();
+        if (now_ms() - start >= timeoutMs) {
+            g_blockingTimeouts.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        sleep_ms(1);
+    }
+    return true;
+}
+
+bool flush(uint32_t timeoutMs) {
+    if (!running()) {
+        return true;
+    }
+    // Everything reserved so far; a record still being copied by another
+    // task is waited for as well.
+    const uint32_t target = g_ring.consumedPos() + static_cast<uint32_t>(g_ring.used());
+    const uint32_t start = now_ms();
+    while (!position_reached(target)) {
+        wake_drain();
+        if (now_ms() - start >= timeoutMs) {
+            return false;
+        }
+        sleep_ms(1);
+    }
+    return true;
+}
+
+Stats stats() {
+    Stats s = {};
+    s.lines = g_ring.pushed();
+    s.dropped = g_ring.dropped();
+    s.truncated = g_truncated.load(std::memory_order_relaxed);
+    s.datagrams = g_datagrams.load(std::memory_order_relaxed);
+    s.udpBytes = g_udpBytes.load(std::memory_order_relaxed);
+    s.serialWrites = g_serialWrites.load(std::memory_order_relaxed);
+    s.serialBytes = g_serialBytes.load(std::memory_order_relaxed);
+    s.blockingWrites = g_blockingWrites.load(std::memory_order_relaxed);
+    s.blockingTimeouts = g_blockingTimeouts.load(std::memory_order_relaxed);
+    s.ringBytes = static_cast<uint32_t>(g_ring.capacity());
+    s.ringHighWater = g_ring.highWater();
+    s.psram = g_psram;
+    return s;
+}
+
+} // namespace log_async
+
+// EOF
@@ -24,44 +24,219 @@
 
 #include "protocol.h"
 
-//
-// A global constant for CRLF termination.
-// All outgoing protocol messages use "\r\n" as defined.
-//
-static const char *CRLF = "\r\n";
+#include <ctype.h>
+#include <string.h>
 
 // ============================================================================
-//  Helper: Convert uint16_t to 4-digit uppercase HEX string (e.g. "00AF").
+//  Helper: Table-driven frame writer (no heap, no printf).
+//
+//  Appends protocol fields into a caller-provided char buffer. Every append
+//  is bounds-checked; once the buffer is exhausted the writer latches an
+//  error and finish() returns 0.
 // ============================================================================
 
-String ProtocolCodec::toHex4(uint16_t value) {
-    // snprintf ensures safe formatting into a fixed buffer.
-    // "%04X" formats the number in uppercase hex, padded to 4 digits.
-    char buf[5];
-    snprintf(buf, sizeof(buf), "%04X", static_cast<unsigned>(value));
-    return String(buf);
-}
+namespace {
+
+const char kHexDigits[] = "0123456789ABCDEF";
+
+// "00".."99": two decimal digits per lookup.
+const char kDecPairs[] = "00010203040506070809"
+                         "10111213141516171819"
+                         "20212223242526272829"
+                         "30313233343536373839"
+                         "40414243444546474849"
+                         "50515253545556575859"
+                         "60616263646566676869"
+                         "70717273747576777879"
+                         "80818283848586878889"
+                         "90919293949596979899";
+
+class FrameWriter {
+  public:
+    FrameWriter(char *buf, size_t cap) : _buf(buf), _cap(cap), _len(0), _ok(buf != nullptr && cap > 0) {}
+
+    void put(const char *text, size_t n) {
+        if (!reserve(n)) {
+            return;
+        }
+        memcpy(_buf + _len, text, n);
+        _len += n;
+    }
+
+    // Literal without terminating NUL.
+    template <size_t N> void lit(const char (&text)[N]) { put(text, N - 1); }
+
+    void sep() { lit(";"); }
+
+    // 4-digit uppercase hex (e.g. "00AF").
+    void hex4(uint16_t value) {
+        if (!reserve(4)) {
+            return;
+        }
+        char *p = _buf + _len;
+        p[0] = kHexDigits[(value >> 12) & 0x0F];
+        p[1] = kHexDigits[(value >> 8) & 0x0F];
+        p[2] = kHexDigits[(value >> 4) & 0x0F];
+        p[3] = kHexDigits[value & 0x0F];
+        _len += 4;
+    }
+
+    // Optional sequence field ";#XX" (2-digit hex), omitted for seq == 0.
+    void seq(uint8_t value) {
+        if (value == 0) {
+            return;
+        }
+        lit(";#");
+        if (!reserve(2)) {
+            return;
+        }
+        _buf[_len++] = kHexDigits[(value >> 4) & 0x0F];
+        _buf[_len++] = kHexDigits[value & 0x0F];
+    }
+
+    // Signed decimal, same text as String(int).
+    void dec(int32_t value) {
+        char tmp[12];
+        char *end = tmp + sizeof(tmp);
+        char *p = end;
+
+        uint32_t u = (value < 0) ? (0u - static_cast<uint32_t>(value)) : static_cast<uint32_t>(value);
+        while (u >= 100) {
+            const uint32_t idx = (u % 100) * 2;
+            u /= 100;
+            *--p = kDecPairs[idx + 1];
+            *--p = kDecPairs[idx];
+        }
+        if (u >= 10) {
+            *--p = kDecPairs[u * 2 + 1];
+            *--p = kDecPairs[u * 2];
+        } else {
+            *--p = static_cast<char>('0' + u);
+        }
+        if (value < 0) {
+            *--p = '-';
+        }
+        put(p, static_cast<size_t>(end - p));
+    }
+
+    // STATUS payload: <mask>;<a0>;<a1>;<a2>;<a3>;<hot_dC>;<chamber_dC>, plus
+    // ;<sampleSeq>;<sampleAgeMs>;<sensorFaults> when the client sent sample
+    // information.
+    void status(const ProtocolStatus &st) {
+        hex4(st.outputsMask);
+        for (uint8_t i = 0; i < 4; ++i) {
+            sep();
+            dec(st.adcRaw[i]);
+        }
+        sep();
+        dec(st.tempHotspot_dC);
+        sep();
+        dec(st.tempChamber_dC);
+        if (st.sampleSeq != 0) {
+            sep();
+            hex4(st.sampleSeq);
+            sep();
+            dec(st.sampleAgeMs);
+            sep();
+            hex4(st.sensorFaults);
+        }
+    }
+
+    // Append CRLF + NUL. Returns frame length (without NUL) or 0 on overflow.
+    size_t finish() {
+        lit("\r\n");
+        if (!reserve(1)) {
+            return 0;
+        }
+        _buf[_len] = '\0';
+        return _len;
+    }
+
+  private:
+    bool reserve(size_t n) {
+        if (!_ok || _len + n > _cap) {
+            _ok = false;
+            return false;
+        }
+        return true;
+    }
+
+    char *_buf;
+    size_t _cap;
+    size_t _len;
+    bool _ok;
+};
+
+} // namespace
 
 // ============================================================================
-//  Helper: Parse 4-digit hex string into uint16_t.
+//  Helper: Parse 4-digit hex field into uint16_t.
 //  Returns true on success, false on malformed input.
+//
+//  Works directly on a (ptr,len) span. Accepts exactly what the former
+//  String/strtol based implementation accepted (optional leading white
+//  space, optional sign, optional "0x" prefix, full consumption up to the
+//  end of the field or an embedded NUL), so no frame changes its verdict.
 // ============================================================================
 
-bool ProtocolCodec::parseHex4(const String &text, uint16_t &value) {
+bool ProtocolCodec::parseHex4(const char *text, size_t len, uint16_t &value) {
     // The protocol mandates exactly 4 hex digits.
-    if (text.length() != 4) {
+    if (len != 4) {
         return false;
     }
 
-    // Use strtol to convert; base 16 for hex.
-    char *endPtr = nullptr;
-    long v = strtol(text.c_str(), &endPtr, 16);
+    // strtol() stops at an embedded NUL → treat it as end of field.
+    const char *nul = static_cast<const char *>(memchr(text, '\0', len));
+    const size_t end = nul ? static_cast<size_t>(nul - text) : len;
+
+    size_t i = 0;
+    while (i < end && isspace(static_cast<unsigned char>(text[i]))) {
+        ++i;
+    }
 
-    // endPtr must point to string end → full parsing success.
-    if (*endPtr != '\0') {
+    bool negative = false;
+    if (i < end && (text[i] == '+' || text[i] == '-')) {
+        negative = (text[i] == '-');
+        ++i;
+    }
+
+    if (i + 2 < end && text[i] == '0' && (text[i + 1] == 'x' || text[i + 1] == 'X') &&
+        isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+        i += 2;
+    }
+
+    long v = 0;
+    size_t digits = 0;
+    for (; i < end; ++i, ++digits) {
+        const char c = text[i];
+        int d;
+        if (c >= '0' && c <= '9') {
+            d = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            d = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            d = c - 'A' + 10;
+        } else {
+            break;
+        }
+        v = (v << 4) | d;
+    }
+
+    if (digits == 0) {
+        // No conversion → strtol reports the field start as end pointer.
+        if (text[0] != '\0') {
+            return false;
+        }
+        v = 0;
+    } else if (i != end) {
+        // Trailing garbage.
         return false;
     }
 
+    if (negative) {
+        v = -v;
+    }
+
     // Check legal uint16 range.
     if (v < 0 || v > 0xFFFF) {
         return false;
@@ -71,6 +246,70 @@ bool ProtocolCodec::parseHex4(const String &text, uint16_t &value) {
     return true;
 }
 
+// ============================================================================
+//  Helper: Parse the optional sequence field "#XX" (exactly two hex digits).
+//  Sequence numbers run 1..255; "#00" is rejected.
+// ============================================================================
+
+bool ProtocolCodec::parseSeq(const char *text, size_t len, uint8_t &seq) {
+    if (len != 3 || text[0] != '#') {
+        return false;
+    }
+
+    uint8_t v = 0;
+    for (size_t i = 1; i < 3; ++i) {
+        const char c = text[i];
+        uint8_t d;
+        if (c >= '0' && c <= '9') {
+            d = static_cast<uint8_t>(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            d = static_cast<uint8_t>(c - 'A' + 10);
+        } else if (c >= 'a' && c <= 'f') {
+            d = static_cast<uint8_t>(c - 'a' + 10);
+        } else {
+            return false;
+        }
+        v = static_cast<uint8_t>((v << 4) | d);
+    }
+
+    if (v == 0) {
+        return false;
+    }
+    seq = v;
+    return true;
+}
+
+// ============================================================================
+//  Helper: Parse a decimal field like String::toInt() (atol semantics,
+//  saturating at the 32-bit long range of the ESP32 toolchain).
+//  Never fails; non-numeric input yields 0.
+// ============================================================================
+
+long ProtocolCodec::parseDecimal(const char *text, size_t len) {
+    size_t i = 0;
+    while (i < len && isspace(static_cast<unsigned char>(text[i]))) {
+        ++i;
+    }
+
+    bool negative = false;
+    if (i < len && (text[i] == '+' || text[i] == '-')) {
+        negative = (text[i] == '-');
+        ++i;
+    }
+
+    // Accumulate as negative to cover INT32_MIN without overflow.
+    const int64_t limit = negative ? INT32_MIN : -static_cast<int64_t>(INT32_MAX);
+    int64_t acc = 0;
+    for (; i < len && text[i] >= '0' && text[i] <= '9'; ++i) {
+        acc = acc * 10 - (text[i] - '0');
+        if (acc < limit) {
+            acc = limit;
+        }
+    }
+
+    return static_cast<long>(negative ? acc : -acc);
+}
+
 // ============================================================================
 //  Host → Client Message Builders
 // ============================================================================
@@ -78,15 +317,17 @@ bool ProtocolCodec::parseHex4(const String &text, uint16_t &value) {
 /**
  * @brief Build a SET message:
  *
- *   H;SET;<mask>\r\n
+ *   H;SET;<mask>[;#<seq>]\r\n
  *
- * <mask> is a 4-digit uppercase hex value.
+ * <mask> is a 4-digit uppercase hex value, <seq> an optional 2-digit
+ * sequence number (omitted for seq == 0).
  */
-String ProtocolCodec::buildHostSet(uint16_t mask) {
-    String msg = F("H;SET;");
-    msg += toHex4(mask);
-    msg += CRLF;
-    return msg;
+size_t ProtocolCodec::buildHostSet(char *buf, size_t cap, uint16_t mask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("H;SET;");
+    w.hex4(mask);
+    w.seq(seq);
+    return w.finish();
 }
 
 /**
@@ -94,10 +335,10 @@ String ProtocolCodec::buildHostSet(uint16_t mask) {
  *
  *   H;GET;STATUS\r\n
  */
-String ProtocolCodec::buildHostGetStatus() {
-    String msg = F("H;GET;STATUS");
-    msg += CRLF;
-    return msg;
+size_t ProtocolCodec::buildHostGetStatus(char *buf, size_t cap) {
+    FrameWriter w(buf, cap);
+    w.lit("H;GET;STATUS");
+    return w.finish();
 }
 
 /**
@@ -105,10 +346,49 @@ String ProtocolCodec::buildHostGetStatus() {
  *
  *   H;PING\r\n
  */
-String ProtocolCodec::buildHostPing() {
-    String msg = F("H;PING");
-    msg += CRLF;
-    return msg;
+size_t ProtocolCodec::buildHostPing(char *buf, size_t cap) {
+    FrameWriter w(buf, cap);
+    w.lit("H;PING");
+    return w.finish();
+}
+
+/**
+ * @brief Build a RST message:
+ *
+ *   H;RST\r\n
+ */
+size_t ProtocolCodec::buildHostRst(char *buf, size_t cap) {
+    FrameWriter w(buf, cap);
+    w.lit("H;RST");
+    return w.finish();
+}
+
+/**
+ * @brief Build an UPD message:
+ *
+ *   H;UPD;<setMask>;<clrMask>[;#<seq>]\r\n
+ */
+size_t ProtocolCodec::buildHostUpd(char *buf, size_t cap, uint16_t setMask, uint16_t clrMask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("H;UPD;");
+    w.hex4(setMask);
+    w.sep();
+    w.hex4(clrMask);
+    w.seq(seq);
+    return w.finish();
+}
+
+/**
+ * @brief Build a TOG message:
+ *
+ *   H;TOG;<togMask>[;#<seq>]\r\n
+ */
+size_t ProtocolCodec::buildHostTog(char *buf, size_t cap, uint16_t togMask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("H;TOG;");
+    w.hex4(togMask);
+    w.seq(seq);
+    return w.finish();
 }
 
 // ============================================================================
@@ -118,13 +398,14 @@ String ProtocolCodec::buildHostPing() {
 /**
  * @brief Build an ACK to a SET message:
  *
- *   C;ACK;SET;<mask>\r\n
+ *   C;ACK;SET;<mask>[;#<seq>]\r\n
  */
-String ProtocolCodec::buildClientAckSet(uint16_t mask) {
-    String msg = F("C;ACK;SET;");
-    msg += toHex4(mask);
-    msg += CRLF;
-    return msg;
+size_t ProtocolCodec::buildClientAckSet(char *buf, size_t cap, uint16_t mask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;SET;");
+    w.hex4(mask);
+    w.seq(seq);
+    return w.finish();
 }
 
 /**
@@ -134,39 +415,30 @@ String ProtocolCodec::buildClientAckSet(uint16_t mask) {
  *
  * The <errorCode> is application-specific (e.g. "1", "42").
  */
-String ProtocolCodec::buildClientErrSet(int errorCode) {
-    String msg = F("C;ERR;SET;");
-    msg += String(errorCode);
-    msg += CRLF;
-    return msg;
+size_t ProtocolCodec::buildClientErrSet(char *buf, size_t cap, int errorCode) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ERR;SET;");
+    w.dec(errorCode);
+    return w.finish();
 }
 
 /**
  * @brief Build a STATUS frame:
  *
- *   C;STATUS;<mask>;<adc0>;<adc1>;<adc2>;<adc3>;<temp>\r\n
+ *   C;STATUS;<mask>;<adc0>;<adc1>;<adc2>;<adc3>;<hot_dC>;<chamber_dC>[;<sseq>;<age>;<flt>]\r\n
  *
- * <mask> = 4-char HEX
- * <adc*> = integer raw values (0..4095 typical)
- * <temp> = temperature × 4 (0.25°C resolution)
+ * <mask>  = 4-char HEX
+ * <adc*>  = signed raw ADS1115 counts
+ * <*_dC>  = temperatures in 0.1°C
+ * <sseq>  = 4-char HEX sample counter, <age> = sample age in ms (decimal),
+ * <flt>   = 4-char HEX sensor fault mask;
+ *           all three only present when status.sampleSeq != 0
  */
-String ProtocolCodec::buildClientStatus(const ProtocolStatus &status) {
-    String msg = F("C;STATUS;");
-    msg += toHex4(status.outputsMask);
-    msg += ';';
-    msg += String(status.adcRaw[0]);
-    msg += ';';
-    msg += String(status.adcRaw[1]);
-    msg += ';';
-    msg += String(status.adcRaw[2]);
-    msg += ';';
-    msg += String(status.adcRaw[3]);
-    msg += ';';
-    msg += String(status.tempHotspot_dC);
-    msg += ';';
-    msg += String(status.tempChamber_dC);
-    msg += CRLF;
-    return msg;
+size_t ProtocolCodec::buildClientStatus(char *buf, size_t cap, const ProtocolStatus &status) {
+    FrameWriter w(buf, cap);
+    w.lit("C;STATUS;");
+    w.status(status);
+    return w.finish();
 }
 
 /**
@@ -174,67 +446,387 @@ String ProtocolCodec::buildClientStatus(const ProtocolStatus &status) {
  *
  *   C;PONG\r\n
  */
+size_t ProtocolCodec::buildClientPong(char *buf, size_t cap) {
+    FrameWriter w(buf, cap);
+    w.lit("C;PONG");
+    return w.finish();
+}
+
+/**
+ * @brief Build a RST message:
+ *
+ *   C;RST\r\n
+ */
+size_t ProtocolCodec::buildClientRst(char *buf, size_t cap) {
+    FrameWriter w(buf, cap);
+    w.lit("C;RST");
+    return w.finish();
+}
+
+/**
+ * @brief Build an ACK to an UPD message:
+ *
+ *   C;ACK;UPD;<newMask>[;#<seq>]\r\n
+ */
+size_t ProtocolCodec::buildClientAckUpd(char *buf, size_t cap, uint16_t newMask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;UPD;");
+    w.hex4(newMask);
+    w.seq(seq);
+    return w.finish();
+}
+
+/**
+ * @brief Build an ACK to a TOG message:
+ *
+ *   C;ACK;TOG;<newMask>[;#<seq>]\r\n
+ */
+size_t ProtocolCodec::buildClientAckTog(char *buf, size_t cap, uint16_t newMask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;TOG;");
+    w.hex4(newMask);
+    w.seq(seq);
+    return w.finish();
+}
+
+// ============================================================================
+//  Link mode negotiation
+// ============================================================================
+
+/**
+ * @brief Build a link mode request:
+ *
+ *   H;BIN;<mode>\r\n
+ */
+size_t ProtocolCodec::buildHostBin(char *buf, size_t cap, uint16_t mode) {
+    FrameWriter w(buf, cap);
+    w.lit("H;BIN;");
+    w.hex4(mode);
+    return w.finish();
+}
+
+/**
+ * @brief Build the answer to a link mode request:
+ *
+ *   C;ACK;BIN;<mode>\r\n
+ */
+size_t ProtocolCodec::buildClientAckBin(char *buf, size_t cap, uint16_t mode) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;BIN;");
+    w.hex4(mode);
+    return w.finish();
+}
+
+// ============================================================================
+//  Link baud rate negotiation
+// ============================================================================
+
+/**
+ * @brief Build a link rate proposal (rate field = baud / 100):
+ *
+ *   H;BAUD;<rate>\r\n
+ */
+size_t ProtocolCodec::buildHostBaud(char *buf, size_t cap, uint16_t rateField) {
+    FrameWriter w(buf, cap);
+    w.lit("H;BAUD;");
+    w.hex4(rateField);
+    return w.finish();
+}
+
+/**
+ * @brief Build the answer to a link rate proposal:
+ *
+ *   C;ACK;BAUD;<rate>\r\n
+ */
+size_t ProtocolCodec::buildClientAckBaud(char *buf, size_t cap, uint16_t rateField) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;BAUD;");
+    w.hex4(rateField);
+    return w.finish();
+}
+
+// ============================================================================
+//  STATUS subscription
+// ============================================================================
+
+/**
+ * @brief Build a STATUS subscription request:
+ *
+ *   H;SUB;<period>;<triggers>\r\n
+ */
+size_t ProtocolCodec::buildHostSub(char *buf, size_t cap, uint16_t periodMs, uint16_t triggers) {
+    FrameWriter w(buf, cap);
+    w.lit("H;SUB;");
+    w.hex4(periodMs);
+    w.sep();
+    w.hex4(triggers);
+    return w.finish();
+}
+
+/**
+ * @brief Build the answer to a subscription request:
+ *
+ *   C;ACK;SUB;<period>\r\n
+ */
+size_t ProtocolCodec::buildClientAckSub(char *buf, size_t cap, uint16_t periodMs) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;SUB;");
+    w.hex4(periodMs);
+    return w.finish();
+}
+
+// ============================================================================
+//  Combined actuate-and-report
+// ============================================================================
+
+/**
+ * @brief Build an actuate-and-report command (UPD semantics):
+ *
+ *   H;ACT;<setMask>;<clrMask>[;#<seq>]\r\n
+ */
+size_t ProtocolCodec::buildHostAct(char *buf, size_t cap, uint16_t setMask, uint16_t clrMask, uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("H;ACT;");
+    w.hex4(setMask);
+    w.sep();
+    w.hex4(clrMask);
+    w.seq(seq);
+    return w.finish();
+}
+
+/**
+ * @brief Build the combined reply: ACK mask followed by the STATUS fields.
+ *
+ *   C;ACK;ACT;<ackMask>;<mask>;<a0>;<a1>;<a2>;<a3>;<hot>;<chamber>[;<sseq>;<age>][;#<seq>]\r\n
+ */
+size_t ProtocolCodec::buildClientAckAct(char *buf, size_t cap, uint16_t ackMask, const ProtocolStatus &status,
+                                        uint8_t seq) {
+    FrameWriter w(buf, cap);
+    w.lit("C;ACK;ACT;");
+    w.hex4(ackMask);
+    w.sep();
+    w.status(status);
+    w.seq(seq);
+    return w.finish();
+}
+
+/**
+ * @brief Build the ASCII frame for any message (dispatch on msg.type).
+ *
+ * Returns 0 for ProtocolMessageType::Unknown or if `cap` is too small.
+ */
+size_t ProtocolCodec::buildFrame(char *buf, size_t cap, const ProtocolMessage &msg) {
+    switch (msg.type) {
+    case ProtocolMessageType::HostSet:
+        return buildHostSet(buf, cap, msg.mask, msg.seq);
+    case ProtocolMessageType::HostGetStatus:
+        return buildHostGetStatus(buf, cap);
+    case ProtocolMessageType::HostPing:
+        return buildHostPing(buf, cap);
+    case ProtocolMessageType::HostRst:
+        return buildHostRst(buf, cap);
+    case ProtocolMessageType::HostUpd:
+        return buildHostUpd(buf, cap, msg.mask, msg.maskB, msg.seq);
+    case ProtocolMessageType::HostTog:
+        return buildHostTog(buf, cap, msg.mask, msg.seq);
+    case ProtocolMessageType::HostBin:
+        return buildHostBin(buf, cap, msg.mask);
+    case ProtocolMessageType::HostSub:
+        return buildHostSub(buf, cap, msg.mask, msg.maskB);
+    case ProtocolMessageType::HostAct:
+        return buildHostAct(buf, cap, msg.mask, msg.maskB, msg.seq);
+    case ProtocolMessageType::HostBaud:
+        return buildHostBaud(buf, cap, msg.mask);
+    case ProtocolMessageType::ClientAckSet:
+        return buildClientAckSet(buf, cap, msg.mask, msg.seq);
+    case ProtocolMessageType::ClientAckUpd:
+        return buildClientAckUpd(buf, cap, msg.mask, msg.seq);
+    case ProtocolMessageType::ClientAckTog:
+        return buildClientAckTog(buf, cap, msg.mask, msg.seq);
+    case ProtocolMessageType::ClientAckBin:
+        return buildClientAckBin(buf, cap, msg.mask);
+    case ProtocolMessageType::ClientAckSub:
+        return buildClientAckSub(buf, cap, msg.mask);
+    case ProtocolMessageType::ClientAckAct:
+        return buildClientAckAct(buf, cap, msg.mask, msg.status, msg.seq);
+    case ProtocolMessageType::ClientAckBaud:
+        return buildClientAckBaud(buf, cap, msg.mask);
+    case ProtocolMessageType::ClientErrSet:
+        return buildClientErrSet(buf, cap, msg.errorCode);
+    case ProtocolMessageType::ClientStatus:
+        return buildClientStatus(buf, cap, msg.status);
+    case ProtocolMessageType::ClientPong:
+        return buildClientPong(buf, cap);
+    case ProtocolMessageType::ClientRst:
+        return buildClientRst(buf, cap);
+    default:
+        return 0;
+    }
+}
+
+// ============================================================================
+//  String convenience builders (allocate; kept for tests and tools)
+// ============================================================================
+
+String ProtocolCodec::buildHostSet(uint16_t mask) {
+    char buf[kMaxFrameLen];
+    buildHostSet(buf, sizeof(buf), mask);
+    return String(buf);
+}
+
+String ProtocolCodec::buildHostGetStatus() {
+    char buf[kMaxFrameLen];
+    buildHostGetStatus(buf, sizeof(buf));
+    return String(buf);
+}
+
+String ProtocolCodec::buildHostPing() {
+    char buf[kMaxFrameLen];
+    buildHostPing(buf, sizeof(buf));
+    return String(buf);
+}
+
+String ProtocolCodec::buildHostRst() {
+    char buf[kMaxFrameLen];
+    buildHostRst(buf, sizeof(buf));
+    return String(buf);
+}
+
+String ProtocolCodec::buildHostUpd(uint16_t setMask, uint16_t clrMask) {
+    char buf[kMaxFrameLen];
+    buildHostUpd(buf, sizeof(buf), setMask, clrMask);
+    return String(buf);
+}
+
+String ProtocolCodec::buildHostTog(uint16_t togMask) {
+    char buf[kMaxFrameLen];
+    buildHostTog(buf, sizeof(buf), togMask);
+    return String(buf);
+}
+
+String ProtocolCodec::buildClientAckSet(uint16_t mask) {
+    char buf[kMaxFrameLen];
+    buildClientAckSet(buf, sizeof(buf), mask);
+    return String(buf);
+}
+
+String ProtocolCodec::buildClientErrSet(int errorCode) {
+    char buf[kMaxFrameLen];
+    buildClientErrSet(buf, sizeof(buf), errorCode);
+    return String(buf);
+}
+
+String ProtocolCodec::buildClientStatus(const ProtocolStatus &status) {
+    char buf[kMaxFrameLen];
+    buildClientStatus(buf, sizeof(buf), status);
+    return String(buf);
+}
+
 String ProtocolCodec::buildClientPong() {
-    String msg = F("C;PONG");
-    msg += CRLF;
-    return msg;
+    char buf[kMaxFrameLen];
+    buildClientPong(buf, sizeof(buf));
+    return String(buf);
+}
+
+String ProtocolCodec::buildClientRst() {
+    char buf[kMaxFrameLen];
+    buildClientRst(buf, sizeof(buf));
+    return String(buf);
+}
+
+String ProtocolCodec::buildClientAckUpd(uint16_t newMask) {
+    char buf[kMaxFrameLen];
+    buildClientAckUpd(buf, sizeof(buf), newMask);
+    return String(buf);
+}
+
+String ProtocolCodec::buildClientAckTog(uint16_t newMask) {
+    char buf[kMaxFrameLen];
+    buildClientAckTog(buf, sizeof(buf), newMask);
+    return String(buf);
 }
 
 // ============================================================================
-//  Parse an incoming protocol line
+//  Parse an incoming protocol frame
 // ============================================================================
 
+namespace {
+
+// Non-owning view of one ';'-separated field inside the frame buffer.
+struct FieldSpan {
+    const char *ptr;
+    size_t len;
+
+    // C-string comparison like String::operator==(const char *):
+    // an embedded NUL terminates the field.
+    bool equals(const char *literal) const {
+        const char *nul = static_cast<const char *>(memchr(ptr, '\0', len));
+        const size_t n = nul ? static_cast<size_t>(nul - ptr) : len;
+        return n == strlen(literal) && memcmp(ptr, literal, n) == 0;
+    }
+};
+
+} // namespace
+
 /**
- * @brief Parse a single protocol line into a structured message.
+ * @brief Parse a single protocol frame into a structured message.
  *
  * Input:
- *   - `line`: a completed text line WITHOUT CR/LF.
+ *   - `data`/`len`: a completed frame WITHOUT CR/LF (need not be terminated).
  *
- * Output (by reference):
- *   - type: which protocol message type was recognized
- *   - status: valid only for ClientStatus frames
- *   - mask:   valid only for SET/ACK frames
- *   - errorCode: valid only for ERR frames
+ * Output:
+ *   - msg.type:      which protocol message type was recognized
+ *   - msg.status:    valid only for ClientStatus frames
+ *   - msg.mask:      valid only for SET/UPD/TOG/ACK frames
+ *   - msg.maskB:     valid only for UPD frames (clear mask)
+ *   - msg.errorCode: valid only for ERR frames
  *
  * Returns:
  *   - true  → valid protocol message
  *   - false → parse error (wrong field count, invalid hex, unknown command)
  *
  * The parser:
- *   1. Splits at ';'
- *   2. Examines parts[0] (sender): "H" or "C"
- *   3. Examines parts[1] (command)
+ *   1. Splits at ';' into at most kMaxFields spans (no copies)
+ *   2. Examines field[0] (sender): "H" or "C"
+ *   3. Examines field[1] (command)
  *   4. Extracts additional values depending on the command type
+ *
+ * Field splitting intentionally mirrors the former String based parser:
+ * separators after an embedded NUL are not seen, and everything behind the
+ * kMaxFields-th field is ignored.
  */
-bool ProtocolCodec::parseLine(const String &line,
-                              ProtocolMessageType &type,
-                              ProtocolStatus &status,
-                              uint16_t &mask,
-                              int &errorCode,
-                              uint16_t &maskB,
-                              uint16_t &maskC) {
-    type = ProtocolMessageType::Unknown;
-    mask = 0;
-    errorCode = 0;
-    maskB = 0;
-    maskC = 0;
-    // --- Step 1: split line by semicolons -------------------------------
-    const int maxParts = 10;
-    String parts[maxParts];
-    int partCount = 0;
-
-    int start = 0;
-    while (start <= line.length() && partCount < maxParts) {
-        int sep = line.indexOf(';', start);
-
-        if (sep < 0) {
+bool ProtocolCodec::parseFrame(const char *data, size_t len, ProtocolMessage &msg) {
+    memset(&msg, 0, sizeof(msg));
+    msg.type = ProtocolMessageType::Unknown;
+
+    if (data == nullptr) {
+        len = 0;
+        data = "";
+    }
+
+    // --- Step 1: split frame by semicolons (in place) -------------------
+    const char *nul = static_cast<const char *>(memchr(data, '\0', len));
+    const size_t sepEnd = nul ? static_cast<size_t>(nul - data) : len;
+
+    FieldSpan parts[kMaxFields];
+    uint8_t partCount = 0;
+
+    size_t start = 0;
+    while (start <= len && partCount < kMaxFields) {
+        const char *sep = nullptr;
+        if (start < sepEnd) {
+            sep = static_cast<const char *>(memchr(data + start, ';', sepEnd - start));
+        }
+
+        if (sep == nullptr) {
             // Last chunk: no more separators
-            parts[partCount++] = line.substring(start);
+            parts[partCount++] = {data + start, len - start};
             break;
-        } else {
-            parts[partCount++] = line.substring(start, sep);
-            start = sep + 1;
         }
+
+        const size_t pos = static_cast<size_t>(sep - data);
+        parts[partCount++] = {data + start, pos - start};
+        start = pos + 1;
     }
 
     // Minimum: sender + command
@@ -242,92 +834,190 @@ bool ProtocolCodec::parseLine(const String &line,
         return false;
     }
 
-    String sender = parts[0]; // "H" or "C"
-    String cmd = parts[1];    // e.g. "SET", "GET", "STATUS", ...
+    const FieldSpan &sender = parts[0]; // "H" or "C"
+    const FieldSpan &cmd = parts[1];    // e.g. "SET", "GET", "STATUS", ...
+
+    // STATUS payload (7 fields: mask hex, a0..a3, hotspot dC, chamber dC,
+    // optionally followed by sample seq hex, sample age ms and sensor fault
+    // mask hex) starting at
+    // parts[first]; shared by C;STATUS and C;ACK;ACT.
+    auto parseStatusFields = [&parts](uint8_t first, bool withSample, ProtocolStatus &status) -> bool {
+        uint16_t m;
+        if (!parseHex4(parts[first].ptr, parts[first].len, m)) {
+            return false;
+        }
+        status.outputsMask = m;
+        for (uint8_t i = 0; i < 4; ++i) {
+            const FieldSpan &f = parts[first + 1 + i];
+            status.adcRaw[i] = static_cast<int16_t>(static_cast<uint16_t>(parseDecimal(f.ptr, f.len)));
+        }
+        status.tempHotspot_dC = static_cast<int16_t>(parseDecimal(parts[first + 5].ptr, parts[first + 5].len));
+        status.tempChamber_dC = static_cast<int16_t>(parseDecimal(parts[first + 6].ptr, parts[first + 6].len));
+        if (withSample) {
+            if (!parseHex4(parts[first + 7].ptr, parts[first + 7].len, status.sampleSeq)) {
+                return false;
+            }
+            status.sampleAgeMs = static_cast<uint16_t>(parseDecimal(parts[first + 8].ptr, parts[first + 8].len));
+            if (!parseHex4(parts[first + 9].ptr, parts[first + 9].len, status.sensorFaults)) {
+                return false;
+            }
+        }
+        return true;
+    };
 
     // =========================================================================
     //  HOST → CLIENT MESSAGES
     // =========================================================================
-    if (sender == "H") {
+    if (sender.equals("H")) {
         // ----------
-        // H;SET;<mask>
+        // H;SET;<mask>[;#<seq>]
         // ----------
-        if (cmd == "SET") {
-            if (partCount != 3) {
+        if (cmd.equals("SET")) {
+            if (partCount == 4) {
+                if (!parseSeq(parts[3].ptr, parts[3].len, msg.seq)) {
+                    return false;
+                }
+            } else if (partCount != 3) {
                 return false;
             }
 
-            if (!parseHex4(parts[2], mask)) {
+            if (!parseHex4(parts[2].ptr, parts[2].len, msg.mask)) {
                 return false;
             }
 
-            type = ProtocolMessageType::HostSet;
+            msg.type = ProtocolMessageType::HostSet;
             return true;
         }
 
         // ----------
         // H;GET;STATUS
         // ----------
-        else if (cmd == "GET") {
+        else if (cmd.equals("GET")) {
             if (partCount != 3) {
                 return false;
             }
 
-            if (parts[2] != "STATUS") {
+            if (!parts[2].equals("STATUS")) {
                 return false;
             }
 
-            type = ProtocolMessageType::HostGetStatus;
+            msg.type = ProtocolMessageType::HostGetStatus;
             return true;
         }
 
         // ----------
         // H;PING
         // ----------
-        else if (cmd == "PING") {
-            type = ProtocolMessageType::HostPing;
+        else if (cmd.equals("PING")) {
+            msg.type = ProtocolMessageType::HostPing;
             return true;
-        } else if (cmd == "RST") {
+        } else if (cmd.equals("RST")) {
             // Accept exactly: H;RST
             if (partCount != 2) {
                 return false;
             }
-            type = ProtocolMessageType::HostRst;
+            msg.type = ProtocolMessageType::HostRst;
             return true;
         }
 
-        else if (cmd == "UPD") {
-            // H;UPD;SSSS;CCCC
-            if (partCount != 4) {
+        else if (cmd.equals("UPD")) {
+            // H;UPD;SSSS;CCCC[;#QQ]
+            if (partCount == 5) {
+                if (!parseSeq(parts[4].ptr, parts[4].len, msg.seq)) {
+                    return false;
+                }
+            } else if (partCount != 4) {
                 return false;
             }
 
             uint16_t setMask = 0;
             uint16_t clrMask = 0;
-            if (!parseHex4(parts[2], setMask)) {
+            if (!parseHex4(parts[2].ptr, parts[2].len, setMask)) {
                 return false;
             }
-            if (!parseHex4(parts[3], clrMask)) {
+            if (!parseHex4(parts[3].ptr, parts[3].len, clrMask)) {
                 return false;
             }
 
-            type = ProtocolMessageType::HostUpd;
-            mask = setMask;
-            maskB = clrMask;
+            msg.type = ProtocolMessageType::HostUpd;
+            msg.mask = setMask;
+            msg.maskB = clrMask;
             return true;
-        } else if (cmd == "TOG") {
-            // H;TOG;TTTT
+        } else if (cmd.equals("BIN")) {
+            // H;BIN;MMMM (link mode request)
             if (partCount != 3) {
                 return false;
             }
 
+            if (!parseHex4(parts[2].ptr, parts[2].len, msg.mask)) {
+                return false;
+            }
+
+            msg.type = ProtocolMessageType::HostBin;
+            return true;
+        } else if (cmd.equals("BAUD")) {
+            // H;BAUD;RRRR (link rate proposal, RRRR = baud / 100)
+            if (partCount != 3) {
+                return false;
+            }
+
+            if (!parseHex4(parts[2].ptr, parts[2].len, msg.mask)) {
+                return false;
+            }
+
+            msg.type = ProtocolMessageType::HostBaud;
+            return true;
+        } else if (cmd.equals("SUB")) {
+            // H;SUB;PPPP;TTTT (STATUS push subscription)
+            if (partCount != 4) {
+                return false;
+            }
+
+            if (!parseHex4(parts[2].ptr, parts[2].len, msg.mask)) {
+                return false;
+            }
+            if (!parseHex4(parts[3].ptr, parts[3].len, msg.maskB)) {
+                return false;
+            }
+
+            msg.type = ProtocolMessageType::HostSub;
+            return true;
+        } else if (cmd.equals("ACT")) {
+            // H;ACT;SSSS;CCCC[;#QQ] (actuate and report)
+            if (partCount == 5) {
+                if (!parseSeq(parts[4].ptr, parts[4].len, msg.seq)) {
+                    return false;
+                }
+            } else if (partCount != 4) {
+                return false;
+            }
+
+            if (!parseHex4(parts[2].ptr, parts[2].len, msg.mask)) {
+                return false;
+            }
+            if (!parseHex4(parts[3].ptr, parts[3].len, msg.maskB)) {
+                return false;
+            }
+
+            msg.type = ProtocolMessageType::HostAct;
+            return true;
+        } else if (cmd.equals("TOG")) {
+            // H;TOG;TTTT[;#QQ]
+            if (partCount == 4) {
+                if (!parseSeq(parts[3].ptr, parts[3].len, msg.seq)) {
+                    return false;
+                }
+            } else if (partCount != 3) {
+                return false;
+            }
+
             uint16_t togMask = 0;
-            if (!parseHex4(parts[2], togMask)) {
+            if (!parseHex4(parts[2].ptr, parts[2].len, togMask)) {
                 return false;
             }
 
-            type = ProtocolMessageType::HostTog;
-            mask = togMask;
+            msg.type = ProtocolMessageType::HostTog;
+            msg.mask = togMask;
             return true;
         }
         // Unknown host command
@@ -337,30 +1027,74 @@ bool ProtocolCodec::parseLine(const String &line,
     // =========================================================================
     //  CLIENT → HOST MESSAGES
     // =========================================================================
-    if (sender == "C") {
-        if (cmd == "ACK") {
+    if (sender.equals("C")) {
+        if (cmd.equals("ACK")) {
             // Supported:
             // C;ACK;SET;MMMM
             // C;ACK;UPD;MMMM
             // C;ACK;TOG;MMMM
-            if (partCount != 4) {
+            // C;ACK;BIN;MMMM
+            // C;ACK;SUB;PPPP
+            // C;ACK;BAUD;RRRR
+            // C;ACK;ACT;MMMM;<mask>;<a0>;<a1>;<a2>;<a3>;<hot>;<chamber>
+            // SET/UPD/TOG/ACT may carry a trailing sequence field ";#QQ".
+            if (partCount >= 3 && parts[2].equals("ACT")) {
+                // 11 fields, 14 with sample fields, +1 with sequence field
+                uint8_t fields = partCount;
+                if (fields == 12 || fields == 15) {
+                    if (!parseSeq(parts[fields - 1].ptr, parts[fields - 1].len, msg.seq)) {
+                        return false;
+                    }
+                    fields--;
+                }
+                if (fields != 11 && fields != 14) {
+                    return false;
+                }
+                if (!parseHex4(parts[3].ptr, parts[3].len, msg.mask)) {
+                    return false;
+                }
+                if (!parseStatusFields(4, fields == 14, msg.status)) {
+                    return false;
+                }
+                msg.type = ProtocolMessageType::ClientAckAct;
+                return true;
+            }
+
+            if (partCount != 4 && partCount != 5) {
                 return false;
             }
 
-            const String &sub = parts[2];
+            const FieldSpan &sub = parts[2];
+            if (partCount == 5) {
+                if (!(sub.equals("SET") || sub.equals("UPD") || sub.equals("TOG"))) {
+                    return false;
+                }
+                if (!parseSeq(parts[4].ptr, parts[4].len, msg.seq)) {
+                    return false;
+                }
+            }
 
-            if (!parseHex4(parts[3], mask)) {
+            if (!parseHex4(parts[3].ptr, parts[3].len, msg.mask)) {
                 return false;
             }
 
-            if (sub == "SET") {
-                type = ProtocolMessageType::ClientAckSet;
+            if (sub.equals("SET")) {
+                msg.type = ProtocolMessageType::ClientAckSet;
+                return true;
+            } else if (sub.equals("UPD")) {
+                msg.type = ProtocolMessageType::ClientAckUpd;
+                return true;
+            } else if (sub.equals("TOG")) {
+                msg.type = ProtocolMessageType::ClientAckTog;
+                return true;
+            } else if (sub.equals("BIN")) {
+                msg.type = ProtocolMessageType::ClientAckBin;
                 return true;
-            } else if (sub == "UPD") {
-                type = ProtocolMessageType::ClientAckUpd;
+            } else if (sub.equals("SUB")) {
+                msg.type = ProtocolMessageType::ClientAckSub;
                 return true;
-            } else if (sub == "TOG") {
-                type = ProtocolMessageType::ClientAckTog;
+            } else if (sub.equals("BAUD")) {
+                msg.type = ProtocolMessageType::ClientAckBaud;
                 return true;
             }
 
@@ -370,25 +1104,25 @@ bool ProtocolCodec::parseLine(const String &line,
         // ----------
         // C;ERR;SET;<errorCode>
         // ----------
-        else if (cmd == "ERR") {
+        else if (cmd.equals("ERR")) {
             if (partCount != 4) {
                 return false;
             }
 
-            if (parts[2] != "SET") {
+            if (!parts[2].equals("SET")) {
                 return false;
             }
 
-            errorCode = parts[3].toInt();
-            type = ProtocolMessageType::ClientErrSet;
+            msg.errorCode = static_cast<int>(parseDecimal(parts[3].ptr, parts[3].len));
+            msg.type = ProtocolMessageType::ClientErrSet;
             return true;
         }
 
         // ----------
-        // C;STATUS;<mask>;<a0>;<a1>;<a2>;<a3>;<temp>
+        // C;STATUS;<mask>;<a0>;<a1>;<a2>;<a3>;<hot>;<chamber>
         // ----------
-        else if (cmd == "STATUS") {
-            // Expect exactly 8 parts:
+        else if (cmd.equals("STATUS")) {
+            // Expect 9 parts, 11 with sample fields:
             // [0]=C
             // [1]=STATUS
             // [2]=mask hex
@@ -396,45 +1130,39 @@ bool ProtocolCodec::parseLine(const String &line,
             // [4]=a1
             // [5]=a2
             // [6]=a3
-            // [7]=temp
-            if (partCount != 9) {
+            // [7]=hotspot dC
+            // [8]=chamber dC
+            // [9]=sample seq hex (optional)
+            // [10]=sample age ms (optional)
+            // [11]=sensor fault mask hex (optional, with [9]/[10])
+            if (partCount != 9 && partCount != 12) {
                 return false;
             }
 
-            uint16_t m;
-            if (!parseHex4(parts[2], m)) {
+            if (!parseStatusFields(2, partCount == 12, msg.status)) {
                 return false;
             }
 
-            status.outputsMask = m;
-            status.adcRaw[0] = static_cast<uint16_t>(parts[3].toInt());
-            status.adcRaw[1] = static_cast<uint16_t>(parts[4].toInt());
-            status.adcRaw[2] = static_cast<uint16_t>(parts[5].toInt());
-            status.adcRaw[3] = static_cast<uint16_t>(parts[6].toInt());
-            status.tempHotspot_dC = static_cast<int16_t>(parts[7].toInt());
-            status.tempChamber_dC = static_cast<int16_t>(parts[8].toInt());
-            
-
-            type = ProtocolMessageType::ClientStatus;
+            msg.type = ProtocolMessageType::ClientStatus;
             return true;
         }
 
         // ----------
         // C;PONG
         // ----------
-        else if (cmd == "PONG") {
-            type = ProtocolMessageType::ClientPong;
+        else if (cmd.equals("PONG")) {
+            msg.type = ProtocolMessageType::ClientPong;
             return true;
         }
         // ----------
         // RESET
         // ----------
-        else if (cmd == "RST") {
+        else if (cmd.equals("RST")) {
             // Accept exactly: C;RST
             if (partCount != 2) {
                 return false;
             }
-            type = ProtocolMessageType::ClientRst;
+            msg.type = ProtocolMessageType::ClientRst;
             return true;
         }
         // Unknown client command
@@ -447,40 +1175,31 @@ bool ProtocolCodec::parseLine(const String &line,
     return false;
 }
 
-String ProtocolCodec::buildHostRst() {
-    String msg = F("H;RST");
-    msg += "\r\n";
-    return msg;
-}
-
-String ProtocolCodec::buildClientRst() {
-    String msg = F("C;RST");
-    msg += "\r\n";
-    return msg;
-}
-
-String ProtocolCodec::buildHostUpd(uint16_t setMask, uint16_t clrMask) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "H;UPD;%04X;%04X\r\n", setMask, clrMask);
-    return String(buf);
-}
-
-String ProtocolCodec::buildHostTog(uint16_t togMask) {
-    char buf[24];
-    snprintf(buf, sizeof(buf), "H;TOG;%04X\r\n", togMask);
-    return String(buf);
-}
-
-String ProtocolCodec::buildClientAckUpd(uint16_t newMask) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "C;ACK;UPD;%04X\r\n", newMask);
-    return String(buf);
-}
+/**
+ * @brief Legacy String-based entry point.
+ *
+ * Delegates to parseFrame(); `status` is only written for ClientStatus
+ * frames, all other outputs are reset on every call (unchanged contract).
+ */
+bool ProtocolCodec::parseLine(const String &line,
+                              ProtocolMessageType &type,
+                              ProtocolStatus &status,
+                              uint16_t &mask,
+                              int &errorCode,
+                              uint16_t &maskB,
+                              uint16_t &maskC) {
+    ProtocolMessage msg;
+    const bool ok = parseFrame(line.c_str(), line.length(), msg);
 
-String ProtocolCodec::buildClientAckTog(uint16_t newMask) {
-    char buf[32];
-    snprintf(buf, sizeof(buf), "C;ACK;TOG;%04X\r\n", newMask);
-    return String(buf);
+    type = msg.type;
+    mask = msg.mask;
+    errorCode = msg.errorCode;
+    maskB = msg.maskB;
+    maskC = msg.maskC;
+    if (ok && msg.type == ProtocolMessageType::ClientStatus) {
+        status = msg.status;
+    }
+    return ok;
 }
 
 // END OF FILE
\ No newline at end of file
@@ -0,0 +1,349 @@
+//
+// protocol_bin.cpp
+//
+// Binary (COBS + CRC16) encoding of the host/client link protocol.
+// See protocol_bin.h for the wire format.
+//
+// The binary mode carries exactly the same ProtocolMessageType set as the
+// ASCII codec; it only replaces the text representation:
+//
+//   ASCII : C;STATUS;0019;12345;23456;0;0;1120;452\r\n   (~40 bytes)
+//   BIN   : 00 <COBS 18 bytes> 00                        (20 bytes)
+//
+
+#include "protocol_bin.h"
+
+#include <string.h>
+
+// ============================================================================
+//  CRC-16/CCITT-FALSE lookup table (poly 0x1021)
+// ============================================================================
+
+namespace {
+
+struct Crc16Table {
+    uint16_t v[256];
+
+    constexpr Crc16Table() : v() {
+        for (uint16_t i = 0; i < 256; ++i) {
+            uint16_t crc = static_cast<uint16_t>(i << 8);
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+            }
+            v[i] = crc;
+        }
+    }
+};
+
+constexpr Crc16Table kCrc16Table;
+
+// Payload length per message type; -1 = not allowed in binary mode.
+int8_t payload_len(ProtocolMessageType type) {
+    switch (type) {
+    case ProtocolMessageType::HostGetStatus:
+    case ProtocolMessageType::HostPing:
+    case ProtocolMessageType::HostRst:
+    case ProtocolMessageType::ClientPong:
+    case ProtocolMessageType::ClientRst:
+        return 0;
+    case ProtocolMessageType::HostSet:
+    case ProtocolMessageType::HostTog:
+    case ProtocolMessageType::HostBin:
+    case ProtocolMessageType::ClientAckSet:
+    case ProtocolMessageType::ClientAckUpd:
+    case ProtocolMessageType::ClientAckTog:
+    case ProtocolMessageType::ClientAckBin:
+    case ProtocolMessageType::ClientAckSub:
+    case ProtocolMessageType::HostBaud:
+    case ProtocolMessageType::ClientAckBaud:
+        return 2;
+    case ProtocolMessageType::HostUpd:
+    case ProtocolMessageType::HostSub:
+    case ProtocolMessageType::HostAct:
+    case ProtocolMessageType::ClientErrSet:
+        return 4;
+    case ProtocolMessageType::ClientStatus:
+        return 14;
+    case ProtocolMessageType::ClientAckAct:
+        return 16;
+    default:
+        return -1;
+    }
+}
+
+// Types that may carry an optional trailing sequence byte.
+bool has_seq_field(ProtocolMessageType type) {
+    switch (type) {
+    case ProtocolMessageType::HostSet:
+    case ProtocolMessageType::HostUpd:
+    case ProtocolMessageType::HostTog:
+    case ProtocolMessageType::ClientAckSet:
+    case ProtocolMessageType::ClientAckUpd:
+    case ProtocolMessageType::ClientAckTog:
+    case ProtocolMessageType::HostAct:
+    case ProtocolMessageType::ClientAckAct:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Types whose STATUS may be followed by the sample fields.
+bool has_sample_ext(ProtocolMessageType type) {
+    return type == ProtocolMessageType::ClientStatus || type == ProtocolMessageType::ClientAckAct;
+}
+
+inline void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v & 0xFF);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline uint16_t get_u16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// Packed ProtocolStatus (14 bytes): mask, adc[4], hotspot, chamber.
+void put_status(uint8_t *p, const ProtocolStatus &st) {
+    put_u16(p, st.outputsMask);
+    for (uint8_t i = 0; i < 4; ++i) {
+        put_u16(p + 2 + 2 * i, static_cast<uint16_t>(st.adcRaw[i]));
+    }
+    put_u16(p + 10, static_cast<uint16_t>(st.tempHotspot_dC));
+    put_u16(p + 12, static_cast<uint16_t>(st.tempChamber_dC));
+}
+
+void get_status(const uint8_t *p, ProtocolStatus &st) {
+    st.outputsMask = get_u16(p);
+    for (uint8_t i = 0; i < 4; ++i) {
+        st.adcRaw[i] = static_cast<int16_t>(get_u16(p + 2 + 2 * i));
+    }
+    st.tempHotspot_dC = static_cast<int16_t>(get_u16(p + 10));
+    st.tempChamber_dC = static_cast<int16_t>(get_u16(p + 12));
+}
+
+} // namespace
+
+// ============================================================================
+//  CRC16
+// ============================================================================
+
+uint16_t ProtocolBinCodec::crc16(const uint8_t *data, size_t len, uint16_t crc) {
+    for (size_t i = 0; i < len; ++i) {
+        crc = static_cast<uint16_t>((crc << 8) ^ kCrc16Table.v[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+    return crc;
+}
+
+// ============================================================================
+//  COBS
+// ============================================================================
+
+size_t ProtocolBinCodec::cobsEncode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    if (out == nullptr || cap == 0) {
+        return 0;
+    }
+
+    size_t codePos = 0; // position of the current code byte
+    size_t o = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < len; ++i) {
+        if (in[i] == 0) {
+            out[codePos] = code;
+            codePos = o++;
+            code = 1;
+        } else {
+            if (o >= cap) {
+                return 0;
+            }
+            out[o++] = in[i];
+            ++code;
+            if (code == 0xFF) {
+                out[codePos] = code;
+                codePos = o++;
+                code = 1;
+            }
+        }
+        if (codePos >= cap) {
+            return 0;
+        }
+    }
+
+    out[codePos] = code;
+    return o;
+}
+
+size_t ProtocolBinCodec::cobsDecode(const uint8_t *in, size_t len, uint8_t *out, size_t cap) {
+    size_t i = 0;
+    size_t o = 0;
+
+    while (i < len) {
+        const uint8_t code = in[i++];
+        if (code == 0) {
+            return 0; // delimiter inside block
+        }
+        for (uint8_t k = 1; k < code; ++k) {
+            if (i >= len || in[i] == 0 || o >= cap) {
+                return 0;
+            }
+            out[o++] = in[i++];
+        }
+        // Implicit zero between groups (not after the last group, not after 0xFF).
+        if (code != 0xFF && i < len) {
+            if (o >= cap) {
+                return 0;
+            }
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+// ============================================================================
+//  Frame encode / decode
+// ============================================================================
+
+/**
+ * @brief Encode one message as a complete binary frame.
+ *
+ *   0x00 | COBS(type | payload | crc16) | 0x00
+ */
+size_t ProtocolBinCodec::encode(const ProtocolMessage &msg, uint8_t *out, size_t cap) {
+    const int8_t plen = payload_len(msg.type);
+    if (plen < 0 || out == nullptr || cap < 2) {
+        return 0;
+    }
+
+    uint8_t rec[kMaxRecordLen];
+    rec[0] = static_cast<uint8_t>(msg.type);
+    uint8_t *p = rec + 1;
+
+    switch (msg.type) {
+    case ProtocolMessageType::HostUpd:
+    case ProtocolMessageType::HostSub:
+    case ProtocolMessageType::HostAct:
+        put_u16(p, msg.mask);
+        put_u16(p + 2, msg.maskB);
+        break;
+    case ProtocolMessageType::ClientErrSet: {
+        const uint32_t e = static_cast<uint32_t>(msg.errorCode);
+        put_u16(p, static_cast<uint16_t>(e & 0xFFFF));
+        put_u16(p + 2, static_cast<uint16_t>(e >> 16));
+        break;
+    }
+    case ProtocolMessageType::ClientStatus:
+        put_status(p, msg.status);
+        break;
+    case ProtocolMessageType::ClientAckAct:
+        put_u16(p, msg.mask);
+        put_status(p + 2, msg.status);
+        break;
+    default:
+        if (plen == 2) {
+            put_u16(p, msg.mask);
+        }
+        break;
+    }
+
+    size_t recLen = 1 + static_cast<size_t>(plen);
+    if (has_sample_ext(msg.type) && msg.status.sampleSeq != 0) {
+        put_u16(rec + recLen, msg.status.sampleSeq);
+        put_u16(rec + recLen + 2, msg.status.sampleAgeMs);
+        put_u16(rec + recLen + 4, msg.status.sensorFaults);
+        recLen += kSampleExtLen;
+    }
+    if (msg.seq != 0 && has_seq_field(msg.type)) {
+        rec[recLen++] = msg.seq;
+    }
+    put_u16(rec + recLen, crc16(rec, recLen));
+
+    out[0] = kDelimiter;
+    const size_t n = cobsEncode(rec, recLen + 2, out + 1, cap - 2);
+    if (n == 0) {
+        return 0;
+    }
+    out[1 + n] = kDelimiter;
+    return n + 2;
+}
+
+/**
+ * @brief Decode one COBS block (without delimiters) into a message.
+ */
+bool ProtocolBinCodec::decode(const uint8_t *block, size_t len, ProtocolMessage &msg) {
+    memset(&msg, 0, sizeof(msg));
+    msg.type = ProtocolMessageType::Unknown;
+
+    if (block == nullptr || len == 0 || len > kMaxCobsLen) {
+        return false;
+    }
+
+    uint8_t rec[kMaxRecordLen + 1];
+    const size_t n = cobsDecode(block, len, rec, sizeof(rec));
+    if (n < 3) {
+        return false;
+    }
+
+    const ProtocolMessageType type = static_cast<ProtocolMessageType>(rec[0]);
+    const int8_t plen = payload_len(type);
+    if (plen < 0) {
+        return false;
+    }
+
+    size_t baseLen = 1 + static_cast<size_t>(plen);
+    const bool withSample = has_sample_ext(type) && (n == baseLen + kSampleExtLen + 2 ||
+                                                     (has_seq_field(type) && n == baseLen + kSampleExtLen + 1 + 2));
+    if (withSample) {
+        baseLen += kSampleExtLen;
+    }
+    const bool withSeq = has_seq_field(type) && n == baseLen + 1 + 2;
+    if (n != baseLen + 2 && !withSeq) {
+        return false;
+    }
+
+    const size_t recLen = withSeq ? baseLen + 1 : baseLen;
+    if (crc16(rec, recLen) != get_u16(rec + recLen)) {
+        return false;
+    }
+    if (withSeq) {
+        if (rec[baseLen] == 0) {
+            return false;
+        }
+        msg.seq = rec[baseLen];
+    }
+
+    const uint8_t *p = rec + 1;
+    switch (type) {
+    case ProtocolMessageType::HostUpd:
+    case ProtocolMessageType::HostSub:
+    case ProtocolMessageType::HostAct:
+        msg.mask = get_u16(p);
+        msg.maskB = get_u16(p + 2);
+        break;
+    case ProtocolMessageType::ClientErrSet:
+        msg.errorCode = static_cast<int>(static_cast<int32_t>(get_u16(p) | (static_cast<uint32_t>(get_u16(p + 2)) << 16)));
+        break;
+    case ProtocolMessageType::ClientStatus:
+        get_status(p, msg.status);
+        break;
+    case ProtocolMessageType::ClientAckAct:
+        msg.mask = get_u16(p);
+        get_status(p + 2, msg.status);
+        break;
+    default:
+        if (plen == 2) {
+            msg.mask = get_u16(p);
+        }
+        break;
+    }
+    if (withSample) {
+        const uint8_t *ext = rec + baseLen - kSampleExtLen;
+        msg.status.sampleSeq = get_u16(ext);
+        msg.status.sampleAgeMs = get_u16(ext + 2);
+        msg.status.sensorFaults = get_u16(ext + 4);
+    }
+
+    msg.type = type;
+    return true;
+}
+
+// END OF FILE
@@ -0,0 +1,309 @@
+#include "timer_wheel.h"
+
+#include <string.h>
+
+namespace {
+
+constexpr uint32_t kSlotMask = TimerWheel::kSlots - 1u;
+
+// Wrap-safe "a is before b" on the 32-bit millis() clock.
+inline bool time_before(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) < 0; }
+
+inline uint64_t rotate_right(uint64_t bits, uint8_t n) {
+    return n == 0 ? bits : (bits >> n) | (bits << (64u - n));
+}
+
+} // namespace
+
+void TimerWheel::reset(uint32_t nowMs) {
+    memset(_timers, 0, sizeof(_timers));
+    memset(_heads, kNil, sizeof(_heads));
+    memset(_occupied, 0, sizeof(_occupied));
+    _now = nowMs;
+    _dispatchNow = nowMs;
+    _dispatching = false;
+    _armedCount = 0;
+}
+
+TimerWheel::TimerId TimerWheel::allocate(const char *name, Callback cb, void *ctx, uint32_t periodMs) {
+    if (!cb) {
+        return kInvalidTimer;
+    }
+    for (uint8_t i = 0; i < kMaxTimers; ++i) {
+        Timer &t = _timers[i];
+        if (!t.used) {
+            memset(&t, 0, sizeof(t));
+            t.used = true;
+            t.cb = cb;
+            t.ctx = ctx;
+            t.name = name;
+            t.periodMs = periodMs;
+            t.prev = kNil;
+            t.next = kNil;
+            return i;
+        }
+    }
+    return kInvalidTimer;
+}
+
+TimerWheel::TimerId TimerWheel::startOneShot(const char *name, uint32_t delayMs, Callback cb, void *ctx) {
+    const TimerId id = allocate(name, cb, ctx, 0);
+    if (id != kInvalidTimer) {
+        restart(id, delayMs);
+    }
+    return id;
+}
+
+TimerWheel::TimerId TimerWheel::startPeriodic(const char *name, uint32_t periodMs, Callback cb, void *ctx,
+                                              uint32_t firstDelayMs) {
+    const TimerId id = allocate(name, cb, ctx, periodMs > 0 ? periodMs : 1u);
+    if (id != kInvalidTimer) {
+        restart(id, firstDelayMs);
+    }
+    return id;
+}
+
+bool TimerWheel::restart(TimerId id, uint32_t delayMs) {
+    if (id >= kMaxTimers || !_timers[id].used) {
+        return false;
+    }
+    // The slot of _now has already been expired: the earliest deadline
+    // that can still fire is the next tick.
+    uint32_t deadline = baseTime() + delayMs;
+    if (!time_before(_now, deadline)) {
+        deadline = _now + 1u;
+    }
+    arm(id, deadline);
+    return true;
+}
+
+bool TimerWheel::stop(TimerId id) {
+    if (id >= kMaxTimers || !_timers[id].used) {
+        return false;
+    }
+    Timer &t = _timers[id];
+    if (t.armed) {
+        unlink(id);
+        t.armed = false;
+        _armedCount--;
+    }
+    return true;
+}
+
+bool TimerWheel::remove(TimerId id) {
+    if (!stop(id)) {
+        return false;
+    }
+    _timers[id].used = false;
+    return true;
+}
+
+bool TimerWheel::armed(TimerId id) const { return id < kMaxTimers && _timers[id].used && _timers[id].armed; }
+
+const char *TimerWheel::name(TimerId id) const {
+    return (id < kMaxTimers && _timers[id].used) ? _timers[id].name : nullptr;
+}
+
+const TimerWheel::Stats *TimerWheel::stats(TimerId id) const {
+    return (id < kMaxTimers && _timers[id].used) ? &_timers[id].stats : nullptr;
+}
+
+void TimerWheel::resetStats() {
+    for (Timer &t : _timers) {
+        memset(&t.stats, 0, sizeof(t.stats));
+    }
+}
+
+void TimerWheel::arm(uint8_t idx, uint32_t deadline) {
+    Timer &t = _timers[idx];
+    if (t.armed) {
+        unlink(idx);
+    } else {
+        t.armed = true;
+        _armedCount++;
+    }
+    t.deadline = deadline;
+    link(idx);
+}
+
+/**
+ * @brief File a timer into the slot that covers its deadline.
+ *
+ * Level L holds deadlines less than 64^(L+1) ms ahead of _now, in the slot
+ * of bits [6L, 6L+6) of the deadline. A slot above level 0 is emptied
+ * (cascade()) when _now reaches the start of its span, so every timer
+ * moves down at most kLevels - 1 times. A deadline beyond kMaxDelayMs is
+ * parked in the top level and re-filed from there.
+ */
+void TimerWheel::link(uint8_t idx) {
+    Timer &t = _timers[idx];
+    uint32_t delta = t.deadline - _now;
+    if (delta > kMaxDelayMs) {
+        delta = kMaxDelayMs;
+    }
+    const uint32_t filed = _now + delta;
+
+    uint8_t level = 0;
+    while (level < kLevels - 1 && (delta >> (kLevelBits * (level + 1))) != 0) {
+        level++;
+    }
+    const uint8_t slot = static_cast<uint8_t>((filed >> (kLevelBits * level)) & kSlotMask);
+
+    t.level = level;
+    t.slot = slot;
+    t.prev = kNil;
+    t.next = _heads[level][slot];
+    if (t.next != kNil) {
+        _timers[t.next].prev = idx;
+    }
+    _heads[level][slot] = idx;
+    _occupied[level] |= (1ull << slot);
+}
+
+void TimerWheel::unlink(uint8_t idx) {
+    Timer &t = _timers[idx];
+    if (t.prev != kNil) {
+        _timers[t.prev].next = t.next;
+    } else {
+        _heads[t.level][t.slot] = t.next;
+        if (t.next == kNil) {
+            _occupied[t.level] &= ~(1ull << t.slot);
+        }
+    }
+    if (t.next != kNil) {
+        _timers[t.next].prev = t.prev;
+    }
+    t.prev = kNil;
+    t.next = kNil;
+}
+
+void TimerWheel::cascade(uint8_t level) {
+    const uint8_t slot = static_cast<uint8_t>((_now >> (kLevelBits * level)) & kSlotMask);
+    uint8_t idx = _heads[level][slot];
+    if (idx == kNil) {
+        return;
+    }
+    // Detach the whole list first: a parked timer may be filed straight
+    // back into this slot.
+    _heads[level][slot] = kNil;
+    _occupied[level] &= ~(1ull << slot);
+    while (idx != kNil) {
+        const uint8_t next = _timers[idx].next;
+        link(idx);
+        idx = next;
+    }
+}
+
+size_t TimerWheel::expireSlot(uint32_t nowMs) {
+    const uint8_t slot = static_cast<uint8_t>(_now & kSlotMask);
+    size_t calls = 0;
+
+    // Pop one at a time, a callback may stop or re-arm any other timer.
+    uint8_t idx;
+    while ((idx = _heads[0][slot]) != kNil) {
+        Timer &t = _timers[idx];
+        unlink(idx);
+
+        const uint32_t late = nowMs - t.deadline;
+        t.stats.calls++;
+        t.stats.lateLastMs = late;
+        t.stats.lateSumMs += late;
+        if (late > t.stats.lateMaxMs) {
+            t.stats.lateMaxMs = late;
+        }
+
+        if (t.periodMs > 0) {
+            // Keep the phase; coalesce periods that are already over.
+            uint32_t next = t.deadline + t.periodMs;
+            if (!time_before(nowMs, next)) {
+                const uint32_t skipped = late / t.periodMs;
+                t.stats.missed += skipped;
+                next = t.deadline + (skipped + 1u) * t.periodMs;
+            }
+            t.deadline = next;
+            link(idx);
+        } else {
+            t.armed = false;
+            _armedCount--;
+        }
+
+        calls++;
+        t.cb(t.ctx);
+    }
+    return calls;
+}
+
+size_t TimerWheel::advance(uint32_t nowMs) {
+    size_t calls = 0;
+    _dispatching = true;
+    _dispatchNow = nowMs;
+
+    while (time_before(_now, nowMs)) {
+        if (_armedCount == 0) {
+            _now = nowMs;
+            break;
+        }
+
+        uint32_t t = _now + 1u;
+        if ((t & kSlotMask) != 0) {
+            // Inside one level-0 round: jump to the next occupied slot, or
+            // to the end of the round if there is none.
+            const uint64_t ahead = _occupied[0] & (~0ull << (t & kSlotMask));
+            t = ahead ? (_now & ~kSlotMask) + static_cast<uint32_t>(__builtin_ctzll(ahead)) : (_now | kSlotMask);
+            if (time_before(nowMs, t)) {
+                _now = nowMs;
+                break;
+            }
+            _now = t;
+            if (!ahead) {
+                continue;
+            }
+        } else {
+            // Round boundary: move the timers of the next span down, the
+            // highest level first.
+            _now = t;
+            uint8_t top = 1;
+            while (top < kLevels - 1 && ((_now >> (kLevelBits * top)) & kSlotMask) == 0) {
+                top++;
+            }
+            for (uint8_t level = top; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+        calls += expireSlot(nowMs);
+    }
+
+    _dispatching = false;
+    return calls;
+}
+
+uint32_t TimerWheel::msUntilNext(uint32_t nowMs) const {
+    if (_armedCount == 0) {
+        return kNever;
+    }
+
+    // The slots of one level cover consecutive spans of time, so the first
+    // occupied slot after the current one holds that level's earliest
+    // deadline (parked timers only sort later).
+    uint32_t best = kNever;
+    for (uint8_t level = 0; level < kLevels; ++level) {
+        if (_occupied[level] == 0) {
+            continue;
+        }
+        const uint8_t shift = kLevelBits * level;
+        const uint32_t round = (_now >> shift) + 1u;
+        const uint64_t ahead = rotate_right(_occupied[level], static_cast<uint8_t>(round & kSlotMask));
+        const uint8_t slot = static_cast<uint8_t>((round + __builtin_ctzll(ahead)) & kSlotMask);
+        for (uint8_t idx = _heads[level][slot]; idx != kNil; idx = _timers[idx].next) {
+            const uint32_t delta = _timers[idx].deadline - _now;
+            if (delta < best) {
+                best = delta;
+            }
+        }
+    }
+
+    const uint32_t at = _now + best;
+    return time_before(nowMs, at) ? at - nowMs : 0u;
+}
+
+// EOF
@@ -8,7 +8,7 @@
  * Expected behavior:
  * - Host can request STATUS multiple times and receives valid STATUS.
  * - adcRaw[] stays within 0..4095 (typical ESP32 ADC raw range).
- * - tempRaw is within a plausible int16 range. If temp is unused it may be 0.
+ * - tempHotspot_dC / tempChamber_dC are plausible (°C x10). Unused sensors may report 0.
  * - Link stays synced, no comm error.
  */
 
@@ -128,10 +128,10 @@ class Test_AdcTempPlausibility : public ITestCase {
                       (unsigned)comm.hasCommError(),
                       (unsigned)comm.lastPongReceived());
 
-        Serial.printf("- Last STATUS: mask=0x%04X adc=[%u,%u,%u,%u] tempRaw=%d okSamples=%u/%u\n",
+        Serial.printf("- Last STATUS: mask=0x%04X adc=[%d,%d,%d,%d] hot_dC=%d chamber_dC=%d okSamples=%u/%u\n",
                       st.outputsMask,
                       st.adcRaw[0], st.adcRaw[1], st.adcRaw[2], st.adcRaw[3],
-                      (int)st.tempRaw,
+                      (int)st.tempHotspot_dC, (int)st.tempChamber_dC,
                       (unsigned)_okCount,
                       (unsigned)kRequiredOkSamples);
 
@@ -151,18 +151,17 @@ class Test_AdcTempPlausibility : public ITestCase {
     static bool plausible(const ProtocolStatus &st) {
         // ADC plausibility (raw). If you use different width/scaling, adjust here.
         for (int i = 0; i < 4; ++i) {
-            if (st.adcRaw[i] > 4095u) {
+            if (st.adcRaw[i] < 0 || st.adcRaw[i] > 4095) {
                 return false;
             }
         }
 
-        // tempRaw plausibility:
-        // tempRaw is in 0.25°C units, int16 range.
+        // Temperature plausibility (°C x10, both NTC channels):
         // Accept 0 (unused). Otherwise accept roughly -50°C..+500°C by default.
         // Adjust if your sensor range is different.
-        const int t = (int)st.tempRaw;
-        if (t != 0) {
-            if (t < (-50 * 4) || t > (500 * 4)) {
+        const int temps[] = {(int)st.tempHotspot_dC, (int)st.tempChamber_dC};
+        for (int t : temps) {
+            if (t != 0 && (t < (-50 * 10) || t > (500 * 10))) {
                 return false;
             }
         }
@@ -42,6 +42,7 @@ class Test_HoldStatusVerify : public ITestCase {
 
         _tStartMs = nowMs;
         _deadlineMs = nowMs + kTotalTimeoutMs;
+        _syncStartMs = 0;
         _nextPingMs = nowMs;
         _nextStatusMs = nowMs;
 
@@ -124,10 +125,10 @@ class Test_HoldStatusVerify : public ITestCase {
             (unsigned)comm.hasNewStatus(),
             (unsigned)comm.getLocalOutputsMask(),
             (unsigned)comm.getRemoteOutputsMask());
-        RAW("- Status: mask=0x%04X adc=[%u,%u,%u,%u] tempRaw=%d\n",
+        RAW("- Status: mask=0x%04X adc=[%u,%u,%u,%u] hot_dC=%d chamber_dC=%d\n",
             (unsigned)st.outputsMask,
             (unsigned)st.adcRaw[0], (unsigned)st.adcRaw[1], (unsigned)st.adcRaw[2], (unsigned)st.adcRaw[3],
-            (int)st.tempRaw);
+            (int)st.tempHotspot_dC, (int)st.tempChamber_dC);
         RAW("- Counters: okStatus=%u badStatus=%u\n", (unsigned)_okStatusCount, (unsigned)_badStatusCount);
         RAW("- LastBadLine: '%s'\n", comm.lastBadLine().c_str());
         RAW("----------------------------------------------\n");
@@ -149,7 +150,7 @@ class Test_HoldStatusVerify : public ITestCase {
     static constexpr uint32_t kPingPeriodMs = 200;
     static constexpr uint32_t kStatusPeriodMs = 250;
 
-    static constexpr uint16_t kTestMask = 0x00A5; // matches your existing LED pattern usage
+    static constexpr uint16_t kTestMask = 0x0085; // CH0, CH2, CH7 (CH5 is the door input, never driven)
     static constexpr uint8_t kMinStatusOk = 3;
 
     // --- state ---
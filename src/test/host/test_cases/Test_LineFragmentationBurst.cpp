@@ -42,10 +42,10 @@ class Test_LineFragmentationBurst : public ITestCase {
 
         // Phase B: STATUS fragmented into chunks (valid frame)
         // Use a valid STATUS line your ProtocolCodec supports:
-        // C;STATUS;<mask>;<a0>;<a1>;<a2>;<a3>;<temp>\r\n
+        // C;STATUS;<mask>;<a0>;<a1>;<a2>;<a3>;<hot_dC>;<chamber_dC>\r\n
         feedChunks(comm, {"C;STATUS;00",
                           "A5;1;2;3",
-                          ";4;5\r\n"});
+                          ";4;5;6\r\n"});
 
         // Phase C: Burst: two PONG frames in one chunk (should sync link)
         feedChunk(comm, "C;PONG\r\nC;PONG\r\n");
@@ -106,6 +106,7 @@ class Test_LineFragmentationBurst : public ITestCase {
     }
 
     void exit(HostComm &comm, uint32_t nowMs) override {
+        (void)comm;
         (void)nowMs;
         // keep status for dump; optionally clear:
         // comm.clearNewStatusFlag();
@@ -6,17 +6,19 @@
  *     SET -> UPD -> TOG -> GET/STATUS
  *   and that the remote mask and STATUS agree with the expected final state.
  *
+ *   SET, UPD and TOG are pipelined (command window 4, sequence numbers) and
+ *   sent back-to-back instead of waiting one round trip + visual hold each.
+ *
  * Expected behavior:
- *   - After SET(0x0001): client ACK;SET and remote mask becomes 0x0001 (CH0 ON)
- *   - After UPD(set=0x0002, clr=0x0000): client ACK;UPD and remote mask becomes 0x0003 (CH0+CH1 ON)
- *   - After TOG(0x0001): client ACK;TOG and remote mask becomes 0x0002 (CH1 ON)
+ *   - Client applies SET(0x0001), UPD(set=0x0002) -> 0x0003, TOG(0x0001) -> 0x0002
+ *     strictly in order and ACKs each command with its sequence number
+ *   - All three commands are acknowledged (none failed or dropped)
+ *   - Remote mask after the last ACK is 0x0002 (CH1 ON)
  *   - After GET/STATUS: client STATUS mask == 0x0002
  *
  * Visual expectation:
- *   On the client LEDs (CH0..CH7), you should see:
- *     - CH0 ON briefly
- *     - then CH0+CH1 ON briefly
- *     - then CH1 ON briefly
+ *   On the client LEDs (CH0..CH7), you should see CH1 ON (the intermediate
+ *   states only last a few milliseconds).
  */
 
 #include "HostComm.h"
@@ -43,6 +45,12 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
         comm.clearNewStatusFlag();
         comm.clearLinkSync();
 
+        _prevWindow = comm.commandWindow();
+        comm.setCommandWindow(kCommandWindow);
+        _ackedAtStart = comm.cmdAckedCount();
+        _failedAtStart = comm.cmdFailedCount();
+        _droppedAtStart = comm.cmdDroppedCount();
+
         _phase = Phase::Sync;
     }
 
@@ -70,99 +78,51 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
 
             // we accept linkSynced() as readiness
             if (comm.linkSynced()) {
-                _detail = "synced; sending SET";
-                _phase = Phase::SendSet;
+                _detail = "synced; sending SET/UPD/TOG";
+                _phase = Phase::SendBurst;
                 _stepDeadlineMs = nowMs + kStepTimeoutMs;
             }
             return;
 
-        case Phase::SendSet:
-            // Visual: CH0 ON
-            comm.clearLastSetAckFlag();
+        case Phase::SendBurst:
+            // Pipelined: all three commands go out back-to-back (window 4).
             comm.setOutputsMask(kMaskSet);
-            _expectedMask = kMaskSet;
-            _detail = "waiting ACK;SET";
-            _phase = Phase::WaitAckSet;
-            _stepDeadlineMs = nowMs + kStepTimeoutMs;
-            return;
-
-        case Phase::WaitAckSet:
-            if (comm.lastSetAcked() && comm.getRemoteOutputsMask() == kMaskSet) {
-                _detail = "SET ok; visual hold";
-                _holdUntilMs = nowMs + kVisualHoldMs;
-                _phase = Phase::HoldAfterSet;
-                return;
-            }
-            if ((int32_t)(nowMs - _stepDeadlineMs) >= 0) {
-                _detail = "timeout waiting ACK;SET";
-                _verdict = TestVerdict::Fail;
-                return;
-            }
-            return;
-
-        case Phase::HoldAfterSet:
-            if ((int32_t)(nowMs - _holdUntilMs) >= 0) {
-                _detail = "sending UPD";
-                _phase = Phase::SendUpd;
-                _stepDeadlineMs = nowMs + kStepTimeoutMs;
-            }
-            return;
-
-        case Phase::SendUpd:
-            // Visual: CH0+CH1 ON
             comm.updOutputs(kUpdSetMask, kUpdClrMask);
-            _expectedMask = (uint16_t)((kMaskSet | kUpdSetMask) & (uint16_t)~kUpdClrMask); // should be 0x0003
-            _detail = "waiting ACK;UPD";
-            _phase = Phase::WaitAckUpd;
-            _stepDeadlineMs = nowMs + kStepTimeoutMs;
-            return;
-
-        case Phase::WaitAckUpd:
-            if (comm.getRemoteOutputsMask() == _expectedMask) {
-                _detail = "UPD ok; visual hold";
-                _holdUntilMs = nowMs + kVisualHoldMs;
-                _phase = Phase::HoldAfterUpd;
-                return;
-            }
-            if ((int32_t)(nowMs - _stepDeadlineMs) >= 0) {
-                _detail = "timeout waiting ACK;UPD";
-                _verdict = TestVerdict::Fail;
-                return;
-            }
-            return;
-
-        case Phase::HoldAfterUpd:
-            if ((int32_t)(nowMs - _holdUntilMs) >= 0) {
-                _detail = "sending TOG";
-                _phase = Phase::SendTog;
-                _stepDeadlineMs = nowMs + kStepTimeoutMs;
-            }
-            return;
-
-        case Phase::SendTog:
-            // Visual: CH1 only (toggle CH0 off)
             comm.togOutputs(kTogMask);
-            _expectedMask = (uint16_t)(kExpectedAfterUpd ^ kTogMask); // 0x0003 ^ 0x0001 = 0x0002
-            _detail = "waiting ACK;TOG";
-            _phase = Phase::WaitAckTog;
+            _expectedMask = kExpectedFinal;
+            _detail = "waiting ACK;SET/UPD/TOG";
+            _phase = Phase::WaitBurstAcks;
             _stepDeadlineMs = nowMs + kStepTimeoutMs;
             return;
 
-        case Phase::WaitAckTog:
-            if (comm.getRemoteOutputsMask() == _expectedMask) {
-                _detail = "TOG ok; visual hold";
+        case Phase::WaitBurstAcks:
+            if (comm.commandsPending() == 0) {
+                const uint32_t acked = comm.cmdAckedCount() - _ackedAtStart;
+                const uint32_t lost = (comm.cmdFailedCount() - _failedAtStart) +
+                                      (comm.cmdDroppedCount() - _droppedAtStart);
+                if (acked != kBurstCommands || lost != 0) {
+                    _detail = "command lost (acked != 3)";
+                    _verdict = TestVerdict::Fail;
+                    return;
+                }
+                if (comm.getRemoteOutputsMask() != _expectedMask) {
+                    _detail = "ACK mask mismatch after SET/UPD/TOG";
+                    _verdict = TestVerdict::Fail;
+                    return;
+                }
+                _detail = "SET/UPD/TOG ok; visual hold";
                 _holdUntilMs = nowMs + kVisualHoldMs;
-                _phase = Phase::HoldAfterTog;
+                _phase = Phase::HoldAfterBurst;
                 return;
             }
             if ((int32_t)(nowMs - _stepDeadlineMs) >= 0) {
-                _detail = "timeout waiting ACK;TOG";
+                _detail = "timeout waiting ACK;SET/UPD/TOG";
                 _verdict = TestVerdict::Fail;
                 return;
             }
             return;
 
-        case Phase::HoldAfterTog:
+        case Phase::HoldAfterBurst:
             if ((int32_t)(nowMs - _holdUntilMs) >= 0) {
                 _detail = "requesting STATUS";
                 _phase = Phase::SendStatusReq;
@@ -201,6 +161,7 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
 
     void exit(HostComm &comm, uint32_t /*nowMs*/) override {
         // keep it clean for next test
+        comm.setCommandWindow(_prevWindow);
         comm.clearLastSetAckFlag();
         comm.clearNewStatusFlag();
         comm.clearLastPongFlag();
@@ -241,18 +202,27 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
             (unsigned)comm.lastSetAcked(),
             (unsigned)comm.hasNewStatus());
 
+        RAW("- Cmds: sent=%lu acked=%lu retx=%lu failed=%lu dropped=%lu dupAck=%lu\n",
+            (unsigned long)comm.cmdSentCount(),
+            (unsigned long)comm.cmdAckedCount(),
+            (unsigned long)comm.cmdRetransmitCount(),
+            (unsigned long)comm.cmdFailedCount(),
+            (unsigned long)comm.cmdDroppedCount(),
+            (unsigned long)comm.cmdDupAckCount());
+
         RAW("- Masks: local=0x%04X remote=0x%04X expected=0x%04X\n",
             comm.getLocalOutputsMask(),
             comm.getRemoteOutputsMask(),
             _expectedMask);
 
-        RAW("- Status: mask=0x%04X adc=[%u,%u,%u,%u] tempRaw=%d\n",
+        RAW("- Status: mask=0x%04X adc=[%u,%u,%u,%u] hot_dC=%d chamber_dC=%d\n",
             comm.getRemoteStatus().outputsMask,
             comm.getRemoteStatus().adcRaw[0],
             comm.getRemoteStatus().adcRaw[1],
             comm.getRemoteStatus().adcRaw[2],
             comm.getRemoteStatus().adcRaw[3],
-            comm.getRemoteStatus().tempRaw);
+            comm.getRemoteStatus().tempHotspot_dC,
+            comm.getRemoteStatus().tempChamber_dC);
 
         RAW("----------------------------------------------\n");
     }
@@ -260,15 +230,9 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
   private:
     enum class Phase : uint8_t {
         Sync = 0,
-        SendSet,
-        WaitAckSet,
-        HoldAfterSet,
-        SendUpd,
-        WaitAckUpd,
-        HoldAfterUpd,
-        SendTog,
-        WaitAckTog,
-        HoldAfterTog,
+        SendBurst,
+        WaitBurstAcks,
+        HoldAfterBurst,
         SendStatusReq,
         WaitStatus,
     };
@@ -283,10 +247,13 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
     static constexpr uint16_t kMaskSet = 0x0001;    // CH0
     static constexpr uint16_t kUpdSetMask = 0x0002; // +CH1
     static constexpr uint16_t kUpdClrMask = 0x0000;
-    static constexpr uint16_t kExpectedAfterUpd = 0x0003;
+    static constexpr uint16_t kExpectedAfterUpd = 0x0003; // client state between UPD and TOG
     static constexpr uint16_t kTogMask = 0x0001; // toggle CH0 off -> leaves CH1
     static constexpr uint16_t kExpectedFinal = 0x0002;
 
+    static constexpr uint8_t kCommandWindow = 4;
+    static constexpr uint32_t kBurstCommands = 3;
+
     Phase _phase = Phase::Sync;
 
     uint32_t _tEnterMs = 0;
@@ -296,6 +263,11 @@ class Test_Seq_SetUpdTogStatus : public ITestCase {
 
     uint16_t _expectedMask = 0x0000;
 
+    uint8_t _prevWindow = 0;
+    uint32_t _ackedAtStart = 0;
+    uint32_t _failedAtStart = 0;
+    uint32_t _droppedAtStart = 0;
+
     TestVerdict _verdict = TestVerdict::Running;
     const char *_detail = "init";
 };
@@ -163,7 +163,7 @@ class Test_SetAck : public ITestCase {
 
     static constexpr uint32_t kTimeoutMs = 2500;
     static constexpr uint32_t kPingPeriodMs = 200;
-    static constexpr uint16_t kTestMask = 0x00A5;
+    static constexpr uint16_t kTestMask = 0x0085; // CH0, CH2, CH7 (CH5 is the door input, never driven)
 
     State _state = State::Sync;
 
@@ -177,7 +177,7 @@ class Test_SetAck : public ITestCase {
 
     TestVerdict _verdict = TestVerdict::Running;
     const char *_detail = "init";
-    uint16_t _expectedMask = 0x00A5;
+    uint16_t _expectedMask = kTestMask;
 
     void dump(HostComm &comm) const override {
         Serial.println("--------------------------------------------------");
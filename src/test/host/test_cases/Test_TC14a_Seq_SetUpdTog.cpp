@@ -180,7 +180,7 @@ class Test_TC14a_Seq_SetUpdTog : public ITestCase {
     static constexpr uint32_t kInterStepDelayMs = 80;
 
     // --- Sequence definition (feel free to tweak masks) ---
-    static constexpr uint16_t kMaskSet = 0x00A5;    // 1010 0101
+    static constexpr uint16_t kMaskSet = 0x0085;    // 1000 0101 (CH5 is the door input)
     static constexpr uint16_t kUpdSetMask = 0x0002; // set bit1
     static constexpr uint16_t kUpdClrMask = 0x0004; // clear bit2
     static constexpr uint16_t kTogMask = 0x000F;    // toggle bits0..3
@@ -105,11 +105,11 @@ class Test_TC14b_Status_AfterSeq : public ITestCase {
              (unsigned long)comm.parseFailCount(),
              (int)comm.hasCommError(),
              (int)comm.hasNewStatus());
-        INFO("- STATUS: mask=0x%04X expected=0x%04X adc=[%u,%u,%u,%u] tempRaw=%d\n",
+        INFO("- STATUS: mask=0x%04X expected=0x%04X adc=[%u,%u,%u,%u] hot_dC=%d chamber_dC=%d\n",
              (unsigned)st.outputsMask,
              (unsigned)kExpectedFinalMask,
              st.adcRaw[0], st.adcRaw[1], st.adcRaw[2], st.adcRaw[3],
-             st.tempRaw);
+             st.tempHotspot_dC, st.tempChamber_dC);
         INFO("- LastBadLine: '%s'\n", comm.lastBadLine().c_str());
         INFO("----------------------------------------------\n");
     }
@@ -119,10 +119,10 @@ class Test_TC14b_Status_AfterSeq : public ITestCase {
     static constexpr uint32_t kPingPeriodMs = 200;
 
     // Must match TC14a’s computed final mask:
-    // start: 0x00A5
-    // upd:   (0x00A5 | 0x0002) & ~0x0004 = 0x00A3
-    // tog:   0x00A3 ^ 0x000F = 0x00AC
-    static constexpr uint16_t kExpectedFinalMask = 0x00AC;
+    // start: 0x0085
+    // upd:   (0x0085 | 0x0002) & ~0x0004 = 0x0083
+    // tog:   0x0083 ^ 0x000F = 0x008C
+    static constexpr uint16_t kExpectedFinalMask = 0x008C;
 
     static const char *verdictToText(TestVerdict v) {
         switch (v) {
@@ -66,13 +66,13 @@ class Test_UpdAck : public ITestCase {
         if (_phase == Phase::SendUpd) {
             // Build a deterministic scenario:
             // Start from known 0 via SET (optional but robust), then UPD:
-            // setMask=0x00A5, clrMask=0x0000 => expected=0x00A5
+            // setMask=0x0085, clrMask=0x0000 => expected=0x0085 (CH5 is the door input)
             comm.setOutputsMask(0x0000);
             delay(10); // tiny settle; safe in test context
             comm.clearLastUpdAckFlag();
 
-            comm.updOutputs(0x00A5, 0x0000);
-            _expectedMask = 0x00A5;
+            comm.updOutputs(0x0085, 0x0000);
+            _expectedMask = 0x0085;
 
             _phase = Phase::WaitAck;
             _detail = "waiting for ACK;UPD";
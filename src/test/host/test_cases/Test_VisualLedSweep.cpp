@@ -63,7 +63,7 @@ class Test_VisualLedSweep : public ITestCase {
         Serial.printf("  newStatus       = %d\n", comm.hasNewStatus());
         Serial.printf("  lastSetAcked    = %d\n", comm.lastSetAcked());
         Serial.printf("  commError       = %d\n", comm.hasCommError());
-        Serial.printf("  parseFailCount  = %lu\n", comm.parseFailCount());
+        Serial.printf("  parseFailCount  = %lu\n", (unsigned long)comm.parseFailCount());
 
         Serial.println("\nRemote:");
         Serial.printf("  outputsMask     = 0x%04X\n", comm.getRemoteOutputsMask());
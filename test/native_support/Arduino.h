@@ -0,0 +1,536 @@
+#pragma once
+
+//
+// Arduino.h (native)
+//
+// Minimal, header-only Arduino API surface for the PlatformIO `native`
+// environment. It is ONLY used by the PC-side unit tests and benchmarks under
+// test/test_native_*; the ESP32 targets never see this file.
+//
+// What it provides:
+// - millis()/micros()/delay() on a *virtual* clock (tests advance it)
+// - String with the same small-string optimisation size as the ESP32 core
+//   (11 chars) and a heap allocation counter for benchmarks
+// - HardwareSerial backed by in-memory RX/TX buffers (Serial, Serial2);
+//   the RX side is thread-safe so an RX thread (HostRxTask) can read while
+//   the test thread injects
+//
+// Anything not needed by src/share, src/client/ClientComm.cpp or
+// src/app/oven is intentionally left out.
+//
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Virtual clock + heap accounting
+// -----------------------------------------------------------------------------
+namespace arduino_native {
+
+inline uint64_t &clock_us() {
+    static uint64_t us = 0;
+    return us;
+}
+
+inline void advance_ms(uint32_t ms) { clock_us() += (uint64_t)ms * 1000ull; }
+inline void advance_us(uint32_t us) { clock_us() += us; }
+inline void set_ms(uint32_t ms) { clock_us() = (uint64_t)ms * 1000ull; }
+
+// Counts every heap (re)allocation performed by String.
+inline uint32_t &string_heap_allocs() {
+    static uint32_t n = 0;
+    return n;
+}
+
+// When true, writes to `Serial` are echoed to stdout (useful while debugging).
+inline bool &console_echo() {
+    static bool on = false;
+    return on;
+}
+
+// When set, every write to `Serial` is passed here as well (the oven
+// simulator collects the HOST_PLOT / HOST_LOGIC CSV lines this way).
+using ConsoleSink = void (*)(const char *data, size_t len);
+inline ConsoleSink &console_sink() {
+    static ConsoleSink sink = nullptr;
+    return sink;
+}
+
+} // namespace arduino_native
+
+inline unsigned long millis() { return (unsigned long)(uint32_t)(arduino_native::clock_us() / 1000ull); }
+inline unsigned long micros() { return (unsigned long)(uint32_t)arduino_native::clock_us(); }
+inline void delay(uint32_t ms) { arduino_native::advance_ms(ms); }
+inline void delayMicroseconds(uint32_t us) { arduino_native::advance_us(us); }
+inline void yield() {}
+
+using std::max;
+using std::min;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define DEC 10
+#define HEX 16
+
+#define SERIAL_8N1 0x800001c
+
+class __FlashStringHelper;
+#define F(string_literal) (string_literal)
+
+// -----------------------------------------------------------------------------
+// String
+// -----------------------------------------------------------------------------
+class String {
+  public:
+    String() { init(); }
+    String(const char *cstr) {
+        init();
+        if (cstr) {
+            copy(cstr, (unsigned)strlen(cstr));
+        }
+    }
+    String(const String &other) {
+        init();
+        copy(other.c_str(), other.length());
+    }
+    String(String &&other) noexcept {
+        init();
+        move(other);
+    }
+    explicit String(char c) {
+        init();
+        copy(&c, 1);
+    }
+    explicit String(int value, unsigned char base = 10) { initNumber((long)value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { initUnsigned((unsigned long)value, base); }
+    explicit String(long value, unsigned char base = 10) { initNumber(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { initUnsigned(value, base); }
+    explicit String(unsigned char value, unsigned char base = 10) { initUnsigned(value, base); }
+    explicit String(short value, unsigned char base = 10) { initNumber(value, base); }
+    explicit String(unsigned short value, unsigned char base = 10) { initUnsigned(value, base); }
+    ~String() { release(); }
+
+    String &operator=(const String &rhs) {
+        if (this != &rhs) {
+            copy(rhs.c_str(), rhs.length());
+        }
+        return *this;
+    }
+    String &operator=(String &&rhs) noexcept {
+        if (this != &rhs) {
+            release();
+            init();
+            move(rhs);
+        }
+        return *this;
+    }
+    String &operator=(const char *cstr) {
+        if (cstr) {
+            copy(cstr, (unsigned)strlen(cstr));
+        } else {
+            setLen(0);
+        }
+        return *this;
+    }
+
+    bool concat(const char *cstr, unsigned int n) {
+        if (!cstr || n == 0) {
+            return true;
+        }
+        const unsigned oldLen = _len;
+        if (!reserve(oldLen + n)) {
+            return false;
+        }
+        memmove(wbuf() + oldLen, cstr, n);
+        setLen(oldLen + n);
+        return true;
+    }
+    bool concat(const String &s) { return concat(s.c_str(), s.length()); }
+    bool concat(const char *cstr) { return cstr ? concat(cstr, (unsigned)strlen(cstr)) : false; }
+    bool concat(char c) { return concat(&c, 1); }
+
+    String &operator+=(const String &rhs) {
+        concat(rhs);
+        return *this;
+    }
+    String &operator+=(const char *cstr) {
+        concat(cstr);
+        return *this;
+    }
+    String &operator+=(char c) {
+        concat(c);
+        return *this;
+    }
+
+    unsigned int length() const { return _len; }
+    bool isEmpty() const { return _len == 0; }
+    const char *c_str() const { return _heap ? _heap : _sso; }
+
+    char operator[](unsigned int i) const { return (i < _len) ? c_str()[i] : '\0'; }
+    char charAt(unsigned int i) const { return (*this)[i]; }
+
+    bool equals(const char *cstr) const {
+        if (!cstr) {
+            return _len == 0;
+        }
+        return strcmp(c_str(), cstr) == 0;
+    }
+    bool equals(const String &s) const { return _len == s._len && memcmp(c_str(), s.c_str(), _len) == 0; }
+    bool operator==(const char *cstr) const { return equals(cstr); }
+    bool operator==(const String &s) const { return equals(s); }
+    bool operator!=(const char *cstr) const { return !equals(cstr); }
+    bool operator!=(const String &s) const { return !equals(s); }
+
+    int indexOf(char ch, unsigned int fromIndex = 0) const {
+        if (fromIndex >= _len) {
+            return -1;
+        }
+        const char *p = strchr(c_str() + fromIndex, ch);
+        return p ? (int)(p - c_str()) : -1;
+    }
+    int indexOf(const char *needle, unsigned int fromIndex = 0) const {
+        if (!needle || fromIndex >= _len) {
+            return -1;
+        }
+        const char *p = strstr(c_str() + fromIndex, needle);
+        return p ? (int)(p - c_str()) : -1;
+    }
+
+    String substring(unsigned int left) const { return substring(left, _len); }
+    String substring(unsigned int left, unsigned int right) const {
+        if (left > right) {
+            std::swap(left, right);
+        }
+        String out;
+        if (left >= _len) {
+            return out;
+        }
+        if (right > _len) {
+            right = _len;
+        }
+        out.copy(c_str() + left, right - left);
+        return out;
+    }
+
+    void trim() {
+        if (_len == 0) {
+            return;
+        }
+        const char *b = c_str();
+        unsigned begin = 0;
+        while (begin < _len && isspace((unsigned char)b[begin])) {
+            begin++;
+        }
+        unsigned end = _len;
+        while (end > begin && isspace((unsigned char)b[end - 1])) {
+            end--;
+        }
+        const unsigned n = end - begin;
+        if (begin > 0) {
+            memmove(wbuf(), b + begin, n);
+        }
+        setLen(n);
+    }
+
+    long toInt() const { return (long)(int32_t)clampLong(atoll(c_str())); }
+
+    bool reserve(unsigned int size) {
+        if (size <= capacity()) {
+            return true;
+        }
+        unsigned newCap = size;
+        char *p = (char *)realloc(_heap, newCap + 1);
+        if (!p) {
+            return false;
+        }
+        arduino_native::string_heap_allocs()++;
+        if (!_heap) {
+            memcpy(p, _sso, _len + 1);
+        }
+        _heap = p;
+        _cap = newCap;
+        return true;
+    }
+
+  private:
+    // ESP32 Arduino core: SSO buffer = sizeof(char*) + 2*4 - 1 on 32-bit targets.
+    static constexpr unsigned kSsoCap = 11;
+
+    char _sso[kSsoCap + 1];
+    char *_heap;
+    unsigned _len;
+    unsigned _cap;
+
+    static long long clampLong(long long v) {
+        // ESP32 `long` is 32 bit: atol() saturates like strtol() there.
+        if (v > INT32_MAX) {
+            return INT32_MAX;
+        }
+        if (v < INT32_MIN) {
+            return INT32_MIN;
+        }
+        return v;
+    }
+
+    void init() {
+        _sso[0] = '\0';
+        _heap = nullptr;
+        _len = 0;
+        _cap = kSsoCap;
+    }
+    void release() {
+        free(_heap);
+        _heap = nullptr;
+    }
+    unsigned capacity() const { return _cap; }
+    char *wbuf() { return _heap ? _heap : _sso; }
+    void setLen(unsigned n) {
+        _len = n;
+        wbuf()[n] = '\0';
+    }
+    void copy(const char *src, unsigned n) {
+        if (!reserve(n)) {
+            setLen(0);
+            return;
+        }
+        memmove(wbuf(), src, n);
+        setLen(n);
+    }
+    void move(String &other) {
+        if (other._heap) {
+            _heap = other._heap;
+            _cap = other._cap;
+            _len = other._len;
+            other.init();
+            return;
+        }
+        memcpy(_sso, other._sso, other._len + 1);
+        _len = other._len;
+        other.setLen(0);
+    }
+    void initNumber(long value, unsigned char base) {
+        init();
+        char buf[40];
+        if (base == 10) {
+            snprintf(buf, sizeof(buf), "%ld", value);
+        } else {
+            snprintf(buf, sizeof(buf), "%lx", (unsigned long)value);
+        }
+        copy(buf, (unsigned)strlen(buf));
+    }
+    void initUnsigned(unsigned long value, unsigned char base) {
+        init();
+        char buf[40];
+        snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%lu", value);
+        copy(buf, (unsigned)strlen(buf));
+    }
+};
+
+// Concatenation (the Arduino core uses StringSumHelper for the same purpose).
+inline String operator+(const String &lhs, const String &rhs) {
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+inline String operator+(const String &lhs, const char *rhs) {
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+inline String operator+(const char *lhs, const String &rhs) {
+    String out(lhs);
+    out += rhs;
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Print / HardwareSerial (in-memory)
+// -----------------------------------------------------------------------------
+class HardwareSerial {
+  public:
+    explicit HardwareSerial(bool echoToConsole = false) : _echo(echoToConsole) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1) {
+        (void)config;
+        (void)rxPin;
+        (void)txPin;
+        _baud = baud;
+        _begun = true;
+    }
+    void end() { _begun = false; }
+    void updateBaudRate(unsigned long baud) {
+        if (!_tx.empty()) {
+            _txMarks.push_back({_tx.size(), baud});
+        }
+        _baud = baud;
+    }
+    unsigned long baudRate() const { return _baud; }
+    size_t setRxBufferSize(size_t size) {
+        _rxBufferSize = size;
+        return size;
+    }
+    size_t rxBufferSize() const { return _rxBufferSize; }
+
+    int available() const {
+        std::lock_guard<std::mutex> lock(_rxMutex);
+        return (int)_rx.size();
+    }
+    int read() {
+        std::lock_guard<std::mutex> lock(_rxMutex);
+        if (_rx.empty()) {
+            return -1;
+        }
+        const uint8_t c = _rx.front();
+        _rx.pop_front();
+        return c;
+    }
+    size_t read(uint8_t *buf, size_t len) {
+        std::lock_guard<std::mutex> lock(_rxMutex);
+        size_t n = 0;
+        while (n < len && !_rx.empty()) {
+            buf[n++] = _rx.front();
+            _rx.pop_front();
+        }
+        return n;
+    }
+    int peek() const {
+        std::lock_guard<std::mutex> lock(_rxMutex);
+        return _rx.empty() ? -1 : _rx.front();
+    }
+    void flush() {}
+
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t len) {
+        if (!data || len == 0) {
+            return 0;
+        }
+        _txBytes += len;
+        _txWrites++;
+        if (_echo) {
+            // Console port: never buffered, optionally echoed.
+            if (arduino_native::console_echo()) {
+                fwrite(data, 1, len, stdout);
+            }
+            if (arduino_native::console_sink()) {
+                arduino_native::console_sink()(reinterpret_cast<const char *>(data), len);
+            }
+            return len;
+        }
+        if (_tx.empty()) {
+            _txStartBaud = _baud;
+            _txMarks.clear();
+        }
+        _tx.append(reinterpret_cast<const char *>(data), len);
+        return len;
+    }
+    size_t write(const char *data, size_t len) { return write(reinterpret_cast<const uint8_t *>(data), len); }
+
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(const char *s) { return s ? write(s, strlen(s)) : 0; }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned v) { return printf("%u", v); }
+    size_t println() { return print("\r\n"); }
+    size_t println(const String &s) { return print(s) + println(); }
+    size_t println(const char *s) { return print(s) + println(); }
+    size_t println(int v) { return print(v) + println(); }
+
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[512];
+        va_list args;
+        va_start(args, fmt);
+        const int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        if (n <= 0) {
+            return 0;
+        }
+        return write(buf, std::min((size_t)n, sizeof(buf) - 1));
+    }
+
+    explicit operator bool() const { return true; }
+
+    // ---- native test hooks --------------------------------------------------
+    void inject(const uint8_t *data, size_t len) {
+        std::lock_guard<std::mutex> lock(_rxMutex);
+        _rx.insert(_rx.end(), data, data + len);
+    }
+    void inject(const char *s) { inject(reinterpret_cast<const uint8_t *>(s), strlen(s)); }
+    std::string takeTx() {
+        std::string out;
+        out.swap(_tx);
+        _txMarks.clear();
+        return out;
+    }
+    // TX split by the baud rate each byte was sent with (link simulators).
+    struct TxSegment {
+        unsigned long baud;
+        std::string bytes;
+    };
+    std::vector<TxSegment> takeTxSegments() {
+        std::vector<TxSegment> out;
+        size_t pos = 0;
+        unsigned long baud = _txStartBaud;
+        for (const auto &mark : _txMarks) {
+            if (mark.first > pos) {
+                out.push_back({baud, _tx.substr(pos, mark.first - pos)});
+            }
+            pos = mark.first;
+            baud = mark.second;
+        }
+        if (pos < _tx.size()) {
+            out.push_back({baud, _tx.substr(pos)});
+        }
+        _tx.clear();
+        _txMarks.clear();
+        return out;
+    }
+    const std::string &tx() const { return _tx; }
+    void clearTx() {
+        _tx.clear();
+        _txMarks.clear();
+    }
+    uint64_t txBytes() const { return _txBytes; }
+    uint64_t txWrites() const { return _txWrites; }
+
+  private:
+    bool _echo = false;
+    bool _begun = false;
+    unsigned long _baud = 0;
+    unsigned long _txStartBaud = 0;
+    size_t _rxBufferSize = 256;
+    mutable std::mutex _rxMutex;
+    std::deque<uint8_t> _rx;
+    std::string _tx;
+    std::vector<std::pair<size_t, unsigned long>> _txMarks; // (offset, new baud)
+    uint64_t _txBytes = 0;
+    uint64_t _txWrites = 0;
+};
+
+inline HardwareSerial Serial(true);
+inline HardwareSerial Serial1;
+inline HardwareSerial Serial2;
+
+// -----------------------------------------------------------------------------
+// GPIO (no-op)
+// -----------------------------------------------------------------------------
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+// EOF
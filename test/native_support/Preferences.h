@@ -0,0 +1,112 @@
+#pragma once
+
+//
+// Preferences.h (native)
+//
+// In-memory stand-in for the ESP32 Arduino Preferences (NVS) API, so code
+// that persists settings (src/app/host_parameters.cpp) links in the native
+// tests. One process-wide store, keyed by namespace and key; nothing is
+// written to disk.
+//
+// Only the blob / integer accessors used by the firmware are provided.
+// preferences_native::clear_all() resets the store between test cases.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace preferences_native {
+
+using Namespace = std::map<std::string, std::vector<uint8_t>>;
+
+inline std::map<std::string, Namespace> &store() {
+    static std::map<std::string, Namespace> s;
+    return s;
+}
+
+inline void clear_all() { store().clear(); }
+
+} // namespace preferences_native
+
+class Preferences {
+  public:
+    bool begin(const char *name, bool readOnly = false, const char *partitionLabel = nullptr) {
+        (void)partitionLabel;
+        if (!name || !name[0]) {
+            return false;
+        }
+        auto &s = preferences_native::store();
+        if (readOnly && s.find(name) == s.end()) {
+            return false; // like NVS: a read-only open of a missing namespace fails
+        }
+        _ns = &s[name];
+        _readOnly = readOnly;
+        return true;
+    }
+
+    void end() { _ns = nullptr; }
+
+    bool clear() {
+        if (!_ns || _readOnly) {
+            return false;
+        }
+        _ns->clear();
+        return true;
+    }
+
+    bool remove(const char *key) {
+        if (!_ns || _readOnly || !key) {
+            return false;
+        }
+        return _ns->erase(key) > 0;
+    }
+
+    bool isKey(const char *key) const { return _ns && key && _ns->find(key) != _ns->end(); }
+
+    size_t putBytes(const char *key, const void *value, size_t len) {
+        if (!_ns || _readOnly || !key || (!value && len)) {
+            return 0;
+        }
+        const uint8_t *p = static_cast<const uint8_t *>(value);
+        (*_ns)[key].assign(p, p + len);
+        return len;
+    }
+
+    size_t getBytesLength(const char *key) const {
+        const std::vector<uint8_t> *v = find(key);
+        return v ? v->size() : 0;
+    }
+
+    size_t getBytes(const char *key, void *buf, size_t maxLen) const {
+        const std::vector<uint8_t> *v = find(key);
+        if (!v || !buf || v->size() > maxLen) {
+            return 0;
+        }
+        memcpy(buf, v->data(), v->size());
+        return v->size();
+    }
+
+    size_t putUInt(const char *key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0) const {
+        uint32_t v = defaultValue;
+        return (getBytes(key, &v, sizeof(v)) == sizeof(v)) ? v : defaultValue;
+    }
+
+  private:
+    const std::vector<uint8_t> *find(const char *key) const {
+        if (!_ns || !key) {
+            return nullptr;
+        }
+        auto it = _ns->find(key);
+        return (it == _ns->end()) ? nullptr : &it->second;
+    }
+
+    preferences_native::Namespace *_ns = nullptr;
+    bool _readOnly = false;
+};
+
+// EOF
@@ -0,0 +1,183 @@
+#pragma once
+
+//
+// delay_link.h (native)
+//
+// Frame-level link between HostComm (host port) and ClientComm (client port)
+// for the protocol tests, stepped on the virtual millisecond clock:
+//
+//   host.loop(), host app -> host TX on the wire -> due bytes to the client
+//   -> client.loop() + client app (every clientLoopMs) -> client TX on the
+//   wire -> due bytes to the host -> host.loop() -> clock += stepMs
+//
+// Per direction:
+// - each TX write arrives latencyMs later as one chunk (0 = same step);
+//   with `serialize` the chunk also occupies the line for its bit time at
+//   the sender's baud rate
+// - chunks sent at a rate different from the receiver's are garbled
+// - optional bit flips for chunks sent at noisyBaud
+// - frames containing dropPrefix are cut out dropCount times (-1 = always)
+//
+// For byte-accurate timing, jitter and loss use LinkSim (link_sim.h).
+//
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+
+struct DelayLinkConfig {
+    uint32_t latencyMs = 0;     // one-way
+    uint32_t stepMs = 1;        // clock advance per step()
+    uint32_t clientLoopMs = 1;  // ClientComm::loop() when millis() % clientLoopMs == 0
+    bool serialize = false;     // add the bit time at the sender's baud rate
+    uint32_t noisyBaud = 0;     // flip bits of chunks sent at this rate ...
+    uint32_t noisePerMille = 0; // ... with this probability per byte
+    uint32_t seed = 12345;
+};
+
+class DelayLink {
+  public:
+    struct Direction {
+        const char *dropPrefix = nullptr; // drop frames containing this text
+        int dropCount = 0;                // ... this many times (-1 = always)
+        uint64_t bytes = 0;               // on the wire, after drops
+        uint32_t frames = 0;              // '\n' on the wire
+        uint32_t garbled = 0;             // junk bytes from a baud mismatch
+
+      private:
+        friend class DelayLink;
+
+        struct Chunk {
+            uint32_t dueMs;
+            unsigned long baud;
+            std::string bytes;
+        };
+        std::deque<Chunk> q;
+        uint32_t busyUntilMs = 0;
+
+        void send(DelayLink &link, HardwareSerial &from) {
+            for (auto &seg : from.takeTxSegments()) {
+                std::string &data = seg.bytes;
+                if (dropPrefix != nullptr) {
+                    size_t pos;
+                    while (dropCount != 0 && (pos = data.find(dropPrefix)) != std::string::npos) {
+                        const size_t end = data.find('\n', pos);
+                        data.erase(pos, end == std::string::npos ? std::string::npos : end - pos + 1);
+                        if (dropCount > 0) {
+                            --dropCount;
+                        }
+                    }
+                }
+                if (data.empty()) {
+                    continue;
+                }
+                bytes += data.size();
+                frames += static_cast<uint32_t>(std::count(data.begin(), data.end(), '\n'));
+
+                const unsigned long baud = seg.baud ? seg.baud : 115200;
+                uint32_t due = millis();
+                if (link._cfg.serialize) {
+                    const uint32_t txMs =
+                        static_cast<uint32_t>((data.size() * 10ull * 1000ull + baud - 1) / baud);
+                    const uint32_t start = ((int32_t)(busyUntilMs - millis()) > 0) ? busyUntilMs : millis();
+                    busyUntilMs = start + txMs;
+                    due = busyUntilMs;
+                }
+                if (baud == link._cfg.noisyBaud) {
+                    for (char &c : data) {
+                        if (link.rng() % 1000 < link._cfg.noisePerMille) {
+                            c = static_cast<char>(c ^ (1u << (link.rng() % 8)));
+                        }
+                    }
+                }
+                q.push_back({static_cast<uint32_t>(due + link._cfg.latencyMs), baud, std::move(data)});
+            }
+        }
+
+        void deliver(DelayLink &link, HardwareSerial &to) {
+            while (!q.empty() && (int32_t)(millis() - q.front().dueMs) >= 0) {
+                Chunk &c = q.front();
+                if (c.baud != to.baudRate()) {
+                    // Wrong rate: framing errors, roughly half as many random bytes.
+                    std::string junk;
+                    for (size_t i = 0; i < c.bytes.size() / 2 + 1; ++i) {
+                        junk.push_back(static_cast<char>(link.rng() & 0xFF));
+                    }
+                    garbled += static_cast<uint32_t>(junk.size());
+                    c.bytes.swap(junk);
+                }
+                to.inject(reinterpret_cast<const uint8_t *>(c.bytes.data()), c.bytes.size());
+                q.pop_front();
+            }
+        }
+    };
+
+    DelayLink(HardwareSerial &hostPort, HardwareSerial &clientPort, const DelayLinkConfig &cfg = DelayLinkConfig())
+        : _hostPort(hostPort), _clientPort(clientPort), _cfg(cfg), _rng(cfg.seed) {}
+
+    DelayLinkConfig &config() { return _cfg; }
+    Direction &hostToClient() { return _h2c; }
+    Direction &clientToHost() { return _c2h; }
+
+    // Called after the first HostComm::loop() / after ClientComm::loop().
+    void setHostApp(std::function<void(HostComm &)> fn) { _hostApp = std::move(fn); }
+    void setClientApp(std::function<void(ClientComm &)> fn) { _clientApp = std::move(fn); }
+
+    // Fresh wire, counters, filters and random sequence (test setUp()); the
+    // configuration and the app hooks stay.
+    void reset() {
+        _hostPort.takeTx();
+        _clientPort.takeTx();
+        _h2c = Direction();
+        _c2h = Direction();
+        _rng = _cfg.seed;
+    }
+
+    void step(HostComm &host, ClientComm &client) {
+        host.loop();
+        if (_hostApp) {
+            _hostApp(host);
+        }
+        _h2c.send(*this, _hostPort);
+        _h2c.deliver(*this, _clientPort);
+        if (millis() % _cfg.clientLoopMs == 0) {
+            client.loop();
+            if (_clientApp) {
+                _clientApp(client);
+            }
+        }
+        _c2h.send(*this, _clientPort);
+        _c2h.deliver(*this, _hostPort);
+        host.loop();
+        arduino_native::advance_ms(_cfg.stepMs);
+    }
+
+    void runForMs(HostComm &host, ClientComm &client, uint32_t ms) {
+        for (uint32_t t = 0; t < ms; t += _cfg.stepMs) {
+            step(host, client);
+        }
+    }
+
+  private:
+    HardwareSerial &_hostPort;
+    HardwareSerial &_clientPort;
+    DelayLinkConfig _cfg;
+    uint32_t _rng;
+    std::function<void(HostComm &)> _hostApp;
+    std::function<void(ClientComm &)> _clientApp;
+    Direction _h2c;
+    Direction _c2h;
+
+    uint32_t rng() {
+        _rng = _rng * 1664525u + 1013904223u;
+        return _rng >> 8;
+    }
+};
+
+// EOF
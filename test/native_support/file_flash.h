@@ -0,0 +1,161 @@
+#pragma once
+
+//
+// file_flash.h (native)
+//
+// NOR flash in a file, for the run history store (run_history.h):
+//
+// - erase() sets a sector to 0xFF, program() can only clear bits; programming
+//   a byte that is not erased is counted (and refused in strict mode), so a
+//   test sees any rewrite in place
+// - every change is written through to the file; a second FileFlash on the
+//   same path is the flash after a reboot
+// - powerCutAfter(n): the next program/erase calls get n more bytes through,
+//   the one that crosses the limit stops half way (a torn write, or half an
+//   erased sector) and everything after fails until reboot()
+// - per-sector erase counters for the wear checks
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "run_history.h"
+
+class FileFlash : public RunHistoryFlash {
+  public:
+    FileFlash(const std::string &path, uint32_t sectorSize, uint32_t sectorCount, bool strict = true)
+        : _path(path), _sectorSize(sectorSize), _sectorCount(sectorCount), _strict(strict),
+          _data(static_cast<size_t>(sectorSize) * sectorCount, 0xFF), _erases(sectorCount, 0) {
+        FILE *f = fopen(path.c_str(), "rb");
+        if (f) {
+            const size_t n = fread(_data.data(), 1, _data.size(), f);
+            (void)n;
+            fclose(f);
+        } else {
+            f = fopen(path.c_str(), "wb");
+            if (f) {
+                fwrite(_data.data(), 1, _data.size(), f);
+                fclose(f);
+            }
+        }
+        _file = fopen(path.c_str(), "r+b");
+    }
+    ~FileFlash() override {
+        if (_file) {
+            fclose(_file);
+        }
+    }
+
+    uint32_t sectorSize() const override { return _sectorSize; }
+    uint32_t sectorCount() const override { return _sectorCount; }
+
+    bool read(uint32_t addr, void *dst, size_t len) override {
+        if (_dead || addr + len > _data.size()) {
+            return false;
+        }
+        memcpy(dst, _data.data() + addr, len);
+        _bytesRead += len;
+        return true;
+    }
+
+    bool program(uint32_t addr, const void *src, size_t len) override {
+        if (_dead || addr + len > _data.size() || addr / _sectorSize != (addr + len - 1) / _sectorSize) {
+            return false;
+        }
+        const uint8_t *s = static_cast<const uint8_t *>(src);
+        for (size_t i = 0; i < len; ++i) {
+            if (_data[addr + i] != 0xFF) {
+                _reprograms++;
+                if (_strict) {
+                    return false;
+                }
+            }
+        }
+        const size_t n = budget(len);
+        for (size_t i = 0; i < n; ++i) {
+            _data[addr + i] &= s[i];
+        }
+        writeThrough(addr, n);
+        _programs++;
+        return n == len;
+    }
+
+    bool erase(uint32_t sector) override {
+        if (_dead || sector >= _sectorCount) {
+            return false;
+        }
+        const size_t n = budget(_sectorSize);
+        const uint32_t addr = sector * _sectorSize;
+        std::fill(_data.begin() + addr, _data.begin() + addr + n, 0xFF);
+        writeThrough(addr, n);
+        if (n == _sectorSize) {
+            _erases[sector]++;
+        }
+        return n == _sectorSize;
+    }
+
+    // Test controls
+    void powerCutAfter(size_t bytes) {
+        _cutArmed = true;
+        _cutLeft = bytes;
+    }
+    bool dead() const { return _dead; }
+    void reboot() {
+        _dead = false;
+        _cutArmed = false;
+    }
+    uint8_t *raw(uint32_t addr) { return _data.data() + addr; }
+
+    uint32_t erases(uint32_t sector) const { return _erases[sector]; }
+    uint32_t maxErases() const {
+        uint32_t m = 0;
+        for (uint32_t e : _erases) {
+            m = e > m ? e : m;
+        }
+        return m;
+    }
+    uint32_t reprograms() const { return _reprograms; }
+    uint32_t programs() const { return _programs; }
+    uint64_t bytesRead() const { return _bytesRead; }
+
+  private:
+    size_t budget(size_t len) {
+        if (!_cutArmed) {
+            return len;
+        }
+        if (len <= _cutLeft) {
+            _cutLeft -= len;
+            return len;
+        }
+        const size_t n = _cutLeft;
+        _cutLeft = 0;
+        _dead = true;
+        return n;
+    }
+
+    void writeThrough(uint32_t addr, size_t n) {
+        if (_file && n) {
+            fseek(_file, static_cast<long>(addr), SEEK_SET);
+            fwrite(_data.data() + addr, 1, n, _file);
+            fflush(_file);
+        }
+    }
+
+    std::string _path;
+    uint32_t _sectorSize;
+    uint32_t _sectorCount;
+    bool _strict;
+    std::vector<uint8_t> _data;
+    std::vector<uint32_t> _erases;
+    FILE *_file = nullptr;
+    bool _dead = false;
+    bool _cutArmed = false;
+    size_t _cutLeft = 0;
+    uint32_t _reprograms = 0;
+    uint32_t _programs = 0;
+    uint64_t _bytesRead = 0;
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+//
+// link_sim.h (native)
+//
+// In-memory UART link between two native HardwareSerial ports, driven by the
+// virtual Arduino clock. Used to run the real HostComm against the real
+// ClientComm on the PC (test/test_native_link_sim).
+//
+// Model per direction:
+// - bit rate from the *sender's* baud rate (10 bits per byte, 8N1); bytes
+//   are serialized, i.e. a burst occupies the line for len * byteTime
+// - bytes arrive one by one at their own time, so receivers see the same
+//   fragmentation as on a real UART
+// - fixed latency plus uniform jitter per TX burst (order is preserved)
+// - byte corruption (random bit flip) and byte loss per million bytes
+// - bytes sent at a baud rate different from the receiver's are garbled
+//
+// Both endpoint loops are called by the simulator at their own period, so
+// host/client scheduling is part of the model as well.
+//
+
+#include <Arduino.h>
+
+#include <deque>
+#include <functional>
+#include <string>
+
+struct LinkSimConfig {
+    uint32_t latencyUs = 100;         // one-way, on top of the serialization time
+    uint32_t jitterUs = 0;            // uniform 0..jitterUs per TX burst
+    uint32_t corruptPerMillion = 0;   // bytes with one flipped bit
+    uint32_t dropPerMillion = 0;      // bytes lost on the wire
+    uint32_t hostLoopUs = 1000;       // HostComm::loop() period
+    uint32_t clientLoopUs = 1000;     // ClientComm::loop() period
+    uint32_t tickUs = 50;             // simulation resolution
+    uint32_t seed = 1;
+};
+
+class LinkSim {
+  public:
+    struct DirStats {
+        uint64_t bytes = 0;
+        uint64_t corrupted = 0;
+        uint64_t dropped = 0;
+        uint64_t garbled = 0; // baud mismatch
+    };
+
+    LinkSim(HardwareSerial &hostPort, HardwareSerial &clientPort, const LinkSimConfig &cfg = LinkSimConfig())
+        : _hostPort(hostPort), _clientPort(clientPort), _cfg(cfg), _rng(cfg.seed ? cfg.seed : 1) {}
+
+    void setHostLoop(std::function<void()> fn) { _hostLoop = std::move(fn); }
+    void setClientLoop(std::function<void()> fn) { _clientLoop = std::move(fn); }
+    LinkSimConfig &config() { return _cfg; }
+
+    // Advance the virtual clock by one tick: deliver due bytes, run the
+    // endpoint loops that are due, then put their TX on the wire.
+    void tick() {
+        const uint64_t now = arduino_native::clock_us();
+        _h2c.deliver(now, _clientPort);
+        _c2h.deliver(now, _hostPort);
+
+        if (now >= _nextHostUs) {
+            _nextHostUs = now + _cfg.hostLoopUs;
+            if (_hostLoop) {
+                _hostLoop();
+            }
+        }
+        if (now >= _nextClientUs) {
+            _nextClientUs = now + _cfg.clientLoopUs;
+            if (_clientLoop) {
+                _clientLoop();
+            }
+        }
+
+        _h2c.send(*this, now, _hostPort);
+        _c2h.send(*this, now, _clientPort);
+        arduino_native::advance_us(_cfg.tickUs);
+    }
+
+    void runForMs(uint32_t ms) {
+        const uint64_t end = arduino_native::clock_us() + (uint64_t)ms * 1000ull;
+        while (arduino_native::clock_us() < end) {
+            tick();
+        }
+    }
+
+    // Run until pred() is true (checked every tick). Returns false on timeout.
+    bool runUntil(const std::function<bool()> &pred, uint32_t timeoutMs) {
+        const uint64_t end = arduino_native::clock_us() + (uint64_t)timeoutMs * 1000ull;
+        while (arduino_native::clock_us() < end) {
+            tick();
+            if (pred()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Put bytes on the wire as if `from` had written them now.
+    void drainTx() {
+        const uint64_t now = arduino_native::clock_us();
+        _h2c.send(*this, now, _hostPort);
+        _c2h.send(*this, now, _clientPort);
+    }
+
+    const DirStats &hostToClient() const { return _h2c.stats; }
+    const DirStats &clientToHost() const { return _c2h.stats; }
+    bool idle() const { return _h2c.q.empty() && _c2h.q.empty(); }
+
+  private:
+    struct WireByte {
+        uint64_t dueUs;
+        unsigned long baud;
+        uint8_t value;
+    };
+
+    struct Direction {
+        std::deque<WireByte> q;
+        uint64_t busyUntilUs = 0; // end of the last serialized byte
+        uint64_t lastDueUs = 0;   // keeps delivery in order under jitter
+        DirStats stats;
+
+        void send(LinkSim &sim, uint64_t now, HardwareSerial &from) {
+            if (from.tx().empty()) {
+                return;
+            }
+            const uint32_t jitter = sim._cfg.jitterUs ? sim.rng() % (sim._cfg.jitterUs + 1) : 0;
+            for (const auto &seg : from.takeTxSegments()) {
+                const unsigned long baud = seg.baud ? seg.baud : 115200;
+                const double byteUs = 10.0 * 1e6 / (double)baud;
+                uint64_t start = busyUntilUs > now ? busyUntilUs : now;
+                for (size_t i = 0; i < seg.bytes.size(); ++i) {
+                    const uint64_t endOfByte = start + (uint64_t)((i + 1) * byteUs);
+                    uint64_t due = endOfByte + sim._cfg.latencyUs + jitter;
+                    if (due < lastDueUs) {
+                        due = lastDueUs;
+                    }
+                    lastDueUs = due;
+                    stats.bytes++;
+
+                    uint8_t b = static_cast<uint8_t>(seg.bytes[i]);
+                    if (sim._cfg.dropPerMillion && sim.rng() % 1000000u < sim._cfg.dropPerMillion) {
+                        stats.dropped++;
+                        continue;
+                    }
+                    if (sim._cfg.corruptPerMillion && sim.rng() % 1000000u < sim._cfg.corruptPerMillion) {
+                        b = static_cast<uint8_t>(b ^ (1u << (sim.rng() % 8)));
+                        stats.corrupted++;
+                    }
+                    q.push_back({due, baud, b});
+                }
+                busyUntilUs = start + (uint64_t)(seg.bytes.size() * byteUs);
+            }
+        }
+
+        void deliver(uint64_t now, HardwareSerial &to) {
+            uint8_t buf[64];
+            size_t n = 0;
+            while (!q.empty() && q.front().dueUs <= now) {
+                uint8_t b = q.front().value;
+                if (q.front().baud != to.baudRate()) {
+                    // Sampled at the wrong rate: framing garbage, never a delimiter.
+                    b = static_cast<uint8_t>((b * 37u + 0x5Bu) | 0x80u);
+                    stats.garbled++;
+                }
+                q.pop_front();
+                buf[n++] = b;
+                if (n == sizeof(buf)) {
+                    to.inject(buf, n);
+                    n = 0;
+                }
+            }
+            if (n > 0) {
+                to.inject(buf, n);
+            }
+        }
+    };
+
+    HardwareSerial &_hostPort;
+    HardwareSerial &_clientPort;
+    LinkSimConfig _cfg;
+    uint32_t _rng;
+    std::function<void()> _hostLoop;
+    std::function<void()> _clientLoop;
+    uint64_t _nextHostUs = 0;
+    uint64_t _nextClientUs = 0;
+    Direction _h2c;
+    Direction _c2h;
+
+    uint32_t rng() {
+        _rng = _rng * 1664525u + 1013904223u;
+        return _rng >> 8;
+    }
+};
+
+// EOF
@@ -0,0 +1,150 @@
+#pragma once
+
+//
+// thermal_plant.h (native)
+//
+// Lumped thermal model of the dryer for the oven simulator
+// (test/test_native_oven_sim). Two coupled masses:
+//
+//   hotspot  heater, its housing and the air stream at the hotspot NTC
+//   chamber  air, walls and filament load around the chamber NTC
+//
+//   C_h dT_h/dt = P_heater - G_hc(fans) (T_h - T_c)
+//   C_c dT_c/dt = G_hc(fans) (T_h - T_c) - G_loss(fans, door) (T_c - T_amb)
+//
+// - heater: fixed power while the HEATER output is on
+// - fans: the 12 V circulation fan and the 230 V fan (slow / fast) raise the
+//   heater-to-chamber coupling; the 230 V fan also moves air through the
+//   vents and so raises the loss to ambient
+// - door: an open door adds a large loss to ambient
+// - sensors: first-order lag per NTC (mount + probe time constant),
+//   quantized to 0.1 °C like the client STATUS
+//
+// The defaults are a rough fit of the production unit with the current
+// pulse logic (45 °C within ~15 min, 80 °C within ~40 min, hotspot a few °C
+// above the chamber in the hold phase); they are meant to compare heater
+// logic variants, not to predict absolute temperatures. Integration is
+// explicit Euler; step() splits larger steps into maxStepS pieces.
+//
+
+#include <stdint.h>
+
+struct ThermalPlantConfig {
+    float ambientC = 22.0f;
+    float heaterW = 600.0f;
+
+    float hotspotJPerK = 1500.0f; // C_h
+    float chamberJPerK = 3000.0f; // C_c
+
+    // Heater -> chamber coupling, W/K
+    float couplingStillWPerK = 3.0f;  // no fan running
+    float couplingFan12WPerK = 10.0f; // 12 V circulation fan
+    float couplingSlowWPerK = 15.0f;  // 230 V fan slow (with or without 12 V)
+    float couplingFastWPerK = 25.0f;  // 230 V fan fast
+
+    // Chamber -> ambient loss, W/K
+    float lossClosedWPerK = 0.5f;
+    float lossSlowExtraWPerK = 0.2f;
+    float lossFastExtraWPerK = 0.5f;
+    float lossDoorExtraWPerK = 18.0f;
+
+    // Sensor lag (first order), seconds
+    float hotspotSensorTauS = 10.0f;
+    float chamberSensorTauS = 15.0f;
+
+    float maxStepS = 0.25f;
+};
+
+struct ThermalPlantInputs {
+    bool heater = false;
+    bool fan12v = false;
+    bool fan230 = false;
+    bool fan230Slow = false;
+    bool doorOpen = false;
+};
+
+class ThermalPlant {
+  public:
+    explicit ThermalPlant(const ThermalPlantConfig &cfg = ThermalPlantConfig()) : _cfg(cfg) { reset(); }
+
+    // Everything at ambient (a cold oven).
+    void reset() {
+        _hotC = _chamberC = _cfg.ambientC;
+        _hotSensorC = _chamberSensorC = _cfg.ambientC;
+        _heaterJ = 0.0;
+    }
+
+    void setInputs(const ThermalPlantInputs &in) { _in = in; }
+    const ThermalPlantInputs &inputs() const { return _in; }
+
+    void step(float dtS) {
+        while (dtS > 0.0f) {
+            const float h = (dtS > _cfg.maxStepS) ? _cfg.maxStepS : dtS;
+            integrate(h);
+            dtS -= h;
+        }
+    }
+
+    // True temperatures
+    float hotspotC() const { return _hotC; }
+    float chamberC() const { return _chamberC; }
+
+    // What the NTCs read (lagged), deci-°C
+    int16_t hotspotSensor_dC() const { return to_dC(_hotSensorC); }
+    int16_t chamberSensor_dC() const { return to_dC(_chamberSensorC); }
+
+    double heaterEnergyJ() const { return _heaterJ; }
+    const ThermalPlantConfig &config() const { return _cfg; }
+
+  private:
+    float coupling() const {
+        if (_in.fan230) {
+            return _cfg.couplingFastWPerK;
+        }
+        if (_in.fan230Slow) {
+            return _cfg.couplingSlowWPerK;
+        }
+        return _in.fan12v ? _cfg.couplingFan12WPerK : _cfg.couplingStillWPerK;
+    }
+
+    float loss() const {
+        float g = _cfg.lossClosedWPerK;
+        if (_in.fan230) {
+            g += _cfg.lossFastExtraWPerK;
+        } else if (_in.fan230Slow) {
+            g += _cfg.lossSlowExtraWPerK;
+        }
+        if (_in.doorOpen) {
+            g += _cfg.lossDoorExtraWPerK;
+        }
+        return g;
+    }
+
+    void integrate(float h) {
+        const float p = _in.heater ? _cfg.heaterW : 0.0f;
+        const float qHc = coupling() * (_hotC - _chamberC);
+        const float qLoss = loss() * (_chamberC - _cfg.ambientC);
+
+        _hotC += h * (p - qHc) / _cfg.hotspotJPerK;
+        _chamberC += h * (qHc - qLoss) / _cfg.chamberJPerK;
+        _heaterJ += static_cast<double>(p) * h;
+
+        _hotSensorC += (_hotC - _hotSensorC) * (h / (_cfg.hotspotSensorTauS + h));
+        _chamberSensorC += (_chamberC - _chamberSensorC) * (h / (_cfg.chamberSensorTauS + h));
+    }
+
+    static int16_t to_dC(float c) {
+        const float d = c * 10.0f;
+        return static_cast<int16_t>((d >= 0.0f) ? (d + 0.5f) : (d - 0.5f));
+    }
+
+    ThermalPlantConfig _cfg;
+    ThermalPlantInputs _in;
+    float _hotC = 0.0f;
+    float _chamberC = 0.0f;
+    float _hotSensorC = 0.0f;
+    float _chamberSensorC = 0.0f;
+    double _heaterJ = 0.0;
+};
+
+// EOF
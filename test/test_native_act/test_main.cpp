@@ -0,0 +1,365 @@
+// ============================================================================
+//  test_native_act / test_main.cpp
+//
+//  Native (PC) tests for the combined actuate-and-report frame (H;ACT).
+//
+//  - Codec: H;ACT / C;ACK;ACT ASCII and binary round trip, worst-case length
+//  - ClientComm: UPD semantics, door bit stripped, watchdog fed, reply sent
+//    after the application applied (door-gated) outputs (outputsApplied()
+//    or, without that call, the next loop())
+//  - Sequenced ACT: duplicates answered again without re-applying
+//  - Timing: command -> confirmed STATUS with SET + GET/STATUS vs. ACT
+//
+//  The link is a delay line between the in-memory UARTs (one-way latency
+//  kLinkLatencyMs); the client application loop runs every kClientLoopMs
+//  and applies outputs right after ClientComm::loop(), like FSD_Client.
+//  The sequenced-duplicate test uses the next-loop() fallback.
+//
+//  Run:
+//    pio test -e native -f test_native_act -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <string>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "delay_link.h"
+#include "output_bitmask.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+
+// -----------------------------------------------------------------------------
+// Delay-line link + simulated client application
+// -----------------------------------------------------------------------------
+
+static constexpr uint32_t kLinkLatencyMs = 5;
+static constexpr uint32_t kClientLoopMs = 10;
+
+static constexpr uint16_t kDoorBit = (1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR);
+static constexpr uint16_t kHeaterBit = 0x0010; // gated by the open door in this sim
+
+static DelayLinkConfig link_config() {
+    DelayLinkConfig cfg;
+    cfg.latencyMs = kLinkLatencyMs;
+    cfg.clientLoopMs = kClientLoopMs;
+    return cfg;
+}
+
+static DelayLink g_link(Serial1, Serial2, link_config());
+
+static bool g_applyPending = false;
+static uint16_t g_requestedMask = 0;
+static uint16_t g_effectiveMask = 0;
+static bool g_doorOpen = false;
+static uint32_t g_clientApplies = 0;
+
+static void outputs_changed_cb(uint16_t newMask) {
+    g_requestedMask = newMask;
+    g_applyPending = true;
+    g_clientApplies++;
+}
+
+static void fill_status_cb(ProtocolStatus &st) {
+    st.outputsMask = static_cast<uint16_t>(g_effectiveMask | (g_doorOpen ? kDoorBit : 0));
+    st.adcRaw[0] = 101;
+    st.adcRaw[1] = 202;
+    st.adcRaw[2] = 303;
+    st.adcRaw[3] = 404;
+    st.tempHotspot_dC = 1234;
+    st.tempChamber_dC = 567;
+}
+
+static void app_apply_outputs(ClientComm *client = nullptr) {
+    if (!g_applyPending) {
+        return;
+    }
+    g_applyPending = false;
+    g_effectiveMask = g_doorOpen ? static_cast<uint16_t>(g_requestedMask & ~kHeaterBit) : g_requestedMask;
+    if (client != nullptr) {
+        client->outputsApplied();
+    }
+}
+
+// Queue one host line on the client UART (handled by the next loop()).
+static void client_rx(const char *line) {
+    const std::string frame = std::string(line) + "\r\n";
+    Serial2.inject(reinterpret_cast<const uint8_t *>(frame.data()), frame.size());
+}
+
+static void step(HostComm &host, ClientComm &client) {
+    g_link.step(host, client);
+}
+
+static void run_for(HostComm &host, ClientComm &client, uint32_t ms) {
+    g_link.runForMs(host, client, ms);
+}
+
+static void start_link(HostComm &host, ClientComm &client) {
+    host.begin(115200, 16, 17);
+    client.begin(115200);
+    client.setOutputsChangedCallback(outputs_changed_cb);
+    client.setFillStatusCallback(fill_status_cb);
+    g_link.setClientApp([](ClientComm &c) { app_apply_outputs(&c); });
+    for (int i = 0; i < 10 && !host.linkSynced(); ++i) {
+        host.sendPing();
+        run_for(host, client, 50);
+    }
+    TEST_ASSERT_TRUE(host.linkSynced());
+}
+
+// Command -> STATUS confirming `expect`; returns the latency in ms.
+static uint32_t confirm_latency(HostComm &host, ClientComm &client, uint16_t mask, uint16_t expect, bool act) {
+    const uint32_t t0 = millis();
+    uint32_t guard = 0;
+    host.clearNewStatusFlag();
+
+    if (act) {
+        host.setOutputsMaskAndReport(mask);
+    } else {
+        host.setOutputsMask(mask);
+        while (!host.lastSetAcked() && guard++ < 5000) {
+            step(host, client);
+        }
+        host.clearNewStatusFlag();
+        host.requestStatus();
+    }
+    while (!host.hasNewStatus() && guard++ < 5000) {
+        step(host, client);
+    }
+    TEST_ASSERT_TRUE(host.hasNewStatus());
+    TEST_ASSERT_EQUAL_HEX16(expect, host.getRemoteStatus().outputsMask);
+    return millis() - t0;
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void setUp(void) {
+    g_link.reset();
+    g_applyPending = false;
+    g_requestedMask = 0;
+    g_effectiveMask = 0;
+    g_doorOpen = false;
+    g_clientApplies = 0;
+}
+void tearDown(void) {}
+
+void test_codec_ascii(void) {
+    ProtocolMessage msg;
+    char buf[ProtocolCodec::kMaxFrameLen];
+
+    TEST_ASSERT_EQUAL_size_t(17, ProtocolCodec::buildHostAct(buf, sizeof(buf), 0x0011, 0xFFEE));
+    TEST_ASSERT_EQUAL_STRING("H;ACT;0011;FFEE\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, 15, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostAct, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x0011, msg.mask);
+    TEST_ASSERT_EQUAL_HEX16(0xFFEE, msg.maskB);
+    TEST_ASSERT_EQUAL_UINT8(0, msg.seq);
+
+    ProtocolStatus st{};
+    st.outputsMask = 0x0091;
+    st.adcRaw[0] = 1;
+    st.adcRaw[1] = -2;
+    st.adcRaw[2] = 3;
+    st.adcRaw[3] = 4;
+    st.tempHotspot_dC = 2501;
+    st.tempChamber_dC = -15;
+    ProtocolCodec::buildClientAckAct(buf, sizeof(buf), 0x0011, st, 0x42);
+    TEST_ASSERT_EQUAL_STRING("C;ACK;ACT;0011;0091;1;-2;3;4;2501;-15;#42\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, strlen(buf) - 2, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckAct, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x0011, msg.mask);
+    TEST_ASSERT_EQUAL_HEX16(0x0091, msg.status.outputsMask);
+    TEST_ASSERT_EQUAL_INT16(-2, msg.status.adcRaw[1]);
+    TEST_ASSERT_EQUAL_INT16(2501, msg.status.tempHotspot_dC);
+    TEST_ASSERT_EQUAL_INT16(-15, msg.status.tempChamber_dC);
+    TEST_ASSERT_EQUAL_UINT8(0x42, msg.seq);
+
+    // Worst case fits the documented frame limit.
+    for (int i = 0; i < 4; ++i) {
+        st.adcRaw[i] = -32768;
+    }
+    st.tempHotspot_dC = -32768;
+    st.tempChamber_dC = -32768;
+    const size_t len = ProtocolCodec::buildClientAckAct(buf, sizeof(buf), 0xFFFF, st, 0xFF);
+    TEST_ASSERT_EQUAL_size_t(67, len);
+    TEST_ASSERT_LESS_THAN(ProtocolCodec::kMaxFrameLen, len);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, len - 2, msg));
+    TEST_ASSERT_EQUAL_INT16(-32768, msg.status.tempChamber_dC);
+
+    static const char *const kBad[] = {
+        "H;ACT;0011",
+        "H;ACT;0011;FFEE;#00",
+        "H;ACT;0011;FFEE;12",
+        "C;ACK;ACT;0011",
+        "C;ACK;ACT;0011;0091;1;2;3;4;5",
+        "C;ACK;ACT;0011;0091;1;2;3;4;5;6;7",
+        "C;ACK;ACT;0011;XYZW;1;2;3;4;5;6",
+    };
+    for (const char *f : kBad) {
+        TEST_ASSERT_FALSE_MESSAGE(ProtocolCodec::parseFrame(f, strlen(f), msg), f);
+    }
+}
+
+void test_codec_binary(void) {
+    ProtocolMessage in;
+    memset(&in, 0, sizeof(in));
+    in.type = ProtocolMessageType::ClientAckAct;
+    in.mask = 0x00F1;
+    in.status.outputsMask = 0x00B1;
+    in.status.adcRaw[0] = -1;
+    in.status.adcRaw[3] = 32767;
+    in.status.tempHotspot_dC = -300;
+    in.status.tempChamber_dC = 4321;
+    in.seq = 0xFF;
+
+    uint8_t frame[ProtocolBinCodec::kMaxFrameLen];
+    const size_t len = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+    TEST_ASSERT_GREATER_THAN(0u, len);
+
+    ProtocolMessage out;
+    TEST_ASSERT_TRUE(ProtocolBinCodec::decode(frame + 1, len - 2, out));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckAct, (int)out.type);
+    TEST_ASSERT_EQUAL_HEX16(0x00F1, out.mask);
+    TEST_ASSERT_EQUAL_HEX16(0x00B1, out.status.outputsMask);
+    TEST_ASSERT_EQUAL_INT16(-1, out.status.adcRaw[0]);
+    TEST_ASSERT_EQUAL_INT16(32767, out.status.adcRaw[3]);
+    TEST_ASSERT_EQUAL_INT16(-300, out.status.tempHotspot_dC);
+    TEST_ASSERT_EQUAL_INT16(4321, out.status.tempChamber_dC);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, out.seq);
+
+    in.type = ProtocolMessageType::HostAct;
+    in.maskB = 0xFF0E;
+    const size_t len2 = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(ProtocolBinCodec::decode(frame + 1, len2 - 2, out));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostAct, (int)out.type);
+    TEST_ASSERT_EQUAL_HEX16(0x00F1, out.mask);
+    TEST_ASSERT_EQUAL_HEX16(0xFF0E, out.maskB);
+}
+
+void test_client_applies_then_reports(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    start_link(host, client);
+
+    // Door open: the heater request is gated by the application, the door
+    // bit in the command is ignored, and the reply shows the applied state.
+    g_doorOpen = true;
+    host.actuateAndReport(static_cast<uint16_t>(0x0011 | kDoorBit), 0x0000);
+    run_for(host, client, 60);
+
+    TEST_ASSERT_EQUAL_HEX16(0x0011, client.getOutputsMask());
+    TEST_ASSERT_TRUE(host.lastSetAcked());
+    TEST_ASSERT_TRUE(host.hasNewStatus());
+    TEST_ASSERT_EQUAL_HEX16(static_cast<uint16_t>(0x0001 | kDoorBit), host.getRemoteStatus().outputsMask);
+    TEST_ASSERT_EQUAL_INT16(567, host.getRemoteStatus().tempChamber_dC);
+    TEST_ASSERT_EQUAL_INT16(404, host.getRemoteStatus().adcRaw[3]);
+    TEST_ASSERT_FALSE(host.hasCommError());
+
+    // SET semantics via ACT(m, ~m).
+    g_doorOpen = false;
+    host.setOutputsMaskAndReport(0x0012);
+    run_for(host, client, 60);
+    TEST_ASSERT_EQUAL_HEX16(0x0012, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0012, host.getLocalOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0012, host.getRemoteStatus().outputsMask);
+}
+
+void test_act_feeds_watchdog_and_rearms(void) {
+    ClientComm client(Serial2, 16, 17);
+    client.begin(115200);
+    client.setOutputsChangedCallback(outputs_changed_cb);
+    client.setFillStatusCallback(fill_status_cb);
+    client_rx("H;ACT;0003;0000");
+    client.loop();
+    TEST_ASSERT_EQUAL_HEX16(0x0003, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_STRING("", Serial2.takeTx().c_str()); // reply is deferred
+
+    app_apply_outputs(&client);
+    TEST_ASSERT_EQUAL_STRING("C;ACK;ACT;0003;0003;101;202;303;404;1234;567\r\n", Serial2.takeTx().c_str());
+
+    // Keep feeding with ACT only: no host-timeout SAFE (outputs stay on).
+    for (int i = 0; i < 20; ++i) {
+        arduino_native::advance_ms(200);
+        client_rx("H;ACT;0000;0000");
+        client.loop();
+    }
+    TEST_ASSERT_EQUAL_HEX16(0x0003, client.getOutputsMask());
+    Serial2.takeTx();
+}
+
+void test_sequenced_act_duplicate_not_reapplied(void) {
+    ClientComm client(Serial2, 16, 17);
+    client.begin(115200);
+    client.setOutputsChangedCallback(outputs_changed_cb);
+    client.setFillStatusCallback(fill_status_cb);
+
+    g_clientApplies = 0;
+    client_rx("H;ACT;0001;0000;#05");
+    client.loop();
+    app_apply_outputs();
+    client_rx("H;ACT;0001;0000;#05"); // retransmit (reply lost)
+    client.loop();
+    app_apply_outputs();
+    client.loop();
+
+    TEST_ASSERT_EQUAL_UINT32(1, g_clientApplies);
+    const std::string tx = Serial2.takeTx();
+    TEST_ASSERT_EQUAL_STRING("C;ACK;ACT;0001;0001;101;202;303;404;1234;567;#05\r\n"
+                             "C;ACK;ACT;0001;0001;101;202;303;404;1234;567;#05\r\n",
+                             tx.c_str());
+}
+
+void test_act_halves_confirmation_latency(void) {
+    static constexpr int kRounds = 20;
+    uint32_t classicMs = 0;
+    uint32_t actMs = 0;
+    {
+        HostComm host(Serial1);
+        ClientComm client(Serial2, 16, 17);
+        start_link(host, client);
+        for (int i = 0; i < kRounds; ++i) {
+            const uint16_t m = static_cast<uint16_t>(1u << (i % 4));
+            classicMs += confirm_latency(host, client, m, m, false);
+        }
+    }
+    {
+        HostComm host(Serial1);
+        ClientComm client(Serial2, 16, 17);
+        host.setCommandWindow(4);
+        start_link(host, client);
+        for (int i = 0; i < kRounds; ++i) {
+            const uint16_t m = static_cast<uint16_t>(1u << (i % 4));
+            actMs += confirm_latency(host, client, m, m, true);
+        }
+        TEST_ASSERT_EQUAL_UINT32(kRounds, host.cmdAckedCount());
+        TEST_ASSERT_EQUAL_UINT32(0, host.cmdRetransmitCount());
+    }
+
+    char msg[140];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] command -> confirmed STATUS: SET+GET %lu ms, ACT %lu ms (avg of %d, latency %lu ms, client loop %lu ms)",
+             (unsigned long)(classicMs / kRounds), (unsigned long)(actMs / kRounds), kRounds,
+             (unsigned long)kLinkLatencyMs, (unsigned long)kClientLoopMs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_OR_EQUAL(classicMs * 6 / 10, actMs);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_codec_ascii);
+    RUN_TEST(test_codec_binary);
+    RUN_TEST(test_client_applies_then_reports);
+    RUN_TEST(test_act_feeds_watchdog_and_rearms);
+    RUN_TEST(test_sequenced_act_duplicate_not_reapplied);
+    RUN_TEST(test_act_halves_confirmation_latency);
+    return UNITY_END();
+}
+
+// EOF
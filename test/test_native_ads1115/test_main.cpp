@@ -0,0 +1,341 @@
+// ============================================================================
+//  test_native_ads1115 / test_main.cpp
+//
+//  Native (PC) tests for the RDY-driven ADS1115 driver (ads1115_async.h)
+//  against a register-level mock of the chip on a simulated I2C bus.
+//
+//  - begin(): conversion-ready thresholds, first conversion on AIN0
+//  - round-robin AIN0..AIN3: one conversion read + one config write per RDY,
+//    never a conversion read while the chip is still converting
+//  - missed RDY edge, stuck conversion and I2C errors (onTimeout)
+//  - poll() without RDY pin
+//  - benchmark: samples/s and time blocked on I2C vs. the former blocking
+//    single-shot loop (128 SPS, 100 kHz, OS polled until ready)
+//
+//  Run:
+//    pio test -e native -f test_native_ads1115 -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <stdio.h>
+#include <vector>
+
+#include "client/ads1115_async.h"
+
+// ADS1115 register model on a virtual clock. Every transaction advances the
+// clock by its bit time; a conversion finishes conversionUs after it was
+// started by a config write with OS = 1.
+class MockAds : public Ads1115Bus {
+  public:
+    explicit MockAds(uint32_t i2cHz = 400000) : _i2cHz(i2cHz) {}
+
+    bool writeReg(uint8_t addr, uint8_t reg, uint16_t value) override {
+        spend(4); // addr, pointer, 2 data bytes
+        writes++;
+        if (addr != kAddr || failWrites > 0) {
+            failWrites -= (failWrites > 0) ? 1 : 0;
+            return false;
+        }
+        regs[reg & 0x03] = value;
+        if (reg == Ads1115Async::kRegConfig && (value & Ads1115Async::kCfgOsStart)) {
+            _converting = true;
+            _stalled = false;
+            _convCh = static_cast<uint8_t>(((value >> 12) & 0x07) - 4);
+            _convEndUs = nowUs + convUs(value);
+            starts.push_back(_convCh);
+        }
+        return true;
+    }
+
+    bool readReg(uint8_t addr, uint8_t reg, uint16_t &value) override {
+        spend(5); // addr + pointer, addr + 2 data bytes
+        update();
+        if (addr != kAddr || failReads > 0) {
+            failReads -= (failReads > 0) ? 1 : 0;
+            return false;
+        }
+        if (reg == Ads1115Async::kRegConversion) {
+            conversionReads++;
+            if (_converting) {
+                readsWhileBusy++;
+            }
+        }
+        value = regs[reg & 0x03];
+        if (reg == Ads1115Async::kRegConfig) {
+            value = static_cast<uint16_t>(_converting ? (value & ~Ads1115Async::kCfgOsStart)
+                                                      : (value | Ads1115Async::kCfgOsStart));
+        }
+        return true;
+    }
+
+    // Advance to the end of the running conversion (= the RDY edge).
+    bool finish() {
+        if (!_converting || _stalled) {
+            return false;
+        }
+        if (nowUs < _convEndUs) {
+            nowUs = _convEndUs;
+        }
+        update();
+        return true;
+    }
+
+    // The running conversion never finishes (until the next start).
+    void stall() { _stalled = true; }
+
+    bool converting() const { return _converting; }
+
+    static constexpr uint8_t kAddr = 0x48;
+    int16_t input[4] = {1000, 2000, -300, 32767};
+    uint16_t regs[4] = {0x0000, 0x8583, 0x8000, 0x7FFF};
+
+    uint64_t nowUs = 0;
+    uint64_t busUs = 0;
+    int failReads = 0;
+    int failWrites = 0;
+    uint32_t writes = 0;
+    uint32_t conversionReads = 0;
+    uint32_t readsWhileBusy = 0;
+    std::vector<uint8_t> starts;
+
+  private:
+    void spend(uint32_t bytes) {
+        const uint64_t us = (uint64_t(bytes) * 9 + 2) * 1000000ull / _i2cHz;
+        nowUs += us;
+        busUs += us;
+    }
+
+    void update() {
+        if (_converting && !_stalled && nowUs >= _convEndUs) {
+            _converting = false;
+            regs[Ads1115Async::kRegConversion] = static_cast<uint16_t>(input[_convCh]);
+        }
+    }
+
+    static uint32_t convUs(uint16_t cfg) {
+        static const uint32_t kSps[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+        return 1000000u / kSps[(cfg >> 5) & 0x07];
+    }
+
+    uint32_t _i2cHz;
+    bool _converting = false;
+    bool _stalled = false;
+    uint8_t _convCh = 0;
+    uint64_t _convEndUs = 0;
+};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// State machine
+// -----------------------------------------------------------------------------
+
+static void test_begin_configures_rdy_and_starts_ain0(void) {
+    MockAds bus;
+    Ads1115Async adc(bus, MockAds::kAddr);
+
+    TEST_ASSERT_TRUE(adc.begin());
+    TEST_ASSERT_EQUAL_HEX16(0x8000, bus.regs[Ads1115Async::kRegHiThresh]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, bus.regs[Ads1115Async::kRegLoThresh]);
+    // OS | AIN0 | 6.144 V | single-shot | 860 SPS | RDY after 1 conversion
+    TEST_ASSERT_EQUAL_HEX16(0xC1E0, bus.regs[Ads1115Async::kRegConfig]);
+    TEST_ASSERT_EQUAL_HEX16(0xD1E0, adc.configWord(1));
+    TEST_ASSERT_EQUAL_HEX16(0xE1E0, adc.configWord(2));
+    TEST_ASSERT_EQUAL_HEX16(0xF1E0, adc.configWord(3));
+    TEST_ASSERT_EQUAL_UINT8(0, adc.channel());
+    TEST_ASSERT_TRUE(bus.converting());
+    TEST_ASSERT_EQUAL_UINT32(1280, adc.conversionUs());
+}
+
+static void test_round_robin_one_read_one_write_per_rdy(void) {
+    MockAds bus;
+    Ads1115Async adc(bus, MockAds::kAddr);
+    TEST_ASSERT_TRUE(adc.begin());
+
+    const uint32_t writesAfterBegin = bus.writes;
+    uint32_t rounds = 0;
+    for (int i = 0; i < 12; ++i) {
+        TEST_ASSERT_TRUE(bus.finish());
+        if (adc.onReady()) {
+            rounds++;
+            TEST_ASSERT_EQUAL_UINT8(0, adc.channel());
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(3, rounds);
+    TEST_ASSERT_EQUAL_UINT32(3, adc.roundCount());
+    TEST_ASSERT_EQUAL_UINT32(12, adc.conversionCount());
+    TEST_ASSERT_EQUAL_UINT32(12, bus.conversionReads);
+    TEST_ASSERT_EQUAL_UINT32(12, bus.writes - writesAfterBegin);
+    TEST_ASSERT_EQUAL_UINT32(0, bus.readsWhileBusy);
+    for (uint8_t ch = 0; ch < 4; ++ch) {
+        TEST_ASSERT_EQUAL_INT16(bus.input[ch], adc.raw(ch));
+    }
+    TEST_ASSERT_EQUAL_UINT32(13, bus.starts.size());
+    for (size_t i = 0; i < bus.starts.size(); ++i) {
+        TEST_ASSERT_EQUAL_UINT8(i % 4, bus.starts[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, adc.busErrorCount());
+    TEST_ASSERT_EQUAL_UINT32(0, adc.timeoutCount());
+}
+
+static void test_timeout_missed_edge_and_stuck(void) {
+    MockAds bus;
+    Ads1115Async adc(bus, MockAds::kAddr);
+    TEST_ASSERT_TRUE(adc.begin());
+
+    // Missed edge: the conversion is done, only onTimeout() runs.
+    bus.nowUs += adc.timeoutUs();
+    adc.onTimeout();
+    TEST_ASSERT_EQUAL_INT16(bus.input[0], adc.raw(0));
+    TEST_ASSERT_EQUAL_UINT8(1, adc.channel());
+    TEST_ASSERT_EQUAL_UINT32(1, adc.timeoutCount());
+
+    // Stuck conversion: OS never reports idle, AIN1 is started again.
+    bus.stall();
+    bus.starts.clear();
+    const uint32_t convReads = bus.conversionReads;
+    bus.nowUs += adc.timeoutUs();
+    TEST_ASSERT_FALSE(adc.onTimeout());
+    TEST_ASSERT_EQUAL_UINT8(1, adc.channel());
+    TEST_ASSERT_EQUAL_UINT32(1, bus.starts.size());
+    TEST_ASSERT_EQUAL_UINT8(1, bus.starts.back());
+    TEST_ASSERT_EQUAL_UINT32(convReads, bus.conversionReads);
+    TEST_ASSERT_EQUAL_UINT32(2, adc.timeoutCount());
+
+    TEST_ASSERT_TRUE(bus.finish());
+    adc.onReady();
+    TEST_ASSERT_EQUAL_INT16(bus.input[1], adc.raw(1));
+    TEST_ASSERT_EQUAL_UINT32(0, bus.readsWhileBusy);
+}
+
+static void test_bus_errors_retry_same_channel(void) {
+    MockAds bus;
+    Ads1115Async adc(bus, MockAds::kAddr);
+    TEST_ASSERT_TRUE(adc.begin());
+
+    // AIN0 finished, but the conversion read fails: AIN0 is converted again.
+    TEST_ASSERT_TRUE(bus.finish());
+    bus.failReads = 1;
+    TEST_ASSERT_FALSE(adc.onReady());
+    TEST_ASSERT_EQUAL_UINT32(1, adc.busErrorCount());
+    TEST_ASSERT_EQUAL_UINT8(0, adc.channel());
+    TEST_ASSERT_EQUAL_UINT8(0, bus.starts.back());
+    TEST_ASSERT_EQUAL_INT16(0, adc.raw(0));
+
+    // Next RDY recovers.
+    TEST_ASSERT_TRUE(bus.finish());
+    adc.onReady();
+    TEST_ASSERT_EQUAL_INT16(bus.input[0], adc.raw(0));
+    TEST_ASSERT_EQUAL_UINT8(1, adc.channel());
+
+    // Failed config write: the timeout path restarts the channel.
+    TEST_ASSERT_TRUE(bus.finish());
+    bus.failWrites = 1;
+    adc.onReady(); // AIN1 read, starting AIN2 fails
+    TEST_ASSERT_EQUAL_UINT32(2, adc.busErrorCount());
+    TEST_ASSERT_FALSE(bus.converting());
+    const uint32_t convReads = bus.conversionReads;
+    bus.nowUs += adc.timeoutUs();
+    adc.onTimeout(); // restarts AIN2 without reading the stale AIN1 result
+    TEST_ASSERT_TRUE(bus.converting());
+    TEST_ASSERT_EQUAL_UINT32(convReads, bus.conversionReads);
+    TEST_ASSERT_EQUAL_UINT8(2, adc.channel());
+    TEST_ASSERT_EQUAL_INT16(0, adc.raw(2));
+
+    // No failure leaves the driver without a running conversion.
+    for (int i = 0; i < 8; ++i) {
+        TEST_ASSERT_TRUE(bus.finish());
+        adc.onReady();
+    }
+    TEST_ASSERT_EQUAL_INT16(bus.input[2], adc.raw(2));
+    TEST_ASSERT_EQUAL_INT16(bus.input[3], adc.raw(3));
+    TEST_ASSERT_EQUAL_UINT32(0, bus.readsWhileBusy);
+}
+
+static void test_poll_without_rdy_pin(void) {
+    MockAds bus;
+    Ads1115Async adc(bus, MockAds::kAddr);
+    TEST_ASSERT_TRUE(adc.begin());
+
+    TEST_ASSERT_FALSE(adc.poll()); // still converting
+    TEST_ASSERT_EQUAL_UINT32(0, bus.conversionReads);
+
+    uint32_t rounds = 0;
+    while (rounds < 2) {
+        bus.nowUs += 100;
+        rounds += adc.poll() ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, adc.conversionCount());
+    TEST_ASSERT_EQUAL_UINT32(0, bus.readsWhileBusy);
+    TEST_ASSERT_EQUAL_UINT32(0, adc.timeoutCount());
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+struct BenchResult {
+    double roundsPerSec;
+    double blockedPct; // share of time the caller spends inside I2C / waiting
+};
+
+// Former path: start, poll OS until idle, read (readADC_SingleEnded).
+static BenchResult run_blocking(uint32_t i2cHz, Ads1115Async::DataRate rate) {
+    MockAds bus(i2cHz);
+    Ads1115Async adc(bus, MockAds::kAddr, rate);
+    adc.begin();
+    const uint64_t endUs = 1000000;
+    while (bus.nowUs < endUs) {
+        adc.poll();
+    }
+    return {double(adc.roundCount()), 100.0};
+}
+
+// New path: the task sleeps until RDY and only blocks for the two transfers.
+static BenchResult run_rdy(uint32_t i2cHz, Ads1115Async::DataRate rate) {
+    MockAds bus(i2cHz);
+    Ads1115Async adc(bus, MockAds::kAddr, rate);
+    adc.begin();
+    const uint64_t endUs = 1000000;
+    bus.busUs = 0;
+    while (bus.nowUs < endUs) {
+        bus.finish();
+        adc.onReady();
+    }
+    return {double(adc.roundCount()), 100.0 * double(bus.busUs) / double(bus.nowUs)};
+}
+
+static void test_bench_rounds_and_blocked_time(void) {
+    const BenchResult oldPath = run_blocking(100000, Ads1115Async::DataRate::Sps128);
+    const BenchResult oldFast = run_blocking(400000, Ads1115Async::DataRate::Sps860);
+    const BenchResult rdy = run_rdy(400000, Ads1115Async::DataRate::Sps860);
+
+    TEST_ASSERT_TRUE(rdy.roundsPerSec > 150.0);
+    TEST_ASSERT_TRUE(rdy.blockedPct < 25.0);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] AIN0..3 rounds/s: blocking 128SPS@100k %.0f, blocking 860SPS@400k %.0f (caller blocked %.0f%%), "
+             "RDY 860SPS@400k %.0f (task blocked %.1f%%)",
+             oldPath.roundsPerSec, oldFast.roundsPerSec, oldFast.blockedPct, rdy.roundsPerSec, rdy.blockedPct);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_configures_rdy_and_starts_ain0);
+    RUN_TEST(test_round_robin_one_read_one_write_per_rdy);
+    RUN_TEST(test_timeout_missed_edge_and_stuck);
+    RUN_TEST(test_bus_errors_retry_same_channel);
+    RUN_TEST(test_poll_without_rdy_pin);
+    RUN_TEST(test_bench_rounds_and_blocked_time);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,315 @@
+// ============================================================================
+//  test_native_baud / test_main.cpp
+//
+//  Native (PC) tests for the runtime link baud rate negotiation (H;BAUD).
+//
+//  - Codec: H;BAUD / C;ACK;BAUD round trip
+//  - Upgrade to 921600 after link sync (ASCII and binary link mode)
+//  - A rate that fails verification is dropped, the next lower one is used
+//  - Error bursts at a raised rate fall back to 115200 on both sides
+//  - Pipelined commands in flight across a fallback: the ones sent after it
+//    are applied (sequence numbers resync)
+//  - Client: unsupported proposals refused, unconfirmed switch reverted,
+//    host timeout reverts the rate
+//
+//  The link (DelayLink, delay_link.h) tags every TX byte with the sender's
+//  baud rate. Bytes received at a different rate turn into garbage;
+//  `noisyBaud` adds bit errors at one rate. Transfer time follows the rate
+//  (10 bits per byte).
+//  The host application pings like oven_comm_poll().
+//
+//  Run:
+//    pio test -e native -f test_native_baud -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "delay_link.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+
+// -----------------------------------------------------------------------------
+// Rate-aware UART link
+// -----------------------------------------------------------------------------
+
+static constexpr uint32_t kLinkLatencyMs = 1;
+static constexpr uint32_t kClientLoopMs = 5;
+
+static DelayLinkConfig link_config() {
+    DelayLinkConfig cfg;
+    cfg.latencyMs = kLinkLatencyMs;
+    cfg.clientLoopMs = kClientLoopMs;
+    cfg.serialize = true;
+    return cfg;
+}
+
+static DelayLink g_link(Serial1, Serial2, link_config());
+static uint32_t g_lastPingMs = 0;
+static bool g_hostSilent = false;
+
+// Keep-alive like oven_comm_poll(): fast pings until synced, then 1 s.
+static void host_app(HostComm &host) {
+    if (g_hostSilent) {
+        return;
+    }
+    const uint32_t interval = host.linkSynced() ? 1000 : 100;
+    if (millis() - g_lastPingMs >= interval) {
+        g_lastPingMs = millis();
+        host.sendPing();
+    }
+}
+
+static void run_for(HostComm &host, ClientComm &client, uint32_t ms) {
+    g_link.runForMs(host, client, ms);
+}
+
+static void start(HostComm &host, ClientComm &client, uint32_t target) {
+    host.begin(115200, 16, 17);
+    client.begin(115200);
+    host.setLinkBaudTarget(target);
+    g_link.setHostApp(host_app);
+    g_lastPingMs = millis() - 1000;
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void setUp(void) {
+    g_link.config().noisyBaud = 0;
+    g_link.config().noisePerMille = 0;
+    g_link.reset();
+    g_hostSilent = false;
+}
+void tearDown(void) {}
+
+void test_codec(void) {
+    char buf[ProtocolCodec::kMaxFrameLen];
+    ProtocolMessage msg;
+
+    TEST_ASSERT_EQUAL_size_t(13, ProtocolCodec::buildHostBaud(buf, sizeof(buf), ProtocolLinkBaud::toField(921600)));
+    TEST_ASSERT_EQUAL_STRING("H;BAUD;2400\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, 11, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostBaud, (int)msg.type);
+    TEST_ASSERT_EQUAL_UINT32(921600, ProtocolLinkBaud::fromField(msg.mask));
+
+    ProtocolCodec::buildClientAckBaud(buf, sizeof(buf), ProtocolLinkBaud::toField(115200));
+    TEST_ASSERT_EQUAL_STRING("C;ACK;BAUD;0480\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, 15, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckBaud, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x0480, msg.mask);
+
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("H;BAUD", 6, msg));
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("H;BAUD;2400;0000", 16, msg));
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("C;ACK;BAUD;2400;#01", 19, msg));
+
+    TEST_ASSERT_EQUAL_INT8(0, ProtocolLinkBaud::indexOf(921600));
+    TEST_ASSERT_EQUAL_INT8(3, ProtocolLinkBaud::indexOf(115200));
+    TEST_ASSERT_EQUAL_INT8(-1, ProtocolLinkBaud::indexOf(57600));
+}
+
+void test_upgrade_to_921600(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    start(host, client, 921600);
+    host.setBinaryModeEnabled(true);
+
+    run_for(host, client, 3000);
+
+    TEST_ASSERT_TRUE(host.linkSynced());
+    TEST_ASSERT_TRUE(host.binaryActive());
+    TEST_ASSERT_TRUE(host.linkBaudRaised());
+    TEST_ASSERT_EQUAL_UINT32(921600, host.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(921600, client.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(921600, Serial1.baudRate());
+    TEST_ASSERT_EQUAL_UINT32(921600, Serial2.baudRate());
+    TEST_ASSERT_EQUAL_UINT32(0, host.baudFallbackCount());
+    TEST_ASSERT_EQUAL_UINT16(1, host.linkRateStats(0).upgrades);
+    TEST_ASSERT_GREATER_THAN(0u, host.linkRateStats(0).rxFrames);
+    TEST_ASSERT_TRUE(host.linkErrorRate(921600) == 0.0f);
+    TEST_ASSERT_EQUAL_UINT32(0, g_link.hostToClient().garbled + g_link.clientToHost().garbled);
+    TEST_ASSERT_FALSE(host.hasCommError());
+
+    // Traffic at the new rate works.
+    host.clearNewStatusFlag();
+    host.requestStatus();
+    run_for(host, client, 20);
+    TEST_ASSERT_TRUE(host.hasNewStatus());
+}
+
+void test_broken_rate_steps_down(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    start(host, client, 921600);
+
+    g_link.config().noisyBaud = 921600;
+    g_link.config().noisePerMille = 1000; // unusable
+    run_for(host, client, 5000);
+
+    TEST_ASSERT_TRUE(host.linkSynced());
+    TEST_ASSERT_EQUAL_UINT32(460800, host.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(460800, client.linkBaud());
+    TEST_ASSERT_TRUE(host.linkBaudRaised());
+    TEST_ASSERT_EQUAL_UINT32(1, host.baudFallbackCount());
+    TEST_ASSERT_EQUAL_UINT16(1, host.linkRateStats(0).fallbacks);
+    TEST_ASSERT_EQUAL_UINT16(0, host.linkRateStats(0).upgrades);
+    TEST_ASSERT_EQUAL_UINT16(1, host.linkRateStats(1).upgrades);
+    TEST_ASSERT_GREATER_THAN(0u, host.linkRateStats(0).rxErrors);
+    TEST_ASSERT_TRUE(host.linkErrorRate(921600) > 0.5f);
+    TEST_ASSERT_TRUE(host.linkErrorRate(460800) == 0.0f);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "[BENCH] error rate 921600: %.2f, 460800: %.2f, 115200: %.2f (fallbacks %lu)",
+             (double)host.linkErrorRate(921600), (double)host.linkErrorRate(460800),
+             (double)host.linkErrorRate(115200), (unsigned long)host.baudFallbackCount());
+    TEST_MESSAGE(msg);
+}
+
+void test_error_burst_falls_back_both_sides(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    start(host, client, 921600);
+    run_for(host, client, 2000);
+    TEST_ASSERT_EQUAL_UINT32(921600, host.linkBaud());
+
+    // Link degrades after the upgrade: both ends go back to 115200.
+    g_link.config().noisyBaud = 921600;
+    g_link.config().noisePerMille = 300;
+    uint32_t guard = 0;
+    while (host.baudFallbackCount() == 0 && guard++ < 10000) {
+        host.requestStatus();
+        run_for(host, client, 20);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, host.baudFallbackCount());
+
+    run_for(host, client, 3000);
+    TEST_ASSERT_GREATER_OR_EQUAL(1u, client.baudFallbackCount());
+    TEST_ASSERT_TRUE(host.linkSynced());
+    TEST_ASSERT_EQUAL_UINT32(host.linkBaud(), client.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(460800, host.linkBaud()); // next lower rate
+    TEST_ASSERT_GREATER_THAN(0u, host.linkRateStats(0).rxErrors);
+}
+
+void test_commands_across_fallback(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start(host, client, 921600);
+    run_for(host, client, 2000);
+    TEST_ASSERT_EQUAL_UINT32(921600, host.linkBaud());
+
+    // Commands keep going out while the raised rate degrades; the fallback
+    // drops whatever is still in flight.
+    g_link.config().noisyBaud = 921600;
+    g_link.config().noisePerMille = 300;
+    host.setOutputsMask(0x0001);
+    uint32_t guard = 0;
+    while (host.baudFallbackCount() == 0 && guard++ < 10000) {
+        if (host.commandsPending() < 4) {
+            host.togOutputs(0x0010);
+        }
+        host.requestStatus();
+        run_for(host, client, 20);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, host.baudFallbackCount());
+    TEST_ASSERT_GREATER_THAN(0u, host.cmdDroppedCount());
+
+    run_for(host, client, 3000);
+    TEST_ASSERT_TRUE(host.linkSynced());
+    TEST_ASSERT_EQUAL_UINT32(host.linkBaud(), client.linkBaud());
+
+    const uint32_t failed = host.cmdFailedCount();
+    host.setOutputsMask(0x0003);
+    host.updOutputs(0x0004, 0x0000);
+    host.togOutputs(0x0001);
+    run_for(host, client, 300);
+    TEST_ASSERT_EQUAL_HEX16(0x0006, client.getOutputsMask());
+    host.setOutputsMask(0x0000);
+    run_for(host, client, 300);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0000, host.getRemoteOutputsMask());
+    TEST_ASSERT_EQUAL_UINT32(failed, host.cmdFailedCount());
+    TEST_ASSERT_EQUAL_UINT8(0, host.commandsPending());
+}
+
+void test_client_refuses_and_reverts(void) {
+    ClientComm client(Serial2, 16, 17);
+    client.begin(115200);
+
+    // Unsupported rate: answered with the current one, no switch.
+    client.processLine("H;BAUD;00C8"); // 20000 baud
+    TEST_ASSERT_EQUAL_STRING("C;ACK;BAUD;0480\r\n", Serial2.takeTx().c_str());
+    TEST_ASSERT_EQUAL_UINT32(115200, client.linkBaud());
+
+    // Supported rate without a confirming host frame: back after the window.
+    client.processLine("H;BAUD;2400");
+    TEST_ASSERT_EQUAL_STRING("C;ACK;BAUD;2400\r\n", Serial2.takeTx().c_str());
+    TEST_ASSERT_EQUAL_UINT32(921600, client.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(921600, Serial2.baudRate());
+    arduino_native::advance_ms(600);
+    client.loop();
+    TEST_ASSERT_EQUAL_UINT32(115200, client.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(115200, Serial2.baudRate());
+    TEST_ASSERT_EQUAL_UINT32(1, client.baudFallbackCount());
+
+    // Confirmed rate, then the host goes silent: host timeout reverts it.
+    client.processLine("H;BAUD;1200");
+    client.processLine("H;PING");
+    arduino_native::advance_ms(600);
+    client.loop();
+    TEST_ASSERT_EQUAL_UINT32(460800, client.linkBaud());
+    arduino_native::advance_ms(2000);
+    client.loop();
+    TEST_ASSERT_EQUAL_UINT32(115200, client.linkBaud());
+    TEST_ASSERT_EQUAL_UINT32(2, client.baudFallbackCount());
+    Serial2.takeTx();
+}
+
+void test_status_round_trip_per_rate(void) {
+    uint32_t rtt[2] = {0, 0};
+    const uint32_t targets[2] = {0, 921600};
+    for (int r = 0; r < 2; ++r) {
+        setUp();
+        HostComm host(Serial1);
+        ClientComm client(Serial2, 16, 17);
+        start(host, client, targets[r]);
+        run_for(host, client, 2000);
+
+        const uint32_t t0 = millis();
+        for (int i = 0; i < 20; ++i) {
+            host.clearNewStatusFlag();
+            host.requestStatus();
+            uint32_t guard = 0;
+            while (!host.hasNewStatus() && guard++ < 1000) {
+                g_link.step(host, client);
+            }
+            TEST_ASSERT_TRUE(host.hasNewStatus());
+        }
+        rtt[r] = millis() - t0;
+    }
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] 20 GET/STATUS round trips (ASCII): 115200 %lu ms, 921600 %lu ms",
+             (unsigned long)rtt[0], (unsigned long)rtt[1]);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN(rtt[0], rtt[1]);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_codec);
+    RUN_TEST(test_upgrade_to_921600);
+    RUN_TEST(test_broken_rate_steps_down);
+    RUN_TEST(test_error_burst_falls_back_both_sides);
+    RUN_TEST(test_commands_across_fallback);
+    RUN_TEST(test_client_refuses_and_reverts);
+    RUN_TEST(test_status_round_trip_per_rate);
+    return UNITY_END();
+}
+
+// EOF
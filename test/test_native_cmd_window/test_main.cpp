@@ -0,0 +1,373 @@
+// ============================================================================
+//  test_native_cmd_window / test_main.cpp
+//
+//  Native (PC) tests for pipelined SET/UPD/TOG with sequence numbers.
+//
+//  - Codec: optional ";#QQ" field (ASCII) / seq byte (binary)
+//  - HostComm window: out-of-order ACK matching, retransmit, accounting
+//  - ClientComm: in-order apply, duplicates re-ACKed but not re-applied
+//  - A command lost for good (all retries) does not block the ones after it:
+//    a SET 0 in flight behind it and commands sent after it failed apply
+//  - Full queue: relative commands are refused, a SET supersedes the queue
+//  - Timing: the Test_Seq_SetUpdTogStatus sequence (SET -> UPD -> TOG ->
+//    GET/STATUS) in lockstep vs. with a window of 4
+//
+//  The link is a delay line between the in-memory UARTs (one-way latency
+//  kLinkLatencyMs); the client application loop runs every kClientLoopMs.
+//
+//  Run:
+//    pio test -e native -f test_native_cmd_window -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "delay_link.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+
+// -----------------------------------------------------------------------------
+// Delay-line link
+// -----------------------------------------------------------------------------
+
+static constexpr uint32_t kLinkLatencyMs = 5;
+static constexpr uint32_t kClientLoopMs = 10;
+
+static DelayLinkConfig link_config() {
+    DelayLinkConfig cfg;
+    cfg.latencyMs = kLinkLatencyMs;
+    cfg.clientLoopMs = kClientLoopMs;
+    return cfg;
+}
+
+static DelayLink g_link(Serial1, Serial2, link_config());
+static DelayLink::Direction &g_h2c = g_link.hostToClient();
+static DelayLink::Direction &g_c2h = g_link.clientToHost();
+static uint32_t g_clientApplies = 0;
+
+static void outputs_changed_cb(uint16_t) {
+    g_clientApplies++;
+}
+
+static void step(HostComm &host, ClientComm &client) {
+    g_link.step(host, client);
+}
+
+static void run_for(HostComm &host, ClientComm &client, uint32_t ms) {
+    g_link.runForMs(host, client, ms);
+}
+
+static void start_link(HostComm &host, ClientComm &client) {
+    host.begin(115200, 16, 17);
+    client.begin(115200);
+    client.setOutputsChangedCallback(outputs_changed_cb);
+    for (int i = 0; i < 10 && !host.linkSynced(); ++i) {
+        host.sendPing();
+        run_for(host, client, 50);
+    }
+    TEST_ASSERT_TRUE(host.linkSynced());
+}
+
+static void assert_accounted(const HostComm &host) {
+    TEST_ASSERT_EQUAL_UINT32(host.cmdSentCount(), host.cmdAckedCount() + host.cmdFailedCount() +
+                                                      host.cmdDroppedCount() + host.cmdSupersededCount() +
+                                                      host.commandsPending());
+}
+
+// Runs the Test_Seq_SetUpdTogStatus sequence and returns its duration in ms.
+static uint32_t run_sequence(HostComm &host, ClientComm &client, bool pipelined) {
+    const uint32_t t0 = millis();
+    uint32_t guard = 0;
+
+    auto wait_for = [&](uint16_t mask) {
+        while (!(host.getRemoteOutputsMask() == mask && host.commandsPending() == 0) && guard++ < 5000) {
+            step(host, client);
+        }
+    };
+
+    if (pipelined) {
+        host.setOutputsMask(0x0001);
+        host.updOutputs(0x0002, 0x0000);
+        host.togOutputs(0x0001);
+        wait_for(0x0002);
+    } else {
+        host.setOutputsMask(0x0001);
+        wait_for(0x0001);
+        host.updOutputs(0x0002, 0x0000);
+        wait_for(0x0003);
+        host.togOutputs(0x0001);
+        wait_for(0x0002);
+    }
+
+    host.clearNewStatusFlag();
+    host.requestStatus();
+    while (!host.hasNewStatus() && guard++ < 5000) {
+        step(host, client);
+    }
+    TEST_ASSERT_TRUE(host.hasNewStatus());
+    TEST_ASSERT_EQUAL_HEX16(0x0002, host.getRemoteStatus().outputsMask);
+    return millis() - t0;
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void setUp(void) {
+    g_link.reset();
+    g_clientApplies = 0;
+}
+void tearDown(void) {}
+
+void test_codec_sequence_field(void) {
+    ProtocolMessage msg;
+    char buf[ProtocolCodec::kMaxFrameLen];
+
+    TEST_ASSERT_EQUAL_size_t(16, ProtocolCodec::buildHostSet(buf, sizeof(buf), 0x0019, 0x2A));
+    TEST_ASSERT_EQUAL_STRING("H;SET;0019;#2A\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, 14, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostSet, (int)msg.type);
+    TEST_ASSERT_EQUAL_UINT8(0x2A, msg.seq);
+
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("H;UPD;0002;0000;#ff", 19, msg));
+    TEST_ASSERT_EQUAL_UINT8(0xFF, msg.seq);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("C;ACK;TOG;0002;#07", 18, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckTog, (int)msg.type);
+    TEST_ASSERT_EQUAL_UINT8(7, msg.seq);
+
+    // Without the field the frame is unchanged and seq is 0.
+    TEST_ASSERT_EQUAL_size_t(12, ProtocolCodec::buildHostTog(buf, sizeof(buf), 0x0001));
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("C;ACK;SET;0019", 14, msg));
+    TEST_ASSERT_EQUAL_UINT8(0, msg.seq);
+
+    static const char *const kBad[] = {
+        "H;SET;0019;#00", "H;SET;0019;#1", "H;SET;0019;#123", "H;SET;0019;2A", "H;SET;0019;#G1",
+        "H;TOG;0001;#", "C;ACK;BIN;0001;#01", "C;ACK;SUB;01F4;#01",
+    };
+    for (const char *f : kBad) {
+        TEST_ASSERT_FALSE_MESSAGE(ProtocolCodec::parseFrame(f, strlen(f), msg), f);
+    }
+
+    // Binary: optional trailing seq byte.
+    ProtocolMessage in;
+    memset(&in, 0, sizeof(in));
+    in.type = ProtocolMessageType::HostUpd;
+    in.mask = 0x1234;
+    in.maskB = 0x0F0F;
+    in.seq = 0x81;
+    uint8_t frame[ProtocolBinCodec::kMaxFrameLen];
+    const size_t len = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(ProtocolBinCodec::decode(frame + 1, len - 2, msg));
+    TEST_ASSERT_EQUAL_UINT8(0x81, msg.seq);
+    TEST_ASSERT_EQUAL_HEX16(0x0F0F, msg.maskB);
+
+    in.type = ProtocolMessageType::HostPing; // no seq field for PING
+    const size_t len2 = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+    TEST_ASSERT_TRUE(ProtocolBinCodec::decode(frame + 1, len2 - 2, msg));
+    TEST_ASSERT_EQUAL_UINT8(0, msg.seq);
+}
+
+void test_pipelined_sequence_is_faster(void) {
+    uint32_t lockstepMs = 0;
+    uint32_t pipelinedMs = 0;
+    {
+        HostComm host(Serial1);
+        ClientComm client(Serial2, 16, 17);
+        start_link(host, client);
+        lockstepMs = run_sequence(host, client, false);
+    }
+    {
+        HostComm host(Serial1);
+        ClientComm client(Serial2, 16, 17);
+        host.setCommandWindow(4);
+        start_link(host, client);
+        pipelinedMs = run_sequence(host, client, true);
+        TEST_ASSERT_EQUAL_UINT32(3, host.cmdSentCount());
+        TEST_ASSERT_EQUAL_UINT32(3, host.cmdAckedCount());
+        TEST_ASSERT_EQUAL_UINT32(0, host.cmdRetransmitCount());
+        assert_accounted(host);
+    }
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] SET->UPD->TOG->STATUS: lockstep %lu ms, window 4: %lu ms (latency %lu ms, client loop %lu ms)",
+             (unsigned long)lockstepMs, (unsigned long)pipelinedMs, (unsigned long)kLinkLatencyMs,
+             (unsigned long)kClientLoopMs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN(lockstepMs * 2 / 3, pipelinedMs);
+}
+
+void test_lost_command_is_retransmitted_in_order(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start_link(host, client);
+
+    g_h2c.dropPrefix = "H;UPD;";
+    g_h2c.dropCount = 1;
+    g_clientApplies = 0;
+
+    host.setOutputsMask(0x0001);
+    host.updOutputs(0x0002, 0x0000);
+    host.togOutputs(0x0001);
+    run_for(host, client, 600);
+
+    // TOG arrived before the retransmitted UPD and was held back.
+    TEST_ASSERT_EQUAL_HEX16(0x0002, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0002, host.getRemoteOutputsMask());
+    TEST_ASSERT_EQUAL_UINT32(3, g_clientApplies);
+    TEST_ASSERT_EQUAL_UINT32(3, host.cmdAckedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, host.cmdFailedCount());
+    TEST_ASSERT_GREATER_THAN(0u, host.cmdRetransmitCount());
+    TEST_ASSERT_FALSE(host.hasCommError());
+    assert_accounted(host);
+}
+
+void test_lost_ack_does_not_toggle_twice(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start_link(host, client);
+
+    g_c2h.dropPrefix = "C;ACK;TOG;";
+    g_c2h.dropCount = 1;
+    g_clientApplies = 0;
+
+    host.setOutputsMask(0x0003);
+    host.togOutputs(0x0001);
+    run_for(host, client, 600);
+
+    TEST_ASSERT_EQUAL_HEX16(0x0002, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0002, host.getRemoteOutputsMask());
+    TEST_ASSERT_EQUAL_UINT32(2, g_clientApplies);
+    TEST_ASSERT_EQUAL_UINT32(2, host.cmdAckedCount());
+    TEST_ASSERT_EQUAL_UINT32(1, host.cmdRetransmitCount());
+    assert_accounted(host);
+}
+
+void test_dead_link_fails_commands(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start_link(host, client);
+
+    g_h2c.dropPrefix = "H;";
+    g_h2c.dropCount = -1;
+
+    host.setOutputsMask(0x0001);
+    host.togOutputs(0x0001);
+    run_for(host, client, 1000);
+
+    TEST_ASSERT_EQUAL_UINT32(2, host.cmdFailedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, host.commandsPending());
+    TEST_ASSERT_TRUE(host.hasCommError());
+    assert_accounted(host);
+}
+
+void test_lost_command_does_not_block_later_ones(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start_link(host, client);
+
+    host.setOutputsMask(0x0003);
+    run_for(host, client, 100);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, client.getOutputsMask());
+
+    // The UPD and all its retransmits are lost; the safe stop right behind
+    // it is ahead of the gap but absolute.
+    g_h2c.dropPrefix = "H;UPD;";
+    g_h2c.dropCount = 1 + 3; // + kCmdMaxRetries
+    host.updOutputs(0x0004, 0x0000);
+    host.setOutputsMask(0x0000);
+    run_for(host, client, 1000);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_UINT32(1, host.cmdFailedCount());
+    TEST_ASSERT_EQUAL_UINT8(0, host.commandsPending());
+
+    // Lost again, nothing behind it: the next sequence number jumps and
+    // the client takes even a relative command.
+    g_h2c.dropCount = 1 + 3;
+    host.updOutputs(0x0004, 0x0000);
+    run_for(host, client, 1000);
+    TEST_ASSERT_EQUAL_UINT32(2, host.cmdFailedCount());
+    host.togOutputs(0x0001);
+    run_for(host, client, 200);
+    TEST_ASSERT_EQUAL_HEX16(0x0001, client.getOutputsMask());
+    for (int i = 0; i < 3; ++i) {
+        host.setOutputsMask(0x0000);
+    }
+    run_for(host, client, 200);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0000, host.getRemoteOutputsMask());
+    TEST_ASSERT_EQUAL_UINT32(2, host.cmdFailedCount());
+    assert_accounted(host);
+}
+
+void test_window_and_queue_limits(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start_link(host, client);
+
+    // 4 in flight + 8 queued are accepted, the rest is dropped and counted.
+    for (int i = 0; i < 14; ++i) {
+        host.togOutputs(0x0001);
+    }
+    TEST_ASSERT_EQUAL_UINT8(12, host.commandsPending());
+    TEST_ASSERT_EQUAL_UINT32(2, host.cmdDroppedCount());
+
+    run_for(host, client, 300);
+    TEST_ASSERT_EQUAL_UINT8(0, host.commandsPending());
+    TEST_ASSERT_EQUAL_UINT32(12, host.cmdAckedCount());
+    TEST_ASSERT_EQUAL_HEX16(0x0000, client.getOutputsMask()); // 12 toggles
+    assert_accounted(host);
+}
+
+void test_full_queue_keeps_latest_set(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    host.setCommandWindow(4);
+    start_link(host, client);
+
+    // Window and queue full of toggles: a relative command is refused, the
+    // SET that follows replaces the queued ones and still reaches the client.
+    for (int i = 0; i < 12; ++i) {
+        TEST_ASSERT_TRUE(host.togOutputs(0x0001));
+    }
+    TEST_ASSERT_FALSE(host.updOutputs(0x0008, 0x0000));
+    host.setOutputsMask(0x0006);
+    TEST_ASSERT_EQUAL_UINT32(1, host.cmdDroppedCount());
+    TEST_ASSERT_EQUAL_UINT32(8, host.cmdSupersededCount());
+    TEST_ASSERT_EQUAL_UINT8(5, host.commandsPending());
+
+    run_for(host, client, 300);
+    TEST_ASSERT_EQUAL_UINT8(0, host.commandsPending());
+    TEST_ASSERT_EQUAL_HEX16(0x0006, client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(0x0006, host.getRemoteOutputsMask());
+    TEST_ASSERT_EQUAL_UINT32(0, host.cmdFailedCount());
+
+    // The gap of superseded numbers does not hold up later commands.
+    host.togOutputs(0x0001);
+    run_for(host, client, 100);
+    TEST_ASSERT_EQUAL_HEX16(0x0007, client.getOutputsMask());
+    assert_accounted(host);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_codec_sequence_field);
+    RUN_TEST(test_pipelined_sequence_is_faster);
+    RUN_TEST(test_lost_command_is_retransmitted_in_order);
+    RUN_TEST(test_lost_ack_does_not_toggle_twice);
+    RUN_TEST(test_dead_link_fails_commands);
+    RUN_TEST(test_lost_command_does_not_block_later_ones);
+    RUN_TEST(test_window_and_queue_limits);
+    RUN_TEST(test_full_queue_keeps_latest_set);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,392 @@
+// ============================================================================
+//  test_native_flight_recorder / test_main.cpp
+//
+//  Native (PC) tests for the flight recorder (flight_recorder.h) and its
+//  host glue (src/app/flight_recorder.cpp, compiled into this test).
+//
+//  - sample codec: key and delta samples round-trip, int16 extremes, time
+//    gaps; an unchanged sample costs one byte
+//  - blocks: every block decodes on its own, a damaged block is rejected
+//  - ring: the oldest block is overwritten, stats follow (held, bytes,
+//    oldest/newest time), blockBySeq() of an overwritten block is nullptr
+//  - freeze: n more samples after the request, then appends are ignored
+//    until resume
+//  - dump lines: format -> parse with a log prefix, CRC and length checks
+//  - host dump: "fr dump" on the console decodes back to exactly the held
+//    samples; "fr dump udp" stays off the console; console commands
+//  - benchmark: bytes per sample over a synthetic 24 h day (runs with
+//    noise, idle time), 24 h against FLIGHT_REC_BYTES, append time
+//
+//  Run:
+//    pio test -e native -f test_native_flight_recorder -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "../../src/app/flight_recorder.cpp"
+
+using flight_rec::FlightSample;
+using flight_rec::Recorder;
+
+static FlightSample make_sample(uint32_t t, int16_t ch, int16_t hot, int16_t tgt, uint8_t flags = 0,
+                                uint8_t stage = 0, uint8_t mode = 0) {
+    FlightSample s{};
+    s.t_s = t;
+    s.chamber_dC = ch;
+    s.hotspot_dC = hot;
+    s.target_dC = tgt;
+    s.flags = flags;
+    s.stage = stage;
+    s.mode = mode;
+    return s;
+}
+
+// Every sample of every held block, oldest first.
+static std::vector<FlightSample> decode_all(const Recorder &rec) {
+    std::vector<FlightSample> out;
+    if (rec.empty()) {
+        return out;
+    }
+    for (uint32_t seq = rec.firstSeq(); seq <= rec.lastSeq(); ++seq) {
+        size_t len = 0;
+        const uint8_t *b = rec.blockBySeq(seq, &len);
+        TEST_ASSERT_TRUE(b != nullptr);
+        const int n = flight_rec::decodeBlock(b, len, [&out](const FlightSample &s) { out.push_back(s); });
+        TEST_ASSERT_TRUE(n > 0);
+    }
+    return out;
+}
+
+// Console capture for the host dump.
+static std::string g_console;
+static void console_capture(const char *data, size_t len) { g_console.append(data, len); }
+
+void setUp(void) {
+    g_console.clear();
+    arduino_native::console_sink() = console_capture;
+}
+
+void tearDown(void) { arduino_native::console_sink() = nullptr; }
+
+// ----------------------------------------------------------------------------
+
+void test_sample_codec(void) {
+    std::vector<FlightSample> in;
+    in.push_back(make_sample(1000, 215, 220, 0));
+    in.push_back(make_sample(1001, 215, 220, 0));                        // unchanged
+    in.push_back(make_sample(1002, 216, 219, 450, 0x13, 2, 1));          // small deltas, flags, stage
+    in.push_back(make_sample(1002, 216, 219, 450, 0x13, 2, 1));          // same second
+    in.push_back(make_sample(1700, -32768, 32767, -32768, 0xFF, 255, 3)); // extremes, 698 s gap
+    in.push_back(make_sample(1701, 32767, -32768, 32767, 0, 0, 0));      // full-range swing
+    in.push_back(make_sample(0xFFFFFFF0u, 0, 0, 0));                     // huge time jump
+
+    uint8_t buf[256];
+    size_t n = 0;
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < in.size(); ++i) {
+        const size_t k = flight_rec::encodeSample(buf + n, in[i], i ? &in[i - 1] : nullptr);
+        TEST_ASSERT_TRUE(k <= flight_rec::kMaxSampleBytes);
+        sizes.push_back(k);
+        n += k;
+    }
+    TEST_ASSERT_EQUAL_size_t(1, sizes[1]); // a steady second is just the mask
+
+    size_t pos = 0;
+    FlightSample prev{};
+    for (size_t i = 0; i < in.size(); ++i) {
+        FlightSample out;
+        TEST_ASSERT_TRUE(flight_rec::decodeSample(buf, n, pos, i == 0, prev, &out));
+        TEST_ASSERT_TRUE(out == in[i]);
+        prev = out;
+    }
+    TEST_ASSERT_EQUAL_size_t(n, pos);
+
+    // Truncated input and unknown mask bits are rejected.
+    pos = 0;
+    FlightSample out;
+    TEST_ASSERT_FALSE(flight_rec::decodeSample(buf, sizes[0] - 1, pos, true, prev, &out));
+    const uint8_t bad[] = {0x40};
+    pos = 0;
+    TEST_ASSERT_FALSE(flight_rec::decodeSample(bad, sizeof(bad), pos, false, prev, &out));
+}
+
+void test_ring_overwrites_oldest(void) {
+    static uint8_t buf[4 * 64];
+    Recorder rec(buf, sizeof(buf), 64);
+    TEST_ASSERT_TRUE(rec.ready());
+    TEST_ASSERT_TRUE(rec.empty());
+
+    std::vector<FlightSample> all;
+    for (uint32_t t = 0; t < 400; ++t) {
+        const FlightSample s = make_sample(5000 + t, static_cast<int16_t>(200 + (t % 37) * 3),
+                                           static_cast<int16_t>(210 + (t % 11)), 450, t % 7 == 0 ? 1 : 0, 1, 1);
+        TEST_ASSERT_TRUE(rec.append(s));
+        all.push_back(s);
+    }
+
+    const Recorder::Stats st = rec.stats();
+    const std::vector<FlightSample> held = decode_all(rec);
+    TEST_ASSERT_EQUAL_UINT32(400u, st.samples);
+    TEST_ASSERT_EQUAL_UINT32(4u, st.blocksHeld);
+    TEST_ASSERT_TRUE(st.evicted > 0);
+    TEST_ASSERT_EQUAL_UINT32(st.held, static_cast<uint32_t>(held.size()));
+    TEST_ASSERT_TRUE(st.bytesHeld <= rec.capacityBytes());
+    TEST_ASSERT_EQUAL_UINT32(held.front().t_s, st.oldest_s);
+    TEST_ASSERT_EQUAL_UINT32(5399u, st.newest_s);
+
+    // The held samples are the newest ones, in order.
+    for (size_t i = 0; i < held.size(); ++i) {
+        TEST_ASSERT_TRUE(held[i] == all[all.size() - held.size() + i]);
+    }
+
+    // Overwritten and future blocks are gone.
+    size_t len = 0;
+    TEST_ASSERT_TRUE(rec.blockBySeq(rec.firstSeq() - 1, &len) == nullptr);
+    TEST_ASSERT_TRUE(rec.blockBySeq(rec.lastSeq() + 1, &len) == nullptr);
+
+    // A damaged block does not decode.
+    uint8_t copy[64];
+    const uint8_t *b = rec.blockBySeq(rec.firstSeq(), &len);
+    memcpy(copy, b, len);
+    copy[flight_rec::kBlockHeader] = 0x7F; // unknown mask bit
+    TEST_ASSERT_EQUAL_INT(-1, flight_rec::decodeBlock(copy, len, [](const FlightSample &) {}));
+    copy[0] = 0;
+    TEST_ASSERT_EQUAL_INT(-1, flight_rec::decodeBlock(copy, len, [](const FlightSample &) {}));
+
+    // Too small for two blocks.
+    Recorder tiny;
+    TEST_ASSERT_FALSE(tiny.attach(buf, 64, 64));
+    TEST_ASSERT_FALSE(tiny.append(make_sample(1, 0, 0, 0)));
+}
+
+void test_freeze_and_resume(void) {
+    static uint8_t buf[8 * 128];
+    Recorder rec(buf, sizeof(buf), 128);
+    for (uint32_t t = 0; t < 10; ++t) {
+        TEST_ASSERT_TRUE(rec.append(make_sample(t, 200, 200, 450)));
+    }
+
+    rec.freeze(3);
+    TEST_ASSERT_TRUE(rec.freezePending());
+    TEST_ASSERT_FALSE(rec.frozen());
+    rec.freeze(100); // a pending freeze is kept as it is
+    for (uint32_t t = 10; t < 13; ++t) {
+        TEST_ASSERT_TRUE(rec.append(make_sample(t, 900, 950, 450, flight_rec::kFlagSafety)));
+    }
+    TEST_ASSERT_TRUE(rec.frozen());
+    TEST_ASSERT_FALSE(rec.freezePending());
+    for (uint32_t t = 13; t < 20; ++t) {
+        TEST_ASSERT_FALSE(rec.append(make_sample(t, 200, 200, 450)));
+    }
+    Recorder::Stats st = rec.stats();
+    TEST_ASSERT_EQUAL_UINT32(13u, st.held);
+    TEST_ASSERT_EQUAL_UINT32(7u, st.ignored);
+    TEST_ASSERT_EQUAL_UINT32(12u, st.newest_s);
+    TEST_ASSERT_EQUAL_UINT8(flight_rec::kFlagSafety, decode_all(rec).back().flags);
+
+    rec.resume();
+    TEST_ASSERT_TRUE(rec.append(make_sample(20, 200, 200, 450)));
+    const std::vector<FlightSample> held = decode_all(rec);
+    TEST_ASSERT_EQUAL_size_t(14, held.size());
+    TEST_ASSERT_EQUAL_UINT32(20u, held.back().t_s); // the gap is kept as a time delta
+
+    rec.freeze(0);
+    TEST_ASSERT_TRUE(rec.frozen());
+    TEST_ASSERT_FALSE(rec.append(make_sample(21, 200, 200, 450)));
+}
+
+void test_dump_lines(void) {
+    static uint8_t buf[4 * 256];
+    Recorder rec(buf, sizeof(buf), 256);
+    for (uint32_t t = 0; t < 50; ++t) {
+        rec.append(make_sample(t, static_cast<int16_t>(t * 5), 300, 450));
+    }
+    size_t len = 0;
+    const uint8_t *b = rec.blockBySeq(rec.firstSeq(), &len);
+
+    std::vector<char> line(flight_rec::blockLineLen(len) + 16);
+    const size_t n = flight_rec::formatBlockLine(line.data(), b, len);
+    TEST_ASSERT_EQUAL_size_t(flight_rec::blockLineLen(len), n);
+    TEST_ASSERT_EQUAL_INT('\n', line[n - 1]);
+
+    uint8_t back[256];
+    TEST_ASSERT_EQUAL_size_t(len, flight_rec::parseBlockLine(line.data(), n, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_MEMORY(b, back, len);
+
+    // Prefixed as in a UDP-only line or a timestamped capture, CRLF ending.
+    std::string prefixed = "12345 ;" + std::string(line.data(), n - 1) + "\r\n";
+    TEST_ASSERT_EQUAL_size_t(len, flight_rec::parseBlockLine(prefixed.data(), prefixed.size(), back, sizeof(back)));
+
+    // One flipped hex digit, a cut line, too small a buffer, no block line.
+    std::string damaged(line.data(), n);
+    damaged[20] = damaged[20] == '0' ? '1' : '0';
+    TEST_ASSERT_EQUAL_size_t(0, flight_rec::parseBlockLine(damaged.data(), damaged.size(), back, sizeof(back)));
+    TEST_ASSERT_EQUAL_size_t(0, flight_rec::parseBlockLine(line.data(), n / 2, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_size_t(0, flight_rec::parseBlockLine(line.data(), n, back, len - 1));
+    const char other[] = "[OVEN/INFO] [FR] BEGIN blocks=1\n";
+    TEST_ASSERT_EQUAL_size_t(0, flight_rec::parseBlockLine(other, sizeof(other) - 1, back, sizeof(back)));
+}
+
+// Runs the dump state machine to the end; returns the steps it took.
+static int run_dump(void) {
+    int steps = 0;
+    while (flight_recorder_dumping() && steps < 100000) {
+        flight_recorder_dump_step();
+        steps++;
+    }
+    return steps;
+}
+
+void test_host_dump_and_commands(void) {
+    TEST_ASSERT_TRUE(flight_recorder_init());
+    TEST_ASSERT_TRUE(flight_recorder_init()); // once only
+    s_recorder.reset();
+
+    std::vector<FlightSample> all;
+    for (uint32_t t = 0; t < 3000; ++t) {
+        const FlightSample s = make_sample(100 + t, static_cast<int16_t>(220 + t / 10), static_cast<int16_t>(230 + t / 9),
+                                           450, (t / 30) % 2 ? flight_rec::kFlagHeaterReq : 0, 1, 1);
+        flight_recorder_append(s);
+        all.push_back(s);
+    }
+    const uint32_t blocks = s_recorder.lastSeq() - s_recorder.firstSeq() + 1;
+
+    g_console.clear();
+    TEST_ASSERT_TRUE(flight_recorder_command("fr dump", 7));
+    TEST_ASSERT_TRUE(flight_recorder_dumping());
+    TEST_ASSERT_FALSE(flight_recorder_dump_start(FLIGHT_DUMP_SERIAL)); // busy
+    // Recording goes on while the dump runs.
+    flight_recorder_append(make_sample(3100, 0, 0, 0));
+    const int steps = run_dump();
+    TEST_ASSERT_EQUAL_INT((int)blocks, steps);
+
+    TEST_ASSERT_TRUE(g_console.find("[FR] BEGIN blocks=") != std::string::npos);
+    TEST_ASSERT_TRUE(g_console.find("[FR] END blocks=") != std::string::npos);
+    std::vector<FlightSample> dumped;
+    size_t start = 0;
+    uint8_t block[FLIGHT_REC_BLOCK_BYTES];
+    while (start < g_console.size()) {
+        size_t end = g_console.find('\n', start);
+        end = end == std::string::npos ? g_console.size() : end + 1;
+        const size_t n = flight_rec::parseBlockLine(g_console.data() + start, end - start, block, sizeof(block));
+        if (n) {
+            TEST_ASSERT_TRUE(flight_rec::decodeBlock(block, n, [&dumped](const FlightSample &s) { dumped.push_back(s); }) > 0);
+        }
+        start = end;
+    }
+    // The ring's block count was fixed at the start; the extra sample went
+    // into the open (last) block.
+    TEST_ASSERT_EQUAL_size_t(all.size() + 1, dumped.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        TEST_ASSERT_TRUE(dumped[i] == all[i]);
+    }
+
+    // UDP-only dump: nothing on the console but the command's own result.
+    g_console.clear();
+    TEST_ASSERT_TRUE(flight_recorder_command("fr dump udp", 11));
+    run_dump();
+    TEST_ASSERT_TRUE(g_console.find("[FR] B ") == std::string::npos);
+    TEST_ASSERT_TRUE(g_console.find("[FR] BEGIN") == std::string::npos);
+
+    // Commands
+    TEST_ASSERT_FALSE(flight_recorder_command("frx", 3));
+    TEST_ASSERT_FALSE(flight_recorder_command("status", 6));
+    TEST_ASSERT_TRUE(flight_recorder_command("fr", 2));
+    TEST_ASSERT_TRUE(flight_recorder_command("fr bogus", 8));
+    TEST_ASSERT_TRUE(flight_recorder_command("fr freeze \r", 11));
+    TEST_ASSERT_TRUE(s_recorder.freezePending());
+    TEST_ASSERT_TRUE(flight_recorder_command("fr resume", 9));
+    TEST_ASSERT_FALSE(s_recorder.freezePending());
+    flight_recorder_freeze("test");
+    for (uint32_t i = 0; i < FLIGHT_REC_POST_TRIGGER_S; ++i) {
+        flight_recorder_append(make_sample(4000 + i, 0, 0, 0));
+    }
+    TEST_ASSERT_TRUE(s_recorder.frozen());
+    flight_recorder_resume();
+    TEST_ASSERT_FALSE(s_recorder.frozen());
+}
+
+// A dryer's day: three runs (heat-up, hold with sensor noise and heater
+// pulses, cool-down) and idle time in between, one sample per second.
+void test_bench_24h(void) {
+    std::vector<uint8_t> mem(FLIGHT_REC_BYTES);
+    Recorder rec(mem.data(), mem.size());
+
+    std::mt19937 rng(24);
+    std::uniform_int_distribution<int> noise(-2, 2);
+    static constexpr uint32_t kDayS = 24u * 3600u;
+    const int16_t targets[] = {450, 800, 600};
+
+    double chamber = 220.0;
+    double hotspot = 220.0;
+    bool heater = false;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; t < kDayS; ++t) {
+        const uint32_t slot = t / (8u * 3600u); // one 8 h slot per run
+        const uint32_t inSlot = t % (8u * 3600u);
+        const bool running = inSlot < 5u * 3600u;
+        const int16_t target = running ? targets[slot] : 0;
+        uint8_t stage = 0;
+        if (running) {
+            stage = chamber < target - 50 ? 1 : (chamber < target - 10 ? 2 : 3);
+            if (t % 30 == 0) {
+                heater = chamber < target;
+            }
+        } else {
+            heater = false;
+        }
+        hotspot += heater ? 0.9 : -(hotspot - chamber) * 0.02;
+        chamber += (hotspot - chamber) * 0.01 - (chamber - 220.0) * 0.0005;
+
+        FlightSample s{};
+        s.t_s = 600 + t;
+        s.chamber_dC = static_cast<int16_t>(chamber + noise(rng));
+        s.hotspot_dC = static_cast<int16_t>(hotspot + noise(rng));
+        s.target_dC = target;
+        s.flags = static_cast<uint8_t>((heater ? flight_rec::kFlagHeaterReq | flight_rec::kFlagHeaterActual : 0) |
+                                       (running ? flight_rec::kFlagRunning : 0) | flight_rec::kFlagCommAlive);
+        s.stage = stage;
+        s.mode = running ? 1 : 0;
+        rec.append(s);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kDayS;
+
+    const Recorder::Stats st = rec.stats();
+    char msg[220];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] 24 h at 1 Hz: %lu B in %lu blocks, %.2f B/sample (raw struct %u B), %.0f ns/append (incl. plant)",
+             (unsigned long)st.bytesHeld, (unsigned long)st.blocksHeld, static_cast<double>(st.bytesHeld) / st.held,
+             (unsigned)sizeof(FlightSample), ns);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "[BENCH] FLIGHT_REC_BYTES %u KB hold %.1f h of this day's mix",
+             (unsigned)(FLIGHT_REC_BYTES / 1024u), rec.capacityBytes() / (static_cast<double>(st.bytesHeld) / st.held) / 3600.0);
+    TEST_MESSAGE(msg);
+
+    // The whole day is held, nothing overwritten.
+    TEST_ASSERT_EQUAL_UINT32(kDayS, st.held);
+    TEST_ASSERT_EQUAL_UINT32(0u, st.evicted);
+    TEST_ASSERT_TRUE(st.bytesHeld * 2u < rec.capacityBytes());
+    TEST_ASSERT_EQUAL_UINT32(kDayS, static_cast<uint32_t>(decode_all(rec).size()));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_codec);
+    RUN_TEST(test_ring_overwrites_oldest);
+    RUN_TEST(test_freeze_and_resume);
+    RUN_TEST(test_dump_lines);
+    RUN_TEST(test_host_dump_and_commands);
+    RUN_TEST(test_bench_24h);
+    return UNITY_END();
+}
+
+// EOF
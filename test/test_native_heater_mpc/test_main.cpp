@@ -0,0 +1,218 @@
+// ============================================================================
+//  test_native_heater_mpc / test_main.cpp
+//
+//  Native (PC) tests for the heater plant identification and planner
+//  (heater_mpc.h).
+//
+//  - RLS recovers the hotspot / chamber parameters of a plant that follows
+//    the model structure exactly, and the estimator bank picks its dead time
+//  - ready() only after enough samples with heating in them
+//  - a long idle phase (no excitation) does not wind up the estimates
+//  - planner: the chosen pulse keeps the predicted peak at or below the aim,
+//    one step more would not; no pulse with the hotspot at its limit
+//  - benchmark: cost of one model update and one plan
+//
+//  Run:
+//    pio test -e native -f test_native_heater_mpc -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#include "heater_mpc.h"
+
+using namespace heater_mpc;
+
+// Plant with the model structure, per kSampleMs sample.
+struct ModelPlant {
+    HeaterModelParams p;
+    float h;
+    float c;
+    float c0;
+    float duty[kMaxDelay + 1];
+
+    ModelPlant(const HeaterModelParams &params, float ambientC) : p(params), h(ambientC), c(ambientC), c0(ambientC) {
+        for (float &d : duty) {
+            d = 0.0f;
+        }
+    }
+
+    void step(float u) {
+        for (uint8_t i = kMaxDelay; i > 0; --i) {
+            duty[i] = duty[i - 1];
+        }
+        duty[0] = u;
+        const float lead = h - c;
+        h += p.aH * lead + p.bH * duty[p.delay];
+        c += p.aC * lead + p.lC * (c - c0);
+    }
+};
+
+static constexpr HeaterModelParams kPlant = {-0.05f, 2.0f, 0.02f, -0.0008f, 2};
+
+// Bang-bang around a setpoint with some on/off cycles, like a heat-up.
+static float excitation(uint32_t k, float chamberC) {
+    if (chamberC < 60.0f) {
+        return (k % 12u) < 4u ? 1.0f : 0.0f;
+    }
+    return (k % 20u) < 2u ? 0.5f : 0.0f;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_identifies_plant_and_dead_time(void) {
+    ModelPlant plant(kPlant, 22.0f);
+    HeaterModel model;
+    model.reset(plant.h, plant.c);
+
+    bool readyEarly = false;
+    for (uint32_t k = 0; k < 600; ++k) {
+        const float u = excitation(k, plant.c);
+        plant.step(u);
+        model.update(plant.h, plant.c, u);
+        if (k + 1 < kReadyMinSamples) {
+            readyEarly |= model.ready();
+        }
+    }
+    TEST_ASSERT_FALSE(readyEarly);
+    TEST_ASSERT_TRUE(model.ready());
+
+    const HeaterModelParams p = model.params();
+    char msg[160];
+    snprintf(msg, sizeof(msg), "[BENCH] identified aH %.4f bH %.3f aC %.4f lC %.5f delay %u (plant delay %u)", p.aH,
+             p.bH, p.aC, p.lC, (unsigned)p.delay, (unsigned)kPlant.delay);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT8(kPlant.delay, p.delay);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, kPlant.aH, p.aH);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, kPlant.bH, p.bH);
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, kPlant.aC, p.aC);
+    TEST_ASSERT_FLOAT_WITHIN(0.0005f, kPlant.lC, p.lC);
+}
+
+static void test_not_ready_without_heating(void) {
+    HeaterModel model;
+    model.reset(22.0f, 22.0f);
+    for (uint32_t k = 0; k < 200; ++k) {
+        model.update(22.0f, 22.0f, 0.0f);
+    }
+    TEST_ASSERT_FALSE(model.ready());
+}
+
+static void test_idle_phase_does_not_wind_up(void) {
+    ModelPlant plant(kPlant, 22.0f);
+    HeaterModel model;
+    model.reset(plant.h, plant.c);
+    for (uint32_t k = 0; k < 600; ++k) {
+        const float u = excitation(k, plant.c);
+        plant.step(u);
+        model.update(plant.h, plant.c, u);
+    }
+    const HeaterModelParams before = model.params();
+
+    // Two hours without the heater, sensor noise of one quantization step.
+    for (uint32_t k = 0; k < 1440; ++k) {
+        plant.step(0.0f);
+        const float noise = (k % 7u == 3u) ? 0.1f : 0.0f;
+        model.update(plant.h + noise, plant.c, 0.0f);
+    }
+    const HeaterModelParams after = model.params();
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * kPlant.bH, before.bH, after.bH);
+    TEST_ASSERT_TRUE(after.aH < 0.0f);
+    TEST_ASSERT_TRUE(after.aC > 0.0f);
+}
+
+static void test_plan_respects_aim_and_hotspot_limit(void) {
+    ModelPlant plant(kPlant, 22.0f);
+    HeaterModel model;
+    model.reset(plant.h, plant.c);
+    for (uint32_t k = 0; k < 600; ++k) {
+        const float u = excitation(k, plant.c);
+        plant.step(u);
+        model.update(plant.h, plant.c, u);
+    }
+    // Let it cool down a bit below a 70 °C target.
+    while (plant.c > 55.0f) {
+        plant.step(0.0f);
+        model.update(plant.h, plant.c, 0.0f);
+    }
+
+    const HeaterMpcLimits lim = {70.0f, 130.0f};
+    const HeaterMpcPlan plan = HeaterMpc::plan(model, plant.h, plant.c, lim, 300000, 1000);
+    TEST_ASSERT_TRUE(plan.pulseMs > 0);
+    TEST_ASSERT_TRUE(plan.peakC <= lim.aimC);
+    TEST_ASSERT_TRUE(plan.peakInMs > plan.pulseMs);
+    const HeaterMpcPlan longer = HeaterMpc::predict(model, plant.h, plant.c, plan.pulseMs + 1000);
+    TEST_ASSERT_TRUE(longer.peakC > lim.aimC || longer.hotspotPeakC >= lim.hotspotLimitC);
+
+    // Run the plan on the plant: the real peak lands close to the aim.
+    float peakC = plant.c;
+    uint32_t leftMs = plan.pulseMs;
+    for (uint32_t k = 0; k < kHorizonSamples; ++k) {
+        const float u = (leftMs >= kSampleMs) ? 1.0f : static_cast<float>(leftMs) / kSampleMs;
+        leftMs = (leftMs >= kSampleMs) ? leftMs - kSampleMs : 0;
+        plant.step(u);
+        peakC = fmaxf(peakC, plant.c);
+    }
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] plan: pulse %lu ms, predicted peak %.2f C, plant peak %.2f C",
+             (unsigned long)plan.pulseMs, plan.peakC, peakC);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, lim.aimC, peakC);
+
+    // Hotspot already at its limit: no pulse.
+    const HeaterMpcLimits tight = {70.0f, plant.h};
+    TEST_ASSERT_EQUAL_UINT32(0, HeaterMpc::plan(model, plant.h, plant.c, tight, 300000, 1000).pulseMs);
+}
+
+static void test_bench_update_and_plan(void) {
+    ModelPlant plant(kPlant, 22.0f);
+    HeaterModel model;
+    model.reset(plant.h, plant.c);
+
+    static constexpr uint32_t kUpdates = 200000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < kUpdates; ++k) {
+        const float u = excitation(k, plant.c);
+        plant.step(u);
+        if (plant.c > 90.0f) {
+            plant.c = 50.0f;
+        }
+        model.update(plant.h, plant.c, u);
+    }
+    const double updateNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kUpdates;
+
+    static constexpr uint32_t kPlans = 2000;
+    volatile uint32_t sink = 0;
+    const HeaterMpcLimits lim = {80.0f, 130.0f};
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kPlans; ++i) {
+        sink = sink + HeaterMpc::plan(model, 60.0f + (i % 10), 55.0f, lim, 300000, 1000).pulseMs;
+    }
+    const double planUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / kPlans;
+    (void)sink;
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] model update %.0f ns, plan %.1f us", updateNs, planUs);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_identifies_plant_and_dead_time);
+    RUN_TEST(test_not_ready_without_heating);
+    RUN_TEST(test_idle_phase_does_not_wind_up);
+    RUN_TEST(test_plan_respects_aim_and_hotspot_limit);
+    RUN_TEST(test_bench_update_and_plan);
+    return UNITY_END();
+}
+
+// EOF
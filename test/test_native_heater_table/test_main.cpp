@@ -0,0 +1,507 @@
+// ============================================================================
+//  test_native_heater_table / test_main.cpp
+//
+//  Native (PC) tests for the table-driven heater pulse control
+//  (HeaterPulseTable, kHeaterPulseTables in oven.h).
+//
+//  - the default tables reproduce the former per-material heater functions
+//    (kept below as a reference, with their constants) bit for bit: pulse
+//    ladder, soak, reheat gate, force-off, WAIT resume soak / pulse and the
+//    running fan timing, over a dense grid of chamber / hotspot / target
+//  - a table saved through HostParameters is used by the next decision,
+//    an inconsistent table is rejected
+//  - a version 2 parameter blob (no tables) keeps its settings on upgrade
+//    and gets the default tables
+//  - benchmark: cost of one table lookup plus the pulse/force-off decision
+//
+//  Run:
+//    pio test -e native -f test_native_heater_table -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <chrono>
+#include <vector>
+
+// The host logic is compiled into this test for its static helpers.
+#include "../../src/app/flight_recorder.cpp"
+#include "../../src/app/host_parameters.cpp"
+#include "../../src/app/run_history.cpp"
+#include "../../src/app/thermal_cache.cpp"
+#include "../../src/app/oven/oven.cpp"
+
+// -----------------------------------------------------------------------------
+// Reference: heater decisions before the tables (constants and functions as
+// they were in oven.h / oven.cpp)
+// -----------------------------------------------------------------------------
+namespace legacy {
+
+static constexpr uint32_t SILICA_FIRST_PULSE_MAX_MS = 45000;
+static constexpr uint32_t SILICA_BULK_PULSE_MAX_MS = 18000;
+static constexpr uint32_t SILICA_APPROACH_PULSE_MAX_MS = 12000;
+static constexpr uint32_t SILICA_HOLD_PULSE_MAX_MS = 8000;
+static constexpr uint32_t SILICA_FIRST_SOAK_MS = 60000;
+static constexpr uint32_t SILICA_REHEAT_SOAK_MS = 35000;
+static constexpr uint32_t SILICA_SAFETY_SOAK_MS = 120000;
+static constexpr float SILICA_BULK_PULSE_ENABLE_BELOW_TARGET_C = 25.0f;
+static constexpr float SILICA_APPROACH_PULSE_ENABLE_BELOW_TARGET_C = 12.0f;
+static constexpr float SILICA_REHEAT_ENABLE_BELOW_TARGET_C = 4.0f;
+static constexpr float SILICA_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C = 2.0f;
+static constexpr float SILICA_FORCE_OFF_BEFORE_TARGET_C = 1.0f;
+static constexpr uint32_t FILAMENT_FIRST_PULSE_MAX_MS = 12000;
+static constexpr uint32_t FILAMENT_FIRST_PULSE_MAX_WARM_MS = 10000;
+static constexpr uint32_t FILAMENT_FIRST_PULSE_MAX_MID_MS = 11000;
+static constexpr uint32_t FILAMENT_BULK_PULSE_MAX_MS = 10000;
+static constexpr uint32_t FILAMENT_APPROACH_PULSE_MAX_MS = 7000;
+static constexpr uint32_t FILAMENT_HOLD_PULSE_MAX_MS = 4000;
+static constexpr uint32_t FILAMENT_HOLD_PULSE_WARM_MS = 6000;
+static constexpr uint32_t FILAMENT_HOLD_PULSE_MID_MS = 5000;
+static constexpr uint32_t FILAMENT_HOLD_PULSE_HIGH_MS = 6000;
+static constexpr uint32_t FILAMENT_FIRST_SOAK_MS = 45000;
+static constexpr uint32_t FILAMENT_REHEAT_SOAK_MS = 30000;
+static constexpr uint32_t FILAMENT_SAFETY_SOAK_MS = 90000;
+static constexpr float FILAMENT_BULK_PULSE_ENABLE_BELOW_TARGET_C = 20.0f;
+static constexpr float FILAMENT_APPROACH_PULSE_ENABLE_BELOW_TARGET_C = 10.0f;
+static constexpr float FILAMENT_REHEAT_ENABLE_BELOW_TARGET_C = 3.0f;
+static constexpr float FILAMENT_HIGH_REHEAT_ENABLE_BELOW_TARGET_C = 2.0f;
+static constexpr float FILAMENT_FORCE_OFF_BEFORE_TARGET_C = 1.0f;
+static constexpr float FILAMENT_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C = 2.0f;
+static constexpr float FILAMENT_HOTSPOT_REHEAT_BLOCK_ABOVE_TARGET_C = 5.0f;
+static constexpr float FILAMENT_HOTSPOT_FORCE_OFF_ABOVE_TARGET_C = 10.0f;
+static constexpr uint32_t FILAMENT_FAN_MIN_SWITCH_MS = 5000;
+static constexpr uint32_t FILAMENT_FAN_FAST_AFTER_HEAT_MS = 12000;
+static constexpr uint32_t FILAMENT_WAIT_RESUME_SOAK_MS = 12000;
+static constexpr uint32_t FILAMENT_WAIT_RESUME_SOAK_MIN_MS = 5000;
+static constexpr uint32_t FILAMENT_WAIT_RESUME_SOAK_HOT_TARGET_MS = 7000;
+static constexpr uint32_t FILAMENT_WAIT_RESUME_PULSE_SHORT_MS = 6000;
+static constexpr uint32_t FILAMENT_WAIT_RESUME_PULSE_LONG_MS = 8000;
+static constexpr float FILAMENT_WAIT_RESUME_LONG_PULSE_ERROR_C = 8.0f;
+static constexpr float FILAMENT_WAIT_RESUME_MEDIUM_PULSE_ERROR_C = 5.0f;
+static constexpr float FILAMENT_MID_TARGET_C = 70.0f;
+static constexpr float FILAMENT_WAIT_RESUME_HOT_TARGET_C = 80.0f;
+static constexpr uint32_t FILAMENT_WAIT_RESUME_LONG_OPEN_MS = 15000;
+
+static bool silica_should_force_heater_off(float chamberC, float targetC, uint8_t pulseCount) {
+    const bool firstPulseActive = (pulseCount <= 1u);
+    const float forceOffBeforeTargetC =
+        firstPulseActive ? SILICA_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C : SILICA_FORCE_OFF_BEFORE_TARGET_C;
+    return chamberC >= (targetC - forceOffBeforeTargetC);
+}
+
+static bool filament_should_force_heater_off(HeaterControlStage stage, float chamberC, float hotspotC,
+                                             float targetC, uint8_t pulseCount) {
+    if (hotspotC >= (targetC + FILAMENT_HOTSPOT_FORCE_OFF_ABOVE_TARGET_C)) {
+        return true;
+    }
+    const bool firstPulseActive = (pulseCount <= 1u);
+    const float directForceOffBeforeTargetC =
+        firstPulseActive ? FILAMENT_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C : FILAMENT_FORCE_OFF_BEFORE_TARGET_C;
+    if (chamberC >= (targetC - directForceOffBeforeTargetC)) {
+        return true;
+    }
+    const float hotspotLeadC = max(0.0f, hotspotC - chamberC);
+    const float predictedChamberC = chamberC + (hotspotLeadC * 1.5f);
+    const float predictiveForceOffBeforeTargetC =
+        firstPulseActive ? FILAMENT_FIRST_PULSE_FORCE_OFF_BEFORE_TARGET_C : 0.5f;
+    if (predictedChamberC >= (targetC - predictiveForceOffBeforeTargetC)) {
+        return true;
+    }
+    if (stage == HeaterControlStage::HOLD && hotspotC >= targetC) {
+        return true;
+    }
+    return false;
+}
+
+static bool is_high_temp_filament_profile(HeaterCurveProfileId profileId) {
+    return profileId == HeaterCurveProfileId::HIGH_80C;
+}
+
+static float filament_reheat_enable_below_target_c(HeaterCurveProfileId profileId) {
+    return is_high_temp_filament_profile(profileId) ? FILAMENT_HIGH_REHEAT_ENABLE_BELOW_TARGET_C
+                                                    : FILAMENT_REHEAT_ENABLE_BELOW_TARGET_C;
+}
+
+static uint32_t filament_hold_pulse_duration_ms(float targetC, HeaterCurveProfileId profileId) {
+    if (targetC >= FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
+        return is_high_temp_filament_profile(profileId) ? FILAMENT_HOLD_PULSE_HIGH_MS : FILAMENT_HOLD_PULSE_MAX_MS;
+    }
+    if (targetC >= FILAMENT_MID_TARGET_C) {
+        return FILAMENT_HOLD_PULSE_MID_MS;
+    }
+    return FILAMENT_HOLD_PULSE_WARM_MS;
+}
+
+static uint32_t filament_pulse_duration_ms(float chamberC, float targetC, uint8_t pulseCount,
+                                           HeaterCurveProfileId profileId) {
+    if (pulseCount == 0) {
+        if (targetC >= FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
+            return FILAMENT_FIRST_PULSE_MAX_MS;
+        }
+        if (targetC >= FILAMENT_MID_TARGET_C) {
+            return FILAMENT_FIRST_PULSE_MAX_MID_MS;
+        }
+        return FILAMENT_FIRST_PULSE_MAX_WARM_MS;
+    }
+    const float errorToTargetC = targetC - chamberC;
+    if (errorToTargetC > FILAMENT_BULK_PULSE_ENABLE_BELOW_TARGET_C) {
+        return FILAMENT_BULK_PULSE_MAX_MS;
+    }
+    if (errorToTargetC > FILAMENT_APPROACH_PULSE_ENABLE_BELOW_TARGET_C) {
+        return FILAMENT_APPROACH_PULSE_MAX_MS;
+    }
+    if (errorToTargetC > filament_reheat_enable_below_target_c(profileId)) {
+        return filament_hold_pulse_duration_ms(targetC, profileId);
+    }
+    return 0;
+}
+
+static uint32_t filament_soak_duration_ms(uint8_t pulseCount) {
+    return (pulseCount <= 1u) ? FILAMENT_FIRST_SOAK_MS : FILAMENT_REHEAT_SOAK_MS;
+}
+
+static uint32_t silica_pulse_duration_ms(float chamberC, float targetC, uint8_t pulseCount) {
+    const float errorToTargetC = targetC - chamberC;
+    if (pulseCount == 0) {
+        return SILICA_FIRST_PULSE_MAX_MS;
+    }
+    if (errorToTargetC > SILICA_BULK_PULSE_ENABLE_BELOW_TARGET_C) {
+        return SILICA_BULK_PULSE_MAX_MS;
+    }
+    if (errorToTargetC > SILICA_APPROACH_PULSE_ENABLE_BELOW_TARGET_C) {
+        return SILICA_APPROACH_PULSE_MAX_MS;
+    }
+    if (errorToTargetC > SILICA_REHEAT_ENABLE_BELOW_TARGET_C) {
+        return SILICA_HOLD_PULSE_MAX_MS;
+    }
+    return 0;
+}
+
+static uint32_t silica_soak_duration_ms(uint8_t pulseCount) {
+    return (pulseCount <= 1u) ? SILICA_FIRST_SOAK_MS : SILICA_REHEAT_SOAK_MS;
+}
+
+static bool silica_reheat_allowed(float chamberC, float targetC) {
+    return chamberC < (targetC - SILICA_REHEAT_ENABLE_BELOW_TARGET_C);
+}
+
+static bool filament_reheat_allowed(float chamberC, float hotspotC, float targetC, HeaterCurveProfileId profileId) {
+    if (chamberC >= (targetC - filament_reheat_enable_below_target_c(profileId))) {
+        return false;
+    }
+    if (hotspotC >= (targetC + FILAMENT_HOTSPOT_REHEAT_BLOCK_ABOVE_TARGET_C)) {
+        return false;
+    }
+    return true;
+}
+
+static uint32_t filament_resume_soak_ms(float chamberC, float targetC, uint32_t waitOpenMs) {
+    uint32_t soakMs = FILAMENT_WAIT_RESUME_SOAK_MS;
+    if (targetC >= FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
+        soakMs = FILAMENT_WAIT_RESUME_SOAK_HOT_TARGET_MS;
+    }
+    const float errorToTargetC = max(0.0f, targetC - chamberC);
+    if (errorToTargetC >= FILAMENT_WAIT_RESUME_LONG_PULSE_ERROR_C) {
+        soakMs = min(soakMs, static_cast<uint32_t>(7000));
+    } else if (errorToTargetC >= FILAMENT_WAIT_RESUME_MEDIUM_PULSE_ERROR_C) {
+        soakMs = min(soakMs, static_cast<uint32_t>(9000));
+    }
+    if (waitOpenMs >= FILAMENT_WAIT_RESUME_LONG_OPEN_MS) {
+        soakMs = max(FILAMENT_WAIT_RESUME_SOAK_MIN_MS, soakMs - 2000u);
+    }
+    return max(FILAMENT_WAIT_RESUME_SOAK_MIN_MS, soakMs);
+}
+
+static uint32_t filament_resume_pulse_ms(float chamberC, float targetC) {
+    const float errorToTargetC = max(0.0f, targetC - chamberC);
+    uint32_t pulseMs = FILAMENT_WAIT_RESUME_PULSE_SHORT_MS;
+    if (errorToTargetC >= FILAMENT_WAIT_RESUME_LONG_PULSE_ERROR_C) {
+        pulseMs = FILAMENT_WAIT_RESUME_PULSE_LONG_MS;
+    } else if (errorToTargetC >= FILAMENT_WAIT_RESUME_MEDIUM_PULSE_ERROR_C) {
+        pulseMs = (FILAMENT_WAIT_RESUME_PULSE_SHORT_MS + FILAMENT_WAIT_RESUME_PULSE_LONG_MS) / 2u;
+    }
+    if (targetC >= FILAMENT_WAIT_RESUME_HOT_TARGET_C) {
+        const uint32_t minPulseMs = FILAMENT_WAIT_RESUME_PULSE_SHORT_MS - 1000u;
+        pulseMs = (pulseMs > 1000u) ? (pulseMs - 1000u) : minPulseMs;
+        if (pulseMs < minPulseMs) {
+            pulseMs = minPulseMs;
+        }
+    }
+    return pulseMs;
+}
+
+} // namespace legacy
+
+// -----------------------------------------------------------------------------
+// Grid
+// -----------------------------------------------------------------------------
+
+static constexpr HeaterCurveProfileId kFilamentProfiles[] = {
+    HeaterCurveProfileId::LOW_45C, HeaterCurveProfileId::MID_60C, HeaterCurveProfileId::HIGH_80C};
+
+static constexpr HeaterControlStage kStages[] = {HeaterControlStage::IDLE, HeaterControlStage::BULK_HEAT,
+                                                 HeaterControlStage::APPROACH, HeaterControlStage::HOLD};
+
+static constexpr uint8_t kPulseCounts[] = {0, 1, 2, 7};
+
+// Every whole-degree target the parameter screen allows, plus the preset
+// dry temperatures (half degrees) for a CUSTOM-style runtime target.
+static std::vector<float> grid_targets() {
+    std::vector<float> out;
+    for (int t = 30; t <= 120; ++t) {
+        out.push_back(static_cast<float>(t));
+    }
+    for (uint16_t i = 0; i < kPresetCount; ++i) {
+        out.push_back(kPresets[i].dryTempC);
+    }
+    return out;
+}
+
+// Temperatures as they arrive in STATUS (deci-°C).
+static float grid_c(int dC) { return dC / 10.0f; }
+
+static uint32_t g_checks = 0;
+static uint32_t g_mismatches = 0;
+static char g_firstMismatch[160];
+
+static void expect_same(uint32_t legacyValue, uint32_t tableValue, const char *what, float chamberC,
+                        float targetC) {
+    g_checks++;
+    if (legacyValue != tableValue) {
+        if (g_mismatches++ == 0) {
+            snprintf(g_firstMismatch, sizeof(g_firstMismatch), "%s: chamber %.2f target %.2f legacy %lu table %lu",
+                     what, chamberC, targetC, (unsigned long)legacyValue, (unsigned long)tableValue);
+        }
+    }
+}
+
+static void report_mismatches(const char *name) {
+    char msg[200];
+    snprintf(msg, sizeof(msg), "[BENCH] %s: %lu decisions compared", name, (unsigned long)g_checks);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, g_mismatches, g_firstMismatch);
+}
+
+void setUp(void) {
+    preferences_native::clear_all();
+    host_parameters_init();
+    g_checks = 0;
+    g_mismatches = 0;
+    g_firstMismatch[0] = '\0';
+}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+static void test_default_rules_match_material_classes(void) {
+    for (HeaterCurveProfileId id : kFilamentProfiles) {
+        const HeaterPulseTable &t = heater_table_for_profile(id);
+        TEST_ASSERT_EQUAL_UINT8(HEATER_RULE_ALL & ~HEATER_RULE_MPC, t.rules);
+        TEST_ASSERT_EQUAL_UINT32(legacy::FILAMENT_REHEAT_SOAK_MS, t.reheatSoakMs);
+        TEST_ASSERT_EQUAL_UINT32(legacy::FILAMENT_SAFETY_SOAK_MS, t.safetySoakMs);
+        TEST_ASSERT_EQUAL_UINT32(legacy::FILAMENT_FAN_MIN_SWITCH_MS, t.fanMinSwitchMs);
+        TEST_ASSERT_EQUAL_UINT32(legacy::FILAMENT_FAN_FAST_AFTER_HEAT_MS, t.fanFastAfterHeatMs);
+    }
+    const HeaterPulseTable &s = heater_table_for_profile(HeaterCurveProfileId::SILICA_100C);
+    TEST_ASSERT_EQUAL_UINT8(HEATER_RULE_PULSE_GATE, s.rules);
+    TEST_ASSERT_EQUAL_UINT32(legacy::SILICA_REHEAT_SOAK_MS, s.reheatSoakMs);
+    TEST_ASSERT_EQUAL_UINT32(legacy::SILICA_SAFETY_SOAK_MS, s.safetySoakMs);
+
+    // Every preset runs with the rules of its material class.
+    for (uint16_t i = 0; i < kPresetCount; ++i) {
+        const HeaterPulseTable &t = heater_table_for_profile(kPresets[i].heaterCurveProfile);
+        const bool filament = (kPresets[i].materialClass == HeaterMaterialClass::FILAMENT);
+        TEST_ASSERT_EQUAL(filament, heater_table_has(t, HEATER_RULE_RUNNING_FANS));
+        TEST_ASSERT_EQUAL(filament, heater_table_has(t, HEATER_RULE_WAIT_RESUME));
+        TEST_ASSERT_TRUE(heater_table_has(t, HEATER_RULE_PULSE_GATE));
+    }
+}
+
+static void test_pulse_soak_and_reheat_match_legacy(void) {
+    const std::vector<float> targets = grid_targets();
+    for (float targetC : targets) {
+        for (int dC = 100; dC <= 1300; ++dC) {
+            const float chamberC = grid_c(dC);
+            for (uint8_t pulseCount : kPulseCounts) {
+                for (HeaterCurveProfileId id : kFilamentProfiles) {
+                    const HeaterPulseTable &t = heater_table_for_profile(id);
+                    expect_same(legacy::filament_pulse_duration_ms(chamberC, targetC, pulseCount, id),
+                                heater_pulse_duration_ms(t, chamberC, targetC, pulseCount), "filament pulse",
+                                chamberC, targetC);
+                    expect_same(legacy::filament_soak_duration_ms(pulseCount), heater_soak_duration_ms(t, pulseCount),
+                                "filament soak", chamberC, targetC);
+                }
+                const HeaterPulseTable &s = heater_table_for_profile(HeaterCurveProfileId::SILICA_100C);
+                expect_same(legacy::silica_pulse_duration_ms(chamberC, targetC, pulseCount),
+                            heater_pulse_duration_ms(s, chamberC, targetC, pulseCount), "silica pulse", chamberC,
+                            targetC);
+                expect_same(legacy::silica_soak_duration_ms(pulseCount), heater_soak_duration_ms(s, pulseCount),
+                            "silica soak", chamberC, targetC);
+            }
+
+            for (int hotOffset_dC = -50; hotOffset_dC <= 300; hotOffset_dC += 5) {
+                const float hotspotC = grid_c(dC + hotOffset_dC);
+                for (HeaterCurveProfileId id : kFilamentProfiles) {
+                    expect_same(legacy::filament_reheat_allowed(chamberC, hotspotC, targetC, id),
+                                heater_reheat_allowed(heater_table_for_profile(id), chamberC, hotspotC, targetC),
+                                "filament reheat", chamberC, targetC);
+                }
+                expect_same(legacy::silica_reheat_allowed(chamberC, targetC),
+                            heater_reheat_allowed(heater_table_for_profile(HeaterCurveProfileId::SILICA_100C),
+                                                  chamberC, hotspotC, targetC),
+                            "silica reheat", chamberC, targetC);
+            }
+        }
+    }
+    report_mismatches("pulse/soak/reheat");
+}
+
+static void test_force_off_matches_legacy(void) {
+    const std::vector<float> targets = grid_targets();
+    const HeaterPulseTable &s = heater_table_for_profile(HeaterCurveProfileId::SILICA_100C);
+    for (float targetC : targets) {
+        for (int dC = 100; dC <= 1300; dC += 3) {
+            const float chamberC = grid_c(dC);
+            for (int hotOffset_dC = -50; hotOffset_dC <= 300; hotOffset_dC += 5) {
+                const float hotspotC = grid_c(dC + hotOffset_dC);
+                for (uint8_t pulseCount : kPulseCounts) {
+                    for (HeaterControlStage stage : kStages) {
+                        const bool legacyOff =
+                            legacy::filament_should_force_heater_off(stage, chamberC, hotspotC, targetC, pulseCount);
+                        for (HeaterCurveProfileId id : kFilamentProfiles) {
+                            expect_same(legacyOff,
+                                        heater_should_force_off(heater_table_for_profile(id), stage, chamberC, hotspotC,
+                                                                targetC, pulseCount),
+                                        "filament force-off", chamberC, targetC);
+                        }
+                        expect_same(legacy::silica_should_force_heater_off(chamberC, targetC, pulseCount),
+                                    heater_should_force_off(s, stage, chamberC, hotspotC, targetC, pulseCount),
+                                    "silica force-off", chamberC, targetC);
+                    }
+                }
+            }
+        }
+    }
+    report_mismatches("force-off");
+}
+
+static void test_wait_resume_matches_legacy(void) {
+    static constexpr uint32_t kWaitOpenMs[] = {0, 5000, 14999, 15000, 60000, 600000};
+    const std::vector<float> targets = grid_targets();
+    for (float targetC : targets) {
+        for (int dC = 100; dC <= 1300; ++dC) {
+            const float chamberC = grid_c(dC);
+            for (HeaterCurveProfileId id : kFilamentProfiles) {
+                const HeaterPulseTable &t = heater_table_for_profile(id);
+                expect_same(legacy::filament_resume_pulse_ms(chamberC, targetC),
+                            heater_resume_pulse_ms(t, chamberC, targetC), "resume pulse", chamberC, targetC);
+                for (uint32_t waitOpenMs : kWaitOpenMs) {
+                    expect_same(legacy::filament_resume_soak_ms(chamberC, targetC, waitOpenMs),
+                                heater_resume_soak_ms(t, chamberC, targetC, waitOpenMs), "resume soak", chamberC,
+                                targetC);
+                }
+            }
+        }
+    }
+    report_mismatches("WAIT resume");
+}
+
+static void test_saved_table_overrides_defaults(void) {
+    HostParameters params{};
+    host_parameters_get(&params);
+
+    HeaterPulseTable &low = params.heaterTables[static_cast<uint8_t>(HeaterCurveProfileId::LOW_45C)];
+    low.bulkPulseMs = 15000;
+    low.rules = static_cast<uint8_t>(low.rules & ~HEATER_RULE_RUNNING_FANS);
+    TEST_ASSERT_TRUE(host_parameters_save(&params));
+
+    const HeaterPulseTable &t = heater_table_for_profile(HeaterCurveProfileId::LOW_45C);
+    TEST_ASSERT_EQUAL_UINT32(15000, heater_pulse_duration_ms(t, 20.0f, 45.0f, 3));
+    TEST_ASSERT_FALSE(heater_table_has(t, HEATER_RULE_RUNNING_FANS));
+    // Other profiles keep their defaults.
+    TEST_ASSERT_EQUAL_UINT32(
+        10000, heater_pulse_duration_ms(heater_table_for_profile(HeaterCurveProfileId::MID_60C), 30.0f, 60.0f, 3));
+
+    // Survives a restart (cache reloaded from NVS).
+    host_parameters_init();
+    TEST_ASSERT_EQUAL_UINT32(15000, heater_table_for_profile(HeaterCurveProfileId::LOW_45C).bulkPulseMs);
+
+    // A ladder that does not step down towards the target is rejected.
+    HostParameters bad = params;
+    bad.heaterTables[0].reheatAbove_dC = bad.heaterTables[0].approachAbove_dC;
+    TEST_ASSERT_FALSE(host_parameters_save(&bad));
+    bad = params;
+    bad.heaterTables[3].holdPulseMs[HEATER_TIER_HOT] = 0;
+    TEST_ASSERT_FALSE(host_parameters_save(&bad));
+    bad = params;
+    bad.heaterTables[1].rules = 0x80;
+    TEST_ASSERT_FALSE(host_parameters_save(&bad));
+    TEST_ASSERT_EQUAL_UINT32(15000, heater_table_for_profile(HeaterCurveProfileId::LOW_45C).bulkPulseMs);
+}
+
+static void test_v2_blob_upgrade_keeps_settings(void) {
+    HostParametersBlobV2 old{};
+    old.version = kVersionV2;
+    const uint16_t shortcuts[HOST_PARAMETER_SHORTCUT_SLOT_COUNT] = {1, 2, 3, 4};
+    std::memcpy(old.params.shortcutPresetIds, shortcuts, sizeof(shortcuts));
+    for (uint8_t i = 0; i < HOST_PARAMETER_HEATER_PROFILE_COUNT; ++i) {
+        old.params.heaterProfiles[i] = {static_cast<int16_t>(50 + i), 20, 90, 30, 25};
+    }
+    old.params.displayDimPercent = 55;
+    old.params.displayDimTimeoutMin = 7;
+
+    Preferences prefs;
+    TEST_ASSERT_TRUE(prefs.begin(kNvsNamespace, false));
+    TEST_ASSERT_EQUAL(sizeof(old), prefs.putBytes(kBlobKey, &old, sizeof(old)));
+    prefs.end();
+
+    host_parameters_init();
+    const HostParameters *p = host_parameters_get_cached();
+    TEST_ASSERT_EQUAL_UINT16(3, p->shortcutPresetIds[2]);
+    TEST_ASSERT_EQUAL_INT16(52, p->heaterProfiles[2].targetC);
+    TEST_ASSERT_EQUAL_INT16(90, p->heaterProfiles[2].approachBand_dC);
+    TEST_ASSERT_EQUAL_UINT8(55, p->displayDimPercent);
+    TEST_ASSERT_EQUAL_UINT8(7, p->displayDimTimeoutMin);
+    for (uint8_t i = 0; i < HOST_PARAMETER_HEATER_PROFILE_COUNT; ++i) {
+        TEST_ASSERT_EQUAL_MEMORY(&kHeaterPulseTables[i], &p->heaterTables[i], sizeof(HeaterPulseTable));
+    }
+}
+
+static void test_bench_lookup_and_decide(void) {
+    static constexpr uint32_t kIters = 2000000;
+    volatile uint32_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kIters; ++i) {
+        const HeaterCurveProfileId id = static_cast<HeaterCurveProfileId>(i & 3u);
+        const HeaterPulseTable &t = heater_table_for_profile(id);
+        const float chamberC = 20.0f + static_cast<float>(i % 800) * 0.1f;
+        sink = sink + heater_pulse_duration_ms(t, chamberC, 60.0f, static_cast<uint8_t>(i & 7u));
+        sink = sink + heater_should_force_off(t, HeaterControlStage::APPROACH, chamberC, chamberC + 4.0f, 60.0f,
+                                              static_cast<uint8_t>(i & 7u));
+    }
+    const double ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kIters;
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] table lookup + pulse + force-off: %.1f ns per tick", ns);
+    TEST_MESSAGE(msg);
+    (void)sink;
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_default_rules_match_material_classes);
+    RUN_TEST(test_pulse_soak_and_reheat_match_legacy);
+    RUN_TEST(test_force_off_matches_legacy);
+    RUN_TEST(test_wait_resume_matches_legacy);
+    RUN_TEST(test_saved_table_overrides_defaults);
+    RUN_TEST(test_v2_blob_upgrade_keeps_settings);
+    RUN_TEST(test_bench_lookup_and_decide);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,347 @@
+// ============================================================================
+//  test_native_line_assembler / test_main.cpp
+//
+//  Native (PC) tests for the shared RX line assembler (line_assembler.h).
+//
+//  - complete lines are handed out as views into the RX block (no copy),
+//    split lines are reassembled and counted as fragmented
+//  - CR stripping, empty lines, overlong lines dropped up to their '\n'
+//  - binary frames interleaved with ASCII lines (feedLink)
+//  - the host hardware test cases Test_LineFragmentationBurst and
+//    Test_MalformedFrames (src/test/host) against HostComm + ClientComm
+//  - benchmark: random fragmentation patterns, LineAssembler vs. the former
+//    per-byte String assembler
+//
+//  Run:
+//    pio test -e native -f test_native_line_assembler -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "line_assembler.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+
+// The hardware test cases run unchanged on the native HostComm.
+#include "../../src/test/host/test_cases/Test_LineFragmentationBurst.cpp"
+#include "../../src/test/host/test_cases/Test_MalformedFrames.cpp"
+
+static uint32_t g_rng = 777;
+static uint32_t rng() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+struct Collected {
+    std::vector<std::string> lines;
+    std::vector<const char *> ptrs;
+    uint32_t overflows = 0;
+};
+
+static void feed(LineAssembler &la, Collected &out, const char *s, size_t n) {
+    la.feed(
+        s, n,
+        [&](const char *line, size_t len) {
+            out.lines.emplace_back(line, len);
+            out.ptrs.push_back(line);
+        },
+        [&]() { out.overflows++; });
+}
+
+static void feed(LineAssembler &la, Collected &out, const char *s) { feed(la, out, s, strlen(s)); }
+
+void setUp(void) {
+    arduino_native::set_ms(1000);
+    Serial1.clearTx();
+    Serial2.clearTx();
+}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// LineAssembler
+// -----------------------------------------------------------------------------
+
+void test_whole_lines_are_views() {
+    LineAssembler la;
+    Collected out;
+    const char block[] = "C;PONG\r\nC;ACK;SET;0001\r\n";
+    feed(la, out, block);
+
+    TEST_ASSERT_EQUAL_size_t(2, out.lines.size());
+    TEST_ASSERT_EQUAL_STRING("C;PONG", out.lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("C;ACK;SET;0001", out.lines[1].c_str());
+    TEST_ASSERT_TRUE(out.ptrs[0] == block);
+    TEST_ASSERT_TRUE(out.ptrs[1] == block + 8);
+    TEST_ASSERT_EQUAL_UINT32(0, la.copiedBytes());
+    TEST_ASSERT_EQUAL_UINT32(0, la.fragmentedCount());
+    TEST_ASSERT_EQUAL_UINT32(2, la.lineCount());
+}
+
+void test_fragmented_lines() {
+    LineAssembler la;
+    Collected out;
+    feed(la, out, "C;STA");
+    feed(la, out, "TUS;00A5;1;2;3;4;5;6");
+    TEST_ASSERT_EQUAL_size_t(0, out.lines.size());
+    TEST_ASSERT_EQUAL_size_t(25, la.pendingLen());
+    feed(la, out, "\r");
+    feed(la, out, "\nC;PO");
+    feed(la, out, "NG\r\n\r\n\n");
+
+    TEST_ASSERT_EQUAL_size_t(2, out.lines.size());
+    TEST_ASSERT_EQUAL_STRING("C;STATUS;00A5;1;2;3;4;5;6", out.lines[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("C;PONG", out.lines[1].c_str());
+    TEST_ASSERT_EQUAL_UINT32(2, la.fragmentedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, la.overflowCount());
+    TEST_ASSERT_EQUAL_size_t(0, la.pendingLen());
+}
+
+void test_overflow_drops_until_newline() {
+    LineAssembler la;
+    Collected out;
+
+    // Overlong line in one block, then split over several blocks.
+    const std::string longLine(LineAssembler::kMaxLineLen + 1, 'A');
+    feed(la, out, (longLine + "\r\nC;PONG\r\n").c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, out.overflows);
+    TEST_ASSERT_EQUAL_size_t(1, out.lines.size());
+
+    for (int i = 0; i < 10; ++i) {
+        feed(la, out, std::string(50, 'B').c_str());
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, out.overflows); // reported once per line
+    feed(la, out, "BBB\r\nC;RST\r\n");
+    TEST_ASSERT_EQUAL_size_t(2, out.lines.size());
+    TEST_ASSERT_EQUAL_STRING("C;RST", out.lines[1].c_str());
+
+    // Exactly kMaxLineLen characters (+ CR) still fit, split or not.
+    const std::string maxLine(LineAssembler::kMaxLineLen, 'C');
+    feed(la, out, (maxLine + "\r\n").c_str());
+    feed(la, out, maxLine.substr(0, 60).c_str());
+    feed(la, out, (maxLine.substr(60) + "\r").c_str());
+    feed(la, out, "\n");
+    TEST_ASSERT_EQUAL_size_t(4, out.lines.size());
+    TEST_ASSERT_EQUAL_size_t(LineAssembler::kMaxLineLen, out.lines[2].size());
+    TEST_ASSERT_EQUAL_size_t(LineAssembler::kMaxLineLen, out.lines[3].size());
+    TEST_ASSERT_EQUAL_UINT32(2, la.overflowCount());
+}
+
+void test_feed_link_separates_binary() {
+    ProtocolMessage msg = {};
+    msg.type = ProtocolMessageType::ClientAckSet;
+    msg.mask = 0x1234;
+    uint8_t bin[ProtocolBinCodec::kMaxFrameLen];
+    const size_t binLen = ProtocolBinCodec::encode(msg, bin, sizeof(bin));
+
+    std::string stream = "C;PO";
+    stream.append(reinterpret_cast<const char *>(bin), binLen); // frame inside a line
+    stream += "NG\r\n";
+    stream.append(reinterpret_cast<const char *>(bin), binLen);
+    stream += "C;RST\r\n";
+
+    // Same result for every split position.
+    for (size_t split = 0; split <= stream.size(); ++split) {
+        LineAssembler la;
+        ProtocolBinRx binRx;
+        std::vector<std::string> lines;
+        uint32_t frames = 0;
+        auto run = [&](size_t from, size_t to) {
+            la.feedLink(
+                binRx, reinterpret_cast<const uint8_t *>(stream.data()) + from, to - from,
+                [&](const char *line, size_t len) { lines.emplace_back(line, len); },
+                []() { TEST_FAIL_MESSAGE("unexpected overflow"); },
+                [&](ProtocolBinRx::Result r) {
+                    TEST_ASSERT_TRUE(r == ProtocolBinRx::Result::Frame);
+                    ProtocolMessage out;
+                    TEST_ASSERT_TRUE(ProtocolBinCodec::decode(binRx.block(), binRx.blockLen(), out));
+                    TEST_ASSERT_EQUAL_HEX16(0x1234, out.mask);
+                    frames++;
+                });
+        };
+        run(0, split);
+        run(split, stream.size());
+
+        TEST_ASSERT_EQUAL_UINT32(2, frames);
+        TEST_ASSERT_EQUAL_size_t(2, lines.size());
+        TEST_ASSERT_EQUAL_STRING("C;PONG", lines[0].c_str());
+        TEST_ASSERT_EQUAL_STRING("C;RST", lines[1].c_str());
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Host hardware test cases (src/test/host/test_cases)
+// -----------------------------------------------------------------------------
+
+static TestVerdict run_case(ITestCase *tc, HostComm &host, ClientComm &client) {
+    tc->enter(host, millis());
+    for (int i = 0; i < 5000 && tc->verdict() == TestVerdict::Running; ++i) {
+        host.loop();
+        Serial2.inject(Serial1.takeTx().c_str());
+        client.loop();
+        Serial1.inject(Serial2.takeTx().c_str());
+        arduino_native::advance_ms(1);
+        tc->tick(host, millis());
+    }
+    tc->exit(host, millis());
+    if (tc->verdict() != TestVerdict::Pass) {
+        TEST_MESSAGE(tc->detail());
+    }
+    return tc->verdict();
+}
+
+void test_host_cases_fragmentation_and_malformed() {
+    HostComm host(Serial1);
+    host.begin(115200, 0, 0);
+    ClientComm client(Serial2, 16, 17);
+    client.begin(115200);
+
+    TEST_ASSERT_TRUE(run_case(get_test_line_fragmentation_burst(), host, client) == TestVerdict::Pass);
+    TEST_ASSERT_EQUAL_UINT32(3, host.rxLines().fragmentedCount()); // byte-wise PONG, split STATUS, junk byte + PONG
+    TEST_ASSERT_TRUE(run_case(get_test_malformed_frames(), host, client) == TestVerdict::Pass);
+    TEST_ASSERT_EQUAL_UINT32(0, host.rxLines().overflowCount());
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark: random fragmentation
+// -----------------------------------------------------------------------------
+
+// The former HostComm/ClientComm assembler: String += c, copy per line.
+struct LegacyAssembler {
+    String rx;
+    template <typename OnLine>
+    void feed(const char *data, size_t len, OnLine &&onLine) {
+        for (size_t i = 0; i < len; ++i) {
+            const char c = data[i];
+            if (c == '\r') {
+                continue;
+            }
+            if (c == '\n') {
+                String line = rx;
+                rx = "";
+                onLine(line.c_str(), line.length());
+                continue;
+            }
+            rx += c;
+            if (rx.length() > 120) {
+                rx = "";
+            }
+        }
+    }
+};
+
+void test_bench_random_fragmentation() {
+    using clock = std::chrono::steady_clock;
+
+    // Typical host RX traffic: STATUS, ACKs, PONGs.
+    std::string stream;
+    for (int i = 0; i < 2000; ++i) {
+        ProtocolStatus st = {};
+        st.outputsMask = static_cast<uint16_t>(i);
+        st.adcRaw[0] = static_cast<int16_t>(i);
+        st.tempChamber_dC = 612;
+        char buf[ProtocolCodec::kMaxFrameLen];
+        stream.append(buf, ProtocolCodec::buildClientStatus(buf, sizeof(buf), st));
+        stream.append(buf, ProtocolCodec::buildClientAckSet(buf, sizeof(buf), static_cast<uint16_t>(i), 7));
+        stream.append(buf, ProtocolCodec::buildClientPong(buf, sizeof(buf)));
+    }
+
+    struct Pattern {
+        const char *name;
+        size_t minChunk;
+        size_t maxChunk;
+    };
+    const Pattern patterns[] = {
+        {"1 byte", 1, 1},
+        {"1..16", 1, 16},
+        {"1..128", 1, 128},
+        {"whole 128", 128, 128},
+    };
+
+    for (const Pattern &p : patterns) {
+        std::vector<size_t> cuts;
+        for (size_t pos = 0; pos < stream.size();) {
+            const size_t n = p.minChunk + rng() % (p.maxChunk - p.minChunk + 1);
+            pos = std::min(pos + n, stream.size());
+            cuts.push_back(pos);
+        }
+
+        constexpr int kRounds = 20;
+        uint64_t newSum = 0;
+        uint64_t oldSum = 0;
+        uint32_t newLines = 0;
+        uint32_t oldLines = 0;
+
+        uint32_t allocs0 = arduino_native::string_heap_allocs();
+        auto t0 = clock::now();
+        for (int r = 0; r < kRounds; ++r) {
+            LegacyAssembler legacy;
+            size_t from = 0;
+            for (size_t to : cuts) {
+                legacy.feed(stream.data() + from, to - from, [&](const char *line, size_t len) {
+                    oldSum += static_cast<uint8_t>(line[len - 1]) + len;
+                    oldLines++;
+                });
+                from = to;
+            }
+        }
+        const double oldSec = std::chrono::duration<double>(clock::now() - t0).count();
+        const uint32_t oldAllocs = arduino_native::string_heap_allocs() - allocs0;
+
+        LineAssembler la;
+        allocs0 = arduino_native::string_heap_allocs();
+        t0 = clock::now();
+        for (int r = 0; r < kRounds; ++r) {
+            la.reset();
+            size_t from = 0;
+            for (size_t to : cuts) {
+                la.feed(
+                    stream.data() + from, to - from,
+                    [&](const char *line, size_t len) {
+                        newSum += static_cast<uint8_t>(line[len - 1]) + len;
+                        newLines++;
+                    },
+                    []() {});
+                from = to;
+            }
+        }
+        const double newSec = std::chrono::duration<double>(clock::now() - t0).count();
+        const uint32_t newAllocs = arduino_native::string_heap_allocs() - allocs0;
+
+        TEST_ASSERT_EQUAL_UINT32(oldLines, newLines);
+        TEST_ASSERT_TRUE(oldSum == newSum);
+        TEST_ASSERT_EQUAL_UINT32(0, newAllocs);
+
+        const double mb = double(stream.size()) * kRounds / 1e6;
+        char msg[200];
+        snprintf(msg, sizeof(msg),
+                 "[BENCH] chunks %-9s: String %7.1f MB/s (%lu allocs), LineAssembler %7.1f MB/s (x%.1f), "
+                 "copied %.0f%% of bytes, %lu fragmented lines",
+                 p.name, mb / oldSec, (unsigned long)oldAllocs, mb / newSec, oldSec / newSec,
+                 100.0 * la.copiedBytes() / (double(stream.size()) * kRounds),
+                 (unsigned long)la.fragmentedCount());
+        TEST_MESSAGE(msg);
+    }
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_whole_lines_are_views);
+    RUN_TEST(test_fragmented_lines);
+    RUN_TEST(test_overflow_drops_until_newline);
+    RUN_TEST(test_feed_link_separates_binary);
+    RUN_TEST(test_host_cases_fragmentation_and_malformed);
+    RUN_TEST(test_bench_random_fragmentation);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,424 @@
+// ============================================================================
+//  test_native_link_sim / test_main.cpp
+//
+//  Host/client link on the PC: the real HostComm and the real ClientComm
+//  connected through LinkSim (test/native_support/link_sim.h), an in-memory
+//  UART model with bit rate, latency, jitter, corruption and byte loss,
+//  driven by the virtual Arduino clock.
+//
+//  - Hardware test suite: the same TestRunner list as Test_Runner_main.cpp
+//    (src/test/host/test_cases) on a clean and on a jittered link
+//  - Robustness: pipelined SETs over a link with corrupted and lost bytes
+//  - Benchmarks: commands/s and ACK latency percentiles for lockstep SET,
+//    SET with a window of 4 and ACT, at 115200 and 921600 baud; STATUS age
+//    for polling vs. push subscription
+//
+//  Run:
+//    pio test -e native -f test_native_link_sim -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "link_sim.h"
+#include "protocol.h"
+
+// The hardware test cases are compiled into this test, so they run
+// unchanged against the simulated client.
+#include "../../src/test/host/test_cases/Test_AdcTempPlausibility.cpp"
+#include "../../src/test/host/test_cases/Test_DigitalBlinkAll.cpp"
+#include "../../src/test/host/test_cases/Test_DigitalChase.cpp"
+#include "../../src/test/host/test_cases/Test_HoldStatusVerify.cpp"
+#include "../../src/test/host/test_cases/Test_LineFragmentationBurst.cpp"
+#include "../../src/test/host/test_cases/Test_LinkStatus.cpp"
+#include "../../src/test/host/test_cases/Test_MalformedFrames.cpp"
+#include "../../src/test/host/test_cases/Test_PingPong.cpp"
+#include "../../src/test/host/test_cases/Test_RstHandling.cpp"
+#include "../../src/test/host/test_cases/Test_Runner.cpp"
+#include "../../src/test/host/test_cases/Test_Seq_SetUpdTogStatus.cpp"
+#include "../../src/test/host/test_cases/Test_SetAck.cpp"
+#include "../../src/test/host/test_cases/Test_TC14a_Seq_SetUpdTog.cpp"
+#include "../../src/test/host/test_cases/Test_TC14b_Status_AfterSeq.cpp"
+#include "../../src/test/host/test_cases/Test_TogAck.cpp"
+#include "../../src/test/host/test_cases/Test_UpdAck.cpp"
+#include "../../src/test/host/test_cases/Test_VisualLedSweep.cpp"
+
+// -----------------------------------------------------------------------------
+// Simulated client application (outputs + ADS1115 values)
+// -----------------------------------------------------------------------------
+
+static constexpr size_t kSampleSlots = 4096;
+
+static uint16_t g_sampleSeq = 0;
+static uint32_t g_sampleTimeMs[kSampleSlots];
+
+// Every STATUS carries a sample counter in adcRaw[0] (0..4095, so the
+// plausibility test case still passes) and the sample time is kept here.
+static void fill_status_cb(ProtocolStatus &st) {
+    g_sampleSeq = static_cast<uint16_t>((g_sampleSeq + 1) % kSampleSlots);
+    g_sampleTimeMs[g_sampleSeq] = millis();
+
+    st.adcRaw[0] = g_sampleSeq;
+    st.adcRaw[1] = 1200;
+    st.adcRaw[2] = 0;
+    st.adcRaw[3] = 0;
+    st.tempHotspot_dC = 251;
+    st.tempChamber_dC = 243;
+}
+
+static void client_app_tick(ClientComm &client) {
+    client.loop();
+    if (client.hasNewOutputsMask()) {
+        client.clearNewOutputsMaskFlag();
+        client.outputsApplied();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+
+static void flush_port(HardwareSerial &port) {
+    port.takeTx();
+    while (port.available() > 0) {
+        port.read();
+    }
+}
+
+struct Bench {
+    HostComm host{Serial1};
+    ClientComm client{Serial2, 16, 17};
+    LinkSim link;
+    uint32_t lastPingMs = 0;
+    bool autoPing = true;
+
+    explicit Bench(const LinkSimConfig &cfg) : link(Serial1, Serial2, cfg) {
+        host.begin(115200, 16, 17);
+        client.begin(115200);
+        client.setFillStatusCallback(fill_status_cb);
+        link.setClientLoop([this]() { client_app_tick(client); });
+    }
+
+    // Host side of oven_comm_poll(): keep-alive PING so linkSynced() holds.
+    void hostAppTick() {
+        host.loop();
+        if (!autoPing) {
+            return;
+        }
+        const uint32_t now = millis();
+        if (now - lastPingMs >= (host.linkSynced() ? 1000u : 250u)) {
+            lastPingMs = now;
+            host.sendPing();
+        }
+    }
+
+    bool sync() {
+        link.setHostLoop([this]() { hostAppTick(); });
+        return link.runUntil([this]() { return host.linkSynced(); }, 3000);
+    }
+
+    bool raiseBaud(uint32_t baud) {
+        host.setLinkBaudTarget(baud);
+        return link.runUntil([this]() { return host.linkBaudRaised(); }, 5000) && client.linkBaud() == baud;
+    }
+};
+
+static uint32_t percentile(std::vector<uint32_t> v, uint32_t pct) {
+    if (v.empty()) {
+        return 0;
+    }
+    const size_t idx = std::min(v.size() - 1, v.size() * pct / 100);
+    std::nth_element(v.begin(), v.begin() + idx, v.end());
+    return v[idx];
+}
+
+void setUp(void) {
+    flush_port(Serial1);
+    flush_port(Serial2);
+}
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Hardware test suite over the simulated link
+// -----------------------------------------------------------------------------
+
+static void run_suite(const LinkSimConfig &cfg, uint32_t &passed, uint32_t &failed) {
+    Bench b(cfg);
+    b.autoPing = false; // the test cases drive the link themselves
+    TestRunner runner(b.host);
+
+    runner.add(get_test_ping_pong());
+    runner.add(get_test_link_status());
+    runner.add(get_test_set_ack());
+    runner.add(get_test_visual_led_sweep());
+    runner.add(get_test_digital_chase());
+    runner.add(get_test_digital_blink_all());
+    runner.add(get_test_upd_ack());
+    runner.add(get_test_tog_ack());
+    runner.add(get_test_seq_set_upd_tog_status());
+    runner.add(get_test_malformed_frames());
+    runner.add(get_test_line_fragmentation_burst());
+    runner.add(get_test_hold_status_verify());
+    runner.add(get_test_tc14a_seq_set_upd_tog());
+    runner.add(get_test_tc14b_status_after_seq());
+    runner.add(get_test_rst_handling());
+    runner.add(get_test_adc_temp_plausibility());
+
+    b.link.setHostLoop([&]() {
+        b.host.loop();
+        runner.tick(millis());
+    });
+    b.link.runForMs(200);
+    runner.start(millis());
+    TEST_ASSERT_TRUE(b.link.runUntil([&]() { return runner.finished(); }, 300000));
+
+    passed = runner.passedCount();
+    failed = runner.failedCount();
+}
+
+void test_suite_clean_link(void) {
+    LinkSimConfig cfg;
+    uint32_t passed = 0, failed = 0;
+    run_suite(cfg, passed, failed);
+    TEST_ASSERT_EQUAL_UINT32(0, failed);
+    TEST_ASSERT_EQUAL_UINT32(16, passed);
+}
+
+void test_suite_jittered_link(void) {
+    LinkSimConfig cfg;
+    cfg.latencyUs = 2000;
+    cfg.jitterUs = 3000;
+    cfg.hostLoopUs = 5000; // LVGL render between HostComm::loop() calls
+    cfg.clientLoopUs = 2000;
+    cfg.seed = 7;
+    uint32_t passed = 0, failed = 0;
+    run_suite(cfg, passed, failed);
+    TEST_ASSERT_EQUAL_UINT32(0, failed);
+    TEST_ASSERT_EQUAL_UINT32(16, passed);
+}
+
+// -----------------------------------------------------------------------------
+// Robustness: corrupted and lost bytes
+// -----------------------------------------------------------------------------
+
+void test_window_survives_corruption(void) {
+    LinkSimConfig cfg;
+    cfg.latencyUs = 500;
+    cfg.jitterUs = 500;
+    cfg.corruptPerMillion = 2000;
+    cfg.dropPerMillion = 1000;
+    cfg.seed = 11;
+    Bench b(cfg);
+    TEST_ASSERT_TRUE(b.sync());
+    b.host.setCommandWindow(4);
+
+    uint16_t mask = 0;
+    for (uint32_t t = 0; t < 20000; ++t) {
+        if (t % 5 == 0 && b.host.commandsPending() < 4) {
+            mask = static_cast<uint16_t>((mask + 0x0101) & 0x0FFF);
+            b.host.setOutputsMask(mask);
+        }
+        b.link.runForMs(1);
+    }
+    TEST_ASSERT_TRUE(b.link.runUntil([&]() { return b.host.commandsPending() == 0; }, 3000));
+    b.link.runForMs(200);
+
+    TEST_ASSERT_GREATER_THAN(0u, (uint32_t)(b.link.hostToClient().corrupted + b.link.clientToHost().corrupted));
+    TEST_ASSERT_GREATER_THAN(0u, b.host.cmdRetransmitCount());
+    TEST_ASSERT_GREATER_THAN(100u, b.host.cmdAckedCount());
+    // Whatever got lost on the way, both ends agree in the end.
+    TEST_ASSERT_EQUAL_HEX16(mask, b.client.getOutputsMask());
+    TEST_ASSERT_EQUAL_HEX16(mask, b.host.getRemoteOutputsMask());
+}
+
+// -----------------------------------------------------------------------------
+// Benchmarks
+// -----------------------------------------------------------------------------
+
+enum class CmdMode : uint8_t { LockstepSet, WindowSet, Act };
+
+static const char *mode_name(CmdMode mode) {
+    switch (mode) {
+    case CmdMode::LockstepSet:
+        return "SET lockstep";
+    case CmdMode::WindowSet:
+        return "SET window 4";
+    default:
+        return "ACT";
+    }
+}
+
+struct CmdStats {
+    uint32_t perSecond;
+    uint32_t p50Us, p95Us, p99Us;
+};
+
+// Keeps the link saturated for 5 s (virtual) and records the time from
+// issuing a command to its ACK being processed by HostComm::loop().
+static CmdStats run_command_bench(CmdMode mode, uint32_t baud) {
+    LinkSimConfig cfg;
+    cfg.latencyUs = 200;
+    cfg.jitterUs = 200;
+    cfg.hostLoopUs = 1000;
+    cfg.clientLoopUs = 500;
+    Bench b(cfg);
+    TEST_ASSERT_TRUE(b.sync());
+    if (baud != 115200) {
+        TEST_ASSERT_TRUE(b.raiseBaud(baud));
+    }
+    if (mode == CmdMode::WindowSet) {
+        b.host.setCommandWindow(4);
+    }
+
+    std::deque<uint64_t> issued;
+    std::vector<uint32_t> latency;
+    uint32_t acked = 0;
+    uint32_t ackedBase = b.host.cmdAckedCount();
+    uint16_t mask = 0;
+
+    b.link.setHostLoop([&]() {
+        b.hostAppTick();
+        const uint64_t now = arduino_native::clock_us();
+
+        // Collect ACKs
+        if (mode == CmdMode::WindowSet) {
+            const uint32_t ackedNow = b.host.cmdAckedCount();
+            for (; ackedBase != ackedNow && !issued.empty(); ++ackedBase) {
+                latency.push_back(static_cast<uint32_t>(now - issued.front()));
+                issued.pop_front();
+                acked++;
+            }
+        } else if (!issued.empty() && b.host.lastSetAcked()) {
+            b.host.clearLastSetAckFlag();
+            latency.push_back(static_cast<uint32_t>(now - issued.front()));
+            issued.pop_front();
+            acked++;
+        }
+
+        // Issue as many as the mode allows
+        const size_t limit = (mode == CmdMode::WindowSet) ? 4 : 1;
+        while (issued.size() < limit) {
+            mask = static_cast<uint16_t>((mask + 1) & 0x0FFF);
+            if (mode == CmdMode::Act) {
+                b.host.setOutputsMaskAndReport(mask);
+            } else {
+                b.host.setOutputsMask(mask);
+            }
+            issued.push_back(now);
+        }
+    });
+    b.host.clearLastSetAckFlag();
+    b.link.runForMs(5000);
+
+    CmdStats s;
+    s.perSecond = acked / 5;
+    s.p50Us = percentile(latency, 50);
+    s.p95Us = percentile(latency, 95);
+    s.p99Us = percentile(latency, 99);
+    return s;
+}
+
+void test_benchmark_commands(void) {
+    const CmdMode modes[] = {CmdMode::LockstepSet, CmdMode::WindowSet, CmdMode::Act};
+    const uint32_t bauds[] = {115200, 921600};
+    CmdStats stats[2][3];
+
+    for (size_t bi = 0; bi < 2; ++bi) {
+        for (size_t mi = 0; mi < 3; ++mi) {
+            stats[bi][mi] = run_command_bench(modes[mi], bauds[bi]);
+            const CmdStats &s = stats[bi][mi];
+            char msg[160];
+            snprintf(msg, sizeof(msg), "[BENCH] %6lu baud %-12s: %5lu cmd/s, ACK latency p50 %5lu us, p95 %5lu us, p99 %5lu us",
+                     (unsigned long)bauds[bi], mode_name(modes[mi]), (unsigned long)s.perSecond,
+                     (unsigned long)s.p50Us, (unsigned long)s.p95Us, (unsigned long)s.p99Us);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_GREATER_THAN(50u, s.perSecond);
+        }
+        // The window overlaps round trips, so it must beat lockstep.
+        TEST_ASSERT_GREATER_THAN(stats[bi][0].perSecond, stats[bi][1].perSecond);
+    }
+    // Lockstep is bound by the round trip, which shrinks with the bit rate.
+    TEST_ASSERT_LESS_THAN(stats[0][0].p50Us, stats[1][0].p50Us);
+}
+
+struct AgeStats {
+    uint32_t p50Ms, p95Ms;
+    uint64_t bytes;
+};
+
+// STATUS age = time since the client took the sample, seen by the host app.
+static AgeStats run_status_age_bench(bool push) {
+    LinkSimConfig cfg;
+    cfg.latencyUs = 500;
+    cfg.jitterUs = 500;
+    cfg.hostLoopUs = 5000;
+    Bench b(cfg);
+    if (push) {
+        b.host.setStatusSubscription(200, SubTriggerOutputs);
+    }
+    TEST_ASSERT_TRUE(b.sync());
+    b.link.runForMs(1000);
+
+    std::vector<uint32_t> ages;
+    uint32_t lastSampleMs = millis();
+    uint32_t lastPollMs = 0;
+    b.link.setHostLoop([&]() {
+        b.hostAppTick();
+        const uint32_t now = millis();
+        if (!b.host.statusSubscribed() && now - lastPollMs >= 200) {
+            lastPollMs = now;
+            b.host.requestStatus();
+        }
+        if (b.host.hasNewStatus()) {
+            lastSampleMs = g_sampleTimeMs[b.host.getRemoteStatus().adcRaw[0] % kSampleSlots];
+            b.host.clearNewStatusFlag();
+        }
+        ages.push_back(now - lastSampleMs);
+    });
+    const uint64_t bytes0 = b.link.hostToClient().bytes + b.link.clientToHost().bytes;
+    b.link.runForMs(30000);
+
+    AgeStats s;
+    s.p50Ms = percentile(ages, 50);
+    s.p95Ms = percentile(ages, 95);
+    s.bytes = b.link.hostToClient().bytes + b.link.clientToHost().bytes - bytes0;
+    return s;
+}
+
+void test_benchmark_status_age(void) {
+    const AgeStats poll = run_status_age_bench(false);
+    const AgeStats push = run_status_age_bench(true);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "[BENCH] STATUS age poll 200 ms: p50 %lu ms, p95 %lu ms, %llu bytes / 30 s",
+             (unsigned long)poll.p50Ms, (unsigned long)poll.p95Ms, (unsigned long long)poll.bytes);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "[BENCH] STATUS age push 200 ms: p50 %lu ms, p95 %lu ms, %llu bytes / 30 s",
+             (unsigned long)push.p50Ms, (unsigned long)push.p95Ms, (unsigned long long)push.bytes);
+    TEST_MESSAGE(msg);
+
+    // Both are bounded by the period; pushing saves the GET direction.
+    TEST_ASSERT_LESS_THAN(250u, poll.p95Ms);
+    TEST_ASSERT_LESS_THAN(250u, push.p95Ms);
+    TEST_ASSERT_LESS_THAN(poll.bytes, push.bytes);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_suite_clean_link);
+    RUN_TEST(test_suite_jittered_link);
+    RUN_TEST(test_window_survives_corruption);
+    RUN_TEST(test_benchmark_commands);
+    RUN_TEST(test_benchmark_status_age);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,430 @@
+// ============================================================================
+//  test_native_log_async / test_main.cpp
+//
+//  Native (PC) tests for the asynchronous log stage: the lock-free MPSC
+//  record ring (log_ring.h) and the drain thread batching lines into Serial
+//  writes and UDP datagrams (log_async.h).
+//
+//  - ring: order, padding at the buffer end, full ring drops and counts,
+//    overlong lines truncated
+//  - ring: several producer threads against one consumer, no record lost
+//    (unless counted as dropped), reordered per producer or torn
+//  - drain: datagrams hold whole lines and never exceed
+//    LOG_ASYNC_DATAGRAM_BYTES; ';' records go to UDP only
+//  - drain: dropped lines are reported in the stream
+//  - write_blocking(): the line is out when it returns
+//  - benchmark: producer cost of one write per line (syscall per line, as
+//    the synchronous path does) against queueing
+//
+//  Run:
+//    pio test -e native -f test_native_log_async -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "log_async.h"
+#include "log_ring.h"
+
+// ----------------------------------------------------------------------------
+//  Capturing sinks
+// ----------------------------------------------------------------------------
+static std::mutex g_sinkMutex;
+static std::vector<std::string> g_datagrams;
+static std::string g_serial;
+static std::atomic<bool> g_sinkGate{true}; // false: sinks stall (slow link)
+
+static void udp_capture(const char *data, size_t len) {
+    while (!g_sinkGate.load()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    g_datagrams.emplace_back(data, len);
+}
+
+static void serial_capture(const char *data, size_t len) {
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    g_serial.append(data, len);
+}
+
+static std::string all_udp() {
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    std::string s;
+    for (const std::string &d : g_datagrams) {
+        s += d;
+    }
+    return s;
+}
+
+void setUp(void) {
+    log_async::stop();
+    g_sinkGate = true;
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    g_datagrams.clear();
+    g_serial.clear();
+}
+
+void tearDown(void) {
+    g_sinkGate = true;
+    log_async::stop();
+}
+
+static std::string make_line(uint32_t producer, uint32_t seq) {
+    // Length varies with seq, the tail repeats a checksum so a torn record
+    // is detected.
+    char head[32];
+    snprintf(head, sizeof(head), "P%u S%u ", producer, seq);
+    std::string s(head);
+    const size_t pad = (seq * 7u + producer) % 41u;
+    for (size_t i = 0; i < pad; ++i) {
+        s += static_cast<char>('a' + (seq + i) % 26u);
+    }
+    s += " #";
+    s += std::to_string((producer * 131u + seq) % 997u);
+    s += '\n';
+    return s;
+}
+
+static bool parse_line(const std::string &s, uint32_t *producer, uint32_t *seq) {
+    unsigned p = 0;
+    unsigned q = 0;
+    if (sscanf(s.c_str(), "P%u S%u ", &p, &q) != 2) {
+        return false;
+    }
+    *producer = p;
+    *seq = q;
+    return s == make_line(p, q);
+}
+
+// ============================================================================
+//  LogRing
+// ============================================================================
+
+static void test_ring_order_and_padding(void) {
+    alignas(4) static uint8_t buf[256];
+    LogRing ring;
+    TEST_ASSERT_TRUE(ring.init(buf, sizeof(buf)));
+    TEST_ASSERT_FALSE(ring.init(buf, 200)); // not a power of two
+    TEST_ASSERT_TRUE(ring.init(buf, sizeof(buf)));
+
+    // Many rounds with odd lengths: records hit the buffer end at every
+    // offset and get padded there.
+    uint32_t next = 0;
+    uint32_t expect = 0;
+    for (int round = 0; round < 2000; ++round) {
+        const int burst = 1 + round % 3;
+        for (int i = 0; i < burst; ++i) {
+            const std::string line = make_line(0, next % 50u);
+            if (line.size() + LogRing::kHeaderLen > 64u) {
+                next++;
+                continue;
+            }
+            TEST_ASSERT_TRUE(ring.push(line.data(), line.size()));
+            next++;
+        }
+        ring.drain([&](const char *data, size_t len) {
+            while (make_line(0, expect % 50u).size() + LogRing::kHeaderLen > 64u) {
+                expect++;
+            }
+            const std::string got(data, len);
+            TEST_ASSERT_EQUAL_STRING(make_line(0, expect % 50u).c_str(), got.c_str());
+            expect++;
+            return true;
+        });
+        TEST_ASSERT_TRUE(ring.empty());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+    TEST_ASSERT_TRUE(ring.highWater() <= ring.capacity());
+}
+
+static void test_ring_full_drops_and_truncates(void) {
+    alignas(4) static uint8_t buf[256];
+    LogRing ring;
+    TEST_ASSERT_TRUE(ring.init(buf, sizeof(buf)));
+
+    const char line[] = "0123456789abcdefghijklmnopqrstu\n"; // 32 bytes + 4 header = 36
+    int accepted = 0;
+    for (int i = 0; i < 20; ++i) {
+        accepted += ring.push(line, sizeof(line) - 1) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_INT(7, accepted); // 7 * 36 = 252 <= 256
+    TEST_ASSERT_EQUAL_UINT32(13, ring.dropped());
+    TEST_ASSERT_EQUAL_UINT32(7, ring.pushed());
+
+    // Drain keeps a record when asked to
+    size_t seen = 0;
+    TEST_ASSERT_EQUAL_size_t(2, ring.drain([&](const char *, size_t) { return ++seen <= 2; }));
+    TEST_ASSERT_TRUE(ring.push(line, sizeof(line) - 1));
+    TEST_ASSERT_EQUAL_size_t(6, ring.drain([](const char *, size_t) { return true; }));
+    TEST_ASSERT_TRUE(ring.empty());
+
+    // A line longer than a quarter of the ring is cut to fit
+    std::string big(300, 'x');
+    uint32_t endPos = 0;
+    TEST_ASSERT_TRUE(ring.push(big.data(), big.size(), &endPos));
+    size_t gotLen = 0;
+    ring.drain([&](const char *, size_t len) {
+        gotLen = len;
+        return true;
+    });
+    TEST_ASSERT_EQUAL_size_t(256 / 4 - LogRing::kHeaderLen, gotLen);
+    TEST_ASSERT_EQUAL_UINT32(endPos, ring.consumedPos());
+}
+
+static void test_ring_multi_producer(void) {
+    alignas(4) static uint8_t buf[4096];
+    LogRing ring;
+    TEST_ASSERT_TRUE(ring.init(buf, sizeof(buf)));
+
+    constexpr uint32_t kProducers = 4;
+    constexpr uint32_t kLines = 20000;
+    std::atomic<uint32_t> done{0};
+    std::vector<uint32_t> failed(kProducers, 0);
+
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            // Retried until it fits: every line must arrive, every failed
+            // attempt must be counted as dropped.
+            for (uint32_t s = 0; s < kLines; ++s) {
+                const std::string line = make_line(p, s);
+                while (!ring.push(line.data(), line.size())) {
+                    failed[p]++;
+                    std::this_thread::yield();
+                }
+            }
+            done++;
+        });
+    }
+
+    std::vector<int64_t> lastSeq(kProducers, -1);
+    std::vector<uint32_t> received(kProducers, 0);
+    uint32_t torn = 0;
+    uint32_t reordered = 0;
+    auto consume = [&](const char *data, size_t len) {
+        uint32_t p = 0;
+        uint32_t s = 0;
+        if (!parse_line(std::string(data, len), &p, &s) || p >= kProducers) {
+            torn++;
+            return true;
+        }
+        if (static_cast<int64_t>(s) <= lastSeq[p]) {
+            reordered++;
+        }
+        lastSeq[p] = s;
+        received[p]++;
+        return true;
+    };
+    while (done.load() < kProducers) {
+        ring.drain(consume);
+    }
+    for (std::thread &t : producers) {
+        t.join();
+    }
+    ring.drain(consume);
+
+    uint32_t totalFailed = 0;
+    for (uint32_t p = 0; p < kProducers; ++p) {
+        TEST_ASSERT_EQUAL_UINT32(kLines, received[p]);
+        totalFailed += failed[p];
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, reordered);
+    TEST_ASSERT_EQUAL_UINT32(totalFailed, ring.dropped());
+    TEST_ASSERT_EQUAL_UINT32(kProducers * kLines, ring.pushed());
+    TEST_ASSERT_TRUE(ring.empty());
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "[BENCH] 4 producers: %lu lines through a 4 KiB ring, %lu full-ring retries",
+             (unsigned long)ring.pushed(), (unsigned long)ring.dropped());
+    TEST_MESSAGE(msg);
+}
+
+// ============================================================================
+//  Drain thread
+// ============================================================================
+
+static void test_async_datagrams_hold_whole_lines(void) {
+    log_async::set_sinks(serial_capture, udp_capture);
+    TEST_ASSERT_TRUE(log_async::start());
+    TEST_ASSERT_TRUE(log_async::running());
+    const log_async::Stats before = log_async::stats();
+
+    std::string expectUdp;
+    std::string expectSerial;
+    for (uint32_t s = 0; s < 3000; ++s) {
+        std::string line = make_line(1, s);
+        if (s % 10 == 0) {
+            line = ";CSV;" + line; // UDP only
+        }
+        expectUdp += line;
+        if (s % 10 != 0) {
+            expectSerial += line;
+        }
+        TEST_ASSERT_TRUE(log_async::write(line.data(), line.size()));
+        if (s % 200 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1)); // let the ring drain
+        }
+    }
+    TEST_ASSERT_TRUE(log_async::flush(2000));
+
+    const log_async::Stats after = log_async::stats();
+    TEST_ASSERT_EQUAL_UINT32(0, after.dropped - before.dropped);
+    TEST_ASSERT_EQUAL_STRING(expectUdp.c_str(), all_udp().c_str());
+    {
+        std::lock_guard<std::mutex> lock(g_sinkMutex);
+        TEST_ASSERT_EQUAL_STRING(expectSerial.c_str(), g_serial.c_str());
+        for (const std::string &d : g_datagrams) {
+            TEST_ASSERT_TRUE(d.size() <= LOG_ASYNC_DATAGRAM_BYTES);
+            TEST_ASSERT_TRUE(d.back() == '\n');
+            TEST_ASSERT_TRUE(d[0] == 'P' || d[0] == ';'); // starts on a line boundary
+        }
+        TEST_ASSERT_TRUE(g_datagrams.size() < 3000 / 4); // batched
+    }
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "[BENCH] 3000 lines -> %lu datagrams, %lu serial writes",
+             (unsigned long)(after.datagrams - before.datagrams),
+             (unsigned long)(after.serialWrites - before.serialWrites));
+    TEST_MESSAGE(msg);
+}
+
+static void test_async_reports_dropped_lines(void) {
+    log_async::set_sinks(serial_capture, udp_capture);
+    TEST_ASSERT_TRUE(log_async::start());
+    const uint32_t droppedBefore = log_async::stats().dropped;
+
+    // Link stalls: the drain thread hangs in the UDP sink, the ring fills
+    g_sinkGate = false;
+    const std::string line(200, 'z');
+    const std::string lineNl = line + "\n";
+    for (int i = 0; i < 400; ++i) {
+        log_async::write(lineNl.data(), lineNl.size());
+    }
+    const uint32_t dropped = log_async::stats().dropped - droppedBefore;
+    TEST_ASSERT_TRUE(dropped > 0);
+    g_sinkGate = true;
+    TEST_ASSERT_TRUE(log_async::flush(2000));
+
+    // The next drain pass reports the count; it follows a new line
+    const char tail[] = "after the stall\n";
+    log_async::write(tail, sizeof(tail) - 1);
+    TEST_ASSERT_TRUE(log_async::flush(2000));
+
+    char expect[64];
+    snprintf(expect, sizeof(expect), "[LOG/WARN] %lu lines dropped", (unsigned long)dropped);
+    const std::string udp = all_udp();
+    TEST_ASSERT_TRUE(udp.find(expect) != std::string::npos);
+    TEST_ASSERT_TRUE(udp.find(tail) != std::string::npos);
+}
+
+static void test_async_blocking_write_is_out_on_return(void) {
+    log_async::set_sinks(serial_capture, udp_capture);
+    TEST_ASSERT_TRUE(log_async::start());
+
+    for (int i = 0; i < 20; ++i) {
+        char line[48];
+        const int n = snprintf(line, sizeof(line), "[MAIN/FATAL] reason %d\n", i);
+        TEST_ASSERT_TRUE(log_async::write_blocking(line, (size_t)n, LOG_ASYNC_BLOCKING_TIMEOUT_MS));
+        std::lock_guard<std::mutex> lock(g_sinkMutex);
+        TEST_ASSERT_TRUE(g_serial.find(line) != std::string::npos);
+    }
+
+    // Stalled link: gives up after the timeout instead of hanging
+    g_sinkGate = false;
+    const char stuck[] = "[MAIN/FATAL] stuck\n";
+    const auto t0 = std::chrono::steady_clock::now();
+    TEST_ASSERT_FALSE(log_async::write_blocking(stuck, sizeof(stuck) - 1, 50));
+    const auto waited =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    TEST_ASSERT_TRUE(waited >= 49 && waited < 1000);
+    TEST_ASSERT_TRUE(log_async::stats().blockingTimeouts >= 1);
+    g_sinkGate = true;
+
+    log_async::stop();
+    TEST_ASSERT_FALSE(log_async::running());
+    TEST_ASSERT_FALSE(log_async::write(stuck, sizeof(stuck) - 1));
+}
+
+// ============================================================================
+//  Benchmark
+// ============================================================================
+
+static int g_devnull = -1;
+static void devnull_sink(const char *data, size_t len) {
+    if (::write(g_devnull, data, len) < 0) {
+        g_devnull = -1;
+    }
+}
+
+static void test_bench_sync_vs_async(void) {
+    g_devnull = ::open("/dev/null", O_WRONLY);
+    TEST_ASSERT_TRUE(g_devnull >= 0);
+    constexpr int kLines = 64 * 1000;
+    const std::string line = make_line(2, 12345);
+
+    // Lines come in bursts (a state change logs a handful of lines); the
+    // ring drains between bursts, outside the timed part.
+    constexpr int kBurst = 64;
+
+    // Synchronous path: one Serial write and one datagram per line
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLines; ++i) {
+        devnull_sink(line.data(), line.size());
+        devnull_sink(line.data(), line.size());
+    }
+    const double syncNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kLines;
+
+    log_async::set_sinks(devnull_sink, devnull_sink);
+    TEST_ASSERT_TRUE(log_async::start());
+    const log_async::Stats before = log_async::stats();
+    double asyncTotalNs = 0.0;
+    for (int i = 0; i < kLines; i += kBurst) {
+        t0 = std::chrono::steady_clock::now();
+        for (int j = 0; j < kBurst; ++j) {
+            log_async::write(line.data(), line.size());
+        }
+        asyncTotalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        TEST_ASSERT_TRUE(log_async::flush(1000));
+    }
+    const double asyncNs = asyncTotalNs / kLines;
+    TEST_ASSERT_TRUE(log_async::flush(5000));
+    const log_async::Stats after = log_async::stats();
+    ::close(g_devnull);
+
+    const uint32_t delivered = (after.lines - before.lines);
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] per line: sync %.0f ns (2 syscalls), async %.0f ns; %lu lines -> %lu datagrams, %lu dropped",
+             syncNs, asyncNs, (unsigned long)delivered, (unsigned long)(after.datagrams - before.datagrams),
+             (unsigned long)(after.dropped - before.dropped));
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32(0, after.dropped - before.dropped);
+    TEST_ASSERT_TRUE(after.datagrams - before.datagrams < delivered / 4);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_order_and_padding);
+    RUN_TEST(test_ring_full_drops_and_truncates);
+    RUN_TEST(test_ring_multi_producer);
+    RUN_TEST(test_async_datagrams_hold_whole_lines);
+    RUN_TEST(test_async_reports_dropped_lines);
+    RUN_TEST(test_async_blocking_write_is_out_on_return);
+    RUN_TEST(test_bench_sync_vs_async);
+    return UNITY_END();
+}
+
+// EOF
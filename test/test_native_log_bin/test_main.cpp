@@ -0,0 +1,327 @@
+// ============================================================================
+//  test_native_log_bin / test_main.cpp
+//
+//  Native (PC) tests for the deferred-format binary log (log_bin.h) and its
+//  decoder (tools/logbin_decode).
+//
+//  - call-site IDs are compile-time constants and match FNV-1a over
+//    "TAG\x1F" "LEVEL\x1F" fmt, as scripts/pio_logbin_formats.py computes
+//  - encode -> decode reproduces the text logPrintf() would have written,
+//    for the conversions used in the tree (%d %u %ld %lu %x %04X %.2f %s
+//    %c %*d %-8s ...), enums and String-like arguments
+//  - record size limit: strings cut, surplus arguments marked truncated
+//  - mixed stream (text lines, CSV, records) decoded from arbitrary chunks;
+//    unknown IDs; table file with escapes
+//  - benchmark: per-call cost and bytes of vsnprintf text vs binary records
+//
+//  Run:
+//    pio test -e native -f test_native_log_bin -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "log_bin.h"
+#include "logbin_decode.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+// Text as logVPrintf() builds it: "[TAG/LEVEL] " + vsnprintf into 512 bytes.
+static size_t format_text(char *line, size_t cap, const char *tag, const char *level, const char *fmt, ...) {
+    int p = snprintf(line, cap, "[%s/%s] ", tag, level);
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(line + p, cap - (size_t)p, fmt, args);
+    va_end(args);
+    size_t total = (size_t)p + (size_t)(n < 0 ? 0 : n);
+    return total >= cap ? cap - 1 : total;
+}
+
+static std::string decode_all(const logbin::FormatTable &table, const uint8_t *data, size_t len) {
+    logbin::StreamDecoder dec(table);
+    std::string out;
+    auto sink = [&](const logbin::StreamDecoder::Line &l) { out += l.text; };
+    dec.feed(data, len, sink);
+    dec.finish(sink);
+    TEST_ASSERT_EQUAL_UINT32(0, dec.malformed());
+    return out;
+}
+
+struct FakeString { // Arduino String stand-in
+    std::string s;
+    const char *c_str() const { return s.c_str(); }
+};
+
+enum class ScopedState : uint8_t { Idle = 0, Running = 3 };
+enum PlainMode { MODE_A = 1, MODE_B = -7 };
+
+// What the varargs call would have received
+template <typename T>
+static typename std::decay<const T>::type printf_arg(const T &v) {
+    return v;
+}
+static const char *printf_arg(const FakeString &v) { return v.c_str(); }
+static int printf_arg(ScopedState v) { return (int)v; }
+
+// Registers the site, encodes, decodes and compares against snprintf.
+#define CHECK_SITE(table, tag, level, ...)                            \
+    do {                                                              \
+        const uint32_t id_ = LOGBIN_SITE_ID(tag, level, __VA_ARGS__); \
+        check_site(table, id_, tag, level, __VA_ARGS__);              \
+    } while (0)
+
+template <typename... Args>
+static void check_site(logbin::FormatTable &table, uint32_t id, const char *tag, const char *level, const char *fmt,
+                       const Args &...args) {
+    table.add(id, tag, level, fmt);
+    char expect[512];
+    format_text(expect, sizeof(expect), tag, level, fmt, printf_arg(args)...);
+
+    uint8_t rec[LOGBIN_MAX_RECORD];
+    const size_t n = logbin::encode(rec, sizeof(rec), id, 4242u, args...);
+    TEST_ASSERT_TRUE(n <= LOGBIN_MAX_RECORD);
+    TEST_ASSERT_EQUAL_HEX8(logbin::kRecordMark, rec[0]);
+    TEST_ASSERT_EQUAL_UINT32(n - logbin::kHeaderLen, rec[1]);
+
+    const std::string got = decode_all(table, rec, n);
+    TEST_ASSERT_EQUAL_STRING(expect, got.c_str());
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+static void test_site_ids(void) {
+    constexpr uint32_t a = LOGBIN_SITE_ID("OVEN", "INFO", "[T] state=%s\n", "RUN");
+    constexpr uint32_t b = LOGBIN_SITE_ID("OVEN", "DEBUG", "[T] state=%s\n", "RUN");
+    constexpr uint32_t c = LOGBIN_SITE_ID("OVEN", "INFO", "[T] state=%s\n");
+    static_assert(a != b, "level is part of the ID");
+    static_assert(a == c, "arguments are not");
+    TEST_ASSERT_EQUAL_HEX32(logbin::fnv1a("OVEN\x1F"
+                                          "INFO\x1F"
+                                          "[T] state=%s\n"),
+                            a);
+
+    // Reference values from scripts/pio_logbin_formats.py (UTF-8 and
+    // escapes hashed as bytes)
+    TEST_ASSERT_EQUAL_HEX32(0x5a70e830u, LOGBIN_SITE_ID("OVEN", "INFO",
+                                                         "[oven_set_runtime_temp_target] Runtime target "
+                                                         "temperature set to %d °C\n"));
+    TEST_ASSERT_EQUAL_HEX32(0x58646a40u, LOGBIN_SITE_ID("MAIN", "INFO", "\t>>>Temp (MAX6675): %d °C\n"));
+}
+
+static void test_roundtrip_matches_printf(void) {
+    logbin::FormatTable table;
+    CHECK_SITE(table, "MAIN", "DEBUG", "[LOOP] %lu passes, %lu RX wake-ups in %lu ms\n", 12345ul, 3120ul, 10000ul);
+    CHECK_SITE(table, "CLIENT", "INFO",
+               "[DIAG] Door=%s state=%s mask=0x%04X rawHot=%d hot_mV=%ld hot_valid=%d "
+               "Thot=%.2fC (%s) rawCh=%d\n",
+               "OPEN", "RUNNING", 0x00A5u, -12, 1843l, 1, 61.37, "ok", 17000);
+    CHECK_SITE(table, "OVEN", "INFO", "[thermal_cache] preset %d: rate %u m°C/s, dead time %lu ms, overshoot %d dC\n",
+               4, 815u, 93000ul, -12);
+    CHECK_SITE(table, "UI", "INFO", "%s", "Loaded preset 'PLA' 04:00 with  50°C to widgets\n");
+    CHECK_SITE(table, "UI", "DEBUG", "|%-8s|%5d|%+.3e|%c|%%|%x|%o|%g|\n", "ab", -42, 12345.678, 'Z', 0xBEEFu, 8u, 0.1f);
+    CHECK_SITE(table, "HOST", "WARN", "width %*d prec %.*f end\n", 6, 77, 2, 3.14159);
+    CHECK_SITE(table, "HOST", "INFO", "%hhu %hd %llu %lld %i\n", 300, 70000, 18446744073709551615ull, -9000000000ll,
+               -1);
+    CHECK_SITE(table, "OVEN", "DEBUG", "state=%d mode=%d name=%s on=%d\n", ScopedState::Running, MODE_B,
+               FakeString{"String arg"}, true);
+    CHECK_SITE(table, "MAIN", "INFO", "no arguments at all\n");
+    CHECK_SITE(table, "MAIN", "INFO", "float %.1f double %.9f\n", 60.5f, 1.0 / 3.0);
+}
+
+static void test_record_limits(void) {
+    logbin::FormatTable table;
+    const uint32_t id = LOGBIN_SITE_ID("MAIN", "INFO", "%s|%s\n");
+    table.add(id, "MAIN", "INFO", "%s|%s\n");
+
+    // Strings are cut to LOGBIN_MAX_STRING
+    const std::string longStr(200, 'x');
+    uint8_t rec[LOGBIN_MAX_RECORD];
+    size_t n = logbin::encode(rec, sizeof(rec), id, 1u, longStr.c_str(), "tail");
+    TEST_ASSERT_TRUE(n <= LOGBIN_MAX_RECORD);
+    std::string expect = "[MAIN/INFO] " + std::string(LOGBIN_MAX_STRING, 'x') + "|tail\n";
+    TEST_ASSERT_EQUAL_STRING(expect.c_str(), decode_all(table, rec, n).c_str());
+
+    // More arguments than fit: the record says so instead of lying
+    const uint32_t id2 = LOGBIN_SITE_ID("MAIN", "INFO", "%s %s %s %s %d\n");
+    table.add(id2, "MAIN", "INFO", "%s %s %s %s %d\n");
+    const std::string s40(40, 'a');
+    n = logbin::encode(rec, sizeof(rec), id2, 1u, s40.c_str(), s40.c_str(), s40.c_str(), s40.c_str(), 5);
+    TEST_ASSERT_TRUE(n <= LOGBIN_MAX_RECORD);
+    logbin::Record r;
+    TEST_ASSERT_TRUE(logbin::parseRecord(rec, n, &r));
+    TEST_ASSERT_TRUE(r.truncated);
+    const std::string out = decode_all(table, rec, n);
+    TEST_ASSERT_TRUE(out.find("<?>") != std::string::npos);
+    TEST_ASSERT_TRUE(out.find(" <truncated>\n") != std::string::npos);
+
+    // Malformed records are rejected, not decoded
+    rec[1] = (uint8_t)(n + 3);
+    TEST_ASSERT_FALSE(logbin::parseRecord(rec, n, &r));
+}
+
+static void test_mixed_stream_in_chunks(void) {
+    logbin::FormatTable table;
+    const uint32_t idA = LOGBIN_SITE_ID("OVEN", "INFO", "[T] state=%s target=%.1f\n");
+    const uint32_t idB = LOGBIN_SITE_ID("HOST", "DEBUG", "seq=%u\n");
+    table.add(idA, "OVEN", "INFO", "[T] state=%s target=%.1f\n");
+    table.add(idB, "HOST", "DEBUG", "seq=%u\n");
+
+    std::vector<uint8_t> stream;
+    std::string expect;
+    std::mt19937 rng(7);
+    uint8_t rec[LOGBIN_MAX_RECORD];
+    for (uint32_t i = 0; i < 500; ++i) {
+        const uint32_t kind = rng() % 4;
+        if (kind == 0) {
+            char line[64];
+            const int n = snprintf(line, sizeof(line), ";CSV;%u;%u\n", i, i * 3);
+            stream.insert(stream.end(), line, line + n);
+            expect.append(line, (size_t)n);
+        } else if (kind == 1) {
+            const size_t n = logbin::encode(rec, sizeof(rec), idA, i, i % 2 ? "RUNNING" : "IDLE", 40.0 + i);
+            stream.insert(stream.end(), rec, rec + n);
+            char line[96];
+            format_text(line, sizeof(line), "OVEN", "INFO", "[T] state=%s target=%.1f\n", i % 2 ? "RUNNING" : "IDLE",
+                        40.0 + i);
+            expect += line;
+        } else if (kind == 2) {
+            const size_t n = logbin::encode(rec, sizeof(rec), idB, i, i);
+            stream.insert(stream.end(), rec, rec + n);
+            expect += "[HOST/DEBUG] seq=" + std::to_string(i) + "\n";
+        } else {
+            // Record of a site missing from the table
+            const size_t n = logbin::encode(rec, sizeof(rec), 0xDEADBEEFu, i, -5, "x");
+            stream.insert(stream.end(), rec, rec + n);
+            expect += "[?/?] <id 0xDEADBEEF> -5 \"x\"\n";
+        }
+    }
+
+    // Arbitrary chunking (serial capture) gives the same lines
+    logbin::StreamDecoder dec(table);
+    std::string out;
+    uint32_t records = 0;
+    auto sink = [&](const logbin::StreamDecoder::Line &l) {
+        out += l.text;
+        records += l.hasTime ? 1u : 0u;
+    };
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        const size_t chunk = std::min<size_t>(1 + rng() % 37, stream.size() - pos);
+        dec.feed(&stream[pos], chunk, sink);
+        pos += chunk;
+    }
+    dec.finish(sink);
+    TEST_ASSERT_EQUAL_UINT32(0, dec.malformed());
+    TEST_ASSERT_EQUAL_UINT32(dec.records(), records);
+    TEST_ASSERT_EQUAL_STRING(expect.c_str(), out.c_str());
+}
+
+static void test_table_file(void) {
+    const char *path = "/tmp/test_native_log_bin_formats.tsv";
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_TRUE(f != nullptr);
+    fputs("# logbin format table: id, tag, level, site, fmt\n", f);
+    fputs("0328ac8b\tMAIN\tINFO\tsrc/x.cpp:123\t\\t>>>[1]: %d\\n\n", f);
+    fputs("5a70e830\tOVEN\tINFO\tsrc/app/oven/oven.cpp:1596\tset to %d °C \\\\ \\x1b[0m\\n\r\n", f);
+    fputs("not a table line\n", f);
+    fclose(f);
+
+    logbin::FormatTable table;
+    TEST_ASSERT_EQUAL_INT(1, table.load(path));
+    TEST_ASSERT_EQUAL_size_t(2, table.size());
+    const logbin::FormatSite *s = table.find(0x0328ac8bu);
+    TEST_ASSERT_TRUE(s != nullptr);
+    TEST_ASSERT_EQUAL_STRING("\t>>>[1]: %d\n", s->fmt.c_str());
+    s = table.find(0x5a70e830u);
+    TEST_ASSERT_TRUE(s != nullptr);
+    TEST_ASSERT_EQUAL_STRING("OVEN", s->tag.c_str());
+    TEST_ASSERT_EQUAL_STRING("src/app/oven/oven.cpp:1596", s->where.c_str());
+    TEST_ASSERT_EQUAL_STRING("set to %d °C \\ \x1b[0m\n", s->fmt.c_str());
+    remove(path);
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+static volatile size_t g_sink;
+
+static void test_bench_text_vs_binary(void) {
+    constexpr int kIters = 200000;
+    char line[512];
+    uint8_t rec[LOGBIN_MAX_RECORD];
+    size_t textBytes = 0;
+    size_t binBytes = 0;
+
+    // Typical calls of the tree
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIters; ++i) {
+        size_t n = format_text(line, sizeof(line), "OVEN", "INFO", "[T] state=%s target=%.1f hot=%d cha=%d\n", "RUNNING",
+                               60.0, 612 + (i & 7), 583);
+        n += format_text(line, sizeof(line), "MAIN", "DEBUG", "[LOOP] %lu passes, %lu RX wake-ups in %lu ms\n",
+                         (unsigned long)i, 3120ul, 10000ul);
+        n += format_text(line, sizeof(line), "HOST", "INFO", "[LINK] synced=%d rtt=%u us errors=%u\n", 1, 467u + (i & 3),
+                         0u);
+        g_sink = g_sink + n;
+        if (i == 0) {
+            textBytes = n;
+        }
+    }
+    const double textNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / (3.0 * kIters);
+
+    const uint32_t idA = LOGBIN_SITE_ID("OVEN", "INFO", "[T] state=%s target=%.1f hot=%d cha=%d\n");
+    const uint32_t idB = LOGBIN_SITE_ID("MAIN", "DEBUG", "[LOOP] %lu passes, %lu RX wake-ups in %lu ms\n");
+    const uint32_t idC = LOGBIN_SITE_ID("HOST", "INFO", "[LINK] synced=%d rtt=%u us errors=%u\n");
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIters; ++i) {
+        const uint32_t now = 3600000u + (uint32_t)i;
+        size_t n = logbin::encode(rec, sizeof(rec), idA, now, "RUNNING", 60.0, 612 + (i & 7), 583);
+        n += logbin::encode(rec, sizeof(rec), idB, now, (unsigned long)i, 3120ul, 10000ul);
+        n += logbin::encode(rec, sizeof(rec), idC, now, 1, 467u + (i & 3), 0u);
+        g_sink = g_sink + n + rec[2];
+        if (i == 0) {
+            binBytes = n;
+        }
+    }
+    const double binNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / (3.0 * kIters);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "[BENCH] per call: vsnprintf %.0f ns, binary %.0f ns (%.1fx)", textNs, binNs,
+             textNs / binNs);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "[BENCH] 3 typical lines: text %u bytes, binary %u bytes (%.1fx)", (unsigned)textBytes,
+             (unsigned)binBytes, (double)textBytes / (double)binBytes);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(binBytes * 2 < textBytes);
+    TEST_ASSERT_TRUE(binNs < textNs);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_site_ids);
+    RUN_TEST(test_roundtrip_matches_printf);
+    RUN_TEST(test_record_limits);
+    RUN_TEST(test_mixed_stream_in_chunks);
+    RUN_TEST(test_table_file);
+    RUN_TEST(test_bench_text_vs_binary);
+    return UNITY_END();
+}
+
+// EOF
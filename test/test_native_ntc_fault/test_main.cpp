@@ -0,0 +1,266 @@
+// ============================================================================
+//  test_native_ntc_fault / test_main.cpp
+//
+//  Native (PC) tests for the NTC sensor fault detector (ntc_fault.h).
+//
+//  - a clean heat-up (ADC noise, EMI spikes, hotspot leading the chamber)
+//    raises no fault on either channel or the pair check
+//  - open / short rails, stuck codes, excessive noise, implausible slope and
+//    hotspot/chamber divergence are each detected within their window;
+//    detection latencies are reported
+//  - faults are held for holdRounds after the condition clears
+//  - benchmark: cost per update
+//
+//  Run:
+//    pio test -e native -f test_native_ntc_fault -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+#include "ntc/ntc_fault.h"
+#include "ntc/ntc_filter.h"
+#include "ntc/ntc_lut_sensors.h"
+
+using namespace ntc;
+
+static constexpr double kRoundMs = 1000.0 / kSensorRoundsPerS;
+
+// Smallest raw code whose temperature is <= temp_dC (both NTCs sit on the
+// low side, so the temperature falls with the code).
+template <typename Lut>
+static int16_t raw_for_dC(int32_t temp_dC) {
+    int32_t lo = 1, hi = 26000;
+    while (lo < hi) {
+        const int32_t mid = (lo + hi) / 2;
+        const int16_t t = Lut::temp_dC(static_cast<int16_t>(mid));
+        if (t != TEMP_INVALID_DC && t <= temp_dC) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return static_cast<int16_t>(lo);
+}
+
+// One channel as the client runs it: LUT, filter chain, detector.
+template <typename Lut, typename Filter>
+struct Channel {
+    SensorFaultDetector det;
+    Filter filt;
+    int16_t filtered = TEMP_INVALID_DC;
+
+    explicit Channel(const SensorFaultConfig &cfg) : det(cfg) {}
+
+    uint8_t step(int16_t raw) {
+        const int16_t t = Lut::temp_dC(raw);
+        filtered = filt.update(t);
+        return det.update(raw, (static_cast<int32_t>(raw) * 3) / 16, t, filtered);
+    }
+};
+
+using HotChannel = Channel<HotspotRawLut, HotspotFilter>;
+using ChaChannel = Channel<ChamberRawLut, ChamberFilter>;
+
+static uint32_t g_rng = 1;
+
+static int32_t noise_lsb(int32_t amplitude) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return static_cast<int32_t>((g_rng >> 8) % static_cast<uint32_t>(2 * amplitude + 1)) - amplitude;
+}
+
+void setUp(void) {
+    g_rng = 1;
+}
+
+void tearDown(void) {}
+
+// Run `rounds` rounds of a steady chamber at temp_dC with +-2 LSB noise.
+static void settle(ChaChannel &ch, int32_t temp_dC, uint32_t rounds) {
+    const int16_t raw = raw_for_dC<ChamberRawLut>(temp_dC);
+    for (uint32_t i = 0; i < rounds; ++i) {
+        TEST_ASSERT_EQUAL_HEX8(0, ch.step(static_cast<int16_t>(raw + noise_lsb(2))));
+    }
+}
+
+// Rounds until `bit` is reported while `rawAt(i)` is fed, 0xFFFFFFFF if never.
+template <typename Ch, typename Fn>
+static uint32_t rounds_until(Ch &ch, uint8_t bit, uint32_t maxRounds, Fn rawAt) {
+    for (uint32_t i = 0; i < maxRounds; ++i) {
+        if (ch.step(rawAt(i)) & bit) {
+            return i + 1;
+        }
+    }
+    return 0xFFFFFFFFu;
+}
+
+// -----------------------------------------------------------------------------
+// No false positives
+// -----------------------------------------------------------------------------
+
+static void test_clean_heatup_has_no_faults(void) {
+    HotChannel hot(kHotspotFaultConfig);
+    ChaChannel cha(kChamberFaultConfig);
+    SensorPairCheck pair(kSensorPairConfig);
+
+    // 25 -> 80 °C chamber at 0.5 °C/s, hotspot lead growing to 15 °C, then
+    // 10 min hold; +-2 LSB noise and a single-round EMI spike every 3 s.
+    uint32_t faultRounds = 0;
+    const uint32_t rampRounds = 110u * kSensorRoundsPerS;
+    const uint32_t total = rampRounds + 600u * kSensorRoundsPerS;
+    for (uint32_t i = 0; i < total; ++i) {
+        const double chaDc = (i < rampRounds) ? 250.0 + 550.0 * i / rampRounds : 800.0;
+        const double lead = (i < rampRounds) ? 150.0 * i / rampRounds : 150.0;
+        int16_t rawHot = static_cast<int16_t>(raw_for_dC<HotspotRawLut>(lround(chaDc + lead)) + noise_lsb(2));
+        const int16_t rawCha = static_cast<int16_t>(raw_for_dC<ChamberRawLut>(lround(chaDc)) + noise_lsb(2));
+        if (i % (3 * kSensorRoundsPerS) == 7) {
+            rawHot = static_cast<int16_t>(rawHot + 900);
+        }
+        const uint16_t mask =
+            pack_sensor_faults(hot.step(rawHot), cha.step(rawCha), pair.update(hot.filtered, cha.filtered));
+        faultRounds += (mask != 0) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, faultRounds);
+}
+
+// -----------------------------------------------------------------------------
+// Detection
+// -----------------------------------------------------------------------------
+
+static void test_open_and_short_rails(void) {
+    ChaChannel open(kChamberFaultConfig);
+    settle(open, 600, 2 * kSensorRoundsPerS);
+    // NTC to GND: an open NTC pulls the tap up to Vref (5000 mV).
+    const uint32_t tOpen = rounds_until(open, SensorFaultOpen, 2 * kSensorRoundsPerS,
+                                        [](uint32_t) { return static_cast<int16_t>(26666 + noise_lsb(1)); });
+    TEST_ASSERT_EQUAL_UINT32(kChamberFaultConfig.railRounds, tOpen);
+    TEST_ASSERT_EQUAL_HEX8(0, open.det.faults() & SensorFaultShort);
+
+    ChaChannel shorted(kChamberFaultConfig);
+    settle(shorted, 600, 2 * kSensorRoundsPerS);
+    const uint32_t tShort = rounds_until(shorted, SensorFaultShort, 2 * kSensorRoundsPerS,
+                                         [](uint32_t) { return static_cast<int16_t>(3 + noise_lsb(2)); });
+    TEST_ASSERT_EQUAL_UINT32(kChamberFaultConfig.railRounds, tShort);
+    TEST_ASSERT_EQUAL_HEX8(0, shorted.det.faults() & SensorFaultOpen);
+
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] open detected after %.0f ms, short after %.0f ms", tOpen * kRoundMs,
+             tShort * kRoundMs);
+    TEST_MESSAGE(msg);
+}
+
+static void test_stuck_noisy_and_slope(void) {
+    ChaChannel stuck(kChamberFaultConfig);
+    settle(stuck, 600, 2 * kSensorRoundsPerS);
+    const int16_t frozen = raw_for_dC<ChamberRawLut>(600);
+    const uint32_t tStuck = rounds_until(stuck, SensorFaultStuck, 10 * kSensorRoundsPerS,
+                                         [frozen](uint32_t) { return frozen; });
+    TEST_ASSERT_EQUAL_UINT32(kChamberFaultConfig.stuckRounds + 1, tStuck);
+
+    ChaChannel noisy(kChamberFaultConfig);
+    settle(noisy, 600, 2 * kSensorRoundsPerS);
+    const int16_t base = raw_for_dC<ChamberRawLut>(600);
+    const uint32_t tNoisy = rounds_until(noisy, SensorFaultNoisy, 5 * kSensorRoundsPerS,
+                                         [base](uint32_t) { return static_cast<int16_t>(base + noise_lsb(150)); });
+    TEST_ASSERT_TRUE(tNoisy <= kChamberFaultConfig.noisyRounds + SensorFaultDetector::kWindow);
+
+    // Chamber reading jumps by 30 °C (sensor touching the heater).
+    ChaChannel slope(kChamberFaultConfig);
+    settle(slope, 600, 2 * kSensorRoundsPerS);
+    const int16_t hotRaw = raw_for_dC<ChamberRawLut>(900);
+    const uint32_t tSlope = rounds_until(slope, SensorFaultSlope, 5 * kSensorRoundsPerS,
+                                         [hotRaw](uint32_t) { return static_cast<int16_t>(hotRaw + noise_lsb(2)); });
+    TEST_ASSERT_TRUE(tSlope <= 2u * kSensorRoundsPerS);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "[BENCH] stuck detected after %.0f ms, noisy after %.0f ms, slope after %.0f ms",
+             tStuck * kRoundMs, tNoisy * kRoundMs, tSlope * kRoundMs);
+    TEST_MESSAGE(msg);
+}
+
+static void test_pair_divergence(void) {
+    HotChannel hot(kHotspotFaultConfig);
+    ChaChannel cha(kChamberFaultConfig);
+    SensorPairCheck pair(kSensorPairConfig);
+    const int16_t rawCha = raw_for_dC<ChamberRawLut>(800);
+    const int16_t rawHotOk = raw_for_dC<HotspotRawLut>(950);
+    const int16_t rawHotOff = raw_for_dC<HotspotRawLut>(250); // fell off, reads the room
+
+    for (uint32_t i = 0; i < 5u * kSensorRoundsPerS; ++i) {
+        hot.step(static_cast<int16_t>(rawHotOk + noise_lsb(2)));
+        cha.step(static_cast<int16_t>(rawCha + noise_lsb(2)));
+        TEST_ASSERT_FALSE(pair.update(hot.filtered, cha.filtered));
+    }
+    uint32_t tPair = 0;
+    for (uint32_t i = 0; i < 20u * kSensorRoundsPerS && tPair == 0; ++i) {
+        hot.step(static_cast<int16_t>(rawHotOff + noise_lsb(2)));
+        cha.step(static_cast<int16_t>(rawCha + noise_lsb(2)));
+        if (pair.update(hot.filtered, cha.filtered)) {
+            tPair = i + 1;
+        }
+    }
+    // The filtered hotspot needs ~1 s (rate limit) to cross the margin.
+    TEST_ASSERT_TRUE(tPair >= kSensorPairConfig.rounds && tPair < kSensorPairConfig.rounds + 2u * kSensorRoundsPerS);
+    const uint16_t mask = pack_sensor_faults(hot.det.faults(), cha.det.faults(), pair.fault());
+    TEST_ASSERT_TRUE((mask & kSensorFaultDivergence) != 0);
+    TEST_ASSERT_EQUAL_HEX16(0, mask & (0x7F << kSensorFaultChamberShift));
+}
+
+static void test_faults_are_held_then_cleared(void) {
+    ChaChannel ch(kChamberFaultConfig);
+    settle(ch, 600, 2 * kSensorRoundsPerS);
+    for (uint16_t i = 0; i < kChamberFaultConfig.railRounds; ++i) {
+        ch.step(3);
+    }
+    TEST_ASSERT_EQUAL_HEX8(SensorFaultShort, ch.det.faults() & SensorFaultShort);
+
+    // Contact is back: the bit stays for holdRounds, then clears.
+    const int16_t raw = raw_for_dC<ChamberRawLut>(600);
+    uint32_t held = 0;
+    while ((ch.step(static_cast<int16_t>(raw + noise_lsb(2))) & SensorFaultShort) != 0 && held < 60000) {
+        held++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(kChamberFaultConfig.holdRounds, held);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, pack_sensor_faults(0, 0, false));
+    TEST_ASSERT_EQUAL_HEX16(0x8201, pack_sensor_faults(SensorFaultOpen, SensorFaultShort, true));
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+static void test_bench_update_cost(void) {
+    SensorFaultDetector det(kChamberFaultConfig);
+    const int16_t base = raw_for_dC<ChamberRawLut>(600);
+    constexpr uint32_t kN = 2000000;
+    uint32_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < kN; ++i) {
+        const int16_t raw = static_cast<int16_t>(base + noise_lsb(2));
+        sink += det.update(raw, (raw * 3) / 16, 600, 600);
+    }
+    const double ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / double(kN);
+    char msg[120];
+    snprintf(msg, sizeof(msg), "[BENCH] SensorFaultDetector::update %.1f ns (%u B state) [%lu]", ns,
+             (unsigned)sizeof(SensorFaultDetector), (unsigned long)(sink & 1));
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_heatup_has_no_faults);
+    RUN_TEST(test_open_and_short_rails);
+    RUN_TEST(test_stuck_noisy_and_slope);
+    RUN_TEST(test_pair_divergence);
+    RUN_TEST(test_faults_are_held_then_cleared);
+    RUN_TEST(test_bench_update_cost);
+    return UNITY_END();
+}
+
+// EOF
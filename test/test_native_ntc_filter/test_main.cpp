@@ -0,0 +1,334 @@
+// ============================================================================
+//  test_native_ntc_filter / test_main.cpp
+//
+//  Native (PC) tests for the NTC filter chains (ntc_filter.h).
+//
+//  - single stages: spike hold/accept, median, EMA convergence, rate limit
+//  - TEMP_INVALID_DC passes through and restarts the chain
+//  - CSV replay: CLIENT_PLOT lines (log_csv.h format) are parsed and the
+//    chamber/hotspot columns run through ntc::ChamberFilter/HotspotFilter.
+//    The built-in trace is synthetic (known truth: plateau, step, ramp,
+//    Gaussian noise, single and double spikes, a dropout) at the client
+//    round rate; noise reduction, spike leakage and latency are asserted.
+//  - a recorded log can be replayed with NTC_FILTER_TRACE=<file> (UDP viewer
+//    or serial capture); it is reported, not asserted
+//
+//  Run:
+//    pio test -e native -f test_native_ntc_filter -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "ntc/ntc_filter.h"
+
+using namespace ntc;
+
+static constexpr double kRoundMs = 4.0 * 1.28 + 0.4; // four 860 SPS conversions + I2C
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Stages
+// -----------------------------------------------------------------------------
+
+static void test_stages(void) {
+    SpikeReject<50, 2> spike;
+    TEST_ASSERT_EQUAL_INT32(400, spike.update(400));
+    TEST_ASSERT_EQUAL_INT32(400, spike.update(900)); // held
+    TEST_ASSERT_EQUAL_INT32(410, spike.update(410));
+    TEST_ASSERT_EQUAL_INT32(410, spike.update(700));
+    TEST_ASSERT_EQUAL_INT32(410, spike.update(700));
+    TEST_ASSERT_EQUAL_INT32(700, spike.update(700)); // persistent: real step
+    TEST_ASSERT_EQUAL_UINT32(3, spike.rejected);
+
+    Median5 med;
+    const int32_t in[] = {10, 12, 300, 11, 13, 12, -200, 12};
+    int32_t out = 0;
+    for (int32_t v : in) {
+        out = med.update(v);
+    }
+    TEST_ASSERT_EQUAL_INT32(12, out);
+
+    Ema<3> ema;
+    TEST_ASSERT_EQUAL_INT32(100, ema.update(100));
+    for (int i = 0; i < 200; ++i) {
+        out = ema.update(200);
+    }
+    TEST_ASSERT_EQUAL_INT32(200, out); // Q8 state: no dead band below 2^Shift
+    for (int i = 0; i < 200; ++i) {
+        out = ema.update(-50);
+    }
+    TEST_ASSERT_EQUAL_INT32(-50, out);
+
+    RateLimit<5> rl;
+    TEST_ASSERT_EQUAL_INT32(0, rl.update(0));
+    TEST_ASSERT_EQUAL_INT32(5, rl.update(100));
+    TEST_ASSERT_EQUAL_INT32(10, rl.update(100));
+    TEST_ASSERT_EQUAL_INT32(7, rl.update(7));
+    TEST_ASSERT_EQUAL_INT32(2, rl.update(-100));
+}
+
+static void test_invalid_restarts_chain(void) {
+    ChamberFilter f;
+    for (int i = 0; i < 100; ++i) {
+        f.update(500);
+    }
+    TEST_ASSERT_EQUAL_INT16(TEMP_INVALID_DC, f.update(TEMP_INVALID_DC));
+    // Reconnected at a different temperature: no ramp from the stale value.
+    TEST_ASSERT_EQUAL_INT16(250, f.update(250));
+    TEST_ASSERT_EQUAL_INT16(250, f.update(251));
+}
+
+// -----------------------------------------------------------------------------
+// CSV replay
+// -----------------------------------------------------------------------------
+
+struct PlotRow {
+    uint32_t ms;
+    int16_t hot_dC;
+    int16_t cha_dC;
+};
+
+// "<ts>;[CSV_CLIENT_PLOT];rawHot;hot_mV;hot_dC;rawCha;cha_mV;cha_dC;..." or
+// the same without the timestamp; other lines are skipped.
+static bool parse_plot_line(const std::string &line, PlotRow &row) {
+    const size_t tag = line.find("[CSV_CLIENT_PLOT]");
+    if (tag == std::string::npos) {
+        return false;
+    }
+    row.ms = (tag > 0) ? static_cast<uint32_t>(strtoul(line.c_str(), nullptr, 10)) : 0;
+    long f[6] = {};
+    const char *p = line.c_str() + tag + strlen("[CSV_CLIENT_PLOT]");
+    for (int i = 0; i < 6; ++i) {
+        if (*p != ';') {
+            return false;
+        }
+        char *end = nullptr;
+        f[i] = strtol(p + 1, &end, 10);
+        if (end == p + 1) {
+            return false;
+        }
+        p = end;
+    }
+    row.hot_dC = static_cast<int16_t>(f[2]);
+    row.cha_dC = static_cast<int16_t>(f[5]);
+    return true;
+}
+
+struct Trace {
+    std::vector<std::string> lines;
+    std::vector<double> truth; // chamber, dC (synthetic only)
+    std::vector<bool> spike;   // sample carries an injected spike
+    size_t stepAt = 0;         // sample index of the +50 dC step
+    size_t rampFrom = 0, rampTo = 0;
+    double rampPerSample = 0.0;
+    size_t flatTo = 0;
+    size_t dropoutAt = 0;
+};
+
+static double gauss(uint32_t &rng) {
+    auto uni = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return ((rng >> 8) + 0.5) / double(1u << 24);
+    };
+    return sqrt(-2.0 * log(uni())) * cos(6.283185307179586 * uni());
+}
+
+static Trace make_synthetic_trace() {
+    Trace t;
+    const size_t perSec = static_cast<size_t>(1000.0 / kRoundMs);
+    t.flatTo = 3 * perSec;
+    t.stepAt = t.flatTo;
+    t.rampFrom = 6 * perSec;
+    t.rampTo = 16 * perSec;
+    t.dropoutAt = 17 * perSec;
+    t.rampPerSample = 20.0 / double(perSec); // 2 °C/s
+    const size_t n = 19 * perSec;
+
+    uint32_t rng = 4242;
+    double level = 400.0;
+    char buf[160];
+    for (size_t i = 0; i < n; ++i) {
+        if (i == t.stepAt) {
+            level += 50.0;
+        }
+        if (i >= t.rampFrom && i < t.rampTo) {
+            level += t.rampPerSample;
+        }
+        double cha = level + 3.0 * gauss(rng); // ADC noise + 1 mV quantization
+        bool spiked = false;
+        if (i % perSec == perSec / 2) {
+            cha += ((i / perSec) & 1) ? 150.0 : -150.0; // single-round EMI spike
+            spiked = true;
+        }
+        if (i % (4 * perSec) == perSec / 3 || i % (4 * perSec) == perSec / 3 + 1) {
+            cha += 120.0; // two rounds in a row
+            spiked = true;
+        }
+        long chaDc = lround(cha);
+        if (i >= t.dropoutAt && i < t.dropoutAt + 3) {
+            chaDc = TEMP_INVALID_DC;
+        }
+        const long hotDc = lround(level * 1.6 + 4.0 * gauss(rng));
+        snprintf(buf, sizeof(buf), "%lu;[CSV_CLIENT_PLOT];9000;1687;%ld;12000;2250;%ld;2;1;0;0;0",
+                 (unsigned long)(i * kRoundMs), hotDc, chaDc);
+        t.lines.push_back(buf);
+        t.truth.push_back(level);
+        t.spike.push_back(spiked);
+    }
+    return t;
+}
+
+struct Replay {
+    std::vector<int16_t> rawCha, filtCha, rawHot, filtHot;
+};
+
+static Replay replay(const std::vector<std::string> &lines) {
+    Replay r;
+    ChamberFilter cha;
+    HotspotFilter hot;
+    PlotRow row;
+    for (const std::string &line : lines) {
+        if (!parse_plot_line(line, row)) {
+            continue;
+        }
+        r.rawCha.push_back(row.cha_dC);
+        r.filtCha.push_back(cha.update(row.cha_dC));
+        r.rawHot.push_back(row.hot_dC);
+        r.filtHot.push_back(hot.update(row.hot_dC));
+    }
+    return r;
+}
+
+// RMS of x minus its centred moving average (window 2k+1), valid samples only.
+static double residual_rms(const std::vector<int16_t> &x, size_t k) {
+    double sum = 0.0;
+    size_t n = 0;
+    for (size_t i = k; i + k < x.size(); ++i) {
+        double avg = 0.0;
+        bool ok = true;
+        for (size_t j = i - k; j <= i + k; ++j) {
+            ok = ok && (x[j] != TEMP_INVALID_DC);
+            avg += x[j];
+        }
+        if (!ok) {
+            continue;
+        }
+        avg /= double(2 * k + 1);
+        sum += (x[i] - avg) * (x[i] - avg);
+        n++;
+    }
+    return (n > 0) ? sqrt(sum / double(n)) : 0.0;
+}
+
+static void test_replay_synthetic_trace(void) {
+    const Trace t = make_synthetic_trace();
+    const Replay r = replay(t.lines);
+    TEST_ASSERT_EQUAL_UINT32(t.lines.size(), r.filtCha.size());
+
+    // Noise on the plateau (after the chain settled), spikes excluded for raw.
+    double rawSq = 0.0, filtSq = 0.0, filtMax = 0.0;
+    size_t rawN = 0, n = 0;
+    for (size_t i = 100; i < t.flatTo; ++i) {
+        const double ef = r.filtCha[i] - t.truth[i];
+        filtSq += ef * ef;
+        filtMax = fmax(filtMax, fabs(ef));
+        n++;
+        if (!t.spike[i]) {
+            const double er = r.rawCha[i] - t.truth[i];
+            rawSq += er * er;
+            rawN++;
+        }
+    }
+    const double rawRms = sqrt(rawSq / double(rawN));
+    const double filtRms = sqrt(filtSq / double(n));
+
+    // Step response: rounds until 90 % of the +50 dC step.
+    size_t step90 = 0;
+    for (size_t i = t.stepAt; i < t.rampFrom; ++i) {
+        if (r.filtCha[i] >= t.truth[t.stepAt - 1] + 45.0) {
+            step90 = i - t.stepAt;
+            break;
+        }
+    }
+
+    // Ramp lag: mean(truth - filtered) / slope over the second half of the ramp.
+    double lagSum = 0.0;
+    size_t lagN = 0;
+    double rampMax = 0.0;
+    for (size_t i = (t.rampFrom + t.rampTo) / 2; i < t.rampTo; ++i) {
+        lagSum += t.truth[i] - r.filtCha[i];
+        lagN++;
+        rampMax = fmax(rampMax, fabs(t.truth[i] - r.filtCha[i]));
+    }
+    const double lagRounds = (lagSum / double(lagN)) / t.rampPerSample;
+
+    // Dropout: invalid in, invalid out, then tracking again right away.
+    TEST_ASSERT_EQUAL_INT16(TEMP_INVALID_DC, r.filtCha[t.dropoutAt]);
+    TEST_ASSERT_EQUAL_INT16(TEMP_INVALID_DC, r.filtCha[t.dropoutAt + 2]);
+    TEST_ASSERT_INT16_WITHIN(15, lround(t.truth[t.dropoutAt + 3]), r.filtCha[t.dropoutAt + 3]);
+
+    char msg[240];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] chamber replay (%u rounds): noise RMS %.2f -> %.2f dC (x%.1f), max plateau error %.1f dC "
+             "with spikes, step 90%% after %u rounds (%.0f ms), ramp lag %.1f rounds (%.0f ms)",
+             (unsigned)r.filtCha.size(), rawRms, filtRms, rawRms / filtRms, filtMax, (unsigned)step90,
+             step90 * kRoundMs, lagRounds, lagRounds * kRoundMs);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE(filtRms * 3.0 < rawRms);
+    TEST_ASSERT_TRUE(filtMax < 5.0);   // no spike leaks through
+    TEST_ASSERT_TRUE(step90 > 0 && step90 * kRoundMs < 600.0);
+    TEST_ASSERT_TRUE(lagRounds * kRoundMs < 250.0);
+    TEST_ASSERT_TRUE(rampMax < 12.0);
+
+    const double hotRaw = residual_rms(r.rawHot, 7);
+    const double hotFilt = residual_rms(r.filtHot, 7);
+    TEST_ASSERT_TRUE(hotFilt * 3.0 < hotRaw);
+}
+
+static void test_replay_recorded_trace(void) {
+    const char *path = getenv("NTC_FILTER_TRACE");
+    if (!path) {
+        TEST_IGNORE_MESSAGE("set NTC_FILTER_TRACE=<CLIENT_PLOT log> to replay a recorded trace");
+    }
+    FILE *f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    std::vector<std::string> lines;
+    char buf[512];
+    while (fgets(buf, sizeof(buf), f)) {
+        lines.emplace_back(buf);
+    }
+    fclose(f);
+
+    const Replay r = replay(lines);
+    TEST_ASSERT_TRUE(r.filtCha.size() > 20);
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] %s: %u rows, chamber residual RMS %.2f -> %.2f dC, hotspot %.2f -> %.2f dC", path,
+             (unsigned)r.filtCha.size(), residual_rms(r.rawCha, 7), residual_rms(r.filtCha, 7),
+             residual_rms(r.rawHot, 7), residual_rms(r.filtHot, 7));
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_stages);
+    RUN_TEST(test_invalid_restarts_chain);
+    RUN_TEST(test_replay_synthetic_trace);
+    RUN_TEST(test_replay_recorded_trace);
+    return UNITY_END();
+}
+
+// EOF
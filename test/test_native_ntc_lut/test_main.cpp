@@ -0,0 +1,178 @@
+// ============================================================================
+//  test_native_ntc_lut / test_main.cpp
+//
+//  Native (PC) tests for the compile-time NTC tables (ntc_lut.h) against the
+//  runtime conversion calc_temp_from_ads_raw_dC() (ntc_convert.cpp).
+//
+//  - dense tables (one entry per mV): identical to the runtime path for every
+//    int16 raw code, incl. the TEMP_INVALID_DC ranges
+//  - bucketed tables: within +-0.1 °C of the runtime path over the operating
+//    range of each sensor, same invalid ranges
+//  - benchmark: per-sample cost of the runtime path and of the tables
+//
+//  Run:
+//    pio test -e native -f test_native_ntc_lut -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "ntc/ntc_convert.h"
+#include "ntc/ntc_lut_sensors.h"
+
+using namespace ntc;
+
+template <uint8_t Shift>
+using HotLut = NtcRawLut<kNtc100k_Hotspot_Table, kNtc100k_Hotspot_TableCount, hotspot::NTC_VREF_MV,
+                         hotspot::NTC_R_FIXED_OHM, hotspot::NTC_TO_GND, Shift>;
+template <uint8_t Shift>
+using ChaLut = NtcRawLut<kNtc10k_Chamber_Table, kNtc10k_Chamber_TableCount, chamber::NTC_VREF_MV,
+                         chamber::NTC_R_FIXED_OHM, chamber::NTC_TO_GND, Shift>;
+
+static int16_t hot_runtime(int16_t raw) {
+    return calc_temp_from_ads_raw_dC(raw, kNtc100k_Hotspot_Table, kNtc100k_Hotspot_TableCount,
+                                     NtcTableMode::Resistance_Ohm, hotspot::NTC_VREF_MV, hotspot::NTC_R_FIXED_OHM,
+                                     hotspot::NTC_TO_GND);
+}
+
+static int16_t cha_runtime(int16_t raw) {
+    return calc_temp_from_ads_raw_dC(raw, kNtc10k_Chamber_Table, kNtc10k_Chamber_TableCount,
+                                     NtcTableMode::Resistance_Ohm, chamber::NTC_VREF_MV, chamber::NTC_R_FIXED_OHM,
+                                     chamber::NTC_TO_GND);
+}
+
+struct Compare {
+    uint32_t validMismatch = 0;
+    int32_t maxErr = 0;    // dC, over the operating range
+    int32_t maxErrRaw = 0; // raw code of maxErr
+};
+
+// Compare every int16 raw code; the error bound applies where the runtime
+// result lies inside [loDc, hiDc].
+template <typename Ref, typename Lut>
+static Compare compare_all(Ref ref, Lut lut, int32_t loDc, int32_t hiDc) {
+    Compare c;
+    for (int32_t raw = -32768; raw <= 32767; ++raw) {
+        const int32_t a = ref(static_cast<int16_t>(raw));
+        const int32_t b = lut(static_cast<int16_t>(raw));
+        if ((a == TEMP_INVALID_DC) != (b == TEMP_INVALID_DC)) {
+            c.validMismatch++;
+            continue;
+        }
+        if (a == TEMP_INVALID_DC || a < loDc || a > hiDc) {
+            continue;
+        }
+        const int32_t err = abs(a - b);
+        if (err > c.maxErr) {
+            c.maxErr = err;
+            c.maxErrRaw = raw;
+        }
+    }
+    return c;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Accuracy
+// -----------------------------------------------------------------------------
+
+static void test_dense_tables_match_runtime_path(void) {
+    const Compare hot = compare_all(hot_runtime, HotLut<0>::temp_dC, -32767, 32767);
+    const Compare cha = compare_all(cha_runtime, ChaLut<0>::temp_dC, -32767, 32767);
+
+    TEST_ASSERT_EQUAL_UINT32(0, hot.validMismatch);
+    TEST_ASSERT_EQUAL_INT32(0, hot.maxErr);
+    TEST_ASSERT_EQUAL_UINT32(0, cha.validMismatch);
+    TEST_ASSERT_EQUAL_INT32(0, cha.maxErr);
+
+    // The valid window of the dividers (sanity, and what the flash use is).
+    TEST_ASSERT_TRUE(HotLut<0>::kFlashBytes < 8 * 1024);
+    TEST_ASSERT_TRUE(ChaLut<0>::kFlashBytes < 8 * 1024);
+    TEST_ASSERT_EQUAL_INT16(250, HotLut<0>::temp_dC(13334)); // 2500 mV: 100k at 25 °C on a 100k divider
+}
+
+static void test_bucketed_tables_within_tenth_degree(void) {
+    // Operating ranges: chamber up to 120 °C with 4 mV buckets, hotspot up to
+    // 150 °C with 2 mV buckets (towards 200 °C one mV is ~2 °C on the 100k
+    // divider, only the dense table is exact there).
+    const Compare hot = compare_all(hot_runtime, HotLut<1>::temp_dC, 0, 1500);
+    const Compare cha = compare_all(cha_runtime, ChaLut<2>::temp_dC, 0, 1200);
+
+    TEST_ASSERT_EQUAL_UINT32(0, hot.validMismatch);
+    TEST_ASSERT_EQUAL_UINT32(0, cha.validMismatch);
+    char msg[120];
+    snprintf(msg, sizeof(msg), "hot max %ld dC @raw %ld, chamber max %ld dC @raw %ld", (long)hot.maxErr,
+             (long)hot.maxErrRaw, (long)cha.maxErr, (long)cha.maxErrRaw);
+    TEST_ASSERT_TRUE_MESSAGE(hot.maxErr <= 1 && cha.maxErr <= 1, msg);
+}
+
+static void test_selected_tables_configuration(void) {
+#if NTC_RAW_LUT_SHIFT == 0
+    TEST_ASSERT_EQUAL_UINT32(HotspotRawLut::kMvHi - HotspotRawLut::kMvLo + 1, HotspotRawLut::kNodes);
+#endif
+    TEST_ASSERT_EQUAL_INT16(hot_runtime(4000), HotspotRawLut::temp_dC(4000));
+    TEST_ASSERT_EQUAL_INT16(cha_runtime(4000), ChamberRawLut::temp_dC(4000));
+    TEST_ASSERT_EQUAL_INT16(TEMP_INVALID_DC, ChamberRawLut::temp_dC(0));
+    TEST_ASSERT_EQUAL_INT16(TEMP_INVALID_DC, ChamberRawLut::temp_dC(-100));
+    TEST_ASSERT_EQUAL_INT16(TEMP_INVALID_DC, ChamberRawLut::temp_dC(32767));
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+template <typename Fn>
+static double ns_per_sample(Fn fn, const std::vector<int16_t> &codes, int32_t &sink) {
+    using clock = std::chrono::steady_clock;
+    constexpr int kRounds = 20;
+    const auto t0 = clock::now();
+    for (int r = 0; r < kRounds; ++r) {
+        for (int16_t raw : codes) {
+            sink += fn(raw);
+        }
+    }
+    return std::chrono::duration<double, std::nano>(clock::now() - t0).count() / (double(kRounds) * codes.size());
+}
+
+static void test_bench_per_sample_cost(void) {
+    // Chamber codes 20..150 °C, random order (typical oven operation).
+    std::vector<int16_t> codes;
+    uint32_t rng = 12345;
+    while (codes.size() < 100000) {
+        rng = rng * 1664525u + 1013904223u;
+        const int16_t raw = static_cast<int16_t>(600 + (rng >> 8) % 12000);
+        codes.push_back(raw);
+    }
+
+    int32_t sink = 0;
+    const double runtimeNs = ns_per_sample(cha_runtime, codes, sink);
+    const double denseNs = ns_per_sample(ChaLut<0>::temp_dC, codes, sink);
+    const double bucketNs = ns_per_sample(ChaLut<2>::temp_dC, codes, sink);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] chamber raw->dC: runtime %.1f ns, dense LUT %.1f ns (%u B), 4 mV buckets %.1f ns (%u B) [%ld]",
+             runtimeNs, denseNs, (unsigned)ChaLut<0>::kFlashBytes, bucketNs, (unsigned)ChaLut<2>::kFlashBytes,
+             (long)(sink & 1));
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_dense_tables_match_runtime_path);
+    RUN_TEST(test_bucketed_tables_within_tenth_degree);
+    RUN_TEST(test_selected_tables_configuration);
+    RUN_TEST(test_bench_per_sample_cost);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,676 @@
+// ============================================================================
+//  test_native_oven_sim / test_main.cpp
+//
+//  Deterministic fast-forward simulation of the whole dryer on the PC:
+//
+//    oven.cpp (real host logic) -> HostComm -> LinkSim -> ClientComm
+//        -> simulated client application -> ThermalPlant (thermal_plant.h)
+//        -> lagged NTC readings -> STATUS -> back to oven.cpp
+//
+//  Everything runs on one thread against the virtual Arduino clock
+//  (OVEN_COMM_RX_TASK=0), so a run replays bit for bit and is only limited
+//  by CPU time. The host emits the same HOST_PLOT / HOST_LOGIC CSV as on the
+//  device.
+//
+//  - Link comes up (sync, STATUS subscription) and reports the cold plant
+//  - Batch: every kPresets entry from a cold oven; per preset time to target,
+//    overshoot, hold-band RMS, hotspot peak and heater duty, plus the speed
+//    against real time
+//  - Door: opened in the hold phase -> WAIT, heater stays off, resume
+//    recovers the band
+//  - Flight recorder: the 1 Hz ring kept all of the above, decodes, holds
+//    the door run; bytes per sample on real controller data
+//  - MPC against the pulse tables, one preset per heater profile
+//  - Thermal cache: repeat runs of a preset warm-start from what the earlier
+//    runs learned; time to HOLD and hold RMS against the cold run
+//  - Run history: every run above has its summary in a file-backed flash,
+//    a stopped run matches what the test measured, a remount sees it all
+//
+//  Environment (optional):
+//    OVEN_SIM_MINUTES=<n>    simulated minutes per preset (default 150,
+//                            shorter if the preset itself is shorter)
+//    OVEN_SIM_CSV=<path>     write every host CSV line, prefixed with the
+//                            virtual time in ms (udp_log_viewer format)
+//
+//  Run:
+//    pio test -e native -f test_native_oven_sim -v
+// ============================================================================
+
+#define OVEN_COMM_RX_TASK 0
+#define CSV_OUT 1
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "file_flash.h"
+#include "link_sim.h"
+#include "thermal_plant.h"
+
+// The real host logic and its parameter store are compiled into this test.
+#include "../../src/app/flight_recorder.cpp"
+#include "../../src/app/host_parameters.cpp"
+#include "../../src/app/run_history.cpp"
+#include "../../src/app/thermal_cache.cpp"
+#include "../../src/app/oven/oven.cpp"
+
+// -----------------------------------------------------------------------------
+// Simulated client application (FSD_Client: outputs, door gating, sensors)
+// -----------------------------------------------------------------------------
+
+static constexpr uint16_t kDoorBit = 1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR;
+
+struct SimClient {
+    ClientComm comm{Serial2, 16, 17};
+    ThermalPlant plant;
+    bool doorOpen = false;
+    bool lastDoorOpen = false;
+    uint16_t effectiveMask = 0;
+    uint16_t sampleSeq = 0;
+    uint64_t lastStepUs = 0;
+};
+
+static SimClient *g_client = nullptr;
+
+// Same gating as applyDoorSafetyGating() in FSD_Client.cpp.
+static uint16_t sim_door_gating(uint16_t mask, bool doorOpen) {
+    mask &= static_cast<uint16_t>(~kDoorBit);
+    if (doorOpen) {
+        mask &= static_cast<uint16_t>(~(connector_u16(OVEN_CONNECTOR::HEATER) |
+                                        connector_u16(OVEN_CONNECTOR::SILICAT_MOTOR) |
+                                        connector_u16(OVEN_CONNECTOR::FAN230V)));
+    }
+    return mask;
+}
+
+static void sim_fill_status(ProtocolStatus &st) {
+    SimClient &c = *g_client;
+    st.outputsMask = static_cast<uint16_t>(c.effectiveMask | (c.doorOpen ? kDoorBit : 0));
+    st.tempHotspot_dC = c.plant.hotspotSensor_dC();
+    st.tempChamber_dC = c.plant.chamberSensor_dC();
+    c.sampleSeq = static_cast<uint16_t>(c.sampleSeq + 1);
+    if (c.sampleSeq == 0) {
+        c.sampleSeq = 1;
+    }
+    st.sampleSeq = c.sampleSeq;
+    st.sampleAgeMs = 0;
+    st.sensorFaults = 0;
+}
+
+static void sim_client_tick() {
+    SimClient &c = *g_client;
+
+    // Plant runs up to "now" with the outputs of the last period.
+    const uint64_t now = arduino_native::clock_us();
+    c.plant.step(static_cast<float>(now - c.lastStepUs) * 1e-6f);
+    c.lastStepUs = now;
+
+    c.comm.loop();
+    if (c.comm.hasNewOutputsMask()) {
+        c.comm.clearNewOutputsMaskFlag();
+        c.comm.outputsApplied();
+    }
+    if (c.doorOpen != c.lastDoorOpen) {
+        c.lastDoorOpen = c.doorOpen;
+        c.comm.notifyStatusEvent(SubTriggerDoor);
+    }
+
+    c.effectiveMask = sim_door_gating(c.comm.getOutputsMask(), c.doorOpen);
+    ThermalPlantInputs in;
+    in.heater = (c.effectiveMask & connector_u16(OVEN_CONNECTOR::HEATER)) != 0;
+    in.fan12v = (c.effectiveMask & connector_u16(OVEN_CONNECTOR::FAN12V)) != 0;
+    in.fan230 = (c.effectiveMask & connector_u16(OVEN_CONNECTOR::FAN230V)) != 0;
+    in.fan230Slow = (c.effectiveMask & connector_u16(OVEN_CONNECTOR::FAN230V_SLOW)) != 0;
+    in.doorOpen = c.doorOpen;
+    c.plant.setInputs(in);
+}
+
+// Host main loop (main.cpp) plus the door handling of screen_main.cpp.
+static void sim_host_tick() {
+    oven_comm_poll();
+    oven_tick();
+
+    if (runtimeState.door_open && runtimeState.mode == OvenMode::RUNNING) {
+        oven_pause_wait();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// CSV capture
+// -----------------------------------------------------------------------------
+
+static FILE *g_csvFile = nullptr;
+static std::string g_consoleLine;
+static uint32_t g_csvLines = 0;
+
+static void sim_console_sink(const char *data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (data[i] != '\n') {
+            g_consoleLine.push_back(data[i]);
+            continue;
+        }
+        if (g_consoleLine.compare(0, 5, "[CSV_") == 0) {
+            g_csvLines++;
+            if (g_csvFile) {
+                fprintf(g_csvFile, "%lu;%s\n", (unsigned long)millis(), g_consoleLine.c_str());
+            }
+        }
+        g_consoleLine.clear();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Harness
+// -----------------------------------------------------------------------------
+
+// One simulator for the whole process: oven.cpp keeps its state in statics,
+// so the runs continue on the same host/client/link like a powered unit.
+struct Sim {
+    SimClient client;
+    LinkSim link;
+    FileFlash historyFlash;
+    bool up = false;
+
+    static LinkSimConfig linkConfig() {
+        LinkSimConfig cfg;
+        cfg.tickUs = 1000;
+        cfg.hostLoopUs = 5000;
+        cfg.clientLoopUs = 5000;
+        cfg.latencyUs = 200;
+        return cfg;
+    }
+
+    static constexpr const char *kHistoryPath = "/tmp/test_native_oven_sim_history.bin";
+
+    static const char *fresh(const char *path) {
+        remove(path);
+        return path;
+    }
+
+    Sim() : link(Serial1, Serial2, linkConfig()), historyFlash(fresh(kHistoryPath), 4096, 64) {}
+
+    bool start() {
+        if (up) {
+            return true;
+        }
+        g_client = &client;
+        client.comm.begin(115200);
+        client.comm.setFillStatusCallback(sim_fill_status);
+        client.lastStepUs = arduino_native::clock_us();
+
+        host_parameters_init();
+        oven_comm_init(Serial1, 115200, 16, 17);
+        flight_recorder_init();
+        run_history_init(&historyFlash);
+        oven_init();
+
+        link.setHostLoop(sim_host_tick);
+        link.setClientLoop(sim_client_tick);
+        up = link.runUntil(
+            []() {
+                return runtimeState.linkSynced && runtimeState.commAlive && g_hostComm->statusSubscribed();
+            },
+            10000);
+        return up;
+    }
+};
+
+static Sim &sim() {
+    static Sim s;
+    return s;
+}
+
+struct PresetResult {
+    float targetC = 0.0f;
+    int32_t timeToTargetS = -1; // chamber NTC within kReachedC of the target
+    int32_t timeToBandS = -1;   // chamber NTC within kBandC of the target
+    int32_t timeToHoldS = -1;   // host heater stage HOLD
+    float overshootC = 0.0f;    // max(chamber - target)
+    float holdRmsC = 0.0f;      // RMS(chamber - target) after reaching it
+    float hotspotMaxC = 0.0f;
+    float heaterDutyPct = 0.0f;
+    uint32_t heaterPulses = 0; // heater off -> on, seen at 1 Hz
+    uint32_t simSeconds = 0;
+    uint32_t safetySeconds = 0;
+    uint32_t commLostSeconds = 0;
+};
+
+// "Reached": chamber NTC within kReachedC of the target. The heater logic
+// stops short of the target on purpose (force-off before target, reheat
+// thresholds), so crossing the target itself is not a reliable event; the
+// remaining offset shows up in the hold RMS.
+static constexpr float kReachedC = 5.0f;
+static constexpr float kBandC = 1.0f;
+static constexpr uint32_t kDefaultSimMinutes = 150;
+
+static uint32_t sim_minutes_per_preset() {
+    const char *env = getenv("OVEN_SIM_MINUTES");
+    const long v = env ? atol(env) : 0;
+    return (v > 0) ? static_cast<uint32_t>(v) : kDefaultSimMinutes;
+}
+
+// Let the host see a cold oven, then start the preset and record 1 Hz
+// samples of the chamber NTC until the run ends or `seconds` have passed.
+// onSecond (optional) runs after every simulated second.
+template <typename OnSecond>
+static PresetResult run_preset(uint16_t index, uint32_t seconds, OnSecond onSecond) {
+    Sim &s = sim();
+    oven_stop();
+    s.client.plant.reset();
+    s.client.doorOpen = false;
+    s.link.runForMs(3000);
+
+    oven_select_preset(index);
+    oven_start();
+
+    PresetResult r;
+    r.targetC = runtimeState.tempTarget;
+    double holdSq = 0.0;
+    uint32_t holdN = 0;
+    uint32_t heaterOnS = 0;
+    bool heaterWasOn = false;
+
+    for (uint32_t t = 1; t <= seconds; ++t) {
+        s.link.runForMs(1000);
+        if (runtimeState.mode == OvenMode::STOPPED || runtimeState.mode == OvenMode::POST) {
+            break;
+        }
+        r.simSeconds = t;
+
+        const float chamberC = s.client.plant.chamberSensor_dC() / 10.0f;
+        const float hotspotC = s.client.plant.hotspotC();
+        const float err = chamberC - r.targetC;
+        r.hotspotMaxC = std::max(r.hotspotMaxC, hotspotC);
+        const bool heaterOn = s.client.plant.inputs().heater;
+        heaterOnS += heaterOn ? 1u : 0u;
+        r.heaterPulses += (heaterOn && !heaterWasOn) ? 1u : 0u;
+        heaterWasOn = heaterOn;
+        r.safetySeconds += runtimeState.safetyCutoffActive ? 1u : 0u;
+        r.commLostSeconds += runtimeState.commAlive ? 0u : 1u;
+
+        if (r.timeToTargetS < 0 && err >= -kReachedC) {
+            r.timeToTargetS = static_cast<int32_t>(t);
+        }
+        if (r.timeToBandS < 0 && err >= -kBandC) {
+            r.timeToBandS = static_cast<int32_t>(t);
+        }
+        if (r.timeToHoldS < 0 && runtimeState.heaterStage == HeaterControlStage::HOLD) {
+            r.timeToHoldS = static_cast<int32_t>(t);
+        }
+        if (r.timeToTargetS >= 0) {
+            r.overshootC = std::max(r.overshootC, err);
+            holdSq += static_cast<double>(err) * err;
+            holdN++;
+        }
+        onSecond(t);
+    }
+
+    r.holdRmsC = holdN ? static_cast<float>(std::sqrt(holdSq / holdN)) : 0.0f;
+    r.heaterDutyPct = r.simSeconds ? 100.0f * heaterOnS / r.simSeconds : 0.0f;
+    oven_stop();
+    return r;
+}
+
+static PresetResult run_preset(uint16_t index, uint32_t seconds) {
+    return run_preset(index, seconds, [](uint32_t) {});
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void test_link_comes_up_against_plant(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE_MESSAGE(s.start(), "host/client link did not come up");
+    s.link.runForMs(5000);
+
+    TEST_ASSERT_TRUE(runtimeState.commAlive);
+    TEST_ASSERT_TRUE(runtimeState.tempChamberValid);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, s.client.plant.config().ambientC, runtimeState.tempChamberC);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, s.client.plant.config().ambientC, runtimeState.tempHotspotC);
+    TEST_ASSERT_EQUAL(OvenMode::STOPPED, runtimeState.mode);
+    TEST_ASSERT_FALSE(s.client.plant.inputs().heater);
+}
+
+void test_all_presets_batch(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE(s.start());
+
+    const char *csvPath = getenv("OVEN_SIM_CSV");
+    g_csvFile = csvPath ? fopen(csvPath, "w") : nullptr;
+    arduino_native::console_sink() = sim_console_sink;
+    g_csvLines = 0;
+
+    const uint32_t minutes = sim_minutes_per_preset();
+    uint64_t simSecondsTotal = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    char msg[200];
+    for (uint16_t i = 0; i < kPresetCount; ++i) {
+        const FilamentPreset &p = kPresets[i];
+        const uint32_t runMin = (p.durationMin > 0) ? std::min<uint32_t>(p.durationMin, minutes) : minutes;
+        const PresetResult r = run_preset(i, runMin * 60u);
+        simSecondsTotal += r.simSeconds;
+
+        TEST_ASSERT_EQUAL_UINT32(0u, r.commLostSeconds);
+        if (r.targetC <= 0.0f) {
+            // CUSTOM without a target: nothing to heat.
+            snprintf(msg, sizeof(msg), "[BENCH] %-20s no target, heater duty %4.1f %%", p.name, r.heaterDutyPct);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_EQUAL_FLOAT(0.0f, r.heaterDutyPct);
+            continue;
+        }
+
+        snprintf(msg, sizeof(msg),
+                 "[BENCH] %-20s target %5.1f C: reach %5ld s, overshoot %4.1f C, hold RMS %4.2f C, "
+                 "hotspot max %5.1f C, duty %4.1f %%",
+                 p.name, r.targetC, (long)r.timeToTargetS, r.overshootC, r.holdRmsC, r.hotspotMaxC,
+                 r.heaterDutyPct);
+        TEST_MESSAGE(msg);
+
+        TEST_ASSERT_TRUE_MESSAGE(r.timeToTargetS > 0, p.name);
+        TEST_ASSERT_TRUE_MESSAGE(r.overshootC < 3.0f, p.name);
+        TEST_ASSERT_TRUE_MESSAGE(r.holdRmsC < 5.0f, p.name);
+        TEST_ASSERT_TRUE_MESSAGE(r.hotspotMaxC < HOST_HOTSPOT_MAX_C, p.name);
+    }
+
+    const double wallS =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    arduino_native::console_sink() = nullptr;
+    if (g_csvFile) {
+        fclose(g_csvFile);
+        g_csvFile = nullptr;
+    }
+
+    snprintf(msg, sizeof(msg), "[BENCH] %u presets, %.1f h simulated in %.2f s wall (%.0fx real time), %lu CSV lines",
+             (unsigned)kPresetCount, simSecondsTotal / 3600.0, wallS, simSecondsTotal / wallS,
+             (unsigned long)g_csvLines);
+    TEST_MESSAGE(msg);
+
+    // Two lines (HOST_PLOT + HOST_LOGIC) per simulated second.
+    TEST_ASSERT_TRUE(g_csvLines >= 2u * simSecondsTotal);
+    TEST_ASSERT_TRUE(simSecondsTotal / wallS > 1000.0);
+}
+
+void test_door_open_waits_and_recovers(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE(s.start());
+
+    static constexpr uint16_t kPla = OVEN_DEFAULT_PRESET_INDEX;
+    static constexpr uint32_t kDoorAtS = 60u * 60u;
+    static constexpr uint32_t kDoorOpenS = 60u;
+    static constexpr uint32_t kRunS = 90u * 60u;
+
+    bool heaterWhileOpen = false;
+    bool waited = false;
+    int32_t backInBandS = -1; // within 1 °C of the temperature before opening
+    float beforeC = 0.0f;
+    float lowestC = 1000.0f;
+
+    const PresetResult r = run_preset(kPla, kRunS, [&](uint32_t t) {
+        const float chamberC = s.client.plant.chamberSensor_dC() / 10.0f;
+        if (t == kDoorAtS) {
+            beforeC = chamberC;
+            s.client.doorOpen = true;
+        }
+        if (t > kDoorAtS && t <= kDoorAtS + kDoorOpenS) {
+            heaterWhileOpen |= s.client.plant.inputs().heater;
+            waited |= (runtimeState.mode == OvenMode::WAITING);
+            lowestC = std::min(lowestC, chamberC);
+        }
+        if (t == kDoorAtS + kDoorOpenS) {
+            s.client.doorOpen = false;
+        }
+        if (runtimeState.mode == OvenMode::WAITING && !runtimeState.door_open) {
+            oven_resume_from_wait();
+        }
+        if (t > kDoorAtS + kDoorOpenS && backInBandS < 0 &&
+            chamberC >= beforeC - 1.0f) {
+            backInBandS = static_cast<int32_t>(t - kDoorAtS - kDoorOpenS);
+        }
+    });
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "[BENCH] door open %lu s at hold: chamber %.1f -> %.1f C, back within 1 C after %ld s",
+             (unsigned long)kDoorOpenS, beforeC, lowestC, (long)backInBandS);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE(r.timeToTargetS > 0 && static_cast<uint32_t>(r.timeToTargetS) < kDoorAtS);
+    TEST_ASSERT_TRUE(waited);
+    TEST_ASSERT_FALSE(heaterWhileOpen);
+    TEST_ASSERT_TRUE(lowestC < beforeC - 2.0f);
+    TEST_ASSERT_TRUE(backInBandS > 0);
+    TEST_ASSERT_TRUE(backInBandS < 20 * 60);
+}
+
+// The flight recorder ran along the whole simulation so far; every block
+// must decode and the door run above must show up in it.
+void test_flight_recorder_on_sim(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE(s.start());
+    TEST_ASSERT_TRUE(s_recorder.ready());
+    TEST_ASSERT_FALSE(s_recorder.frozen());
+
+    uint32_t samples = 0;
+    uint32_t doorOpen = 0;
+    uint32_t waiting = 0;
+    uint32_t gaps = 0;
+    uint32_t prevT = 0;
+    for (uint32_t seq = s_recorder.firstSeq(); seq <= s_recorder.lastSeq(); ++seq) {
+        size_t len = 0;
+        const uint8_t *block = s_recorder.blockBySeq(seq, &len);
+        TEST_ASSERT_TRUE(block != nullptr);
+        const int n = flight_rec::decodeBlock(block, len, [&](const flight_rec::FlightSample &fs) {
+            doorOpen += (fs.flags & flight_rec::kFlagDoorOpen) ? 1u : 0u;
+            waiting += fs.mode == static_cast<uint8_t>(OvenMode::WAITING) ? 1u : 0u;
+            gaps += (samples > 0 && fs.t_s != prevT + 1u) ? 1u : 0u;
+            prevT = fs.t_s;
+            samples++;
+        });
+        TEST_ASSERT_TRUE(n > 0);
+    }
+
+    const flight_rec::Recorder::Stats st = s_recorder.stats();
+    char msg[200];
+    snprintf(msg, sizeof(msg), "[BENCH] flight recorder over the sim: %lu samples (%.1f h) in %lu B, %.2f B/sample, %lu gaps",
+             (unsigned long)st.held, (st.newest_s - st.oldest_s) / 3600.0, (unsigned long)st.bytesHeld,
+             static_cast<double>(st.bytesHeld) / st.held, (unsigned long)gaps);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(st.held, samples);
+    TEST_ASSERT_TRUE(doorOpen > 0);
+    TEST_ASSERT_TRUE(waiting > 0);
+    TEST_ASSERT_TRUE(st.bytesHeld < st.held * 6u);
+}
+
+// Switches every heater profile between the pulse tables and MPC through
+// the saved host parameters, like the parameter screen would.
+static void set_heater_control_mode(HeaterControlMode mode) {
+    HostParameters params{};
+    host_parameters_get(&params);
+    for (uint8_t i = 0; i < HOST_PARAMETER_HEATER_PROFILE_COUNT; ++i) {
+        uint8_t &rules = params.heaterTables[i].rules;
+        rules = static_cast<uint8_t>((mode == HeaterControlMode::MPC) ? (rules | HEATER_RULE_MPC)
+                                                                       : (rules & ~HEATER_RULE_MPC));
+    }
+    TEST_ASSERT_TRUE(host_parameters_save(&params));
+}
+
+void test_mpc_against_pulse(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE(s.start());
+
+    // One preset per heater profile.
+    static constexpr uint16_t kCases[] = {5, 4, 2, 1}; // PLA, PETG, ABS, SILICA
+    static constexpr uint32_t kRunS = 120u * 60u;
+
+    char msg[220];
+    for (uint16_t index : kCases) {
+        // Both from a cold thermal cache.
+        set_heater_control_mode(HeaterControlMode::PULSE);
+        TEST_ASSERT_TRUE(thermal_cache_clear());
+        const PresetResult pulse = run_preset(index, kRunS);
+
+        set_heater_control_mode(HeaterControlMode::MPC);
+        TEST_ASSERT_TRUE(thermal_cache_clear());
+        bool mpcActive = false;
+        const PresetResult mpc = run_preset(index, kRunS, [&](uint32_t) { mpcActive |= runtimeState.heaterMpcActive; });
+
+        for (const PresetResult *r : {&pulse, &mpc}) {
+            snprintf(msg, sizeof(msg),
+                     "[BENCH] %-6s %-5s target %5.1f C: within 5 C %5ld s, within 1 C %5ld s, overshoot %4.1f C, "
+                     "hold RMS %4.2f C, hotspot max %5.1f C, %lu pulses",
+                     kPresets[index].name, (r == &mpc) ? "MPC" : "pulse", r->targetC, (long)r->timeToTargetS,
+                     (long)r->timeToBandS, r->overshootC, r->holdRmsC, r->hotspotMaxC,
+                     (unsigned long)r->heaterPulses);
+            TEST_MESSAGE(msg);
+        }
+
+        const HeaterPolicy &policy = heater_policy_for_profile(kPresets[index].heaterCurveProfile);
+        TEST_ASSERT_TRUE_MESSAGE(mpcActive, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(mpc.timeToTargetS > 0 && mpc.timeToTargetS <= pulse.timeToTargetS,
+                                 kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(mpc.timeToBandS > 0, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(mpc.overshootC < policy.targetOvershootCapC, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(mpc.holdRmsC <= pulse.holdRmsC, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(mpc.hotspotMaxC < policy.hotspotMaxC, kPresets[index].name);
+        TEST_ASSERT_EQUAL_UINT32(0u, mpc.safetySeconds);
+    }
+    set_heater_control_mode(HeaterControlMode::PULSE);
+}
+
+void test_thermal_cache_warm_start(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE(s.start());
+
+    static constexpr uint16_t kCases[] = {5, 4, 2, 1}; // PLA, PETG, ABS, SILICA
+    static constexpr uint32_t kRunS = 120u * 60u;
+    static constexpr uint8_t kWarmRuns = 3;
+
+    char msg[220];
+    for (uint16_t index : kCases) {
+        TEST_ASSERT_TRUE(thermal_cache_clear());
+        const PresetResult cold = run_preset(index, kRunS);
+        TEST_ASSERT_FALSE(runtimeState.heaterWarmStart);
+
+        PresetResult warm;
+        bool warmStarted = false;
+        for (uint8_t run = 0; run < kWarmRuns; ++run) {
+            warm = run_preset(index, kRunS, [&](uint32_t) { warmStarted |= runtimeState.heaterWarmStart; });
+        }
+        const ThermalCacheEntry *e = thermal_cache_get(index, kPresets[index].heaterCurveProfile,
+                                                       thermal_cache_target_dC(cold.targetC));
+        TEST_ASSERT_TRUE_MESSAGE(e != nullptr, kPresets[index].name);
+
+        const PresetResult *const results[] = {&cold, &warm};
+        for (const PresetResult *r : results) {
+            snprintf(msg, sizeof(msg),
+                     "[BENCH] %-6s %-4s target %5.1f C: HOLD %5ld s, within 5 C %5ld s, within 1 C %5ld s, "
+                     "overshoot %4.1f C, hold RMS %4.2f C, hotspot max %5.1f C",
+                     kPresets[index].name, (r == &warm) ? "warm" : "cold", r->targetC, (long)r->timeToHoldS,
+                     (long)r->timeToTargetS, (long)r->timeToBandS, r->overshootC, r->holdRmsC, r->hotspotMaxC);
+            TEST_MESSAGE(msg);
+        }
+        snprintf(msg, sizeof(msg),
+                 "[BENCH] %-6s learned after %u runs: %u m°C/s, dead time %lu ms, hold duty %u pm, overshoot %d dC",
+                 kPresets[index].name, (unsigned)e->runs, (unsigned)e->heatRate_mCps, (unsigned long)e->deadTimeMs,
+                 (unsigned)e->holdDuty_pm, (int)e->overshoot_dC);
+        TEST_MESSAGE(msg);
+
+        const HeaterPolicy &policy = heater_policy_for_profile(kPresets[index].heaterCurveProfile);
+        TEST_ASSERT_TRUE_MESSAGE(warmStarted, kPresets[index].name);
+        TEST_ASSERT_EQUAL_UINT8(1u + kWarmRuns, e->runs);
+        TEST_ASSERT_TRUE_MESSAGE(warm.timeToHoldS > 0, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(cold.timeToHoldS < 0 || warm.timeToHoldS < cold.timeToHoldS, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(warm.timeToTargetS < cold.timeToTargetS, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(warm.holdRmsC < cold.holdRmsC, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(warm.overshootC < policy.targetOvershootCapC, kPresets[index].name);
+        TEST_ASSERT_TRUE_MESSAGE(warm.hotspotMaxC < policy.hotspotMaxC, kPresets[index].name);
+        TEST_ASSERT_EQUAL_UINT32(0u, warm.safetySeconds);
+    }
+    TEST_ASSERT_TRUE(thermal_cache_clear());
+}
+
+// Every run so far went into the history; one more, stopped by hand, is
+// checked against what the test measured, then the flash is mounted again
+// like after a reboot.
+void test_run_history_on_sim(void) {
+    Sim &s = sim();
+    TEST_ASSERT_TRUE(s.start());
+
+    run_history::RunAggregate before;
+    TEST_ASSERT_TRUE(run_history_aggregate(run_history::kAnyPreset, 0, 0xFFFFFFFFu, &before));
+    TEST_ASSERT_TRUE(before.runs > kPresetCount);
+
+    static constexpr uint16_t kPla = OVEN_DEFAULT_PRESET_INDEX;
+    static constexpr uint32_t kRunS = 40u * 60u;
+    const PresetResult r = run_preset(kPla, kRunS);
+
+    RunSummary last;
+    TEST_ASSERT_EQUAL_size_t(1u, run_history_recent(&last, 1));
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] history: %lu runs before this one; run #%lu %lu s, reach %ld s (test %ld s), overshoot %d dC "
+             "(test %.1f C), %u Wh",
+             (unsigned long)before.runs, (unsigned long)last.runId, (unsigned long)last.duration_s,
+             (long)last.timeToTarget_s, (long)r.timeToTargetS, (int)last.overshoot_dC, r.overshootC,
+             (unsigned)last.energy_Wh);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT8(kPla, last.preset);
+    TEST_ASSERT_EQUAL_UINT8(RUN_END_USER_STOP, last.reason);
+    TEST_ASSERT_EQUAL_INT16(static_cast<int16_t>(lroundf(r.targetC * 10.0f)), last.target_dC);
+    TEST_ASSERT_UINT32_WITHIN(2u, kRunS, last.duration_s);
+    TEST_ASSERT_TRUE(last.timeToTarget_s != RUN_HISTORY_NOT_REACHED);
+    TEST_ASSERT_INT32_WITHIN(2, r.timeToTargetS, static_cast<int32_t>(last.timeToTarget_s));
+    TEST_ASSERT_TRUE(last.overshoot_dC <= static_cast<int16_t>(lroundf(r.overshootC * 10.0f)) + 2);
+    const float energyWh = r.heaterDutyPct / 100.0f * r.simSeconds * HOST_HEATER_POWER_W / 3600.0f;
+    TEST_ASSERT_FLOAT_WITHIN(2.0f + 0.1f * energyWh, energyWh, static_cast<float>(last.energy_Wh));
+    TEST_ASSERT_FALSE(last.flags & RUN_FLAG_SAFETY);
+
+    // The console statistics name the preset.
+    static std::string console;
+    console.clear();
+    arduino_native::console_sink() = [](const char *data, size_t len) { console.append(data, len); };
+    TEST_ASSERT_TRUE(run_history_command("hist", 4));
+    TEST_ASSERT_FALSE(run_history_command("histogram", 9));
+    arduino_native::console_sink() = nullptr;
+    TEST_ASSERT_TRUE(console.find(kPresets[kPla].name) != std::string::npos);
+
+    run_history::RunAggregate pla;
+    TEST_ASSERT_TRUE(run_history_aggregate(kPla, 0, 0xFFFFFFFFu, &pla));
+    FileFlash again(Sim::kHistoryPath, 4096, 64);
+    TEST_ASSERT_TRUE(run_history_init(&again));
+    run_history::RunAggregate after;
+    TEST_ASSERT_TRUE(run_history_aggregate(kPla, 0, 0xFFFFFFFFu, &after));
+    TEST_ASSERT_EQUAL_UINT32(pla.runs, after.runs);
+    TEST_ASSERT_EQUAL_UINT32(pla.sumEnergy_Wh, after.sumEnergy_Wh);
+    TEST_ASSERT_TRUE(run_history_aggregate(run_history::kAnyPreset, 0, 0xFFFFFFFFu, &after));
+    TEST_ASSERT_EQUAL_UINT32(before.runs + 1u, after.runs);
+    TEST_ASSERT_EQUAL_UINT32(0u, s.historyFlash.reprograms());
+    run_history_init(&s.historyFlash);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_link_comes_up_against_plant);
+    RUN_TEST(test_all_presets_batch);
+    RUN_TEST(test_door_open_waits_and_recovers);
+    RUN_TEST(test_flight_recorder_on_sim);
+    RUN_TEST(test_mpc_against_pulse);
+    RUN_TEST(test_thermal_cache_warm_start);
+    RUN_TEST(test_run_history_on_sim);
+    return UNITY_END();
+}
+
+// EOF
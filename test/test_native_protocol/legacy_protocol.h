@@ -0,0 +1,439 @@
+#pragma once
+
+// ============================================================================
+//  legacy_protocol.h
+//
+//  Frozen copy of the String based ProtocolCodec parser and builders as they
+//  existed before the zero-allocation span parser / buffer builders. Used by
+//  the native tests as equivalence oracle and as benchmark baseline.
+//  Do NOT use in firmware.
+// ============================================================================
+
+#include <Arduino.h>
+#include <stdlib.h>
+
+#include "protocol.h"
+
+namespace legacy_protocol {
+
+inline bool parseHex4(const String &text, uint16_t &value) {
+    // The protocol mandates exactly 4 hex digits.
+    if (text.length() != 4) {
+        return false;
+    }
+
+    // Use strtol to convert; base 16 for hex.
+    char *endPtr = nullptr;
+    long v = strtol(text.c_str(), &endPtr, 16);
+
+    // endPtr must point to string end → full parsing success.
+    if (*endPtr != '\0') {
+        return false;
+    }
+
+    // Check legal uint16 range.
+    if (v < 0 || v > 0xFFFF) {
+        return false;
+    }
+
+    value = static_cast<uint16_t>(v);
+    return true;
+}
+
+inline bool parseLine(const String &line,
+                      ProtocolMessageType &type,
+                      ProtocolStatus &status,
+                      uint16_t &mask,
+                      int &errorCode,
+                      uint16_t &maskB,
+                      uint16_t &maskC) {
+    type = ProtocolMessageType::Unknown;
+    mask = 0;
+    errorCode = 0;
+    maskB = 0;
+    maskC = 0;
+    // --- Step 1: split line by semicolons -------------------------------
+    const int maxParts = 10;
+    String parts[maxParts];
+    int partCount = 0;
+
+    int start = 0;
+    while (start <= line.length() && partCount < maxParts) {
+        int sep = line.indexOf(';', start);
+
+        if (sep < 0) {
+            // Last chunk: no more separators
+            parts[partCount++] = line.substring(start);
+            break;
+        } else {
+            parts[partCount++] = line.substring(start, sep);
+            start = sep + 1;
+        }
+    }
+
+    // Minimum: sender + command
+    if (partCount < 2) {
+        return false;
+    }
+
+    String sender = parts[0]; // "H" or "C"
+    String cmd = parts[1];    // e.g. "SET", "GET", "STATUS", ...
+
+    // =========================================================================
+    //  HOST → CLIENT MESSAGES
+    // =========================================================================
+    if (sender == "H") {
+        // ----------
+        // H;SET;<mask>
+        // ----------
+        if (cmd == "SET") {
+            if (partCount != 3) {
+                return false;
+            }
+
+            if (!parseHex4(parts[2], mask)) {
+                return false;
+            }
+
+            type = ProtocolMessageType::HostSet;
+            return true;
+        }
+
+        // ----------
+        // H;GET;STATUS
+        // ----------
+        else if (cmd == "GET") {
+            if (partCount != 3) {
+                return false;
+            }
+
+            if (parts[2] != "STATUS") {
+                return false;
+            }
+
+            type = ProtocolMessageType::HostGetStatus;
+            return true;
+        }
+
+        // ----------
+        // H;PING
+        // ----------
+        else if (cmd == "PING") {
+            type = ProtocolMessageType::HostPing;
+            return true;
+        } else if (cmd == "RST") {
+            // Accept exactly: H;RST
+            if (partCount != 2) {
+                return false;
+            }
+            type = ProtocolMessageType::HostRst;
+            return true;
+        }
+
+        else if (cmd == "UPD") {
+            // H;UPD;SSSS;CCCC
+            if (partCount != 4) {
+                return false;
+            }
+
+            uint16_t setMask = 0;
+            uint16_t clrMask = 0;
+            if (!parseHex4(parts[2], setMask)) {
+                return false;
+            }
+            if (!parseHex4(parts[3], clrMask)) {
+                return false;
+            }
+
+            type = ProtocolMessageType::HostUpd;
+            mask = setMask;
+            maskB = clrMask;
+            return true;
+        } else if (cmd == "TOG") {
+            // H;TOG;TTTT
+            if (partCount != 3) {
+                return false;
+            }
+
+            uint16_t togMask = 0;
+            if (!parseHex4(parts[2], togMask)) {
+                return false;
+            }
+
+            type = ProtocolMessageType::HostTog;
+            mask = togMask;
+            return true;
+        }
+        // Unknown host command
+        return false;
+    }
+
+    // =========================================================================
+    //  CLIENT → HOST MESSAGES
+    // =========================================================================
+    if (sender == "C") {
+        if (cmd == "ACK") {
+            // Supported:
+            // C;ACK;SET;MMMM
+            // C;ACK;UPD;MMMM
+            // C;ACK;TOG;MMMM
+            if (partCount != 4) {
+                return false;
+            }
+
+            const String &sub = parts[2];
+
+            if (!parseHex4(parts[3], mask)) {
+                return false;
+            }
+
+            if (sub == "SET") {
+                type = ProtocolMessageType::ClientAckSet;
+                return true;
+            } else if (sub == "UPD") {
+                type = ProtocolMessageType::ClientAckUpd;
+                return true;
+            } else if (sub == "TOG") {
+                type = ProtocolMessageType::ClientAckTog;
+                return true;
+            }
+
+            return false;
+        }
+
+        // ----------
+        // C;ERR;SET;<errorCode>
+        // ----------
+        else if (cmd == "ERR") {
+            if (partCount != 4) {
+                return false;
+            }
+
+            if (parts[2] != "SET") {
+                return false;
+            }
+
+            errorCode = parts[3].toInt();
+            type = ProtocolMessageType::ClientErrSet;
+            return true;
+        }
+
+        // ----------
+        // C;STATUS;<mask>;<a0>;<a1>;<a2>;<a3>;<temp>
+        // ----------
+        else if (cmd == "STATUS") {
+            // Expect exactly 8 parts:
+            // [0]=C
+            // [1]=STATUS
+            // [2]=mask hex
+            // [3]=a0
+            // [4]=a1
+            // [5]=a2
+            // [6]=a3
+            // [7]=temp
+            if (partCount != 9) {
+                return false;
+            }
+
+            uint16_t m;
+            if (!parseHex4(parts[2], m)) {
+                return false;
+            }
+
+            status.outputsMask = m;
+            status.adcRaw[0] = static_cast<uint16_t>(parts[3].toInt());
+            status.adcRaw[1] = static_cast<uint16_t>(parts[4].toInt());
+            status.adcRaw[2] = static_cast<uint16_t>(parts[5].toInt());
+            status.adcRaw[3] = static_cast<uint16_t>(parts[6].toInt());
+            status.tempHotspot_dC = static_cast<int16_t>(parts[7].toInt());
+            status.tempChamber_dC = static_cast<int16_t>(parts[8].toInt());
+            
+
+            type = ProtocolMessageType::ClientStatus;
+            return true;
+        }
+
+        // ----------
+        // C;PONG
+        // ----------
+        else if (cmd == "PONG") {
+            type = ProtocolMessageType::ClientPong;
+            return true;
+        }
+        // ----------
+        // RESET
+        // ----------
+        else if (cmd == "RST") {
+            // Accept exactly: C;RST
+            if (partCount != 2) {
+                return false;
+            }
+            type = ProtocolMessageType::ClientRst;
+            return true;
+        }
+        // Unknown client command
+        return false;
+    }
+
+    // =========================================================================
+    //  UNKNOWN SENDER
+    // =========================================================================
+    return false;
+}
+
+inline String toHex4(uint16_t value) {
+    // snprintf ensures safe formatting into a fixed buffer.
+    // "%04X" formats the number in uppercase hex, padded to 4 digits.
+    char buf[5];
+    snprintf(buf, sizeof(buf), "%04X", static_cast<unsigned>(value));
+    return String(buf);
+}
+
+// ============================================================================
+//  Host → Client Message Builders
+// ============================================================================
+
+/**
+ * @brief Build a SET message:
+ *
+ *   H;SET;<mask>\r\n
+ *
+ * <mask> is a 4-digit uppercase hex value.
+ */
+inline String buildHostSet(uint16_t mask) {
+    String msg = F("H;SET;");
+    msg += toHex4(mask);
+    msg += "\r\n";
+    return msg;
+}
+
+/**
+ * @brief Build a GET STATUS message:
+ *
+ *   H;GET;STATUS\r\n
+ */
+inline String buildHostGetStatus() {
+    String msg = F("H;GET;STATUS");
+    msg += "\r\n";
+    return msg;
+}
+
+/**
+ * @brief Build a PING message:
+ *
+ *   H;PING\r\n
+ */
+inline String buildHostPing() {
+    String msg = F("H;PING");
+    msg += "\r\n";
+    return msg;
+}
+
+// ============================================================================
+//  Client → Host Message Builders
+// ============================================================================
+
+/**
+ * @brief Build an ACK to a SET message:
+ *
+ *   C;ACK;SET;<mask>\r\n
+ */
+inline String buildClientAckSet(uint16_t mask) {
+    String msg = F("C;ACK;SET;");
+    msg += toHex4(mask);
+    msg += "\r\n";
+    return msg;
+}
+
+/**
+ * @brief Build an ERR response to a SET message:
+ *
+ *   C;ERR;SET;<errorCode>\r\n
+ *
+ * The <errorCode> is application-specific (e.g. "1", "42").
+ */
+inline String buildClientErrSet(int errorCode) {
+    String msg = F("C;ERR;SET;");
+    msg += String(errorCode);
+    msg += "\r\n";
+    return msg;
+}
+
+/**
+ * @brief Build a STATUS frame:
+ *
+ *   C;STATUS;<mask>;<adc0>;<adc1>;<adc2>;<adc3>;<temp>\r\n
+ *
+ * <mask> = 4-char HEX
+ * <adc*> = integer raw values (0..4095 typical)
+ * <temp> = temperature × 4 (0.25°C resolution)
+ */
+inline String buildClientStatus(const ProtocolStatus &status) {
+    String msg = F("C;STATUS;");
+    msg += toHex4(status.outputsMask);
+    msg += ';';
+    msg += String(status.adcRaw[0]);
+    msg += ';';
+    msg += String(status.adcRaw[1]);
+    msg += ';';
+    msg += String(status.adcRaw[2]);
+    msg += ';';
+    msg += String(status.adcRaw[3]);
+    msg += ';';
+    msg += String(status.tempHotspot_dC);
+    msg += ';';
+    msg += String(status.tempChamber_dC);
+    msg += "\r\n";
+    return msg;
+}
+
+/**
+ * @brief Build a PONG message to respond to a host PING:
+ *
+ *   C;PONG\r\n
+ */
+inline String buildClientPong() {
+    String msg = F("C;PONG");
+    msg += "\r\n";
+    return msg;
+}
+
+inline String buildHostRst() {
+    String msg = F("H;RST");
+    msg += "\r\n";
+    return msg;
+}
+
+inline String buildClientRst() {
+    String msg = F("C;RST");
+    msg += "\r\n";
+    return msg;
+}
+
+inline String buildHostUpd(uint16_t setMask, uint16_t clrMask) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "H;UPD;%04X;%04X\r\n", setMask, clrMask);
+    return String(buf);
+}
+
+inline String buildHostTog(uint16_t togMask) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "H;TOG;%04X\r\n", togMask);
+    return String(buf);
+}
+
+inline String buildClientAckUpd(uint16_t newMask) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "C;ACK;UPD;%04X\r\n", newMask);
+    return String(buf);
+}
+
+inline String buildClientAckTog(uint16_t newMask) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "C;ACK;TOG;%04X\r\n", newMask);
+    return String(buf);
+}
+
+} // namespace legacy_protocol
+
+// EOF
@@ -0,0 +1,532 @@
+// ============================================================================
+//  test_native_protocol / test_main.cpp
+//
+//  Native (PC) tests for ProtocolCodec parser and builders.
+//
+//  - Equivalence: the span parser must accept/reject exactly the same frames
+//    as the former String based parser (legacy_protocol.h) and decode
+//    identical values. Checked on hand-picked edge cases and on a large set
+//    of randomly mutated frames.
+//  - Builders: buffer builders must emit byte-identical frames to the former
+//    String builders and fail cleanly on too small buffers.
+//  - Benchmarks: frames/sec and String heap allocations per frame for old
+//    and new parser/builders on a realistic frame mix.
+//
+//  Run:
+//    pio test -e native -f test_native_protocol -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "legacy_protocol.h"
+#include "protocol.h"
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+struct Decoded {
+    bool ok;
+    ProtocolMessageType type;
+    uint16_t mask;
+    uint16_t maskB;
+    int errorCode;
+    ProtocolStatus status;
+};
+
+static String make_string(const std::string &bytes) {
+    // Build via concat so embedded NULs survive (same as HostComm/ClientComm rx).
+    String s;
+    for (char c : bytes) {
+        s += c;
+    }
+    return s;
+}
+
+static Decoded decode_legacy(const std::string &frame) {
+    Decoded d{};
+    memset(&d.status, 0, sizeof(d.status));
+    const String line = make_string(frame);
+    uint16_t maskC = 0;
+    d.ok = legacy_protocol::parseLine(line, d.type, d.status, d.mask, d.errorCode, d.maskB, maskC);
+    return d;
+}
+
+static Decoded decode_span(const std::string &frame) {
+    Decoded d{};
+    memset(&d.status, 0, sizeof(d.status));
+    ProtocolMessage msg;
+    d.ok = ProtocolCodec::parseFrame(frame.data(), frame.size(), msg);
+    d.type = msg.type;
+    d.mask = msg.mask;
+    d.maskB = msg.maskB;
+    d.errorCode = msg.errorCode;
+    if (d.ok && msg.type == ProtocolMessageType::ClientStatus) {
+        d.status = msg.status;
+    }
+    return d;
+}
+
+static std::string printable(const std::string &frame) {
+    std::string out;
+    for (unsigned char c : frame) {
+        if (c >= 0x20 && c < 0x7F) {
+            out += (char)c;
+        } else {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\x%02X", c);
+            out += buf;
+        }
+    }
+    return out;
+}
+
+static void assert_equivalent(const std::string &frame) {
+    const Decoded a = decode_legacy(frame);
+    const Decoded b = decode_span(frame);
+
+    char msg[256];
+    snprintf(msg, sizeof(msg), "frame='%s'", printable(frame).c_str());
+
+    TEST_ASSERT_EQUAL_MESSAGE(a.ok, b.ok, msg);
+    if (!a.ok) {
+        return;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE((int)a.type, (int)b.type, msg);
+    TEST_ASSERT_EQUAL_MESSAGE(a.mask, b.mask, msg);
+    TEST_ASSERT_EQUAL_MESSAGE(a.maskB, b.maskB, msg);
+    TEST_ASSERT_EQUAL_MESSAGE(a.errorCode, b.errorCode, msg);
+    if (a.type == ProtocolMessageType::ClientStatus) {
+        TEST_ASSERT_EQUAL_MESSAGE(a.status.outputsMask, b.status.outputsMask, msg);
+        for (int i = 0; i < 4; ++i) {
+            TEST_ASSERT_EQUAL_MESSAGE(a.status.adcRaw[i], b.status.adcRaw[i], msg);
+        }
+        TEST_ASSERT_EQUAL_MESSAGE(a.status.tempHotspot_dC, b.status.tempHotspot_dC, msg);
+        TEST_ASSERT_EQUAL_MESSAGE(a.status.tempChamber_dC, b.status.tempChamber_dC, msg);
+    }
+}
+
+// Representative well-formed frames of every message type.
+static const char *const kValidFrames[] = {
+    "H;SET;0019",
+    "H;GET;STATUS",
+    "H;PING",
+    "H;RST",
+    "H;UPD;0011;0100",
+    "H;TOG;0004",
+    "C;ACK;SET;0019",
+    "C;ACK;UPD;00FF",
+    "C;ACK;TOG;abcd",
+    "C;ERR;SET;42",
+    "C;STATUS;0019;123;456;789;1023;1120;452",
+    "C;STATUS;FFFF;-1;32767;-32768;65535;-400;9999",
+    "C;PONG",
+    "C;RST",
+};
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_valid_frames_decode(void) {
+    ProtocolMessage msg;
+
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("H;UPD;0011;0100", 15, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostUpd, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x0011, msg.mask);
+    TEST_ASSERT_EQUAL_HEX16(0x0100, msg.maskB);
+
+    const char *st = "C;STATUS;0019;123;456;789;1023;1120;452";
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(st, strlen(st), msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientStatus, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x0019, msg.status.outputsMask);
+    TEST_ASSERT_EQUAL_INT16(1023, msg.status.adcRaw[3]);
+    TEST_ASSERT_EQUAL_INT16(1120, msg.status.tempHotspot_dC);
+    TEST_ASSERT_EQUAL_INT16(452, msg.status.tempChamber_dC);
+
+    // Span need not be NUL-terminated: trailing bytes outside len are ignored.
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("H;PING;garbage", 6, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostPing, (int)msg.type);
+
+    for (const char *f : kValidFrames) {
+        TEST_ASSERT_TRUE_MESSAGE(ProtocolCodec::parseFrame(f, strlen(f), msg), f);
+        assert_equivalent(f);
+    }
+
+    // Link mode negotiation frames were added after the legacy parser
+    // (not part of the equivalence corpus; the fuzz alphabet has no 'B').
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("H;BIN;0001", 10, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostBin, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x0001, msg.mask);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("C;ACK;BIN;0000", 14, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckBin, (int)msg.type);
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("H;BIN", 5, msg));
+
+    // STATUS push subscription (same: newer than the legacy parser).
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("H;SUB;01F4;0003", 15, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::HostSub, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x01F4, msg.mask);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, msg.maskB);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame("C;ACK;SUB;01F4", 14, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckSub, (int)msg.type);
+    TEST_ASSERT_EQUAL_HEX16(0x01F4, msg.mask);
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("H;SUB;01F4", 10, msg));
+
+    char buf[ProtocolCodec::kMaxFrameLen];
+    TEST_ASSERT_EQUAL_size_t(17, ProtocolCodec::buildHostSub(buf, sizeof(buf), 500, 0x0003));
+    TEST_ASSERT_EQUAL_STRING("H;SUB;01F4;0003\r\n", buf);
+
+    // Optional sample fields (seq hex, age ms, sensor faults hex); the 9-field
+    // STATUS above has none.
+    TEST_ASSERT_EQUAL_HEX16(0, msg.status.sampleSeq);
+    ProtocolStatus sample = {};
+    sample.outputsMask = 0x0019;
+    sample.tempChamber_dC = 452;
+    sample.sampleSeq = 0x0A2F;
+    sample.sampleAgeMs = 37;
+    sample.sensorFaults = 0x8104;
+    ProtocolCodec::buildClientStatus(buf, sizeof(buf), sample);
+    TEST_ASSERT_EQUAL_STRING("C;STATUS;0019;0;0;0;0;0;452;0A2F;37;8104\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, strlen(buf) - 2, msg));
+    TEST_ASSERT_EQUAL_HEX16(0x0A2F, msg.status.sampleSeq);
+    TEST_ASSERT_EQUAL_UINT16(37, msg.status.sampleAgeMs);
+    TEST_ASSERT_EQUAL_HEX16(0x8104, msg.status.sensorFaults);
+    ProtocolCodec::buildClientAckAct(buf, sizeof(buf), 0x0019, sample, 0x2A);
+    TEST_ASSERT_EQUAL_STRING("C;ACK;ACT;0019;0019;0;0;0;0;0;452;0A2F;37;8104;#2A\r\n", buf);
+    TEST_ASSERT_TRUE(ProtocolCodec::parseFrame(buf, strlen(buf) - 2, msg));
+    TEST_ASSERT_EQUAL((int)ProtocolMessageType::ClientAckAct, (int)msg.type);
+    TEST_ASSERT_EQUAL_UINT8(0x2A, msg.seq);
+    TEST_ASSERT_EQUAL_HEX16(0x0A2F, msg.status.sampleSeq);
+    TEST_ASSERT_EQUAL_UINT16(37, msg.status.sampleAgeMs);
+    TEST_ASSERT_EQUAL_HEX16(0x8104, msg.status.sensorFaults);
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("C;STATUS;0019;0;0;0;0;0;452;0A2F", 32, msg));
+    TEST_ASSERT_FALSE(ProtocolCodec::parseFrame("C;STATUS;0019;0;0;0;0;0;452;0A2F;37", 35, msg));
+}
+
+void test_edge_cases_match_legacy(void) {
+    static const char *const kCases[] = {
+        "", ";", ";;", "H", "H;", "C;", "X;PING", "h;PING", "H;ping",
+        "H;SET", "H;SET;", "H;SET;001", "H;SET;00190", "H;SET;0019;", "H;SET;GGGG",
+        "H;SET; 019", "H;SET;+019", "H;SET;-000", "H;SET;-001", "H;SET;0x1F", "H;SET;0X1f",
+        "H;SET;0x  ", "H;SET;  0x", "H;SET;-0x1", "H;SET; +1F", "H;SET;\t001", "H;SET;00 1",
+        "H;GET;status", "H;GET;STATUS;", "H;GET;STATUSX",
+        "H;PING;", "H;PING;x;y", "H;RST;", "H;UPD;0011", "H;UPD;0011;0100;", "H;UPD;0011;01000",
+        "H;TOG;", "H;TOG;1;", "C;ACK;SET", "C;ACK;SET;12345", "C;ACK;FOO;0011", "C;ACK;SET;zz00",
+        "C;ERR;SET;", "C;ERR;SET;abc", "C;ERR;SET; -17x", "C;ERR;SET;99999999999", "C;ERR;GET;1",
+        "C;ERR;SET;-2147483649", "C;ERR;SET;+2147483647",
+        "C;STATUS;0019;1;2;3;4;5", "C;STATUS;0019;1;2;3;4;5;6;7", "C;STATUS;0019;;;;;;",
+        "C;STATUS;0019;70000;-70000;x;  12;+5;-0", "C;STATUS;001G;1;2;3;4;5;6",
+        "C;PONG;", "C;PONG;1;2;3;4;5;6;7;8;9;10;11", "C;RST;x",
+        "H;PING;1;2;3;4;5;6;7;8;9", "C;STATUS;0019;1;2;3;4;5;6;7;8;9",
+        "H;SET;;", " H;PING", "H ;PING", "H;PING ",
+    };
+    for (const char *c : kCases) {
+        assert_equivalent(c);
+    }
+
+    // Embedded NULs (String += '\0' keeps them): separators after a NUL are
+    // invisible to the legacy indexOf(), comparisons stop at the NUL.
+    const std::string withNul[] = {
+        std::string("H;PING\0;x", 9),     std::string("H;SET;00\0;", 10), std::string("H;SET;\0abc", 10),
+        std::string("H;SET;0\0ab", 10),   std::string("C;PONG\0", 7),     std::string("H\0;PING", 7),
+        std::string("H;GET;STATUS\0", 13), std::string("C;ERR;SET;1\0" "2", 12),
+    };
+    for (const std::string &f : withNul) {
+        assert_equivalent(f);
+    }
+}
+
+void test_random_mutations_match_legacy(void) {
+    std::mt19937 rng(0xF5D0u);
+    static const char kAlphabet[] = "HC;0123456789abcdefABCDEFxXgG+- \t\r\nSETUPDGOAKRNIOSTATUSPONG";
+    const size_t alphabetLen = sizeof(kAlphabet) - 1;
+    uint32_t accepted = 0;
+
+    for (uint32_t iter = 0; iter < 200000; ++iter) {
+        std::string f = kValidFrames[rng() % (sizeof(kValidFrames) / sizeof(kValidFrames[0]))];
+        const uint32_t edits = 1 + rng() % 3;
+        for (uint32_t e = 0; e < edits; ++e) {
+            const uint32_t op = rng() % 5;
+            const size_t pos = f.empty() ? 0 : rng() % (f.size() + 1);
+            const char ch = (rng() % 64 == 0) ? '\0' : kAlphabet[rng() % alphabetLen];
+            switch (op) {
+            case 0: // replace
+                if (pos < f.size()) {
+                    f[pos] = ch;
+                }
+                break;
+            case 1: // insert
+                f.insert(f.begin() + pos, ch);
+                break;
+            case 2: // erase
+                if (pos < f.size()) {
+                    f.erase(pos, 1);
+                }
+                break;
+            case 3: // truncate
+                f.resize(pos);
+                break;
+            default: // keep unchanged (valid frames must stay valid)
+                break;
+            }
+        }
+        assert_equivalent(f);
+        accepted += decode_span(f).ok ? 1 : 0;
+    }
+
+    // Sanity: the corpus covers both verdicts.
+    TEST_ASSERT_GREATER_THAN(1000u, accepted);
+    TEST_ASSERT_LESS_THAN(200000u, accepted);
+}
+
+void test_span_parser_is_allocation_free(void) {
+    ProtocolMessage msg;
+    const uint32_t before = arduino_native::string_heap_allocs();
+    for (const char *f : kValidFrames) {
+        ProtocolCodec::parseFrame(f, strlen(f), msg);
+    }
+    TEST_ASSERT_EQUAL_UINT32(before, arduino_native::string_heap_allocs());
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark (informational, no pass/fail thresholds)
+// -----------------------------------------------------------------------------
+
+// Typical link traffic: STATUS dominates, plus ACKs and PONGs.
+static const char *const kBenchMix[] = {
+    "C;STATUS;0019;12345;23456;345;4567;1120;452",
+    "C;ACK;UPD;0019",
+    "C;PONG",
+    "C;STATUS;0011;12001;23001;301;4001;1133;455",
+    "H;UPD;0011;0100",
+    "H;PING",
+    "H;GET;STATUS",
+    "C;ACK;SET;0019",
+};
+static constexpr size_t kBenchMixLen = sizeof(kBenchMix) / sizeof(kBenchMix[0]);
+static constexpr uint32_t kBenchFrames = 1000000;
+
+void test_benchmark_parse(void) {
+    using clock = std::chrono::steady_clock;
+
+    // Pre-build String lines for the legacy parser (as HostComm would hold them).
+    std::vector<String> lines;
+    for (const char *f : kBenchMix) {
+        lines.emplace_back(f);
+    }
+
+    volatile uint32_t sink = 0;
+
+    // --- legacy String parser ---
+    uint32_t allocs0 = arduino_native::string_heap_allocs();
+    auto t0 = clock::now();
+    for (uint32_t i = 0; i < kBenchFrames; ++i) {
+        ProtocolMessageType type;
+        ProtocolStatus st;
+        uint16_t mask, maskB, maskC;
+        int err;
+        sink += legacy_protocol::parseLine(lines[i % kBenchMixLen], type, st, mask, err, maskB, maskC);
+    }
+    const double legacySec = std::chrono::duration<double>(clock::now() - t0).count();
+    const double legacyAllocs = double(arduino_native::string_heap_allocs() - allocs0) / kBenchFrames;
+
+    // --- span parser ---
+    size_t lens[kBenchMixLen];
+    for (size_t i = 0; i < kBenchMixLen; ++i) {
+        lens[i] = strlen(kBenchMix[i]);
+    }
+    allocs0 = arduino_native::string_heap_allocs();
+    t0 = clock::now();
+    for (uint32_t i = 0; i < kBenchFrames; ++i) {
+        ProtocolMessage msg;
+        const size_t k = i % kBenchMixLen;
+        sink += ProtocolCodec::parseFrame(kBenchMix[k], lens[k], msg);
+    }
+    const double spanSec = std::chrono::duration<double>(clock::now() - t0).count();
+    const double spanAllocs = double(arduino_native::string_heap_allocs() - allocs0) / kBenchFrames;
+
+    TEST_ASSERT_EQUAL_UINT32(2u * kBenchFrames, (uint32_t)sink);
+
+    char buf[192];
+    snprintf(buf, sizeof(buf), "[BENCH] legacy parseLine : %10.0f frames/s, %5.2f allocs/frame",
+             kBenchFrames / legacySec, legacyAllocs);
+    TEST_MESSAGE(buf);
+    snprintf(buf, sizeof(buf), "[BENCH] span parseFrame  : %10.0f frames/s, %5.2f allocs/frame (x%.1f)",
+             kBenchFrames / spanSec, spanAllocs, legacySec / spanSec);
+    TEST_MESSAGE(buf);
+
+    TEST_ASSERT_EQUAL(0, (int)(spanAllocs * 1000));
+}
+
+void test_builders_match_legacy(void) {
+    std::mt19937 rng(0xB01Du);
+    char buf[ProtocolCodec::kMaxFrameLen];
+
+    auto check = [&](const String &expected, size_t len) {
+        TEST_ASSERT_EQUAL_size_t(expected.length(), len);
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), buf);
+    };
+
+    check(legacy_protocol::buildHostGetStatus(), ProtocolCodec::buildHostGetStatus(buf, sizeof(buf)));
+    check(legacy_protocol::buildHostPing(), ProtocolCodec::buildHostPing(buf, sizeof(buf)));
+    check(legacy_protocol::buildHostRst(), ProtocolCodec::buildHostRst(buf, sizeof(buf)));
+    check(legacy_protocol::buildClientPong(), ProtocolCodec::buildClientPong(buf, sizeof(buf)));
+    check(legacy_protocol::buildClientRst(), ProtocolCodec::buildClientRst(buf, sizeof(buf)));
+
+    static const int kErrCodes[] = {0, 1, -1, 9, 10, 99, 100, 42, -100, INT32_MAX, INT32_MIN};
+    for (int e : kErrCodes) {
+        check(legacy_protocol::buildClientErrSet(e), ProtocolCodec::buildClientErrSet(buf, sizeof(buf), e));
+    }
+
+    for (uint32_t iter = 0; iter < 20000; ++iter) {
+        const uint16_t a = (uint16_t)rng();
+        const uint16_t b = (uint16_t)rng();
+        check(legacy_protocol::buildHostSet(a), ProtocolCodec::buildHostSet(buf, sizeof(buf), a));
+        check(legacy_protocol::buildHostUpd(a, b), ProtocolCodec::buildHostUpd(buf, sizeof(buf), a, b));
+        check(legacy_protocol::buildHostTog(a), ProtocolCodec::buildHostTog(buf, sizeof(buf), a));
+        check(legacy_protocol::buildClientAckSet(a), ProtocolCodec::buildClientAckSet(buf, sizeof(buf), a));
+        check(legacy_protocol::buildClientAckUpd(a), ProtocolCodec::buildClientAckUpd(buf, sizeof(buf), a));
+        check(legacy_protocol::buildClientAckTog(a), ProtocolCodec::buildClientAckTog(buf, sizeof(buf), a));
+
+        const int e = (int)rng();
+        check(legacy_protocol::buildClientErrSet(e), ProtocolCodec::buildClientErrSet(buf, sizeof(buf), e));
+
+        ProtocolStatus st = {};
+        st.outputsMask = a;
+        for (int i = 0; i < 4; ++i) {
+            st.adcRaw[i] = (int16_t)rng();
+        }
+        st.tempHotspot_dC = (int16_t)rng();
+        st.tempChamber_dC = (int16_t)(rng() % 3000);
+        check(legacy_protocol::buildClientStatus(st), ProtocolCodec::buildClientStatus(buf, sizeof(buf), st));
+
+        // String wrappers produce the same text.
+        TEST_ASSERT_TRUE(ProtocolCodec::buildClientStatus(st) == legacy_protocol::buildClientStatus(st));
+    }
+}
+
+void test_builders_respect_capacity(void) {
+    ProtocolStatus worst = {};
+    worst.outputsMask = 0xFFFF;
+    for (int i = 0; i < 4; ++i) {
+        worst.adcRaw[i] = INT16_MIN;
+    }
+    worst.tempHotspot_dC = INT16_MIN;
+    worst.tempChamber_dC = INT16_MIN;
+
+    char buf[ProtocolCodec::kMaxFrameLen];
+    const size_t len = ProtocolCodec::buildClientStatus(buf, sizeof(buf), worst);
+    TEST_ASSERT_EQUAL_size_t(57, len);
+    TEST_ASSERT_LESS_THAN(ProtocolCodec::kMaxFrameLen, len);
+
+    // Exact fit (len + NUL) works, one byte less fails and sends nothing.
+    char exact[58];
+    TEST_ASSERT_EQUAL_size_t(57, ProtocolCodec::buildClientStatus(exact, sizeof(exact), worst));
+    TEST_ASSERT_EQUAL_size_t(0, ProtocolCodec::buildClientStatus(exact, sizeof(exact) - 1, worst));
+    TEST_ASSERT_EQUAL_size_t(0, ProtocolCodec::buildHostSet(buf, 4, 0x1234));
+    TEST_ASSERT_EQUAL_size_t(0, ProtocolCodec::buildHostPing(nullptr, 64));
+}
+
+void test_benchmark_build(void) {
+    using clock = std::chrono::steady_clock;
+    static constexpr uint32_t kBuildFrames = 300000;
+
+    ProtocolStatus st;
+    st.outputsMask = 0x0019;
+    st.adcRaw[0] = 12345;
+    st.adcRaw[1] = 23456;
+    st.adcRaw[2] = 0;
+    st.adcRaw[3] = 0;
+    st.tempHotspot_dC = 1120;
+    st.tempChamber_dC = 452;
+
+    volatile size_t sink = 0;
+
+    // --- legacy String builders (poll cycle: SET/UPD + GET + PING, client STATUS + ACK) ---
+    uint32_t allocs0 = arduino_native::string_heap_allocs();
+    auto t0 = clock::now();
+    for (uint32_t i = 0; i < kBuildFrames; ++i) {
+        switch (i % 5) {
+        case 0:
+            sink += legacy_protocol::buildHostUpd((uint16_t)i, 0x0100).length();
+            break;
+        case 1:
+            sink += legacy_protocol::buildHostGetStatus().length();
+            break;
+        case 2:
+            sink += legacy_protocol::buildHostPing().length();
+            break;
+        case 3:
+            sink += legacy_protocol::buildClientStatus(st).length();
+            break;
+        default:
+            sink += legacy_protocol::buildClientAckUpd((uint16_t)i).length();
+            break;
+        }
+    }
+    const double legacySec = std::chrono::duration<double>(clock::now() - t0).count();
+    const double legacyAllocs = double(arduino_native::string_heap_allocs() - allocs0) / kBuildFrames;
+
+    // --- buffer builders ---
+    allocs0 = arduino_native::string_heap_allocs();
+    t0 = clock::now();
+    for (uint32_t i = 0; i < kBuildFrames; ++i) {
+        char buf[ProtocolCodec::kMaxFrameLen];
+        switch (i % 5) {
+        case 0:
+            sink += ProtocolCodec::buildHostUpd(buf, sizeof(buf), (uint16_t)i, 0x0100);
+            break;
+        case 1:
+            sink += ProtocolCodec::buildHostGetStatus(buf, sizeof(buf));
+            break;
+        case 2:
+            sink += ProtocolCodec::buildHostPing(buf, sizeof(buf));
+            break;
+        case 3:
+            sink += ProtocolCodec::buildClientStatus(buf, sizeof(buf), st);
+            break;
+        default:
+            sink += ProtocolCodec::buildClientAckUpd(buf, sizeof(buf), (uint16_t)i);
+            break;
+        }
+    }
+    const double bufSec = std::chrono::duration<double>(clock::now() - t0).count();
+    const double bufAllocs = double(arduino_native::string_heap_allocs() - allocs0) / kBuildFrames;
+
+    char line[192];
+    snprintf(line, sizeof(line), "[BENCH] legacy String build: %10.0f frames/s, %5.2f allocs/frame",
+             kBuildFrames / legacySec, legacyAllocs);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "[BENCH] buffer build       : %10.0f frames/s, %5.2f allocs/frame (x%.1f)",
+             kBuildFrames / bufSec, bufAllocs, legacySec / bufSec);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_GREATER_THAN(0, (int)sink);
+    TEST_ASSERT_EQUAL(0, (int)(bufAllocs * 1000));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_valid_frames_decode);
+    RUN_TEST(test_edge_cases_match_legacy);
+    RUN_TEST(test_random_mutations_match_legacy);
+    RUN_TEST(test_span_parser_is_allocation_free);
+    RUN_TEST(test_benchmark_parse);
+    RUN_TEST(test_builders_match_legacy);
+    RUN_TEST(test_builders_respect_capacity);
+    RUN_TEST(test_benchmark_build);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,465 @@
+// ============================================================================
+//  test_native_protocol_bin / test_main.cpp
+//
+//  Native (PC) tests for the binary link mode (COBS + CRC16).
+//
+//  - CRC16 / COBS primitives
+//  - Round trip of every ProtocolMessageType, corruption detection
+//  - Bytes on the wire and worst-case decode time: ASCII vs. binary
+//  - HostComm <-> ClientComm negotiation after linkSynced() and fallback to
+//    ASCII when the client does not answer H;BIN
+//
+//  Run:
+//    pio test -e native -f test_native_protocol_bin -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "delay_link.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+static ProtocolMessage make_msg(ProtocolMessageType type) {
+    ProtocolMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = type;
+    return msg;
+}
+
+static ProtocolStatus typical_status() {
+    ProtocolStatus st = {};
+    st.outputsMask = 0x0019;
+    st.adcRaw[0] = 12345;
+    st.adcRaw[1] = 23456;
+    st.adcRaw[2] = 0;
+    st.adcRaw[3] = 0;
+    st.tempHotspot_dC = 1120;
+    st.tempChamber_dC = 452;
+    return st;
+}
+
+static ProtocolStatus worst_status() {
+    ProtocolStatus st = {};
+    st.outputsMask = 0xFFFF;
+    for (int i = 0; i < 4; ++i) {
+        st.adcRaw[i] = INT16_MIN;
+    }
+    st.tempHotspot_dC = INT16_MIN;
+    st.tempChamber_dC = INT16_MIN;
+    return st;
+}
+
+// Strip the two delimiters of an encoded frame -> COBS block.
+static bool decode_frame(const uint8_t *frame, size_t len, ProtocolMessage &msg) {
+    if (len < 2 || frame[0] != 0 || frame[len - 1] != 0) {
+        return false;
+    }
+    return ProtocolBinCodec::decode(frame + 1, len - 2, msg);
+}
+
+static void assert_same(const ProtocolMessage &a, const ProtocolMessage &b) {
+    TEST_ASSERT_EQUAL((int)a.type, (int)b.type);
+    TEST_ASSERT_EQUAL_HEX16(a.mask, b.mask);
+    TEST_ASSERT_EQUAL_HEX16(a.maskB, b.maskB);
+    TEST_ASSERT_EQUAL_INT(a.errorCode, b.errorCode);
+    if (a.type == ProtocolMessageType::ClientStatus || a.type == ProtocolMessageType::ClientAckAct) {
+        TEST_ASSERT_EQUAL_MEMORY(&a.status, &b.status, sizeof(ProtocolStatus));
+    }
+}
+
+static const ProtocolMessageType kAllTypes[] = {
+    ProtocolMessageType::HostUpd,      ProtocolMessageType::HostTog,      ProtocolMessageType::HostSet,
+    ProtocolMessageType::HostGetStatus, ProtocolMessageType::HostPing,    ProtocolMessageType::HostRst,
+    ProtocolMessageType::ClientAckUpd, ProtocolMessageType::ClientAckTog, ProtocolMessageType::ClientAckSet,
+    ProtocolMessageType::ClientErrSet, ProtocolMessageType::ClientStatus, ProtocolMessageType::ClientPong,
+    ProtocolMessageType::ClientRst,    ProtocolMessageType::HostBin,      ProtocolMessageType::ClientAckBin,
+    ProtocolMessageType::HostSub,      ProtocolMessageType::ClientAckSub, ProtocolMessageType::HostAct,
+    ProtocolMessageType::ClientAckAct, ProtocolMessageType::HostBaud,     ProtocolMessageType::ClientAckBaud,
+};
+
+// -----------------------------------------------------------------------------
+// Link harness: HostComm on Serial1, ClientComm on Serial2 over a DelayLink
+// without latency, in 5 ms steps.
+// -----------------------------------------------------------------------------
+
+static DelayLinkConfig link_config() {
+    DelayLinkConfig cfg;
+    cfg.stepMs = 5;
+    return cfg;
+}
+
+static DelayLink g_link(Serial1, Serial2, link_config());
+
+static uint64_t link_bytes() {
+    return g_link.hostToClient().bytes + g_link.clientToHost().bytes;
+}
+
+static void fill_status_cb(ProtocolStatus &st) {
+    const ProtocolStatus t = typical_status();
+    st.adcRaw[0] = t.adcRaw[0];
+    st.adcRaw[1] = t.adcRaw[1];
+    st.tempHotspot_dC = t.tempHotspot_dC;
+    st.tempChamber_dC = t.tempChamber_dC;
+}
+
+static void run_link(HostComm &host, ClientComm &client, uint32_t ms) {
+    g_link.runForMs(host, client, ms);
+}
+
+static void sync_link(HostComm &host, ClientComm &client) {
+    for (int i = 0; i < 3 && !host.linkSynced(); ++i) {
+        host.sendPing();
+        run_link(host, client, 20);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void setUp(void) {
+    g_link.reset();
+}
+void tearDown(void) {}
+
+void test_crc16_check_value(void) {
+    const char *check = "123456789";
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, ProtocolBinCodec::crc16(reinterpret_cast<const uint8_t *>(check), 9));
+}
+
+void test_cobs_round_trip(void) {
+    std::mt19937 rng(0xC0B5u);
+    uint8_t in[600];
+    uint8_t enc[620];
+    uint8_t dec[620];
+
+    for (uint32_t iter = 0; iter < 5000; ++iter) {
+        const size_t len = rng() % 600;
+        const uint32_t zeroEvery = 1 + rng() % 300;
+        for (size_t i = 0; i < len; ++i) {
+            in[i] = (rng() % zeroEvery == 0) ? 0 : (uint8_t)(1 + rng() % 255);
+        }
+
+        const size_t n = ProtocolBinCodec::cobsEncode(in, len, enc, sizeof(enc));
+        TEST_ASSERT_GREATER_THAN(0u, n);
+        TEST_ASSERT_LESS_OR_EQUAL(len + len / 254 + 1, n);
+        for (size_t i = 0; i < n; ++i) {
+            TEST_ASSERT_NOT_EQUAL(0, enc[i]);
+        }
+
+        const size_t m = ProtocolBinCodec::cobsDecode(enc, n, dec, sizeof(dec));
+        TEST_ASSERT_EQUAL_size_t(len, m);
+        TEST_ASSERT_EQUAL_MEMORY(in, dec, len);
+    }
+
+    // Too small output buffer fails cleanly.
+    TEST_ASSERT_EQUAL_size_t(0, ProtocolBinCodec::cobsEncode(in, 100, enc, 50));
+}
+
+void test_all_types_round_trip(void) {
+    std::mt19937 rng(0xB1Au);
+    uint8_t frame[ProtocolBinCodec::kMaxFrameLen];
+
+    for (uint32_t iter = 0; iter < 2000; ++iter) {
+        for (ProtocolMessageType type : kAllTypes) {
+            ProtocolMessage in = make_msg(type);
+            switch (type) {
+            case ProtocolMessageType::HostUpd:
+            case ProtocolMessageType::HostSub:
+            case ProtocolMessageType::HostAct:
+                in.mask = (uint16_t)rng();
+                in.maskB = (uint16_t)rng();
+                break;
+            case ProtocolMessageType::ClientErrSet:
+                in.errorCode = (int)rng();
+                break;
+            case ProtocolMessageType::ClientAckAct:
+                in.mask = (uint16_t)rng();
+                in.seq = (uint8_t)(rng() % 255 + 1);
+                // fall through
+            case ProtocolMessageType::ClientStatus:
+                in.status.outputsMask = (uint16_t)rng();
+                for (int i = 0; i < 4; ++i) {
+                    in.status.adcRaw[i] = (int16_t)rng();
+                }
+                in.status.tempHotspot_dC = (int16_t)rng();
+                in.status.tempChamber_dC = (int16_t)rng();
+                if (rng() & 1) {
+                    in.status.sampleSeq = (uint16_t)(rng() % 65535 + 1);
+                    in.status.sampleAgeMs = (uint16_t)rng();
+                    in.status.sensorFaults = (uint16_t)rng();
+                }
+                break;
+            case ProtocolMessageType::HostGetStatus:
+            case ProtocolMessageType::HostPing:
+            case ProtocolMessageType::HostRst:
+            case ProtocolMessageType::ClientPong:
+            case ProtocolMessageType::ClientRst:
+                break;
+            default:
+                in.mask = (uint16_t)rng();
+                break;
+            }
+
+            const size_t len = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+            TEST_ASSERT_GREATER_THAN(2u, len);
+            TEST_ASSERT_LESS_OR_EQUAL(ProtocolBinCodec::kMaxFrameLen, len);
+
+            ProtocolMessage out;
+            TEST_ASSERT_TRUE(decode_frame(frame, len, out));
+            assert_same(in, out);
+        }
+    }
+
+    ProtocolMessage unknown = make_msg(ProtocolMessageType::Unknown);
+    TEST_ASSERT_EQUAL_size_t(0, ProtocolBinCodec::encode(unknown, frame, sizeof(frame)));
+}
+
+void test_corruption_is_detected(void) {
+    ProtocolMessage in = make_msg(ProtocolMessageType::ClientStatus);
+    in.status = typical_status();
+
+    uint8_t frame[ProtocolBinCodec::kMaxFrameLen];
+    const size_t len = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+    const uint8_t *block = frame + 1;
+    const size_t blockLen = len - 2;
+
+    // Every single-bit error inside the block is rejected.
+    uint8_t bad[ProtocolBinCodec::kMaxCobsLen];
+    for (size_t i = 0; i < blockLen; ++i) {
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            memcpy(bad, block, blockLen);
+            bad[i] ^= (uint8_t)(1u << bit);
+            ProtocolMessage out;
+            TEST_ASSERT_FALSE(ProtocolBinCodec::decode(bad, blockLen, out));
+        }
+    }
+
+    // Truncated / extended blocks are rejected.
+    ProtocolMessage out;
+    TEST_ASSERT_FALSE(ProtocolBinCodec::decode(block, blockLen - 1, out));
+    memcpy(bad, block, blockLen);
+    TEST_ASSERT_FALSE(ProtocolBinCodec::decode(bad, 1, out));
+    TEST_ASSERT_FALSE(ProtocolBinCodec::decode(nullptr, 0, out));
+}
+
+void test_rx_assembler_resyncs(void) {
+    ProtocolMessage in = make_msg(ProtocolMessageType::ClientAckSet);
+    in.mask = 0x0019;
+    uint8_t frame[ProtocolBinCodec::kMaxFrameLen];
+    const size_t len = ProtocolBinCodec::encode(in, frame, sizeof(frame));
+
+    ProtocolBinRx rx;
+    uint32_t frames = 0;
+    uint32_t ascii = 0;
+    auto feed = [&](const uint8_t *p, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            switch (rx.accept(p[i])) {
+            case ProtocolBinRx::Result::Frame: {
+                ProtocolMessage out;
+                if (ProtocolBinCodec::decode(rx.block(), rx.blockLen(), out)) {
+                    frames++;
+                }
+                break;
+            }
+            case ProtocolBinRx::Result::NotBinary:
+                ascii++;
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    // ASCII line, then two binary frames, then ASCII again.
+    feed(reinterpret_cast<const uint8_t *>("C;PONG\r\n"), 8);
+    feed(frame, len);
+    feed(frame, len);
+    feed(reinterpret_cast<const uint8_t *>("C;PONG\r\n"), 8);
+    TEST_ASSERT_EQUAL_UINT32(2, frames);
+    TEST_ASSERT_EQUAL_UINT32(16, ascii);
+
+    // Lost leading delimiter: one frame is lost, the next one decodes again.
+    frames = 0;
+    feed(frame + 1, len - 1);
+    feed(frame, len);
+    feed(frame, len);
+    TEST_ASSERT_GREATER_OR_EQUAL(1u, frames);
+}
+
+void test_bytes_on_wire_and_decode_time(void) {
+    using clock = std::chrono::steady_clock;
+
+    struct Case {
+        const char *name;
+        ProtocolMessage msg;
+    };
+    std::vector<Case> cases;
+    ProtocolMessage m = make_msg(ProtocolMessageType::ClientStatus);
+    m.status = typical_status();
+    cases.push_back({"STATUS typ", m});
+    m.status = worst_status();
+    cases.push_back({"STATUS max", m});
+    m = make_msg(ProtocolMessageType::ClientAckUpd);
+    m.mask = 0x0019;
+    cases.push_back({"ACK UPD", m});
+    m = make_msg(ProtocolMessageType::HostUpd);
+    m.mask = 0x0011;
+    m.maskB = 0x0100;
+    cases.push_back({"UPD", m});
+    cases.push_back({"PING", make_msg(ProtocolMessageType::HostPing)});
+
+    TEST_MESSAGE("[BENCH] frame        ASCII  BIN   (bytes on wire)");
+    for (const Case &c : cases) {
+        char ascii[ProtocolCodec::kMaxFrameLen];
+        uint8_t bin[ProtocolBinCodec::kMaxFrameLen];
+        const size_t a = ProtocolCodec::buildFrame(ascii, sizeof(ascii), c.msg);
+        const size_t b = ProtocolBinCodec::encode(c.msg, bin, sizeof(bin));
+        char line[128];
+        snprintf(line, sizeof(line), "[BENCH] %-11s %5u %5u", c.name, (unsigned)a, (unsigned)b);
+        TEST_MESSAGE(line);
+        TEST_ASSERT_GREATER_THAN(0u, a);
+        TEST_ASSERT_GREATER_THAN(0u, b);
+    }
+
+    // Typical STATUS must be at most half the ASCII size.
+    {
+        char ascii[ProtocolCodec::kMaxFrameLen];
+        uint8_t bin[ProtocolBinCodec::kMaxFrameLen];
+        const size_t a = ProtocolCodec::buildFrame(ascii, sizeof(ascii), cases[0].msg);
+        const size_t b = ProtocolBinCodec::encode(cases[0].msg, bin, sizeof(bin));
+        TEST_ASSERT_LESS_OR_EQUAL(a / 2, b);
+    }
+
+    // Worst-case decode time: the longest STATUS frame in both encodings.
+    char ascii[ProtocolCodec::kMaxFrameLen];
+    const size_t asciiLen = ProtocolCodec::buildFrame(ascii, sizeof(ascii), cases[1].msg) - 2; // no CRLF
+    uint8_t bin[ProtocolBinCodec::kMaxFrameLen];
+    const size_t binLen = ProtocolBinCodec::encode(cases[1].msg, bin, sizeof(bin));
+
+    static constexpr uint32_t kRounds = 2000;
+    static constexpr uint32_t kBatch = 100;
+    double worstAscii = 0.0;
+    double worstBin = 0.0;
+    volatile uint32_t sink = 0;
+    for (uint32_t r = 0; r < kRounds; ++r) {
+        ProtocolMessage out;
+        auto t0 = clock::now();
+        for (uint32_t i = 0; i < kBatch; ++i) {
+            sink += ProtocolCodec::parseFrame(ascii, asciiLen, out);
+        }
+        auto t1 = clock::now();
+        for (uint32_t i = 0; i < kBatch; ++i) {
+            sink += ProtocolBinCodec::decode(bin + 1, binLen - 2, out);
+        }
+        auto t2 = clock::now();
+        worstAscii = std::max(worstAscii, std::chrono::duration<double, std::nano>(t1 - t0).count() / kBatch);
+        worstBin = std::max(worstBin, std::chrono::duration<double, std::nano>(t2 - t1).count() / kBatch);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2u * kRounds * kBatch, (uint32_t)sink);
+
+    char line[128];
+    snprintf(line, sizeof(line), "[BENCH] worst-case decode STATUS: ASCII %.0f ns, BIN %.0f ns", worstAscii, worstBin);
+    TEST_MESSAGE(line);
+}
+
+void test_link_negotiates_binary_after_sync(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 1, 2);
+    host.begin(115200, 1, 2);
+    client.begin(115200);
+    client.setFillStatusCallback(fill_status_cb);
+    host.setBinaryModeEnabled(true);
+
+    // Nothing is negotiated before the link is synced.
+    run_link(host, client, 50);
+    TEST_ASSERT_FALSE(host.binaryActive());
+
+    sync_link(host, client);
+    TEST_ASSERT_TRUE(host.linkSynced());
+    run_link(host, client, 50);
+    TEST_ASSERT_TRUE(host.binaryActive());
+    TEST_ASSERT_TRUE(client.binaryActive());
+
+    // Poll STATUS in binary; ASCII semantics (hasNewStatus) unchanged.
+    const uint64_t bytes0 = link_bytes();
+    const uint32_t bin0 = host.binFrameCount();
+    for (int i = 0; i < 10; ++i) {
+        host.requestStatus();
+        run_link(host, client, 10);
+        TEST_ASSERT_TRUE(host.hasNewStatus());
+        host.clearNewStatusFlag();
+    }
+    const uint64_t binBytes = link_bytes() - bytes0;
+    TEST_ASSERT_EQUAL_UINT32(bin0 + 10, host.binFrameCount());
+    TEST_ASSERT_EQUAL_INT16(typical_status().tempChamber_dC, host.getRemoteStatus().tempChamber_dC);
+    TEST_ASSERT_EQUAL_INT16(typical_status().adcRaw[1], host.getRemoteStatus().adcRaw[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, host.binErrorCount());
+
+    // Commands still round-trip (ACK in binary).
+    host.updOutputs(0x0001, 0x0000);
+    run_link(host, client, 10);
+    TEST_ASSERT_TRUE(host.lastUpdAcked());
+    TEST_ASSERT_EQUAL_HEX16(0x0001, client.getOutputsMask());
+
+    // Link loss resets to ASCII.
+    host.clearLinkSync();
+    TEST_ASSERT_FALSE(host.binaryActive());
+
+    char line[96];
+    snprintf(line, sizeof(line), "[BENCH] 10 GET/STATUS round trips in binary: %u bytes", (unsigned)binBytes);
+    TEST_MESSAGE(line);
+}
+
+void test_link_falls_back_to_ascii(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 1, 2);
+    host.begin(115200, 1, 2);
+    client.begin(115200);
+    client.setFillStatusCallback(fill_status_cb);
+    host.setBinaryModeEnabled(true);
+
+    g_link.hostToClient().dropPrefix = "H;BIN;"; // client never sees H;BIN
+    g_link.hostToClient().dropCount = -1;
+    sync_link(host, client);
+    TEST_ASSERT_TRUE(host.linkSynced());
+
+    run_link(host, client, 2000);
+    TEST_ASSERT_FALSE(host.binaryActive());
+    TEST_ASSERT_FALSE(client.binaryActive());
+
+    // ASCII keeps working.
+    host.requestStatus();
+    run_link(host, client, 10);
+    TEST_ASSERT_TRUE(host.hasNewStatus());
+    TEST_ASSERT_EQUAL_UINT32(0, host.binFrameCount());
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_cobs_round_trip);
+    RUN_TEST(test_all_types_round_trip);
+    RUN_TEST(test_corruption_is_detected);
+    RUN_TEST(test_rx_assembler_resyncs);
+    RUN_TEST(test_bytes_on_wire_and_decode_time);
+    RUN_TEST(test_link_negotiates_binary_after_sync);
+    RUN_TEST(test_link_falls_back_to_ascii);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,499 @@
+// ============================================================================
+//  test_native_run_history / test_main.cpp
+//
+//  Native (PC) tests for the run history store (run_history.h) on a
+//  file-backed NOR flash (test/native_support/file_flash.h). The flash is
+//  strict: programming a byte that is not erased fails, so a store that
+//  rewrote anything in place would fail here.
+//
+//  - record codec: round-trip, extremes, a flipped bit or an erased slot is
+//    not a record
+//  - append, reopen the file, mount: same runs, run ids go on
+//  - aggregate() against a brute-force sum over random runs and random time
+//    ranges; only the sectors at the edges of a range are scanned
+//  - power cut at every byte of a run that closes a sector (index write,
+//    erase, header, record), unwrapped and wrapped ring: the remount agrees
+//    with itself, the run is there or pending, the next runs append
+//  - a run without a summary is pending after a reboot
+//  - wrap: the oldest sector goes, every sector is erased once per lap
+//  - more presets in a sector than index entries: the sector is scanned
+//  - benchmark: per-preset statistics over a full 350-sector partition
+//    against scanning every record; mount cost
+//
+//  Run:
+//    pio test -e native -f test_native_run_history -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "file_flash.h"
+#include "run_history.h"
+
+using run_history::QueryCost;
+using run_history::RunAggregate;
+using run_history::Store;
+
+static const char *kPath = "/tmp/test_native_run_history.bin";
+static constexpr uint32_t kSmallSector = 1024; // 7 record slots per sector
+static constexpr uint8_t kPresets = 27;         // kPresetCount in oven.h
+
+static RunSummary make_run(uint32_t start_s, uint8_t preset, uint32_t i) {
+    RunSummary r{};
+    r.start_s = start_s;
+    r.preset = preset;
+    r.profile = static_cast<uint8_t>(i % 5u);
+    r.target_dC = static_cast<int16_t>(400 + preset * 10);
+    r.duration_s = 600u + (i * 37u) % 20000u;
+    r.timeToTarget_s = (i % 7u == 3u) ? RUN_HISTORY_NOT_REACHED : 300u + (i * 13u) % 1500u;
+    r.overshoot_dC = static_cast<int16_t>(static_cast<int32_t>(i * 11u % 61u) - 20);
+    r.energy_Wh = static_cast<uint16_t>(50u + (i * 29u) % 900u);
+    r.reason = static_cast<uint8_t>((i % 11u == 5u) ? RUN_END_USER_STOP : RUN_END_COMPLETED);
+    r.flags = static_cast<uint8_t>(i % 16u);
+    return r;
+}
+
+// Field by field: RunSummary has padding.
+static void assert_run_equal(const RunSummary &want, const RunSummary &got) {
+    TEST_ASSERT_EQUAL_UINT32(want.runId, got.runId);
+    TEST_ASSERT_EQUAL_UINT32(want.start_s, got.start_s);
+    TEST_ASSERT_EQUAL_UINT32(want.duration_s, got.duration_s);
+    TEST_ASSERT_EQUAL_UINT32(want.timeToTarget_s, got.timeToTarget_s);
+    TEST_ASSERT_EQUAL_UINT16(want.energy_Wh, got.energy_Wh);
+    TEST_ASSERT_EQUAL_INT16(want.overshoot_dC, got.overshoot_dC);
+    TEST_ASSERT_EQUAL_INT16(want.target_dC, got.target_dC);
+    TEST_ASSERT_EQUAL_UINT8(want.preset, got.preset);
+    TEST_ASSERT_EQUAL_UINT8(want.profile, got.profile);
+    TEST_ASSERT_EQUAL_UINT8(want.reason, got.reason);
+    TEST_ASSERT_EQUAL_UINT8(want.flags, got.flags);
+}
+
+static bool run_once(Store &store, RunSummary &r) { return store.beginRun(r) && store.endRun(r); }
+
+static RunAggregate brute_force(const std::vector<RunSummary> &runs, uint8_t preset, uint32_t from_s, uint32_t to_s) {
+    RunAggregate a = RunAggregate();
+    for (const RunSummary &r : runs) {
+        if (r.start_s >= from_s && r.start_s <= to_s && (preset == run_history::kAnyPreset || r.preset == preset)) {
+            a.add(r);
+        }
+    }
+    return a;
+}
+
+static void assert_aggregate_equal(const RunAggregate &want, const RunAggregate &got) {
+    TEST_ASSERT_EQUAL_UINT32(want.runs, got.runs);
+    TEST_ASSERT_EQUAL_UINT32(want.reached, got.reached);
+    TEST_ASSERT_EQUAL_UINT32(want.aborted, got.aborted);
+    TEST_ASSERT_EQUAL_UINT32(want.sumTimeToTarget_s, got.sumTimeToTarget_s);
+    TEST_ASSERT_EQUAL_UINT32(want.sumOvershoot_dC, got.sumOvershoot_dC);
+    TEST_ASSERT_EQUAL_UINT32(want.sumEnergy_Wh, got.sumEnergy_Wh);
+    TEST_ASSERT_EQUAL_UINT32(want.sumDuration_s, got.sumDuration_s);
+    TEST_ASSERT_EQUAL_INT16(want.maxOvershoot_dC, got.maxOvershoot_dC);
+}
+
+// Every summary the store holds, oldest first.
+static std::vector<RunSummary> held_runs(Store &store) {
+    std::vector<RunSummary> out(RUN_HISTORY_MAX_SECTORS * 128u);
+    out.resize(store.recent(out.data(), out.size()));
+    return std::vector<RunSummary>(out.rbegin(), out.rend());
+}
+
+// The indexes and the RAM sums agree with the records they summarise.
+static void assert_consistent(Store &store) {
+    const std::vector<RunSummary> runs = held_runs(store);
+    RunAggregate all;
+    TEST_ASSERT_TRUE(store.aggregate(run_history::kAnyPreset, 0, 0xFFFFFFFFu, &all));
+    assert_aggregate_equal(brute_force(runs, run_history::kAnyPreset, 0, 0xFFFFFFFFu), all);
+    for (size_t i = 1; i < runs.size(); ++i) {
+        TEST_ASSERT_TRUE(runs[i].runId > runs[i - 1].runId);
+    }
+}
+
+void setUp(void) { remove(kPath); }
+void tearDown(void) { remove(kPath); }
+
+// ----------------------------------------------------------------------------
+
+void test_record_codec(void) {
+    RunSummary r = make_run(0xFFFFFFF0u, 26, 3);
+    r.runId = 0xFFFFFFFEu;
+    r.overshoot_dC = -32768;
+    r.target_dC = 32767;
+    r.energy_Wh = 0xFFFF;
+    uint8_t rec[run_history::kRecordBytes];
+    run_history::encodeRecord(rec, run_history::kRecordEnd, r);
+
+    run_history::RecordKind kind;
+    RunSummary back{};
+    TEST_ASSERT_TRUE(run_history::decodeRecord(rec, &kind, &back));
+    TEST_ASSERT_EQUAL_UINT8(run_history::kRecordEnd, kind);
+    assert_run_equal(r, back);
+
+    for (size_t bit = 0; bit < 8 * sizeof(rec); ++bit) {
+        rec[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+        TEST_ASSERT_FALSE(run_history::decodeRecord(rec, &kind, &back));
+        rec[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+    }
+    memset(rec, 0xFF, sizeof(rec));
+    TEST_ASSERT_FALSE(run_history::decodeRecord(rec, &kind, &back));
+}
+
+void test_append_and_remount(void) {
+    std::vector<RunSummary> runs;
+    {
+        FileFlash flash(kPath, kSmallSector, 16);
+        std::unique_ptr<Store> store(new Store());
+        TEST_ASSERT_TRUE(store->mount(&flash));
+        TEST_ASSERT_EQUAL_UINT32(0u, store->stats().sectorsHeld);
+        for (uint32_t i = 0; i < 20; ++i) {
+            RunSummary r = make_run(1000u + i * 3600u, static_cast<uint8_t>(i % 4u), i);
+            TEST_ASSERT_TRUE(run_once(*store, r));
+            TEST_ASSERT_EQUAL_UINT32(i + 1u, r.runId);
+            runs.push_back(r);
+        }
+        TEST_ASSERT_EQUAL_UINT32(0u, flash.reprograms());
+    }
+
+    FileFlash flash(kPath, kSmallSector, 16); // the file as a reboot finds it
+    std::unique_ptr<Store> store(new Store());
+    TEST_ASSERT_TRUE(store->mount(&flash));
+    TEST_ASSERT_FALSE(store->pendingRun(nullptr));
+    TEST_ASSERT_EQUAL_UINT32(21u, store->nextRunId());
+
+    const Store::Stats st = store->stats();
+    TEST_ASSERT_EQUAL_UINT32(20u, st.runs);
+    TEST_ASSERT_EQUAL_UINT32(1000u, st.oldest_s);
+    TEST_ASSERT_EQUAL_UINT32(1000u + 19u * 3600u, st.newest_s);
+    TEST_ASSERT_EQUAL_UINT32(0u, st.torn);
+
+    const std::vector<RunSummary> held = held_runs(*store);
+    TEST_ASSERT_EQUAL_size_t(runs.size(), held.size());
+    for (size_t i = 0; i < runs.size(); ++i) {
+        assert_run_equal(runs[i], held[i]);
+    }
+    for (uint8_t p = 0; p < 4; ++p) {
+        RunAggregate a;
+        TEST_ASSERT_TRUE(store->aggregate(p, 0, 0xFFFFFFFFu, &a));
+        assert_aggregate_equal(brute_force(runs, p, 0, 0xFFFFFFFFu), a);
+    }
+
+    RunSummary next = make_run(200000u, 1, 99);
+    TEST_ASSERT_TRUE(run_once(*store, next));
+    TEST_ASSERT_EQUAL_UINT32(21u, next.runId);
+    TEST_ASSERT_EQUAL_UINT32(0u, flash.reprograms());
+}
+
+void test_aggregate_against_brute_force(void) {
+    FileFlash flash(kPath, 4096, 48);
+    std::unique_ptr<Store> store(new Store());
+    TEST_ASSERT_TRUE(store->mount(&flash));
+
+    std::mt19937 rng(25);
+    std::vector<RunSummary> runs;
+    uint32_t t = 1700000000u;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        t += 1800u + rng() % 90000u;
+        RunSummary r = make_run(t, static_cast<uint8_t>(rng() % kPresets), i);
+        TEST_ASSERT_TRUE(run_once(*store, r));
+        runs.push_back(r);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0u, flash.reprograms());
+    TEST_ASSERT_EQUAL_UINT32(2000u, store->stats().runs);
+
+    const uint32_t t0 = runs.front().start_s;
+    const uint32_t span = runs.back().start_s - t0;
+    for (int q = 0; q < 300; ++q) {
+        uint32_t a = t0 - 1000u + rng() % (span + 2000u);
+        uint32_t b = t0 - 1000u + rng() % (span + 2000u);
+        if (a > b) {
+            std::swap(a, b);
+        }
+        const uint8_t preset = (q % 4 == 0) ? run_history::kAnyPreset : static_cast<uint8_t>(rng() % kPresets);
+        RunAggregate got;
+        QueryCost cost;
+        TEST_ASSERT_TRUE(store->aggregate(preset, a, b, &got, &cost));
+        assert_aggregate_equal(brute_force(runs, preset, a, b), got);
+        TEST_ASSERT_TRUE(cost.sectorsScanned <= 2u); // the two edge sectors
+    }
+
+    // Everything but the open sector comes from the indexes.
+    RunAggregate got;
+    QueryCost cost;
+    TEST_ASSERT_TRUE(store->aggregate(run_history::kAnyPreset, 0, 0xFFFFFFFFu, &got, &cost));
+    assert_aggregate_equal(brute_force(runs, run_history::kAnyPreset, 0, 0xFFFFFFFFu), got);
+    TEST_ASSERT_EQUAL_UINT32(store->stats().sectorsHeld - 1u, cost.sectorsFromIndex);
+    TEST_ASSERT_EQUAL_UINT32(0u, cost.sectorsScanned);
+}
+
+// Cuts the power n bytes into the run that closes the open sector, for
+// every n until the run goes through; reboots and checks the store.
+static void power_cut_sweep(uint32_t sectors, uint32_t baseRuns) {
+    std::vector<RunSummary> base;
+    std::vector<uint8_t> image;
+    uint32_t oldestRuns = 0;
+    remove(kPath);
+    {
+        FileFlash flash(kPath, kSmallSector, sectors);
+        std::unique_ptr<Store> store(new Store());
+        TEST_ASSERT_TRUE(store->mount(&flash));
+        for (uint32_t i = 0; i < baseRuns; ++i) {
+            RunSummary r = make_run(5000u + i * 100u, static_cast<uint8_t>(i % 3u), i);
+            TEST_ASSERT_TRUE(run_once(*store, r));
+            base.push_back(r);
+        }
+        const std::vector<RunSummary> held = held_runs(*store);
+        RunSummary r = make_run(5000u + baseRuns * 100u, 2, baseRuns);
+        TEST_ASSERT_TRUE(store->beginRun(r)); // fills the sector; its end record opens the next one
+        image.assign(flash.raw(0), flash.raw(0) + kSmallSector * sectors);
+        oldestRuns = static_cast<uint32_t>(base.size() - held.size());
+        base.assign(held.begin(), held.end());
+    }
+    const size_t slots = (kSmallSector - run_history::kHeaderBytes - run_history::kIndexBytes) / run_history::kRecordBytes;
+    const uint32_t perSector = static_cast<uint32_t>(slots / 2u);
+    const bool wrapped = oldestRuns > 0;
+
+    uint32_t cuts = 0;
+    for (size_t cut = 0;; ++cut) {
+        FILE *f = fopen(kPath, "r+b"); // back to the image before the run
+        TEST_ASSERT_TRUE(f != nullptr);
+        fwrite(image.data(), 1, image.size(), f);
+        fclose(f);
+        FileFlash flash(kPath, kSmallSector, sectors);
+        std::unique_ptr<Store> store(new Store());
+        TEST_ASSERT_TRUE(store->mount(&flash));
+        RunSummary pending;
+        TEST_ASSERT_TRUE(store->pendingRun(&pending));
+
+        RunSummary r = pending;
+        r.duration_s = 7200;
+        r.reason = RUN_END_COMPLETED;
+        flash.powerCutAfter(cut);
+        const bool ok = store->endRun(r);
+        if (!flash.dead()) {
+            TEST_ASSERT_TRUE(ok);
+            break;
+        }
+        cuts++;
+        flash.reboot();
+
+        std::unique_ptr<Store> again(new Store());
+        TEST_ASSERT_TRUE(again->mount(&flash));
+        assert_consistent(*again);
+        const std::vector<RunSummary> held = held_runs(*again);
+        const bool landed = !held.empty() && held.back().runId == r.runId;
+        TEST_ASSERT_EQUAL(!landed, again->pendingRun(nullptr));
+        if (!wrapped) {
+            std::vector<RunSummary> want = base;
+            if (landed) {
+                want.push_back(r);
+            }
+            TEST_ASSERT_EQUAL_size_t(want.size(), held.size());
+        } else {
+            TEST_ASSERT_TRUE(held.size() + 2u * perSector >= base.size());
+        }
+
+        // Life goes on: the next runs append and survive another reboot.
+        for (uint32_t i = 0; i < 2u * perSector + 1u; ++i) {
+            RunSummary next = make_run(900000u + i, 1, i);
+            TEST_ASSERT_TRUE(run_once(*again, next));
+            TEST_ASSERT_TRUE(next.runId > r.runId);
+        }
+        std::unique_ptr<Store> third(new Store());
+        TEST_ASSERT_TRUE(third->mount(&flash));
+        assert_consistent(*third);
+        TEST_ASSERT_FALSE(third->pendingRun(nullptr));
+        TEST_ASSERT_EQUAL_UINT32(0u, flash.reprograms());
+    }
+    // index (<= 768 B) + erase (1024 B) + header + record
+    TEST_ASSERT_TRUE(cuts > kSmallSector);
+}
+
+void test_power_cut_at_every_byte(void) {
+    // 2 * runs + 1 records fill whole sectors of 7 slots: the end record of
+    // the last run opens a sector.
+    power_cut_sweep(8, 3);  // ring not full yet
+    power_cut_sweep(4, 17); // the new sector evicts the oldest
+}
+
+void test_pending_run_is_power_loss(void) {
+    {
+        FileFlash flash(kPath, kSmallSector, 4);
+        std::unique_ptr<Store> store(new Store());
+        TEST_ASSERT_TRUE(store->mount(&flash));
+        RunSummary r = make_run(100, 7, 0);
+        TEST_ASSERT_TRUE(run_once(*store, r));
+        RunSummary cut = make_run(200, 8, 1);
+        TEST_ASSERT_TRUE(store->beginRun(cut));
+        TEST_ASSERT_EQUAL_UINT32(2u, cut.runId);
+    }
+    FileFlash flash(kPath, kSmallSector, 4);
+    std::unique_ptr<Store> store(new Store());
+    TEST_ASSERT_TRUE(store->mount(&flash));
+    RunSummary pending;
+    TEST_ASSERT_TRUE(store->pendingRun(&pending));
+    TEST_ASSERT_EQUAL_UINT32(2u, pending.runId);
+    TEST_ASSERT_EQUAL_UINT8(8, pending.preset);
+    TEST_ASSERT_EQUAL_UINT32(200u, pending.start_s);
+    TEST_ASSERT_EQUAL_UINT32(3u, store->nextRunId());
+
+    pending.reason = RUN_END_POWER_LOSS;
+    TEST_ASSERT_TRUE(store->endRun(pending));
+    std::unique_ptr<Store> again(new Store());
+    TEST_ASSERT_TRUE(again->mount(&flash));
+    TEST_ASSERT_FALSE(again->pendingRun(nullptr));
+    RunAggregate a;
+    TEST_ASSERT_TRUE(again->aggregate(8, 0, 0xFFFFFFFFu, &a));
+    TEST_ASSERT_EQUAL_UINT32(1u, a.runs);
+    TEST_ASSERT_EQUAL_UINT32(1u, a.aborted);
+}
+
+void test_wrap_and_wear(void) {
+    static constexpr uint32_t kSectors = 8;
+    static constexpr uint32_t kRuns = 1000;
+    FileFlash flash(kPath, kSmallSector, kSectors);
+    std::unique_ptr<Store> store(new Store());
+    TEST_ASSERT_TRUE(store->mount(&flash));
+    for (uint32_t i = 0; i < kRuns; ++i) {
+        RunSummary r = make_run(10u + i * 60u, static_cast<uint8_t>(i % 5u), i);
+        TEST_ASSERT_TRUE(run_once(*store, r));
+    }
+    const Store::Stats st = store->stats();
+    TEST_ASSERT_EQUAL_UINT32(kSectors, st.sectorsHeld);
+    // A sector holds slots / 2 or one more summaries, the open one fewer.
+    TEST_ASSERT_TRUE(st.runs >= (kSectors - 1u) * (st.slotsPerSector / 2u));
+    TEST_ASSERT_TRUE(st.runs <= kSectors * (st.slotsPerSector / 2u + 1u));
+
+    const std::vector<RunSummary> held = held_runs(*store);
+    TEST_ASSERT_EQUAL_UINT32(kRuns, held.back().runId);
+    TEST_ASSERT_EQUAL_UINT32(kRuns - held.size() + 1u, held.front().runId);
+    assert_consistent(*store);
+
+    // Round-robin: every sector erased once per lap, no sector more than
+    // one lap ahead.
+    const uint32_t opened = (2u * kRuns + st.slotsPerSector - 1u) / st.slotsPerSector;
+    uint32_t minErases = 0xFFFFFFFFu;
+    for (uint32_t s = 0; s < kSectors; ++s) {
+        minErases = flash.erases(s) < minErases ? flash.erases(s) : minErases;
+    }
+    TEST_ASSERT_TRUE(flash.maxErases() - minErases <= 1u);
+    TEST_ASSERT_TRUE(flash.maxErases() <= opened / kSectors + 1u);
+    TEST_ASSERT_EQUAL_UINT32(0u, flash.reprograms());
+
+    std::unique_ptr<Store> again(new Store());
+    TEST_ASSERT_TRUE(again->mount(&flash));
+    TEST_ASSERT_EQUAL_UINT32(kRuns + 1u, again->nextRunId());
+    assert_consistent(*again);
+}
+
+void test_index_overflow(void) {
+    FileFlash flash(kPath, 4096, 4);
+    std::unique_ptr<Store> store(new Store());
+    TEST_ASSERT_TRUE(store->mount(&flash));
+    std::vector<RunSummary> runs;
+    const uint32_t perSector = store->stats().slotsPerSector / 2u;
+    for (uint32_t i = 0; i < 2u * perSector; ++i) {
+        RunSummary r = make_run(100u + i, static_cast<uint8_t>(i % 45u), i); // 45 presets > kMaxIndexEntries
+        TEST_ASSERT_TRUE(run_once(*store, r));
+        runs.push_back(r);
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        for (uint8_t p = 0; p < 45; ++p) {
+            RunAggregate a;
+            QueryCost cost;
+            TEST_ASSERT_TRUE(store->aggregate(p, 0, 0xFFFFFFFFu, &a, &cost));
+            assert_aggregate_equal(brute_force(runs, p, 0, 0xFFFFFFFFu), a);
+            TEST_ASSERT_EQUAL_UINT32(0u, cost.sectorsFromIndex);
+        }
+        store.reset(new Store());
+        TEST_ASSERT_TRUE(store->mount(&flash));
+    }
+}
+
+void test_bench_full_partition(void) {
+    static constexpr uint32_t kSectors = 350;
+    FileFlash flash(kPath, 4096, kSectors);
+    std::unique_ptr<Store> store(new Store());
+    TEST_ASSERT_TRUE(store->mount(&flash));
+
+    std::mt19937 rng(7);
+    std::vector<RunSummary> runs;
+    uint32_t t = 1700000000u;
+    const uint32_t perSector = store->stats().slotsPerSector / 2u;
+    const uint32_t total = (kSectors - 1u) * perSector;
+    static constexpr uint8_t kFavourites[] = {5, 4, 2, 8}; // most runs use a few presets
+    for (uint32_t i = 0; i < total; ++i) {
+        t += 3600u + rng() % 40000u;
+        const uint8_t preset = (rng() % 5u) ? kFavourites[rng() % 4u] : static_cast<uint8_t>(rng() % kPresets);
+        RunSummary r = make_run(t, preset, i);
+        TEST_ASSERT_TRUE(run_once(*store, r));
+        runs.push_back(r);
+    }
+
+    store.reset(new Store());
+    const auto m0 = std::chrono::steady_clock::now();
+    TEST_ASSERT_TRUE(store->mount(&flash));
+    const double mountUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m0).count();
+    const Store::Stats st = store->stats();
+    TEST_ASSERT_EQUAL_UINT32(total, st.runs);
+
+    // A statistics screen: one aggregate per preset over all time.
+    uint64_t indexBytes = 0;
+    const auto q0 = std::chrono::steady_clock::now();
+    for (uint8_t p = 0; p < kPresets; ++p) {
+        RunAggregate a;
+        QueryCost cost;
+        TEST_ASSERT_TRUE(store->aggregate(p, 0, 0xFFFFFFFFu, &a, &cost));
+        indexBytes += cost.bytesRead;
+        TEST_ASSERT_EQUAL_UINT32(brute_force(runs, p, 0, 0xFFFFFFFFu).runs, a.runs);
+        TEST_ASSERT_EQUAL_UINT32(0u, cost.sectorsScanned);
+    }
+    const double indexUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - q0).count();
+
+    // The same from the records alone.
+    const uint64_t scan0 = flash.bytesRead();
+    const auto s0 = std::chrono::steady_clock::now();
+    const std::vector<RunSummary> held = held_runs(*store);
+    RunAggregate byPreset[kPresets] = {};
+    for (const RunSummary &r : held) {
+        byPreset[r.preset].add(r);
+    }
+    const double scanUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s0).count();
+    const uint64_t scanBytes = flash.bytesRead() - scan0;
+    TEST_ASSERT_EQUAL_size_t(runs.size(), held.size());
+
+    char msg[220];
+    snprintf(msg, sizeof(msg), "[BENCH] %lu runs in %lu x 4 KB sectors: mount %lu B read, %.0f us", (unsigned long)st.runs,
+             (unsigned long)kSectors, (unsigned long)st.mountBytesRead, mountUs);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg),
+             "[BENCH] %u per-preset aggregates: index %lu B read, %.0f us; record scan %lu B read, %.0f us (%.0fx bytes)",
+             (unsigned)kPresets, (unsigned long)indexBytes, indexUs, (unsigned long)scanBytes, scanUs,
+             static_cast<double>(scanBytes) / indexBytes);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_TRUE(indexBytes * 10u < scanBytes);
+    TEST_ASSERT_EQUAL_UINT32(0u, flash.reprograms());
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_record_codec);
+    RUN_TEST(test_append_and_remount);
+    RUN_TEST(test_aggregate_against_brute_force);
+    RUN_TEST(test_power_cut_at_every_byte);
+    RUN_TEST(test_pending_run_is_power_loss);
+    RUN_TEST(test_wrap_and_wear);
+    RUN_TEST(test_index_overflow);
+    RUN_TEST(test_bench_full_partition);
+    return UNITY_END();
+}
+
+// EOF
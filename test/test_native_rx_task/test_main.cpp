@@ -0,0 +1,417 @@
+// ============================================================================
+//  test_native_rx_task / test_main.cpp
+//
+//  Native (PC) tests for the RX task pipeline (HostRxTask + SpscRing).
+//
+//  - SpscRing: order, full/drop accounting, index wrap-around
+//  - SpscRing: 1M items through two real threads, order preserved
+//  - HostRxDecoder: same counters/state as the inline HostComm assembler
+//    for a stream of valid/junk/overlong/corrupt ASCII and binary frames
+//  - HostRxTask on a std::thread while the consumer "renders" for several
+//    milliseconds per frame: no lost or reordered frames, RX-to-apply latency
+//  - HostComm + HostRxTask end to end (what oven_comm_poll() runs)
+//  - wake callback: a consumer that sleeps until woken (host main loop)
+//    still gets every frame
+//
+//  These tests use real threads and wall-clock sleeps; the virtual Arduino
+//  clock is only touched by the test (consumer) thread.
+//
+//  Run:
+//    pio test -e native -f test_native_rx_task -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HostComm.h"
+#include "HostRxTask.h"
+#include "protocol.h"
+#include "protocol_bin.h"
+#include "spsc_ring.h"
+
+using Clock = std::chrono::steady_clock;
+
+static uint32_t g_rng = 4242;
+static uint32_t rng() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+static ProtocolStatus make_status(uint16_t seq) {
+    ProtocolStatus st = {};
+    st.outputsMask = static_cast<uint16_t>(seq * 7u);
+    st.adcRaw[0] = static_cast<int16_t>(seq);
+    st.adcRaw[1] = 100;
+    st.adcRaw[2] = -5;
+    st.adcRaw[3] = 1234;
+    st.tempHotspot_dC = 2500;
+    st.tempChamber_dC = static_cast<int16_t>(seq % 3000);
+    return st;
+}
+
+// STATUS frame for `seq`; every third frame binary-encoded.
+static std::string status_frame(uint16_t seq) {
+    if (seq % 3 == 0) {
+        ProtocolMessage msg = {};
+        msg.type = ProtocolMessageType::ClientStatus;
+        msg.status = make_status(seq);
+        uint8_t buf[ProtocolBinCodec::kMaxFrameLen];
+        const size_t n = ProtocolBinCodec::encode(msg, buf, sizeof(buf));
+        return std::string(reinterpret_cast<const char *>(buf), n);
+    }
+    char buf[ProtocolCodec::kMaxFrameLen];
+    const size_t n = ProtocolCodec::buildClientStatus(buf, sizeof(buf), make_status(seq));
+    return std::string(buf, n);
+}
+
+static void drain_serial(HardwareSerial &s) {
+    uint8_t tmp[64];
+    while (s.read(tmp, sizeof(tmp)) > 0) {
+    }
+}
+
+void setUp(void) {
+    arduino_native::set_ms(1000);
+    drain_serial(Serial1);
+    drain_serial(Serial2);
+    Serial1.clearTx();
+    Serial2.clearTx();
+}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// SpscRing
+// -----------------------------------------------------------------------------
+
+void test_ring_order_full_and_wrap() {
+    SpscRing<uint32_t, 8> ring;
+    uint32_t v = 0;
+    TEST_ASSERT_FALSE(ring.pop(v));
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_FALSE(ring.push(99)); // full
+    TEST_ASSERT_EQUAL_UINT32(1, ring.dropped());
+    TEST_ASSERT_EQUAL_UINT32(8, ring.highWater());
+
+    for (uint32_t i = 0; i < 8; ++i) {
+        TEST_ASSERT_TRUE(ring.pop(v));
+        TEST_ASSERT_EQUAL_UINT32(i, v);
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+
+    // Many laps: indices wrap around the slot array (and would wrap the
+    // 32-bit counters after 4G items in the same way).
+    uint32_t next = 0;
+    for (uint32_t lap = 0; lap < 1000; ++lap) {
+        const uint32_t burst = 1 + lap % 8;
+        for (uint32_t i = 0; i < burst; ++i) {
+            TEST_ASSERT_TRUE(ring.push(next + i));
+        }
+        for (uint32_t i = 0; i < burst; ++i) {
+            TEST_ASSERT_TRUE(ring.pop(v));
+            TEST_ASSERT_EQUAL_UINT32(next + i, v);
+        }
+        next += burst;
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, ring.dropped());
+}
+
+void test_ring_two_threads() {
+    static SpscRing<uint32_t, 64> ring;
+    constexpr uint32_t kItems = 1000000;
+
+    std::thread producer([]() {
+        for (uint32_t i = 1; i <= kItems;) {
+            if (ring.size() < 64 && ring.push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 1;
+    bool ordered = true;
+    while (expected <= kItems) {
+        uint32_t v;
+        if (ring.pop(v)) {
+            ordered = ordered && (v == expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// -----------------------------------------------------------------------------
+// HostRxDecoder vs inline HostComm
+// -----------------------------------------------------------------------------
+
+static std::string mixed_stream() {
+    std::string s;
+    for (uint16_t i = 0; i < 300; ++i) {
+        switch (rng() % 8) {
+        case 0:
+            s += "garbage\r\n"; // junk line
+            break;
+        case 1:
+            s += "xxC;PONG\r\n"; // leading junk
+            break;
+        case 2:
+            s += "C;STATUS;ZZZZ\r\n"; // parse error
+            break;
+        case 3:
+            s += std::string(130, 'A') + "\r\n"; // line overflow
+            break;
+        case 4: {
+            std::string f = status_frame(3); // binary frame ...
+            f[3] = static_cast<char>(f[3] ^ 0x10); // ... with a CRC error
+            s += f;
+            break;
+        }
+        case 5:
+            s += "  \r\n\r\n"; // empty lines
+            break;
+        default:
+            s += status_frame(i);
+            break;
+        }
+    }
+    return s;
+}
+
+// Keep consuming until the task has read `bytes` and the ring is empty.
+static void drain_task(HostComm &host, HostRxTask &task, uint32_t bytes) {
+    const auto deadline = Clock::now() + std::chrono::seconds(5);
+    while (task.rxBytes() < bytes && Clock::now() < deadline) {
+        host.loop();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    host.loop();
+}
+
+void test_decoder_matches_inline() {
+    const std::string stream = mixed_stream();
+
+    HostComm inlineHost(Serial2);
+    inlineHost.begin(115200, 0, 0);
+    inlineHost.processRxBytes(reinterpret_cast<const uint8_t *>(stream.data()), stream.size());
+    inlineHost.loop();
+
+    HostComm taskHost(Serial1);
+    taskHost.begin(115200, 0, 0);
+    HostRxTask task(Serial1);
+    TEST_ASSERT_TRUE(task.start());
+    taskHost.setRxTask(&task);
+
+    // Feed in random fragments, consuming concurrently.
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        const size_t n = std::min<size_t>(1 + rng() % 40, stream.size() - pos);
+        Serial1.inject(reinterpret_cast<const uint8_t *>(stream.data() + pos), n);
+        pos += n;
+        taskHost.loop();
+    }
+    drain_task(taskHost, task, stream.size());
+    task.stop();
+    taskHost.loop(); // task stopped: inline path, nothing left to read
+
+    TEST_ASSERT_EQUAL_UINT32(0, task.droppedEvents());
+    TEST_ASSERT_EQUAL_UINT32(inlineHost.rxBytes(), taskHost.rxBytes());
+    TEST_ASSERT_EQUAL_UINT32(inlineHost.parseFailCount(), taskHost.parseFailCount());
+    TEST_ASSERT_EQUAL_UINT32(inlineHost.binFrameCount(), taskHost.binFrameCount());
+    TEST_ASSERT_EQUAL_UINT32(inlineHost.binErrorCount(), taskHost.binErrorCount());
+    TEST_ASSERT_EQUAL_UINT32(inlineHost.statusFrameCount(), taskHost.statusFrameCount());
+    TEST_ASSERT_EQUAL_STRING(inlineHost.lastBadLine().c_str(), taskHost.lastBadLine().c_str());
+    TEST_ASSERT_EQUAL_MEMORY(&inlineHost.getRemoteStatus(), &taskHost.getRemoteStatus(), sizeof(ProtocolStatus));
+    TEST_ASSERT_GREATER_THAN(50, inlineHost.statusFrameCount());
+    TEST_ASSERT_GREATER_THAN(20, inlineHost.parseFailCount());
+}
+
+// -----------------------------------------------------------------------------
+// Threaded pipeline under render load
+// -----------------------------------------------------------------------------
+
+static constexpr uint16_t kStressFrames = 3000;
+static constexpr uint32_t kRenderMs = 6;         // consumer busy per "UI frame"
+static constexpr uint32_t kProducerBytesPerMs = 92; // 921600 baud
+
+static Clock::time_point g_injectAt[kStressFrames + 1];
+
+// Writes the frames into Serial1 paced like a 921600 baud UART.
+static void produce_frames() {
+    const auto t0 = Clock::now();
+    uint64_t sentBytes = 0;
+    for (uint16_t seq = 1; seq <= kStressFrames; ++seq) {
+        const std::string f = status_frame(seq);
+        const auto due = t0 + std::chrono::microseconds(sentBytes * 1000 / kProducerBytesPerMs);
+        std::this_thread::sleep_until(due);
+        g_injectAt[seq] = Clock::now();
+        Serial1.inject(reinterpret_cast<const uint8_t *>(f.data()), f.size());
+        sentBytes += f.size();
+    }
+}
+
+void test_task_under_render_load() {
+    HostRxTask task(Serial1);
+    TEST_ASSERT_TRUE(task.start());
+
+    std::thread producer(produce_frames);
+
+    uint16_t expected = 1;
+    uint32_t received = 0;
+    uint32_t reordered = 0;
+    uint64_t latencySumUs = 0;
+    uint64_t latencyMaxUs = 0;
+    const auto deadline = Clock::now() + std::chrono::seconds(20);
+
+    while (expected <= kStressFrames && Clock::now() < deadline) {
+        HostRxEvent ev;
+        while (task.pop(ev)) {
+            TEST_ASSERT_TRUE(ev.kind == HostRxEvent::Kind::Frame);
+            const uint16_t seq = static_cast<uint16_t>(ev.msg.status.adcRaw[0]);
+            if (seq != expected) {
+                reordered++;
+            }
+            const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - g_injectAt[seq]).count();
+            latencySumUs += us;
+            latencyMaxUs = std::max(latencyMaxUs, us);
+            received++;
+            expected = static_cast<uint16_t>(seq + 1);
+        }
+        // Fake LVGL render: the UI core is busy, the RX task keeps reading.
+        std::this_thread::sleep_for(std::chrono::milliseconds(kRenderMs));
+    }
+    producer.join();
+    task.stop();
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] %u frames @921600 with %lu ms render/loop: avg %lu us, max %lu us RX-to-consume, "
+             "queue high water %lu/%u",
+             (unsigned)received, (unsigned long)kRenderMs, (unsigned long)(latencySumUs / (received ? received : 1)),
+             (unsigned long)latencyMaxUs, (unsigned long)task.queueHighWater(), (unsigned)HostRxTask::kQueueLen);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(0, task.droppedEvents());
+    TEST_ASSERT_EQUAL_UINT32(0, reordered);
+    TEST_ASSERT_EQUAL_UINT32(kStressFrames, received);
+}
+
+void test_hostcomm_with_task_end_to_end() {
+    HostComm host(Serial1);
+    host.begin(115200, 0, 0);
+    HostRxTask task(Serial1);
+    TEST_ASSERT_TRUE(task.start());
+    host.setRxTask(&task);
+
+    std::thread producer(produce_frames);
+    const auto deadline = Clock::now() + std::chrono::seconds(20);
+    while (host.statusFrameCount() < kStressFrames && Clock::now() < deadline) {
+        host.loop();
+        arduino_native::advance_ms(kRenderMs);
+        std::this_thread::sleep_for(std::chrono::milliseconds(kRenderMs));
+    }
+    producer.join();
+    task.stop();
+
+    TEST_ASSERT_EQUAL_UINT32(kStressFrames, host.statusFrameCount());
+    TEST_ASSERT_EQUAL_UINT32(0, host.parseFailCount());
+    TEST_ASSERT_EQUAL_UINT32(0, task.droppedEvents());
+    TEST_ASSERT_EQUAL_INT16(kStressFrames, host.getRemoteStatus().adcRaw[0]);
+    TEST_ASSERT_EQUAL_UINT32(task.rxBytes(), host.rxBytes());
+}
+
+struct WakeSignal {
+    std::mutex m;
+    std::condition_variable cv;
+    bool pending = false;
+    std::atomic<uint32_t> calls{0};
+};
+
+static void wake_consumer(void *ctx) {
+    WakeSignal *w = static_cast<WakeSignal *>(ctx);
+    w->calls.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(w->m);
+        w->pending = true;
+    }
+    w->cv.notify_one();
+}
+
+void test_wake_callback_consumer_sleeps() {
+    WakeSignal wake;
+    HostRxTask task(Serial1);
+    task.setWakeCallback(wake_consumer, &wake);
+    TEST_ASSERT_TRUE(task.start());
+
+    std::thread producer(produce_frames);
+    uint32_t received = 0;
+    uint32_t timeouts = 0;
+    uint32_t loops = 0;
+    uint64_t latencyMaxUs = 0;
+    const auto deadline = Clock::now() + std::chrono::seconds(20);
+    while (received < kStressFrames && Clock::now() < deadline) {
+        // Sleep "until the next deadline" (long) unless frames arrive.
+        {
+            std::unique_lock<std::mutex> lock(wake.m);
+            if (!wake.cv.wait_for(lock, std::chrono::milliseconds(50), [&] { return wake.pending; })) {
+                timeouts++;
+            }
+            wake.pending = false;
+        }
+        loops++;
+        HostRxEvent ev;
+        while (task.pop(ev)) {
+            const uint16_t seq = static_cast<uint16_t>(ev.msg.status.adcRaw[0]);
+            const uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - g_injectAt[seq]).count();
+            latencyMaxUs = std::max(latencyMaxUs, us);
+            received++;
+        }
+    }
+    producer.join();
+    task.stop();
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] woken consumer: %u frames in %lu loop passes (%lu timeouts), %lu wake calls, max %lu us RX-to-consume",
+             (unsigned)received, (unsigned long)loops, (unsigned long)timeouts,
+             (unsigned long)wake.calls.load(), (unsigned long)latencyMaxUs);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(kStressFrames, received);
+    TEST_ASSERT_TRUE(wake.calls.load() > 0);
+    TEST_ASSERT_TRUE(latencyMaxUs < 50000u); // never waited for the timeout
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_order_full_and_wrap);
+    RUN_TEST(test_ring_two_threads);
+    RUN_TEST(test_decoder_matches_inline);
+    RUN_TEST(test_task_under_render_load);
+    RUN_TEST(test_hostcomm_with_task_end_to_end);
+    RUN_TEST(test_wake_callback_consumer_sleeps);
+    return UNITY_END();
+}
+
+// EOF
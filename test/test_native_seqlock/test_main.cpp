@@ -0,0 +1,221 @@
+// ============================================================================
+//  test_native_seqlock / test_main.cpp
+//
+//  Native (PC) tests for the sample snapshot path (seqlock.h) used by the
+//  client's background ADS1115 sampler.
+//
+//  - single-threaded: sequence parity, latest value wins
+//  - a writer thread publishing self-consistent samples while reader threads
+//    copy snapshots: a torn snapshot must never be observed
+//  - sample age on the wire: C;STATUS with ;<sampleSeq>;<ageMs> and
+//    HostComm::remoteSampleAgeMs() growing with the time since the frame
+//  - benchmark: snapshot read cost with and without a concurrent writer
+//
+//  Run:
+//    pio test -e native -f test_native_seqlock -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "HostComm.h"
+#include "protocol.h"
+#include "seqlock.h"
+
+// Same shape as sensor_ntc::Sample; every field is derived from `seq`, so a
+// snapshot mixing two writes is detectable.
+struct FakeSample {
+    int16_t rawHotspot;
+    int16_t rawChamber;
+    int16_t hot_dC;
+    int16_t cha_dC;
+    bool hotValid;
+    bool adsOk;
+    uint16_t seq;
+    uint32_t sampleMs;
+};
+
+static FakeSample make_sample(uint32_t n) {
+    FakeSample s = {};
+    s.seq = static_cast<uint16_t>(n);
+    s.rawHotspot = static_cast<int16_t>(n * 3);
+    s.rawChamber = static_cast<int16_t>(n * 5);
+    s.hot_dC = static_cast<int16_t>(n * 7);
+    s.cha_dC = static_cast<int16_t>(n * 11);
+    s.hotValid = (n & 1u) != 0;
+    s.adsOk = true;
+    s.sampleMs = n * 100u;
+    return s;
+}
+
+static bool consistent(const FakeSample &s) {
+    const FakeSample ref = make_sample(s.sampleMs / 100u);
+    return s.seq == ref.seq && s.rawHotspot == ref.rawHotspot && s.rawChamber == ref.rawChamber &&
+           s.hot_dC == ref.hot_dC && s.cha_dC == ref.cha_dC && s.hotValid == ref.hotValid && s.adsOk;
+}
+
+void setUp(void) {
+    arduino_native::set_ms(1000);
+    Serial1.clearTx();
+}
+
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// SeqLock
+// -----------------------------------------------------------------------------
+
+static void test_sequence_and_latest_value(void) {
+    SeqLock<FakeSample> lock;
+    TEST_ASSERT_EQUAL_UINT32(0, lock.sequence());
+
+    FakeSample out = {};
+    TEST_ASSERT_TRUE(lock.tryRead(out));
+    TEST_ASSERT_EQUAL_UINT16(0, out.seq);
+
+    lock.write(make_sample(1));
+    lock.write(make_sample(2));
+    TEST_ASSERT_EQUAL_UINT32(4, lock.sequence());
+
+    out = lock.read();
+    TEST_ASSERT_TRUE(consistent(out));
+    TEST_ASSERT_EQUAL_UINT16(2, out.seq);
+    TEST_ASSERT_EQUAL_INT16(22, out.cha_dC);
+}
+
+static void test_concurrent_reads_never_torn(void) {
+    SeqLock<FakeSample> lock;
+    lock.write(make_sample(1));
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> torn{0};
+    std::atomic<uint32_t> reads{0};
+    std::atomic<uint32_t> backwards{0};
+
+    std::thread writer([&]() {
+        for (uint32_t n = 2; !stop.load(std::memory_order_relaxed); ++n) {
+            lock.write(make_sample(n & 0xFFFFu));
+        }
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            uint32_t lastMs = 0;
+            for (uint32_t i = 0; i < 200000; ++i) {
+                const FakeSample s = lock.read();
+                if (!consistent(s)) {
+                    torn.fetch_add(1);
+                }
+                // sampleMs only goes backwards when the 16-bit counter wraps
+                if (s.sampleMs < lastMs && s.seq != 0 && lastMs - s.sampleMs < 3000000u) {
+                    backwards.fetch_add(1);
+                }
+                lastMs = s.sampleMs;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &t : readers) {
+        t.join();
+    }
+    stop.store(true);
+    writer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(400000, reads.load());
+    TEST_ASSERT_EQUAL_UINT32(0, torn.load());
+    TEST_ASSERT_EQUAL_UINT32(0, backwards.load());
+}
+
+// -----------------------------------------------------------------------------
+// Sample age on the wire
+// -----------------------------------------------------------------------------
+
+static void test_remote_sample_age(void) {
+    HostComm host(Serial1);
+
+    // Legacy STATUS without sample fields: age unknown.
+    host.processLine("C;STATUS;0001;0;0;0;0;250;240");
+    TEST_ASSERT_TRUE(host.hasNewStatus());
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, host.remoteSampleAgeMs());
+
+    ProtocolStatus st = {};
+    st.outputsMask = 0x0001;
+    st.tempHotspot_dC = 251;
+    st.tempChamber_dC = 241;
+    st.sampleSeq = 0x0123;
+    st.sampleAgeMs = 42;
+    char buf[ProtocolCodec::kMaxFrameLen];
+    const size_t n = ProtocolCodec::buildClientStatus(buf, sizeof(buf), st);
+    TEST_ASSERT_EQUAL_STRING("C;STATUS;0001;0;0;0;0;251;241;0123;42;0000\r\n", buf);
+
+    host.processLine(String(buf).substring(0, n - 2));
+    TEST_ASSERT_EQUAL_UINT16(0x0123, host.getRemoteStatus().sampleSeq);
+    TEST_ASSERT_EQUAL_UINT32(42, host.remoteSampleAgeMs());
+
+    arduino_native::advance_ms(150);
+    TEST_ASSERT_EQUAL_UINT32(192, host.remoteSampleAgeMs());
+}
+
+// -----------------------------------------------------------------------------
+// Benchmark
+// -----------------------------------------------------------------------------
+
+static void test_bench_snapshot_read(void) {
+    using clock = std::chrono::steady_clock;
+    constexpr uint32_t kReads = 2000000;
+
+    SeqLock<FakeSample> lock;
+    lock.write(make_sample(1));
+
+    uint32_t sink = 0;
+    auto t0 = clock::now();
+    for (uint32_t i = 0; i < kReads; ++i) {
+        sink += lock.read().seq;
+    }
+    const double idleNs = std::chrono::duration<double, std::nano>(clock::now() - t0).count() / kReads;
+
+    // Writer at full speed (far above the 10 Hz of the sampling task).
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        for (uint32_t n = 2; !stop.load(std::memory_order_relaxed); ++n) {
+            lock.write(make_sample(n & 0xFFFFu));
+        }
+    });
+    uint32_t retries = 0;
+    t0 = clock::now();
+    for (uint32_t i = 0; i < kReads; ++i) {
+        FakeSample s;
+        while (!lock.tryRead(s)) {
+            retries++;
+        }
+        sink += s.seq;
+    }
+    const double busyNs = std::chrono::duration<double, std::nano>(clock::now() - t0).count() / kReads;
+    stop.store(true);
+    writer.join();
+
+    char msg[160];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] snapshot read: %.1f ns idle, %.1f ns under a saturating writer (%.2f retries/read) [%u]",
+             idleNs, busyNs, double(retries) / kReads, (unsigned)(sink & 1u));
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_sequence_and_latest_value);
+    RUN_TEST(test_concurrent_reads_never_torn);
+    RUN_TEST(test_remote_sample_age);
+    RUN_TEST(test_bench_snapshot_read);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,349 @@
+// ============================================================================
+//  test_native_status_push / test_main.cpp
+//
+//  Native (PC) tests for the push-based STATUS subscription (H;SUB).
+//
+//  - HostComm subscribes after linkSynced(), ClientComm pushes periodically
+//  - Immediate pushes on output changes and door edges
+//  - Fallback to polling when the client does not answer H;SUB
+//  - Subscription is renewed when pushes stop
+//  - Benchmark: polling (H;GET;STATUS every 500 ms) vs. subscription with the
+//    same period: telemetry age, door-edge latency and link traffic
+//
+//  Both ends run the real HostComm / ClientComm on the in-memory UARTs of
+//  the native Arduino shim (DelayLink without latency), driven by the
+//  virtual clock in 1 ms steps.
+//
+//  Run:
+//    pio test -e native -f test_native_status_push -v
+// ============================================================================
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ClientComm.h"
+#include "HostComm.h"
+#include "delay_link.h"
+#include "output_bitmask.h"
+#include "protocol.h"
+
+// -----------------------------------------------------------------------------
+// Simulated client application
+// -----------------------------------------------------------------------------
+
+static constexpr size_t kSampleSlots = 4096;
+
+static bool g_doorOpen = false;
+static uint16_t g_sampleSeq = 0;
+static uint32_t g_sampleTimeMs[kSampleSlots];
+
+// Stamps every sample with a sequence number (in tempChamber_dC) so the host
+// side can look up when it was taken.
+static void fill_status_cb(ProtocolStatus &st) {
+    const uint16_t kDoorBit = (1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR);
+    if (g_doorOpen) {
+        st.outputsMask |= kDoorBit;
+    } else {
+        st.outputsMask &= static_cast<uint16_t>(~kDoorBit);
+    }
+
+    g_sampleSeq = static_cast<uint16_t>((g_sampleSeq + 1) % kSampleSlots);
+    g_sampleTimeMs[g_sampleSeq] = millis();
+
+    st.adcRaw[0] = 12345;
+    st.adcRaw[1] = 23456;
+    st.tempHotspot_dC = 1120;
+    st.tempChamber_dC = static_cast<int16_t>(g_sampleSeq);
+}
+
+// -----------------------------------------------------------------------------
+// Link harness
+// -----------------------------------------------------------------------------
+
+static DelayLink g_link(Serial1, Serial2);
+
+static uint64_t link_bytes() {
+    return g_link.hostToClient().bytes + g_link.clientToHost().bytes;
+}
+static uint32_t link_frames() {
+    return g_link.hostToClient().frames + g_link.clientToHost().frames;
+}
+
+// Host application: the STATUS-related part of oven_comm_poll().
+struct HostApp {
+    HostComm *comm = nullptr;
+    uint32_t lastPingMs = 0;
+    uint32_t lastPollMs = 0;
+    uint32_t consumed = 0;
+    uint32_t lastSampleMs = 0;
+    bool doorSeen = false;
+};
+
+// Runs after HostComm::loop() in every link step.
+static void host_app_tick(HostApp &app) {
+    HostComm &comm = *app.comm;
+    const uint32_t now = millis();
+    const uint32_t pingInterval = comm.linkSynced() ? 1000 : 250;
+    if (now - app.lastPingMs >= pingInterval) {
+        app.lastPingMs = now;
+        comm.sendPing();
+    }
+
+    if (comm.linkSynced() && !comm.statusSubscribed() && now - app.lastPollMs >= 500) {
+        app.lastPollMs = now;
+        comm.requestStatus();
+    }
+}
+
+// Consume a new STATUS (hasNewStatus semantics as in oven_comm_poll).
+static bool host_app_consume(HostApp &app) {
+    if (!app.comm->hasNewStatus()) {
+        return false;
+    }
+    const ProtocolStatus &st = app.comm->getRemoteStatus();
+    app.lastSampleMs = g_sampleTimeMs[static_cast<uint16_t>(st.tempChamber_dC) % kSampleSlots];
+    app.doorSeen = (st.outputsMask & (1u << OUTPUT_BIT_MASK_8BIT::BIT_DOOR)) != 0;
+    app.consumed++;
+    app.comm->clearNewStatusFlag();
+    return true;
+}
+
+static void step(HostApp &app, ClientComm &client) {
+    g_link.step(*app.comm, client);
+}
+
+static void run_for(HostApp &app, ClientComm &client, uint32_t ms) {
+    for (uint32_t t = 0; t < ms; ++t) {
+        step(app, client);
+        host_app_consume(app);
+    }
+}
+
+static void start_link(HostComm &host, ClientComm &client, HostApp &app) {
+    host.begin(115200, 16, 17);
+    client.begin(115200);
+    client.setFillStatusCallback(fill_status_cb);
+    app.comm = &host;
+    g_link.setHostApp([&app](HostComm &) { host_app_tick(app); });
+    app.lastPingMs = millis();
+    app.lastPollMs = millis();
+    for (int i = 0; i < 1000 && !host.linkSynced(); ++i) {
+        step(app, client);
+    }
+    TEST_ASSERT_TRUE(host.linkSynced());
+}
+
+static uint32_t median(std::vector<uint32_t> v) {
+    if (v.empty()) {
+        return 0;
+    }
+    std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    return v[v.size() / 2];
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+void setUp(void) {
+    g_link.reset();
+    g_doorOpen = false;
+}
+void tearDown(void) {}
+
+void test_subscribes_after_sync(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    HostApp app;
+    host.setStatusSubscription(500, SubTriggerDoor | SubTriggerOutputs);
+    start_link(host, client, app);
+
+    run_for(app, client, 50);
+    TEST_ASSERT_TRUE(host.statusSubscribed());
+    TEST_ASSERT_TRUE(client.statusSubscribed());
+    TEST_ASSERT_EQUAL_UINT16(500, host.statusPushPeriodMs());
+
+    // Pushes arrive at the subscribed rate without any H;GET;STATUS.
+    const uint32_t before = app.consumed;
+    const uint32_t pushesBefore = client.statusPushCount();
+    run_for(app, client, 5000);
+    TEST_ASSERT_EQUAL_UINT32(10, client.statusPushCount() - pushesBefore);
+    TEST_ASSERT_EQUAL_UINT32(10, app.consumed - before);
+}
+
+void test_push_on_outputs_change(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    HostApp app;
+    host.setStatusSubscription(500, SubTriggerOutputs);
+    start_link(host, client, app);
+    run_for(app, client, 600);
+
+    const uint32_t pushes = client.statusPushCount();
+    host.setOutputsMask(0x0011);
+    for (int i = 0; i < 3; ++i) {
+        step(app, client);
+    }
+    TEST_ASSERT_EQUAL_UINT32(pushes + 1, client.statusPushCount());
+    TEST_ASSERT_TRUE(host_app_consume(app));
+    TEST_ASSERT_EQUAL_HEX16(0x0011, host.getRemoteStatus().outputsMask);
+
+    // Unchanged mask: no extra push.
+    host.setOutputsMask(0x0011);
+    for (int i = 0; i < 3; ++i) {
+        step(app, client);
+    }
+    TEST_ASSERT_EQUAL_UINT32(pushes + 1, client.statusPushCount());
+}
+
+void test_push_on_door_edge(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    HostApp app;
+    host.setStatusSubscription(500, SubTriggerDoor);
+    start_link(host, client, app);
+    run_for(app, client, 600);
+
+    g_doorOpen = true;
+    client.notifyStatusEvent(SubTriggerDoor);
+    run_for(app, client, 3);
+    TEST_ASSERT_TRUE(app.doorSeen);
+
+    // Trigger not subscribed: ignored.
+    const uint32_t pushes = client.statusPushCount();
+    client.notifyStatusEvent(SubTriggerOutputs);
+    run_for(app, client, 3);
+    TEST_ASSERT_EQUAL_UINT32(pushes, client.statusPushCount());
+}
+
+void test_falls_back_to_polling(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    HostApp app;
+    g_link.hostToClient().dropPrefix = "H;SUB;"; // client firmware without H;SUB
+    g_link.hostToClient().dropCount = -1;
+    host.setStatusSubscription(500, SubTriggerDoor | SubTriggerOutputs);
+    start_link(host, client, app);
+
+    run_for(app, client, 3000);
+    TEST_ASSERT_FALSE(host.statusSubscribed());
+    TEST_ASSERT_FALSE(client.statusSubscribed());
+    TEST_ASSERT_GREATER_THAN(4u, app.consumed);
+}
+
+void test_renews_when_pushes_stop(void) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    HostApp app;
+    host.setStatusSubscription(500, SubTriggerOutputs);
+    start_link(host, client, app);
+    run_for(app, client, 600);
+    TEST_ASSERT_TRUE(host.statusSubscribed());
+
+    // Client forgets the subscription (e.g. reboot without RST).
+    client.processLine("H;SUB;0000;0000");
+    Serial2.takeTx();
+    TEST_ASSERT_FALSE(client.statusSubscribed());
+
+    run_for(app, client, 2000);
+    TEST_ASSERT_TRUE(client.statusSubscribed());
+    TEST_ASSERT_TRUE(host.statusSubscribed());
+}
+
+// Same period (500 ms) for polling and pushing; door toggles every 1733 ms.
+struct LinkStats {
+    uint32_t ageMedianMs;
+    uint32_t doorMedianMs;
+    uint64_t bytes;
+    uint32_t frames;
+    uint32_t statusFrames;
+};
+
+static LinkStats run_benchmark(bool push) {
+    HostComm host(Serial1);
+    ClientComm client(Serial2, 16, 17);
+    HostApp app;
+    if (push) {
+        host.setStatusSubscription(500, SubTriggerDoor | SubTriggerOutputs);
+    }
+    start_link(host, client, app);
+    run_for(app, client, 1000);
+
+    const uint64_t bytes0 = link_bytes();
+    const uint32_t frames0 = link_frames();
+    const uint32_t status0 = host.statusFrameCount();
+
+    std::vector<uint32_t> ages;
+    std::vector<uint32_t> doorLatency;
+    uint32_t lastEdgeMs = millis();
+    bool pendingEdge = false;
+
+    for (uint32_t t = 0; t < 60000; ++t) {
+        if (t % 1733 == 1732) {
+            g_doorOpen = !g_doorOpen;
+            client.notifyStatusEvent(SubTriggerDoor);
+            lastEdgeMs = millis();
+            pendingEdge = true;
+        }
+
+        step(app, client);
+        host_app_consume(app);
+
+        if (pendingEdge && app.doorSeen == g_doorOpen) {
+            doorLatency.push_back(millis() - lastEdgeMs);
+            pendingEdge = false;
+        }
+        ages.push_back(millis() - app.lastSampleMs);
+    }
+
+    LinkStats s;
+    s.ageMedianMs = median(ages);
+    s.doorMedianMs = median(doorLatency);
+    s.bytes = link_bytes() - bytes0;
+    s.frames = link_frames() - frames0;
+    s.statusFrames = host.statusFrameCount() - status0;
+    return s;
+}
+
+void test_benchmark_push_vs_poll(void) {
+    const LinkStats poll = run_benchmark(false);
+    const LinkStats push = run_benchmark(true);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "[BENCH] poll: age p50=%lums door p50=%lums, %llu bytes, %lu frames, %lu STATUS / 60 s",
+             (unsigned long)poll.ageMedianMs, (unsigned long)poll.doorMedianMs, (unsigned long long)poll.bytes,
+             (unsigned long)poll.frames, (unsigned long)poll.statusFrames);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "[BENCH] push: age p50=%lums door p50=%lums, %llu bytes, %lu frames, %lu STATUS / 60 s",
+             (unsigned long)push.ageMedianMs, (unsigned long)push.doorMedianMs, (unsigned long long)push.bytes,
+             (unsigned long)push.frames, (unsigned long)push.statusFrames);
+    TEST_MESSAGE(msg);
+
+    // Event pushes restart the period, so the median sample age drops too.
+    TEST_ASSERT_LESS_THAN(poll.ageMedianMs, push.ageMedianMs);
+    TEST_ASSERT_LESS_OR_EQUAL(5u, push.doorMedianMs);
+    TEST_ASSERT_GREATER_THAN(100u, poll.doorMedianMs);
+
+    // One frame per update instead of GET + STATUS. Keep-alive PING/PONG
+    // and the extra event pushes are included in the totals.
+    TEST_ASSERT_LESS_THAN(poll.bytes, push.bytes);
+    TEST_ASSERT_LESS_OR_EQUAL(poll.frames * 3 / 4, push.frames);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_subscribes_after_sync);
+    RUN_TEST(test_push_on_outputs_change);
+    RUN_TEST(test_push_on_door_edge);
+    RUN_TEST(test_falls_back_to_polling);
+    RUN_TEST(test_renews_when_pushes_stop);
+    RUN_TEST(test_benchmark_push_vs_poll);
+    return UNITY_END();
+}
+
+// EOF
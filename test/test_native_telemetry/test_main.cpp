@@ -0,0 +1,490 @@
+// ============================================================================
+//  test_native_telemetry / test_main.cpp
+//
+//  Native (PC) tests for the typed telemetry frames (telemetry.h) and the
+//  receiver (tools/telemetry_recv).
+//
+//  - every stream's schema frame fits into one frame and parses back to the
+//    compiled-in descriptor; payload sizes as documented
+//  - sample encode -> decode keeps every column (signed limits included)
+//  - emitter: schema before the first sample, again after
+//    TELEMETRY_SCHEMA_PERIOD_MS and when the link comes up; seq per stream
+//  - loss detection: gaps, late (reordered) frames, device restart
+//  - mixed stream (text, log_bin.h records, frames) split from arbitrary
+//    chunks; logbin_decode skips the frames
+//  - CSV and column files written and read back, row groups, new file part
+//    after a schema change
+//  - fast/slow rate: Decimator
+//  - benchmark: UDP bytes per second of the CSV text lines vs frames
+//
+//  Run:
+//    pio test -e native -f test_native_telemetry -v
+// ============================================================================
+
+#define TELEMETRY_BINARY 1 // header-only here; enables the fast rate
+
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "log_bin.h"
+#include "log_csv.h"
+#include "logbin_decode.h"
+#include "telemetry.h"
+#include "telemetry_recv.h"
+
+using telemetry_recv::Receiver;
+using telemetry_recv::Sample;
+using telemetry_recv::Schema;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+static std::vector<std::vector<uint8_t> > g_frames;
+
+static void capture_sink(const uint8_t *frame, size_t len) {
+    g_frames.push_back(std::vector<uint8_t>(frame, frame + len));
+}
+
+static telemetry::ClientTemp client_temp(int i) {
+    telemetry::ClientTemp t{};
+    t.rawHot = static_cast<int16_t>(12000 + i);
+    t.hot_mV = 1500 + i;
+    t.hot_dC = static_cast<int16_t>(250 + i);
+    t.rawChamber = static_cast<int16_t>(11000 - i);
+    t.cha_mV = 1400 - i;
+    t.cha_dC = static_cast<int16_t>(230 + i);
+    t.state = 2;
+    t.heater = i & 1;
+    t.door = 0;
+    t.hotFilt_dC = static_cast<int16_t>(249 + i);
+    t.chaFilt_dC = static_cast<int16_t>(229 + i);
+    return t;
+}
+
+struct Collected {
+    std::vector<Sample> samples;
+    std::vector<std::string> names;
+};
+
+static void feed_all(Receiver &rx, Collected &c, const std::vector<uint8_t> &bytes) {
+    rx.feed(bytes.data(), bytes.size(), [&c](const Schema &s, const Sample &v) {
+        c.samples.push_back(v);
+        c.names.push_back(s.name);
+    });
+    rx.finish();
+}
+
+static std::vector<uint8_t> concat(const std::vector<std::vector<uint8_t> > &frames) {
+    std::vector<uint8_t> out;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        out.insert(out.end(), frames[i].begin(), frames[i].end());
+    }
+    return out;
+}
+
+static std::string read_text(const std::string &path) {
+    std::string s;
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return s;
+    }
+    char buf[1024];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        s.append(buf, n);
+    }
+    fclose(f);
+    return s;
+}
+
+// -----------------------------------------------------------------------------
+// Tests
+// -----------------------------------------------------------------------------
+
+static void test_schema_frames(void) {
+    const telemetry::StreamDesc *descs[] = {
+        &telemetry::streamDesc(telemetry::ClientTemp()),
+        &telemetry::streamDesc(telemetry::ClientLogic()),
+        &telemetry::streamDesc(telemetry::HostTemp()),
+        &telemetry::streamDesc(telemetry::HostLogic()),
+    };
+    const size_t payload[] = {23, 8, 11, 10};
+    const size_t columns[] = {11, 8, 6, 10};
+
+    for (size_t i = 0; i < 4; ++i) {
+        const telemetry::StreamDesc &d = *descs[i];
+        TEST_ASSERT_EQUAL_UINT32(i + 1, d.id);
+        TEST_ASSERT_EQUAL_size_t(payload[i], telemetry::payloadSize(d));
+        TEST_ASSERT_EQUAL_size_t(columns[i], d.fieldCount);
+
+        uint8_t frame[telemetry::kMaxFrame];
+        const size_t n = telemetry::encodeSchema(frame, sizeof(frame), d, 7, 1234);
+        TEST_ASSERT_TRUE(n > telemetry::kFrameHeader);
+        TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameMark, frame[0]);
+
+        Schema s;
+        TEST_ASSERT_TRUE(telemetry_recv::parseSchema(frame, n, &s));
+        TEST_ASSERT_TRUE(s.fromDevice);
+        TEST_ASSERT_EQUAL_STRING(telemetry_recv::builtinSchema(d).signature().c_str(), s.signature().c_str());
+
+        // cut or too small buffers are refused, not overrun
+        TEST_ASSERT_FALSE(telemetry_recv::parseSchema(frame, n - 1, &s));
+        TEST_ASSERT_EQUAL_size_t(0, telemetry::encodeSchema(frame, n - 1, d, 7, 1234));
+    }
+
+    // prefixes match the CSV_LOG text lines
+    TEST_ASSERT_EQUAL_STRING(csv::CLIENT_TEMP::PREFIX, descs[0]->name);
+    TEST_ASSERT_EQUAL_STRING(csv::CLIENT_LOGIC::PREFIX, descs[1]->name);
+    TEST_ASSERT_EQUAL_STRING(csv::HOST_TEMP::PREFIX, descs[2]->name);
+    TEST_ASSERT_EQUAL_STRING(csv::HOST_LOGIC::PREFIX, descs[3]->name);
+}
+
+static void test_sample_roundtrip(void) {
+    telemetry::ClientTemp t = client_temp(5);
+    t.hot_dC = -32768; // TEMP_INVALID_DC
+    t.cha_mV = -70000;
+    t.rawHot = -1;
+
+    const telemetry::StreamDesc &d = telemetry::streamDesc(t);
+    uint8_t frame[telemetry::kMaxFrame];
+    const size_t n = telemetry::encodeSample(frame, sizeof(frame), d, 0xFFFF, 0xFEDCBA98u, &t);
+    TEST_ASSERT_EQUAL_size_t(telemetry::kFrameHeader + 23, n);
+
+    Sample v;
+    TEST_ASSERT_TRUE(telemetry_recv::parseSample(frame, n, telemetry_recv::builtinSchema(d), &v));
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, v.seq);
+    TEST_ASSERT_EQUAL_UINT32(0xFEDCBA98u, v.timeMs);
+    const int64_t expect[] = {-1, 1500 + 5, -32768, 11000 - 5, -70000, 235, 2, 1, 0, 254, 234};
+    TEST_ASSERT_EQUAL_size_t(11, v.values.size());
+    for (size_t i = 0; i < 11; ++i) {
+        TEST_ASSERT_TRUE(expect[i] == v.values[i]);
+    }
+
+    telemetry::HostLogic l{};
+    l.mode = 3;
+    l.heaterStage = 255;
+    const size_t m = telemetry::encodeSample(frame, sizeof(frame), telemetry::streamDesc(l), 1, 2, &l);
+    TEST_ASSERT_TRUE(telemetry_recv::parseSample(frame, m, telemetry_recv::builtinSchema(telemetry::streamDesc(l)), &v));
+    TEST_ASSERT_TRUE(v.values[0] == 3 && v.values[9] == 255);
+
+    // a frame of another stream or size does not match the schema
+    TEST_ASSERT_FALSE(telemetry_recv::parseSample(frame, m, telemetry_recv::builtinSchema(d), &v));
+}
+
+static void test_emitter_schema_and_seq(void) {
+    g_frames.clear();
+    telemetry::Emitter em(capture_sink);
+    const telemetry::ClientTemp t = client_temp(0);
+    telemetry::ClientLogic l{};
+
+    em.send(t, 1000, false); // schema + sample
+    em.send(t, 1100, false);
+    em.send(l, 1100, false); // first sample of another stream: its schema
+    TEST_ASSERT_EQUAL_size_t(5, g_frames.size());
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSchema, g_frames[0][2]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSample, g_frames[1][2]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSample, g_frames[2][2]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSchema, g_frames[3][2]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kStreamClientLogic, g_frames[3][3]);
+    TEST_ASSERT_EQUAL_UINT16(2, em.nextSeq(telemetry::kStreamClientTemp));
+    TEST_ASSERT_EQUAL_UINT16(1, em.nextSeq(telemetry::kStreamClientLogic));
+
+    // link comes up: every stream sends its schema again, once
+    g_frames.clear();
+    em.send(t, 1200, true);
+    em.send(t, 1300, true);
+    em.send(l, 1300, true);
+    TEST_ASSERT_EQUAL_size_t(5, g_frames.size());
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSchema, g_frames[0][2]);
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSchema, g_frames[3][2]);
+
+    // periodic schema
+    g_frames.clear();
+    em.send(t, 1200 + TELEMETRY_SCHEMA_PERIOD_MS - 1, true);
+    TEST_ASSERT_EQUAL_size_t(1, g_frames.size());
+    em.send(t, 1200 + TELEMETRY_SCHEMA_PERIOD_MS, true);
+    TEST_ASSERT_EQUAL_size_t(3, g_frames.size());
+    TEST_ASSERT_EQUAL_UINT8(telemetry::kFrameSchema, g_frames[1][2]);
+
+    // the schema carries the seq of the sample after it
+    Receiver rx;
+    Collected c;
+    feed_all(rx, c, concat(g_frames));
+    TEST_ASSERT_EQUAL_size_t(2, c.samples.size());
+    TEST_ASSERT_EQUAL_UINT16(4, c.samples[0].seq);
+    TEST_ASSERT_EQUAL_UINT16(5, c.samples[1].seq);
+    TEST_ASSERT_EQUAL_UINT16(5, (uint16_t)(g_frames[1][4] | (g_frames[1][5] << 8)));
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats().at(telemetry::kStreamClientTemp).lost);
+}
+
+static void test_loss_detection(void) {
+    g_frames.clear();
+    telemetry::Emitter em(capture_sink);
+    for (int i = 0; i < 20; ++i) {
+        em.send(client_temp(i), 1000u + 100u * i, true);
+    }
+    // frame 0 is the schema, frame k (k >= 1) sample seq k-1
+    std::vector<std::vector<uint8_t> > rx_frames;
+    for (size_t k = 0; k < g_frames.size(); ++k) {
+        if (k == 4 || k == 5 || k == 6 || k == 12) {
+            continue; // lost: seq 3, 4, 5, 11
+        }
+        rx_frames.push_back(g_frames[k]);
+    }
+    rx_frames.push_back(g_frames[12]); // arrives late, after seq 18
+
+    // device restart: seq and time start over
+    g_frames.clear();
+    telemetry::Emitter em2(capture_sink);
+    em2.send(client_temp(0), 50, true);
+    em2.send(client_temp(1), 150, true);
+    rx_frames.insert(rx_frames.end(), g_frames.begin(), g_frames.end());
+
+    Receiver rx;
+    Collected c;
+    feed_all(rx, c, concat(rx_frames));
+    const telemetry_recv::StreamStats &st = rx.stats().at(telemetry::kStreamClientTemp);
+    TEST_ASSERT_EQUAL_UINT32(16 + 1 + 2, st.samples);
+    TEST_ASSERT_EQUAL_UINT32(4, st.lost);
+    TEST_ASSERT_EQUAL_UINT32(1, st.late);
+    TEST_ASSERT_EQUAL_UINT32(1, st.restarts);
+    TEST_ASSERT_EQUAL_UINT32(2, st.schemas);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.malformed());
+}
+
+static void test_mixed_stream_in_chunks(void) {
+    // text line, CSV line, log_bin record and telemetry frames interleaved
+    std::vector<uint8_t> stream;
+    const std::string text = "[OVEN/INFO] start\n";
+    const std::string csvLine = ";[CSV_HOST_PLOT];1;2;3;4;5;0\n";
+    uint8_t rec[LOGBIN_MAX_RECORD];
+    const size_t recLen = logbin::encode(rec, sizeof(rec), 0x12345678u, 42u, 7, "x\n");
+
+    g_frames.clear();
+    telemetry::Emitter em(capture_sink);
+    telemetry::HostTemp h{};
+    for (int i = 0; i < 50; ++i) {
+        h.chamber_dC = static_cast<int16_t>(200 + i);
+        h.hotspot_dC = 10; // 0x0A: '\n' inside the payload
+        if (i % 3 == 0) {
+            stream.insert(stream.end(), text.begin(), text.end());
+        }
+        if (i % 5 == 0) {
+            stream.insert(stream.end(), rec, rec + recLen);
+            stream.insert(stream.end(), csvLine.begin(), csvLine.end());
+        }
+        const size_t first = g_frames.size();
+        em.send(h, 1000u + 100u * i, false); // the first call adds the schema
+        for (size_t k = first; k < g_frames.size(); ++k) {
+            stream.insert(stream.end(), g_frames[k].begin(), g_frames[k].end());
+        }
+    }
+
+    std::mt19937 rng(23);
+    Receiver rx;
+    Collected c;
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        const size_t n = std::min<size_t>(stream.size() - pos, 1 + rng() % 40);
+        rx.feed(&stream[pos], n, [&c](const Schema &s, const Sample &v) {
+            c.samples.push_back(v);
+            c.names.push_back(s.name);
+        });
+        pos += n;
+    }
+    rx.finish();
+    TEST_ASSERT_EQUAL_size_t(50, c.samples.size());
+    for (size_t i = 0; i < c.samples.size(); ++i) {
+        TEST_ASSERT_EQUAL_STRING("HOST_PLOT", c.names[i].c_str());
+        TEST_ASSERT_TRUE(c.samples[i].values[0] == (int64_t)(200 + i));
+        TEST_ASSERT_TRUE(c.samples[i].values[1] == 10);
+    }
+    TEST_ASSERT_EQUAL_UINT32(17 + 10, rx.textLines());
+    TEST_ASSERT_EQUAL_UINT32(10, rx.logRecords());
+    TEST_ASSERT_EQUAL_UINT32(0, rx.malformed());
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats().at(telemetry::kStreamHostTemp).lost);
+
+    // the log decoder passes the text and records through, skips the frames
+    logbin::FormatTable table;
+    table.add(0x12345678u, "OVEN", "INFO", "n=%d %s");
+    logbin::StreamDecoder dec(table);
+    std::string out;
+    auto sink = [&out](const logbin::StreamDecoder::Line &l) { out += l.text; };
+    dec.feed(stream.data(), stream.size(), sink);
+    dec.finish(sink);
+    TEST_ASSERT_EQUAL_UINT32(0, dec.malformed());
+    TEST_ASSERT_EQUAL_UINT32(51, dec.telemetryFrames());
+    TEST_ASSERT_EQUAL_UINT32(10, dec.records());
+    TEST_ASSERT_EQUAL_UINT32(27, dec.textLines());
+    TEST_ASSERT_TRUE(out.find("[OVEN/INFO] n=7 x\n") != std::string::npos);
+}
+
+static void test_csv_and_column_files(void) {
+    char dirTemplate[] = "/tmp/telemetry_test_XXXXXX";
+    const char *dir = mkdtemp(dirTemplate);
+    TEST_ASSERT_TRUE(dir != nullptr);
+
+    g_frames.clear();
+    telemetry::Emitter em(capture_sink);
+    for (int i = 0; i < 10; ++i) {
+        em.send(client_temp(i), 1000u + 100u * i, true);
+    }
+    const std::vector<uint8_t> bytes = concat(g_frames);
+
+    // a device with a changed layout: HOST_PLOT with one column less
+    static const telemetry::Field hostFields[] = {
+        {"chamber_dC", telemetry::kI16, 0},
+        {"hotspot_dC", telemetry::kI16, 2},
+    };
+    const telemetry::StreamDesc oldHost = {telemetry::kStreamHostTemp, "HOST_PLOT", hostFields, 2};
+    const int16_t oldRec[2] = {-5, 400};
+    const telemetry::HostTemp newRec{};
+    g_frames.clear();
+    telemetry::Emitter em2(capture_sink);
+    em2.send(newRec, 10, true);
+    em2.sendRecord(oldHost, oldRec, 10 + TELEMETRY_SCHEMA_PERIOD_MS, true); // schema due again
+    const std::vector<uint8_t> hostBytes = concat(g_frames);
+
+    {
+        Receiver rx;
+        telemetry_recv::CsvWriter csvOut(dir);
+        auto w = [&csvOut](const Schema &s, const Sample &v) { TEST_ASSERT_TRUE(csvOut.write(s, v)); };
+        rx.feed(bytes.data(), bytes.size(), w);
+        rx.feed(hostBytes.data(), hostBytes.size(), w);
+        rx.finish();
+    }
+    const std::string csvText = read_text(std::string(dir) + "/CLIENT_PLOT.csv");
+    TEST_ASSERT_EQUAL_STRING(
+        "t_ms;seq;rawHot;hot_mV;hot_dC;rawChamber;cha_mV;cha_dC;state;heater;door;hotFilt_dC;chaFilt_dC\n"
+        "1000;0;12000;1500;250;11000;1400;230;2;0;0;249;229\n",
+        csvText.substr(0, csvText.find('\n', csvText.find('\n') + 1) + 1).c_str());
+    TEST_ASSERT_EQUAL_size_t(11, (size_t)std::count(csvText.begin(), csvText.end(), '\n'));
+    TEST_ASSERT_EQUAL_STRING("t_ms;seq;chamber_dC;hotspot_dC;target_dC;low_dC;high_dC;safety\n10;0;0;0;0;0;0;0\n",
+                             read_text(std::string(dir) + "/HOST_PLOT.csv").c_str());
+    TEST_ASSERT_EQUAL_STRING("t_ms;seq;chamber_dC;hotspot_dC\n10010;1;-5;400\n",
+                             read_text(std::string(dir) + "/HOST_PLOT.1.csv").c_str());
+
+    {
+        Receiver rx;
+        telemetry_recv::ColumnWriter colOut(dir, 4); // 3 row groups for 10 rows
+        auto w = [&colOut](const Schema &s, const Sample &v) { TEST_ASSERT_TRUE(colOut.write(s, v)); };
+        rx.feed(bytes.data(), bytes.size(), w);
+        rx.finish();
+    }
+    telemetry_recv::ColumnFile cf;
+    TEST_ASSERT_TRUE(telemetry_recv::readColumnFile((std::string(dir) + "/CLIENT_PLOT.tcol").c_str(), &cf));
+    TEST_ASSERT_EQUAL_STRING("CLIENT_PLOT", cf.stream.c_str());
+    TEST_ASSERT_EQUAL_size_t(13, cf.columns.size());
+    TEST_ASSERT_EQUAL_STRING("t_ms", cf.columns[0].name.c_str());
+    TEST_ASSERT_EQUAL_STRING("seq", cf.columns[1].name.c_str());
+    TEST_ASSERT_EQUAL_STRING("cha_mV", cf.columns[6].name.c_str());
+    TEST_ASSERT_EQUAL_UINT32(3, cf.rowGroups);
+    TEST_ASSERT_EQUAL_size_t(10, cf.rows());
+    for (size_t r = 0; r < 10; ++r) {
+        TEST_ASSERT_TRUE(cf.data[0][r] == (int64_t)(1000 + 100 * r));
+        TEST_ASSERT_TRUE(cf.data[1][r] == (int64_t)r);
+        TEST_ASSERT_TRUE(cf.data[6][r] == (int64_t)(1400 - (int)r));
+    }
+
+    const char *files[] = {"CLIENT_PLOT.csv", "HOST_PLOT.csv", "HOST_PLOT.1.csv", "CLIENT_PLOT.tcol"};
+    for (size_t i = 0; i < 4; ++i) {
+        unlink((std::string(dir) + "/" + files[i]).c_str());
+    }
+    rmdir(dir);
+}
+
+static void test_rate_decimator(void) {
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_FAST_PERIOD_MS, telemetry::samplePeriodMs(true));
+    TEST_ASSERT_EQUAL_UINT32(TELEMETRY_SLOW_PERIOD_MS, telemetry::samplePeriodMs(false));
+
+    telemetry::Decimator dec;
+    int sent = 0;
+    for (int i = 0; i < 100; ++i) {
+        sent += dec.tick(false) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_INT(100 / (TELEMETRY_SLOW_PERIOD_MS / TELEMETRY_FAST_PERIOD_MS), sent);
+    sent = 0;
+    for (int i = 0; i < 100; ++i) {
+        sent += dec.tick(true) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_INT(100, sent);
+}
+
+// One minute of heat-up on both boards: all four streams, text at 1 Hz as
+// today vs frames at 10 Hz.
+static void test_bench_text_vs_frames(void) {
+    const int kSeconds = 60;
+    const int kHz = (int)(1000u / TELEMETRY_FAST_PERIOD_MS);
+    char line[256];
+    size_t textBytes = 0;
+    for (int s = 0; s < kSeconds; ++s) {
+        const telemetry::ClientTemp t = client_temp(s);
+        textBytes += (size_t)snprintf(line, sizeof(line), csv::CLIENT_TEMP::FMT, csv::CLIENT_TEMP::PREFIX,
+                                      (long)t.rawHot, (long)t.hot_mV, (long)t.hot_dC, (long)t.rawChamber,
+                                      (long)t.cha_mV, (long)t.cha_dC, (long)t.state, (long)t.heater, (long)t.door,
+                                      (long)t.hotFilt_dC, (long)t.chaFilt_dC);
+        textBytes += (size_t)snprintf(line, sizeof(line), csv::CLIENT_LOGIC::FMT, csv::CLIENT_LOGIC::PREFIX, 1, 1,
+                                      0, 0, 1, 0, 0, 2u);
+        textBytes += (size_t)snprintf(line, sizeof(line), csv::HOST_TEMP::FMT, csv::HOST_TEMP::PREFIX, 1234L,
+                                      1876L, 1400L, 1380L, 1420L, 0);
+        textBytes += (size_t)snprintf(line, sizeof(line), csv::HOST_LOGIC::FMT, csv::HOST_LOGIC::PREFIX, 1u, 1, 1,
+                                      1, 0, 0, 1, 1, 2u, 1u);
+    }
+
+    g_frames.clear();
+    telemetry::Emitter em(capture_sink);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int k = 0; k < kSeconds * kHz; ++k) {
+        const uint32_t now = 1000u + (uint32_t)k * TELEMETRY_FAST_PERIOD_MS;
+        em.send(client_temp(k), now, true);
+        em.send(telemetry::ClientLogic(), now, true);
+        em.send(telemetry::HostTemp(), now, true);
+        em.send(telemetry::HostLogic(), now, true);
+    }
+    const double ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() /
+        (4.0 * kSeconds * kHz);
+    size_t frameBytes = 0;
+    for (size_t i = 0; i < g_frames.size(); ++i) {
+        frameBytes += g_frames[i].size();
+    }
+
+    char msg[200];
+    snprintf(msg, sizeof(msg), "[BENCH] 4 streams: text 1 Hz %u B/s, frames %d Hz %u B/s (incl. schemas), %.0f ns/frame",
+             (unsigned)(textBytes / kSeconds), kHz, (unsigned)(frameBytes / kSeconds), ns);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "[BENCH] per sample set: text %u bytes, frames %u bytes",
+             (unsigned)(textBytes / kSeconds), (unsigned)(frameBytes / (kSeconds * kHz)));
+    TEST_MESSAGE(msg);
+    // a sample set as frames costs well under 60 % of its text lines
+    TEST_ASSERT_TRUE(frameBytes * 10 < textBytes * (size_t)kHz * 6);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_schema_frames);
+    RUN_TEST(test_sample_roundtrip);
+    RUN_TEST(test_emitter_schema_and_seq);
+    RUN_TEST(test_loss_detection);
+    RUN_TEST(test_mixed_stream_in_chunks);
+    RUN_TEST(test_csv_and_column_files);
+    RUN_TEST(test_rate_decimator);
+    RUN_TEST(test_bench_text_vs_frames);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,162 @@
+// ============================================================================
+//  test_native_thermal_cache / test_main.cpp
+//
+//  Native (PC) tests for the per-preset learned thermal cache
+//  (thermal_cache.h, src/app/thermal_cache.cpp) on the in-memory NVS shim.
+//
+//  - first observation is taken as is, later ones folded in with the EMA
+//  - heat-up and hold fields are learned independently
+//  - a different heater profile or target replaces the entry, lookups with
+//    the wrong key miss
+//  - entries survive a reboot (thermal_cache_init() from NVS); a blob of
+//    another version or size is ignored
+//  - clear() forgets RAM and NVS; out-of-range presets are rejected
+//
+//  Run:
+//    pio test -e native -f test_native_thermal_cache -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <Preferences.h>
+
+#include "../../src/app/thermal_cache.cpp"
+
+static constexpr uint16_t kPla = OVEN_DEFAULT_PRESET_INDEX;
+static constexpr HeaterCurveProfileId kPlaProfile = HeaterCurveProfileId::LOW_45C;
+static constexpr int16_t kPlaTarget_dC = 450;
+
+static ThermalCacheEntry observation(uint8_t fields, uint16_t rate, uint32_t deadMs, uint16_t duty, int16_t over) {
+    ThermalCacheEntry e = {};
+    e.fields = fields;
+    e.heaterProfile = static_cast<uint8_t>(kPlaProfile);
+    e.target_dC = kPlaTarget_dC;
+    e.heatRate_mCps = rate;
+    e.deadTimeMs = deadMs;
+    e.timeToReachS = 800;
+    e.holdDuty_pm = duty;
+    e.overshoot_dC = over;
+    return e;
+}
+
+void setUp(void) {
+    preferences_native::clear_all();
+    thermal_cache_init();
+}
+
+void tearDown(void) {}
+
+static void test_first_run_taken_then_ema(void) {
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC));
+
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP | THERMAL_CACHE_HOLD, 100, 20000,
+                                                            50, -30)));
+    const ThermalCacheEntry *e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL_UINT8(1, e->runs);
+    TEST_ASSERT_EQUAL_UINT16(100, e->heatRate_mCps);
+    TEST_ASSERT_EQUAL_UINT32(20000, e->deadTimeMs);
+    TEST_ASSERT_EQUAL_UINT16(50, e->holdDuty_pm);
+    TEST_ASSERT_EQUAL_INT16(-30, e->overshoot_dC);
+
+    // 30 % towards the new observation, rounded
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP | THERMAL_CACHE_HOLD, 200, 30000,
+                                                            60, 10)));
+    e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC);
+    TEST_ASSERT_EQUAL_UINT8(2, e->runs);
+    TEST_ASSERT_EQUAL_UINT16(130, e->heatRate_mCps);
+    TEST_ASSERT_EQUAL_UINT32(23000, e->deadTimeMs);
+    TEST_ASSERT_EQUAL_UINT16(53, e->holdDuty_pm);
+    TEST_ASSERT_EQUAL_INT16(-18, e->overshoot_dC);
+
+    // Converges on a repeated observation
+    for (int i = 0; i < 40; ++i) {
+        thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP | THERMAL_CACHE_HOLD, 200, 30000, 60, 10));
+    }
+    e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC);
+    TEST_ASSERT_EQUAL_UINT8(42, e->runs);
+    TEST_ASSERT_UINT16_WITHIN(1, 200, e->heatRate_mCps);
+    TEST_ASSERT_UINT32_WITHIN(2, 30000, e->deadTimeMs);
+    TEST_ASSERT_INT16_WITHIN(1, 10, e->overshoot_dC);
+}
+
+static void test_fields_learned_independently(void) {
+    // A short run: heat-up only.
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP, 100, 20000, 0, 0)));
+    const ThermalCacheEntry *e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC);
+    TEST_ASSERT_EQUAL_UINT8(THERMAL_CACHE_HEATUP, e->fields);
+
+    // Then one with a hold phase: hold taken as is, heat-up folded in.
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP | THERMAL_CACHE_HOLD, 200, 20000,
+                                                            40, -20)));
+    e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC);
+    TEST_ASSERT_EQUAL_UINT8(THERMAL_CACHE_HEATUP | THERMAL_CACHE_HOLD, e->fields);
+    TEST_ASSERT_EQUAL_UINT16(130, e->heatRate_mCps);
+    TEST_ASSERT_EQUAL_UINT16(40, e->holdDuty_pm);
+    TEST_ASSERT_EQUAL_INT16(-20, e->overshoot_dC);
+
+    // Nothing observed: not recorded.
+    TEST_ASSERT_FALSE(thermal_cache_record(kPla, observation(0, 0, 0, 0, 0)));
+    TEST_ASSERT_EQUAL_UINT8(2, thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC)->runs);
+}
+
+static void test_key_mismatch(void) {
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP, 100, 20000, 0, 0)));
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, HeaterCurveProfileId::MID_60C, kPlaTarget_dC));
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC + 25));
+    TEST_ASSERT_NULL(thermal_cache_get(kPla + 1, kPlaProfile, kPlaTarget_dC));
+    TEST_ASSERT_NULL(thermal_cache_get(kPresetCount, kPlaProfile, kPlaTarget_dC));
+
+    // A changed target starts the entry over.
+    ThermalCacheEntry moved = observation(THERMAL_CACHE_HEATUP, 300, 10000, 0, 0);
+    moved.target_dC = kPlaTarget_dC + 25;
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, moved));
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC));
+    const ThermalCacheEntry *e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC + 25);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL_UINT8(1, e->runs);
+    TEST_ASSERT_EQUAL_UINT16(300, e->heatRate_mCps);
+
+    TEST_ASSERT_FALSE(thermal_cache_record(kPresetCount, observation(THERMAL_CACHE_HEATUP, 100, 20000, 0, 0)));
+}
+
+static void test_persists_across_init(void) {
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP | THERMAL_CACHE_HOLD, 100, 20000,
+                                                            50, -30)));
+    thermal_cache_init(); // reboot
+    const ThermalCacheEntry *e = thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC);
+    TEST_ASSERT_NOT_NULL(e);
+    TEST_ASSERT_EQUAL_UINT16(100, e->heatRate_mCps);
+    TEST_ASSERT_EQUAL_INT16(-30, e->overshoot_dC);
+
+    // A blob from another layout is dropped, not misread.
+    Preferences prefs;
+    TEST_ASSERT_TRUE(prefs.begin("thermal-cache", false));
+    uint8_t shortBlob[16] = {1, 0};
+    prefs.putBytes("presets", shortBlob, sizeof(shortBlob));
+    prefs.end();
+    thermal_cache_init();
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC));
+}
+
+static void test_clear(void) {
+    TEST_ASSERT_TRUE(thermal_cache_record(kPla, observation(THERMAL_CACHE_HEATUP, 100, 20000, 0, 0)));
+    TEST_ASSERT_TRUE(thermal_cache_clear());
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC));
+    thermal_cache_init();
+    TEST_ASSERT_NULL(thermal_cache_get(kPla, kPlaProfile, kPlaTarget_dC));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_first_run_taken_then_ema);
+    RUN_TEST(test_fields_learned_independently);
+    RUN_TEST(test_key_mismatch);
+    RUN_TEST(test_persists_across_init);
+    RUN_TEST(test_clear);
+    return UNITY_END();
+}
+
+// EOF
@@ -0,0 +1,338 @@
+// ============================================================================
+//  test_native_timer_wheel / test_main.cpp
+//
+//  Native (PC) tests for the hierarchical timer wheel (timer_wheel.h) that
+//  schedules the periodic work of the host and client main loops.
+//
+//  - one-shot fires at its deadline, never earlier; stop / restart / remove
+//  - periodic keeps its phase, a late call runs once and counts the missed
+//    periods; lateness statistics
+//  - delays across all levels and beyond kMaxDelayMs, and across the
+//    32-bit millis() wrap
+//  - msUntilNext() matches the earliest deadline at every level
+//  - callbacks re-arming and stopping timers from inside advance()
+//  - randomized against a brute-force reference scheduler
+//  - benchmark: start/stop and advance cost against scanning all timers
+//
+//  Run:
+//    pio test -e native -f test_native_timer_wheel -v
+// ============================================================================
+
+#include <unity.h>
+
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+#include "timer_wheel.h"
+
+struct Probe {
+    TimerWheel *wheel = nullptr;
+    uint32_t calls = 0;
+    uint32_t lastAt = 0;
+    std::vector<uint32_t> at;
+};
+
+static void probe_cb(void *ctx) {
+    Probe *p = static_cast<Probe *>(ctx);
+    p->calls++;
+    p->lastAt = p->wheel->now();
+    p->at.push_back(p->wheel->now());
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void test_one_shot(void) {
+    TimerWheel w(1000);
+    Probe p;
+    p.wheel = &w;
+    const TimerWheel::TimerId id = w.startOneShot("once", 250, probe_cb, &p);
+    TEST_ASSERT_NOT_EQUAL(TimerWheel::kInvalidTimer, id);
+    TEST_ASSERT_EQUAL_UINT32(250, w.msUntilNext(1000));
+    TEST_ASSERT_EQUAL_UINT32(50, w.msUntilNext(1200));
+
+    TEST_ASSERT_EQUAL_UINT32(0, w.advance(1249));
+    TEST_ASSERT_EQUAL_UINT32(0, p.calls);
+    TEST_ASSERT_EQUAL_UINT32(1, w.advance(1250));
+    TEST_ASSERT_EQUAL_UINT32(1, p.calls);
+    TEST_ASSERT_FALSE(w.armed(id));
+    TEST_ASSERT_EQUAL_UINT32(TimerWheel::kNever, w.msUntilNext(1250));
+    TEST_ASSERT_EQUAL_UINT32(0, w.advance(5000));
+
+    // Restart keeps the id; stop cancels; remove frees it.
+    TEST_ASSERT_TRUE(w.restart(id, 10));
+    TEST_ASSERT_TRUE(w.stop(id));
+    TEST_ASSERT_EQUAL_UINT32(0, w.advance(6000));
+    TEST_ASSERT_TRUE(w.restart(id, 0)); // next tick
+    TEST_ASSERT_EQUAL_UINT32(1, w.msUntilNext(6000));
+    TEST_ASSERT_EQUAL_UINT32(1, w.advance(6001));
+    TEST_ASSERT_EQUAL_STRING("once", w.name(id));
+    TEST_ASSERT_TRUE(w.remove(id));
+    TEST_ASSERT_NULL(w.name(id));
+    TEST_ASSERT_FALSE(w.restart(id, 10));
+}
+
+static void test_periodic_phase_and_lateness(void) {
+    TimerWheel w(0);
+    Probe p;
+    p.wheel = &w;
+    const TimerWheel::TimerId id = w.startPeriodic("ui", 250, probe_cb, &p, 250);
+
+    // Polled every 7 ms: calls stay on the 250 ms grid.
+    for (uint32_t t = 0; t <= 2002; t += 7) {
+        w.advance(t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(8, p.calls);
+    for (size_t i = 0; i < p.at.size(); ++i) {
+        TEST_ASSERT_EQUAL_UINT32(250u * (i + 1), p.at[i]);
+    }
+    const TimerWheel::Stats *s = w.stats(id);
+    TEST_ASSERT_EQUAL_UINT32(8, s->calls);
+    TEST_ASSERT_EQUAL_UINT32(0, s->missed);
+    TEST_ASSERT_TRUE(s->lateMaxMs < 7);
+
+    // A 1 s stall: one call, three periods missed, next deadline keeps phase.
+    w.resetStats();
+    TEST_ASSERT_EQUAL_UINT32(1, w.advance(3010));
+    TEST_ASSERT_EQUAL_UINT32(1, s->calls);
+    TEST_ASSERT_EQUAL_UINT32(3, s->missed);
+    TEST_ASSERT_EQUAL_UINT32(760, s->lateMaxMs); // deadline 2250
+    TEST_ASSERT_EQUAL_UINT32(240, w.msUntilNext(3010));
+}
+
+static void test_long_delays_cascade(void) {
+    static const uint32_t kDelays[] = {1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 262145,
+                                       TimerWheel::kMaxDelayMs, TimerWheel::kMaxDelayMs + 1, 50000000u};
+    for (uint32_t start : {0u, 12345u, 0xFFFFFFFFu - 100000u}) {
+        for (uint32_t d : kDelays) {
+            TimerWheel w(start);
+            Probe p;
+            p.wheel = &w;
+            w.startOneShot("long", d, probe_cb, &p);
+
+            // One sleep of exactly the delay, however many levels it spans.
+            TEST_ASSERT_EQUAL_UINT32(d, w.msUntilNext(start));
+            TEST_ASSERT_EQUAL_UINT32(0, w.advance(start + d - 1u));
+            TEST_ASSERT_EQUAL_UINT32(1, w.msUntilNext(start + d - 1u));
+            TEST_ASSERT_EQUAL_UINT32(1, w.advance(start + d));
+            TEST_ASSERT_EQUAL_UINT32(1, p.calls);
+            TEST_ASSERT_EQUAL_UINT32(start + d, p.lastAt);
+        }
+    }
+}
+
+struct Chain {
+    TimerWheel *wheel;
+    TimerWheel::TimerId self;
+    TimerWheel::TimerId victim;
+    uint32_t calls;
+};
+
+static void chain_cb(void *ctx) {
+    Chain *c = static_cast<Chain *>(ctx);
+    c->calls++;
+    if (c->calls < 3) {
+        c->wheel->restart(c->self, 100); // from the advance() time
+    }
+    c->wheel->stop(c->victim);
+}
+
+static void test_rearm_from_callback(void) {
+    TimerWheel w(0);
+    Probe victim;
+    victim.wheel = &w;
+    Chain c = {&w, TimerWheel::kInvalidTimer, TimerWheel::kInvalidTimer, 0};
+    c.self = w.startOneShot("chain", 100, chain_cb, &c);
+    c.victim = w.startOneShot("victim", 100, probe_cb, &victim); // same deadline
+
+    // Late by 50 ms: the re-armed one-shot counts from 150, not from 100.
+    TEST_ASSERT_EQUAL_UINT32(1, w.advance(150));
+    TEST_ASSERT_EQUAL_UINT32(1, c.calls);
+    TEST_ASSERT_EQUAL_UINT32(0, victim.calls);
+    TEST_ASSERT_EQUAL_UINT32(100, w.msUntilNext(150));
+    w.advance(249);
+    TEST_ASSERT_EQUAL_UINT32(1, c.calls);
+    w.advance(250);
+    w.advance(350);
+    w.advance(10000);
+    TEST_ASSERT_EQUAL_UINT32(3, c.calls);
+    TEST_ASSERT_EQUAL_UINT32(0, w.armedCount());
+}
+
+static void test_pool_full(void) {
+    TimerWheel w(0);
+    Probe p;
+    p.wheel = &w;
+    for (size_t i = 0; i < TimerWheel::kMaxTimers; ++i) {
+        TEST_ASSERT_NOT_EQUAL(TimerWheel::kInvalidTimer, w.startPeriodic("p", 10, probe_cb, &p, 10));
+    }
+    TEST_ASSERT_EQUAL(TimerWheel::kInvalidTimer, w.startOneShot("x", 10, probe_cb, &p));
+    TEST_ASSERT_EQUAL(TimerWheel::kInvalidTimer, w.startOneShot("x", 10, nullptr, &p));
+    w.advance(100);
+    TEST_ASSERT_EQUAL_UINT32(TimerWheel::kMaxTimers, p.calls); // 100 ms in one step: coalesced
+}
+
+// Brute-force reference: fire everything due, in deadline order.
+struct RefTimer {
+    bool armed;
+    uint32_t deadline;
+    uint32_t period;
+};
+
+static void test_random_against_reference(void) {
+    std::mt19937 rng(1234);
+    TimerWheel w(0xFFFF0000u); // crosses the millis() wrap
+    Probe probes[TimerWheel::kMaxTimers];
+    RefTimer ref[TimerWheel::kMaxTimers] = {};
+    TimerWheel::TimerId ids[TimerWheel::kMaxTimers];
+    uint32_t refCalls[TimerWheel::kMaxTimers] = {};
+
+    for (size_t i = 0; i < TimerWheel::kMaxTimers; ++i) {
+        probes[i].wheel = &w;
+        const bool periodic = (i & 1u) != 0;
+        const uint32_t period = periodic ? 1u + rng() % 5000u : 0u;
+        ids[i] = periodic ? w.startPeriodic("r", period, probe_cb, &probes[i], 0)
+                          : w.startOneShot("r", 0, probe_cb, &probes[i]);
+        w.stop(ids[i]);
+        ref[i].period = period;
+    }
+
+    uint32_t now = w.now();
+    for (int step = 0; step < 20000; ++step) {
+        const size_t i = rng() % TimerWheel::kMaxTimers;
+        switch (rng() % 4) {
+        case 0: { // (re)start with a delay spanning all levels
+            const uint32_t delay = (rng() % 3 == 0) ? rng() % 300000u : rng() % 200u;
+            w.restart(ids[i], delay);
+            ref[i].armed = true;
+            ref[i].deadline = now + (delay > 0 ? delay : 1u);
+            break;
+        }
+        case 1:
+            w.stop(ids[i]);
+            ref[i].armed = false;
+            break;
+        default: { // advance in small or large steps
+            const uint32_t next = now + ((rng() % 8 == 0) ? rng() % 100000u : rng() % 100u);
+            // Expected deadline check before advancing
+            uint32_t refNext = TimerWheel::kNever;
+            for (const RefTimer &r : ref) {
+                if (r.armed) {
+                    const uint32_t d = static_cast<int32_t>(r.deadline - now) > 0 ? r.deadline - now : 0u;
+                    refNext = d < refNext ? d : refNext;
+                }
+            }
+            TEST_ASSERT_EQUAL_UINT32(refNext, w.msUntilNext(now));
+
+            w.advance(next);
+            for (size_t k = 0; k < TimerWheel::kMaxTimers; ++k) {
+                RefTimer &r = ref[k];
+                if (!r.armed || static_cast<int32_t>(next - r.deadline) < 0) {
+                    continue;
+                }
+                refCalls[k]++;
+                if (r.period == 0) {
+                    r.armed = false;
+                } else {
+                    const uint32_t late = next - r.deadline;
+                    r.deadline += (late / r.period + 1u) * r.period;
+                }
+            }
+            now = next;
+            break;
+        }
+        }
+        for (size_t k = 0; k < TimerWheel::kMaxTimers; ++k) {
+            TEST_ASSERT_EQUAL_UINT32(refCalls[k], probes[k].calls);
+            TEST_ASSERT_EQUAL(ref[k].armed, w.armed(ids[k]));
+        }
+    }
+}
+
+static void noop_cb(void *) {}
+
+static void test_bench_wheel(void) {
+    using clk = std::chrono::steady_clock;
+    static constexpr int kRounds = 200000;
+
+    // Main-loop shape: a few periodic timers, polled every 5 ms.
+    TimerWheel w(0);
+    static const uint32_t kPeriods[] = {20, 250, 1000, 1000, 10000};
+    for (uint32_t p : kPeriods) {
+        w.startPeriodic("p", p, noop_cb, nullptr, p);
+    }
+    const TimerWheel::TimerId one = w.startOneShot("one", 1000, noop_cb, nullptr);
+
+    auto t0 = clk::now();
+    uint32_t now = 0;
+    size_t calls = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        now += 5;
+        calls += w.advance(now);
+        w.restart(one, 1000 + (i & 255));
+    }
+    const double wheelNs = std::chrono::duration<double, std::nano>(clk::now() - t0).count() / kRounds;
+
+    // The same with `now - last >= period` checks over every timer.
+    uint32_t last[6] = {};
+    uint32_t deadlineOne = 1000;
+    size_t scanCalls = 0;
+    volatile uint32_t sink = 0;
+    t0 = clk::now();
+    now = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        now += 5;
+        for (size_t k = 0; k < 5; ++k) {
+            if (now - last[k] >= kPeriods[k]) {
+                last[k] = now;
+                scanCalls++;
+            }
+        }
+        if (static_cast<int32_t>(now - deadlineOne) >= 0) {
+            scanCalls++;
+        }
+        deadlineOne = now + 1000 + (i & 255);
+        sink = sink + static_cast<uint32_t>(scanCalls);
+    }
+    const double scanNs = std::chrono::duration<double, std::nano>(clk::now() - t0).count() / kRounds;
+
+    // Sleeping on msUntilNext() instead of every 5 ms.
+    TimerWheel s(0);
+    for (uint32_t p : kPeriods) {
+        s.startPeriodic("p", p, noop_cb, nullptr, p);
+    }
+    uint32_t wakeups = 0;
+    now = 0;
+    while (now < 60000u) {
+        now += s.msUntilNext(now);
+        s.advance(now);
+        wakeups++;
+    }
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "[BENCH] loop pass: wheel advance+restart %.1f ns (%lu calls), scan %.1f ns; "
+             "wake-ups per minute: %lu on deadlines vs %u polling every 5 ms",
+             wheelNs, (unsigned long)calls, scanNs, (unsigned long)wakeups, 60000u / 5u);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(calls > 0);
+    TEST_ASSERT_TRUE(wakeups < 60000u / 5u);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_one_shot);
+    RUN_TEST(test_periodic_phase_and_lateness);
+    RUN_TEST(test_long_delays_cascade);
+    RUN_TEST(test_rearm_from_callback);
+    RUN_TEST(test_pool_full);
+    RUN_TEST(test_random_against_reference);
+    RUN_TEST(test_bench_wheel);
+    return UNITY_END();
+}
+
+// EOF
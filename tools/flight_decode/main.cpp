@@ -0,0 +1,101 @@
+// ============================================================================
+//  flight_decode / main.cpp
+//
+//  Turns a flight recorder dump ("fr dump" on the host console, or
+//  "fr dump udp") captured from the console or the UDP log into CSV.
+//
+//  Build (PC):
+//    g++ -std=c++17 -O2 -I include tools/flight_decode/main.cpp -o flight_decode
+//
+//  Use:
+//    flight_decode console.log > flight.csv
+//    flight_decode < udp_capture.txt
+//
+//  Other log lines around the dump are ignored; a block seen twice (console
+//  and UDP capture of the same dump) is written once, blocks in seq order.
+//  Damaged lines (CRC) and gaps in the block seq go to stderr.
+// ============================================================================
+
+#include <stdio.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "flight_recorder.h"
+
+using flight_rec::FlightSample;
+
+static void read_lines(FILE *f, std::map<uint32_t, std::vector<uint8_t>> &blocks, unsigned &damaged) {
+    std::string line;
+    uint8_t buf[0xFFFF];
+    int c;
+    do {
+        c = fgetc(f);
+        if (c != EOF && c != '\n') {
+            line.push_back(static_cast<char>(c));
+            continue;
+        }
+        if (line.find("[FR] B ") != std::string::npos) {
+            const size_t n = flight_rec::parseBlockLine(line.data(), line.size(), buf, sizeof(buf));
+            flight_rec::BlockInfo info;
+            if (n == 0 || !flight_rec::parseBlockHeader(buf, n, &info)) {
+                damaged++;
+            } else {
+                blocks[info.seq].assign(buf, buf + n);
+            }
+        }
+        line.clear();
+    } while (c != EOF);
+}
+
+int main(int argc, char **argv) {
+    std::map<uint32_t, std::vector<uint8_t>> blocks;
+    unsigned damaged = 0;
+    if (argc < 2) {
+        read_lines(stdin, blocks, damaged);
+    }
+    for (int i = 1; i < argc; ++i) {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        read_lines(f, blocks, damaged);
+        fclose(f);
+    }
+
+    printf("t_s;chamber_C;hotspot_C;target_C;heater_req;heater_actual;door;safety;running;comm;stage;mode\n");
+    unsigned long samples = 0;
+    unsigned gaps = 0;
+    unsigned bad = 0;
+    bool first = true;
+    uint32_t prevSeq = 0;
+    for (const auto &kv : blocks) {
+        if (!first && kv.first != prevSeq + 1) {
+            fprintf(stderr, "blocks %lu..%lu missing\n", (unsigned long)prevSeq + 1, (unsigned long)kv.first - 1);
+            gaps++;
+        }
+        first = false;
+        prevSeq = kv.first;
+        const int n = flight_rec::decodeBlock(kv.second.data(), kv.second.size(), [](const FlightSample &s) {
+            printf("%lu;%.1f;%.1f;%.1f;%d;%d;%d;%d;%d;%d;%u;%u\n", (unsigned long)s.t_s, s.chamber_dC / 10.0,
+                   s.hotspot_dC / 10.0, s.target_dC / 10.0, (s.flags & flight_rec::kFlagHeaterReq) ? 1 : 0,
+                   (s.flags & flight_rec::kFlagHeaterActual) ? 1 : 0, (s.flags & flight_rec::kFlagDoorOpen) ? 1 : 0,
+                   (s.flags & flight_rec::kFlagSafety) ? 1 : 0, (s.flags & flight_rec::kFlagRunning) ? 1 : 0,
+                   (s.flags & flight_rec::kFlagCommAlive) ? 1 : 0, (unsigned)s.stage, (unsigned)s.mode);
+        });
+        if (n < 0) {
+            fprintf(stderr, "block %lu malformed\n", (unsigned long)kv.first);
+            bad++;
+        } else {
+            samples += static_cast<unsigned long>(n);
+        }
+    }
+    fprintf(stderr, "%lu samples from %zu blocks, %u gaps, %u damaged lines, %u malformed blocks\n", samples,
+            blocks.size(), gaps, damaged, bad);
+    return blocks.empty() ? 1 : 0;
+}
+
+// EOF
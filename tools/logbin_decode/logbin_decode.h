@@ -0,0 +1,511 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "log_bin.h"
+#include "telemetry.h"
+
+// ============================================================================
+//  logbin_decode.h
+//
+//  PC side of the binary log (include/log_bin.h): format table and stream
+//  decoder. Used by the logbin_decode tool and by test_native_log_bin.
+//
+//  - FormatTable: the build-time table written by
+//    scripts/pio_logbin_formats.py, one site per line:
+//      id (8 hex digits) TAB tag TAB level TAB file:line TAB fmt (escaped)
+//  - StreamDecoder: feed() bytes (UDP datagrams or a capture file in
+//    arbitrary chunks); every complete text line is passed through, every
+//    binary record comes out as its text line, formatted with the host's
+//    snprintf from the recorded arguments
+//  - unknown IDs (stale table) come out as "[?/?] <id 0x...> args..."
+//  - telemetry frames (telemetry.h) are skipped and counted
+// ============================================================================
+
+namespace logbin {
+
+struct FormatSite {
+    std::string tag;
+    std::string level;
+    std::string where; // file:line of the first call site
+    std::string fmt;
+};
+
+struct Arg {
+    ArgType type;
+    int64_t i;
+    uint64_t u;
+    double d;
+    std::string s;
+};
+
+struct Record {
+    uint32_t id = 0;
+    uint32_t timeMs = 0;
+    std::vector<Arg> args;
+    bool truncated = false;
+};
+
+class FormatTable {
+  public:
+    void add(uint32_t id, const std::string &tag, const std::string &level, const std::string &fmt,
+             const std::string &where = std::string()) {
+        _sites[id] = FormatSite{tag, level, where, fmt};
+    }
+
+    const FormatSite *find(uint32_t id) const {
+        const auto it = _sites.find(id);
+        return it == _sites.end() ? nullptr : &it->second;
+    }
+
+    size_t size() const { return _sites.size(); }
+
+    // One table line; false for a malformed line. Comment lines ('#') and
+    // empty lines are accepted and ignored.
+    bool addLine(const std::string &line) {
+        if (line.empty() || line[0] == '#') {
+            return true;
+        }
+        std::vector<std::string> cols;
+        size_t start = 0;
+        for (int i = 0; i < 4; ++i) {
+            const size_t tab = line.find('\t', start);
+            if (tab == std::string::npos) {
+                return false;
+            }
+            cols.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        cols.push_back(unescape(line.substr(start)));
+        char *end = nullptr;
+        const unsigned long id = strtoul(cols[0].c_str(), &end, 16);
+        if (!end || *end != '\0' || cols[0].empty()) {
+            return false;
+        }
+        add(static_cast<uint32_t>(id), cols[1], cols[2], cols[4], cols[3]);
+        return true;
+    }
+
+    // Returns the number of malformed lines, -1 if the file cannot be read.
+    int load(const char *path) {
+        FILE *f = fopen(path, "rb");
+        if (!f) {
+            return -1;
+        }
+        int bad = 0;
+        std::string line;
+        int c;
+        while ((c = fgetc(f)) != EOF) {
+            if (c == '\n') {
+                bad += addLine(stripCr(line)) ? 0 : 1;
+                line.clear();
+            } else {
+                line += static_cast<char>(c);
+            }
+        }
+        if (!line.empty()) {
+            bad += addLine(stripCr(line)) ? 0 : 1;
+        }
+        fclose(f);
+        return bad;
+    }
+
+    static std::string unescape(const std::string &s) {
+        std::string out;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] != '\\' || i + 1 == s.size()) {
+                out += s[i];
+                continue;
+            }
+            const char e = s[++i];
+            switch (e) {
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'x':
+                if (i + 2 < s.size()) {
+                    out += static_cast<char>(strtoul(s.substr(i + 1, 2).c_str(), nullptr, 16));
+                    i += 2;
+                }
+                break;
+            default:
+                out += e; // "\\"
+                break;
+            }
+        }
+        return out;
+    }
+
+  private:
+    static std::string stripCr(const std::string &s) {
+        return !s.empty() && s.back() == '\r' ? s.substr(0, s.size() - 1) : s;
+    }
+
+    std::map<uint32_t, FormatSite> _sites;
+};
+
+// %d of a float argument: truncate like a cast, but stay defined for NaN
+// and out-of-range values.
+inline int64_t floatToInt(double d) {
+    return d == d && d > -9.2e18 && d < 9.2e18 ? static_cast<int64_t>(d) : 0;
+}
+
+// Parses one record (starting at the 0x1E mark). false: malformed.
+inline bool parseRecord(const uint8_t *p, size_t n, Record *out) {
+    if (n < kHeaderLen + 5 || p[0] != kRecordMark || static_cast<size_t>(p[1]) + kHeaderLen != n) {
+        return false;
+    }
+    size_t i = kHeaderLen;
+    auto varint = [&](uint64_t *v) {
+        *v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (i >= n) {
+                return false;
+            }
+            const uint8_t b = p[i++];
+            *v |= static_cast<uint64_t>(b & 0x7Fu) << shift;
+            if ((b & 0x80u) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    Record r;
+    r.id = static_cast<uint32_t>(p[i]) | static_cast<uint32_t>(p[i + 1]) << 8 | static_cast<uint32_t>(p[i + 2]) << 16 |
+           static_cast<uint32_t>(p[i + 3]) << 24;
+    i += 4;
+    uint64_t t = 0;
+    if (!varint(&t)) {
+        return false;
+    }
+    r.timeMs = static_cast<uint32_t>(t);
+
+    while (i < n) {
+        Arg a{};
+        a.type = static_cast<ArgType>(p[i++]);
+        uint64_t v = 0;
+        switch (a.type) {
+        case kArgSigned:
+            if (!varint(&v)) {
+                return false;
+            }
+            a.i = static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1u);
+            a.u = static_cast<uint64_t>(a.i);
+            a.d = static_cast<double>(a.i);
+            break;
+        case kArgUnsigned:
+        case kArgPointer:
+            if (!varint(&v)) {
+                return false;
+            }
+            a.u = v;
+            a.i = static_cast<int64_t>(v);
+            a.d = static_cast<double>(v);
+            break;
+        case kArgFloat: {
+            if (i + 4 > n) {
+                return false;
+            }
+            float f;
+            memcpy(&f, p + i, 4);
+            i += 4;
+            a.d = f;
+            a.i = floatToInt(a.d);
+            a.u = static_cast<uint64_t>(a.i);
+            break;
+        }
+        case kArgDouble:
+            if (i + 8 > n) {
+                return false;
+            }
+            memcpy(&a.d, p + i, 8);
+            i += 8;
+            a.i = floatToInt(a.d);
+            a.u = static_cast<uint64_t>(a.i);
+            break;
+        case kArgString:
+            if (!varint(&v) || i + v > n) {
+                return false;
+            }
+            a.s.assign(reinterpret_cast<const char *>(p + i), static_cast<size_t>(v));
+            i += static_cast<size_t>(v);
+            break;
+        case kArgTruncated:
+            r.truncated = true;
+            if (i != n) {
+                return false;
+            }
+            continue;
+        default:
+            return false;
+        }
+        r.args.push_back(a);
+    }
+    *out = r;
+    return true;
+}
+
+// printf-style formatting of fmt with recorded arguments. Length modifiers
+// follow the device (32-bit int and long); a missing argument prints "<?>".
+inline std::string formatRecord(const std::string &fmt, const std::vector<Arg> &args, bool truncated) {
+    std::string out;
+    size_t next = 0;
+    auto take = [&]() -> const Arg * { return next < args.size() ? &args[next++] : nullptr; };
+    char buf[256];
+
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        if (fmt[i] != '%') {
+            out += fmt[i];
+            continue;
+        }
+        if (i + 1 < fmt.size() && fmt[i + 1] == '%') {
+            out += '%';
+            i++;
+            continue;
+        }
+        std::string spec = "%";
+        size_t j = i + 1;
+        while (j < fmt.size() && strchr("-+ #0", fmt[j])) {
+            spec += fmt[j++];
+        }
+        auto number = [&]() {
+            if (j < fmt.size() && fmt[j] == '*') {
+                const Arg *a = take();
+                spec += std::to_string(a ? static_cast<int>(a->i) : 0);
+                j++;
+                return;
+            }
+            while (j < fmt.size() && fmt[j] >= '0' && fmt[j] <= '9') {
+                spec += fmt[j++];
+            }
+        };
+        number();
+        if (j < fmt.size() && fmt[j] == '.') {
+            spec += fmt[j++];
+            number();
+        }
+        int bits = 32;
+        while (j < fmt.size() && strchr("hlLqjzt", fmt[j])) {
+            const char m = fmt[j++];
+            if (m == 'h') {
+                bits = bits == 16 ? 8 : 16;
+            } else if (m == 'l' && j < fmt.size() && fmt[j] == 'l') {
+                bits = 64;
+                j++;
+            } else if (m == 'q' || m == 'j') {
+                bits = 64;
+            }
+        }
+        if (j >= fmt.size()) {
+            out += fmt.substr(i);
+            break;
+        }
+        const char conv = fmt[j];
+        i = j;
+        if (conv == 'n') {
+            continue;
+        }
+        const Arg *a = take();
+        if (!a) {
+            out += "<?>";
+            continue;
+        }
+        const uint64_t mask = bits == 64 ? ~0ull : (1ull << bits) - 1u;
+        switch (conv) {
+        case 'd':
+        case 'i': {
+            int64_t v = a->i;
+            if (bits < 64) {
+                v = static_cast<int64_t>(static_cast<uint64_t>(v) & mask);
+                if (v & static_cast<int64_t>(1ull << (bits - 1))) {
+                    v -= static_cast<int64_t>(1ull << bits);
+                }
+            }
+            snprintf(buf, sizeof(buf), (spec + "lld").c_str(), static_cast<long long>(v));
+            break;
+        }
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), static_cast<unsigned long long>(a->u & mask));
+            break;
+        case 'c':
+            snprintf(buf, sizeof(buf), (spec + "c").c_str(), static_cast<int>(a->i));
+            break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            snprintf(buf, sizeof(buf), (spec + conv).c_str(), a->d);
+            break;
+        case 's':
+            if (a->type == kArgString) {
+                snprintf(buf, sizeof(buf), (spec + "s").c_str(), a->s.c_str());
+            } else {
+                snprintf(buf, sizeof(buf), "<?>");
+            }
+            break;
+        case 'p':
+            snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(a->u));
+            break;
+        default:
+            snprintf(buf, sizeof(buf), "<%%%c?>", conv);
+            break;
+        }
+        out += buf;
+    }
+    if (truncated) {
+        // Keep the line break where the format had it
+        const bool nl = !out.empty() && out.back() == '\n';
+        if (nl) {
+            out.pop_back();
+        }
+        out += " <truncated>";
+        if (nl) {
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+// Text of one record: "[TAG/LEVEL] " + formatted message, as logPrintf()
+// would have written it.
+inline std::string recordToText(const FormatTable &table, const Record &r) {
+    const FormatSite *site = table.find(r.id);
+    if (site) {
+        return "[" + site->tag + "/" + site->level + "] " + formatRecord(site->fmt, r.args, r.truncated);
+    }
+    char head[48];
+    snprintf(head, sizeof(head), "[?/?] <id 0x%08lX>", static_cast<unsigned long>(r.id));
+    std::string s = head;
+    for (const Arg &a : r.args) {
+        s += ' ';
+        if (a.type == kArgString) {
+            s += '"' + a.s + '"';
+        } else if (a.type == kArgFloat || a.type == kArgDouble) {
+            char b[32];
+            snprintf(b, sizeof(b), "%g", a.d);
+            s += b;
+        } else if (a.type == kArgSigned) {
+            s += std::to_string(a.i);
+        } else {
+            s += std::to_string(a.u);
+        }
+    }
+    return s + (r.truncated ? " <truncated>\n" : "\n");
+}
+
+class StreamDecoder {
+  public:
+    // line: a text line or a decoded record (ends in '\n' if its format
+    // did); timeMs is only set for records (hasTime).
+    struct Line {
+        std::string text;
+        bool hasTime;
+        uint32_t timeMs;
+    };
+
+    explicit StreamDecoder(const FormatTable &table) : _table(table) {}
+
+    template <typename OnLine>
+    void feed(const uint8_t *data, size_t len, OnLine &&onLine) {
+        _pending.insert(_pending.end(), data, data + len);
+        size_t pos = 0;
+        while (pos < _pending.size()) {
+            if (_pending[pos] == kRecordMark) {
+                if (pos + kHeaderLen > _pending.size()) {
+                    break;
+                }
+                const size_t n = kHeaderLen + _pending[pos + 1];
+                if (pos + n > _pending.size()) {
+                    break;
+                }
+                Record r;
+                if (parseRecord(&_pending[pos], n, &r)) {
+                    onLine(Line{recordToText(_table, r), true, r.timeMs});
+                    _records++;
+                } else {
+                    _malformed++;
+                }
+                pos += n;
+            } else if (_pending[pos] == telemetry::kFrameMark) {
+                // telemetry frame (tools/telemetry_recv), same length byte
+                if (pos + telemetry::kHeaderLen > _pending.size()) {
+                    break;
+                }
+                const size_t n = telemetry::kHeaderLen + _pending[pos + 1];
+                if (pos + n > _pending.size()) {
+                    break;
+                }
+                _telemetryFrames++;
+                pos += n;
+            } else {
+                size_t end = pos;
+                while (end < _pending.size() && _pending[end] != '\n' && _pending[end] != kRecordMark &&
+                       _pending[end] != telemetry::kFrameMark) {
+                    end++;
+                }
+                if (end == _pending.size()) {
+                    break; // line continues in the next chunk
+                }
+                const bool nl = _pending[end] == '\n';
+                const size_t stop = nl ? end + 1 : end;
+                onLine(Line{std::string(_pending.begin() + pos, _pending.begin() + stop), false, 0});
+                _textLines++;
+                pos = stop;
+            }
+        }
+        _pending.erase(_pending.begin(), _pending.begin() + pos);
+    }
+
+    // End of a datagram / file: whatever is left is a text line without '\n'
+    // or a cut record.
+    template <typename OnLine>
+    void finish(OnLine &&onLine) {
+        if (!_pending.empty()) {
+            if (_pending[0] == kRecordMark || _pending[0] == telemetry::kFrameMark) {
+                _malformed++;
+            } else {
+                onLine(Line{std::string(_pending.begin(), _pending.end()), false, 0});
+                _textLines++;
+            }
+            _pending.clear();
+        }
+    }
+
+    uint32_t records() const { return _records; }
+    uint32_t textLines() const { return _textLines; }
+    uint32_t malformed() const { return _malformed; }
+    uint32_t telemetryFrames() const { return _telemetryFrames; }
+
+  private:
+    const FormatTable &_table;
+    std::vector<uint8_t> _pending;
+    uint32_t _records = 0;
+    uint32_t _textLines = 0;
+    uint32_t _malformed = 0;
+    uint32_t _telemetryFrames = 0;
+};
+
+} // namespace logbin
+
+// EOF
@@ -0,0 +1,148 @@
+// ============================================================================
+//  logbin_decode / main.cpp
+//
+//  Turns the binary log stream (LOG_BINARY_ENABLE=1) back into text lines.
+//
+//  Build (PC):
+//    g++ -std=c++17 -O2 -I include -I tools/logbin_decode tools/logbin_decode/main.cpp -o logbin_decode
+//
+//  Use:
+//    logbin_decode -f .pio/build/<env>/logbin_formats.tsv -u 10514
+//        listen on the UDP log port instead of udp-viewer
+//    logbin_decode -f logbin_formats.tsv capture.bin ...
+//        decode captured bytes (stdin without a file)
+//
+//    -t  prefix every record with its device time in seconds
+// ============================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "logbin_decode.h"
+
+static bool g_showTime = false;
+
+static void print_line(const logbin::StreamDecoder::Line &line) {
+    if (g_showTime && line.hasTime) {
+        printf("%10.3f ", line.timeMs / 1000.0);
+    }
+    fwrite(line.text.data(), 1, line.text.size(), stdout);
+    if (line.text.empty() || line.text.back() != '\n') {
+        fputc('\n', stdout);
+    }
+}
+
+static int decode_file(logbin::StreamDecoder &dec, FILE *f) {
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        dec.feed(buf, n, print_line);
+    }
+    dec.finish(print_line);
+    return 0;
+}
+
+static int listen_udp(logbin::StreamDecoder &dec, int port) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        perror("bind");
+        close(fd);
+        return 1;
+    }
+    fprintf(stderr, "listening on UDP %d\n", port);
+    uint8_t buf[2048];
+    for (;;) {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            perror("recv");
+            break;
+        }
+        // A datagram holds whole lines and records
+        dec.feed(buf, static_cast<size_t>(n), print_line);
+        dec.finish(print_line);
+        fflush(stdout);
+    }
+    close(fd);
+    return 1;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s -f <logbin_formats.tsv> [-t] [-u <port> | <capture> ...]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    const char *tablePath = nullptr;
+    int port = 0;
+    int first = argc;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            tablePath = argv[++i];
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            g_showTime = true;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            first = i;
+            break;
+        }
+    }
+    if (!tablePath) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    logbin::FormatTable table;
+    const int bad = table.load(tablePath);
+    if (bad < 0) {
+        fprintf(stderr, "cannot read %s\n", tablePath);
+        return 1;
+    }
+    fprintf(stderr, "%zu call sites from %s", table.size(), tablePath);
+    fprintf(stderr, bad ? ", %d malformed lines\n" : "\n", bad);
+
+    logbin::StreamDecoder dec(table);
+    int rc = 0;
+    if (port > 0) {
+        rc = listen_udp(dec, port);
+    } else if (first >= argc) {
+        rc = decode_file(dec, stdin);
+    } else {
+        for (int i = first; i < argc && rc == 0; ++i) {
+            FILE *f = fopen(argv[i], "rb");
+            if (!f) {
+                fprintf(stderr, "cannot read %s\n", argv[i]);
+                rc = 1;
+                break;
+            }
+            rc = decode_file(dec, f);
+            fclose(f);
+        }
+    }
+    if (dec.malformed()) {
+        fprintf(stderr, "%lu malformed records\n", static_cast<unsigned long>(dec.malformed()));
+    }
+    if (dec.telemetryFrames()) {
+        fprintf(stderr, "%lu telemetry frames skipped (tools/telemetry_recv)\n",
+                static_cast<unsigned long>(dec.telemetryFrames()));
+    }
+    return rc;
+}
+
+// EOF
@@ -0,0 +1,190 @@
+// ============================================================================
+//  telemetry_recv / main.cpp
+//
+//  Writes the telemetry frames (TELEMETRY_BINARY=1) of the UDP log stream
+//  into one file per stream.
+//
+//  Build (PC):
+//    g++ -std=c++17 -O2 -I include -I tools/telemetry_recv tools/telemetry_recv/main.cpp -o telemetry_recv
+//
+//  Use:
+//    telemetry_recv -o runs/ -u 10514
+//        listen on the UDP log port (Ctrl-C ends the capture)
+//    telemetry_recv -o runs/ capture.bin ...
+//        split captured bytes (stdin without a file)
+//
+//    -c  column files (<NAME>.tcol) instead of CSV (<NAME>.csv)
+//    -d  <file.tcol>: print a column file as CSV
+//
+//  Per-stream counts (samples, lost, late, restarts) go to stderr at the end.
+// ============================================================================
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "telemetry_recv.h"
+
+using telemetry_recv::ColumnWriter;
+using telemetry_recv::CsvWriter;
+using telemetry_recv::Receiver;
+using telemetry_recv::Sample;
+using telemetry_recv::Schema;
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_sigint(int) { g_stop = 1; }
+
+template <typename Writer>
+static int decode_file(Receiver &rx, Writer &out, FILE *f) {
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        rx.feed(buf, n, [&out](const Schema &s, const Sample &v) { out.write(s, v); });
+    }
+    rx.finish();
+    return 0;
+}
+
+template <typename Writer>
+static int listen_udp(Receiver &rx, Writer &out, int port) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        perror("bind");
+        close(fd);
+        return 1;
+    }
+    struct sigaction sa{};
+    sa.sa_handler = on_sigint; // no SA_RESTART: recv() returns EINTR
+    sigaction(SIGINT, &sa, nullptr);
+
+    fprintf(stderr, "listening on UDP %d\n", port);
+    uint8_t buf[2048];
+    while (!g_stop) {
+        const ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno != EINTR) {
+                perror("recv");
+            }
+            break;
+        }
+        // A datagram holds whole lines, records and frames
+        rx.feed(buf, static_cast<size_t>(n), [&out](const Schema &s, const Sample &v) { out.write(s, v); });
+        rx.finish();
+    }
+    close(fd);
+    return 0;
+}
+
+static int dump_columns(const char *path) {
+    telemetry_recv::ColumnFile cf;
+    if (!telemetry_recv::readColumnFile(path, &cf)) {
+        fprintf(stderr, "cannot read %s\n", path);
+        return 1;
+    }
+    for (size_t c = 0; c < cf.columns.size(); ++c) {
+        printf(c ? ";%s" : "%s", cf.columns[c].name.c_str());
+    }
+    putchar('\n');
+    for (size_t r = 0; r < cf.rows(); ++r) {
+        for (size_t c = 0; c < cf.columns.size(); ++c) {
+            printf(c ? ";%lld" : "%lld", static_cast<long long>(cf.data[c][r]));
+        }
+        putchar('\n');
+    }
+    fprintf(stderr, "%s: %zu rows in %u row groups\n", cf.stream.c_str(), cf.rows(), (unsigned)cf.rowGroups);
+    return 0;
+}
+
+static void print_stats(const Receiver &rx) {
+    for (const auto &kv : rx.stats()) {
+        const Schema *s = rx.schema(kv.first);
+        const telemetry_recv::StreamStats &st = kv.second;
+        fprintf(stderr, "%-12s samples=%lu lost=%lu late=%lu restarts=%lu schemas=%lu\n",
+                s ? s->name.c_str() : "?",
+                (unsigned long)st.samples, (unsigned long)st.lost, (unsigned long)st.late,
+                (unsigned long)st.restarts, (unsigned long)st.schemas);
+    }
+    if (rx.unknown() || rx.malformed()) {
+        fprintf(stderr, "%lu frames without a matching schema, %lu malformed\n",
+                (unsigned long)rx.unknown(), (unsigned long)rx.malformed());
+    }
+}
+
+template <typename Writer>
+static int run(Writer &out, int port, int first, int argc, char **argv) {
+    Receiver rx;
+    int rc = 0;
+    if (port > 0) {
+        rc = listen_udp(rx, out, port);
+    } else if (first >= argc) {
+        rc = decode_file(rx, out, stdin);
+    } else {
+        for (int i = first; i < argc && rc == 0; ++i) {
+            FILE *f = fopen(argv[i], "rb");
+            if (!f) {
+                fprintf(stderr, "cannot read %s\n", argv[i]);
+                rc = 1;
+                break;
+            }
+            rc = decode_file(rx, out, f);
+            fclose(f);
+        }
+    }
+    out.close();
+    print_stats(rx);
+    return rc;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "usage: %s [-o <dir>] [-c] [-u <port> | <capture> ...]\n", argv0);
+    fprintf(stderr, "       %s -d <file.tcol>\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    std::string dir = ".";
+    bool columns = false;
+    int port = 0;
+    int first = argc;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0) {
+            columns = true;
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            return dump_columns(argv[i + 1]);
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            first = i;
+            break;
+        }
+    }
+
+    if (columns) {
+        ColumnWriter out(dir);
+        return run(out, port, first, argc, argv);
+    }
+    CsvWriter out(dir);
+    return run(out, port, first, argc, argv);
+}
+
+// EOF
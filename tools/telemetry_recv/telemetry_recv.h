@@ -0,0 +1,615 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "log_bin.h"
+#include "telemetry.h"
+
+// ============================================================================
+//  telemetry_recv.h
+//
+//  PC side of the telemetry frames (include/telemetry.h). Used by the
+//  telemetry_recv tool and by test_native_telemetry.
+//
+//  - Receiver: feed() bytes (UDP datagrams or a capture in arbitrary
+//    chunks); text lines and log_bin.h records are skipped and counted,
+//    every sample frame comes out with its decoded column values
+//  - schemas: the ones compiled into telemetry.h are known from the start,
+//    a schema frame from the device replaces them (same stream id)
+//  - loss: per stream, a seq gap counts as lost frames, an older seq as
+//    late; seq 0 or device time more than kReorderWindowMs back is a
+//    restart (seq starts over)
+//  - CsvWriter: one <NAME>.csv per stream, ';' separated like the CSV_LOG
+//    lines: t_ms;seq;<fields>
+//  - ColumnWriter: one <NAME>.tcol per stream, column-major row groups with
+//    per-column min/max (see below); readColumnFile() reads it back
+// ============================================================================
+
+namespace telemetry_recv {
+
+struct Column {
+    std::string name;
+    uint8_t type;
+};
+
+struct Schema {
+    uint8_t stream = 0;
+    std::string name;
+    std::vector<Column> columns;
+    bool fromDevice = false; // false: built-in (telemetry.h)
+
+    size_t payloadSize() const {
+        size_t n = 0;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            n += telemetry::fieldSize(columns[i].type);
+        }
+        return n;
+    }
+
+    // Compares names and types; writers start a new file when it changes.
+    std::string signature() const {
+        std::string s = name;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            s += ';' + columns[i].name + ':' + std::to_string(columns[i].type);
+        }
+        return s;
+    }
+};
+
+struct Sample {
+    uint8_t stream = 0;
+    uint16_t seq = 0;
+    uint32_t timeMs = 0;
+    std::vector<int64_t> values; // one per schema column
+};
+
+struct StreamStats {
+    uint32_t samples = 0;
+    uint32_t schemas = 0;
+    uint32_t lost = 0;     // seq gaps
+    uint32_t late = 0;     // seq older than the last one (reordered / duplicate)
+    uint32_t restarts = 0; // device time went backwards
+    bool haveSeq = false;
+    uint16_t lastSeq = 0;
+    uint32_t lastTimeMs = 0;
+};
+
+inline uint32_t getLe(const uint8_t *p, size_t n) {
+    uint32_t v = 0;
+    for (size_t i = 0; i < n; ++i) {
+        v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return v;
+}
+
+inline int64_t decodeField(const uint8_t *p, uint8_t type) {
+    switch (type) {
+    case telemetry::kI8:
+        return static_cast<int8_t>(p[0]);
+    case telemetry::kU8:
+        return p[0];
+    case telemetry::kI16:
+        return static_cast<int16_t>(getLe(p, 2));
+    case telemetry::kU16:
+        return getLe(p, 2);
+    case telemetry::kI32:
+        return static_cast<int32_t>(getLe(p, 4));
+    default:
+        return getLe(p, 4);
+    }
+}
+
+inline Schema builtinSchema(const telemetry::StreamDesc &d) {
+    Schema s;
+    s.stream = d.id;
+    s.name = d.name;
+    for (uint8_t i = 0; i < d.fieldCount; ++i) {
+        s.columns.push_back(Column{d.fields[i].name, d.fields[i].type});
+    }
+    return s;
+}
+
+struct FrameHeader {
+    uint8_t kind;
+    uint8_t stream;
+    uint16_t seq;
+    uint32_t timeMs;
+};
+
+// p: a whole frame starting at the 0x1D mark.
+inline bool parseHeader(const uint8_t *p, size_t n, FrameHeader *out) {
+    if (n < telemetry::kFrameHeader || p[0] != telemetry::kFrameMark ||
+        static_cast<size_t>(p[1]) + telemetry::kHeaderLen != n) {
+        return false;
+    }
+    out->kind = p[2];
+    out->stream = p[3];
+    out->seq = static_cast<uint16_t>(getLe(p + 4, 2));
+    out->timeMs = getLe(p + 6, 4);
+    return true;
+}
+
+inline bool readName(const uint8_t *p, size_t n, size_t &pos, std::string *out) {
+    if (pos >= n || pos + 1 + p[pos] > n) {
+        return false;
+    }
+    const size_t len = p[pos++];
+    out->assign(reinterpret_cast<const char *>(p + pos), len);
+    pos += len;
+    return true;
+}
+
+inline bool parseSchema(const uint8_t *p, size_t n, Schema *out) {
+    FrameHeader h;
+    if (!parseHeader(p, n, &h) || h.kind != telemetry::kFrameSchema) {
+        return false;
+    }
+    size_t pos = telemetry::kFrameHeader;
+    if (pos >= n || p[pos++] != telemetry::kSchemaVersion) {
+        return false;
+    }
+    Schema s;
+    s.stream = h.stream;
+    s.fromDevice = true;
+    if (!readName(p, n, pos, &s.name) || pos >= n) {
+        return false;
+    }
+    const uint8_t count = p[pos++];
+    for (uint8_t i = 0; i < count; ++i) {
+        Column c;
+        if (pos >= n) {
+            return false;
+        }
+        c.type = p[pos++];
+        if (telemetry::fieldSize(c.type) == 0 || !readName(p, n, pos, &c.name)) {
+            return false;
+        }
+        s.columns.push_back(c);
+    }
+    if (pos != n) {
+        return false;
+    }
+    *out = s;
+    return true;
+}
+
+inline bool parseSample(const uint8_t *p, size_t n, const Schema &schema, Sample *out) {
+    FrameHeader h;
+    if (!parseHeader(p, n, &h) || h.kind != telemetry::kFrameSample || h.stream != schema.stream ||
+        n != telemetry::kFrameHeader + schema.payloadSize()) {
+        return false;
+    }
+    out->stream = h.stream;
+    out->seq = h.seq;
+    out->timeMs = h.timeMs;
+    out->values.clear();
+    size_t pos = telemetry::kFrameHeader;
+    for (size_t i = 0; i < schema.columns.size(); ++i) {
+        out->values.push_back(decodeField(p + pos, schema.columns[i].type));
+        pos += telemetry::fieldSize(schema.columns[i].type);
+    }
+    return true;
+}
+
+class Receiver {
+  public:
+    static constexpr uint32_t kReorderWindowMs = 5000;
+
+    explicit Receiver(bool builtinSchemas = true) {
+        if (builtinSchemas) {
+            addBuiltin(telemetry::streamDesc(telemetry::ClientTemp()));
+            addBuiltin(telemetry::streamDesc(telemetry::ClientLogic()));
+            addBuiltin(telemetry::streamDesc(telemetry::HostTemp()));
+            addBuiltin(telemetry::streamDesc(telemetry::HostLogic()));
+        }
+    }
+
+    // onSample(const Schema &, const Sample &)
+    template <typename OnSample>
+    void feed(const uint8_t *data, size_t len, OnSample &&onSample) {
+        _pending.insert(_pending.end(), data, data + len);
+        size_t pos = 0;
+        while (pos < _pending.size()) {
+            const uint8_t mark = _pending[pos];
+            if (mark == telemetry::kFrameMark || mark == logbin::kRecordMark) {
+                // both: mark | len | len bytes
+                if (pos + 2 > _pending.size()) {
+                    break;
+                }
+                const size_t n = 2 + _pending[pos + 1];
+                if (pos + n > _pending.size()) {
+                    break;
+                }
+                if (mark == telemetry::kFrameMark) {
+                    frame(&_pending[pos], n, onSample);
+                } else {
+                    _logRecords++;
+                }
+                pos += n;
+            } else {
+                size_t end = pos;
+                while (end < _pending.size() && _pending[end] != '\n' && _pending[end] != telemetry::kFrameMark &&
+                       _pending[end] != logbin::kRecordMark) {
+                    end++;
+                }
+                if (end == _pending.size()) {
+                    break; // line continues in the next chunk
+                }
+                _textLines++;
+                pos = _pending[end] == '\n' ? end + 1 : end;
+            }
+        }
+        _pending.erase(_pending.begin(), _pending.begin() + pos);
+    }
+
+    // End of a datagram / file.
+    void finish() {
+        if (!_pending.empty()) {
+            if (_pending[0] == telemetry::kFrameMark || _pending[0] == logbin::kRecordMark) {
+                _malformed++;
+            } else {
+                _textLines++;
+            }
+            _pending.clear();
+        }
+    }
+
+    const Schema *schema(uint8_t stream) const {
+        std::map<uint8_t, Schema>::const_iterator it = _schemas.find(stream);
+        return it == _schemas.end() ? nullptr : &it->second;
+    }
+
+    const std::map<uint8_t, StreamStats> &stats() const { return _stats; }
+    uint32_t textLines() const { return _textLines; }
+    uint32_t logRecords() const { return _logRecords; }
+    uint32_t malformed() const { return _malformed; }
+    uint32_t unknown() const { return _unknown; } // samples without a matching schema
+
+  private:
+    void addBuiltin(const telemetry::StreamDesc &d) { _schemas[d.id] = builtinSchema(d); }
+
+    template <typename OnSample>
+    void frame(const uint8_t *p, size_t n, OnSample &onSample) {
+        FrameHeader h;
+        if (!parseHeader(p, n, &h)) {
+            _malformed++;
+            return;
+        }
+        if (h.kind == telemetry::kFrameSchema) {
+            Schema s;
+            if (parseSchema(p, n, &s)) {
+                _schemas[s.stream] = s;
+                _stats[s.stream].schemas++;
+            } else {
+                _malformed++;
+            }
+            return;
+        }
+        const Schema *s = schema(h.stream);
+        if (!s) {
+            _unknown++;
+            return;
+        }
+        if (!parseSample(p, n, *s, &_sample)) {
+            // kind unknown to this receiver or payload does not match the schema
+            _unknown++;
+            return;
+        }
+        StreamStats &st = _stats[h.stream];
+        // A restarted device counts from seq 0 again; a late datagram is
+        // only a little older than the last one.
+        if (st.haveSeq && h.timeMs < st.lastTimeMs &&
+            (h.seq == 0 || h.timeMs + kReorderWindowMs < st.lastTimeMs)) {
+            st.restarts++;
+            st.haveSeq = false;
+        }
+        if (st.haveSeq) {
+            const uint16_t gap = static_cast<uint16_t>(h.seq - st.lastSeq - 1u);
+            if (gap >= 0x8000u) {
+                st.late++; // older than (or equal to) the last one
+            } else {
+                st.lost += gap;
+                st.lastSeq = h.seq;
+                st.lastTimeMs = h.timeMs;
+            }
+        } else {
+            st.haveSeq = true;
+            st.lastSeq = h.seq;
+            st.lastTimeMs = h.timeMs;
+        }
+        st.samples++;
+        onSample(*s, _sample);
+    }
+
+    std::map<uint8_t, Schema> _schemas;
+    std::map<uint8_t, StreamStats> _stats;
+    std::vector<uint8_t> _pending;
+    Sample _sample;
+    uint32_t _textLines = 0;
+    uint32_t _logRecords = 0;
+    uint32_t _malformed = 0;
+    uint32_t _unknown = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Output files
+// ----------------------------------------------------------------------------
+
+// File name for a stream: <dir>/<NAME><ext>, <NAME>.<n><ext> after the
+// schema changed during the capture.
+inline std::string streamPath(const std::string &dir, const std::string &name, unsigned part, const char *ext) {
+    std::string p = dir.empty() ? name : dir + "/" + name;
+    if (part > 0) {
+        p += "." + std::to_string(part);
+    }
+    return p + ext;
+}
+
+class CsvWriter {
+  public:
+    explicit CsvWriter(const std::string &dir) : _dir(dir) {}
+    ~CsvWriter() { close(); }
+
+    bool write(const Schema &schema, const Sample &sample) {
+        Out &o = _out[schema.stream];
+        if (!o.f || o.signature != schema.signature()) {
+            if (!open(o, schema)) {
+                return false;
+            }
+        }
+        fprintf(o.f, "%lu;%u", static_cast<unsigned long>(sample.timeMs), static_cast<unsigned>(sample.seq));
+        for (size_t i = 0; i < sample.values.size(); ++i) {
+            fprintf(o.f, ";%lld", static_cast<long long>(sample.values[i]));
+        }
+        fputc('\n', o.f);
+        return true;
+    }
+
+    void close() {
+        for (std::map<uint8_t, Out>::iterator it = _out.begin(); it != _out.end(); ++it) {
+            if (it->second.f) {
+                fclose(it->second.f);
+                it->second.f = nullptr;
+            }
+        }
+    }
+
+  private:
+    struct Out {
+        FILE *f = nullptr;
+        std::string signature;
+        unsigned parts = 0;
+    };
+
+    bool open(Out &o, const Schema &schema) {
+        if (o.f) {
+            fclose(o.f);
+        }
+        o.f = fopen(streamPath(_dir, schema.name, o.parts++, ".csv").c_str(), "w");
+        if (!o.f) {
+            return false;
+        }
+        o.signature = schema.signature();
+        fprintf(o.f, "t_ms;seq");
+        for (size_t i = 0; i < schema.columns.size(); ++i) {
+            fprintf(o.f, ";%s", schema.columns[i].name.c_str());
+        }
+        fputc('\n', o.f);
+        return true;
+    }
+
+    std::string _dir;
+    std::map<uint8_t, Out> _out;
+};
+
+// Column file (.tcol), all integers little endian:
+//
+//   "TCOL" | u8 version | u8 n + stream name | u16 columns |
+//   per column: u8 type (telemetry::FieldType) | u8 n + name
+//   row groups: u32 rows | per column: i64 min | i64 max | rows values
+//   end:        u32 0
+//
+// t_ms (kU32) and seq (kU16) are the first two columns. A row group holds
+// up to kRowGroupRows rows; min/max let a reader skip groups.
+static constexpr uint8_t kColumnFileVersion = 1;
+static constexpr uint32_t kRowGroupRows = 4096;
+
+class ColumnWriter {
+  public:
+    explicit ColumnWriter(const std::string &dir, uint32_t rowGroupRows = kRowGroupRows)
+        : _dir(dir), _rowGroupRows(rowGroupRows ? rowGroupRows : 1u) {}
+    ~ColumnWriter() { close(); }
+
+    bool write(const Schema &schema, const Sample &sample) {
+        Out &o = _out[schema.stream];
+        if (!o.f || o.signature != schema.signature()) {
+            if (!open(o, schema)) {
+                return false;
+            }
+        }
+        o.rows[0].push_back(sample.timeMs);
+        o.rows[1].push_back(sample.seq);
+        for (size_t i = 0; i < sample.values.size() && i + 2 < o.rows.size(); ++i) {
+            o.rows[i + 2].push_back(sample.values[i]);
+        }
+        if (o.rows[0].size() >= _rowGroupRows) {
+            flushGroup(o);
+        }
+        return true;
+    }
+
+    void close() {
+        for (std::map<uint8_t, Out>::iterator it = _out.begin(); it != _out.end(); ++it) {
+            finishFile(it->second);
+        }
+    }
+
+  private:
+    struct Out {
+        FILE *f = nullptr;
+        std::string signature;
+        unsigned parts = 0;
+        std::vector<uint8_t> types;
+        std::vector<std::vector<int64_t> > rows; // per column
+    };
+
+    static void putLe(FILE *f, uint64_t v, size_t n) {
+        uint8_t b[8];
+        for (size_t i = 0; i < n; ++i) {
+            b[i] = static_cast<uint8_t>(v >> (8 * i));
+        }
+        fwrite(b, 1, n, f);
+    }
+
+    static void putName(FILE *f, const std::string &s) {
+        const size_t n = s.size() < 255 ? s.size() : 255;
+        fputc(static_cast<int>(n), f);
+        fwrite(s.data(), 1, n, f);
+    }
+
+    bool open(Out &o, const Schema &schema) {
+        finishFile(o);
+        o.f = fopen(streamPath(_dir, schema.name, o.parts++, ".tcol").c_str(), "wb");
+        if (!o.f) {
+            return false;
+        }
+        o.signature = schema.signature();
+        o.types.assign(1, telemetry::kU32);
+        o.types.push_back(telemetry::kU16);
+        fwrite("TCOL", 1, 4, o.f);
+        fputc(kColumnFileVersion, o.f);
+        putName(o.f, schema.name);
+        putLe(o.f, schema.columns.size() + 2, 2);
+        fputc(telemetry::kU32, o.f);
+        putName(o.f, "t_ms");
+        fputc(telemetry::kU16, o.f);
+        putName(o.f, "seq");
+        for (size_t i = 0; i < schema.columns.size(); ++i) {
+            fputc(schema.columns[i].type, o.f);
+            putName(o.f, schema.columns[i].name);
+            o.types.push_back(schema.columns[i].type);
+        }
+        o.rows.assign(o.types.size(), std::vector<int64_t>());
+        return true;
+    }
+
+    void flushGroup(Out &o) {
+        const size_t rows = o.rows.empty() ? 0 : o.rows[0].size();
+        if (!o.f || rows == 0) {
+            return;
+        }
+        putLe(o.f, rows, 4);
+        for (size_t c = 0; c < o.rows.size(); ++c) {
+            const std::vector<int64_t> &col = o.rows[c];
+            int64_t lo = col[0];
+            int64_t hi = col[0];
+            for (size_t r = 1; r < rows; ++r) {
+                lo = col[r] < lo ? col[r] : lo;
+                hi = col[r] > hi ? col[r] : hi;
+            }
+            putLe(o.f, static_cast<uint64_t>(lo), 8);
+            putLe(o.f, static_cast<uint64_t>(hi), 8);
+            const size_t sz = telemetry::fieldSize(o.types[c]);
+            for (size_t r = 0; r < rows; ++r) {
+                putLe(o.f, static_cast<uint64_t>(col[r]), sz);
+            }
+            o.rows[c].clear();
+        }
+    }
+
+    void finishFile(Out &o) {
+        if (o.f) {
+            flushGroup(o);
+            putLe(o.f, 0, 4);
+            fclose(o.f);
+            o.f = nullptr;
+        }
+    }
+
+    std::string _dir;
+    uint32_t _rowGroupRows;
+    std::map<uint8_t, Out> _out;
+};
+
+struct ColumnFile {
+    std::string stream;
+    std::vector<Column> columns;            // incl. t_ms and seq
+    std::vector<std::vector<int64_t> > data; // per column
+    uint32_t rowGroups = 0;
+
+    size_t rows() const { return data.empty() ? 0 : data[0].size(); }
+};
+
+// Reads a whole .tcol file. false: cannot read or malformed.
+inline bool readColumnFile(const char *path, ColumnFile *out) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    std::vector<uint8_t> b;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        b.insert(b.end(), chunk, chunk + n);
+    }
+    fclose(f);
+
+    size_t pos = 0;
+    const uint8_t *p = b.data();
+    if (b.size() < 8 || memcmp(p, "TCOL", 4) != 0 || p[4] != kColumnFileVersion) {
+        return false;
+    }
+    pos = 5;
+    ColumnFile cf;
+    if (!readName(p, b.size(), pos, &cf.stream) || pos + 2 > b.size()) {
+        return false;
+    }
+    const size_t cols = getLe(p + pos, 2);
+    pos += 2;
+    for (size_t i = 0; i < cols; ++i) {
+        Column c;
+        if (pos >= b.size()) {
+            return false;
+        }
+        c.type = p[pos++];
+        if (telemetry::fieldSize(c.type) == 0 || !readName(p, b.size(), pos, &c.name)) {
+            return false;
+        }
+        cf.columns.push_back(c);
+    }
+    cf.data.assign(cols, std::vector<int64_t>());
+    for (;;) {
+        if (pos + 4 > b.size()) {
+            return false; // no end mark
+        }
+        const size_t rows = getLe(p + pos, 4);
+        pos += 4;
+        if (rows == 0) {
+            break;
+        }
+        for (size_t c = 0; c < cols; ++c) {
+            const size_t sz = telemetry::fieldSize(cf.columns[c].type);
+            if (pos + 16 + rows * sz > b.size()) {
+                return false;
+            }
+            pos += 16; // min/max
+            for (size_t r = 0; r < rows; ++r) {
+                cf.data[c].push_back(decodeField(p + pos, cf.columns[c].type));
+                pos += sz;
+            }
+        }
+        cf.rowGroups++;
+    }
+    *out = cf;
+    return true;
+}
+
+} // namespace telemetry_recv
+
+// EOF